@@ -33,29 +33,6 @@ xil_axi_uint                           passthrough_agent_verbosity = 0;
 bit                                     clock;
 bit                                     reset;
 integer result_slave;  
-bit [31:0] S00_AXI_test_data[3:0]; 
- localparam LC_AXI_BURST_LENGTH = 8; 
- localparam LC_AXI_DATA_WIDTH = 32; 
-task automatic COMPARE_DATA; 
-  input [(LC_AXI_BURST_LENGTH * LC_AXI_DATA_WIDTH)-1:0]expected; 
-  input [(LC_AXI_BURST_LENGTH * LC_AXI_DATA_WIDTH)-1:0]actual; 
-  begin 
-    if (expected === 'hx || actual === 'hx) begin 
-      $display("TESTBENCH ERROR! COMPARE_DATA cannot be performed with an expected or actual vector that is all 'x'!"); 
- result_slave = 0;    $stop; 
-  end 
-  if (actual != expected) begin 
-    $display("TESTBENCH ERROR! Data expected is not equal to actual.",     " expected = 0x%h",expected,     " actual   = 0x%h",actual); 
-    result_slave = 0; 
-    $stop; 
-  end 
-  else  
-    begin 
-     $display("TESTBENCH Passed! Data expected is equal to actual.", 
-              " expected = 0x%h",expected,               " actual   = 0x%h",actual); 
-    end 
-  end 
-endtask 
 integer                                 i; 
 integer                                 j;  
 xil_axi_uint                            trans_cnt_before_switch = 48;  
@@ -106,10 +83,173 @@ axi_ready_gen                           arready_gen2;
 xil_axi_payload_byte                    data_mem[xil_axi_ulong];  
 IMR_ADC_7476A_X2_bfm_1_master_0_0_mst_t          mst_agent_0;
 
+// ADC pins - driven by the AD7476A model below
+wire                                    adc_sclk;
+wire                                    adc_cs_n;
+wire                                    adc_irq;
+wire                                    adc_miso_a;
+wire                                    adc_miso_b;
+
   `BD_WRAPPER DUT(
       .ARESETN(reset), 
-      .ACLK(clock) 
+      .ACLK(clock),
+      .ADC_SCLK(adc_sclk),
+      .ADC_CS_n(adc_cs_n),
+      .ADC_MISO_A(adc_miso_a),
+      .ADC_MISO_B(adc_miso_b),
+      .IRQ(adc_irq)
     ); 
+
+//------------------------------------------------------------------------------
+// AD7476A x2 behavioral model
+//   CS_n falling loads a 16 bit frame {4'b0000, sample[11:0]} and presents the MSB,
+//   each SCLK falling edge moves to the next bit.  Ramps so every sample is unique:
+//   channel A = 12'h100 + n, channel B = 12'hF00 - n, n counts conversions
+//------------------------------------------------------------------------------
+logic [15:0]                            adc_frame_a;
+logic [15:0]                            adc_frame_b;
+logic [11:0]                            adc_sample_n = 0;
+
+function automatic [31:0] ADC_FIFO_WORD(input [11:0] n);
+  ADC_FIFO_WORD = {8'h00, 12'h100 + n, 12'hF00 - n};
+endfunction
+
+always @(negedge adc_cs_n) begin
+  adc_frame_a = {4'b0000, 12'h100 + adc_sample_n};
+  adc_frame_b = {4'b0000, 12'hF00 - adc_sample_n};
+  adc_sample_n = adc_sample_n + 1;
+end
+always @(negedge adc_sclk) begin
+  if (!adc_cs_n) begin
+    adc_frame_a = {adc_frame_a[14:0], 1'b0};
+    adc_frame_b = {adc_frame_b[14:0], 1'b0};
+  end
+end
+// Conversion start times - SAMPLE_PERIOD_TEST checks the spacing
+realtime                                adc_start_time[$];
+always @(negedge adc_cs_n)
+  adc_start_time.push_back($realtime);
+// SCLK phase widths while selected and CS_n high time before each conversion - THROUGHPUT_TEST
+realtime                                adc_sclk_rise = 0;
+realtime                                adc_sclk_fall = 0;
+realtime                                adc_cs_rise = 0;
+realtime                                adc_min_sclk_high;
+realtime                                adc_min_sclk_low;
+realtime                                adc_min_quiet;
+always @(posedge adc_sclk) begin
+  if (!adc_cs_n && (adc_sclk_fall > adc_start_time[$]) && (($realtime - adc_sclk_fall) < adc_min_sclk_low))
+    adc_min_sclk_low = $realtime - adc_sclk_fall;
+  adc_sclk_rise = $realtime;
+end
+always @(negedge adc_sclk) begin
+  if (!adc_cs_n && (($realtime - adc_sclk_rise) < adc_min_sclk_high))
+    adc_min_sclk_high = $realtime - adc_sclk_rise;
+  adc_sclk_fall = $realtime;
+end
+always @(posedge adc_cs_n)
+  adc_cs_rise = $realtime;
+always @(negedge adc_cs_n) begin
+  if ((adc_cs_rise != 0) && (($realtime - adc_cs_rise) < adc_min_quiet))
+    adc_min_quiet = $realtime - adc_cs_rise;
+end
+// Interrupts raised - TRIGGER_TEST expects one per record
+int                                     adc_irq_rise = 0;
+always @(posedge adc_irq)
+  adc_irq_rise++;
+assign adc_miso_a = adc_cs_n ? 1'b0 : adc_frame_a[15];
+assign adc_miso_b = adc_cs_n ? 1'b0 : adc_frame_b[15];
+
+// Register map - see hdl/IMR_ADC_7476A_X2_Def.vh
+localparam [31:0] TB_REG_CTRL        = 32'h00;
+localparam [31:0] TB_REG_STATUS      = 32'h04;
+localparam [31:0] TB_REG_DATA_A      = 32'h08;
+localparam [31:0] TB_REG_IRQ         = 32'h10;
+localparam [31:0] TB_REG_FIFO_CTRL   = 32'h14;
+localparam [31:0] TB_REG_FIFO_STATUS = 32'h18;
+localparam [31:0] TB_REG_FIFO_DATA   = 32'h1C;
+localparam [31:0] TB_REG_DATA_AB     = 32'h20;
+localparam [31:0] TB_REG_SAMPLE_PERIOD = 32'h3C;
+localparam [31:0] TB_REG_TRIG_CTRL   = 32'h40;
+localparam [31:0] TB_REG_TRIG_LEVEL  = 32'h44;
+localparam [31:0] TB_REG_TRIG_HOLDOFF = 32'h48;
+localparam [31:0] TB_REG_TRIG_RECORD = 32'h4C;
+localparam [31:0] TB_REG_TRIG_STATUS = 32'h50;
+localparam [31:0] TB_REG_CIC_CTRL    = 32'h54;
+localparam [31:0] TB_STATUS_OVERRUN  = 32'h00000020;
+localparam [31:0] TB_STATUS_DONE     = 32'h00000040;
+localparam [31:0] TB_CTRL_EN         = 32'h00000001;
+localparam [31:0] TB_CTRL_START      = 32'h00000002;
+localparam [31:0] TB_CTRL_CONT       = 32'h00000004;
+localparam [31:0] TB_CTRL_FREE_RUN   = 32'h00000008;
+localparam [31:0] TB_CTRL_CLKDIV_2   = 32'h00000020;
+localparam [31:0] TB_CTRL_CLKDIV_ODD = 32'h00100000;
+localparam [31:0] TB_IRQ_EN          = 32'h00000001;
+localparam [31:0] TB_IRQ_CLR         = 32'h00000002;
+localparam [31:0] TB_IRQ_AUTO_ACK    = 32'h00000004;
+localparam [31:0] TB_IRQ_DONE_EN     = 32'h00000008;
+localparam [31:0] TB_FIFO_EN         = 32'h00010000;
+localparam [31:0] TB_FIFO_FLUSH      = 32'h00020000;
+localparam [31:0] TB_FIFO_OVF        = 32'h00020000;
+localparam [31:0] TB_FIFO_EMPTY      = 32'h00040000;
+localparam [31:0] TB_FIFO_FULL       = 32'h00080000;
+localparam [31:0] TB_FIFO_TRIG       = 32'h00200000;
+localparam [31:0] TB_TRIG_EN         = 32'h00000001;
+localparam [31:0] TB_TRIG_ARM        = 32'h00000002;
+localparam [31:0] TB_TRIG_FORCE      = 32'h00000004;
+localparam [31:0] TB_TRIG_SOURCE_B   = 32'h00000008;
+localparam [31:0] TB_TRIG_ABOVE      = 32'h00000000;
+localparam [31:0] TB_TRIG_RISING     = 32'h00000010;
+localparam [31:0] TB_TRIG_FALLING    = 32'h00000020;
+localparam [31:0] TB_CIC_EN          = 32'h00000001;
+localparam        TB_FIFO_DEPTH      = 1024;
+localparam        TB_IRQ_TIMEOUT     = 200000;  // ACLK cycles
+
+task automatic REG_WRITE(input [31:0] addr, input [31:0] data);
+  xil_axi_resp_t resp;
+  bit [63:0] wdata;
+  begin
+    wdata = {32'h0, data};
+    mst_agent_0.AXI4LITE_WRITE_BURST(addr, 0, wdata, resp);
+  end
+endtask
+
+task automatic REG_READ(input [31:0] addr, output [31:0] data);
+  xil_axi_resp_t [255:0] resp;
+  bit [63:0] rdata;
+  begin
+    mst_agent_0.AXI4LITE_READ_BURST(addr, 0, rdata, resp);
+    data = rdata[31:0];
+  end
+endtask
+
+task automatic CHECK(input string what, input [31:0] expected, input [31:0] actual);
+  begin
+    if (actual !== expected) begin
+      $display("TESTBENCH ERROR! %s expected = 0x%h actual = 0x%h", what, expected, actual);
+      result_slave = 0;
+      error_cnt = error_cnt + 1;
+    end
+    comparison_cnt = comparison_cnt + 1;
+  end
+endtask
+
+// Continuous capture of count conversions - START is edge detected so it is dropped first
+task automatic START_CAPTURE(input [11:0] count);
+  begin
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_2 | (count << 8));
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_2 | (count << 8) | TB_CTRL_START);
+  end
+endtask
+
+task automatic WAIT_IDLE;
+  bit [31:0] status;
+  begin
+    do begin
+      repeat (50) @(posedge clock);
+      REG_READ(TB_REG_STATUS, status);
+    end while (status[0]);
+  end
+endtask
   
 initial begin
      mst_agent_0 = new("master vip agent",DUT.`BD_INST_NAME.master_0.inst.IF);//ms  
@@ -127,71 +267,575 @@ initial begin
   end
   always #5 clock <= ~clock;
   initial begin
-      S_AXI_TEST ( );
+      result_slave = 1;   // FIFO_TEST failures are also counted in error_cnt
+      wait (reset == 1'b1);
+      repeat (10) @(posedge clock);
+      FIFO_TEST ( );
+      DATA_AB_TEST ( );
+      FREE_RUN_TEST ( );
+      SAMPLE_PERIOD_TEST ( );
+      THROUGHPUT_TEST ( );
+      TRIGGER_TEST ( );
+      CIC_TEST ( );
+      DONE_TEST ( );
+      CTRL_READBACK_TEST ( );
 
       #1ns;
       $finish;
   end
-task automatic S_AXI_TEST;  
-begin   
-#1; 
-   $display("Sequential write transfers example similar to  AXI BFM WRITE_BURST method starts"); 
-   mtestID = 0; 
-   mtestADDR = 64'h00000000; 
-   mtestBurstLength = 0; 
-   mtestDataSize = xil_axi_size_t'(xil_clog2(32/8)); 
-   mtestBurstType = XIL_AXI_BURST_TYPE_INCR;  
-   mtestLOCK = XIL_AXI_ALOCK_NOLOCK;  
-   mtestCacheType = 0;  
-   mtestProtectionType = 0;  
-   mtestRegion = 0; 
-   mtestQOS = 0; 
-   result_slave = 1; 
-  mtestWDataL[31:0] = 32'h00000001; 
-  for(int i = 0; i < 4;i++) begin 
-  S00_AXI_test_data[i] <= mtestWDataL[31:0];   
-  mst_agent_0.AXI4LITE_WRITE_BURST( 
-  mtestADDR, 
-  mtestProtectionType, 
-  mtestWDataL, 
-  mtestBresp 
-  );   
-  mtestWDataL[31:0] = mtestWDataL[31:0] + 1; 
-  mtestADDR = mtestADDR + 64'h4; 
-  end 
-     $display("Sequential write transfers example similar to  AXI BFM WRITE_BURST method completes"); 
-     $display("Sequential read transfers example similar to  AXI BFM READ_BURST method starts"); 
-     mtestID = 0; 
-     mtestADDR = 64'h00000000; 
-     mtestBurstLength = 0; 
-     mtestDataSize = xil_axi_size_t'(xil_clog2(32/8)); 
-     mtestBurstType = XIL_AXI_BURST_TYPE_INCR;  
-     mtestLOCK = XIL_AXI_ALOCK_NOLOCK;  
-     mtestCacheType = 0;  
-     mtestProtectionType = 0;  
-     mtestRegion = 0; 
-     mtestQOS = 0; 
- for(int i = 0; i < 4;i++) begin 
-   mst_agent_0.AXI4LITE_READ_BURST( 
-        mtestADDR, 
-        mtestProtectionType, 
-        mtestRDataL, 
-        mtestRresp 
-      ); 
-   mtestADDR = mtestADDR + 64'h4; 
-   COMPARE_DATA(S00_AXI_test_data[i],mtestRDataL); 
- end 
-     $display("Sequential read transfers example similar to  AXI BFM READ_BURST method completes"); 
-     $display("Sequential read transfers example similar to  AXI VIP READ_BURST method completes"); 
-     $display("---------------------------------------------------------"); 
-     $display("EXAMPLE TEST S00_AXI: PTGEN_TEST_FINISHED!"); 
-     if ( result_slave ) begin                    
-       $display("PTGEN_TEST: PASSED!");                  
-     end    else begin                                       
-       $display("PTGEN_TEST: FAILED!");                  
-     end                                
-     $display("---------------------------------------------------------"); 
-  end 
-endtask  
+//------------------------------------------------------------------------------
+// CTRL read-back: CTRL is the only plain read/write register, the others are
+// read-only or have write side effects.  EN stays clear so nothing is started
+//------------------------------------------------------------------------------
+task automatic CTRL_READBACK_TEST;
+  bit [31:0] data;
+  bit [31:0] pattern;
+  begin
+    pattern = TB_CTRL_CONT | TB_CTRL_FREE_RUN | TB_CTRL_CLKDIV_ODD | (32'd5 << 4) | (32'd100 << 8);
+    REG_WRITE(TB_REG_CTRL, pattern);
+    REG_READ(TB_REG_CTRL, data);
+    CHECK("CTRL read-back", pattern, data);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN);
+    REG_READ(TB_REG_CTRL, data);
+    CHECK("CTRL read-back EN only", TB_CTRL_EN, data);
+    $display("---------------------------------------------------------");
+    $display("EXAMPLE TEST S00_AXI: PTGEN_TEST_FINISHED!");
+    if ( result_slave && (error_cnt == 0) ) begin
+      $display("PTGEN_TEST: PASSED!");
+    end else begin
+      $display("PTGEN_TEST: FAILED!");
+    end
+    $display("---------------------------------------------------------");
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// Sample FIFO traffic
+//   1) Threshold 8, 20 conversions: drain on each IRQ the way the driver does (read
+//      FIFO_STATUS count, then count reads of FIFO_DATA) - 8, 8, then the 4 sample tail
+//   2) Threshold off, 1030 conversions: FIFO fills, the last 6 are dropped, overflow IRQ
+//   3) IRQ_CLR clears overflow, flush empties the FIFO, IRQ drops
+//------------------------------------------------------------------------------
+task automatic FIFO_TEST;
+  bit [31:0] data;
+  bit [31:0] fifo_status;
+  int received;
+  int timeout;
+  begin
+    $display("FIFO threshold test starts");
+    adc_sample_n = 0;
+    received = 0;
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | 8);
+    START_CAPTURE(20);
+    while (received < 20) begin
+      timeout = 0;
+      while (!adc_irq && (timeout < TB_IRQ_TIMEOUT)) begin
+        @(posedge clock);
+        timeout++;
+      end
+      if (!adc_irq) begin
+        $display("TESTBENCH ERROR! No FIFO IRQ after %0d samples", received);
+        result_slave = 0;
+        break;
+      end
+      REG_READ(TB_REG_FIFO_STATUS, fifo_status);
+      if ((fifo_status[10:0] < 8) && (received + fifo_status[10:0] < 20))
+        CHECK("IRQ below threshold before the tail", 8, fifo_status[10:0]);
+      for (int n = fifo_status[10:0]; n > 0; n--) begin
+        REG_READ(TB_REG_FIFO_DATA, data);
+        CHECK("FIFO sample", ADC_FIFO_WORD(received), data);
+        received++;
+      end
+    end
+    WAIT_IDLE();
+    REG_READ(TB_REG_FIFO_STATUS, fifo_status);
+    CHECK("FIFO empty after drain", TB_FIFO_EMPTY, fifo_status);
+    CHECK("IRQ low after drain", 0, adc_irq);
+    $display("FIFO threshold test completes - %0d samples", received);
+
+    $display("FIFO overflow test starts");
+    adc_sample_n = 0;
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN);
+    START_CAPTURE(TB_FIFO_DEPTH + 6);
+    WAIT_IDLE();
+    REG_READ(TB_REG_FIFO_STATUS, fifo_status);
+    CHECK("FIFO full + overflow", TB_FIFO_FULL | TB_FIFO_OVF | (1 << 20) | TB_FIFO_DEPTH, fifo_status);
+    CHECK("IRQ on overflow", 1, adc_irq);
+    for (int n = 0; n < TB_FIFO_DEPTH; n++) begin
+      REG_READ(TB_REG_FIFO_DATA, data);
+      CHECK("FIFO sample after overflow", ADC_FIFO_WORD(n), data);
+    end
+    REG_READ(TB_REG_FIFO_STATUS, fifo_status);
+    CHECK("Empty, overflow held", TB_FIFO_EMPTY | TB_FIFO_OVF, fifo_status);
+    CHECK("IRQ held by overflow", 1, adc_irq);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN);
+    REG_READ(TB_REG_FIFO_STATUS, fifo_status);
+    CHECK("Overflow cleared by IRQ_CLR", TB_FIFO_EMPTY, fifo_status);
+    CHECK("IRQ low after IRQ_CLR", 0, adc_irq);
+
+    $display("FIFO flush test starts");
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN);
+    START_CAPTURE(5);
+    WAIT_IDLE();
+    REG_READ(TB_REG_FIFO_STATUS, fifo_status);
+    CHECK("5 sample tail", 5, fifo_status[10:0]);
+    CHECK("IRQ on tail", 1, adc_irq);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, 0);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN);
+    REG_READ(TB_REG_FIFO_STATUS, fifo_status);
+    CHECK("Empty after flush", TB_FIFO_EMPTY, fifo_status);
+    CHECK("IRQ low after flush", 0, adc_irq);
+    REG_WRITE(TB_REG_IRQ, 0);
+    $display("FIFO tests complete: %0d checks, %0d errors", comparison_cnt, error_cnt);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// Packed data register and one transaction acknowledge
+//   1) IRQ_AUTO_ACK: single conversions - one DATA_AB read returns {seq, A, B} and drops IRQ
+//   2) IRQ_CLR self-clears: one write acknowledges, the bit reads back 0
+//------------------------------------------------------------------------------
+task automatic DATA_AB_TEST;
+  bit [31:0] data;
+  bit [7:0] sequence;
+  int timeout;
+  begin
+    $display("DATA_AB auto acknowledge test starts");
+    adc_sample_n = 0;
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_AUTO_ACK);
+    for (int n = 0; n < 4; n++) begin
+      REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CLKDIV_2);
+      REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CLKDIV_2 | TB_CTRL_START);
+      timeout = 0;
+      while (!adc_irq && (timeout < TB_IRQ_TIMEOUT)) begin
+        @(posedge clock);
+        timeout++;
+      end
+      CHECK("IRQ per single conversion", 1, adc_irq);
+      REG_READ(TB_REG_DATA_AB, data);
+      CHECK("DATA_AB samples", {12'h100 + n[11:0], 12'hF00 - n[11:0]}, data[23:0]);
+      if (n != 0)
+        CHECK("DATA_AB sequence", sequence + 8'd1, data[31:24]);
+      sequence = data[31:24];
+      CHECK("IRQ low after one DATA_AB read", 0, adc_irq);
+    end
+
+    $display("IRQ_CLR self-clear test starts");
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CLKDIV_2);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CLKDIV_2 | TB_CTRL_START);
+    WAIT_IDLE();
+    CHECK("IRQ set without auto ack", 1, adc_irq);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    CHECK("IRQ low after one IRQ_CLR write", 0, adc_irq);
+    REG_READ(TB_REG_IRQ, data);
+    CHECK("IRQ_CLR self-cleared", TB_IRQ_EN, data);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN);
+    REG_WRITE(TB_REG_IRQ, 0);
+    $display("DATA_AB tests complete: %0d checks, %0d errors", comparison_cnt, error_cnt);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// Free running acquisition through the FIFO
+//   CONT_CNT = 4 is ignored: 64 samples are drained across threshold IRQs, then START is
+//   dropped, the engine must idle after the frame in flight and the tail must continue the ramp
+//------------------------------------------------------------------------------
+task automatic FREE_RUN_TEST;
+  bit [31:0] data;
+  bit [31:0] fifo_status;
+  int received;
+  int timeout;
+  begin
+    $display("Free running test starts");
+    adc_sample_n = 0;
+    received = 0;
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | 16);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CLKDIV_2);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_FREE_RUN | TB_CTRL_CLKDIV_2 | (4 << 8) | TB_CTRL_START);
+    while (received < 64) begin
+      timeout = 0;
+      while (!adc_irq && (timeout < TB_IRQ_TIMEOUT)) begin
+        @(posedge clock);
+        timeout++;
+      end
+      if (!adc_irq) begin
+        $display("TESTBENCH ERROR! Free running stopped after %0d samples", received);
+        result_slave = 0;
+        error_cnt = error_cnt + 1;
+        break;
+      end
+      REG_READ(TB_REG_FIFO_STATUS, fifo_status);
+      for (int n = fifo_status[10:0]; n > 0; n--) begin
+        REG_READ(TB_REG_FIFO_DATA, data);
+        CHECK("Free running sample", ADC_FIFO_WORD(received), data);
+        received++;
+      end
+    end
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CLKDIV_2);
+    WAIT_IDLE();
+    REG_READ(TB_REG_FIFO_STATUS, fifo_status);
+    for (int n = fifo_status[10:0]; n > 0; n--) begin
+      REG_READ(TB_REG_FIFO_DATA, data);
+      CHECK("Free running tail sample", ADC_FIFO_WORD(received), data);
+      received++;
+    end
+    CHECK("Model frames = samples received", adc_sample_n, received);
+    CHECK("IRQ low after stop and drain", 0, adc_irq);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, 0);
+    REG_WRITE(TB_REG_IRQ, 0);
+    $display("Free running test complete - %0d samples: %0d checks, %0d errors", received, comparison_cnt, error_cnt);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// Sample period timer
+//   1) SAMPLE_PERIOD = 200 SysClks (500 kHz): 16 conversions through the FIFO, every CS_n
+//      fall exactly 2000 ns after the one before, no overrun
+//   2) SAMPLE_PERIOD = 40 SysClks - shorter than a CLKDIV 2 frame (69): overrun is flagged,
+//      cleared by IRQ_CLR
+//------------------------------------------------------------------------------
+task automatic SAMPLE_PERIOD_TEST;
+  bit [31:0] data;
+  bit [31:0] status;
+  begin
+    $display("Sample period test starts");
+    adc_sample_n = 0;
+    REG_WRITE(TB_REG_IRQ, 0);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN);
+    REG_WRITE(TB_REG_SAMPLE_PERIOD, 200);
+    adc_start_time.delete();
+    START_CAPTURE(16);
+    WAIT_IDLE();
+    CHECK("Paced conversions", 16, adc_start_time.size());
+    for (int n = 1; n < adc_start_time.size(); n++)
+      CHECK("Conversion start spacing (ns)", 2000, int'(adc_start_time[n] - adc_start_time[n - 1]));
+    REG_READ(TB_REG_STATUS, status);
+    CHECK("No overrun at 200 SysClks", 0, status & TB_STATUS_OVERRUN);
+    for (int n = 0; n < 16; n++) begin
+      REG_READ(TB_REG_FIFO_DATA, data);
+      CHECK("Paced sample", ADC_FIFO_WORD(n), data);
+    end
+
+    $display("Sample period overrun test starts");
+    REG_WRITE(TB_REG_SAMPLE_PERIOD, 40);
+    START_CAPTURE(8);
+    WAIT_IDLE();
+    REG_READ(TB_REG_STATUS, status);
+    CHECK("Overrun at 40 SysClks", TB_STATUS_OVERRUN, status & TB_STATUS_OVERRUN);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_CLR);
+    REG_READ(TB_REG_STATUS, status);
+    CHECK("Overrun cleared by IRQ_CLR", 0, status & TB_STATUS_OVERRUN);
+    REG_WRITE(TB_REG_SAMPLE_PERIOD, 0);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, 0);
+    $display("Sample period test complete: %0d checks, %0d errors", comparison_cnt, error_cnt);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// Back to back throughput per divider - FIFO enabled, SAMPLE_PERIOD = 0
+//   Every CS_n fall N + 15 * Tsclk + 1 + 6 SysClks after the one before (Tsclk = 2N, or
+//   2N - 1 with CLKDIV_ODD), CS_n high >= tQUIET (50 ns), SCLK high / low >= 0.4 x Tsclk
+//   and every sample intact.  The frame / rate table is printed for the header notes
+//------------------------------------------------------------------------------
+task automatic THROUGHPUT_TEST;
+  bit [31:0] data;
+  bit [31:0] ctrl;
+  int divider [5] = '{3, 4, 5, 3, 4};
+  bit odd [5] = '{0, 0, 0, 1, 1};
+  int sclk_period;
+  int frame;
+  begin
+    $display("Throughput test starts");
+    REG_WRITE(TB_REG_IRQ, 0);
+    REG_WRITE(TB_REG_SAMPLE_PERIOD, 0);
+    for (int d = 0; d < 5; d++) begin
+      sclk_period = (2 * divider[d]) - odd[d];
+      frame = divider[d] + (15 * sclk_period) + 1 + 6;
+      ctrl = TB_CTRL_EN | TB_CTRL_CONT | (divider[d] << 4) | (odd[d] ? TB_CTRL_CLKDIV_ODD : 0) | (8 << 8);
+      adc_sample_n = 0;
+      REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+      REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN);
+      REG_WRITE(TB_REG_CTRL, ctrl);
+      adc_start_time.delete();
+      adc_cs_rise = 0;
+      adc_min_quiet = 1.0e9;
+      adc_min_sclk_high = 1.0e9;
+      adc_min_sclk_low = 1.0e9;
+      REG_WRITE(TB_REG_CTRL, ctrl | TB_CTRL_START);
+      WAIT_IDLE();
+      CHECK("Back to back conversions", 8, adc_start_time.size());
+      for (int n = 1; n < adc_start_time.size(); n++)
+        CHECK("Frame (ns)", frame * 10, int'(adc_start_time[n] - adc_start_time[n - 1]));
+      CHECK("CS_n high >= tQUIET", 1, adc_min_quiet >= 50.0);
+      CHECK("SCLK high >= 0.4 tSCLK", 1, adc_min_sclk_high >= (0.4 * sclk_period * 10.0));
+      CHECK("SCLK low >= 0.4 tSCLK", 1, adc_min_sclk_low >= (0.4 * sclk_period * 10.0));
+      for (int n = 0; n < 8; n++) begin
+        REG_READ(TB_REG_FIFO_DATA, data);
+        CHECK("Back to back sample", ADC_FIFO_WORD(n), data);
+      end
+      $display("CLKDIV %0d%s: SCLK %0.2f MHz, frame %0d SysClks (%0.0f ns), %0.1f kSPS, CS_n high %0.0f ns",
+               divider[d], odd[d] ? " ODD" : "", 1000.0 / (sclk_period * 10.0), frame,
+               adc_start_time[1] - adc_start_time[0], 1.0e6 / (adc_start_time[1] - adc_start_time[0]), adc_min_quiet);
+    end
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, 0);
+    $display("Throughput test complete: %0d checks, %0d errors", comparison_cnt, error_cnt);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// Trigger engine - free running into the pre-trigger ring, one IRQ per record
+//   1) Rising edge on A at 0x128, hysteresis 8, PRE 16 / POST 32: ramp sample 40 triggers,
+//      the record is samples 24..71 and the engine stops after sample 71
+//   2) Level (ABOVE 0) with HOLDOFF 100, PRE 4 / POST 4: sample 100 triggers
+//   3) Rising edge on A at 0x110 with hysteresis 0x20: the ramp starts above 0xF0 so the
+//      edge never counts - FORCE after sample 40 triggers, PRE 8 / POST 8
+//   4) Falling edge on B at 0xF00 - 30, PRE 0 / POST 10: sample 30 triggers at index 0
+//------------------------------------------------------------------------------
+// Arm, free run and wait for the record IRQ (FORCE once force_at samples are taken if > 0)
+task automatic TRIGGER_CAPTURE(input [31:0] trig_ctrl, input [31:0] level, input [31:0] holdoff, input [31:0] record, input int force_at, output [31:0] trig_status);
+  int timeout;
+  begin
+    adc_sample_n = 0;
+    adc_irq_rise = 0;
+    REG_WRITE(TB_REG_TRIG_LEVEL, level);
+    REG_WRITE(TB_REG_TRIG_HOLDOFF, holdoff);
+    REG_WRITE(TB_REG_TRIG_RECORD, record);
+    REG_WRITE(TB_REG_TRIG_CTRL, trig_ctrl);
+    REG_WRITE(TB_REG_TRIG_CTRL, trig_ctrl | TB_TRIG_ARM);
+    REG_WRITE(TB_REG_TRIG_CTRL, trig_ctrl);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CLKDIV_2);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_FREE_RUN | TB_CTRL_CLKDIV_2 | TB_CTRL_START);
+    if (force_at > 0) begin
+      wait (adc_sample_n >= force_at);
+      CHECK("No trigger before FORCE", 0, adc_irq_rise);
+      REG_WRITE(TB_REG_TRIG_CTRL, trig_ctrl | TB_TRIG_FORCE);
+      REG_WRITE(TB_REG_TRIG_CTRL, trig_ctrl);
+    end
+    timeout = 0;
+    while (!adc_irq && (timeout < TB_IRQ_TIMEOUT)) begin
+      @(posedge clock);
+      timeout++;
+    end
+    if (!adc_irq) begin
+      $display("TESTBENCH ERROR! No trigger record IRQ");
+      result_slave = 0;
+      error_cnt = error_cnt + 1;
+    end
+    WAIT_IDLE();
+    REG_READ(TB_REG_TRIG_STATUS, trig_status);
+  end
+endtask
+
+// Record checks: index, done, FIFO count, samples first_n on, stop point, one IRQ cleared by IRQ_CLR
+task automatic TRIGGER_CHECK(input [31:0] trig_status, input int index, input int first_n, input int length);
+  bit [31:0] data;
+  bit [31:0] fifo_status;
+  begin
+    CHECK("Trigger index", index, trig_status[10:0]);
+    CHECK("Trigger state DONE", 3, trig_status[17:16]);
+    CHECK("Trigger done", 1, trig_status[20]);
+    CHECK("Engine stops after the record", first_n + length, adc_sample_n);
+    REG_READ(TB_REG_FIFO_STATUS, fifo_status);
+    CHECK("Record length", length, fifo_status[10:0]);
+    CHECK("FIFO_STATUS TRIG", TB_FIFO_TRIG, fifo_status & TB_FIFO_TRIG);
+    CHECK("No overflow", 0, fifo_status & TB_FIFO_OVF);
+    for (int n = 0; n < length; n++) begin
+      REG_READ(TB_REG_FIFO_DATA, data);
+      CHECK("Record sample", ADC_FIFO_WORD(first_n + n), data);
+    end
+    CHECK("IRQ held until acknowledged", 1, adc_irq);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    CHECK("IRQ low after IRQ_CLR", 0, adc_irq);
+    CHECK("One IRQ per record", 1, adc_irq_rise);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN);
+  end
+endtask
+
+task automatic TRIGGER_TEST;
+  bit [31:0] data;
+  bit [31:0] trig_status;
+  int first_n;
+  begin
+    $display("Trigger test starts");
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN);
+    REG_WRITE(TB_REG_SAMPLE_PERIOD, 0);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN);
+
+    TRIGGER_CAPTURE(TB_TRIG_EN | TB_TRIG_RISING, (8 << 16) | 12'h128, 0, (32 << 16) | 16, 0, trig_status);
+    TRIGGER_CHECK(trig_status, 16, 24, 48);
+
+    TRIGGER_CAPTURE(TB_TRIG_EN | TB_TRIG_ABOVE, 0, 100, (4 << 16) | 4, 0, trig_status);
+    TRIGGER_CHECK(trig_status, 4, 96, 8);
+
+    // FORCE lands on the first sample latched after the write - read the record start from the data
+    TRIGGER_CAPTURE(TB_TRIG_EN | TB_TRIG_RISING, (12'h020 << 16) | 12'h110, 0, (8 << 16) | 8, 40, trig_status);
+    REG_READ(TB_REG_FIFO_STATUS, data);
+    first_n = adc_sample_n - data[10:0];
+    CHECK("FORCE after sample 40", 1, first_n + 8 >= 40);
+    TRIGGER_CHECK(trig_status, 8, first_n, 16);
+
+    TRIGGER_CAPTURE(TB_TRIG_EN | TB_TRIG_FALLING | TB_TRIG_SOURCE_B, (4 << 16) | (12'hF00 - 30), 0, (10 << 16) | 0, 0, trig_status);
+    TRIGGER_CHECK(trig_status, 0, 30, 10);
+
+    REG_WRITE(TB_REG_TRIG_CTRL, 0);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, 0);
+    REG_WRITE(TB_REG_IRQ, 0);
+    $display("Trigger test complete: %0d checks, %0d errors", comparison_cnt, error_cnt);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// CIC decimator - counted captures into the FIFO, checked against a model of the
+// IP filter run over the ramp (pipelined integrators, R-th frame combs, priming)
+//   1) Order 1, R = 4, shift 0: each output is the sum of 4 ramp samples
+//   2) Order 3, R = 8, shift 5: first 2 outputs discarded, 6 delivered from 64 frames
+//   3) CIC left enabled, a single conversion bypasses it - DATA_A is the raw sample
+//------------------------------------------------------------------------------
+// Output k of channel A (or B) for the ramp from n = 0 - integrator k adds integrator k - 1 as it was
+function automatic [15:0] CIC_MODEL(input int order, input int ratio, input int shift, input int k, input bit channel_b);
+  longint integ [4];
+  longint delay [4];
+  longint comb;
+  longint scaled;
+  int outputs;
+  begin
+    integ = '{default:0};
+    delay = '{default:0};
+    outputs = 0;
+    CIC_MODEL = 0;
+    for (int n = 0; outputs <= k + order - 1; n++) begin
+      for (int stage = order - 1; stage > 0; stage--)
+        integ[stage] = integ[stage] + integ[stage - 1];
+      integ[0] = integ[0] + (channel_b ? (12'hF00 - n) : (12'h100 + n));
+      if ((n % ratio) == ratio - 1) begin
+        comb = integ[order - 1];
+        for (int stage = 0; stage < order; stage++) begin
+          scaled = comb;
+          comb = comb - delay[stage];
+          delay[stage] = scaled;
+        end
+        scaled = comb >>> shift;
+        if (outputs == k + order - 1)
+          CIC_MODEL = (scaled > 16'hFFFF) ? 16'hFFFF : scaled[15:0];
+        outputs++;
+      end
+    end
+  end
+endfunction
+
+task automatic CIC_CAPTURE(input int order, input int ratio, input int shift, input int count);
+  bit [31:0] data;
+  bit [31:0] fifo_status;
+  begin
+    adc_sample_n = 0;
+    REG_WRITE(TB_REG_CIC_CTRL, TB_CIC_EN | ((order - 1) << 4) | ((ratio - 1) << 8) | (shift << 16));
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN);
+    START_CAPTURE(count);
+    WAIT_IDLE();
+    CHECK("Frames for the decimated count", (count + order - 1) * ratio, adc_sample_n);
+    REG_READ(TB_REG_STATUS, data);
+    CHECK("Conversion count in outputs", count - 1, data[27:16]);
+    REG_READ(TB_REG_FIFO_STATUS, fifo_status);
+    CHECK("Decimated samples", count, fifo_status[10:0]);
+    for (int k = 0; k < count; k++) begin
+      REG_READ(TB_REG_FIFO_DATA, data);
+      CHECK("CIC sample", {CIC_MODEL(order, ratio, shift, k, 0), CIC_MODEL(order, ratio, shift, k, 1)}, data);
+    end
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+  end
+endtask
+
+task automatic CIC_TEST;
+  bit [31:0] data;
+  begin
+    $display("CIC test starts");
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN);
+    REG_WRITE(TB_REG_SAMPLE_PERIOD, 0);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN);
+
+    CIC_CAPTURE(1, 4, 0, 8);
+    CHECK("Order 1 output 0 is a 4 sample sum", 16'h0406, CIC_MODEL(1, 4, 0, 0, 0));
+    CIC_CAPTURE(3, 8, 5, 6);
+
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, 0);
+    adc_sample_n = 0;
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CLKDIV_2);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CLKDIV_2 | TB_CTRL_START);
+    WAIT_IDLE();
+    REG_READ(TB_REG_DATA_A, data);
+    CHECK("Single conversion bypasses the CIC", 12'h100, data);
+
+    REG_WRITE(TB_REG_CIC_CTRL, 0);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    REG_WRITE(TB_REG_IRQ, 0);
+    $display("CIC test complete: %0d checks, %0d errors", comparison_cnt, error_cnt);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// Capture done
+//   1) A FIFO capture with the IRQ off: STATUS DONE is set with BUSY low and every sample in
+//      the FIFO; drained, the IRQ stays low until DONE_EN is set - then DONE alone raises it
+//   2) IRQ_CLR drops the IRQ and DONE; the next capture start clears DONE too
+//------------------------------------------------------------------------------
+task automatic DONE_TEST;
+  bit [31:0] data;
+  bit [31:0] status;
+  begin
+    $display("Capture done test starts");
+    REG_WRITE(TB_REG_IRQ, 0);
+    REG_WRITE(TB_REG_SAMPLE_PERIOD, 0);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN);
+    START_CAPTURE(4);
+    WAIT_IDLE();
+    REG_READ(TB_REG_STATUS, status);
+    CHECK("DONE set with BUSY low", TB_STATUS_DONE, status & (TB_STATUS_DONE | 32'h1));
+    REG_READ(TB_REG_FIFO_STATUS, data);
+    CHECK("Every sample stored at DONE", 4, data[10:0]);
+    for (int n = 0; n < 4; n++)
+      REG_READ(TB_REG_FIFO_DATA, data);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN);
+    CHECK("No IRQ without DONE_EN", 0, adc_irq);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_DONE_EN);
+    CHECK("DONE raises the IRQ", 1, adc_irq);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_DONE_EN | TB_IRQ_CLR);
+    CHECK("IRQ_CLR drops the IRQ", 0, adc_irq);
+    REG_READ(TB_REG_STATUS, status);
+    CHECK("IRQ_CLR clears DONE", 0, status & TB_STATUS_DONE);
+
+    REG_WRITE(TB_REG_IRQ, 0);
+    START_CAPTURE(2);
+    WAIT_IDLE();
+    START_CAPTURE(2);
+    REG_READ(TB_REG_STATUS, status);
+    CHECK("Capture start clears DONE", 0, status & TB_STATUS_DONE);
+    WAIT_IDLE();
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, 0);
+    $display("Capture done test complete: %0d checks, %0d errors", comparison_cnt, error_cnt);
+  end
+endtask
 
 endmodule
@@ -22,6 +22,18 @@ proc create_ipi_design { offsetfile design_name } {
 	# Create port connections
 	connect_bd_net -net aclk_net [get_bd_ports ACLK] [get_bd_pins master_0/ACLK] [get_bd_pins IMR_ADC_7476A_X2_0/S00_AXI_ACLK]
 	connect_bd_net -net aresetn_net [get_bd_ports ARESETN] [get_bd_pins master_0/ARESETN] [get_bd_pins IMR_ADC_7476A_X2_0/S00_AXI_ARESETN]
+
+	# ADC pins and IRQ external so the test bench can attach an AD7476A model
+	create_bd_port -dir O ADC_SCLK
+	create_bd_port -dir O ADC_CS_n
+	create_bd_port -dir I ADC_MISO_A
+	create_bd_port -dir I ADC_MISO_B
+	create_bd_port -dir O -type intr IRQ
+	connect_bd_net [get_bd_ports ADC_SCLK] [get_bd_pins IMR_ADC_7476A_X2_0/ADC_SCLK]
+	connect_bd_net [get_bd_ports ADC_CS_n] [get_bd_pins IMR_ADC_7476A_X2_0/ADC_CS_n]
+	connect_bd_net [get_bd_ports ADC_MISO_A] [get_bd_pins IMR_ADC_7476A_X2_0/ADC_MISO_A]
+	connect_bd_net [get_bd_ports ADC_MISO_B] [get_bd_pins IMR_ADC_7476A_X2_0/ADC_MISO_B]
+	connect_bd_net [get_bd_ports IRQ] [get_bd_pins IMR_ADC_7476A_X2_0/IRQ]
 set_property target_simulator XSim [current_project]
 set_property -name {xsim.simulate.runtime} -value {100ms} -objects [get_filesets sim_1]
 
@@ -0,0 +1,1026 @@
+//------------------------------------------------------------------------------
+// ADC 7476A Dual-Channel Core Testbench (self checking, no Vivado VIP)
+//------------------------------------------------------------------------------
+// Description:
+//   Drives the IP top level (IMR_ADC_7476A_X2) with a plain AXI-Lite master, as
+//   the DMA testbench does, with the DMA writer left disabled.  The AD7476A model
+//   sees SCLK BOARD_OUT late and MISO reaches the IP BOARD_IN later still; from
+//   t7 (hold) to t4 (access) after each SCLK falling edge MISO carries the wrong
+//   bit, so a controller sampling outside the valid window reads bad data.  Every
+//   sample read back is checked against the conversion number.
+//
+// Tests:
+//   1. FIFO_THRESHOLD_TEST: counted capture drained on the threshold interrupt -
+//      IRQ at the threshold, low again once drained, the tail interrupt at the end.
+//   2. FIFO_OVERFLOW_TEST: capture larger than the FIFO, never drained - overflow
+//      interrupt, full FIFO holds the first 1024 samples, IRQ_CLR and flush.
+//   3. SAMPLE_PERIOD_TEST: CS_n falls exactly SAMPLE_PERIOD SysClks apart - with
+//      the period longer than or equal to the frame no overrun; one SysClk shorter
+//      every tick overruns; a single conversion never does.  FIFO disabled, a prompt
+//      DATA_AB reader keeps the grid, a slow one overruns without losing a sample.
+//   4. THROUGHPUT_TEST: back to back frames for N = 3, 4, 5, the odd divider and N < 3 (runs as 3) -
+//      SysClks per conversion, SCLK high / low phases, 16 SCLKs per frame, CS_n
+//      high for tQUIET, data read back through the worst case access time.
+//   5. RESULT_LATCH_TEST: FIFO disabled, back to back - a prompt DATA_AB reader
+//      does not slow the frame rate; a slow reader with RREADY held off by the
+//      interconnect still gets every sample, and RDATA holds while RVALID is high.
+//   6. TRIGGER_TEST: triangle wave on channel A, counter on B - rising / falling
+//      edges with hysteresis, level modes, holdoff and PRE holding off the trigger,
+//      FORCE, and hysteresis bands the wave never leaves, so the edges never re-arm.
+//      The trigger sample, the index, the record contents and the capture stop are
+//      checked against a model.
+//   7. CIC_TEST: pseudo random samples on both channels through every order, ratios
+//      1 to 256, shifts and saturation - each output is checked against a direct
+//      boxcar^N convolution of the input, through the FIFO and through DATA_AB.
+//
+// Run (from this directory): ./run.sh [iverilog | verilator | svsim], or by hand:
+//   iverilog -g2012 -I ../../hdl -o core_tb.vvp IMR_ADC_7476A_X2_Core_tb.sv \
+//     ../../hdl/IMR_ADC_7476A_X2.v ../../hdl/IMR_ADC_7476A_X2_slave_lite_v1_0_S00_AXI.v \
+//     ../../hdl/IMR_ADC_7476A_X2_Core.sv ../../hdl/IMR_ADC_7476A_X2_DMA_Writer.sv && vvp core_tb.vvp
+//   verilator --binary --timing -Wno-fatal -I../../hdl --top-module IMR_ADC_7476A_X2_Core_tb \
+//     IMR_ADC_7476A_X2_Core_tb.sv ../../hdl/*.v ../../hdl/*.sv && ./obj_dir/VIMR_ADC_7476A_X2_Core_tb
+//------------------------------------------------------------------------------
+`timescale 1ns / 1ps
+
+module IMR_ADC_7476A_X2_Core_tb();
+
+localparam        C_S_AXI_ADDR_WIDTH = 7;
+localparam        C_M_AXI_ADDR_WIDTH = 32;
+
+int                                     error_cnt = 0;
+int                                     comparison_cnt = 0;
+bit                                     clock;
+bit                                     reset;
+
+//------------------------------------------------------------------------------
+// DUT
+//------------------------------------------------------------------------------
+// AXI-Lite master
+logic [C_S_AXI_ADDR_WIDTH-1:0]          s_awaddr = '0;
+logic                                   s_awvalid = 1'b0;
+wire                                    s_awready;
+logic [31:0]                            s_wdata = '0;
+logic                                   s_wvalid = 1'b0;
+wire                                    s_wready;
+wire [1:0]                              s_bresp;
+wire                                    s_bvalid;
+logic                                   s_bready = 1'b1;
+logic [C_S_AXI_ADDR_WIDTH-1:0]          s_araddr = '0;
+logic                                   s_arvalid = 1'b0;
+wire                                    s_arready;
+wire [31:0]                             s_rdata;
+wire [1:0]                              s_rresp;
+wire                                    s_rvalid;
+logic                                   s_rready = 1'b1;
+int                                     s_rready_delay = 0;   // ACLKs RREADY is held off after RVALID
+
+// AXI4 write master - DMA disabled, must stay quiet
+wire [C_M_AXI_ADDR_WIDTH-1:0]           m_awaddr;
+wire [7:0]                              m_awlen;
+wire [2:0]                              m_awsize;
+wire [1:0]                              m_awburst;
+wire                                    m_awlock;
+wire [3:0]                              m_awcache;
+wire [2:0]                              m_awprot;
+wire                                    m_awvalid;
+wire [31:0]                             m_wdata;
+wire [3:0]                              m_wstrb;
+wire                                    m_wlast;
+wire                                    m_wvalid;
+wire                                    m_bready;
+
+// ADC pins
+wire                                    adc_sclk;
+wire                                    adc_cs_n;
+wire                                    adc_irq;
+wire                                    adc_miso_a;
+wire                                    adc_miso_b;
+
+IMR_ADC_7476A_X2 #
+(
+  .C_S00_AXI_DATA_WIDTH(32),
+  .C_S00_AXI_ADDR_WIDTH(C_S_AXI_ADDR_WIDTH),
+  .C_M00_AXI_ADDR_WIDTH(C_M_AXI_ADDR_WIDTH)
+) DUT
+(
+  .ADC_SCLK(adc_sclk),
+  .ADC_CS_n(adc_cs_n),
+  .ADC_MISO_A(adc_miso_a),
+  .ADC_MISO_B(adc_miso_b),
+  .IRQ(adc_irq),
+  .m00_axi_awaddr(m_awaddr),
+  .m00_axi_awlen(m_awlen),
+  .m00_axi_awsize(m_awsize),
+  .m00_axi_awburst(m_awburst),
+  .m00_axi_awlock(m_awlock),
+  .m00_axi_awcache(m_awcache),
+  .m00_axi_awprot(m_awprot),
+  .m00_axi_awvalid(m_awvalid),
+  .m00_axi_awready(1'b0),
+  .m00_axi_wdata(m_wdata),
+  .m00_axi_wstrb(m_wstrb),
+  .m00_axi_wlast(m_wlast),
+  .m00_axi_wvalid(m_wvalid),
+  .m00_axi_wready(1'b0),
+  .m00_axi_bresp(2'b00),
+  .m00_axi_bvalid(1'b0),
+  .m00_axi_bready(m_bready),
+  .s00_axi_aclk(clock),
+  .s00_axi_aresetn(reset),
+  .s00_axi_awaddr(s_awaddr),
+  .s00_axi_awprot(3'b000),
+  .s00_axi_awvalid(s_awvalid),
+  .s00_axi_awready(s_awready),
+  .s00_axi_wdata(s_wdata),
+  .s00_axi_wstrb(4'hF),
+  .s00_axi_wvalid(s_wvalid),
+  .s00_axi_wready(s_wready),
+  .s00_axi_bresp(s_bresp),
+  .s00_axi_bvalid(s_bvalid),
+  .s00_axi_bready(s_bready),
+  .s00_axi_araddr(s_araddr),
+  .s00_axi_arprot(3'b000),
+  .s00_axi_arvalid(s_arvalid),
+  .s00_axi_arready(s_arready),
+  .s00_axi_rdata(s_rdata),
+  .s00_axi_rresp(s_rresp),
+  .s00_axi_rvalid(s_rvalid),
+  .s00_axi_rready(s_rready)
+);
+
+always #5 clock <= ~clock;
+
+//------------------------------------------------------------------------------
+// AD7476A x2 behavioral model
+//   CS_n falling loads the frame {4'b0000, sample} - the leading zero is on MISO
+//   at once; each SCLK falling edge shifts the next bit out ADC_T4 later, and MISO
+//   is wrong from ADC_T7 until then (board delays added both ways).
+//   ADC_VALUE gives the sample of conversion n, so any read back can be checked.
+//   WAVE_COUNT: A = 12'h100 + n, B = 12'hF00 - n (as bfm_design)
+//   WAVE_TRIANGLE: A = 0 .. 4064 and back every 256 conversions, B as WAVE_COUNT
+//   WAVE_RANDOM: A and B pseudo random (hash of n), full 12 bit range
+//------------------------------------------------------------------------------
+localparam        ADC_T4 = 40;              // ns, data access after SCLK falling (AD7476A t4 max)
+localparam        ADC_T7 = 10;              // ns, data hold after SCLK falling (AD7476A t7 min)
+localparam        BOARD_OUT = 6;            // ns, SCLK clock to pad and trace to the ADC
+localparam        BOARD_IN = 3;             // ns, MISO trace and pad to the shift register
+localparam        WAVE_COUNT = 0;
+localparam        WAVE_TRIANGLE = 1;
+localparam        WAVE_RANDOM = 2;
+logic [15:0]                            adc_frame_a;
+logic [15:0]                            adc_frame_b;
+logic                                   adc_bit_bad = 1'b0;   // MISO in the t7 - t4 window
+int                                     adc_sample_n = 0;
+int                                     adc_wave = WAVE_COUNT;
+
+function automatic [11:0] ADC_VALUE(input bit channel_b, input int n);
+  logic [31:0] hash;
+  hash = (n + 1) * 32'h9E3779B1;
+  hash = hash ^ (hash >> 15);
+  if (adc_wave == WAVE_RANDOM)
+    ADC_VALUE = channel_b ? hash[27:16] : hash[11:0];
+  else if (channel_b)
+    ADC_VALUE = 12'hF00 - n[11:0];
+  else if (adc_wave == WAVE_TRIANGLE)
+    ADC_VALUE = n[7] ? {~n[6:0], 5'd0} : {n[6:0], 5'd0};
+  else
+    ADC_VALUE = 12'h100 + n[11:0];
+endfunction
+
+function automatic [31:0] ADC_FIFO_WORD(input int n);
+  ADC_FIFO_WORD = {8'h00, ADC_VALUE(0, n), ADC_VALUE(1, n)};
+endfunction
+
+always @(negedge adc_cs_n) begin
+  adc_frame_a = {4'b0000, ADC_VALUE(0, adc_sample_n)};
+  adc_frame_b = {4'b0000, ADC_VALUE(1, adc_sample_n)};
+  adc_sample_n = adc_sample_n + 1;
+end
+always @(negedge adc_sclk) begin
+  if (!adc_cs_n) begin
+    #(BOARD_OUT + ADC_T7 + BOARD_IN);
+    adc_bit_bad = 1'b1;
+    #(ADC_T4 - ADC_T7);
+    adc_frame_a = {adc_frame_a[14:0], 1'b0};
+    adc_frame_b = {adc_frame_b[14:0], 1'b0};
+    adc_bit_bad = 1'b0;
+  end
+end
+// The wrong bit is the inverse of the next one - neither the old nor the new value
+assign adc_miso_a = adc_cs_n ? 1'b0 : (adc_bit_bad ? ~adc_frame_a[14] : adc_frame_a[15]);
+assign adc_miso_b = adc_cs_n ? 1'b0 : (adc_bit_bad ? ~adc_frame_b[14] : adc_frame_b[15]);
+
+//------------------------------------------------------------------------------
+// Register map - see hdl/IMR_ADC_7476A_X2_Def.vh
+//------------------------------------------------------------------------------
+localparam [31:0] TB_REG_CTRL         = 32'h00;
+localparam [31:0] TB_REG_STATUS       = 32'h04;
+localparam [31:0] TB_REG_IRQ          = 32'h10;
+localparam [31:0] TB_REG_FIFO_CTRL    = 32'h14;
+localparam [31:0] TB_REG_FIFO_STATUS  = 32'h18;
+localparam [31:0] TB_REG_FIFO_DATA    = 32'h1C;
+localparam [31:0] TB_REG_DATA_AB      = 32'h20;
+localparam [31:0] TB_REG_SAMPLE_PERIOD = 32'h3C;
+localparam [31:0] TB_REG_TRIG_CTRL    = 32'h40;
+localparam [31:0] TB_REG_TRIG_LEVEL   = 32'h44;
+localparam [31:0] TB_REG_TRIG_HOLDOFF = 32'h48;
+localparam [31:0] TB_REG_TRIG_RECORD  = 32'h4C;
+localparam [31:0] TB_REG_TRIG_STATUS  = 32'h50;
+localparam [31:0] TB_REG_CIC_CTRL     = 32'h54;
+localparam [31:0] TB_CTRL_EN          = 32'h00000001;
+localparam [31:0] TB_CTRL_START       = 32'h00000002;
+localparam [31:0] TB_CTRL_CONT        = 32'h00000004;
+localparam [31:0] TB_CTRL_FREE_RUN    = 32'h00000008;
+localparam [31:0] TB_CTRL_CLKDIV_3    = 32'h00000030;
+localparam [31:0] TB_CTRL_CLKDIV_ODD  = 32'h00100000;
+localparam [31:0] TB_STATUS_BUSY      = 32'h00000001;
+localparam [31:0] TB_STATUS_OVERRUN   = 32'h00000020;
+localparam [31:0] TB_IRQ_EN           = 32'h00000001;
+localparam [31:0] TB_IRQ_CLR          = 32'h00000002;
+localparam [31:0] TB_IRQ_AUTO_ACK     = 32'h00000004;
+localparam [31:0] TB_FIFO_EN          = 32'h00010000;
+localparam [31:0] TB_FIFO_FLUSH       = 32'h00020000;
+localparam [31:0] TB_FIFO_COUNT       = 32'h000007FF;
+localparam [31:0] TB_FIFO_THRESH      = 32'h00010000;
+localparam [31:0] TB_FIFO_OVF         = 32'h00020000;
+localparam [31:0] TB_FIFO_EMPTY       = 32'h00040000;
+localparam [31:0] TB_FIFO_FULL        = 32'h00080000;
+localparam [31:0] TB_FIFO_TAIL        = 32'h00100000;
+localparam [31:0] TB_FIFO_TRIG        = 32'h00200000;
+localparam [31:0] TB_TRIG_EN          = 32'h00000001;
+localparam [31:0] TB_TRIG_ARM         = 32'h00000002;
+localparam [31:0] TB_TRIG_FORCE       = 32'h00000004;
+localparam [31:0] TB_TRIG_SOURCE_B    = 32'h00000008;
+localparam        TB_TRIG_ABOVE       = 0;
+localparam        TB_TRIG_RISING      = 1;
+localparam        TB_TRIG_FALLING     = 2;
+localparam        TB_TRIG_BELOW       = 3;
+localparam [31:0] TB_TRIG_INDEX       = 32'h000007FF;
+localparam [31:0] TB_TRIG_STATE_DONE  = 32'h00030000;
+localparam [31:0] TB_TRIG_DONE        = 32'h00100000;
+localparam [31:0] TB_CIC_EN           = 32'h00000001;
+localparam        TB_FIFO_DEPTH       = 1024;
+localparam        TB_TIMEOUT          = 2000000;  // ACLK cycles
+localparam        TB_THRESH_LEVEL     = 64;       // FIFO_THRESHOLD_TEST
+localparam        TB_THRESH_CONVERSIONS = 500;
+localparam        TB_OVF_CONVERSIONS  = 1100;     // FIFO_OVERFLOW_TEST
+localparam        TB_PERIOD_CONVERSIONS = 40;     // SAMPLE_PERIOD_TEST
+localparam        TB_RATE_CONVERSIONS = 24;       // THROUGHPUT_TEST
+localparam        TB_LATCH_CONVERSIONS = 30;      // RESULT_LATCH_TEST
+
+//------------------------------------------------------------------------------
+// AXI-Lite master tasks - address and data together, as the MicroBlaze does
+//------------------------------------------------------------------------------
+task automatic REG_WRITE(input [31:0] addr, input [31:0] data);
+  begin
+    @(posedge clock);
+    s_awaddr <= addr[C_S_AXI_ADDR_WIDTH-1:0];
+    s_wdata <= data;
+    s_awvalid <= 1'b1;
+    s_wvalid <= 1'b1;
+    do @(posedge clock); while (!s_awready);
+    s_awvalid <= 1'b0;
+    s_wvalid <= 1'b0;
+    while (!s_bvalid) @(posedge clock);
+  end
+endtask
+
+task automatic REG_READ(input [31:0] addr, output [31:0] data);
+  logic [31:0] first;
+  begin
+    @(posedge clock);
+    s_araddr <= addr[C_S_AXI_ADDR_WIDTH-1:0];
+    s_arvalid <= 1'b1;
+    s_rready <= (s_rready_delay == 0);
+    do @(posedge clock); while (!s_arready);
+    s_arvalid <= 1'b0;
+    do @(posedge clock); while (!s_rvalid);
+    if (s_rready_delay != 0) begin
+      // Interconnect back pressure - RDATA must hold until the handshake
+      first = s_rdata;
+      repeat (s_rready_delay) @(posedge clock);
+      s_rready <= 1'b1;
+      @(posedge clock);
+      if (s_rdata !== first)
+        CHECK("RDATA held while RVALID", first, s_rdata);
+    end
+    data = s_rdata;
+  end
+endtask
+
+task automatic CHECK(input string what, input [31:0] expected, input [31:0] actual);
+  begin
+    if (actual !== expected) begin
+      $display("TESTBENCH ERROR! %s expected = 0x%h actual = 0x%h", what, expected, actual);
+      error_cnt = error_cnt + 1;
+    end
+    comparison_cnt = comparison_cnt + 1;
+  end
+endtask
+
+// The DMA writer is never enabled here
+always @(posedge clock)
+  if (reset && m_awvalid)
+    CHECK("No DMA burst", 32'h0, 32'h1);
+
+//------------------------------------------------------------------------------
+// CS_n monitor - SysClks from one CS_n fall (the AD7476A sample instant) to the
+// next and CS_n high time, min / max over a capture (cleared by CAPTURE_START)
+//------------------------------------------------------------------------------
+int                                     cs_cycle = 0;
+int                                     cs_fall_cycle;
+int                                     cs_rise_cycle;
+int                                     cs_period_min;
+int                                     cs_period_max;
+int                                     cs_period_cnt;
+int                                     cs_high_min;
+bit                                     cs_q = 1'b1;
+// SCLK phases inside a frame - the low phase before the first rising edge and the
+// high phase cut by CS_n are not whole phases and are skipped
+int                                     sclk_high_min;
+int                                     sclk_high_max;
+int                                     sclk_low_min;
+int                                     sclk_low_max;
+int                                     sclk_rises;
+int                                     sclk_rises_bad;   // frames without exactly 16 SCLKs
+int                                     sclk_run;
+bit                                     sclk_q = 1'b0;
+
+task automatic CS_STATS_CLEAR;
+  begin
+    cs_fall_cycle = -1;
+    cs_period_min = 32'h7FFFFFFF;
+    cs_period_max = 0;
+    cs_period_cnt = 0;
+    cs_high_min = 32'h7FFFFFFF;
+    sclk_high_min = 32'h7FFFFFFF;
+    sclk_high_max = 0;
+    sclk_low_min = 32'h7FFFFFFF;
+    sclk_low_max = 0;
+    sclk_rises_bad = 0;
+  end
+endtask
+
+always @(posedge clock) begin
+  cs_cycle = cs_cycle + 1;
+  if (cs_q && !adc_cs_n) begin
+    if (cs_fall_cycle >= 0) begin
+      if (cs_cycle - cs_fall_cycle < cs_period_min)
+        cs_period_min = cs_cycle - cs_fall_cycle;
+      if (cs_cycle - cs_fall_cycle > cs_period_max)
+        cs_period_max = cs_cycle - cs_fall_cycle;
+      if (cs_cycle - cs_rise_cycle < cs_high_min)
+        cs_high_min = cs_cycle - cs_rise_cycle;
+      cs_period_cnt = cs_period_cnt + 1;
+    end
+    cs_fall_cycle = cs_cycle;
+  end
+  if (!cs_q && adc_cs_n) begin
+    cs_rise_cycle = cs_cycle;
+    if (sclk_rises != 16)
+      sclk_rises_bad = sclk_rises_bad + 1;
+  end
+  if (adc_cs_n) begin
+    sclk_rises = 0;
+    sclk_run = 0;
+  end
+  else if (adc_sclk != sclk_q) begin
+    if (adc_sclk) begin
+      if ((sclk_rises != 0) && (sclk_run < sclk_low_min))
+        sclk_low_min = sclk_run;
+      if ((sclk_rises != 0) && (sclk_run > sclk_low_max))
+        sclk_low_max = sclk_run;
+      sclk_rises = sclk_rises + 1;
+    end
+    else begin
+      if (sclk_run < sclk_high_min)
+        sclk_high_min = sclk_run;
+      if (sclk_run > sclk_high_max)
+        sclk_high_max = sclk_run;
+    end
+    sclk_run = 1;
+  end
+  else
+    sclk_run = sclk_run + 1;
+  cs_q = adc_cs_n;
+  sclk_q = adc_sclk;
+end
+
+//------------------------------------------------------------------------------
+// Software side - the driver's FIFO path in SV
+//------------------------------------------------------------------------------
+int                                     fifo_n;   // Conversion number of the next FIFO word
+
+task automatic CAPTURE_START(input [31:0] ctrl);
+  begin
+    CS_STATS_CLEAR();
+    adc_sample_n = 0;
+    fifo_n = 0;
+    REG_WRITE(TB_REG_CTRL, ctrl);
+    REG_WRITE(TB_REG_CTRL, ctrl | TB_CTRL_START);
+  end
+endtask
+
+task automatic WAIT_IDLE;
+  logic [31:0] status;
+  int timeout;
+  begin
+    timeout = 0;
+    do begin
+      repeat (100) @(posedge clock);
+      timeout = timeout + 100;
+      REG_READ(TB_REG_STATUS, status);
+    end while ((status & TB_STATUS_BUSY) && (timeout < TB_TIMEOUT));
+    CHECK("Engine idle", 32'h0, status & TB_STATUS_BUSY);
+  end
+endtask
+
+// Pop and check count samples
+task automatic FIFO_DRAIN(input int count);
+  logic [31:0] data;
+  begin
+    repeat (count) begin
+      REG_READ(TB_REG_FIFO_DATA, data);
+      CHECK($sformatf("FIFO sample %0d", fifo_n), ADC_FIFO_WORD(fifo_n), data);
+      fifo_n = fifo_n + 1;
+    end
+  end
+endtask
+
+task automatic FIFO_TEARDOWN;
+  begin
+    REG_WRITE(TB_REG_CTRL, 32'h0);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, 32'h0);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// 1. Threshold interrupt - drain on each, tail interrupt at the end
+//------------------------------------------------------------------------------
+task automatic FIFO_THRESHOLD_TEST;
+  logic [31:0] flags;
+  int irqs;
+  int timeout;
+  bit tail;
+  begin
+    $display("FIFO threshold test starts");
+    irqs = 0;
+    tail = 0;
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_THRESH_LEVEL);
+    CAPTURE_START(TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_3 | (TB_THRESH_CONVERSIONS << 8));
+    timeout = 0;
+    while (!tail && (timeout < TB_TIMEOUT)) begin
+      @(posedge clock);
+      timeout = timeout + 1;
+      if (adc_irq) begin
+        REG_READ(TB_REG_FIFO_STATUS, flags);
+        irqs = irqs + 1;
+        CHECK("No overflow", 32'h0, flags & TB_FIFO_OVF);
+        if (flags & TB_FIFO_TAIL) begin
+          // End of the capture below threshold
+          tail = 1;
+          CHECK("Tail below threshold", 32'h0, flags & TB_FIFO_THRESH);
+          CHECK("Tail sample count", TB_THRESH_CONVERSIONS - fifo_n, flags & TB_FIFO_COUNT);
+        end
+        else begin
+          // Raised by the sample reaching the threshold - serviced before the next one lands
+          CHECK("Threshold flag", TB_FIFO_THRESH, flags & TB_FIFO_THRESH);
+          CHECK("Count at the threshold interrupt", TB_THRESH_LEVEL, flags & TB_FIFO_COUNT);
+        end
+        FIFO_DRAIN(flags & TB_FIFO_COUNT);
+        // Drained below threshold - the interrupt drops without an acknowledge (unless the tail follows)
+        REG_READ(TB_REG_FIFO_STATUS, flags);
+        if (!(flags & TB_FIFO_TAIL))
+          CHECK("IRQ low after the drain", 32'h0, {31'd0, adc_irq});
+      end
+    end
+    CHECK("Tail interrupt", 32'h1, {31'd0, tail});
+    CHECK("Samples through the FIFO", TB_THRESH_CONVERSIONS, fifo_n);
+    REG_READ(TB_REG_FIFO_STATUS, flags);
+    CHECK("FIFO empty", TB_FIFO_EMPTY, flags & (TB_FIFO_EMPTY | TB_FIFO_COUNT));
+    WAIT_IDLE();
+    FIFO_TEARDOWN();
+    $display("FIFO threshold test: %0d samples, %0d interrupts", fifo_n, irqs);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// 2. Overflow - the full FIFO keeps the oldest samples, IRQ_CLR and flush
+//------------------------------------------------------------------------------
+task automatic FIFO_OVERFLOW_TEST;
+  logic [31:0] flags;
+  int timeout;
+  begin
+    $display("FIFO overflow test starts");
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN);
+    CAPTURE_START(TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_3 | (TB_OVF_CONVERSIONS << 8));
+    // Threshold 0 - nothing interrupts until a sample is dropped
+    timeout = 0;
+    while (!adc_irq && (timeout < TB_TIMEOUT)) begin
+      @(posedge clock);
+      timeout = timeout + 1;
+    end
+    CHECK("Overflow on conversion 1025", TB_FIFO_DEPTH + 1, adc_sample_n);
+    REG_READ(TB_REG_FIFO_STATUS, flags);
+    CHECK("Full and overflow", TB_FIFO_OVF | TB_FIFO_FULL | TB_FIFO_DEPTH,
+          flags & (TB_FIFO_OVF | TB_FIFO_FULL | TB_FIFO_EMPTY | TB_FIFO_COUNT));
+    WAIT_IDLE();
+    CHECK("Every conversion made", TB_OVF_CONVERSIONS, adc_sample_n);
+    // The first 1024 samples, the rest dropped
+    FIFO_DRAIN(TB_FIFO_DEPTH);
+    REG_READ(TB_REG_FIFO_STATUS, flags);
+    CHECK("Empty, overflow still flagged", TB_FIFO_OVF | TB_FIFO_EMPTY,
+          flags & (TB_FIFO_OVF | TB_FIFO_FULL | TB_FIFO_EMPTY | TB_FIFO_COUNT));
+    CHECK("IRQ held by the overflow", 32'h1, {31'd0, adc_irq});
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    REG_READ(TB_REG_FIFO_STATUS, flags);
+    CHECK("Overflow cleared by IRQ_CLR", 32'h0, flags & TB_FIFO_OVF);
+    CHECK("IRQ low after IRQ_CLR", 32'h0, {31'd0, adc_irq});
+
+    // Flush: a short capture left in the FIFO raises the tail interrupt, FLUSH empties it
+    CAPTURE_START(TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_3 | (10 << 8));
+    WAIT_IDLE();
+    REG_READ(TB_REG_FIFO_STATUS, flags);
+    CHECK("Tail of 10", TB_FIFO_TAIL | 32'd10, flags & (TB_FIFO_TAIL | TB_FIFO_EMPTY | TB_FIFO_COUNT));
+    CHECK("Tail IRQ", 32'h1, {31'd0, adc_irq});
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN);
+    REG_READ(TB_REG_FIFO_STATUS, flags);
+    CHECK("Flushed", TB_FIFO_EMPTY, flags & (TB_FIFO_TAIL | TB_FIFO_EMPTY | TB_FIFO_COUNT));
+    CHECK("IRQ low after the flush", 32'h0, {31'd0, adc_irq});
+    FIFO_TEARDOWN();
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// 3. Sample period - conversion starts on the SysClk grid, overrun detection
+//------------------------------------------------------------------------------
+// Counted capture into the FIFO, paced at period - returns the STATUS read at the end
+task automatic PERIOD_FIFO_RUN(input int period, output [31:0] status);
+  begin
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN);
+    REG_WRITE(TB_REG_SAMPLE_PERIOD, period);
+    CAPTURE_START(TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_3 | (TB_PERIOD_CONVERSIONS << 8));
+    WAIT_IDLE();
+    REG_READ(TB_REG_STATUS, status);
+    FIFO_DRAIN(TB_PERIOD_CONVERSIONS);
+    CHECK("Conversion starts", TB_PERIOD_CONVERSIONS - 1, cs_period_cnt);
+  end
+endtask
+
+// FIFO disabled: the ISR reads DATA_AB (auto acknowledge) latency ACLKs after each IRQ
+task automatic PERIOD_DATA_AB_RUN(input int period, input int latency, output [31:0] status);
+  logic [31:0] data;
+  logic [7:0] sequence_n;
+  int n;
+  int timeout;
+  begin
+    n = 0;
+    REG_WRITE(TB_REG_FIFO_CTRL, 32'h0);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_AUTO_ACK | TB_IRQ_CLR);
+    REG_WRITE(TB_REG_SAMPLE_PERIOD, period);
+    CAPTURE_START(TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_3 | (TB_PERIOD_CONVERSIONS << 8));
+    timeout = 0;
+    while ((n < TB_PERIOD_CONVERSIONS) && (timeout < TB_TIMEOUT)) begin
+      @(posedge clock);
+      timeout = timeout + 1;
+      if (adc_irq) begin
+        repeat (latency) @(posedge clock);
+        REG_READ(TB_REG_DATA_AB, data);
+        CHECK($sformatf("DATA_AB sample %0d", n), ADC_FIFO_WORD(n) & 32'h00FFFFFF, data & 32'h00FFFFFF);
+        if ((n != 0) && (data[31:24] != sequence_n + 8'd1))
+          CHECK("DATA_AB sequence", {24'd0, sequence_n + 8'd1}, {24'd0, data[31:24]});
+        sequence_n = data[31:24];
+        n = n + 1;
+      end
+    end
+    CHECK("Every result read", TB_PERIOD_CONVERSIONS, n);
+    WAIT_IDLE();
+    REG_READ(TB_REG_STATUS, status);
+    CHECK("Conversion starts", TB_PERIOD_CONVERSIONS - 1, cs_period_cnt);
+  end
+endtask
+
+task automatic SAMPLE_PERIOD_TEST;
+  logic [31:0] status;
+  begin
+    $display("Sample period test starts");
+    // N = 3: the frame is 101 SysClks
+    PERIOD_FIFO_RUN(250, status);
+    CHECK("Period 250: min", 32'd250, cs_period_min);
+    CHECK("Period 250: max", 32'd250, cs_period_max);
+    CHECK("Period 250: no overrun", 32'h0, status & TB_STATUS_OVERRUN);
+    PERIOD_FIFO_RUN(101, status);
+    CHECK("Period 101: min", 32'd101, cs_period_min);
+    CHECK("Period 101: max", 32'd101, cs_period_max);
+    CHECK("Period 101 = frame: no overrun", 32'h0, status & TB_STATUS_OVERRUN);
+    // One SysClk short of the frame - every tick overruns, the frames run back to back
+    PERIOD_FIFO_RUN(100, status);
+    CHECK("Period 100: back to back", 32'd101, cs_period_min);
+    CHECK("Period 100: overrun", TB_STATUS_OVERRUN, status & TB_STATUS_OVERRUN);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    REG_READ(TB_REG_STATUS, status);
+    CHECK("Overrun cleared by IRQ_CLR", 32'h0, status & TB_STATUS_OVERRUN);
+    // A single conversion has no period slot to miss - a period shorter than the frame is not an overrun
+    REG_WRITE(TB_REG_SAMPLE_PERIOD, 32'd50);
+    CAPTURE_START(TB_CTRL_EN | TB_CTRL_CLKDIV_3);
+    WAIT_IDLE();
+    REG_READ(TB_REG_STATUS, status);
+    CHECK("Single conversion period 50: no overrun", 32'h0, status & TB_STATUS_OVERRUN);
+    FIFO_DRAIN(1);
+    $display("Sample period test: FIFO paced 250 / 101 / 100 SysClks, single conversion at 50");
+
+    // FIFO disabled: the result latch overlaps the next frame - a reader within the period keeps the grid
+    PERIOD_DATA_AB_RUN(300, 20, status);
+    CHECK("DATA_AB period 300: min", 32'd300, cs_period_min);
+    CHECK("DATA_AB period 300: max", 32'd300, cs_period_max);
+    CHECK("DATA_AB period 300: no overrun", 32'h0, status & TB_STATUS_OVERRUN);
+    // A reader slower than the period holds the next frame - flagged, nothing lost
+    PERIOD_DATA_AB_RUN(300, 450, status);
+    CHECK("DATA_AB slow reader: overrun", TB_STATUS_OVERRUN, status & TB_STATUS_OVERRUN);
+    if (cs_period_min < 300)
+      CHECK("DATA_AB slow reader: never early", 32'd300, cs_period_min);
+    REG_WRITE(TB_REG_SAMPLE_PERIOD, 32'h0);
+    FIFO_TEARDOWN();
+    $display("Sample period test: DATA_AB paced 300 SysClks, slow reader %0d - %0d SysClks", cs_period_min, cs_period_max);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// 4. Throughput - back to back frames, SCLK divider
+//   Frame = N + 15 * Tsclk + 2 + tQUIET (6), Tsclk = 2N (2N - 1 odd); N below 3 runs as 3
+//------------------------------------------------------------------------------
+task automatic RATE_RUN(input int n, input bit odd, input int frame, input int high, input int low);
+  string name;
+  begin
+    name = $sformatf("N=%0d%s", n, odd ? " odd" : "");
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN);
+    CAPTURE_START(TB_CTRL_EN | TB_CTRL_CONT | (odd ? TB_CTRL_CLKDIV_ODD : 32'h0) | (n << 4) | (TB_RATE_CONVERSIONS << 8));
+    WAIT_IDLE();
+    FIFO_DRAIN(TB_RATE_CONVERSIONS);
+    CHECK($sformatf("%s conversion starts", name), TB_RATE_CONVERSIONS - 1, cs_period_cnt);
+    CHECK($sformatf("%s SysClks per conversion min", name), frame, cs_period_min);
+    CHECK($sformatf("%s SysClks per conversion max", name), frame, cs_period_max);
+    CHECK($sformatf("%s SCLK high min", name), high, sclk_high_min);
+    CHECK($sformatf("%s SCLK high max", name), high, sclk_high_max);
+    CHECK($sformatf("%s SCLK low min", name), low, sclk_low_min);
+    CHECK($sformatf("%s SCLK low max", name), low, sclk_low_max);
+    CHECK($sformatf("%s frames of 16 SCLKs", name), 32'h0, sclk_rises_bad);
+    CHECK($sformatf("%s CS_n high (tQUIET)", name), 32'd6, cs_high_min);
+    $display("Throughput %s: %0d SysClks per conversion (%0d.%03d MSPS), SCLK high %0d low %0d SysClks",
+             name, cs_period_min, 100 / cs_period_min, (100000 / cs_period_min) % 1000, sclk_high_min, sclk_low_min);
+  end
+endtask
+
+task automatic THROUGHPUT_TEST;
+  begin
+    $display("Throughput test starts");
+    RATE_RUN(3, 0, 101, 3, 3);
+    RATE_RUN(3, 1,  86, 2, 3);
+    RATE_RUN(4, 0, 132, 4, 4);
+    RATE_RUN(4, 1, 117, 3, 4);
+    RATE_RUN(5, 0, 163, 5, 5);
+    // The divider field clamps to 3 - a smaller N would run SCLK past the AD7476A limit
+    RATE_RUN(2, 0, 101, 3, 3);
+    RATE_RUN(1, 1,  86, 2, 3);
+    RATE_RUN(0, 0, 101, 3, 3);
+    FIFO_TEARDOWN();
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// 5. Result latch - FIFO disabled, back to back, DATA_AB with auto acknowledge
+//------------------------------------------------------------------------------
+task automatic LATCH_RUN(input int latency, input int rready_delay);
+  logic [31:0] data;
+  logic [7:0] sequence_n;
+  int n;
+  int timeout;
+  begin
+    n = 0;
+    s_rready_delay = 0;
+    REG_WRITE(TB_REG_FIFO_CTRL, 32'h0);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_AUTO_ACK | TB_IRQ_CLR);
+    CAPTURE_START(TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_3 | (TB_LATCH_CONVERSIONS << 8));
+    s_rready_delay = rready_delay;
+    timeout = 0;
+    while ((n < TB_LATCH_CONVERSIONS) && (timeout < TB_TIMEOUT)) begin
+      @(posedge clock);
+      timeout = timeout + 1;
+      if (adc_irq) begin
+        repeat (latency) @(posedge clock);
+        REG_READ(TB_REG_DATA_AB, data);
+        CHECK($sformatf("DATA_AB sample %0d", n), ADC_FIFO_WORD(n) & 32'h00FFFFFF, data & 32'h00FFFFFF);
+        if ((n != 0) && (data[31:24] != sequence_n + 8'd1))
+          CHECK("DATA_AB sequence", {24'd0, sequence_n + 8'd1}, {24'd0, data[31:24]});
+        sequence_n = data[31:24];
+        n = n + 1;
+      end
+    end
+    s_rready_delay = 0;
+    CHECK("Every result read", TB_LATCH_CONVERSIONS, n);
+    WAIT_IDLE();
+    CHECK("Conversions made", TB_LATCH_CONVERSIONS, adc_sample_n);
+  end
+endtask
+
+task automatic RESULT_LATCH_TEST;
+  begin
+    $display("Result latch test starts");
+    // Read within the frame - the latch overlaps QUIET and the next SHIFT, no stall
+    LATCH_RUN(0, 0);
+    CHECK("Prompt reader: SysClks per conversion min", 32'd101, cs_period_min);
+    CHECK("Prompt reader: SysClks per conversion max", 32'd101, cs_period_max);
+    $display("Result latch test: prompt reader %0d SysClks per conversion", cs_period_max);
+    // Slower than a frame - the next result waits in the shift registers, CS_n held high
+    LATCH_RUN(150, 0);
+    if (cs_period_min < 101)
+      CHECK("Slow reader: never faster than a frame", 32'd101, cs_period_min);
+    $display("Result latch test: slow reader %0d - %0d SysClks per conversion", cs_period_min, cs_period_max);
+    // Same with RREADY held off - the acknowledge latches the waiting result during the read
+    LATCH_RUN(150, 8);
+    FIFO_TEARDOWN();
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// 6. Trigger engine - pre / post record around the trigger sample
+//------------------------------------------------------------------------------
+// The documented condition, sample by sample: no trigger for max(HOLDOFF, PRE) samples
+// after ARM, edges re-arm once the source has been beyond the hysteresis band
+function automatic int TRIG_EXPECT(input int mode, input bit source_b, input int level, input int hyst,
+                                   input int holdoff, input int pre);
+  int hold;
+  int value;
+  bit edge_armed;
+  bit fire;
+  begin
+    hold = (holdoff > pre) ? holdoff : pre;
+    edge_armed = 0;
+    TRIG_EXPECT = -1;
+    for (int n = 0; (n < 4096) && (TRIG_EXPECT < 0); n++) begin
+      value = ADC_VALUE(source_b, n);
+      case (mode)
+        TB_TRIG_ABOVE:   fire = (value >= level);
+        TB_TRIG_RISING:  fire = edge_armed && (value >= level);
+        TB_TRIG_FALLING: fire = edge_armed && (value <= level);
+        default:         fire = (value <= level);
+      endcase
+      if ((n >= hold) && fire)
+        TRIG_EXPECT = n;
+      if ((mode == TB_TRIG_RISING) && (level - hyst >= 0) && (value < level - hyst))
+        edge_armed = 1;
+      if ((mode == TB_TRIG_FALLING) && (value > level + hyst))
+        edge_armed = 1;
+    end
+  end
+endfunction
+
+// Arm, free run until the record is done (FORCE after force_at conversions if not 0),
+// check status, stop and record - returns the trigger conversion
+task automatic TRIG_RUN(input int mode, input bit source_b, input int level, input int hyst, input int holdoff,
+                        input int pre, input int post, input int force_at, output int trig_n);
+  logic [31:0] ctrl;
+  logic [31:0] flags;
+  logic [31:0] trig_status;
+  logic [31:0] data;
+  int expect_n;
+  int index;
+  int timeout;
+  begin
+    ctrl = TB_TRIG_EN | (source_b ? TB_TRIG_SOURCE_B : 32'h0) | (mode << 4);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN);
+    REG_WRITE(TB_REG_TRIG_LEVEL, level | (hyst << 16));
+    REG_WRITE(TB_REG_TRIG_HOLDOFF, holdoff);
+    REG_WRITE(TB_REG_TRIG_RECORD, pre | (post << 16));
+    REG_WRITE(TB_REG_TRIG_CTRL, ctrl);
+    REG_WRITE(TB_REG_TRIG_CTRL, ctrl | TB_TRIG_ARM);
+    CAPTURE_START(TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_FREE_RUN | TB_CTRL_CLKDIV_3);
+    expect_n = TRIG_EXPECT(mode, source_b, level, hyst, holdoff, pre);
+    if (force_at != 0) begin
+      while ((adc_sample_n < force_at) && !adc_irq)
+        @(posedge clock);
+      REG_WRITE(TB_REG_TRIG_CTRL, ctrl | TB_TRIG_ARM | TB_TRIG_FORCE);
+    end
+    // The record complete is the only interrupt
+    timeout = 0;
+    while (!adc_irq && (timeout < TB_TIMEOUT)) begin
+      @(posedge clock);
+      timeout = timeout + 1;
+    end
+    REG_READ(TB_REG_TRIG_STATUS, trig_status);
+    REG_READ(TB_REG_FIFO_STATUS, flags);
+    CHECK("Record done", TB_TRIG_DONE | TB_TRIG_STATE_DONE, trig_status & (TB_TRIG_DONE | TB_TRIG_STATE_DONE));
+    CHECK("FIFO_STATUS TRIG", TB_FIFO_TRIG, flags & (TB_FIFO_TRIG | TB_FIFO_OVF));
+    index = trig_status & TB_TRIG_INDEX;
+    CHECK("Trigger index = PRE", pre, index);
+    CHECK("Record length = PRE + POST", pre + post, flags & TB_FIFO_COUNT);
+    // The capture stops after the frame in flight - nothing more is stored
+    WAIT_IDLE();
+    REG_READ(TB_REG_FIFO_STATUS, flags);
+    CHECK("Nothing stored after the record", pre + post, flags & TB_FIFO_COUNT);
+    // The trigger sample - channel B counts conversions
+    REG_READ(TB_REG_FIFO_DATA, data);
+    fifo_n = 32'hF00 - data[11:0] + 1;
+    trig_n = fifo_n - 1 + index;
+    CHECK("First record sample", ADC_FIFO_WORD(trig_n - index), data);
+    if (force_at != 0) begin
+      // adc_sample_n counts conversions started - force_at - 1 is the one in flight
+      if ((trig_n < force_at - 1) || (trig_n > force_at + 1))
+        CHECK("Forced on the next sample", force_at, trig_n);
+    end
+    else
+      CHECK("Trigger sample", expect_n, trig_n);
+    FIFO_DRAIN(pre + post - 1);
+    if (adc_sample_n > trig_n + post + 2)
+      CHECK("Capture stopped after the record", trig_n + post, adc_sample_n);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    REG_READ(TB_REG_TRIG_STATUS, trig_status);
+    CHECK("DONE cleared by IRQ_CLR", 32'h0, trig_status & TB_TRIG_DONE);
+    CHECK("IRQ low after IRQ_CLR", 32'h0, {31'd0, adc_irq});
+    REG_WRITE(TB_REG_CTRL, 32'h0);
+    REG_WRITE(TB_REG_TRIG_CTRL, 32'h0);
+  end
+endtask
+
+task automatic TRIGGER_TEST;
+  int trig_n;
+  begin
+    $display("Trigger test starts");
+    adc_wave = WAVE_TRIANGLE;
+    TRIG_RUN(TB_TRIG_RISING, 0, 2000, 100, 0, 32, 64, 0, trig_n);
+    $display("Trigger test: rising 2000 on A at conversion %0d, PRE 32 POST 64", trig_n);
+    TRIG_RUN(TB_TRIG_FALLING, 0, 1000, 200, 300, 100, 50, 0, trig_n);
+    $display("Trigger test: falling 1000 on A after holdoff 300 at conversion %0d, PRE 100 POST 50", trig_n);
+    TRIG_RUN(TB_TRIG_BELOW, 1, 12'hE00, 0, 0, 8, 8, 0, trig_n);
+    $display("Trigger test: below 0xE00 on B at conversion %0d, PRE 8 POST 8", trig_n);
+    TRIG_RUN(TB_TRIG_ABOVE, 0, 0, 0, 50, 10, 1, 0, trig_n);
+    $display("Trigger test: above 0 on A after holdoff 50 at conversion %0d, PRE 10 POST 1", trig_n);
+    TRIG_RUN(TB_TRIG_ABOVE, 0, 0, 0, 5, 20, 4, 0, trig_n);
+    $display("Trigger test: above 0 on A after PRE 20 at conversion %0d, POST 4", trig_n);
+    // LEVEL - HYST = 0: the triangle never goes below it, the edges at conversions 4 and 260 never fire
+    TRIG_RUN(TB_TRIG_RISING, 0, 100, 100, 0, 4, 4, 300, trig_n);
+    $display("Trigger test: forced at conversion %0d, PRE 4 POST 4", trig_n);
+    // LEVEL + HYST = 4064, the triangle peak: the falling edge at conversion 130 never fires
+    TRIG_RUN(TB_TRIG_FALLING, 0, 4000, 64, 0, 4, 4, 200, trig_n);
+    $display("Trigger test: forced at conversion %0d, PRE 4 POST 4", trig_n);
+    // LEVEL - HYST below 0: the rising edges at conversions 63, 319 and 575 never fire - FORCE ends it
+    TRIG_RUN(TB_TRIG_RISING, 0, 2000, 2500, 0, 16, 16, 600, trig_n);
+    $display("Trigger test: forced at conversion %0d, PRE 16 POST 16", trig_n);
+    adc_wave = WAVE_COUNT;
+    FIFO_TEARDOWN();
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// 7. CIC decimator - outputs against a direct convolution
+//------------------------------------------------------------------------------
+// Order N, ratio R: h = boxcar(R) convolved N times.  Output j completes at conversion
+// (j + N) * R - 1; the pipelined integrators see that conversion N - 1 frames late
+longint cic_coef [0:1023];
+longint cic_coef_last [0:1023];             // h before the current boxcar
+int     cic_taps;
+
+task automatic CIC_COEF(input int order, input int ratio);
+  begin
+    cic_coef[0] = 1;
+    cic_taps = 1;
+    repeat (order) begin
+      for (int k = 0; k < cic_taps; k++)
+        cic_coef_last[k] = cic_coef[k];
+      cic_taps = cic_taps + ratio - 1;
+      for (int k = 0; k < cic_taps; k++)
+        cic_coef[k] = ((k > 0) ? cic_coef[k - 1] : 0) + ((k < cic_taps - ratio + 1) ? cic_coef_last[k] : 0) -
+                      ((k >= ratio) ? cic_coef_last[k - ratio] : 0);
+    end
+  end
+endtask
+
+function automatic [15:0] CIC_EXPECT(input bit channel_b, input int j, input int order, input int ratio,
+                                     input int shift);
+  longint sum;
+  int t;
+  begin
+    sum = 0;
+    t = (j + order) * ratio - order;
+    for (int k = 0; (k < cic_taps) && (k <= t); k++)
+      sum = sum + cic_coef[k] * ADC_VALUE(channel_b, t - k);
+    sum = sum >>> shift;
+    CIC_EXPECT = (sum > 65535) ? 16'hFFFF : sum[15:0];
+  end
+endfunction
+
+function automatic [31:0] CIC_WORD(input int j, input int order, input int ratio, input int shift);
+  CIC_WORD = {CIC_EXPECT(0, j, order, ratio, shift), CIC_EXPECT(1, j, order, ratio, shift)};
+endfunction
+
+// count outputs through the FIFO (fifo_on) or DATA_AB read on each IRQ; returns the saturated outputs
+task automatic CIC_RUN(input int order, input int ratio, input int shift, input int count, input bit fifo_on,
+                       output int saturated);
+  logic [31:0] data;
+  logic [31:0] expected;
+  int n;
+  int timeout;
+  begin
+    saturated = 0;
+    CIC_COEF(order, ratio);
+    REG_WRITE(TB_REG_CIC_CTRL, TB_CIC_EN | ((order - 1) << 4) | ((ratio - 1) << 8) | (shift << 16));
+    if (fifo_on) begin
+      REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+      REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+      REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN);
+    end
+    else begin
+      REG_WRITE(TB_REG_FIFO_CTRL, 32'h0);
+      REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_AUTO_ACK | TB_IRQ_CLR);
+    end
+    CAPTURE_START(TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_3 | (count << 8));
+    n = 0;
+    if (fifo_on) begin
+      WAIT_IDLE();
+      REG_READ(TB_REG_FIFO_STATUS, data);
+      CHECK("CIC outputs stored", count, data & TB_FIFO_COUNT);
+    end
+    timeout = 0;
+    while ((n < count) && (timeout < TB_TIMEOUT)) begin
+      if (fifo_on)
+        REG_READ(TB_REG_FIFO_DATA, data);
+      else begin
+        while (!adc_irq && (timeout < TB_TIMEOUT)) begin
+          @(posedge clock);
+          timeout = timeout + 1;
+        end
+        REG_READ(TB_REG_DATA_AB, data);
+      end
+      expected = CIC_WORD(n, order, ratio, shift);
+      CHECK($sformatf("CIC N=%0d R=%0d output %0d", order, ratio, n), expected, data);
+      if ((expected[31:16] == 16'hFFFF) || (expected[15:0] == 16'hFFFF))
+        saturated = saturated + 1;
+      n = n + 1;
+    end
+    WAIT_IDLE();
+    // CONT_CNT counts outputs: R conversions each, plus the N - 1 filling the filter
+    CHECK("Conversions per CIC capture", ratio * (count + order - 1), adc_sample_n);
+    REG_WRITE(TB_REG_CTRL, 32'h0);
+    REG_WRITE(TB_REG_CIC_CTRL, 32'h0);
+  end
+endtask
+
+task automatic CIC_TEST;
+  int saturated;
+  begin
+    $display("CIC test starts");
+    adc_wave = WAVE_RANDOM;
+    REG_WRITE(TB_REG_SAMPLE_PERIOD, 32'h0);
+    CIC_RUN(1, 1, 0, 16, 1, saturated);
+    $display("CIC test: N=1 R=1 shift 0 (bypass equivalent), 16 outputs");
+    CIC_RUN(3, 8, 5, 16, 1, saturated);
+    $display("CIC test: N=3 R=8 shift 5, 16 outputs, %0d saturated", saturated);
+    CIC_RUN(2, 5, 0, 16, 1, saturated);
+    $display("CIC test: N=2 R=5 shift 0, 16 outputs, %0d saturated", saturated);
+    CIC_RUN(4, 16, 12, 8, 1, saturated);
+    $display("CIC test: N=4 R=16 shift 12, 8 outputs, %0d saturated", saturated);
+    CIC_RUN(2, 256, 16, 3, 1, saturated);
+    $display("CIC test: N=2 R=256 shift 16, 3 outputs, %0d saturated", saturated);
+    CIC_RUN(2, 4, 3, 12, 0, saturated);
+    $display("CIC test: N=2 R=4 shift 3 through DATA_AB, 12 outputs, %0d saturated", saturated);
+    adc_wave = WAVE_COUNT;
+    FIFO_TEARDOWN();
+  end
+endtask
+
+initial begin
+  reset <= 1'b0;
+  #200ns;
+  reset <= 1'b1;
+  repeat (10) @(posedge clock);
+  FIFO_THRESHOLD_TEST ( );
+  FIFO_OVERFLOW_TEST ( );
+  SAMPLE_PERIOD_TEST ( );
+  THROUGHPUT_TEST ( );
+  RESULT_LATCH_TEST ( );
+  TRIGGER_TEST ( );
+  CIC_TEST ( );
+  $display("---------------------------------------------------------");
+  $display("CORE TEST: %0d checks, %0d errors", comparison_cnt, error_cnt);
+  if (error_cnt == 0)
+    $display("CORE TEST: PASSED!");
+  else
+    $display("CORE TEST: FAILED!");
+  $display("---------------------------------------------------------");
+  $finish;
+end
+
+endmodule
@@ -0,0 +1,38 @@
+#!/bin/sh
+#------------------------------------------------------------------------------
+# ADC 7476A Dual-Channel Core Testbench - runner
+#------------------------------------------------------------------------------
+# Usage: ./run.sh [iverilog | verilator | svsim]
+#   Runs IMR_ADC_7476A_X2_Core_tb.sv with the named simulator, by default the first
+#   of iverilog and verilator found on the PATH, then the 2-state interpreter in
+#   ../svsim (Python 3 only).  Exits non-zero unless the testbench prints
+#   "CORE TEST: PASSED!".
+#------------------------------------------------------------------------------
+cd "$(dirname "$0")" || exit 1
+
+TOP=IMR_ADC_7476A_X2_Core_tb
+HDL="../../hdl/IMR_ADC_7476A_X2.v ../../hdl/IMR_ADC_7476A_X2_slave_lite_v1_0_S00_AXI.v \
+     ../../hdl/IMR_ADC_7476A_X2_Core.sv ../../hdl/IMR_ADC_7476A_X2_DMA_Writer.sv"
+
+SIM=$1
+if [ -z "$SIM" ]; then
+  if command -v iverilog >/dev/null 2>&1; then SIM=iverilog
+  elif command -v verilator >/dev/null 2>&1; then SIM=verilator
+  else SIM=svsim
+  fi
+fi
+
+case "$SIM" in
+  iverilog)
+    iverilog -g2012 -I ../../hdl -o core_tb.vvp $TOP.sv $HDL && vvp core_tb.vvp > core_tb.log ;;
+  verilator)
+    verilator --binary --timing -Wno-fatal -I../../hdl --top-module $TOP $TOP.sv $HDL && \
+      ./obj_dir/V$TOP > core_tb.log ;;
+  svsim)
+    python3 ../svsim/svsim.py -I ../../hdl --top $TOP $TOP.sv $HDL > core_tb.log ;;
+  *)
+    echo "usage: $0 [iverilog | verilator | svsim]" >&2; exit 2 ;;
+esac
+STATUS=$?
+tail -n 3 core_tb.log 2>/dev/null
+[ $STATUS -eq 0 ] && grep -q "CORE TEST: PASSED!" core_tb.log
@@ -0,0 +1,582 @@
+//------------------------------------------------------------------------------
+// ADC 7476A Dual-Channel DMA Writer Testbench (self checking, no Vivado VIP)
+//------------------------------------------------------------------------------
+// Description:
+//   Drives the IP top level (IMR_ADC_7476A_X2) with a plain AXI-Lite master and
+//   answers its M00_AXI write bursts with an AXI4 slave memory model standing in
+//   for the MIG DDR3 behind the SmartConnect.  AWREADY / WREADY / BVALID are held
+//   off at random so the writer sees back pressure.  The AD7476A model is the one
+//   in bfm_design: channel A = 12'h100 + n, channel B = 12'hF00 - n, so every
+//   sample in the ring is checked against the conversion number.
+//
+// Tests:
+//   1. DMA_BLOCK_TEST: 300 counted conversions into a 256 byte ring that straddles
+//      a 4KB boundary.  Software consumes on the block interrupt and sometimes
+//      sleeps so the ring fills and the writer stalls.  Ends on DMA done.
+//   2. DMA_FREE_RUN_TEST: free running capture, consumed on block interrupts,
+//      stopped by dropping START - the tail lands and DMA done follows.
+//   3. DMA_LINE_TEST: two counted captures into one ring without a rewind - the
+//      first ends on a short tail burst, so the second starts mid line and its
+//      first burst must stop at the 64 byte line.
+//   4. DMA_ERROR_TEST: one burst answered with SLVERR - error flag and IRQ.
+//
+// Protocol checks on every burst: INCR, 4 byte beats, at most 16 beats, AWLEN + 1
+// beats with WLAST on the last only, inside the ring, no 64 byte line or 4KB crossing.
+//
+// Run (from this directory): ./run.sh [iverilog | verilator | svsim], or by hand:
+//   iverilog -g2012 -I ../../hdl -o dma_tb.vvp IMR_ADC_7476A_X2_DMA_tb.sv \
+//     ../../hdl/IMR_ADC_7476A_X2.v ../../hdl/IMR_ADC_7476A_X2_slave_lite_v1_0_S00_AXI.v \
+//     ../../hdl/IMR_ADC_7476A_X2_Core.sv ../../hdl/IMR_ADC_7476A_X2_DMA_Writer.sv && vvp dma_tb.vvp
+//   verilator --binary --timing -Wno-fatal -I../../hdl --top-module IMR_ADC_7476A_X2_DMA_tb \
+//     IMR_ADC_7476A_X2_DMA_tb.sv ../../hdl/*.v ../../hdl/*.sv && ./obj_dir/VIMR_ADC_7476A_X2_DMA_tb
+//------------------------------------------------------------------------------
+`timescale 1ns / 1ps
+
+module IMR_ADC_7476A_X2_DMA_tb();
+
+localparam        C_S_AXI_ADDR_WIDTH = 7;
+localparam        C_M_AXI_ADDR_WIDTH = 32;
+
+int                                     error_cnt = 0;
+int                                     comparison_cnt = 0;
+bit                                     clock;
+bit                                     reset;
+
+//------------------------------------------------------------------------------
+// DUT
+//------------------------------------------------------------------------------
+// AXI-Lite master
+logic [C_S_AXI_ADDR_WIDTH-1:0]          s_awaddr = '0;
+logic                                   s_awvalid = 1'b0;
+wire                                    s_awready;
+logic [31:0]                            s_wdata = '0;
+logic                                   s_wvalid = 1'b0;
+wire                                    s_wready;
+wire [1:0]                              s_bresp;
+wire                                    s_bvalid;
+logic                                   s_bready = 1'b1;
+logic [C_S_AXI_ADDR_WIDTH-1:0]          s_araddr = '0;
+logic                                   s_arvalid = 1'b0;
+wire                                    s_arready;
+wire [31:0]                             s_rdata;
+wire [1:0]                              s_rresp;
+wire                                    s_rvalid;
+logic                                   s_rready = 1'b1;
+
+// AXI4 write slave (memory model)
+wire [C_M_AXI_ADDR_WIDTH-1:0]           m_awaddr;
+wire [7:0]                              m_awlen;
+wire [2:0]                              m_awsize;
+wire [1:0]                              m_awburst;
+wire                                    m_awlock;
+wire [3:0]                              m_awcache;
+wire [2:0]                              m_awprot;
+wire                                    m_awvalid;
+logic                                   m_awready = 1'b0;
+wire [31:0]                             m_wdata;
+wire [3:0]                              m_wstrb;
+wire                                    m_wlast;
+wire                                    m_wvalid;
+logic                                   m_wready = 1'b0;
+logic [1:0]                             m_bresp = 2'b00;
+logic                                   m_bvalid = 1'b0;
+wire                                    m_bready;
+
+// ADC pins
+wire                                    adc_sclk;
+wire                                    adc_cs_n;
+wire                                    adc_irq;
+wire                                    adc_miso_a;
+wire                                    adc_miso_b;
+
+IMR_ADC_7476A_X2 #
+(
+  .C_S00_AXI_DATA_WIDTH(32),
+  .C_S00_AXI_ADDR_WIDTH(C_S_AXI_ADDR_WIDTH),
+  .C_M00_AXI_ADDR_WIDTH(C_M_AXI_ADDR_WIDTH)
+) DUT
+(
+  .ADC_SCLK(adc_sclk),
+  .ADC_CS_n(adc_cs_n),
+  .ADC_MISO_A(adc_miso_a),
+  .ADC_MISO_B(adc_miso_b),
+  .IRQ(adc_irq),
+  .m00_axi_awaddr(m_awaddr),
+  .m00_axi_awlen(m_awlen),
+  .m00_axi_awsize(m_awsize),
+  .m00_axi_awburst(m_awburst),
+  .m00_axi_awlock(m_awlock),
+  .m00_axi_awcache(m_awcache),
+  .m00_axi_awprot(m_awprot),
+  .m00_axi_awvalid(m_awvalid),
+  .m00_axi_awready(m_awready),
+  .m00_axi_wdata(m_wdata),
+  .m00_axi_wstrb(m_wstrb),
+  .m00_axi_wlast(m_wlast),
+  .m00_axi_wvalid(m_wvalid),
+  .m00_axi_wready(m_wready),
+  .m00_axi_bresp(m_bresp),
+  .m00_axi_bvalid(m_bvalid),
+  .m00_axi_bready(m_bready),
+  .s00_axi_aclk(clock),
+  .s00_axi_aresetn(reset),
+  .s00_axi_awaddr(s_awaddr),
+  .s00_axi_awprot(3'b000),
+  .s00_axi_awvalid(s_awvalid),
+  .s00_axi_awready(s_awready),
+  .s00_axi_wdata(s_wdata),
+  .s00_axi_wstrb(4'hF),
+  .s00_axi_wvalid(s_wvalid),
+  .s00_axi_wready(s_wready),
+  .s00_axi_bresp(s_bresp),
+  .s00_axi_bvalid(s_bvalid),
+  .s00_axi_bready(s_bready),
+  .s00_axi_araddr(s_araddr),
+  .s00_axi_arprot(3'b000),
+  .s00_axi_arvalid(s_arvalid),
+  .s00_axi_arready(s_arready),
+  .s00_axi_rdata(s_rdata),
+  .s00_axi_rresp(s_rresp),
+  .s00_axi_rvalid(s_rvalid),
+  .s00_axi_rready(s_rready)
+);
+
+always #5 clock <= ~clock;
+
+//------------------------------------------------------------------------------
+// AD7476A x2 behavioral model (as bfm_design)
+//------------------------------------------------------------------------------
+logic [15:0]                            adc_frame_a;
+logic [15:0]                            adc_frame_b;
+logic [11:0]                            adc_sample_n = 0;
+
+function automatic [31:0] ADC_FIFO_WORD(input [11:0] n);
+  ADC_FIFO_WORD = {8'h00, 12'h100 + n, 12'hF00 - n};
+endfunction
+
+always @(negedge adc_cs_n) begin
+  adc_frame_a = {4'b0000, 12'h100 + adc_sample_n};
+  adc_frame_b = {4'b0000, 12'hF00 - adc_sample_n};
+  adc_sample_n = adc_sample_n + 1;
+end
+always @(negedge adc_sclk) begin
+  if (!adc_cs_n) begin
+    adc_frame_a = {adc_frame_a[14:0], 1'b0};
+    adc_frame_b = {adc_frame_b[14:0], 1'b0};
+  end
+end
+assign adc_miso_a = adc_cs_n ? 1'b0 : adc_frame_a[15];
+assign adc_miso_b = adc_cs_n ? 1'b0 : adc_frame_b[15];
+
+//------------------------------------------------------------------------------
+// Register map - see hdl/IMR_ADC_7476A_X2_Def.vh
+//------------------------------------------------------------------------------
+localparam [31:0] TB_REG_CTRL         = 32'h00;
+localparam [31:0] TB_REG_STATUS       = 32'h04;
+localparam [31:0] TB_REG_IRQ          = 32'h10;
+localparam [31:0] TB_REG_FIFO_CTRL    = 32'h14;
+localparam [31:0] TB_REG_FIFO_STATUS  = 32'h18;
+localparam [31:0] TB_REG_DMA_CTRL     = 32'h24;
+localparam [31:0] TB_REG_DMA_BASE     = 32'h28;
+localparam [31:0] TB_REG_DMA_SIZE     = 32'h2C;
+localparam [31:0] TB_REG_DMA_BLOCK    = 32'h30;
+localparam [31:0] TB_REG_DMA_PRODUCER = 32'h34;
+localparam [31:0] TB_REG_DMA_CONSUMER = 32'h38;
+localparam [31:0] TB_CTRL_EN          = 32'h00000001;
+localparam [31:0] TB_CTRL_START       = 32'h00000002;
+localparam [31:0] TB_CTRL_CONT        = 32'h00000004;
+localparam [31:0] TB_CTRL_FREE_RUN    = 32'h00000008;
+localparam [31:0] TB_CTRL_CLKDIV_2    = 32'h00000020;
+localparam [31:0] TB_IRQ_EN           = 32'h00000001;
+localparam [31:0] TB_IRQ_CLR          = 32'h00000002;
+localparam [31:0] TB_FIFO_EN          = 32'h00010000;
+localparam [31:0] TB_FIFO_FLUSH       = 32'h00020000;
+localparam [31:0] TB_FIFO_OVF         = 32'h00020000;
+localparam [31:0] TB_DMA_EN           = 32'h00000001;
+localparam [31:0] TB_DMA_RESET        = 32'h00000002;
+localparam [31:0] TB_DMA_BLOCK        = 32'h01000000;
+localparam [31:0] TB_DMA_ERR          = 32'h02000000;
+localparam [31:0] TB_DMA_DONE         = 32'h04000000;
+localparam [31:0] TB_DMA_STALL        = 32'h08000000;
+localparam        TB_TIMEOUT          = 2000000;  // ACLK cycles
+
+//------------------------------------------------------------------------------
+// AXI-Lite master tasks - address and data together, as the MicroBlaze does
+//------------------------------------------------------------------------------
+task automatic REG_WRITE(input [31:0] addr, input [31:0] data);
+  begin
+    @(posedge clock);
+    s_awaddr <= addr[C_S_AXI_ADDR_WIDTH-1:0];
+    s_wdata <= data;
+    s_awvalid <= 1'b1;
+    s_wvalid <= 1'b1;
+    do @(posedge clock); while (!s_awready);
+    s_awvalid <= 1'b0;
+    s_wvalid <= 1'b0;
+    while (!s_bvalid) @(posedge clock);
+  end
+endtask
+
+task automatic REG_READ(input [31:0] addr, output [31:0] data);
+  begin
+    @(posedge clock);
+    s_araddr <= addr[C_S_AXI_ADDR_WIDTH-1:0];
+    s_arvalid <= 1'b1;
+    do @(posedge clock); while (!s_arready);
+    s_arvalid <= 1'b0;
+    do @(posedge clock); while (!s_rvalid);
+    data = s_rdata;
+  end
+endtask
+
+task automatic CHECK(input string what, input [31:0] expected, input [31:0] actual);
+  begin
+    if (actual !== expected) begin
+      $display("TESTBENCH ERROR! %s expected = 0x%h actual = 0x%h", what, expected, actual);
+      error_cnt = error_cnt + 1;
+    end
+    comparison_cnt = comparison_cnt + 1;
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// AXI4 slave memory model - DDR behind the SmartConnect
+//   One outstanding burst, as the writer issues.  mem_stall_pct of the cycles
+//   hold AWREADY / WREADY low; bresp_error answers the next burst with SLVERR.
+//------------------------------------------------------------------------------
+localparam [31:0] MEM_BASE  = 32'h8000_0000;
+localparam        MEM_WORDS = 2048;         // 8KB window - rings live in here
+logic [31:0]                            mem [0:MEM_WORDS-1];
+int                                     mem_stall_pct = 30;
+bit                                     bresp_error = 0;
+logic [31:0]                            ring_base;
+logic [31:0]                            ring_bytes;
+int                                     burst_cnt = 0;
+int                                     burst_full_cnt = 0;   // 16 beats - a whole 64 byte line
+logic [31:0]                            burst_addr_log [0:255];
+logic [7:0]                             burst_len_log [0:255];
+
+logic [31:0]                            wr_addr;
+logic [8:0]                             wr_beats;
+logic [8:0]                             wr_beat;
+bit                                     wr_active = 0;
+
+always @(posedge clock) begin
+  if (!reset) begin
+    m_awready <= 1'b0;
+    m_wready <= 1'b0;
+    m_bvalid <= 1'b0;
+    wr_active <= 0;
+  end
+  else begin
+    // Address
+    m_awready <= !wr_active && !m_bvalid && ($urandom_range(99) >= mem_stall_pct);
+    if (m_awvalid && m_awready) begin
+      wr_addr <= m_awaddr;
+      wr_beats <= m_awlen + 1;
+      wr_beat <= 0;
+      wr_active <= 1;
+      burst_cnt <= burst_cnt + 1;
+      burst_addr_log[burst_cnt[7:0]] <= m_awaddr;
+      burst_len_log[burst_cnt[7:0]] <= m_awlen;
+      if (m_awlen == 8'd15)
+        burst_full_cnt <= burst_full_cnt + 1;
+      m_awready <= 1'b0;
+      if (m_awburst !== 2'b01)
+        CHECK("AWBURST INCR", 32'h1, {30'd0, m_awburst});
+      if (m_awsize !== 3'b010)
+        CHECK("AWSIZE 4 bytes", 32'h2, {29'd0, m_awsize});
+      if (m_awaddr[1:0] !== 2'b00)
+        CHECK("AWADDR word aligned", 32'h0, {30'd0, m_awaddr[1:0]});
+      if (m_awlen > 8'd15)
+        CHECK("Burst of 16 beats at most", 32'd15, {24'd0, m_awlen});
+      if (((m_awaddr & 32'h3F) + ((m_awlen + 1) * 4)) > 32'h40)
+        CHECK("Burst crosses a 64 byte line", 32'h0, m_awaddr);
+      if (((m_awaddr & 32'hFFF) + ((m_awlen + 1) * 4)) > 32'h1000)
+        CHECK("Burst crosses 4KB", 32'h0, m_awaddr);
+      if ((m_awaddr < ring_base) || ((m_awaddr + (m_awlen + 1) * 4) > (ring_base + ring_bytes)))
+        CHECK("Burst inside the ring", ring_base, m_awaddr);
+    end
+    // Data
+    m_wready <= wr_active && ($urandom_range(99) >= mem_stall_pct);
+    if (m_wvalid && m_wready && wr_active) begin
+      if (m_wstrb !== 4'hF)
+        CHECK("WSTRB", 32'hF, {28'd0, m_wstrb});
+      if (m_wlast !== (wr_beat == wr_beats - 1))
+        CHECK("WLAST on the last beat only", {31'd0, (wr_beat == wr_beats - 1)}, {31'd0, m_wlast});
+      mem[(wr_addr - MEM_BASE) >> 2] <= m_wdata;
+      wr_addr <= wr_addr + 4;
+      wr_beat <= wr_beat + 1;
+      if (wr_beat == wr_beats - 1) begin
+        wr_active <= 0;
+        m_wready <= 1'b0;
+        m_bvalid <= 1'b1;
+        m_bresp <= bresp_error ? 2'b10 : 2'b00;
+        bresp_error <= 0;
+      end
+    end
+    else if (m_wvalid && !wr_active)
+      CHECK("WVALID before AW", 32'h0, 32'h1);
+    // Response
+    if (m_bvalid && m_bready)
+      m_bvalid <= 1'b0;
+  end
+end
+
+//------------------------------------------------------------------------------
+// Software side - the driver's DMA path in SV
+//------------------------------------------------------------------------------
+int                                     consumed;
+logic [31:0]                            consumer;
+
+task automatic DMA_SETUP(input [31:0] base, input [31:0] bytes, input [31:0] block);
+  begin
+    ring_base = base;
+    ring_bytes = bytes;
+    consumed = 0;
+    consumer = 0;
+    adc_sample_n = 0;
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN | TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_EN);
+    REG_WRITE(TB_REG_DMA_BASE, base);
+    REG_WRITE(TB_REG_DMA_SIZE, bytes);
+    REG_WRITE(TB_REG_DMA_BLOCK, block);
+    REG_WRITE(TB_REG_DMA_CONSUMER, 32'h0);
+    REG_WRITE(TB_REG_DMA_CTRL, TB_DMA_RESET);
+    REG_WRITE(TB_REG_DMA_CTRL, TB_DMA_EN);
+  end
+endtask
+
+// Check and release every sample between the consumer and the producer
+task automatic DMA_CONSUME;
+  logic [31:0] producer;
+  begin
+    REG_READ(TB_REG_DMA_PRODUCER, producer);
+    while (consumer != producer) begin
+      CHECK($sformatf("Ring sample %0d", consumed), ADC_FIFO_WORD(consumed[11:0]), mem[(ring_base + consumer - MEM_BASE) >> 2]);
+      consumed = consumed + 1;
+      consumer = (consumer + 4 == ring_bytes) ? 0 : consumer + 4;
+    end
+    REG_WRITE(TB_REG_DMA_CONSUMER, consumer);
+  end
+endtask
+
+// IRQ service: consume, acknowledge, return the flags seen
+task automatic DMA_SERVICE(output [31:0] flags);
+  begin
+    REG_READ(TB_REG_FIFO_STATUS, flags);
+    DMA_CONSUME();
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+  end
+endtask
+
+task automatic DMA_TEARDOWN;
+  begin
+    REG_WRITE(TB_REG_CTRL, 32'h0);
+    REG_WRITE(TB_REG_DMA_CTRL, 32'h0);
+    REG_WRITE(TB_REG_FIFO_CTRL, TB_FIFO_FLUSH);
+    REG_WRITE(TB_REG_FIFO_CTRL, 32'h0);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// 1. Counted capture, block interrupts, ring straddling 4KB, slow consumer
+//------------------------------------------------------------------------------
+task automatic DMA_BLOCK_TEST;
+  logic [31:0] flags;
+  int blocks;
+  int stalls;
+  int services;
+  int timeout;
+  bit done;
+  begin
+    $display("DMA block test starts");
+    blocks = 0;
+    stalls = 0;
+    services = 0;
+    done = 0;
+    DMA_SETUP(MEM_BASE + 32'h0F80, 32'd256, 32'd64);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_2 | (300 << 8));
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_2 | (300 << 8) | TB_CTRL_START);
+    timeout = 0;
+    while (!done && (timeout < TB_TIMEOUT)) begin
+      @(posedge clock);
+      timeout = timeout + 1;
+      if (adc_irq) begin
+        // Every fourth interrupt sleeps long enough for the 64 word ring to fill
+        if ((services % 4) == 3)
+          repeat (20000) @(posedge clock);
+        REG_READ(TB_REG_FIFO_STATUS, flags);
+        if (flags & TB_DMA_STALL)
+          stalls = stalls + 1;
+        DMA_SERVICE(flags);
+        services = services + 1;
+        if (flags & TB_DMA_BLOCK)
+          blocks = blocks + 1;
+        if (flags & (TB_DMA_ERR | TB_FIFO_OVF))
+          CHECK("No DMA error / FIFO overflow", 32'h0, flags & (TB_DMA_ERR | TB_FIFO_OVF));
+        if (flags & TB_DMA_DONE)
+          done = 1;
+      end
+    end
+    CHECK("DMA done", 32'h1, {31'd0, done});
+    DMA_CONSUME();
+    CHECK("Samples through the ring", 32'd300, consumed);
+    if (blocks == 0)
+      CHECK("Block interrupts", 32'h1, 32'h0);
+    if (stalls == 0)
+      CHECK("Writer stalled on a full ring", 32'h1, 32'h0);
+    CHECK("IRQ low after the last acknowledge", 32'h0, {31'd0, adc_irq});
+    DMA_TEARDOWN();
+    $display("DMA block test: %0d samples, %0d bursts (%0d of 16 beats), %0d block IRQs, %0d stalls",
+             consumed, burst_cnt, burst_full_cnt, blocks, stalls);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// 2. Free running - consume on block interrupts, stop by dropping START
+//------------------------------------------------------------------------------
+task automatic DMA_FREE_RUN_TEST;
+  logic [31:0] flags;
+  logic [31:0] status;
+  int timeout;
+  int bursts;
+  int bursts_full;
+  bit done;
+  begin
+    $display("DMA free run test starts");
+    done = 0;
+    bursts = burst_cnt;
+    bursts_full = burst_full_cnt;
+    DMA_SETUP(MEM_BASE + 32'h0400, 32'd512, 32'd128);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_FREE_RUN | TB_CTRL_CLKDIV_2);
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_FREE_RUN | TB_CTRL_CLKDIV_2 | TB_CTRL_START);
+    timeout = 0;
+    while ((consumed < 600) && (timeout < TB_TIMEOUT)) begin
+      @(posedge clock);
+      timeout = timeout + 1;
+      if (adc_irq) begin
+        DMA_SERVICE(flags);
+        if (flags & TB_DMA_DONE)
+          CHECK("No DMA done while free running", 32'h0, flags & TB_DMA_DONE);
+      end
+    end
+    // Stop: drop START, the frame in flight completes, the tail is flushed and DMA done follows
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CLKDIV_2);
+    timeout = 0;
+    while (!done && (timeout < TB_TIMEOUT)) begin
+      @(posedge clock);
+      timeout = timeout + 1;
+      if (adc_irq) begin
+        DMA_SERVICE(flags);
+        if (flags & TB_DMA_DONE)
+          done = 1;
+      end
+    end
+    CHECK("DMA done after stop", 32'h1, {31'd0, done});
+    REG_READ(TB_REG_STATUS, status);
+    CHECK("Engine idle", 32'h0, status & 32'h1);
+    DMA_CONSUME();
+    CHECK("Every conversion in the ring", {20'd0, adc_sample_n}, consumed);
+    DMA_TEARDOWN();
+    $display("DMA free run test: %0d samples, %0d bursts (%0d of 16 beats)", consumed, burst_cnt - bursts, burst_full_cnt - bursts_full);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// 3. A capture starting mid line - the first burst only fills the line
+//------------------------------------------------------------------------------
+task automatic DMA_CAPTURE(input [31:0] count);
+  logic [31:0] flags;
+  int timeout;
+  bit done;
+  begin
+    done = 0;
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_2 | (count << 8));
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_2 | (count << 8) | TB_CTRL_START);
+    timeout = 0;
+    while (!done && (timeout < TB_TIMEOUT)) begin
+      @(posedge clock);
+      timeout = timeout + 1;
+      if (adc_irq) begin
+        DMA_SERVICE(flags);
+        if (flags & TB_DMA_DONE)
+          done = 1;
+      end
+    end
+    CHECK("DMA done", 32'h1, {31'd0, done});
+    DMA_CONSUME();
+  end
+endtask
+
+task automatic DMA_LINE_TEST;
+  int first;
+  begin
+    $display("DMA line test starts");
+    DMA_SETUP(MEM_BASE + 32'h0800, 32'd256, 32'd0);
+    // 20 samples: one full burst and a 4 word tail - the producer is left at byte 80
+    first = burst_cnt;
+    DMA_CAPTURE(20);
+    CHECK("First capture bursts", 32'd2, burst_cnt - first);
+    CHECK("Tail burst beats", 32'd4, burst_len_log[(first + 1) % 256] + 1);
+    // 40 more: 12 words to the line end, then 16 and 12
+    first = burst_cnt;
+    DMA_CAPTURE(40);
+    CHECK("Second capture bursts", 32'd3, burst_cnt - first);
+    CHECK("Mid line burst address", MEM_BASE + 32'h0800 + 32'd80, burst_addr_log[first % 256]);
+    CHECK("Mid line burst beats", 32'd12, burst_len_log[first % 256] + 1);
+    CHECK("Next burst on the line", MEM_BASE + 32'h0800 + 32'd128, burst_addr_log[(first + 1) % 256]);
+    CHECK("Samples through the ring", 32'd60, consumed);
+    DMA_TEARDOWN();
+    $display("DMA line test: %0d samples", consumed);
+  end
+endtask
+
+//------------------------------------------------------------------------------
+// 4. Write error response
+//------------------------------------------------------------------------------
+task automatic DMA_ERROR_TEST;
+  logic [31:0] flags;
+  int timeout;
+  begin
+    $display("DMA error test starts");
+    DMA_SETUP(MEM_BASE + 32'h0000, 32'd256, 32'd0);
+    bresp_error = 1;
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_2 | (16 << 8));
+    REG_WRITE(TB_REG_CTRL, TB_CTRL_EN | TB_CTRL_CONT | TB_CTRL_CLKDIV_2 | (16 << 8) | TB_CTRL_START);
+    timeout = 0;
+    while (!adc_irq && (timeout < TB_TIMEOUT)) begin
+      @(posedge clock);
+      timeout = timeout + 1;
+    end
+    REG_READ(TB_REG_FIFO_STATUS, flags);
+    CHECK("DMA error flag", TB_DMA_ERR, flags & TB_DMA_ERR);
+    REG_WRITE(TB_REG_IRQ, TB_IRQ_EN | TB_IRQ_CLR);
+    REG_READ(TB_REG_FIFO_STATUS, flags);
+    CHECK("DMA error cleared by IRQ_CLR", 32'h0, flags & TB_DMA_ERR);
+    DMA_TEARDOWN();
+  end
+endtask
+
+initial begin
+  reset <= 1'b0;
+  #200ns;
+  reset <= 1'b1;
+  repeat (10) @(posedge clock);
+  DMA_BLOCK_TEST ( );
+  DMA_FREE_RUN_TEST ( );
+  DMA_LINE_TEST ( );
+  DMA_ERROR_TEST ( );
+  $display("---------------------------------------------------------");
+  $display("DMA TEST: %0d checks, %0d errors", comparison_cnt, error_cnt);
+  if (error_cnt == 0)
+    $display("DMA TEST: PASSED!");
+  else
+    $display("DMA TEST: FAILED!");
+  $display("---------------------------------------------------------");
+  $finish;
+end
+
+endmodule
@@ -0,0 +1,30 @@
+#!/bin/sh
+#------------------------------------------------------------------------------
+# ADC 7476A Dual-Channel IP - lint runner
+#------------------------------------------------------------------------------
+# Usage: ./run.sh [verilator | svsim]
+#   Lints the IP top level with the waivers in IMR_ADC_7476A_X2.vlt, by default
+#   with verilator --lint-only -Wall when it is on the PATH, otherwise with the
+#   Verilator style checks of the interpreter in ../svsim (Python 3 only).
+#   Exits non-zero on any warning that is not waived.
+#------------------------------------------------------------------------------
+cd "$(dirname "$0")" || exit 1
+
+HDL="../../hdl/IMR_ADC_7476A_X2.v ../../hdl/IMR_ADC_7476A_X2_slave_lite_v1_0_S00_AXI.v \
+     ../../hdl/IMR_ADC_7476A_X2_Core.sv ../../hdl/IMR_ADC_7476A_X2_DMA_Writer.sv"
+
+SIM=$1
+if [ -z "$SIM" ]; then
+  if command -v verilator >/dev/null 2>&1; then SIM=verilator
+  else SIM=svsim
+  fi
+fi
+
+case "$SIM" in
+  verilator)
+    verilator --lint-only -Wall -I../../hdl --top-module IMR_ADC_7476A_X2 IMR_ADC_7476A_X2.vlt $HDL ;;
+  svsim)
+    python3 ../svsim/svsim.py --lint -I ../../hdl --top IMR_ADC_7476A_X2 IMR_ADC_7476A_X2.vlt $HDL ;;
+  *)
+    echo "usage: $0 [verilator | svsim]" >&2; exit 2 ;;
+esac
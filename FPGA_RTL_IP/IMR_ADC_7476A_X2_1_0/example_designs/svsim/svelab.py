@@ -0,0 +1,1070 @@
+"""Elaboration of the parsed modules into Python source run by svrt (2-state, cycle exact
+IEEE 1800 expression sizing, active / NBA scheduling)."""
+from svparse import SvError, ATOM_W, Node
+from svrt import Sig, Proc
+
+ARITH = ('+', '-', '*', '/', '%', '&', '|', '^', '~^', '^~')
+COMPARE = ('==', '!=', '===', '!==', '<', '<=', '>', '>=')
+LOGIC = ('&&', '||')
+SHIFT = ('<<', '>>', '<<<', '>>>', '**')
+REDUCE = ('&', '|', '^', '~&', '~|', '~^', '^~')
+
+
+def mask(w):
+    return (1 << w) - 1
+
+
+class Info:
+    def __init__(self, kind, **kw):
+        self.kind = kind
+        self.w = 1
+        self.s = False
+        self.isstr = False
+        self.desc = True
+        self.plsb = 0
+        self.arr = None     # (lo, n)
+        self.py = None
+        self.sig = None
+        self.val = None
+        self.node = None
+        self.scope = None
+        self.name = ''
+        self.__dict__.update(kw)
+
+
+class Scope:
+    def __init__(self, parent=None, path=''):
+        self.d = {}
+        self.parent = parent
+        self.path = path if parent is None else parent.path
+        self.mod = None if parent is None else parent.mod
+
+    def lookup(self, name, line=None):
+        sc = self
+        while sc is not None:
+            if name in sc.d:
+                return sc.d[name]
+            sc = sc.parent
+        raise SvError('%s: line %s: undeclared identifier %s' % (self.path, line, name))
+
+    def has(self, name):
+        sc = self
+        while sc is not None:
+            if name in sc.d:
+                return True
+            sc = sc.parent
+        return False
+
+    def __setitem__(self, k, v):
+        self.d[k] = v
+
+
+class Elab:
+    def __init__(self, mods, G):
+        self.mods = mods
+        self.G = G
+        self.src = []
+        self.procs = []       # (kind, fname, sens, name, node, scope)
+        self.inits = []
+        self.sigs = []
+        self.uid = 0
+        self.reads = None
+        self.writes = None
+        self.instances = []   # (path, module node, scope)
+        self.cassigns = []    # for lint: (lhs, lsc, rhs, rsc, line)
+
+    def new(self, prefix):
+        self.uid += 1
+        return '%s%d' % (prefix, self.uid)
+
+    # ------------------------------------------------------------------ types
+    def tyinfo(self, ty, sc, line=None):
+        base = ty['base']
+        if base == 'string':
+            return dict(w=0, s=False, isstr=True, desc=True, plsb=0)
+        if base in ATOM_W:
+            w, s = ATOM_W[base]
+            if ty['signed'] is not None:
+                s = ty['signed']
+            return dict(w=w, s=s, isstr=False, desc=True, plsb=0)
+        dims = ty['dims']
+        if len(dims) > 1:
+            raise SvError('%s: line %s: multiple packed dimensions not supported' % (sc.path, line))
+        if dims:
+            msb = self.cint(dims[0][0], sc)
+            lsb = self.cint(dims[0][1], sc)
+            return dict(w=abs(msb - lsb) + 1, s=bool(ty['signed']), isstr=False, desc=msb >= lsb, plsb=lsb)
+        return dict(w=1, s=bool(ty['signed']), isstr=False, desc=True, plsb=0)
+
+    def udims(self, udims, sc, line):
+        if not udims:
+            return None
+        if len(udims) > 1:
+            raise SvError('%s: line %s: multi-dimensional arrays not supported' % (sc.path, line))
+        a = self.cint(udims[0][0], sc)
+        b = self.cint(udims[0][1], sc)
+        return (min(a, b), abs(a - b) + 1)
+
+    def make_sig(self, sc, name, ti, arr, line):
+        py = self.new('S')
+        sig = Sig(sc.path + '.' + name, ti['w'], arr[1] if arr else None, arr[0] if arr else 0)
+        if ti['isstr']:
+            sig.v = ''
+        self.G[py] = sig
+        info = Info('sig', py=py, sig=sig, arr=arr, name=name, line=line, **ti)
+        self.sigs.append((sig, info, sc))
+        sc[name] = info
+        return info
+
+    # ------------------------------------------------------------------ constants
+    def const(self, n, sc):
+        w, s, isstr = self.selfw(n, sc)
+        if isstr:
+            raise SvError('%s: line %s: string constant not supported' % (sc.path, n.line))
+        saved = self.reads
+        self.reads = set()
+        code = self.ex(n, w, s, sc)
+        r = self.reads
+        self.reads = saved
+        if r:
+            raise SvError('%s: line %s: expression is not constant' % (sc.path, n.line))
+        return (eval(code, self.G), w, s)
+
+    def cint(self, n, sc):
+        v, w, s = self.const(n, sc)
+        return v - (1 << w) if s and (v >> (w - 1)) & 1 else v
+
+    # ------------------------------------------------------------------ elaboration
+    def elab_module(self, name, overrides, path, conns, line=None):
+        if name not in self.mods:
+            raise SvError('%s: module %s not found' % (path, name))
+        mod = self.mods[name]
+        sc = Scope(None, path)
+        sc.mod = mod
+        self.instances.append((path, mod, sc))
+        pending = []
+        for p in mod.params:
+            self.def_param(p, sc, overrides)
+        for it in mod.items:
+            if it.kind == 'param':
+                self.def_param(it, sc, {} if it.local else overrides)
+        for p in mod.ports:
+            ti = self.tyinfo(p.ty, sc, p.line)
+            arr = self.udims(p.udims, sc, p.line)
+            conn = conns.get(p.name) if conns is not None else None
+            if conn is not None and conn[0] is not None and conn[0].kind == 'id' and arr is None:
+                pinfo = conn[1].lookup(conn[0].name, conn[0].line)
+                if pinfo.kind == 'sig' and pinfo.w == ti['w'] and pinfo.arr is None:
+                    sc[p.name] = pinfo
+                    pinfo.aliases = getattr(pinfo, 'aliases', []) + [(sc.path, p.name, p.dir)]
+                    continue
+            info = self.make_sig(sc, p.name, ti, arr, p.line)
+            info.port = p.dir
+            if conn is not None and conn[0] is not None:
+                if p.dir == 'input':
+                    pending.append((Node('id', name=p.name, line=p.line), sc, conn[0], conn[1], p.line))
+                else:
+                    pending.append((conn[0], conn[1], Node('id', name=p.name, line=p.line), sc, p.line))
+        for it in mod.items:
+            if it.kind == 'decl':
+                ti = self.tyinfo(it.ty, sc, it.line)
+                arr = self.udims(it.udims, sc, it.line)
+                info = self.make_sig(sc, it.name, ti, arr, it.line)
+                if it.init is not None:
+                    if it.ty['base'] == 'wire':
+                        pending.append((Node('id', name=it.name, line=it.line), sc, it.init, sc, it.line))
+                    else:
+                        self.inits.append((info, it.init, sc))
+            elif it.kind in ('task', 'function'):
+                sc[it.name] = Info('func' if it.kind == 'function' else 'task', node=it, scope=sc, name=it.name)
+        for it in mod.items:
+            if it.kind == 'inst':
+                ov = {}
+                for pn, e in it.params.items():
+                    ov[pn] = self.const(e, sc)
+                cc = {pn: (e, sc) for pn, e in it.conns.items()}
+                self.elab_module(it.mod, ov, path + '.' + it.name, cc, it.line)
+        for it in mod.items:
+            if it.kind == 'cassign':
+                pending.append((it.lhs, sc, it.rhs, sc, it.line))
+        for lhs, lsc, rhs, rsc, ln in pending:
+            self.compile_cassign(lhs, lsc, rhs, rsc, ln)
+        for it in mod.items:
+            if it.kind == 'proc':
+                self.compile_proc(it, sc)
+        return sc
+
+    def def_param(self, p, sc, overrides):
+        if p.name in overrides:
+            v, w, s = overrides[p.name]
+        else:
+            v, w, s = self.const(p.value, sc)
+        ty = p.ty
+        if ty is not None and (ty['base'] is not None or ty['dims']):
+            ti = self.tyinfo(ty, sc, p.line)
+            if v >> (ti['w']) and s:
+                pass
+            if s and (v >> (w - 1)) & 1 and ti['w'] > w:
+                v = (v - (1 << w)) & mask(ti['w'])
+            v &= mask(ti['w'])
+            w, s = ti['w'], ti['s']
+        elif ty is not None and ty['signed'] is not None:
+            s = ty['signed']
+        sc[p.name] = Info('param', val=v, w=w, s=s, name=p.name, line=p.line)
+
+    # ------------------------------------------------------------------ expression sizing
+    def selfw(self, n, sc):
+        k = n.kind
+        if k == 'num':
+            if n.fill is not None:
+                return (1, False, False)
+            return (n.w or 32, n.s, False)
+        if k == 'str':
+            return (max(8 * len(n.val), 8), False, True)
+        if k == 'id':
+            info = sc.lookup(n.name, n.line)
+            if info.kind in ('func', 'task'):
+                raise SvError('%s: line %s: %s used as a value' % (sc.path, n.line, n.name))
+            return (info.w, info.s, info.isstr)
+        if k == 'index':
+            if n.base.kind == 'id':
+                info = sc.lookup(n.base.name, n.line)
+                if info.arr is not None:
+                    return (info.w, info.s, False)
+            return (1, False, False)
+        if k == 'range':
+            return (abs(self.cint(n.msb, sc) - self.cint(n.lsb, sc)) + 1, False, False)
+        if k == 'ipart':
+            return (self.cint(n.width, sc), False, False)
+        if k == 'un':
+            if n.op in ('!',) or n.op in REDUCE:
+                return (1, False, False)
+            return self.selfw(n.a, sc)
+        if k == 'bin':
+            if n.op in COMPARE or n.op in LOGIC:
+                return (1, False, False)
+            if n.op in SHIFT:
+                return self.selfw(n.a, sc)
+            wa, sa, _ = self.selfw(n.a, sc)
+            wb, sb, _ = self.selfw(n.b, sc)
+            return (max(wa, wb), sa and sb, False)
+        if k == 'cond':
+            wa, sa, ia = self.selfw(n.a, sc)
+            wb, sb, ib = self.selfw(n.b, sc)
+            return (max(wa, wb), sa and sb, ia or ib)
+        if k == 'concat':
+            return (sum(self.selfw(p, sc)[0] for p in n.parts), False, False)
+        if k == 'repl':
+            return (self.cint(n.n, sc) * sum(self.selfw(p, sc)[0] for p in n.parts), False, False)
+        if k == 'call':
+            info = sc.lookup(n.name, n.line)
+            if info.kind != 'func':
+                raise SvError('%s: line %s: %s is not a function' % (sc.path, n.line, n.name))
+            rty = info.node.rty
+            if rty == 'void':
+                return (1, False, False)
+            ti = self.tyinfo(rty, info.scope, n.line)
+            return (ti['w'], ti['s'], ti['isstr'])
+        if k == 'syscall':
+            nm = n.name
+            if nm in ('$urandom_range', '$urandom'):
+                return (32, False, False)
+            if nm in ('$random', '$clog2', '$bits'):
+                return (32, True, False)
+            if nm in ('$time', '$stime', '$realtime'):
+                return (64, False, False)
+            if nm == '$signed':
+                return (self.selfw(n.args[0], sc)[0], True, False)
+            if nm == '$unsigned':
+                return (self.selfw(n.args[0], sc)[0], False, False)
+            if nm == '$sformatf':
+                return (8, False, True)
+            raise SvError('%s: line %s: system function %s not supported' % (sc.path, n.line, nm))
+        if k == 'cast':
+            if n.to == 'int':
+                return (32, True, False)
+            return (self.selfw(n.a, sc)[0], n.to == 'signed', False)
+        if k == 'hier':
+            raise SvError('%s: line %s: hierarchical references not supported' % (sc.path, n.line))
+        raise SvError('%s: line %s: cannot size %s' % (sc.path, n.line, k))
+
+    # ------------------------------------------------------------------ expression code
+    @staticmethod
+    def ext(code, w, s, W, S):
+        if W > w and S and s:
+            return '_sxw(%s, %d, %d)' % (code, w, W)
+        return code
+
+    def exs(self, n, sc):
+        w, s, isstr = self.selfw(n, sc)
+        if isstr:
+            return self.exstr(n, sc)
+        return self.ex(n, w, s, sc)
+
+    def exstr(self, n, sc):
+        k = n.kind
+        if k == 'str':
+            return repr(n.val)
+        if k == 'id':
+            info = sc.lookup(n.name, n.line)
+            if info.isstr:
+                return self.rd(info)
+        if k == 'syscall' and n.name == '$sformatf':
+            return '_fmtargs([%s])' % ', '.join(self.dargs(n.args, sc))
+        if k == 'cond':
+            return '(%s if %s else %s)' % (self.exstr(n.a, sc), self.exs(n.c, sc), self.exstr(n.b, sc))
+        raise SvError('%s: line %s: string expression expected' % (sc.path, n.line))
+
+    def rd(self, info):
+        if info.kind == 'sig':
+            if self.reads is not None:
+                self.reads.add(info.sig)
+            return '%s.v' % info.py
+        return info.py
+
+    def base_info(self, n, sc):
+        """(code of the vector, width, plsb, desc, lvalue info) for a select base"""
+        if n.kind == 'id':
+            info = sc.lookup(n.name, n.line)
+            if info.arr is not None:
+                raise SvError('%s: line %s: array %s used without an index' % (sc.path, n.line, n.name))
+            if info.kind == 'param':
+                return ('%d' % info.val, info.w, 0, True)
+            return (self.rd(info), info.w, info.plsb, info.desc)
+        if n.kind == 'index' and n.base.kind == 'id':
+            info = sc.lookup(n.base.name, n.line)
+            if info.arr is not None:
+                return (self.ex(n, info.w, False, sc), info.w, info.plsb, info.desc)
+        w, s, _ = self.selfw(n, sc)
+        return (self.ex(n, w, s, sc), w, 0, True)
+
+    def ex(self, n, W, S, sc):
+        k = n.kind
+        M = mask(W)
+        if k == 'num':
+            if n.fill is not None:
+                return '0x%x' % (M if n.fill == '1' else 0)
+            v = n.val
+            w = n.w or 32
+            if n.w is None:
+                v &= mask(32) if v >= 0 else mask(32)
+            if S and n.s and W > w and (v >> (w - 1)) & 1:
+                v = (v - (1 << w)) & M
+            return '0x%x' % (v & M)
+        if k == 'str':
+            v = 0
+            for ch in n.val.encode():
+                v = (v << 8) | ch
+            return '0x%x' % (v & M)
+        if k == 'id':
+            info = sc.lookup(n.name, n.line)
+            if info.kind == 'param':
+                v = info.val
+                if S and info.s and W > info.w and (v >> (info.w - 1)) & 1:
+                    v = (v - (1 << info.w)) & M
+                return '0x%x' % v
+            if info.kind not in ('sig', 'local'):
+                raise SvError('%s: line %s: %s is not a value' % (sc.path, n.line, n.name))
+            if info.arr is not None:
+                raise SvError('%s: line %s: array %s used without an index' % (sc.path, n.line, n.name))
+            return self.ext(self.rd(info), info.w, info.s, W, S)
+        if k == 'index':
+            if n.base.kind == 'id':
+                info = sc.lookup(n.base.name, n.line)
+                if info.arr is not None:
+                    lo = info.arr[0]
+                    ic = self.exs(n.idx, sc)
+                    if lo:
+                        ic = '(%s) - %d' % (ic, lo)
+                    return self.ext('_ag(%s, %s)' % (self.rd(info), ic), info.w, info.s, W, S)
+            bc, bw, plsb, desc = self.base_info(n.base, sc)
+            ir = self.try_const(n.idx, sc)
+            if ir is not None:
+                off = ir - plsb if desc else plsb - ir
+                if off < 0 or off >= bw:
+                    return '0'
+                return '((%s >> %d) & 1)' % (bc, off)
+            ic = self.exs(n.idx, sc)
+            if desc:
+                return '_bit(%s, (%s) - %d, %d)' % (bc, ic, plsb, bw)
+            return '_bit(%s, %d - (%s), %d)' % (bc, plsb, ic, bw)
+        if k == 'range':
+            bc, bw, plsb, desc = self.base_info(n.base, sc)
+            msb = self.cint(n.msb, sc)
+            lsb = self.cint(n.lsb, sc)
+            w = abs(msb - lsb) + 1
+            off = (lsb - plsb) if desc else (plsb - lsb)
+            if off < 0 or off + w > bw:
+                raise SvError('%s: line %s: part select [%d:%d] out of range' % (sc.path, n.line, msb, lsb))
+            if off == 0 and w == bw:
+                return bc
+            return '((%s >> %d) & 0x%x)' % (bc, off, mask(w))
+        if k == 'ipart':
+            bc, bw, plsb, desc = self.base_info(n.base, sc)
+            w = self.cint(n.width, sc)
+            st = self.exs(n.start, sc)
+            if n.dir == '-:':
+                st = '(%s) - %d' % (st, w - 1)
+            return '_part(%s, (%s) - %d, %d, 0x%x)' % (bc, st, plsb, w, mask(w))
+        if k == 'un':
+            op = n.op
+            if op == '!':
+                return '(0 if %s else 1)' % self.exs(n.a, sc)
+            if op == '~':
+                return '(~%s & 0x%x)' % (self.ex(n.a, W, S, sc), M)
+            if op == '-':
+                return '(-%s & 0x%x)' % (self.ex(n.a, W, S, sc), M)
+            if op == '+':
+                return self.ex(n.a, W, S, sc)
+            wa = self.selfw(n.a, sc)[0]
+            a = self.exs(n.a, sc)
+            if op == '&':
+                return '(1 if %s == 0x%x else 0)' % (a, mask(wa))
+            if op == '~&':
+                return '(0 if %s == 0x%x else 1)' % (a, mask(wa))
+            if op == '|':
+                return '(1 if %s else 0)' % a
+            if op == '~|':
+                return '(0 if %s else 1)' % a
+            if op == '^':
+                return "(bin(%s).count('1') & 1)" % a
+            return "(~bin(%s).count('1') & 1)" % a
+        if k == 'bin':
+            op = n.op
+            if op in COMPARE:
+                wa, sa, _ = self.selfw(n.a, sc)
+                wb, sb, _ = self.selfw(n.b, sc)
+                Wc = max(wa, wb)
+                Sc = sa and sb
+                a = self.ex(n.a, Wc, Sc, sc)
+                b = self.ex(n.b, Wc, Sc, sc)
+                pyop = {'===': '==', '!==': '!='}.get(op, op)
+                if Sc and op in ('<', '<=', '>', '>='):
+                    a = '_sx(%s, %d)' % (a, Wc)
+                    b = '_sx(%s, %d)' % (b, Wc)
+                return '(1 if %s %s %s else 0)' % (a, pyop, b)
+            if op in LOGIC:
+                return '(1 if (%s) %s (%s) else 0)' % (self.exs(n.a, sc), 'and' if op == '&&' else 'or',
+                                                       self.exs(n.b, sc))
+            if op in SHIFT:
+                a = self.ex(n.a, W, S, sc)
+                b = self.exs(n.b, sc)
+                if op in ('<<', '<<<'):
+                    return '_shl(%s, %s, 0x%x, %d)' % (a, b, M, W)
+                if op == '>>' or not S:
+                    return '(%s >> %s)' % (a, b)
+                if op == '>>>':
+                    return '((_sx(%s, %d) >> %s) & 0x%x)' % (a, W, b, M)
+                return '((%s ** %s) & 0x%x)' % (a, b, M)
+            a = self.ex(n.a, W, S, sc)
+            b = self.ex(n.b, W, S, sc)
+            if op in ('+', '-', '*'):
+                return '((%s %s %s) & 0x%x)' % (a, op, b, M)
+            if op == '/':
+                return ('_sdiv(%s, %s, %d)' % (a, b, W)) if S else ('_div(%s, %s, 0x%x)' % (a, b, M))
+            if op == '%':
+                return ('_smod(%s, %s, %d)' % (a, b, W)) if S else ('_mod(%s, %s, 0x%x)' % (a, b, M))
+            if op in ('&', '|', '^'):
+                return '(%s %s %s)' % (a, op, b)
+            return '(~(%s ^ %s) & 0x%x)' % (a, b, M)
+        if k == 'cond':
+            return '(%s if %s else %s)' % (self.ex(n.a, W, S, sc), self.exs(n.c, sc), self.ex(n.b, W, S, sc))
+        if k == 'concat' or k == 'repl':
+            codes = []
+            tot = 0
+            for p in reversed(n.parts):
+                w, s, _ = self.selfw(p, sc)
+                c = self.ex(p, w, s, sc)
+                codes.append('(%s << %d)' % (c, tot) if tot else c)
+                tot += w
+            code = '(%s)' % ' | '.join(reversed(codes))
+            if k == 'repl':
+                code = '_repl(%s, %d, %d)' % (code, tot, self.cint(n.n, sc))
+            return code
+        if k == 'call':
+            info = sc.lookup(n.name, n.line)
+            fpy = self.compile_sub(info)
+            args = self.call_args(info, n.args, sc, n.line)
+            w, s, _ = self.selfw(n, sc)
+            return self.ext('%s(%s)' % (fpy, ', '.join(a for a in args if a is not None)), w, s, W, S)
+        if k == 'syscall':
+            nm = n.name
+            if nm == '$urandom_range':
+                return '_urr(%s)' % ', '.join(self.exs(a, sc) for a in n.args)
+            if nm in ('$urandom', '$random'):
+                return '(_urand() & 0x%x)' % M
+            if nm in ('$time', '$stime'):
+                return '_time()'
+            if nm == '$clog2':
+                v = self.cint(n.args[0], sc)
+                return '%d' % max(0, (v - 1).bit_length())
+            if nm in ('$signed', '$unsigned'):
+                w, s, _ = self.selfw(n, sc)
+                return self.ext(self.ex(n.args[0], w, False, sc), w, s, W, S)
+            raise SvError('%s: line %s: %s in a numeric context' % (sc.path, n.line, nm))
+        if k == 'cast':
+            w, s, _ = self.selfw(n, sc)
+            wa, sa, _ = self.selfw(n.a, sc)
+            Wi = max(w, wa)
+            code = '(%s & 0x%x)' % (self.ex(n.a, Wi, sa, sc), mask(w))
+            return self.ext(code, w, s, W, S)
+        raise SvError('%s: line %s: cannot generate %s' % (sc.path, n.line, k))
+
+    def try_const(self, n, sc):
+        saved = self.reads
+        self.reads = set()
+        try:
+            w, s, isstr = self.selfw(n, sc)
+            code = self.ex(n, w, s, sc)
+            if self.reads or isstr:
+                return None
+            v = eval(code, dict(self.G))
+            return v - (1 << w) if s and (v >> (w - 1)) & 1 else v
+        except (SvError, NameError):
+            return None
+        finally:
+            self.reads = saved
+
+    def dargs(self, args, sc):
+        out = []
+        for a in args:
+            w, s, isstr = self.selfw(a, sc)
+            if isstr:
+                out.append('(%s, 0, False)' % self.exstr(a, sc))
+            else:
+                out.append('(%s, %d, %s)' % (self.ex(a, w, s, sc), w, s))
+        return out
+
+    # ------------------------------------------------------------------ lvalues
+    def lwidth(self, n, sc):
+        k = n.kind
+        if k == 'id':
+            info = sc.lookup(n.name, n.line)
+            return info.w
+        if k == 'concat':
+            return sum(self.lwidth(p, sc) for p in n.parts)
+        return self.selfw(n, sc)[0]
+
+    def note_write(self, info, n):
+        if self.writes is not None and info.kind == 'sig':
+            self.writes.add(info.sig)
+
+    def lassign(self, n, sc, val, nb, L, ind):
+        """emit code assigning python expression val (already masked to the lvalue width)"""
+        p = '    ' * ind
+        k = n.kind
+        if k == 'id':
+            info = sc.lookup(n.name, n.line)
+            if info.kind == 'local':
+                L.append('%s%s = %s' % (p, info.py, val))
+                return
+            if info.kind != 'sig':
+                raise SvError('%s: line %s: cannot assign %s' % (sc.path, n.line, n.name))
+            if info.arr is not None:
+                raise SvError('%s: line %s: whole array assignment not supported' % (sc.path, n.line))
+            self.note_write(info, n)
+            L.append('%s%s(%s, %s)' % (p, '_nb' if nb else '_set', info.py, val))
+            return
+        if k in ('index', 'range', 'ipart'):
+            base = n.base
+            # array element (optionally with a bit / part select on it)
+            arr_info = None
+            if k == 'index' and base.kind == 'id':
+                bi = sc.lookup(base.name, base.line)
+                if bi.arr is not None:
+                    arr_info = bi
+            if arr_info is not None:
+                self.note_write(arr_info, n)
+                ic = self.exs(n.idx, sc)
+                if arr_info.arr[0]:
+                    ic = '(%s) - %d' % (ic, arr_info.arr[0])
+                L.append('%s%s(%s, %s, %s)' % (p, '_nba' if nb else '_seta', arr_info.py, ic, val))
+                return
+            if base.kind == 'index' and base.base.kind == 'id' and sc.lookup(base.base.name).arr is not None:
+                ai = sc.lookup(base.base.name)
+                self.note_write(ai, n)
+                ic = self.exs(base.idx, sc)
+                if ai.arr[0]:
+                    ic = '(%s) - %d' % (ic, ai.arr[0])
+                off, w = self.sel_off(n, ai, sc)
+                L.append('%s%s(%s, %s, %s, %d, %s)' % (p, '_nbab' if nb else '_setab', ai.py, ic, off, w, val))
+                return
+            if base.kind != 'id':
+                raise SvError('%s: line %s: unsupported lvalue' % (sc.path, n.line))
+            info = sc.lookup(base.name, base.line)
+            off, w = self.sel_off(n, info, sc)
+            if info.kind == 'local':
+                L.append('%s%s = _putb(%s, %s, %d, %s, %d)' % (p, info.py, info.py, off, w, val, info.w))
+                return
+            self.note_write(info, n)
+            L.append('%s%s(%s, %s, %d, %s)' % (p, '_nbb' if nb else '_setb', info.py, off, w, val))
+            return
+        if k == 'concat':
+            t = self.new('_v')
+            L.append('%s%s = %s' % (p, t, val))
+            sh = 0
+            for part in reversed(n.parts):
+                w = self.lwidth(part, sc)
+                self.lassign(part, sc, '((%s >> %d) & 0x%x)' % (t, sh, mask(w)), nb, L, ind)
+                sh += w
+            return
+        raise SvError('%s: line %s: unsupported lvalue %s' % (sc.path, n.line, k))
+
+    def sel_off(self, n, info, sc):
+        plsb, desc = info.plsb, info.desc
+        if n.kind == 'index':
+            c = self.try_const(n.idx, sc)
+            if c is not None:
+                return (str(c - plsb if desc else plsb - c), 1)
+            ic = self.exs(n.idx, sc)
+            return ('(%s) - %d' % (ic, plsb) if desc else '%d - (%s)' % (plsb, ic), 1)
+        if n.kind == 'range':
+            msb = self.cint(n.msb, sc)
+            lsb = self.cint(n.lsb, sc)
+            return (str(lsb - plsb if desc else plsb - lsb), abs(msb - lsb) + 1)
+        w = self.cint(n.width, sc)
+        st = self.exs(n.start, sc)
+        if n.dir == '-:':
+            st = '(%s) - %d' % (st, w - 1)
+        return ('(%s) - %d' % (st, plsb), w)
+
+    def assign(self, lhs, lsc, rhs, rsc, nb, L, ind):
+        lw = self.lwidth(lhs, lsc)
+        if lhs.kind == 'id' and lsc.lookup(lhs.name, lhs.line).isstr:
+            self.lassign(lhs, lsc, self.exstr(rhs, rsc), nb, L, ind)
+            return
+        rw, rs, risstr = self.selfw(rhs, rsc)
+        if risstr and rhs.kind != 'str':
+            raise SvError('%s: line %s: string assigned to a vector' % (lsc.path, lhs.line))
+        W = max(lw, rw)
+        code = self.ex(rhs, W, rs, rsc)
+        if W > lw:
+            code = '(%s & 0x%x)' % (code, mask(lw))
+        self.lassign(lhs, lsc, code, nb, L, ind)
+
+    # ------------------------------------------------------------------ statements
+    def has_timing(self, n, sc, seen=None):
+        if n is None:
+            return False
+        k = n.kind
+        if k in ('evctl', 'delay', 'wait'):
+            return True
+        if k == 'block':
+            return any(self.has_timing(s, sc, seen) for s in n.stmts)
+        if k == 'if':
+            return self.has_timing(n.then, sc, seen) or self.has_timing(n.els, sc, seen)
+        if k == 'case':
+            return any(self.has_timing(s, sc, seen) for _, s in n.items)
+        if k in ('for', 'while', 'dowhile', 'repeat', 'forever'):
+            return self.has_timing(n.body, sc, seen)
+        if k == 'taskcall':
+            info = sc.lookup(n.name, n.line)
+            return self.task_timing(info)
+        return False
+
+    def task_timing(self, info):
+        if not hasattr(info, 'timing'):
+            info.timing = True      # recursion guard
+            info.timing = self.has_timing(info.node.body, info.scope)
+        return info.timing
+
+    def new_local(self, sc, name, ti, line):
+        py = self.new('l_%s_' % name)
+        sc[name] = Info('local', py=py, name=name, line=line, **ti)
+        return py
+
+    def st(self, n, sc, L, ind, ctx):
+        p = '    ' * ind
+        k = n.kind
+        start = len(L)
+        if k == 'null':
+            L.append(p + 'pass')
+        elif k == 'block':
+            bsc = Scope(sc)
+            for d in n.decls:
+                ti = self.tyinfo(d.ty, bsc, d.line)
+                if d.udims:
+                    raise SvError('%s: line %s: local arrays not supported' % (sc.path, d.line))
+                init = None
+                if d.init is not None:
+                    if ti['isstr']:
+                        init = self.exstr(d.init, bsc)
+                    else:
+                        rw, rs, _ = self.selfw(d.init, bsc)
+                        Wd = max(ti['w'], rw)
+                        init = '(%s & 0x%x)' % (self.ex(d.init, Wd, rs, bsc), mask(ti['w']))
+                py = self.new_local(bsc, d.name, ti, d.line)
+                L.append('%s%s = %s' % (p, py, init if init is not None else ("''" if ti['isstr'] else '0')))
+            for s in n.stmts:
+                self.st(s, bsc, L, ind, ctx)
+        elif k == 'assign':
+            self.assign(n.lhs, sc, n.rhs, sc, n.nb, L, ind)
+        elif k == 'if':
+            L.append('%sif %s:' % (p, self.exs(n.cond, sc)))
+            self.body(n.then, sc, L, ind + 1, ctx)
+            if n.els is not None:
+                L.append(p + 'else:')
+                self.body(n.els, sc, L, ind + 1, ctx)
+        elif k == 'case':
+            sw, ss, _ = self.selfw(n.sel, sc)
+            Wm, Sm = sw, ss
+            for labels, _ in n.items:
+                for lab in labels or []:
+                    lw, ls, _ = self.selfw(lab, sc)
+                    Wm = max(Wm, lw)
+                    Sm = Sm and ls
+            t = self.new('_c')
+            L.append('%s%s = %s' % (p, t, self.ex(n.sel, Wm, Sm, sc)))
+            first = True
+            default = None
+            for labels, body in n.items:
+                if labels is None:
+                    default = body
+                    continue
+                conds = ' or '.join('%s == %s' % (t, self.ex(lab, Wm, Sm, sc)) for lab in labels)
+                L.append('%s%s %s:' % (p, 'if' if first else 'elif', conds))
+                first = False
+                self.body(body, sc, L, ind + 1, ctx)
+            if default is not None:
+                if first:
+                    self.st(default, sc, L, ind, ctx)
+                else:
+                    L.append(p + 'else:')
+                    self.body(default, sc, L, ind + 1, ctx)
+        elif k == 'for':
+            fsc = Scope(sc)
+            for it in n.init:
+                if it.kind == 'decl':
+                    ti = self.tyinfo(it.ty, fsc, it.line)
+                    py = self.new_local(fsc, it.name, ti, it.line)
+                    rw, rs, _ = self.selfw(it.init, fsc)
+                    L.append('%s%s = (%s & 0x%x)' % (p, py, self.ex(it.init, max(rw, ti['w']), rs, fsc),
+                                                     mask(ti['w'])))
+                else:
+                    self.st(it, fsc, L, ind, ctx)
+            L.append('%swhile %s:' % (p, self.exs(n.cond, fsc)))
+            self.body(n.body, fsc, L, ind + 1, ctx)
+            self.st(n.step, fsc, L, ind + 1, ctx)
+        elif k == 'while':
+            L.append('%swhile %s:' % (p, self.exs(n.cond, sc)))
+            self.body(n.body, sc, L, ind + 1, ctx)
+        elif k == 'dowhile':
+            L.append(p + 'while True:')
+            self.body(n.body, sc, L, ind + 1, ctx)
+            L.append('%s    if not (%s):' % (p, self.exs(n.cond, sc)))
+            L.append('%s        break' % p)
+        elif k == 'repeat':
+            t = self.new('_i')
+            w, s, _ = self.selfw(n.n, sc)
+            cnt = self.exs(n.n, sc)
+            if s:
+                cnt = '_sx(%s, %d)' % (cnt, w)
+            L.append('%sfor %s in range(%s):' % (p, t, cnt))
+            self.body(n.body, sc, L, ind + 1, ctx)
+        elif k == 'forever':
+            L.append(p + 'while True:')
+            self.body(n.body, sc, L, ind + 1, ctx)
+        elif k == 'evctl':
+            if not ctx['gen']:
+                raise SvError('%s: line %s: event control in a function or combinational block' % (sc.path, n.line))
+            if n.events == '*':
+                raise SvError('%s: line %s: @* inside a process not supported' % (sc.path, n.line))
+            evs = []
+            for edge, e in n.events:
+                if e.kind != 'id':
+                    raise SvError('%s: line %s: event on an expression not supported' % (sc.path, n.line))
+                info = sc.lookup(e.name, e.line)
+                if info.kind != 'sig':
+                    raise SvError('%s: line %s: event on a non-signal' % (sc.path, n.line))
+                evs.append('(%s, %d)' % (info.py, {'any': 0, 'posedge': 1, 'negedge': 2}[edge]))
+            L.append('%syield (0, (%s,))' % (p, ', '.join(evs)))
+            self.st(n.stmt, sc, L, ind, ctx)
+        elif k == 'delay':
+            if not ctx['gen']:
+                raise SvError('%s: line %s: delay in a function or combinational block' % (sc.path, n.line))
+            a = n.amount
+            if a.kind == 'num':
+                L.append('%syield (1, %d)' % (p, a.val))
+            else:
+                L.append('%syield (1, (%s) * 1000)' % (p, self.exs(a.expr, sc)))
+            self.st(n.stmt, sc, L, ind, ctx)
+        elif k == 'wait':
+            if not ctx['gen']:
+                raise SvError('%s: line %s: wait in a function' % (sc.path, n.line))
+            saved = self.reads
+            self.reads = set()
+            c = self.exs(n.cond, sc)
+            r = self.reads
+            self.reads = saved if saved is None else saved | r
+            sigs = sorted(r, key=lambda s: s.name)
+            pys = []
+            for s in sigs:
+                for nm, v in self.G.items():
+                    if v is s:
+                        pys.append(nm)
+                        break
+            L.append('%swhile not (%s):' % (p, c))
+            L.append('%s    yield (0, (%s,))' % (p, ', '.join('(%s, 0)' % x for x in pys)))
+            self.st(n.stmt, sc, L, ind, ctx)
+        elif k == 'taskcall':
+            info = sc.lookup(n.name, n.line)
+            if info.kind != 'task':
+                if info.kind == 'func':
+                    fpy = self.compile_sub(info)
+                    args = self.call_args(info, n.args, sc, n.line)
+                    L.append('%s%s(%s)' % (p, fpy, ', '.join(a for a in args if a is not None)))
+                    return
+                raise SvError('%s: line %s: %s is not a task' % (sc.path, n.line, n.name))
+            timing = self.task_timing(info)
+            gpy, ppy = self.compile_task(info)
+            args = self.call_args(info, n.args, sc, n.line)
+            call = ', '.join(a for a in args if a is not None)
+            r = self.new('_r')
+            if ctx['gen']:
+                L.append('%s%s = yield from %s(%s)' % (p, r, gpy, call))
+            else:
+                if timing:
+                    raise SvError('%s: line %s: task %s with timing called from a function / block without timing'
+                                  % (sc.path, n.line, n.name))
+                L.append('%s%s = %s(%s)' % (p, r, ppy, call))
+            oi = 0
+            for fa, actual in zip(info.node.args, n.args):
+                if fa['dir'] in ('output', 'inout'):
+                    fw = self.tyinfo(fa['ty'], info.scope)['w']
+                    lw = self.lwidth(actual, sc)
+                    val = '%s[%d]' % (r, oi)
+                    if fw > lw:
+                        val = '(%s & 0x%x)' % (val, mask(lw))
+                    self.lassign(actual, sc, val, False, L, ind)
+                    oi += 1
+        elif k == 'systask':
+            nm = n.name
+            if nm in ('$display', '$write', '$error', '$warning', '$info', '$fatal'):
+                args = n.args
+                if nm == '$fatal' and args and args[0].kind == 'num':
+                    args = args[1:]
+                pre = {'$error': "('ERROR: ', 0, False), ", '$fatal': "('FATAL: ', 0, False), "}.get(nm, '')
+                if pre:
+                    L.append('%s_display([%s], False)' % (p, pre[:-2]))
+                L.append('%s_display([%s], %s)' % (p, ', '.join(self.dargs(args, sc)), nm != '$write'))
+                if nm == '$fatal':
+                    L.append(p + '_finish()')
+            elif nm in ('$finish', '$stop'):
+                L.append(p + '_finish()')
+            elif nm in ('$dumpfile', '$dumpvars', '$timeformat', '$monitor'):
+                L.append(p + 'pass')
+            else:
+                raise SvError('%s: line %s: system task %s not supported' % (sc.path, n.line, nm))
+        elif k == 'return':
+            if ctx.get('func') is not None:
+                fi = ctx['func']
+                if n.expr is not None:
+                    self.assign(Node('id', name=fi.name, line=n.line), ctx['fsc'], n.expr, sc, False, L, ind)
+                L.append('%sreturn %s' % (p, ctx['fret']))
+            elif ctx.get('task') is not None:
+                L.append('%sreturn %s' % (p, ctx['tret']))
+            else:
+                raise SvError('%s: line %s: return outside a subroutine' % (sc.path, n.line))
+        elif k in ('break', 'continue'):
+            L.append(p + k)
+        else:
+            raise SvError('%s: line %s: statement %s not supported' % (sc.path, n.line, k))
+        if len(L) == start:
+            L.append(p + 'pass')
+
+    def body(self, n, sc, L, ind, ctx):
+        start = len(L)
+        self.st(n, sc, L, ind, ctx)
+        if len(L) == start:
+            L.append('    ' * ind + 'pass')
+
+    # ------------------------------------------------------------------ subroutines
+    def call_args(self, info, actuals, sc, line):
+        formals = info.node.args
+        if len(actuals) != len(formals):
+            if not (len(actuals) == 0 and len(formals) == 0):
+                raise SvError('%s: line %s: %s expects %d arguments, got %d' % (sc.path, line, info.name, len(formals),
+                                                                                len(actuals)))
+        out = []
+        for fa, a in zip(formals, actuals):
+            if fa['dir'] in ('output',):
+                out.append(None)
+                continue
+            ti = self.tyinfo(fa['ty'], info.scope)
+            if ti['isstr']:
+                out.append(self.exstr(a, sc))
+                continue
+            rw, rs, _ = self.selfw(a, sc)
+            W = max(ti['w'], rw)
+            code = self.ex(a, W, rs, sc)
+            if W > ti['w']:
+                code = '(%s & 0x%x)' % (code, mask(ti['w']))
+            out.append(code)
+        return out
+
+    def compile_sub(self, info):
+        if info.kind != 'func':
+            raise SvError('%s is not a function' % info.name)
+        if info.py is not None:
+            return info.py
+        node = info.node
+        info.py = self.new('f_%s_' % node.name)
+        fsc = Scope(info.scope)
+        params = []
+        L = []
+        for fa in node.args:
+            ti = self.tyinfo(fa['ty'], fsc)
+            py = self.new_local(fsc, fa['name'], ti, node.line)
+            params.append(py)
+        rty = node.rty
+        ret = None
+        if rty != 'void':
+            ti = self.tyinfo(rty, fsc)
+            ret = self.new_local(fsc, node.name, ti, node.line)
+            L.append('    %s = 0' % ret)
+        for d in node.decls:
+            ti = self.tyinfo(d.ty, fsc, d.line)
+            py = self.new_local(fsc, d.name, ti, d.line)
+            L.append('    %s = 0' % py)
+            if d.init is not None:
+                self.assign(Node('id', name=d.name, line=d.line), fsc, d.init, fsc, False, L, 1)
+        ctx = {'gen': False, 'func': Info('x', name=node.name), 'fsc': fsc, 'fret': ret or 'None'}
+        saved = self.reads
+        self.st(node.body, fsc, L, 1, ctx)
+        self.reads = saved
+        src = ['def %s(%s):' % (info.py, ', '.join(params))] + L + ['    return %s' % (ret or 'None')]
+        self.emit(src)
+        return info.py
+
+    def compile_task(self, info):
+        if info.py is not None:
+            return info.py, getattr(info, 'py_plain', None)
+        node = info.node
+        timing = self.task_timing(info)
+        base = self.new('t_%s_' % node.name)
+        info.py = base
+        info.py_plain = base + '_p' if not timing else None
+        tsc = Scope(info.scope)
+        params = []
+        outs = []
+        L = []
+        for fa in node.args:
+            ti = self.tyinfo(fa['ty'], tsc)
+            py = self.new_local(tsc, fa['name'], ti, node.line)
+            if fa['dir'] == 'output':
+                outs.append(py)
+                L.append('    %s = %s' % (py, "''" if ti['isstr'] else '0'))
+            else:
+                params.append(py)
+                if fa['dir'] == 'inout':
+                    outs.append(py)
+        for d in node.decls:
+            ti = self.tyinfo(d.ty, tsc, d.line)
+            py = self.new_local(tsc, d.name, ti, d.line)
+            L.append('    %s = %s' % (py, "''" if ti['isstr'] else '0'))
+            if d.init is not None:
+                self.assign(Node('id', name=d.name, line=d.line), tsc, d.init, tsc, False, L, 1)
+        tret = '(%s)' % ''.join(o + ', ' for o in outs)
+        ctx = {'gen': timing, 'task': info, 'tret': tret}
+        saved = self.reads
+        self.reads = None
+        self.st(node.body, tsc, L, 1, ctx)
+        self.reads = saved
+        if timing:
+            src = ['def %s(%s):' % (base, ', '.join(params)), '    if False:', '        yield'] + L + \
+                  ['    return %s' % tret]
+        else:
+            src = ['def %s(%s):' % (info.py_plain, ', '.join(params))] + L + ['    return %s' % tret,
+                   'def %s(*a):' % base, '    return %s(*a)' % info.py_plain, '    yield']
+        self.emit(src)
+        return info.py, info.py_plain
+
+    # ------------------------------------------------------------------ processes
+    def emit(self, lines):
+        code = '\n'.join(lines) + '\n'
+        self.src.append(code)
+        try:
+            exec(compile(code, '<svsim>', 'exec'), self.G)
+        except SyntaxError as e:
+            raise SvError('internal codegen error: %s\n%s' % (e, code))
+
+    def compile_cassign(self, lhs, lsc, rhs, rsc, line):
+        fname = self.new('c')
+        self.reads = set()
+        self.writes = set()
+        L = ['def %s():' % fname]
+        self.assign(lhs, lsc, rhs, rsc, False, L, 1)
+        self.emit(L)
+        self.procs.append((3, fname, sorted(self.reads, key=id), '%s:%s assign' % (lsc.path, line), set(self.writes)))
+        self.cassigns.append((lhs, lsc, rhs, rsc, line))
+        self.reads = None
+        self.writes = None
+
+    def compile_proc(self, it, sc):
+        pk = it.pk
+        stmt = it.stmt
+        name = '%s:%s %s' % (sc.path, it.line, pk)
+        fname = self.new('p')
+        self.writes = set()
+        if pk == 'always_comb' or (pk == 'always' and stmt.kind == 'evctl' and stmt.events == '*'):
+            body = stmt if pk == 'always_comb' else stmt.stmt
+            self.reads = set()
+            L = ['def %s():' % fname]
+            self.body(body, sc, L, 1, {'gen': False})
+            self.emit(L)
+            self.procs.append((0, fname, sorted(self.reads, key=id), name, set(self.writes)))
+        elif pk in ('always', 'always_ff') and stmt.kind == 'evctl' and not self.has_timing(stmt.stmt, sc):
+            self.reads = None
+            L = ['def %s():' % fname]
+            self.body(stmt.stmt, sc, L, 1, {'gen': False})
+            self.emit(L)
+            sens = []
+            for edge, e in stmt.events:
+                if e.kind != 'id':
+                    raise SvError('%s: event on an expression not supported' % name)
+                info = sc.lookup(e.name, e.line)
+                sens.append((info.sig, {'any': 0, 'posedge': 1, 'negedge': 2}[edge]))
+            self.procs.append((1, fname, sens, name, set(self.writes)))
+        elif pk in ('always', 'always_ff', 'initial'):
+            self.reads = None
+            L = ['def %s():' % fname, '    if False:', '        yield']
+            if pk == 'initial':
+                self.body(stmt, sc, L, 1, {'gen': True})
+            else:
+                L.append('    while True:')
+                self.body(stmt, sc, L, 2, {'gen': True})
+            self.emit(L)
+            self.procs.append((2, fname, [], name, set(self.writes)))
+        else:
+            raise SvError('%s: %s not supported' % (name, pk))
+        self.reads = None
+        self.writes = None
+
+    def build(self):
+        # time 0 initial values
+        for info, e, sc in self.inits:
+            if info.isstr:
+                info.sig.v = eval(self.exstr(e, sc), self.G)
+            else:
+                rw, rs, _ = self.selfw(e, sc)
+                W = max(rw, info.w)
+                info.sig.v = eval(self.ex(e, W, rs, sc), self.G) & mask(info.w)
+        start = []
+        for kind, fname, sens, name, writes in self.procs:
+            p = Proc(self.G[fname], 1 if kind == 3 else kind, name)
+            if kind == 1:
+                for s, edge in sens:
+                    s.edge.append((p, edge))
+                continue
+            if kind in (0, 3):
+                for s in sens:
+                    s.comb.append(p)
+            start.append(p)
+        return start
+
+
+def putb(v, off, w, val, tw):
+    if isinstance(off, int) and (off < 0 or off >= tw):
+        return v
+    m = ((1 << w) - 1) << off
+    return ((v & ~m) | ((val << off) & m)) & ((1 << tw) - 1)
@@ -0,0 +1,744 @@
+"""Lint pass over the elaborated design, modelled on Verilator's -Wall checks:
+WIDTHEXPAND / WIDTHTRUNC / WIDTHCONCAT, index widths, SELRANGE, UNUSEDSIGNAL, UNDRIVEN,
+UNUSEDPARAM, MULTIDRIVEN, BLKSEQ, COMBDLY, LATCH, CASEINCOMPLETE, CASEOVERLAP,
+PINMISSING, PINCONNECTEMPTY, VARHIDDEN, DECLFILENAME."""
+import os
+from svparse import SvError, Node
+from svelab import Scope, Info, mask, COMPARE, LOGIC, SHIFT
+
+
+def clog2(n):
+    return max(1, (n - 1).bit_length())
+
+
+def ranges(m, w):
+    out = []
+    i = 0
+    while i < w:
+        if (m >> i) & 1:
+            j = i
+            while j + 1 < w and (m >> (j + 1)) & 1:
+                j += 1
+            out.append((j, i))
+            i = j + 1
+        else:
+            i += 1
+    return out
+
+
+def pname(n):
+    k = n.kind
+    if k == 'id':
+        return "VARREF '%s'" % n.name
+    if k == 'num':
+        return 'CONST'
+    if k in ('index', 'range', 'ipart'):
+        return 'SEL'
+    if k == 'bin':
+        return {'+': 'ADD', '-': 'SUB', '*': 'MUL', '&': 'AND', '|': 'OR', '^': 'XOR', '/': 'DIV', '%': 'MOD',
+                '<<': 'SHIFTL', '>>': 'SHIFTR', '>>>': 'SHIFTRS', '==': 'EQ', '!=': 'NEQ', '<': 'LT', '<=': 'LTE',
+                '>': 'GT', '>=': 'GTE', '&&': 'LOGAND', '||': 'LOGOR'}.get(n.op, 'OP' + n.op)
+    if k == 'un':
+        return {'~': 'NOT', '-': 'NEGATE', '!': 'LOGNOT'}.get(n.op, 'RED' + n.op)
+    if k == 'cond':
+        return 'COND'
+    if k in ('concat', 'repl'):
+        return 'CONCAT' if k == 'concat' else 'REPLICATE'
+    if k == 'call':
+        return "FUNCREF '%s'" % n.name
+    return k.upper()
+
+
+class ModLint:
+    def __init__(self, top, mod, sc, path):
+        self.top = top
+        self.el = top.el
+        self.mod = mod
+        self.sc = sc
+        self.path = path
+        self.rd = {}
+        self.wr = {}
+        self.proc = None
+        self.pkind = None
+
+    def warn(self, code, line, msg):
+        self.top.add(code, self.mod.file, line, msg)
+
+    def lookup(self, name, sc, line):
+        s = sc
+        while s is not None:
+            if name in s.d:
+                return s.d[name], s is self.sc
+            s = s.parent
+        raise SvError('%s:%s undeclared %s' % (self.mod.file, line, name))
+
+    def selfw(self, n, sc):
+        return self.el.selfw(n, sc)
+
+    # ---------------------------------------------------------------- usage tracking
+    def bitmask(self, n, info, sc):
+        """mask of the bits of info touched by select n (constant selects only)"""
+        full = mask(info.w)
+        if n.kind == 'index':
+            c = self.el.try_const(n.idx, sc)
+            if c is None:
+                return full
+            off = c - info.plsb if info.desc else info.plsb - c
+            if off < 0 or off >= info.w:
+                self.warn('SELRANGE', n.line, "Selection index out of range: '%s'[%d]" % (n.base.name, c))
+                return 0
+            return 1 << off
+        if n.kind == 'range':
+            msb = self.el.cint(n.msb, sc)
+            lsb = self.el.cint(n.lsb, sc)
+            off = lsb - info.plsb if info.desc else info.plsb - lsb
+            w = abs(msb - lsb) + 1
+            if off < 0 or off + w > info.w:
+                self.warn('SELRANGE', n.line, "Selection index out of range: '%s'[%d:%d]" % (n.base.name, msb, lsb))
+            return (mask(w) << max(off, 0)) & full
+        c = self.el.try_const(n.start, sc)
+        if c is None:
+            return full
+        w = self.el.cint(n.width, sc)
+        lsb = c if n.dir == '+:' else c - w + 1
+        off = lsb - info.plsb if info.desc else info.plsb - lsb
+        return (mask(w) << max(off, 0)) & full
+
+    def mark(self, table, name, m):
+        if table is self.rd:
+            self.rd[name] = self.rd.get(name, 0) | m
+        else:
+            self.wr.setdefault(name, []).append((self.proc, m, self.pkind))
+
+    # ---------------------------------------------------------------- expressions
+    def unsized(self, n):
+        """value of an expression built only from unsized literals (Verilator keeps these
+        width-flexible), else None"""
+        k = n.kind
+        if k == 'num':
+            return n.val if n.w is None and n.fill is None else None
+        if k == 'bin' and n.op in ('+', '-', '*', '/', '<<', '>>', '&', '|', '^'):
+            a = self.unsized(n.a)
+            b = self.unsized(n.b)
+            if a is None or b is None:
+                return None
+            return {'+': a + b, '-': a - b, '*': a * b, '/': a // b if b else 0, '<<': a << b, '>>': a >> b,
+                    '&': a & b, '|': a | b, '^': a ^ b}[n.op]
+        if k == 'un' and n.op == '-':
+            a = self.unsized(n.a)
+            return None if a is None else -a
+        return None
+
+    def minw(self, n, sc):
+        """Verilator widthMin: unsized literals count only their value bits and keep the
+        context-determined operators above them width-flexible"""
+        u = self.unsized(n)
+        if u is not None:
+            return max(1, u.bit_length()) if u >= 0 else 32
+        if n.kind == 'num' and n.fill is not None:
+            return 1
+        if self.ctxop(n):
+            if n.kind == 'bin':
+                if n.op in SHIFT:
+                    return self.minw(n.a, sc)
+                return max(self.minw(n.a, sc), self.minw(n.b, sc))
+            if n.kind == 'un':
+                return self.minw(n.a, sc)
+            return max(self.minw(n.a, sc), self.minw(n.b, sc))
+        return self.selfw(n, sc)[0]
+
+    def ctxop(self, n):
+        k = n.kind
+        if k == 'bin':
+            return n.op in ('+', '-', '*', '/', '%', '&', '|', '^', '~^', '^~') or n.op in SHIFT
+        if k == 'un':
+            return n.op in ('~', '-', '+')
+        return k == 'cond'
+
+    def chk(self, n, W, sc, what='expression', warn=True):
+        """check n used where W bits are expected (None = self-determined)"""
+        sw, ss, isstr = self.selfw(n, sc)
+        if isstr:
+            self.descend(n, sc, sw)
+            return
+        if W is None:
+            W = sw
+        u = self.unsized(n)
+        if u is not None or (n.kind == 'num' and n.fill is not None):
+            if warn and u is not None and u >= 0 and u.bit_length() > W:
+                self.warn('WIDTHTRUNC', n.line, 'Operator %s expects %d bits, but CONST generates %d bits.'
+                          % (what, W, u.bit_length()))
+            return
+        if self.ctxop(n):
+            pw = self.minw(n, sc)
+            if pw > W:
+                if warn:
+                    self.warn('WIDTHTRUNC', n.line, 'Operator %s expects %d bits, but %s generates %d bits.'
+                              % (what, W, pname(n), pw))
+                W = pw
+            if n.kind == 'bin':
+                if n.op in SHIFT:
+                    self.chk(n.a, W, sc, pname(n), warn)
+                    self.chk(n.b, None, sc)
+                    return
+                wa = self.minw(n.a, sc)
+                wb = self.minw(n.b, sc)
+                wnA = wnB = True
+                if n.op in ('+', '-'):
+                    wnA = W != wa + 1
+                    wnB = W != wb + 1
+                elif n.op == '*':
+                    wnA = W < wa
+                    wnB = W < wb
+                self.chk(n.a, W, sc, pname(n), wnA)
+                self.chk(n.b, W, sc, pname(n), wnB)
+            elif n.kind == 'un':
+                self.chk(n.a, W, sc, pname(n), warn)
+            else:
+                self.boolchk(n.c, sc, 'COND')
+                self.chk(n.a, W, sc, 'COND', True)
+                self.chk(n.b, W, sc, 'COND', True)
+            return
+        m = self.minw(n, sc)
+        if warn and sw != W and (sw == m or m > W):
+            self.warn('WIDTHEXPAND' if sw < W else 'WIDTHTRUNC', n.line,
+                      'Operator %s expects %d bits, but %s generates %d bits.' % (what, W, pname(n), sw))
+        self.descend(n, sc, sw)
+
+    def boolchk(self, n, sc, what):
+        sw = self.minw(n, sc)
+        if sw != 1:
+            self.warn('WIDTHTRUNC', n.line, 'Logical operator %s expects 1 bit, but %s generates %d bits.'
+                      % (what, pname(n), sw))
+        self.chk(n, None, sc)
+
+    def idxchk(self, idx, need, sc, what):
+        if self.el.try_const(idx, sc) is not None:
+            self.descend(idx, sc, self.selfw(idx, sc)[0])
+            return
+        iw = self.selfw(idx, sc)[0]
+        if iw != need:
+            self.warn('WIDTHEXPAND' if iw < need else 'WIDTHTRUNC', idx.line,
+                      'Bit extraction of %s requires %d bit index, not %d bits.' % (what, need, iw))
+        self.descend(idx, sc, iw)
+
+    def descend(self, n, sc, sw):
+        k = n.kind
+        if k in ('num', 'str'):
+            return
+        if k == 'id':
+            info, modlevel = self.lookup(n.name, sc, n.line)
+            if modlevel and info.kind == 'sig':
+                self.mark(self.rd, n.name, mask(info.w))
+            return
+        if k in ('index', 'range', 'ipart'):
+            base = n.base
+            if base.kind == 'id':
+                info, modlevel = self.lookup(base.name, sc, base.line)
+                if k == 'index' and info.arr is not None:
+                    self.idxchk(n.idx, clog2(info.arr[1]), sc, "array '%s'" % base.name)
+                    if modlevel:
+                        self.mark(self.rd, base.name, mask(info.w))
+                    return
+                if info.kind == 'param':
+                    m = 0
+                else:
+                    m = self.bitmask(n, info, sc)
+                if modlevel and info.kind == 'sig':
+                    self.mark(self.rd, base.name, m)
+                bw = info.w
+                bname = base.name
+            else:
+                self.descend(base, sc, self.selfw(base, sc)[0])
+                bw = self.selfw(base, sc)[0]
+                bname = '<expr>'
+            if k == 'index':
+                self.idxchk(n.idx, clog2(bw), sc, "'%s'[%d bits]" % (bname, bw))
+            elif k == 'ipart':
+                self.idxchk(n.start, clog2(bw), sc, "'%s'[%d bits]" % (bname, bw))
+            return
+        if k == 'un':
+            if n.op == '!':
+                self.boolchk(n.a, sc, 'LOGNOT')
+            else:
+                self.chk(n.a, None, sc)
+            return
+        if k == 'bin':
+            op = n.op
+            if op in COMPARE:
+                wa = self.minw(n.a, sc)
+                wb = self.minw(n.b, sc)
+                if self.unsized(n.a) is not None:
+                    wa = min(wa, wb)
+                if self.unsized(n.b) is not None:
+                    wb = min(wa, wb)
+                Wc = max(wa, wb)
+                self.chk(n.a, Wc, sc, pname(n))
+                self.chk(n.b, Wc, sc, pname(n))
+            elif op in LOGIC:
+                self.boolchk(n.a, sc, pname(n))
+                self.boolchk(n.b, sc, pname(n))
+            else:
+                self.chk(n, sw, sc)
+            return
+        if k == 'cond':
+            self.chk(n, sw, sc)
+            return
+        if k in ('concat', 'repl'):
+            for p in n.parts:
+                if p.kind == 'num' and p.w is None:
+                    self.warn('WIDTHCONCAT', p.line, 'Unsized numbers/parameters not allowed in concatenations.')
+                self.chk(p, None, sc)
+            return
+        if k == 'call':
+            info, _ = self.lookup(n.name, sc, n.line)
+            for fa, a in zip(info.node.args, n.args):
+                ti = self.el.tyinfo(fa['ty'], info.scope)
+                self.chk(a, ti['w'], sc, "function argument '%s'" % fa['name'])
+            return
+        if k == 'syscall':
+            for a in n.args:
+                if a.kind != 'str':
+                    self.chk(a, None, sc)
+            return
+        if k == 'cast':
+            self.chk(n.a, None, sc)
+            return
+
+    # ---------------------------------------------------------------- lvalues
+    def lval(self, n, sc, nb):
+        k = n.kind
+        if k == 'concat':
+            for p in n.parts:
+                self.lval(p, sc, nb)
+            return
+        base = n if k == 'id' else n.base
+        if base.kind == 'index':
+            self.idxchk(base.idx, clog2(self.lookup(base.base.name, sc, n.line)[0].arr[1]), sc,
+                        "array '%s'" % base.base.name)
+            base = base.base
+        info, modlevel = self.lookup(base.name, sc, n.line)
+        if k == 'id':
+            m = mask(info.w)
+        elif k == 'index' and info.arr is not None:
+            self.idxchk(n.idx, clog2(info.arr[1]), sc, "array '%s'" % base.name)
+            m = mask(info.w)
+        else:
+            m = self.bitmask(n, info, sc)
+            if k == 'index':
+                self.idxchk(n.idx, clog2(info.w), sc, "'%s'" % base.name)
+            elif k == 'ipart':
+                self.idxchk(n.start, clog2(info.w), sc, "'%s'" % base.name)
+        if not modlevel or info.kind != 'sig':
+            return
+        if self.pkind == 'seq' and not nb:
+            self.warn('BLKSEQ', n.line, "Blocking assignment '=' in sequential logic process")
+        if self.pkind == 'comb' and nb:
+            self.warn('COMBDLY', n.line, "Non-blocking assignment '<=' in combinational logic process")
+        self.mark(self.wr, base.name, m)
+
+    def assign(self, lhs, rhs, sc, nb, what='ASSIGN'):
+        lw = self.el.lwidth(lhs, sc)
+        if lhs.kind == 'id' and self.lookup(lhs.name, sc, lhs.line)[0].isstr:
+            self.descend(rhs, sc, 0)
+        else:
+            self.chk(rhs, lw, sc, what)
+        self.lval(lhs, sc, nb)
+
+    # ---------------------------------------------------------------- statements
+    def local(self, sc, d):
+        ti = self.el.tyinfo(d.ty, sc, d.line)
+        if self.sc.has(d.name) and d.name in self.sc.d:
+            self.warn('VARHIDDEN', d.line, "Declaration of signal hides declaration in upper scope: '%s'" % d.name)
+        sc[d.name] = Info('local', py='x', name=d.name, line=d.line, **ti)
+
+    def st(self, n, sc):
+        k = n.kind
+        if k == 'block':
+            bsc = Scope(sc)
+            for d in n.decls:
+                self.local(bsc, d)
+                if d.init is not None:
+                    self.chk(d.init, self.el.tyinfo(d.ty, bsc)['w'], bsc, 'ASSIGN')
+            for s in n.stmts:
+                self.st(s, bsc)
+        elif k == 'assign':
+            self.assign(n.lhs, n.rhs, sc, n.nb, 'ASSIGNDLY' if n.nb else 'ASSIGN')
+        elif k == 'if':
+            self.boolchk(n.cond, sc, 'IF')
+            self.st(n.then, sc)
+            if n.els is not None:
+                self.st(n.els, sc)
+        elif k == 'case':
+            sw = self.selfw(n.sel, sc)[0]
+            self.chk(n.sel, None, sc)
+            seen = {}
+            has_default = False
+            for labels, body in n.items:
+                if labels is None:
+                    has_default = True
+                else:
+                    for lab in labels:
+                        self.chk(lab, sw, sc, 'CASE item')
+                        c = self.el.try_const(lab, sc)
+                        if c is not None:
+                            c &= mask(sw)
+                            if c in seen:
+                                self.warn('CASEOVERLAP', lab.line, 'Case values overlap (example pattern 0x%x)' % c)
+                            seen[c] = True
+                self.st(body, sc)
+            if not has_default and sw <= 16 and len(seen) < (1 << sw):
+                missing = next(v for v in range(1 << sw) if v not in seen)
+                self.warn('CASEINCOMPLETE', n.line, 'Case values incompletely covered (example pattern 0x%x)'
+                          % missing)
+        elif k == 'for':
+            fsc = Scope(sc)
+            for it in n.init:
+                if it.kind == 'decl':
+                    self.local(fsc, it)
+                    self.chk(it.init, self.el.tyinfo(it.ty, fsc)['w'], fsc, 'ASSIGN')
+                else:
+                    self.st(it, fsc)
+            self.boolchk(n.cond, fsc, 'FOR')
+            self.st(n.body, fsc)
+            self.st(n.step, fsc)
+        elif k in ('while', 'dowhile'):
+            self.boolchk(n.cond, sc, 'WHILE')
+            self.st(n.body, sc)
+        elif k == 'repeat':
+            self.chk(n.n, None, sc)
+            self.st(n.body, sc)
+        elif k == 'forever':
+            self.st(n.body, sc)
+        elif k in ('evctl', 'delay'):
+            if k == 'evctl' and n.events != '*':
+                for _, e in n.events:
+                    self.descend(e, sc, 1)
+            self.st(n.stmt, sc)
+        elif k == 'wait':
+            self.boolchk(n.cond, sc, 'WAIT')
+            self.st(n.stmt, sc)
+        elif k == 'taskcall':
+            info, _ = self.lookup(n.name, sc, n.line)
+            for fa, a in zip(info.node.args, n.args):
+                ti = self.el.tyinfo(fa['ty'], info.scope)
+                if fa['dir'] == 'output':
+                    self.lval(a, sc, False)
+                else:
+                    self.chk(a, ti['w'], sc, "task argument '%s'" % fa['name'])
+        elif k == 'systask':
+            for a in n.args:
+                if a.kind != 'str':
+                    self.chk(a, None, sc)
+        elif k == 'return':
+            if n.expr is not None:
+                self.chk(n.expr, self.ret_w, sc, 'FUNC return')
+
+    # ---------------------------------------------------------------- latch check
+    def defs(self, n, sc):
+        """(definitely assigned masks, any assigned masks) of module signals for statement n"""
+        k = n.kind
+        if k == 'assign':
+            d = {}
+            self.lv_masks(n.lhs, sc, d)
+            return d, dict(d)
+        if k == 'block':
+            bsc = Scope(sc)
+            for dcl in n.decls:
+                bsc[dcl.name] = Info('local', py='x', name=dcl.name, **self.el.tyinfo(dcl.ty, bsc))
+            D, A = {}, {}
+            for s in n.stmts:
+                d, a = self.defs(s, bsc)
+                for x, m in d.items():
+                    D[x] = D.get(x, 0) | m
+                for x, m in a.items():
+                    A[x] = A.get(x, 0) | m
+            return D, A
+        if k == 'if':
+            dt, at = self.defs(n.then, sc)
+            de, ae = self.defs(n.els, sc) if n.els is not None else ({}, {})
+            D = {x: dt[x] & de[x] for x in dt if x in de and dt[x] & de[x]}
+            A = dict(at)
+            for x, m in ae.items():
+                A[x] = A.get(x, 0) | m
+            return D, A
+        if k == 'case':
+            sw = self.selfw(n.sel, sc)[0]
+            full = any(lab is None for lab, _ in n.items) or \
+                sum(len(lab) for lab, _ in n.items if lab is not None) >= (1 << sw)
+            D = None
+            A = {}
+            for _, body in n.items:
+                d, a = self.defs(body, sc)
+                D = dict(d) if D is None else {x: D[x] & d[x] for x in D if x in d}
+                for x, m in a.items():
+                    A[x] = A.get(x, 0) | m
+            return (D or {}) if full else {}, A
+        if k == 'for':
+            fsc = Scope(sc)
+            for it in n.init:
+                if it.kind == 'decl':
+                    fsc[it.name] = Info('local', py='x', name=it.name, **self.el.tyinfo(it.ty, fsc))
+            return self.defs(n.body, fsc)
+        if k == 'taskcall':
+            d = {}
+            info, _ = self.lookup(n.name, sc, n.line)
+            for fa, a in zip(info.node.args, n.args):
+                if fa['dir'] == 'output':
+                    self.lv_masks(a, sc, d)
+            return d, dict(d)
+        return {}, {}
+
+    def lv_masks(self, n, sc, d):
+        if n.kind == 'concat':
+            for p in n.parts:
+                self.lv_masks(p, sc, d)
+            return
+        base = n if n.kind == 'id' else n.base
+        if base.kind == 'index':
+            base = base.base
+        info, modlevel = self.lookup(base.name, sc, n.line)
+        if not modlevel or info.kind != 'sig':
+            return
+        if n.kind == 'id' or info.arr is not None:
+            m = mask(info.w)
+        else:
+            try:
+                m = self.bitmask(n, info, sc)
+            except SvError:
+                m = mask(info.w)
+        d[base.name] = d.get(base.name, 0) | m
+
+    # ---------------------------------------------------------------- module
+    def run(self):
+        mod = self.mod
+        sc = self.sc
+        base = os.path.splitext(os.path.basename(mod.file))[0]
+        if base != mod.name:
+            self.warn('DECLFILENAME', mod.line, "Filename '%s' does not match MODULE name: '%s'" % (base, mod.name))
+        # declarations
+        for it in mod.items:
+            if it.kind == 'decl' and it.init is not None:
+                info = sc.d[it.name]
+                self.proc = ('init', it.line) if it.ty['base'] != 'wire' else ('wire', it.line)
+                self.pkind = 'init' if it.ty['base'] != 'wire' else 'assign'
+                if info.isstr:
+                    continue
+                self.chk(it.init, info.w, sc, 'ASSIGN')
+                self.mark(self.wr, it.name, mask(info.w))
+        for it in mod.items:
+            if it.kind == 'cassign':
+                self.proc = ('assign', it.line)
+                self.pkind = 'assign'
+                self.assign(it.lhs, it.rhs, sc, False, 'ASSIGNW')
+            elif it.kind == 'proc':
+                self.proc = ('proc', it.line)
+                stmt = it.stmt
+                if it.pk == 'initial':
+                    self.pkind = 'init'
+                    self.st(stmt, sc)
+                elif it.pk == 'always_comb' or (stmt.kind == 'evctl' and stmt.events == '*'):
+                    self.pkind = 'comb'
+                    body = stmt if it.pk == 'always_comb' else stmt.stmt
+                    self.st(body, sc)
+                    D, A = self.defs(body, sc)
+                    for x, m in sorted(A.items()):
+                        if D.get(x, 0) != m:
+                            self.warn('LATCH', it.line, "Latch inferred for signal '%s' (not all control paths "
+                                      "of combinational always assign a value)" % x)
+                else:
+                    edge = stmt.kind == 'evctl' and stmt.events != '*' and \
+                        any(e[0] != 'any' for e in stmt.events)
+                    self.pkind = 'seq' if edge else 'comb'
+                    self.st(stmt, sc)
+            elif it.kind in ('task', 'function'):
+                self.proc = ('sub', it.line)
+                self.pkind = 'sub'
+                fsc = Scope(sc)
+                for fa in it.args:
+                    ti = self.el.tyinfo(fa['ty'], sc)
+                    fsc[fa['name']] = Info('local', py='x', name=fa['name'], **ti)
+                    if fa['name'] in sc.d:
+                        self.warn('VARHIDDEN', it.line, "Declaration of signal hides declaration in upper scope: "
+                                  "'%s'" % fa['name'])
+                self.ret_w = None
+                if it.kind == 'function' and it.rty != 'void':
+                    ti = self.el.tyinfo(it.rty, sc)
+                    fsc[it.name] = Info('local', py='x', name=it.name, **ti)
+                    self.ret_w = ti['w']
+                for d in it.decls:
+                    self.local(fsc, d)
+                self.st(it.body, fsc)
+            elif it.kind == 'inst':
+                self.inst(it)
+        # ports
+        for p in mod.ports:
+            info = sc.d[p.name]
+            if p.dir in ('input', 'inout'):
+                self.wr.setdefault(p.name, []).append((('port',), mask(info.w), 'port'))
+            if p.dir in ('output', 'inout'):
+                self.rd[p.name] = mask(info.w)
+        names = [(p.name, p.line) for p in mod.ports] + [(it.name, it.line) for it in mod.items if it.kind == 'decl']
+        for name, line in names:
+            info = sc.d[name]
+            full = mask(info.w) if not info.isstr else 1
+            r = self.rd.get(name, 0) & full
+            if r != full and 'unused' not in name.lower():
+                if r == 0:
+                    self.warn('UNUSEDSIGNAL', line, "Signal is not used: '%s'" % name)
+                else:
+                    bits = ranges(full & ~r, info.w)
+                    self.warn('UNUSEDSIGNAL', line, "Bits of signal are not used: '%s'%s" % (
+                        name, ','.join('[%d:%d]' % (a + info.plsb, b + info.plsb) if a != b else '[%d]'
+                                       % (a + info.plsb) for a, b in bits)))
+            ws = self.wr.get(name, [])
+            wm = 0
+            for _, m, _ in ws:
+                wm |= m
+            wm &= full
+            if wm != full:
+                if wm == 0:
+                    self.warn('UNDRIVEN', line, "Signal is not driven: '%s'" % name)
+                else:
+                    bits = ranges(full & ~wm, info.w)
+                    self.warn('UNDRIVEN', line, "Bits of signal are not driven: '%s'%s" % (
+                        name, ','.join('[%d:%d]' % (a + info.plsb, b + info.plsb) for a, b in bits)))
+            drivers = {}
+            for pid, m, pk in ws:
+                if pk in ('init',):
+                    continue
+                drivers[pid] = drivers.get(pid, 0) | m
+            if len(drivers) > 1:
+                tot = 0
+                clash = False
+                for m in drivers.values():
+                    if tot & m:
+                        clash = True
+                    tot |= m
+                if clash:
+                    self.warn('MULTIDRIVEN', line, "Signal has multiple driving blocks: '%s' (lines %s)" % (
+                        name, ', '.join(str(p[1]) for p in drivers if len(p) > 1)))
+        # parameters
+        used = set()
+        self.collect_ids(mod.items, used, skip_param=True)
+        self.collect_ids(mod.ports, used)
+        for p in mod.params:
+            self.collect_ids(p.value, used)
+        for it in mod.items:
+            if it.kind == 'param':
+                self.collect_ids(it.value, used)
+        for p in list(mod.params) + [it for it in mod.items if it.kind == 'param']:
+            if p.name not in used:
+                self.warn('UNUSEDPARAM', p.line, "Parameter is not used: '%s'" % p.name)
+
+    def collect_ids(self, x, used, skip_param=False):
+        if isinstance(x, Node):
+            if skip_param and x.kind == 'param':
+                return
+            if x.kind in ('id', 'call') or x.kind == 'taskcall':
+                used.add(x.name)
+            for v in x.__dict__.values():
+                self.collect_ids(v, used)
+        elif isinstance(x, (list, tuple)):
+            for v in x:
+                self.collect_ids(v, used)
+        elif isinstance(x, dict):
+            for v in x.values():
+                self.collect_ids(v, used)
+
+    def inst(self, it):
+        cpath = self.path + '.' + it.name
+        csc = None
+        for p, m, s in self.el.instances:
+            if p == cpath:
+                csc = s
+                cmod = m
+        if csc is None:
+            return
+        for p in cmod.ports:
+            if p.name not in it.conns:
+                self.warn('PINMISSING', it.line, "Cell has missing pin: '%s'" % p.name)
+                continue
+            e = it.conns[p.name]
+            if e is None:
+                self.warn('PINCONNECTEMPTY', it.line, "Cell pin connected by name with empty reference: '%s'" % p.name)
+                continue
+            cw = csc.d[p.name].w
+            self.proc = ('inst', it.line, it.name)
+            self.pkind = 'inst'
+            if p.dir == 'input':
+                self.chk(e, cw, self.sc, "PIN '%s'" % p.name)
+            else:
+                lw = self.el.lwidth(e, self.sc)
+                if lw != cw:
+                    self.warn('WIDTHEXPAND' if cw < lw else 'WIDTHTRUNC', it.line,
+                              "Operator PIN '%s' expects %d bits, but the connection generates %d bits." %
+                              (p.name, lw, cw))
+                self.lval(e, self.sc, True)
+
+
+class Lint:
+    def __init__(self, el):
+        self.el = el
+        self.warns = []
+
+    def add(self, code, f, line, msg):
+        self.warns.append((code, os.path.basename(f), line, msg))
+
+    def run(self):
+        done = set()
+        for path, mod, sc in self.el.instances:
+            if mod.name in done:
+                continue
+            done.add(mod.name)
+            ModLint(self, mod, sc, path).run()
+        seen = set()
+        out = []
+        for w in self.warns:
+            if w not in seen:
+                seen.add(w)
+                out.append(w)
+        self.warns = sorted(out, key=lambda w: (w[1], w[2], w[0]))
+        return self.warns
+
+
+def load_vlt(path):
+    """Verilator configuration file: `verilator_config, lint_off -rule R [-file "glob"] [-lines a[-b]] [-match "glob"]."""
+    import re
+    import shlex
+    rules = []
+    for raw in open(path):
+        line = raw.split('//')[0].strip()
+        if not line.startswith('lint_off'):
+            continue
+        toks = shlex.split(line)
+        r = {'rule': '*', 'file': '*', 'lines': None, 'match': '*'}
+        i = 1
+        while i < len(toks):
+            k = toks[i].lstrip('-')
+            v = toks[i + 1]
+            i += 2
+            if k == 'lines':
+                a, _, b = v.partition('-')
+                r['lines'] = (int(a), int(b or a))
+            else:
+                r[k] = v
+        rules.append(r)
+    return rules
+
+
+def waived(rules, w):
+    import fnmatch
+    code, f, line, msg = w
+    text = '%%Warning-%s: %s:%d: %s' % (code, f, line, msg)
+    for r in rules:
+        if r['rule'] not in ('*', code):
+            continue
+        if not fnmatch.fnmatch(f, r['file']) and not fnmatch.fnmatch('x/' + f, r['file']):
+            continue
+        if r['lines'] and not (r['lines'][0] <= line <= r['lines'][1]):
+            continue
+        if r['match'] != '*' and not fnmatch.fnmatch(text, r['match']):
+            continue
+        return True
+    return False
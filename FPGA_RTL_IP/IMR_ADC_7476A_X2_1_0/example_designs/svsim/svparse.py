@@ -0,0 +1,842 @@
+"""Preprocessor, lexer and parser for the synthesizable + testbench SystemVerilog subset
+used by the IMR_ADC_7476A_X2 IP and its plain-SV testbenches."""
+import os
+import re
+
+
+class SvError(Exception):
+    pass
+
+
+# ----------------------------------------------------------------------------------------
+# Preprocessor
+# ----------------------------------------------------------------------------------------
+def strip_comments(text):
+    out = []
+    i = 0
+    n = len(text)
+    while i < n:
+        c = text[i]
+        if c == '"':
+            j = i + 1
+            while j < n and text[j] != '"':
+                if text[j] == '\\':
+                    j += 1
+                j += 1
+            out.append(text[i:j + 1])
+            i = j + 1
+        elif text.startswith('//', i):
+            j = text.find('\n', i)
+            if j < 0:
+                j = n
+            i = j
+        elif text.startswith('/*', i):
+            j = text.find('*/', i + 2)
+            if j < 0:
+                raise SvError('unterminated block comment')
+            out.append('\n' * text.count('\n', i, j))
+            i = j + 2
+        else:
+            out.append(c)
+            i += 1
+    return ''.join(out)
+
+
+def preprocess(path, incdirs, defines=None, _depth=0):
+    if defines is None:
+        defines = {}
+    with open(path) as f:
+        text = strip_comments(f.read())
+    text = re.sub(r'\(\*\s*[A-Za-z_]\w*\s*(=\s*"[^"]*"\s*)?\*\)', ' ', text)
+    out = []
+    stack = []          # (active, seen_true)
+    active = True
+    for lineno, line in enumerate(text.split('\n'), 1):
+        s = line.strip()
+        m = re.match(r'`(ifdef|ifndef|else|endif|elsif|define|undef|include|timescale|default_nettype|resetall)\b(.*)', s)
+        if m:
+            d, rest = m.group(1), m.group(2).strip()
+            if d in ('ifdef', 'ifndef'):
+                cond = (rest.split()[0] in defines)
+                if d == 'ifndef':
+                    cond = not cond
+                stack.append((active, cond))
+                active = active and cond
+            elif d == 'elsif':
+                parent, seen = stack[-1]
+                cond = rest.split()[0] in defines
+                stack[-1] = (parent, seen or cond)
+                active = parent and cond and not seen
+            elif d == 'else':
+                parent, seen = stack[-1]
+                active = parent and not seen
+                stack[-1] = (parent, True)
+            elif d == 'endif':
+                parent, _ = stack.pop()
+                active = parent
+            elif not active:
+                pass
+            elif d == 'define':
+                mm = re.match(r'(\w+)(\(.*?\))?\s*(.*)', rest)
+                if mm.group(2):
+                    raise SvError('%s:%d function-like macros not supported' % (path, lineno))
+                defines[mm.group(1)] = mm.group(3).strip()
+            elif d == 'undef':
+                defines.pop(rest.split()[0], None)
+            elif d == 'include':
+                fn = rest.strip().strip('"')
+                for dd in [os.path.dirname(path)] + incdirs:
+                    p = os.path.join(dd, fn)
+                    if os.path.exists(p):
+                        out.append(preprocess(p, incdirs, defines, _depth + 1).replace('\n', ' '))
+                        break
+                else:
+                    raise SvError('%s:%d include %s not found' % (path, lineno, fn))
+                continue
+            out.append('')
+            continue
+        if not active:
+            out.append('')
+            continue
+        # macro expansion
+        for _ in range(20):
+            if '`' not in line:
+                break
+
+            def rep(mo):
+                nm = mo.group(1)
+                if nm not in defines:
+                    raise SvError('%s:%d undefined macro `%s' % (path, lineno, nm))
+                return ' ' + defines[nm] + ' '
+            line = re.sub(r'`(\w+)', rep, line)
+        out.append(line)
+    if _depth == 0 and stack:
+        raise SvError('%s: unbalanced `ifdef' % path)
+    # file marker for error messages
+    return '\n'.join(out)
+
+
+# ----------------------------------------------------------------------------------------
+# Lexer
+# ----------------------------------------------------------------------------------------
+OPS = ['<<<=', '>>>=', '<<<', '>>>', '===', '!==', '<<=', '>>=', '<=', '>=', '==', '!=', '&&', '||', '<<', '>>',
+       '**', '+:', '-:', '++', '--', '+=', '-=', '*=', '|=', '&=', '^=', '~&', '~|', '~^', '^~', '::', '->',
+       '+', '-', '*', '/', '%', '&', '|', '^', '~', '!', '<', '>', '=', '?', ':', ';', ',', '.', '(', ')',
+       '[', ']', '{', '}', '@', '#', "'"]
+
+TOKEN_RE = re.compile(r'''
+  (?P<ws>\s+)
+ |(?P<based>(?:\d[\d_]*)?\s*'[sS]?[bBoOdDhH]\s*[0-9a-fA-FxXzZ_?]+)
+ |(?P<unbased>'[01xXzZ](?![\w]))
+ |(?P<time>\d[\d_]*(?:\.\d+)?(?:fs|ps|ns|us|ms|s)(?![\w]))
+ |(?P<real>\d[\d_]*\.\d+)
+ |(?P<dec>\d[\d_]*)
+ |(?P<str>"(?:[^"\\]|\\.)*")
+ |(?P<sysid>\$[A-Za-z_]\w*)
+ |(?P<id>[A-Za-z_][\w$]*)
+ |(?P<op>''' + '|'.join(re.escape(o) for o in OPS) + r''')
+''', re.X)
+
+
+class Tok:
+    __slots__ = ('k', 'v', 'line', 'file')
+
+    def __init__(self, k, v, line, file):
+        self.k = k
+        self.v = v
+        self.line = line
+        self.file = file
+
+    def __repr__(self):
+        return '%s:%r@%d' % (self.k, self.v, self.line)
+
+
+def lex(text, fname):
+    toks = []
+    pos = 0
+    line = 1
+    n = len(text)
+    while pos < n:
+        m = TOKEN_RE.match(text, pos)
+        if not m:
+            raise SvError('%s:%d: bad character %r' % (fname, line, text[pos:pos + 20]))
+        k = m.lastgroup
+        v = m.group(k)
+        if k != 'ws':
+            toks.append(Tok(k, v, line, fname))
+        line += v.count('\n')
+        pos = m.end()
+    toks.append(Tok('eof', None, line, fname))
+    return toks
+
+
+# ----------------------------------------------------------------------------------------
+# AST
+# ----------------------------------------------------------------------------------------
+class Node:
+    def __init__(self, kind, **kw):
+        self.kind = kind
+        self.__dict__.update(kw)
+
+    def __repr__(self):
+        d = dict(self.__dict__)
+        d.pop('kind')
+        d.pop('line', None)
+        return '%s(%s)' % (self.kind, ', '.join('%s=%r' % kv for kv in d.items()))
+
+
+def parse_number(text):
+    """returns (value, width or None for unsized, signed, fill)"""
+    t = text.replace('_', '').replace(' ', '').replace('\t', '')
+    if t.startswith("'") and len(t) == 2:
+        return (0, None, False, t[1])
+    m = re.match(r"(\d*)'([sS]?)([bBoOdDhH])(.+)", t)
+    if m:
+        width = int(m.group(1)) if m.group(1) else None
+        signed = bool(m.group(2))
+        base = {'b': 2, 'o': 8, 'd': 10, 'h': 16}[m.group(3).lower()]
+        digits = re.sub(r'[xXzZ?]', '0', m.group(4))
+        val = int(digits, base)
+        if width is None:
+            width = 32
+            return (val & 0xFFFFFFFF, 32, signed, None)
+        return (val & ((1 << width) - 1), width, signed, None)
+    return (int(t), None, True, None)
+
+
+TYPE_KW = {'logic', 'reg', 'wire', 'bit', 'int', 'integer', 'byte', 'shortint', 'longint', 'string', 'time', 'var',
+           'tri', 'genvar', 'real', 'event'}
+ATOM_W = {'int': (32, True), 'integer': (32, True), 'byte': (8, True), 'shortint': (16, True),
+          'longint': (64, True), 'time': (64, False), 'genvar': (32, True)}
+
+
+class Parser:
+    def __init__(self, toks):
+        self.t = toks
+        self.i = 0
+
+    # -- token helpers
+    @property
+    def cur(self):
+        return self.t[self.i]
+
+    def peek(self, k=1):
+        return self.t[min(self.i + k, len(self.t) - 1)]
+
+    def err(self, msg):
+        c = self.cur
+        raise SvError('%s:%d: %s (at %r)' % (c.file, c.line, msg, c.v))
+
+    def at(self, v):
+        c = self.cur
+        return c.v == v and c.k in ('op', 'id')
+
+    def accept(self, v):
+        if self.at(v):
+            self.i += 1
+            return True
+        return False
+
+    def expect(self, v):
+        if not self.accept(v):
+            self.err('expected %r' % v)
+
+    def ident(self):
+        c = self.cur
+        if c.k != 'id':
+            self.err('expected identifier')
+        self.i += 1
+        return c.v
+
+    # -- top level
+    def parse_file(self):
+        mods = []
+        while self.cur.k != 'eof':
+            if self.at('module'):
+                mods.append(self.parse_module())
+            elif self.at('import'):
+                self.err('package import not supported (Vivado VIP testbench?)')
+            else:
+                self.err('expected module')
+        return mods
+
+    def parse_module(self):
+        line = self.cur.line
+        fname = self.cur.file
+        self.expect('module')
+        name = self.ident()
+        params = []
+        ports = []
+        if self.accept('#'):
+            self.expect('(')
+            while not self.at(')'):
+                self.accept('parameter')
+                self.accept('localparam')
+                params.append(self.parse_param_decl_one(False))
+                if not self.accept(','):
+                    break
+            self.expect(')')
+        if self.accept('('):
+            last = None
+            while not self.at(')'):
+                last = self.parse_port(last)
+                ports.append(last)
+                if not self.accept(','):
+                    break
+            self.expect(')')
+        self.expect(';')
+        items = []
+        while not self.at('endmodule'):
+            items.extend(self.parse_module_item())
+        self.expect('endmodule')
+        return Node('module', name=name, params=params, ports=ports, items=items, line=line, file=fname)
+
+    def parse_dims(self):
+        dims = []
+        while self.at('['):
+            self.i += 1
+            msb = self.parse_expr()
+            self.expect(':')
+            lsb = self.parse_expr()
+            self.expect(']')
+            dims.append((msb, lsb))
+        return dims
+
+    def parse_type(self):
+        """[type keyword] [signed] [packed dims] -> dict or None if nothing type-like"""
+        ty = {'base': None, 'signed': None, 'dims': []}
+        seen = False
+        if self.cur.k == 'id' and self.cur.v in TYPE_KW:
+            ty['base'] = self.cur.v
+            self.i += 1
+            seen = True
+            if ty['base'] in ('var',) and self.cur.k == 'id' and self.cur.v in TYPE_KW:
+                ty['base'] = self.cur.v
+                self.i += 1
+            if ty['base'] == 'wire' and self.at('logic'):
+                self.i += 1
+        if self.at('signed'):
+            self.i += 1
+            ty['signed'] = True
+            seen = True
+        elif self.at('unsigned'):
+            self.i += 1
+            ty['signed'] = False
+            seen = True
+        if self.at('['):
+            ty['dims'] = self.parse_dims()
+            seen = True
+        return ty if seen else None
+
+    def parse_port(self, last):
+        line = self.cur.line
+        d = None
+        if self.cur.v in ('input', 'output', 'inout'):
+            d = self.cur.v
+            self.i += 1
+        ty = self.parse_type()
+        name = self.ident()
+        udims = self.parse_dims()
+        if d is None:
+            if last is None:
+                self.err('non-ANSI port list not supported')
+            d = last.dir
+            if ty is None:
+                ty = last.ty
+        if ty is None:
+            ty = {'base': None, 'signed': None, 'dims': []}
+        return Node('port', dir=d, ty=ty, name=name, udims=udims, line=line)
+
+    def parse_param_decl_one(self, local):
+        line = self.cur.line
+        ty = self.parse_type()
+        name = self.ident()
+        self.expect('=')
+        val = self.parse_expr()
+        return Node('param', name=name, ty=ty, value=val, local=local, line=line)
+
+    def parse_module_item(self):
+        c = self.cur
+        line = c.line
+        if c.v in ('parameter', 'localparam'):
+            local = c.v == 'localparam'
+            self.i += 1
+            out = [self.parse_param_decl_one(local)]
+            while self.accept(','):
+                ty = out[-1].ty
+                nm = self.ident()
+                self.expect('=')
+                out.append(Node('param', name=nm, ty=ty, value=self.parse_expr(), local=local, line=line))
+            self.expect(';')
+            return out
+        if c.v == 'assign':
+            self.i += 1
+            out = []
+            while True:
+                lhs = self.parse_postfix()
+                self.expect('=')
+                rhs = self.parse_expr()
+                out.append(Node('cassign', lhs=lhs, rhs=rhs, line=line))
+                if not self.accept(','):
+                    break
+            self.expect(';')
+            return out
+        if c.v in ('always', 'always_ff', 'always_comb', 'always_latch', 'initial', 'final'):
+            self.i += 1
+            stmt = self.parse_stmt()
+            return [Node('proc', pk=c.v, stmt=stmt, line=line)]
+        if c.v in ('task', 'function'):
+            return [self.parse_subroutine()]
+        if c.v in ('input', 'output'):
+            self.err('non-ANSI port declarations not supported')
+        if c.v == 'genvar':
+            self.err('generate not supported')
+        if c.k == 'id' and (c.v in TYPE_KW or c.v in ('signed', 'unsigned')):
+            return self.parse_decl(True)
+        if c.k == 'id' and self.peek().k == 'id' or (c.k == 'id' and self.peek().v == '#'):
+            return [self.parse_instance()]
+        self.err('unexpected module item')
+
+    def parse_decl(self, module_level):
+        line = self.cur.line
+        ty = self.parse_type()
+        out = []
+        while True:
+            name = self.ident()
+            udims = self.parse_dims()
+            init = None
+            if self.accept('='):
+                init = self.parse_expr()
+            out.append(Node('decl', ty=ty, name=name, udims=udims, init=init, line=line))
+            if not self.accept(','):
+                break
+        self.expect(';')
+        return out
+
+    def parse_instance(self):
+        line = self.cur.line
+        mod = self.ident()
+        params = {}
+        if self.accept('#'):
+            self.expect('(')
+            while not self.at(')'):
+                self.expect('.')
+                pn = self.ident()
+                self.expect('(')
+                params[pn] = self.parse_expr()
+                self.expect(')')
+                if not self.accept(','):
+                    break
+            self.expect(')')
+        iname = self.ident()
+        self.expect('(')
+        conns = {}
+        while not self.at(')'):
+            self.expect('.')
+            pn = self.ident()
+            self.expect('(')
+            conns[pn] = None if self.at(')') else self.parse_expr()
+            self.expect(')')
+            if not self.accept(','):
+                break
+        self.expect(')')
+        self.expect(';')
+        return Node('inst', mod=mod, params=params, name=iname, conns=conns, line=line)
+
+    def parse_subroutine(self):
+        line = self.cur.line
+        kind = self.cur.v
+        self.i += 1
+        self.accept('automatic')
+        self.accept('static')
+        rty = None
+        if kind == 'function':
+            if self.at('void'):
+                self.i += 1
+                rty = 'void'
+            else:
+                rty = self.parse_type()
+                if rty is None:
+                    rty = {'base': None, 'signed': None, 'dims': []}
+        name = self.ident()
+        args = []
+        if self.accept('('):
+            last = None
+            while not self.at(')'):
+                d = None
+                if self.cur.v in ('input', 'output', 'inout', 'ref'):
+                    d = self.cur.v
+                    self.i += 1
+                ty = self.parse_type()
+                an = self.ident()
+                if d is None:
+                    d = last['dir'] if last else 'input'
+                    if ty is None and last:
+                        ty = last['ty']
+                if ty is None:
+                    ty = {'base': None, 'signed': None, 'dims': []}
+                last = {'dir': d, 'ty': ty, 'name': an}
+                args.append(last)
+                if not self.accept(','):
+                    break
+            self.expect(')')
+        self.expect(';')
+        end = 'end' + kind
+        decls = []
+        stmts = []
+        while not self.at(end):
+            if self.cur.k == 'id' and self.cur.v in ('input', 'output'):
+                d = self.cur.v
+                self.i += 1
+                ty = self.parse_type() or {'base': None, 'signed': None, 'dims': []}
+                while True:
+                    args.append({'dir': d, 'ty': ty, 'name': self.ident()})
+                    if not self.accept(','):
+                        break
+                self.expect(';')
+            elif self.is_decl_start():
+                decls.extend(self.parse_decl(False))
+            else:
+                stmts.append(self.parse_stmt())
+        self.expect(end)
+        return Node(kind, name=name, rty=rty, args=args, decls=decls,
+                    body=Node('block', decls=[], stmts=stmts, line=line), line=line)
+
+    def is_decl_start(self):
+        c = self.cur
+        return c.k == 'id' and c.v in TYPE_KW and c.v not in ('event',)
+
+    # -- statements
+    def parse_stmt(self):
+        c = self.cur
+        line = c.line
+        if c.v == ';' and c.k == 'op':
+            self.i += 1
+            return Node('null', line=line)
+        if c.k == 'id':
+            v = c.v
+            if v == 'begin':
+                self.i += 1
+                if self.accept(':'):
+                    self.ident()
+                decls = []
+                stmts = []
+                while not self.at('end'):
+                    if self.is_decl_start():
+                        decls.extend(self.parse_decl(False))
+                    else:
+                        stmts.append(self.parse_stmt())
+                self.expect('end')
+                if self.accept(':'):
+                    self.ident()
+                return Node('block', decls=decls, stmts=stmts, line=line)
+            if v in ('unique', 'priority', 'unique0'):
+                self.i += 1
+                return self.parse_stmt()
+            if v == 'if':
+                self.i += 1
+                self.expect('(')
+                cond = self.parse_expr()
+                self.expect(')')
+                then = self.parse_stmt()
+                els = None
+                if self.accept('else'):
+                    els = self.parse_stmt()
+                return Node('if', cond=cond, then=then, els=els, line=line)
+            if v in ('case', 'casez', 'casex'):
+                self.i += 1
+                self.expect('(')
+                sel = self.parse_expr()
+                self.expect(')')
+                items = []
+                while not self.at('endcase'):
+                    if self.accept('default'):
+                        self.accept(':')
+                        items.append((None, self.parse_stmt()))
+                    else:
+                        labels = [self.parse_expr()]
+                        while self.accept(','):
+                            labels.append(self.parse_expr())
+                        self.expect(':')
+                        items.append((labels, self.parse_stmt()))
+                self.expect('endcase')
+                return Node('case', ck=v, sel=sel, items=items, line=line)
+            if v == 'for':
+                self.i += 1
+                self.expect('(')
+                init = []
+                if self.is_decl_start():
+                    ty = self.parse_type()
+                    nm = self.ident()
+                    self.expect('=')
+                    init.append(Node('decl', ty=ty, name=nm, udims=[], init=self.parse_expr(), line=line))
+                    self.expect(';')
+                else:
+                    init.append(self.parse_simple_assign())
+                    self.expect(';')
+                cond = self.parse_expr()
+                self.expect(';')
+                step = self.parse_simple_assign()
+                self.expect(')')
+                body = self.parse_stmt()
+                return Node('for', init=init, cond=cond, step=step, body=body, line=line)
+            if v == 'while':
+                self.i += 1
+                self.expect('(')
+                cond = self.parse_expr()
+                self.expect(')')
+                return Node('while', cond=cond, body=self.parse_stmt(), line=line)
+            if v == 'do':
+                self.i += 1
+                body = self.parse_stmt()
+                self.expect('while')
+                self.expect('(')
+                cond = self.parse_expr()
+                self.expect(')')
+                self.expect(';')
+                return Node('dowhile', cond=cond, body=body, line=line)
+            if v == 'repeat':
+                self.i += 1
+                self.expect('(')
+                n = self.parse_expr()
+                self.expect(')')
+                return Node('repeat', n=n, body=self.parse_stmt(), line=line)
+            if v == 'forever':
+                self.i += 1
+                return Node('forever', body=self.parse_stmt(), line=line)
+            if v == 'wait':
+                self.i += 1
+                self.expect('(')
+                cond = self.parse_expr()
+                self.expect(')')
+                return Node('wait', cond=cond, stmt=self.parse_stmt(), line=line)
+            if v == 'return':
+                self.i += 1
+                e = None if self.at(';') else self.parse_expr()
+                self.expect(';')
+                return Node('return', expr=e, line=line)
+            if v in ('break', 'continue'):
+                self.i += 1
+                self.expect(';')
+                return Node(v, line=line)
+        if c.v == '@':
+            self.i += 1
+            events = self.parse_event_list()
+            return Node('evctl', events=events, stmt=self.parse_stmt(), line=line)
+        if c.v == '#':
+            self.i += 1
+            d = self.parse_delay_value()
+            return Node('delay', amount=d, stmt=self.parse_stmt(), line=line)
+        if c.k == 'sysid':
+            name = c.v
+            self.i += 1
+            args = []
+            if self.accept('('):
+                while not self.at(')'):
+                    args.append(self.parse_expr())
+                    if not self.accept(','):
+                        break
+                self.expect(')')
+            self.expect(';')
+            return Node('systask', name=name, args=args, line=line)
+        s = self.parse_simple_assign(allow_call=True)
+        self.expect(';')
+        return s
+
+    def parse_delay_value(self):
+        c = self.cur
+        if c.k == 'time':
+            self.i += 1
+            m = re.match(r'([\d_.]+)(\w+)', c.v)
+            mult = {'fs': 1e-3, 'ps': 1, 'ns': 1000, 'us': 1000000, 'ms': 1000000000, 's': 1000000000000}[m.group(2)]
+            return Node('num', val=int(float(m.group(1).replace('_', '')) * mult), w=None, s=True, fill=None,
+                        ps=True, line=c.line)
+        if c.k in ('dec', 'real'):
+            self.i += 1
+            return Node('num', val=int(float(c.v.replace('_', '')) * 1000), w=None, s=True, fill=None, ps=True,
+                        line=c.line)
+        if self.accept('('):
+            e = self.parse_expr()
+            self.expect(')')
+            return Node('delayexpr', expr=e, line=c.line)
+        return Node('delayexpr', expr=self.parse_primary(), line=c.line)
+
+    def parse_event_list(self):
+        events = []
+        if self.accept('*'):
+            return '*'
+        self.expect('(')
+        if self.accept('*'):
+            self.expect(')')
+            return '*'
+        while True:
+            edge = 'any'
+            if self.at('posedge') or self.at('negedge'):
+                edge = self.cur.v
+                self.i += 1
+            events.append((edge, self.parse_expr()))
+            if not (self.accept('or') or self.accept(',')):
+                break
+        self.expect(')')
+        return events
+
+    def parse_simple_assign(self, allow_call=False):
+        line = self.cur.line
+        lhs = self.parse_postfix()
+        c = self.cur
+        if c.k == 'op':
+            if c.v in ('=', '<='):
+                self.i += 1
+                if self.at('#') or self.at('@'):
+                    self.err('intra-assignment timing not supported')
+                return Node('assign', lhs=lhs, rhs=self.parse_expr(), nb=(c.v == '<='), line=line)
+            if c.v in ('+=', '-=', '*=', '|=', '&=', '^=', '<<=', '>>='):
+                self.i += 1
+                rhs = self.parse_expr()
+                return Node('assign', lhs=lhs, rhs=Node('bin', op=c.v[:-1], a=lhs, b=rhs, line=line), nb=False,
+                            line=line)
+            if c.v in ('++', '--'):
+                self.i += 1
+                one = Node('num', val=1, w=None, s=True, fill=None, line=line)
+                return Node('assign', lhs=lhs, rhs=Node('bin', op=c.v[0], a=lhs, b=one, line=line), nb=False,
+                            line=line)
+        if allow_call:
+            if lhs.kind == 'call':
+                return Node('taskcall', name=lhs.name, args=lhs.args, line=line)
+            if lhs.kind == 'id':
+                return Node('taskcall', name=lhs.name, args=[], line=line)
+        self.err('expected assignment')
+
+    # -- expressions
+    BIN_PREC = [
+        ['||'], ['&&'], ['|'], ['^', '~^', '^~'], ['&'], ['==', '!=', '===', '!=='],
+        ['<', '<=', '>', '>='], ['<<', '>>', '<<<', '>>>'], ['+', '-'], ['*', '/', '%'], ['**'],
+    ]
+
+    def parse_expr(self):
+        line = self.cur.line
+        c = self.parse_binary(0)
+        if self.accept('?'):
+            a = self.parse_expr()
+            self.expect(':')
+            b = self.parse_expr()
+            return Node('cond', c=c, a=a, b=b, line=line)
+        return c
+
+    def parse_binary(self, level):
+        if level == len(self.BIN_PREC):
+            return self.parse_unary()
+        line = self.cur.line
+        lhs = self.parse_binary(level + 1)
+        ops = self.BIN_PREC[level]
+        while self.cur.k == 'op' and self.cur.v in ops:
+            op = self.cur.v
+            self.i += 1
+            rhs = self.parse_binary(level + 1)
+            lhs = Node('bin', op=op, a=lhs, b=rhs, line=line)
+        return lhs
+
+    def parse_unary(self):
+        c = self.cur
+        if c.k == 'op' and c.v in ('!', '~', '-', '+', '&', '|', '^', '~&', '~|', '~^', '^~'):
+            self.i += 1
+            return Node('un', op=c.v, a=self.parse_unary(), line=c.line)
+        return self.parse_postfix()
+
+    def parse_postfix(self):
+        e = self.parse_primary()
+        while self.at('['):
+            line = self.cur.line
+            self.i += 1
+            a = self.parse_expr()
+            if self.accept(':'):
+                b = self.parse_expr()
+                self.expect(']')
+                e = Node('range', base=e, msb=a, lsb=b, line=line)
+            elif self.at('+:') or self.at('-:'):
+                d = self.cur.v
+                self.i += 1
+                b = self.parse_expr()
+                self.expect(']')
+                e = Node('ipart', base=e, start=a, width=b, dir=d, line=line)
+            else:
+                self.expect(']')
+                e = Node('index', base=e, idx=a, line=line)
+        return e
+
+    def parse_primary(self):
+        c = self.cur
+        line = c.line
+        if c.k in ('based', 'unbased', 'dec'):
+            self.i += 1
+            val, w, s, fill = parse_number(c.v)
+            return Node('num', val=val, w=w, s=s, fill=fill, line=line)
+        if c.k == 'str':
+            self.i += 1
+            return Node('str', val=bytes(c.v[1:-1], 'utf-8').decode('unicode_escape'), line=line)
+        if c.k == 'sysid':
+            self.i += 1
+            args = []
+            if self.accept('('):
+                while not self.at(')'):
+                    args.append(self.parse_expr())
+                    if not self.accept(','):
+                        break
+                self.expect(')')
+            return Node('syscall', name=c.v, args=args, line=line)
+        if c.k == 'id':
+            self.i += 1
+            if c.v in ('int', 'signed', 'unsigned') and self.at("'"):
+                self.i += 1
+                self.expect('(')
+                e = self.parse_expr()
+                self.expect(')')
+                return Node('cast', to=c.v, a=e, line=line)
+            if self.at('('):
+                self.i += 1
+                args = []
+                while not self.at(')'):
+                    args.append(self.parse_expr())
+                    if not self.accept(','):
+                        break
+                self.expect(')')
+                return Node('call', name=c.v, args=args, line=line)
+            name = c.v
+            if self.at('.') and self.peek().k == 'id':
+                parts = [name]
+                while self.at('.') and self.peek().k == 'id':
+                    self.i += 1
+                    parts.append(self.ident())
+                return Node('hier', parts=parts, line=line)
+            return Node('id', name=name, line=line)
+        if c.v == '(':
+            self.i += 1
+            e = self.parse_expr()
+            self.expect(')')
+            return e
+        if c.v == '{':
+            self.i += 1
+            first = self.parse_expr()
+            if self.at('{'):
+                self.i += 1
+                parts = [self.parse_expr()]
+                while self.accept(','):
+                    parts.append(self.parse_expr())
+                self.expect('}')
+                self.expect('}')
+                return Node('repl', n=first, parts=parts, line=line)
+            parts = [first]
+            while self.accept(','):
+                parts.append(self.parse_expr())
+            self.expect('}')
+            return Node('concat', parts=parts, line=line)
+        self.err('expected expression')
+
+
+def parse_files(paths, incdirs):
+    mods = {}
+    for p in paths:
+        text = preprocess(p, incdirs)
+        for m in Parser(lex(text, p)).parse_file():
+            mods[m.name] = m
+    return mods
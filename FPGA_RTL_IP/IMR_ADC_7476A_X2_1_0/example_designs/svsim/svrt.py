@@ -0,0 +1,359 @@
+"""Event driven runtime: 2-state values (like Verilator), active / NBA regions, delta cycles."""
+import heapq
+import random
+from collections import deque
+
+
+class Finish(Exception):
+    pass
+
+
+class Sig:
+    __slots__ = ('v', 'name', 'w', 'comb', 'edge', 'wait', 'arr', 'lo')
+
+    def __init__(self, name, w, arr=None, lo=0):
+        self.name = name
+        self.w = w
+        self.arr = arr
+        self.lo = lo
+        self.v = [0] * arr if arr is not None else 0
+        self.comb = []
+        self.edge = []
+        self.wait = []
+
+    def __repr__(self):
+        return 'Sig(%s)' % self.name
+
+
+class Proc:
+    __slots__ = ('fn', 'kind', 'sched', 'gen', 'name', 'tok', 'done')
+
+    def __init__(self, fn, kind, name):
+        self.fn = fn
+        self.kind = kind      # 0 comb, 1 edge, 2 gen
+        self.sched = False
+        self.gen = None
+        self.name = name
+        self.tok = 0
+        self.done = False
+
+
+def make_runtime(seed=1):
+    G = {}
+    ACTIVE = deque()
+    NBA = []
+    TQ = []
+    state = {'now': 0, 'seq': 0, 'defer': None, 'out': []}
+    rng = random.Random(seed)
+
+    def _notify(s, o, v):
+        for p in s.comb:
+            if not p.sched:
+                p.sched = True
+                ACTIVE.append(p)
+        if s.edge:
+            po = o & 1 if o is not None else 2
+            pv = v & 1 if v is not None else 2
+            pos = (po == 0 and pv == 1)
+            neg = (po == 1 and pv == 0)
+            for p, k in s.edge:
+                if (k == 0 or (k == 1 and pos) or (k == 2 and neg)) and not p.sched:
+                    p.sched = True
+                    ACTIVE.append(p)
+        if s.wait:
+            lst = s.wait
+            s.wait = []
+            po = o & 1 if o is not None else 2
+            pv = v & 1 if v is not None else 2
+            pos = (po == 0 and pv == 1)
+            neg = (po == 1 and pv == 0)
+            for e in lst:
+                p, k, tok = e
+                if tok != p.tok:
+                    continue
+                if k == 0 or (k == 1 and pos) or (k == 2 and neg):
+                    p.tok += 1
+                    if not p.sched:
+                        p.sched = True
+                        ACTIVE.append(p)
+                else:
+                    s.wait.append(e)
+
+    def _set(s, v):
+        o = s.v
+        if o != v:
+            s.v = v
+            d = state['defer']
+            if d is not None:
+                if s not in d:
+                    d[s] = o
+            else:
+                _notify(s, o, v)
+
+    def _setb(s, off, w, v):
+        if off < 0 or off >= s.w:
+            return
+        m = ((1 << w) - 1) << off
+        _set(s, ((s.v & ~m) | ((v << off) & m)) & ((1 << s.w) - 1))
+
+    def _seta(s, i, v):
+        if 0 <= i < s.arr and s.v[i] != v:
+            s.v[i] = v
+            d = state['defer']
+            if d is not None:
+                if s not in d:
+                    d[s] = None
+            else:
+                _notify(s, None, None)
+
+    def _setab(s, i, off, w, v):
+        if 0 <= i < s.arr and 0 <= off < s.w:
+            m = ((1 << w) - 1) << off
+            _seta(s, i, (s.v[i] & ~m) | ((v << off) & m))
+
+    def _nb(s, v):
+        NBA.append((0, s, v, 0, 0))
+
+    def _nbb(s, off, w, v):
+        NBA.append((1, s, v, off, w))
+
+    def _nba(s, i, v):
+        NBA.append((2, s, v, i, 0))
+
+    def _nbab(s, i, off, w, v):
+        NBA.append((3, s, v, i, (off, w)))
+
+    def _sx(v, w):
+        return v - (1 << w) if (v >> (w - 1)) & 1 else v
+
+    def _sxw(v, w, W):
+        if (v >> (w - 1)) & 1:
+            return (v - (1 << w)) & ((1 << W) - 1)
+        return v
+
+    def _bit(v, i, w):
+        return (v >> i) & 1 if 0 <= i < w else 0
+
+    def _part(v, i, w, m):
+        return (v >> i) & m if i >= 0 else (v << -i) & m
+
+    def _ag(a, i):
+        return a[i] if 0 <= i < len(a) else 0
+
+    def _shl(a, b, M, W):
+        return (a << b) & M if b < W else 0
+
+    def _div(a, b, M):
+        return (a // b) & M if b else 0
+
+    def _mod(a, b, M):
+        return (a % b) & M if b else 0
+
+    def _sdiv(a, b, W):
+        a = _sx(a, W)
+        b = _sx(b, W)
+        if b == 0:
+            return 0
+        q = abs(a) // abs(b)
+        if (a < 0) != (b < 0):
+            q = -q
+        return q & ((1 << W) - 1)
+
+    def _smod(a, b, W):
+        a = _sx(a, W)
+        b = _sx(b, W)
+        if b == 0:
+            return 0
+        r = abs(a) % abs(b)
+        if a < 0:
+            r = -r
+        return r & ((1 << W) - 1)
+
+    def _repl(v, w, n):
+        r = 0
+        for _ in range(n):
+            r = (r << w) | v
+        return r
+
+    def _urr(a, b=0):
+        lo, hi = (a, b) if a <= b else (b, a)
+        return rng.randint(lo, hi)
+
+    def _urand():
+        return rng.getrandbits(32)
+
+    def _fmt(fmt, args):
+        out = []
+        ai = 0
+        i = 0
+        n = len(fmt)
+        while i < n:
+            c = fmt[i]
+            if c != '%':
+                out.append(c)
+                i += 1
+                continue
+            j = i + 1
+            while j < n and (fmt[j].isdigit() or fmt[j] in '.-'):
+                j += 1
+            spec = fmt[i + 1:j]
+            conv = fmt[j] if j < n else ''
+            i = j + 1
+            if conv == '%':
+                out.append('%')
+                continue
+            if conv == 'm':
+                out.append('tb')
+                continue
+            if ai >= len(args):
+                out.append('<missing>')
+                continue
+            v, w, s = args[ai]
+            ai += 1
+            cl = conv.lower()
+            if isinstance(v, str):
+                out.append(v if spec in ('', '0') else v.rjust(int(spec.lstrip('-0') or 0)))
+                continue
+            if cl == 'd':
+                val = _sx(v, w) if s else v
+                txt = str(val)
+                if spec == '':
+                    txt = txt.rjust(len(str((1 << w) - 1)) + (1 if s else 0))
+                elif spec != '0':
+                    txt = txt.rjust(int(spec), '0' if spec.startswith('0') else ' ')
+                out.append(txt)
+            elif cl in ('h', 'x'):
+                txt = '%x' % v
+                if spec == '':
+                    txt = txt.rjust((w + 3) // 4, '0')
+                elif spec != '0':
+                    txt = txt.rjust(int(spec), '0' if spec.startswith('0') else ' ')
+                out.append(txt)
+            elif cl == 'b':
+                txt = bin(v)[2:]
+                if spec == '':
+                    txt = txt.rjust(w, '0')
+                out.append(txt)
+            elif cl == 'o':
+                out.append('%o' % v)
+            elif cl == 't':
+                out.append(str(state['now'] // 1000).rjust(0 if spec == '0' else 20))
+            elif cl == 's':
+                bs = []
+                while v:
+                    bs.append(chr(v & 0xFF))
+                    v >>= 8
+                out.append(''.join(reversed(bs)))
+            elif cl == 'c':
+                out.append(chr(v & 0xFF))
+            elif cl == 'f' or cl == 'g' or cl == 'e':
+                out.append(('%' + spec + cl) % v)
+            else:
+                out.append('%' + spec + conv)
+        # leftover args
+        while ai < len(args):
+            v, w, s = args[ai]
+            ai += 1
+            out.append(v if isinstance(v, str) else str(_sx(v, w) if s else v))
+        return ''.join(out)
+
+    def _display(args, nl=True):
+        txt = _fmtargs(args)
+        print(txt, end='\n' if nl else '', flush=True)
+        state['out'].append(txt)
+
+    def _fmtargs(args):
+        if args and isinstance(args[0][0], str):
+            return _fmt(args[0][0], list(args[1:]))
+        return _fmt('', list(args))
+
+    def _finish():
+        raise Finish()
+
+    def _time():
+        return state['now'] // 1000
+
+    G.update(dict(_set=_set, _setb=_setb, _seta=_seta, _setab=_setab, _nb=_nb, _nbb=_nbb, _nba=_nba, _nbab=_nbab,
+                  _sx=_sx, _sxw=_sxw, _bit=_bit, _part=_part, _ag=_ag, _shl=_shl, _div=_div, _mod=_mod,
+                  _sdiv=_sdiv, _smod=_smod, _repl=_repl, _urr=_urr, _urand=_urand, _fmt=_fmt, _fmtargs=_fmtargs,
+                  _display=_display, _finish=_finish, _time=_time, Finish=Finish))
+
+    def apply_nba():
+        q = NBA.copy()
+        NBA.clear()
+        for k, s, v, a, b in q:
+            if k == 0:
+                _set(s, v)
+            elif k == 1:
+                _setb(s, a, b, v)
+            elif k == 2:
+                _seta(s, a, v)
+            else:
+                _setab(s, a, b[0], b[1], v)
+
+    def run_proc(p):
+        k = p.kind
+        if k == 1:
+            p.fn()
+        elif k == 0:
+            d = state['defer'] = {}
+            p.fn()
+            state['defer'] = None
+            p.sched = True
+            for s, o in d.items():
+                if s.arr is not None:
+                    _notify(s, None, None)
+                elif s.v != o:
+                    _notify(s, o, s.v)
+            p.sched = False
+        else:
+            if p.done:
+                return
+            if p.gen is None:
+                p.gen = p.fn()
+            try:
+                req = p.gen.send(None)
+            except StopIteration:
+                p.done = True
+                return
+            if req[0] == 1:
+                if req[1] <= 0:
+                    p.sched = True
+                    ACTIVE.append(p)
+                else:
+                    state['seq'] += 1
+                    heapq.heappush(TQ, (state['now'] + req[1], state['seq'], p))
+            else:
+                p.tok += 1
+                tok = p.tok
+                for s, kk in req[1]:
+                    s.wait.append((p, kk, tok))
+
+    def run(procs, max_ps=None):
+        for p in procs:
+            p.sched = True
+            ACTIVE.append(p)
+        try:
+            while True:
+                while ACTIVE or NBA:
+                    while ACTIVE:
+                        p = ACTIVE.popleft()
+                        p.sched = False
+                        run_proc(p)
+                    if NBA:
+                        apply_nba()
+                if not TQ:
+                    return 'idle'
+                t = TQ[0][0]
+                if max_ps is not None and t > max_ps:
+                    return 'timeout'
+                state['now'] = t
+                while TQ and TQ[0][0] == t:
+                    _, _, p = heapq.heappop(TQ)
+                    if not p.sched:
+                        p.sched = True
+                        ACTIVE.append(p)
+        except Finish:
+            return 'finish'
+
+    return G, state, run
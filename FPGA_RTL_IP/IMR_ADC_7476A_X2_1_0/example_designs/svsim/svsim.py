@@ -0,0 +1,73 @@
+"""svsim: run a SystemVerilog testbench on the local 2-state interpreter.
+usage: svsim.py [-I dir]... [-D NAME[=V]]... [--top T] [--seed N] [--max-ns N] [--dump-py f] files..."""
+import sys
+import time
+import argparse
+from svparse import parse_files, SvError
+from svrt import make_runtime
+from svelab import Elab, putb
+
+
+def main(argv):
+    ap = argparse.ArgumentParser()
+    ap.add_argument('-I', action='append', default=[])
+    ap.add_argument('-D', action='append', default=[])
+    ap.add_argument('--top')
+    ap.add_argument('--seed', type=int, default=1)
+    ap.add_argument('--max-ns', type=int, default=None)
+    ap.add_argument('--dump-py')
+    ap.add_argument('--lint', action='store_true')
+    ap.add_argument('files', nargs='+')
+    a = ap.parse_args(argv)
+    vlts = [f for f in a.files if f.endswith('.vlt')]
+    a.files = [f for f in a.files if not f.endswith('.vlt')]
+    t0 = time.time()
+    try:
+        defs = {}
+        for d in a.D:
+            k, _, v = d.partition('=')
+            defs[k] = v or '1'
+        try:
+            mods = parse_files(a.files, a.I, defs)
+        except TypeError:
+            mods = parse_files(a.files, a.I)
+        top = a.top or list(mods)[-1]
+        G, state, run = make_runtime(a.seed)
+        G['_putb'] = putb
+        el = Elab(mods, G)
+        el.elab_module(top, {}, top, None)
+        start = el.build()
+    except SvError as e:
+        print('svsim: error: %s' % e, file=sys.stderr)
+        return 2
+    finally:
+        if a.dump_py:
+            try:
+                open(a.dump_py, 'w').write('\n'.join(el.src))
+            except Exception:
+                pass
+    if a.lint:
+        from svlint import Lint
+        ws = Lint(el).run()
+        if vlts:
+            from svlint import load_vlt, waived
+            rules = []
+            for v in vlts:
+                rules += load_vlt(v)
+            nw = len(ws)
+            ws = [w for w in ws if not waived(rules, w)]
+            print('svsim: %d warnings waived by %s' % (nw - len(ws), ' '.join(vlts)), file=sys.stderr)
+        for code, f, line, msg in ws:
+            print('%%Warning-%s: %s:%d: %s' % (code, f, line, msg))
+        print('svsim: lint %d warnings' % len(ws), file=sys.stderr)
+        return 1 if ws else 0
+    t1 = time.time()
+    res = run(start, None if a.max_ns is None else a.max_ns * 1000)
+    t2 = time.time()
+    print('svsim: %s at %d ns (elab %.1fs, run %.1fs, %d signals, %d processes)' %
+          (res, state['now'] // 1000, t1 - t0, t2 - t1, len(el.sigs), len(el.procs)), file=sys.stderr)
+    return 0 if res == 'finish' else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -4,14 +4,15 @@
 	module IMR_ADC_7476A_X2 #
 	(
 		// Users to add parameters here
-
+		// Width of the DMA writer M00_AXI address bus
+		parameter integer C_M00_AXI_ADDR_WIDTH	= 32,
 		// User parameters ends
 		// Do not modify the parameters beyond this line
 
 
 		// Parameters of Axi Slave Bus Interface S00_AXI
 		parameter integer C_S00_AXI_DATA_WIDTH	= 32,
-		parameter integer C_S00_AXI_ADDR_WIDTH	= 5
+		parameter integer C_S00_AXI_ADDR_WIDTH	= 7
 	)
 	(
 		// Users to add ports here
@@ -21,6 +22,24 @@
         input  wire ADC_MISO_A,
         input  wire ADC_MISO_B,
 		output wire IRQ,
+		// DMA writer - AXI4 master, write channels only
+		output wire [C_M00_AXI_ADDR_WIDTH-1 : 0] m00_axi_awaddr,
+		output wire [7 : 0] m00_axi_awlen,
+		output wire [2 : 0] m00_axi_awsize,
+		output wire [1 : 0] m00_axi_awburst,
+		output wire  m00_axi_awlock,
+		output wire [3 : 0] m00_axi_awcache,
+		output wire [2 : 0] m00_axi_awprot,
+		output wire  m00_axi_awvalid,
+		input  wire  m00_axi_awready,
+		output wire [31 : 0] m00_axi_wdata,
+		output wire [3 : 0] m00_axi_wstrb,
+		output wire  m00_axi_wlast,
+		output wire  m00_axi_wvalid,
+		input  wire  m00_axi_wready,
+		input  wire [1 : 0] m00_axi_bresp,
+		input  wire  m00_axi_bvalid,
+		output wire  m00_axi_bready,
 		// User ports ends
 		// Do not modify the ports beyond this line
 
@@ -51,7 +70,8 @@
 // Instantiation of Axi Bus Interface S00_AXI
 	IMR_ADC_7476A_X2_slave_lite_v1_0_S00_AXI # ( 
 		.C_S_AXI_DATA_WIDTH(C_S00_AXI_DATA_WIDTH),
-		.C_S_AXI_ADDR_WIDTH(C_S00_AXI_ADDR_WIDTH)
+		.C_S_AXI_ADDR_WIDTH(C_S00_AXI_ADDR_WIDTH),
+		.C_M_AXI_ADDR_WIDTH(C_M00_AXI_ADDR_WIDTH)
 	) IMR_ADC_7476A_X2_slave_lite_v1_0_S00_AXI_inst (
 		.S_AXI_ACLK(s00_axi_aclk),
 		.S_AXI_ARESETN(s00_axi_aresetn),
@@ -79,8 +99,26 @@
 		.ADC_CS_n(ADC_CS_n),
 		.ADC_MISO_A(ADC_MISO_A),
 		.ADC_MISO_B(ADC_MISO_B),
-		.IRQ(IRQ)
+		.IRQ(IRQ),
 		// ADC user ports end
+		// DMA writer master
+		.M_AXI_AWADDR(m00_axi_awaddr),
+		.M_AXI_AWLEN(m00_axi_awlen),
+		.M_AXI_AWSIZE(m00_axi_awsize),
+		.M_AXI_AWBURST(m00_axi_awburst),
+		.M_AXI_AWLOCK(m00_axi_awlock),
+		.M_AXI_AWCACHE(m00_axi_awcache),
+		.M_AXI_AWPROT(m00_axi_awprot),
+		.M_AXI_AWVALID(m00_axi_awvalid),
+		.M_AXI_AWREADY(m00_axi_awready),
+		.M_AXI_WDATA(m00_axi_wdata),
+		.M_AXI_WSTRB(m00_axi_wstrb),
+		.M_AXI_WLAST(m00_axi_wlast),
+		.M_AXI_WVALID(m00_axi_wvalid),
+		.M_AXI_WREADY(m00_axi_wready),
+		.M_AXI_BRESP(m00_axi_bresp),
+		.M_AXI_BVALID(m00_axi_bvalid),
+		.M_AXI_BREADY(m00_axi_bready)
 	);
 
 	// Add user logic here
@@ -8,6 +8,12 @@
 // Operation Modes:
 //   1. Single Conversion: One complete conversion cycle on both channels
 //   2. Continuous Conversion: Multiple conversions up to specified count
+//   3. Free Running Conversion: Continuous with FREE_RUN set - no count, runs until START or
+//      ChipEnable is cleared.  Intended for the sample FIFO: the driver drains it into a RAM ring
+//   Either mode can deliver to the DATA_A/B registers (one IRQ per conversion) or,
+//   with FIFO_EN set, to the sample FIFO (IRQ at the fill threshold / overflow / tail)
+//   Continuous captures may be decimated by the CIC (CIC_EN) - results are then 16 bit
+//   decimated samples at Fs / R and the counts are in decimated samples
 //
 // Signal Interface:
 //   Clock/Reset:
@@ -19,21 +25,60 @@
 //     * ChipEnable: Global enable for ADC operation
 //     * SingleConversion: Single conversion mode
 //     * ContinuousConversion: Continuous conversion mode
-//     * ClockDivider_N: Sets ADC clock frequency (SCLK = SysClk/(2*(N+1)))
+//     * ClockDivider_N: Sets ADC clock frequency (SCLK = SysClk/(2*N)), N below 3 runs as 3
+//     * ClockOdd: SCLK period 2*N - 1 SysClks, the high phase one SysClk shorter (N = 3: 20 MHz)
 //     * TotalConversions: Number of conversions in continuous mode
+//     * FreeRun: Continuous mode ignores TotalConversions
+//
+//   - Sample_Period_Register: SysClk cycles between conversion starts (0 = back to back)
+//     * Conversion starts (CS_n falling - the AD7476A sample instant) are paced by a period
+//       timer so Fs = SysClk / SamplePeriod exactly, independent of ClockDivider_N and the
+//       FSM overhead
+//     * StatusOverrun: a tick came before the next frame of a continuous capture (counted,
+//       FreeRun or triggered) could start - the frame (SHIFT + QUIET, or a FIFO-off result
+//       held for an IRQ not yet cleared) is longer than the period.  Single conversions and
+//       the frame in flight once START is dropped never overrun
 //
 //   - IRQ_Register: Interrupt control
 //     * IRQ_Enable: Enable interrupt generation
-//     * IRQ_Clear: Clear active interrupt
+//     * IRQ_Clear: Clear active interrupt (one SysClk pulse - the AXI slave self-clears the bit)
+//     * IRQ_AutoAck: A DATA_AB read clears the active interrupt
+//     * IRQ_DoneEnable: Also interrupt when a capture completes (CaptureDone)
 //
 //   Status/Data Interface:
 //   - Status_Register: Operation status and debugging
 //     * StatusBusy: Active conversion in progress
 //     * StatusReady: Data ready for reading
+//     * CaptureDone: The capture has ended and every result is latched (sticky)
 //     * StatusError: Error conditions
 //     * StatusDebug: Debug information
 //   - ADC_Data_A_Register: Channel A conversion result (12-bit)
 //   - ADC_Data_B_Register: Channel B conversion result (12-bit)
+//   - ADC_Data_AB_Register: {Sequence[7:0], A[11:0], B[11:0]} held from one result latch to the next
+//   - DataAB_Read: One SysClk pulse from the AXI read of DATA_AB - acknowledges the IRQ when
+//     IRQ_AutoAck is set, so one read per conversion both fetches the data and re-arms
+//
+//   Sample FIFO Interface:
+//   - FIFO_Ctrl_Register: FifoThreshold, FifoEnable, FifoFlush
+//   - FIFO_Status_Register: FifoCount, threshold / overflow / empty / full / tail flags
+//   - FIFO_Data_Register: Oldest sample {8'h00, A[11:0], B[11:0]}
+//   - FIFO_Pop: One SysClk pulse from the AXI read of FIFO_DATA - FIFO_Data_Register
+//     holds the popped sample from the next clock until the next pop
+//   - FIFO_DMA_Pop: Same, from the DMA writer (IMR_ADC_7476A_X2_DMA_Writer)
+//   - DMA_Enable: The DMA writer owns the FIFO read port and flushes the tail - no tail IRQ
+//   - FIFO_DMA_Hold: Trigger engine armed / storing - the DMA writer must leave the FIFO alone
+//     until the record is complete (the slave shows it a count of 0)
+//
+//   Trigger Interface (TRIG_EN with FIFO_EN - signal mode captures that start on an event):
+//   - Trig_Ctrl_Register: TrigEnable, TrigArm / TrigForce (write 1 pulses), TrigSourceB, TrigMode
+//   - Trig_Level_Register: TrigLevel, TrigHysteresis
+//   - Trig_Holdoff_Register: TrigHoldoff - samples after ARM before a trigger is accepted
+//   - Trig_Record_Register: TrigPre, TrigPost - the record is PRE samples before the trigger
+//     sample and POST from it on
+//   - Trig_Status_Register: TrigIndex (trigger sample position in the record), TrigState, TrigDone
+//
+//   CIC Interface:
+//   - Cic_Ctrl_Register: CicEnable (0 = bypass), CicOrder - 1, CicRatio - 1, CicShift
 //
 // ADC Interface:
 //   - MISO_A/B: Serial data input from both ADCs
@@ -44,37 +89,59 @@
 //   1. IDLE: Wait for conversion trigger
 //      → Enters START when ChipEnable and conversion mode active
 //
-//   2. START: Prepare for conversion
-//      → Waits for !IP_IRQ
-//      → Asserts CS_n
-//      → Moves to SHIFT when ready
+//   2. START: Prepare for conversion (CS_n still high)
+//      → Waits for the shift registers - a result held for an IRQ must latch first
+//      → Moves to SHIFT, CS_n falls
 //
 //   3. SHIFT: Data acquisition (16 clock cycles)
 //      → Generate SCLK
 //      → Sample MISO on rising edge
 //      → Shift data into registers
-//      → Move to LATCH after 16 bits
+//      → Move to QUIET on the 16th sample - the frame is now a pending result
 //
-//   4. LATCH: Complete conversion
-//      → Store converted data
-//      → Set StatusReady
-//      → Move to QUIET
+//   4. QUIET: Inter-conversion delay, CS_n high
+//      → Wait QUIET_SYS_CLKS cycles (tQUIET)
+//      → Continuous (count not reached, or free running): straight into SHIFT when the next
+//        frame may start, otherwise NEXT_CONV
+//      → Otherwise IDLE.  Clearing START / ChipEnable ends any mode here after the frame in flight
 //
-//   5. QUIET: Inter-conversion delay
-//      → Wait QUIET_SYS_CLKS cycles
-//      → Deassert CS_n
-//      → Move to NEXT_CONV or IDLE
+//   5. NEXT_CONV: Wait for the next conversion (continuous mode), CS_n high
+//      → SamplePeriod != 0: wait for the period tick - CS_n falls on it
+//      → Wait for the pending result to latch (FIFO disabled, IRQ not yet cleared)
+//      → Move to SHIFT, or IDLE if START / ChipEnable was cleared while waiting
 //
-//   6. NEXT_CONV: Setup next conversion (continuous mode)
-//      → Reset bit counters
-//      → Move to START for next conversion
+//   Result latch (pipelined - no FSM state; STATUS state encoding 3 is unused):
+//      → The frame in the shift registers is copied to DATA_A/B, DATA_AB and the FIFO the
+//        first clock it may be (LatchNow): FIFO enabled at once, FIFO disabled once the
+//        last result is acknowledged (!IP_IRQ)
+//      → This overlaps QUIET and the next frame's CS_n and shift: the shift registers are
+//        only reloaded from the first MISO sample, N + 2 SysClks into SHIFT
+//      → FIFO disabled, software has a whole frame to read the result before the engine
+//        stalls (the next frame completes and waits, CS_n high, for the latch)
 //
 // Timing:
-//   - ADC Clock: Configurable frequency via ClockDivider_N (Cannot exceed 20MHz)
+//   - ADC Clock: Configurable frequency via ClockDivider_N (Cannot exceed 20MHz - N = 0..2
+//     clamps to 3, the odd high phase N - 1 SysClks would otherwise wrap)
 //     * Example frequencies:
-//       N=3: 16.67MHz
-//       N=4: 12.50MHz
+//       N=3: 16.67MHz        N=3 + ClockOdd: 20.00MHz (high 20 ns, low 30 ns)
+//       N=4: 12.50MHz        N=4 + ClockOdd: 14.29MHz
 //       N=5: 10.00MHz
+//     * MISO is sampled two SysClks after the SCLK rising edge - low phase + 20 ns after the
+//       falling edge that launched the bit (>= 50 ns for N >= 3).  Budget from that falling
+//       edge, 3V AD7476A, SCLK pad and trace 6 ns, MISO trace and pad 3 ns (board estimates):
+//         bit valid at 6 + t4 (40 ns max) + 3 = 49 ns - 1 ns setup margin at N = 3
+//         bit held to Tsclk + 6 + t7 (10 ns min) + 3 >= Tsclk + 19 ns - long past the sample
+//       One SysClk earlier (40 ns) falls inside the t7..t4 window; keep ADC_CS_n / ADC_SCLK
+//       in the IOB output registers and MISO in the IOB input register to hold these delays
+//   - Frame (CS_n fall to CS_n fall, back to back with SamplePeriod = 0):
+//       SHIFT = N + 15 * Tsclk + 2, QUIET = QUIET_SYS_CLKS (6) - CS_n high 60 ns >= tQUIET
+//       Tsclk = 2N (2N - 1 with ClockOdd) SysClks
+//       N=3: 101 SysClks  990.1 kSPS    N=3 + ClockOdd:  86 SysClks  1.163 MSPS
+//       N=4: 132 SysClks  757.6 kSPS    N=4 + ClockOdd: 117 SysClks  854.7 kSPS
+//       N=5: 163 SysClks  613.5 kSPS
+//     Was START + SHIFT + LATCH + QUIET + NEXT_CONV = 31N + 10 (N=3: 970.9 kSPS, N=4: 746.3 kSPS)
+//     The AD7476A is rated to 1 MSPS: with ClockOdd pace at SamplePeriod >= 100 (the driver
+//     enforces it)
 //
 // Interrupt Handling:
 //   - IP_IRQ asserted when:
@@ -82,7 +149,54 @@
 //     * IRQ_Enable is active
 //   - Cleared by:
 //     * IRQ_Clear signal
+//     * DATA_AB read with IRQ_AutoAck set
 //     * Reset
+//   - With FIFO_EN set, IP_IRQ is instead asserted while IRQ_Enable is active and:
+//     * FifoCount >= FifoThreshold (threshold 0 = never), or
+//     * A sample was dropped to a full FIFO (FifoOverflow, cleared by IRQ_Clear or flush), or
+//     * The FSM is idle with samples left (tail of a capture that ended below threshold)
+//     Draining the FIFO below threshold drops IP_IRQ - the interrupt controller sees a new
+//     edge on the next crossing, so the drain must continue until FifoCount reads 0
+//   - With IRQ_DoneEnable set, IP_IRQ is also asserted by CaptureDone in every mode:
+//     * Set when the engine falls idle - BUSY (FSM, a pending result or the CIC comb) drops
+//     * Cleared by IRQ_Clear or the start of the next capture
+//     The end of a capture then interrupts even with the FIFO empty (samples lost to overflow)
+//     and software needs no count or BUSY poll to find it
+//
+// Sample FIFO:
+//   - 1024 x 32 block RAM written on the result latch, one word per conversion, both channels packed
+//   - Full FIFO drops the new sample and sets FifoOverflow - conversions never stall
+//
+// Trigger Engine (TrigEnable with FifoEnable):
+//   - ARM flushes the FIFO and starts storing: until the trigger the FIFO is a pre-trigger ring -
+//     at TrigPre samples each new sample drops the oldest, so it never fills or interrupts
+//   - Triggers are ignored for max(TrigHoldoff, TrigPre) samples after ARM so the pre-trigger
+//     part of the record is full, then each latched sample of the source channel is compared:
+//       ABOVE: sample >= TrigLevel          BELOW: sample <= TrigLevel
+//       RISING: sample >= TrigLevel once the signal has been below TrigLevel - TrigHysteresis
+//       FALLING: sample <= TrigLevel once the signal has been above TrigLevel + TrigHysteresis
+//     The hysteresis band is tracked through the holdoff, so noise on a slow edge cannot re-fire
+//   - FORCE triggers on the next sample regardless (holdoff included)
+//   - The trigger sample and the TrigPost - 1 after it are stored, then TrigDone is set and the
+//     capture ends after that frame (as if START was cleared) - nothing more is stored
+//   - IP_IRQ is TrigDone (or FIFO overflow - PRE + POST larger than the FIFO): one interrupt per
+//     complete record.  With DMA_Enable the record is written to the ring after TrigDone and the
+//     DMA DONE interrupt reports it instead
+//
+// CIC Decimator (CicEnable, continuous captures - single conversions always bypass):
+//   - Order N (1..4) integrators run on every frame, R (1..256) frames per output, differential
+//     delay 1.  Gain R^N, bit growth N * log2(R): the CIC_WIDTH (44) bit integrators hold the
+//     worst case (4 x 8 + 12) and wrap without loss - the comb differences are exact
+//   - The integrators are pipelined (each stage adds the previous stage's registered value) and the
+//     combs run one stage per SysClk after the R-th frame - the output is pending N + 3 clocks
+//     after FrameDone, about where QUIET ends
+//   - Output = comb >> CicShift saturated to 16 bits (software picks the shift that removes the growth
+//     above 16 bits).  It replaces the raw sample in DATA_A/B, DATA_AB and the FIFO: those words carry
+//     A[15:0] / B[15:0] and DATA_AB has no sequence number.  The trigger compares output [15:4]
+//   - Cleared at the capture start; the first N - 1 outputs (filter still filling) are not delivered
+//   - TotalConversions, ConversionCount and the result latch count decimated outputs - R frames each
+//   - FIFO disabled, a result not yet acknowledged holds the next frame start as before (flagged as
+//     overrun when paced) - the integrators never miss a frame but their input spacing stretches
 //
 // Debug Features:
 //   - StatusDebug register tracks state transitions and conditions
@@ -91,8 +205,9 @@
 //
 // Notes:
 //   - CS_n timing critical for proper ADC operation
-//   - Interrupt must be cleared before starting new conversion
-//   - Supports up to 4096 continuous conversions
+//   - FIFO disabled, a result is only latched once the last IRQ is cleared - one frame may be
+//     converted meanwhile and waits in the shift registers
+//   - Supports up to 4095 counted continuous conversions, unbounded with FreeRun
 //------------------------------------------------------------------------------
 `timescale 1ns/1ps
 `include "IMR_ADC_7476A_X2_Def.vh"
@@ -106,11 +221,14 @@ module IMR_ADC_7476A_X2_Core
   // Control + Interrupt enable from AXI regs (e.g., slv_reg0, slv_reg4)
   input  logic [31:0] Ctrl_Register,
   input  logic [31:0] IRQ_Register,
+  input  logic [31:0] Sample_Period_Register,
 
   // Readback to AXI (STATUS / DATA_A / DATA_B)
   output logic [31:0] Status_Register,
   output logic [31:0] ADC_Data_A_Register,
   output logic [31:0] ADC_Data_B_Register,
+  output logic [31:0] ADC_Data_AB_Register,
+  input  logic        DataAB_Read,
 
   // External ADC pins
   input  logic        MISO_A,
@@ -118,6 +236,25 @@ module IMR_ADC_7476A_X2_Core
   output logic        SCLK,
   output logic        CS_n,
 
+  // Sample FIFO (FIFO_CTRL / FIFO_STATUS / FIFO_DATA)
+  input  logic [31:0] FIFO_Ctrl_Register,
+  output logic [31:0] FIFO_Status_Register,
+  output logic [31:0] FIFO_Data_Register,
+  input  logic        FIFO_Pop,
+  input  logic        FIFO_DMA_Pop,
+  input  logic        DMA_Enable,
+  output logic        FIFO_DMA_Hold,
+
+  // Trigger engine (TRIG_CTRL / TRIG_LEVEL / TRIG_HOLDOFF / TRIG_RECORD / TRIG_STATUS)
+  input  logic [31:0] Trig_Ctrl_Register,
+  input  logic [31:0] Trig_Level_Register,
+  input  logic [31:0] Trig_Holdoff_Register,
+  input  logic [31:0] Trig_Record_Register,
+  output logic [31:0] Trig_Status_Register,
+
+  // CIC decimator (CIC_CTRL)
+  input  logic [31:0] Cic_Ctrl_Register,
+
   // Interrupt to system
   output logic        IP_IRQ
 );
@@ -128,13 +265,27 @@ module IMR_ADC_7476A_X2_Core
   logic ChipEnable;
   logic SingleConversion;
   logic ContinuousConversion;
+  logic FreeRun;
+  logic ClockOdd;
   logic [(`CTRL_CLKDIV_MSB - `CTRL_CLKDIV_LSB):0] ClockDivider_N; 
   logic [(`CTRL_CONT_CNT_MSB - `CTRL_CONT_CNT_LSB):0] TotalConversions; 
   assign ChipEnable           = Ctrl_Register[`CTRL_EN_BIT];
-  assign ClockDivider_N       = Ctrl_Register[`CTRL_CLKDIV_MSB:`CTRL_CLKDIV_LSB];
+  // N below 3 would run SCLK past 20MHz and wrap the odd high phase count (N - 2) - run as 3
+  assign ClockDivider_N       = (Ctrl_Register[`CTRL_CLKDIV_MSB:`CTRL_CLKDIV_LSB] < 3) ? 3 :
+                                Ctrl_Register[`CTRL_CLKDIV_MSB:`CTRL_CLKDIV_LSB];
   assign SingleConversion     = Ctrl_Register[`CTRL_START_BIT] & ~Ctrl_Register[`CTRL_CONT_BIT];
   assign ContinuousConversion = Ctrl_Register[`CTRL_START_BIT] & Ctrl_Register[`CTRL_CONT_BIT];
   assign TotalConversions     = Ctrl_Register[`CTRL_CONT_CNT_MSB:`CTRL_CONT_CNT_LSB];
+  assign FreeRun              = Ctrl_Register[`CTRL_FREE_RUN_BIT];
+  assign ClockOdd             = Ctrl_Register[`CTRL_CLKDIV_ODD_BIT];
+
+  // --------------------------
+  // Sample Period Register extraction
+  // --------------------------
+  logic [(`SAMPLE_PERIOD_MSB - `SAMPLE_PERIOD_LSB):0] SamplePeriod;
+  logic PeriodEnable;
+  assign SamplePeriod = Sample_Period_Register[`SAMPLE_PERIOD_MSB:`SAMPLE_PERIOD_LSB];
+  assign PeriodEnable = (SamplePeriod != '0);
 
   // --------------------------
   // Status Register extraction
@@ -147,8 +298,58 @@ module IMR_ADC_7476A_X2_Core
   // --------------------------
   logic IRQ_Enable;
   logic IRQ_Clear;
+  logic IRQ_AutoAck;
+  logic IRQ_DoneEnable;
   assign IRQ_Enable = IRQ_Register[`IRQ_EN_BIT];
   assign IRQ_Clear = IRQ_Register[`IRQ_CLR_BIT];
+  assign IRQ_AutoAck = IRQ_Register[`IRQ_AUTO_ACK_BIT];
+  assign IRQ_DoneEnable = IRQ_Register[`IRQ_DONE_EN_BIT];
+
+  // --------------------------
+  // FIFO Control Register extraction
+  // --------------------------
+  logic FifoEnable;
+  logic FifoFlush;
+  logic [(`FIFO_CTRL_THRESH_MSB - `FIFO_CTRL_THRESH_LSB):0] FifoThreshold;
+  assign FifoEnable    = FIFO_Ctrl_Register[`FIFO_CTRL_EN_BIT];
+  assign FifoFlush     = FIFO_Ctrl_Register[`FIFO_CTRL_FLUSH_BIT];
+  assign FifoThreshold = FIFO_Ctrl_Register[`FIFO_CTRL_THRESH_MSB:`FIFO_CTRL_THRESH_LSB];
+
+  // --------------------------
+  // Trigger Register extraction
+  // --------------------------
+  logic TrigEnable;
+  logic TrigArm;
+  logic TrigForce;
+  logic TrigSourceB;
+  logic [1:0] TrigMode;
+  logic [(`TRIG_LEVEL_MSB - `TRIG_LEVEL_LSB):0] TrigLevel;
+  logic [(`TRIG_HYST_MSB - `TRIG_HYST_LSB):0] TrigHysteresis;
+  logic [(`TRIG_HOLDOFF_MSB - `TRIG_HOLDOFF_LSB):0] TrigHoldoff;
+  logic [(`TRIG_PRE_MSB - `TRIG_PRE_LSB):0] TrigPre;
+  logic [(`TRIG_POST_MSB - `TRIG_POST_LSB):0] TrigPost;
+  assign TrigEnable     = Trig_Ctrl_Register[`TRIG_CTRL_EN_BIT];
+  assign TrigArm        = Trig_Ctrl_Register[`TRIG_CTRL_ARM_BIT];
+  assign TrigForce      = Trig_Ctrl_Register[`TRIG_CTRL_FORCE_BIT];
+  assign TrigSourceB    = Trig_Ctrl_Register[`TRIG_CTRL_SOURCE_BIT];
+  assign TrigMode       = Trig_Ctrl_Register[`TRIG_CTRL_MODE_MSB:`TRIG_CTRL_MODE_LSB];
+  assign TrigLevel      = Trig_Level_Register[`TRIG_LEVEL_MSB:`TRIG_LEVEL_LSB];
+  assign TrigHysteresis = Trig_Level_Register[`TRIG_HYST_MSB:`TRIG_HYST_LSB];
+  assign TrigHoldoff    = Trig_Holdoff_Register[`TRIG_HOLDOFF_MSB:`TRIG_HOLDOFF_LSB];
+  assign TrigPre        = Trig_Record_Register[`TRIG_PRE_MSB:`TRIG_PRE_LSB];
+  assign TrigPost       = Trig_Record_Register[`TRIG_POST_MSB:`TRIG_POST_LSB];
+
+  // --------------------------
+  // CIC Register extraction
+  // --------------------------
+  logic CicEnable;
+  logic [(`CIC_CTRL_ORDER_MSB - `CIC_CTRL_ORDER_LSB):0] CicOrderM1;
+  logic [(`CIC_CTRL_RATIO_MSB - `CIC_CTRL_RATIO_LSB):0] CicRatioM1;
+  logic [(`CIC_CTRL_SHIFT_MSB - `CIC_CTRL_SHIFT_LSB):0] CicShift;
+  assign CicEnable  = Cic_Ctrl_Register[`CIC_CTRL_EN_BIT];
+  assign CicOrderM1 = Cic_Ctrl_Register[`CIC_CTRL_ORDER_MSB:`CIC_CTRL_ORDER_LSB];
+  assign CicRatioM1 = Cic_Ctrl_Register[`CIC_CTRL_RATIO_MSB:`CIC_CTRL_RATIO_LSB];
+  assign CicShift   = Cic_Ctrl_Register[`CIC_CTRL_SHIFT_MSB:`CIC_CTRL_SHIFT_LSB];
 
   // --------------------------
   // State / Counters / Clock
@@ -156,9 +357,17 @@ module IMR_ADC_7476A_X2_Core
   logic [2:0] State;              // FSM State
   logic [4:0] ShiftBitCount;      // 0..15 (16 SCLK edges where we sample)
   logic [(`CTRL_CLKDIV_MSB - `CTRL_CLKDIV_LSB):0] ClockDividerCount;  // 0..ClockDivider_N for half-period ticks
-  logic [11:0]ConversionCount;    // 0..4096 Total Conversions possible
+  logic [11:0]ConversionCount;    // 0..4096 Total Conversions possible (wraps when free running)
   logic ADC_CLK;                  // Clock used to drive ADC
+  logic MISO_Sample;              // Take MISO this clock - two SysClks after SCLK rises
   logic [7:0] QuietCnt;           // SYSCLK cycles after CS_n high
+  logic [(`SAMPLE_PERIOD_MSB - `SAMPLE_PERIOD_LSB):0] PeriodCount;   // SysClk cycles to the next period tick
+  logic SamplePending;            // Period tick not yet taken by the next frame
+  logic SampleTick;
+  logic SampleTake;
+  logic QuietDone;                // Last tQUIET clock
+  logic ContinueCapture;          // Continuous capture wants another frame after this one
+  logic StartReady;               // Period and result latch allow the next frame to start
 
   // --------------------------
   // Shift Registers and Flags
@@ -166,16 +375,121 @@ module IMR_ADC_7476A_X2_Core
   // Shift registers (capture 16-bit frame, MSB-first)
   logic [15:0] ADC_Shift_A; 
   logic [15:0] ADC_Shift_B;
+  // Result registers - the frame latched from the shift registers (or the CIC output)
+  logic [15:0] ADC_Result_A;
+  logic [15:0] ADC_Result_B;
+  logic [15:0] ResultSample_A;    // Sample the latch takes: raw 12 bits or the 16 bit CIC output
+  logic [15:0] ResultSample_B;
+  logic [31:0] ResultWord;        // FIFO / DATA_AB packing of the two
+  logic CountDone;                // This frame ends a counted capture
+  logic FrameDone;                // 16th MISO sample this clock
+  logic ResultPending;            // Complete frame in the shift registers, not yet latched
+  logic LatchNow;                 // Latch the pending frame this clock
   // Status flags
   logic StatusBusy;               // A conversion is in progress
   logic StatusReady;              // A conversion is ready
+  logic [7:0] Sequence;           // Conversions completed (wraps) - lets software spot a missed sample
+  logic StatusOverrun;            // Conversion missed its period slot (sticky)
+  logic CaptureBusy;              // STATUS BUSY - FSM, pending result or CIC comb
+  logic CaptureBusy_D1;
+  logic CaptureDone;              // Capture ended, every result latched (sticky)
+
+  // --------------------------
+  // Sample FIFO
+  // --------------------------
+  (* ram_style = "block" *) logic [31:0] FifoMemory [0:`FIFO_DEPTH - 1];
+  logic [`FIFO_ADDR_BITS - 1:0] FifoWritePointer;
+  logic [`FIFO_ADDR_BITS - 1:0] FifoReadPointer;
+  logic [`FIFO_ADDR_BITS:0] FifoCount;        // 0..1024
+  logic [31:0] FifoReadData;                  // BRAM output register
+  logic FifoOverflow;                         // Sample dropped (sticky)
+  logic FifoFull;
+  logic FifoEmpty;
+  logic FifoPush;
+  logic FifoPopValid;
+  logic FifoThresholdReached;
+  logic FifoTail;
+  logic FifoDrop;                             // Pre-trigger ring: drop the oldest as the new sample lands
+
+  // --------------------------
+  // Trigger engine
+  // --------------------------
+  logic TrigActive;                           // TrigEnable with the FIFO on
+  logic [1:0] TrigState;
+  logic [(`TRIG_HOLDOFF_MSB - `TRIG_HOLDOFF_LSB):0] TrigHoldCount;    // Samples left before a trigger is accepted
+  logic [(`TRIG_POST_MSB - `TRIG_POST_LSB):0] TrigPostCount;          // Post trigger samples left to store
+  logic [`FIFO_ADDR_BITS:0] TrigIndex;        // Pre trigger samples in the record
+  logic TrigEdgeArmed;                        // Source has been beyond the hysteresis band - an edge may fire
+  logic TrigForcePending;
+  logic TrigDone;                             // Record complete (sticky)
+  logic TrigStore;                            // Latched samples go to the FIFO
+  logic TrigFire;
+  logic TrigCondition;
+  logic [11:0] TrigSample;
+  logic [12:0] TrigBandLow;                   // 13 bits - LEVEL - HYST below 0 never re-arms a rising edge
+  logic [12:0] TrigBandHigh;                  // and LEVEL + HYST above 4095 never re-arms a falling edge
+  logic [(`TRIG_HOLDOFF_MSB - `TRIG_HOLDOFF_LSB):0] TrigPreHold;      // TrigPre at the holdoff width
+
+  // --------------------------
+  // CIC decimator
+  // --------------------------
+  logic CicRun;                               // This capture is decimated (latched at the capture start)
+  logic CicInput;                             // Frame complete in the shift registers - integrate it
+  logic [`CIC_WIDTH - 1:0] CicInteg_A [0:`CIC_MAX_ORDER - 1];
+  logic [`CIC_WIDTH - 1:0] CicInteg_B [0:`CIC_MAX_ORDER - 1];
+  logic [`CIC_WIDTH - 1:0] CicCombDelay_A [0:`CIC_MAX_ORDER - 1];
+  logic [`CIC_WIDTH - 1:0] CicCombDelay_B [0:`CIC_MAX_ORDER - 1];
+  logic [`CIC_WIDTH - 1:0] CicSample_A;       // Conversion at the integrator width
+  logic [`CIC_WIDTH - 1:0] CicSample_B;
+  logic [`CIC_WIDTH - 1:0] CicComb_A;         // Value passing through the comb stages
+  logic [`CIC_WIDTH - 1:0] CicComb_B;
+  logic [`CIC_WIDTH - 1:0] CicScaled_A;
+  logic [`CIC_WIDTH - 1:0] CicScaled_B;
+  logic [15:0] CicOut_A;
+  logic [15:0] CicOut_B;
+  logic [(`CIC_CTRL_RATIO_MSB - `CIC_CTRL_RATIO_LSB):0] CicDecimCount;   // Frames into this output
+  logic [(`CIC_CTRL_ORDER_MSB - `CIC_CTRL_ORDER_LSB):0] CicPrimeCount;  // Outputs still to discard
+  logic CicOutputFrame;                       // The last frame completes a delivered output
+  logic CicCombActive;
+  logic [2:0] CicCombStep;                    // 0 = load from the last integrator, then one comb per clock
+  logic [1:0] CicCombIndex;                   // Comb stage applied at this step (CicCombStep - 1)
+  logic CicOutputReady;                       // Last comb this clock - the output is pending next clock
 
   // --------------------------
   // Output assigns (Combinational statments)
   // --------------------------
   assign SCLK = ADC_CLK;
-  assign CS_n = (State == `STATE_START || State == `STATE_SHIFT || State == `STATE_LATCH) ? 1'b0 : 1'b1;   // ADC Chip Select (active low)
-  assign IP_IRQ = (IRQ_Enable & StatusReady);   // Assert Interrupt (data ready) when Status Ready and Interrupt enabled
+  assign CS_n = (State == `STATE_SHIFT) ? 1'b0 : 1'b1;   // ADC Chip Select (active low)
+  // Assert Interrupt when enabled and: FIFO off - data ready, FIFO on - threshold, overflow or tail,
+  // triggered - the record is complete (or overflow); in any mode the capture done if enabled
+  assign IP_IRQ = IRQ_Enable & ((IRQ_DoneEnable & CaptureDone) |
+                                (TrigActive ? (FifoOverflow | (TrigDone & ~DMA_Enable)) :
+                                 FifoEnable ? (FifoThresholdReached | FifoOverflow | (FifoTail & ~DMA_Enable)) : StatusReady));
+  assign CaptureBusy = StatusBusy | ResultPending | CicCombActive;
+
+  assign FifoFull             = (FifoCount == `FIFO_DEPTH);
+  assign FifoEmpty            = (FifoCount == '0);
+  // Pre-trigger ring: a full ring (or FIFO) takes the new sample as the oldest is dropped
+  assign FifoDrop             = TrigActive && (TrigState == `TRIG_STATE_ARMED) && LatchNow && !TrigFire &&
+                                (FifoCount >= TrigPre) && !FifoPopValid;
+  assign FifoPush             = FifoEnable && LatchNow && TrigStore && (!FifoFull || FifoDrop);
+  assign FifoPopValid         = (FIFO_Pop || FIFO_DMA_Pop) && !FifoEmpty;
+  assign FifoThresholdReached = (FifoThreshold != '0) && (FifoCount >= FifoThreshold);
+  assign FifoTail             = !FifoEmpty && (State == `STATE_IDLE);
+  // Result latch: FIFO enabled at once, FIFO disabled when the last result has been acknowledged
+  assign FrameDone            = (State == `STATE_SHIFT) && MISO_Sample && (ShiftBitCount == (`FRAME_CLKS - 1));
+  assign LatchNow             = ResultPending && (FifoEnable || !IP_IRQ);
+  // Period tick every SamplePeriod SysClks from the first CS_n fall; the next frame starts on it
+  // from the end of QUIET (on time) or NEXT_CONV (waiting)
+  assign SampleTick           = PeriodEnable && (State != `STATE_IDLE) && (State != `STATE_START) && (PeriodCount == '0);
+  assign QuietDone            = (State == `STATE_QUIET) && (QuietCnt >= (`QUIET_SYS_CLKS - 1));
+  // Counted captures end on the frame giving the last result - decimating, on the frame completing the last output
+  assign CountDone            = (ConversionCount == TotalConversions - 12'd1) && (!CicRun || CicOutputFrame);
+  assign ContinueCapture      = ContinuousConversion && ChipEnable && (FreeRun || !CountDone) &&
+                                !(TrigActive && (TrigState == `TRIG_STATE_DONE));
+  assign StartReady           = (!PeriodEnable || SamplePending || SampleTick) && (!ResultPending || LatchNow);
+  assign SampleTake           = StartReady && ((QuietDone && ContinueCapture) ||
+                                               ((State == `STATE_NEXT_CONV) && ContinuousConversion && ChipEnable));
 
 
   // --------------------------
@@ -185,17 +499,34 @@ module IMR_ADC_7476A_X2_Core
   begin
     // First clear all bits, then set specific fields
     Status_Register = '0;
-    Status_Register[`STATUS_BUSY_BIT] = StatusBusy;
+    Status_Register[`STATUS_BUSY_BIT] = CaptureBusy;
     Status_Register[`STATUS_RDY_BIT] = StatusReady;
+    Status_Register[`STATUS_OVERRUN_BIT] = StatusOverrun;
+    Status_Register[`STATUS_DONE_BIT] = CaptureDone;
     `STATUS_ERR_FIELD = StatusError;
     `STATUS_STATE_FIELD = State;
     `STATUS_C_CNT_FIELD = ConversionCount;
     `STATUS_DEBUG_FIELD = StatusDebug;
-    `STATUS_REV_FIELD = 4'd2; 
-    // { ... , ... } is the concatenation operator 20 bits of 0's and 12bits from Shift_X (32b total)
-    // Loads channel data with 20 MSBs = 0s + 12 LSBs from ADC shift register
-    ADC_Data_A_Register = {20'd0, ADC_Shift_A[11:0]};
-    ADC_Data_B_Register = {20'd0, ADC_Shift_B[11:0]};
+    `STATUS_REV_FIELD = 4'd11; 
+    // { ... , ... } is the concatenation operator 16 bits of 0's and 16bits from Result_X (32b total)
+    // Loads channel data with 16 MSBs = 0s + 12 bits latched from the ADC shift register (16 decimating)
+    ADC_Data_A_Register = {16'd0, ADC_Result_A};
+    ADC_Data_B_Register = {16'd0, ADC_Result_B};
+
+    FIFO_Status_Register = '0;
+    FIFO_Status_Register[`FIFO_STATUS_COUNT_MSB:`FIFO_STATUS_COUNT_LSB] = FifoCount;
+    FIFO_Status_Register[`FIFO_STATUS_THRESH_BIT] = FifoThresholdReached;
+    FIFO_Status_Register[`FIFO_STATUS_OVF_BIT] = FifoOverflow;
+    FIFO_Status_Register[`FIFO_STATUS_EMPTY_BIT] = FifoEmpty;
+    FIFO_Status_Register[`FIFO_STATUS_FULL_BIT] = FifoFull;
+    FIFO_Status_Register[`FIFO_STATUS_TAIL_BIT] = FifoTail;
+    FIFO_Status_Register[`FIFO_STATUS_TRIG_BIT] = TrigDone;
+    FIFO_Data_Register = FifoReadData;
+
+    Trig_Status_Register = '0;
+    Trig_Status_Register[`TRIG_STATUS_INDEX_MSB:`TRIG_STATUS_INDEX_LSB] = TrigIndex;
+    Trig_Status_Register[`TRIG_STATUS_STATE_MSB:`TRIG_STATUS_STATE_LSB] = TrigState;
+    Trig_Status_Register[`TRIG_STATUS_DONE_BIT] = TrigDone;
   end
 
 
@@ -222,6 +553,16 @@ module IMR_ADC_7476A_X2_Core
   end
   wire ADC_CLK_RisingEdge = (ADC_CLK & ~ADC_CLK_Delay_1_Clk);
 
+  // MISO sample strobe: the SysClk after the rising edge detect, so MISO is taken two SysClks
+  // after SCLK rises - the timing budget under Timing above
+  always_ff @(posedge SysClk or negedge RST_n)
+  begin
+    if (!RST_n)
+        MISO_Sample <= 1'b0;
+    else
+        MISO_Sample <= ADC_CLK_RisingEdge;
+  end
+
 
  // Rising-edge detect on Continuous bit (treats write-1 as a pulse)
   logic Continuous_Delay_1_Clk;
@@ -234,6 +575,38 @@ module IMR_ADC_7476A_X2_Core
   end
   wire ContinuousRisingEdge = (ContinuousConversion & ~Continuous_Delay_1_Clk);
 
+
+  // Rising-edge detect on FIFO Flush bit (treats write-1 as a pulse)
+  logic Flush_Delay_1_Clk;
+  always_ff @(posedge SysClk or negedge RST_n)
+  begin
+    if (!RST_n) 
+        Flush_Delay_1_Clk <= 1'b0;
+    else        
+        Flush_Delay_1_Clk <= FifoFlush;
+  end
+  wire FlushRisingEdge = (FifoFlush & ~Flush_Delay_1_Clk);
+
+
+  // Rising-edge detect on Trigger Arm and Force bits (treats write-1 as a pulse)
+  logic Arm_Delay_1_Clk;
+  logic Force_Delay_1_Clk;
+  always_ff @(posedge SysClk or negedge RST_n)
+  begin
+    if (!RST_n)
+    begin
+        Arm_Delay_1_Clk <= 1'b0;
+        Force_Delay_1_Clk <= 1'b0;
+    end
+    else
+    begin
+        Arm_Delay_1_Clk <= TrigArm;
+        Force_Delay_1_Clk <= TrigForce;
+    end
+  end
+  wire ArmRisingEdge = (TrigArm & ~Arm_Delay_1_Clk) & TrigActive;
+  wire ForceRisingEdge = (TrigForce & ~Force_Delay_1_Clk);
+
   
   // Handle Status Ready flag - Interrupt generation and clearing
   always_ff @(posedge SysClk or negedge RST_n)
@@ -244,13 +617,14 @@ module IMR_ADC_7476A_X2_Core
     end
 
     // Clear the Interrupt
-    else if (IRQ_Clear)
+    else if (IRQ_Clear || (IRQ_AutoAck && DataAB_Read))
     begin
       StatusReady <= `FALSE; 
     end
 
-    // Set the Status Ready flag when in LATCH state - this will trigger the interrupt
-    else if (State == `STATE_LATCH)
+    // Set the Status Ready flag with the result latch - this will trigger the interrupt
+    // FIFO enabled: the sample goes to the FIFO, DATA_A/B are not handshaked
+    else if (LatchNow && !FifoEnable)
     begin
       StatusReady <= `TRUE;
     end
@@ -258,13 +632,392 @@ module IMR_ADC_7476A_X2_Core
 
 
 
+  // Capture done flag - the falling edge of BUSY.  A new capture clears it (as it does the overrun
+  // flag); set wins over IRQ_Clear in the same clock so an end of capture is never lost
+  always_ff @(posedge SysClk or negedge RST_n)
+  begin
+    if (!RST_n)
+    begin
+      CaptureBusy_D1 <= `FALSE;
+      CaptureDone <= `FALSE;
+    end
+    else
+    begin
+      CaptureBusy_D1 <= CaptureBusy;
+      if (CaptureBusy_D1 && !CaptureBusy)
+        CaptureDone <= `TRUE;
+      else if (IRQ_Clear || ((State == `STATE_IDLE) && ChipEnable && (SingleRisingEdge || ContinuousRisingEdge)))
+        CaptureDone <= `FALSE;
+    end
+  end
+
+
+
+  // Result registers, packed data register and sequence number - latched from the completed frame
+  // so the next frame can shift while software reads this one
+  always_ff @(posedge SysClk or negedge RST_n)
+  begin
+    if (!RST_n)
+    begin
+      ADC_Result_A <= '0;
+      ADC_Result_B <= '0;
+      ADC_Data_AB_Register <= '0;
+      Sequence <= '0;
+    end
+    else if (LatchNow)
+    begin
+      ADC_Result_A <= ResultSample_A;
+      ADC_Result_B <= ResultSample_B;
+      ADC_Data_AB_Register <= CicRun ? ResultWord : {Sequence, ResultWord[23:0]};
+      Sequence <= Sequence + 8'd1;
+    end
+  end
+
+
+  // Pending result - set by the 16th sample (decimating, by the last comb), cleared by the latch.
+  // SHIFT is only entered with no result pending (or on its latch clock), so the two never coincide
+  always_ff @(posedge SysClk or negedge RST_n)
+  begin
+    if (!RST_n)
+      ResultPending <= `FALSE;
+    else if (CicRun ? CicOutputReady : FrameDone)
+      ResultPending <= `TRUE;
+    else if (LatchNow)
+      ResultPending <= `FALSE;
+  end
+
+
+  // --------------------------
+  // Sample FIFO storage - no reset so the array maps to block RAM
+  // Push on the result latch (ADC_Shift_A/B hold the complete frame, or the CIC output), pop registers the oldest word
+  // --------------------------
+  always_ff @(posedge SysClk)
+  begin
+    if (FifoPush)
+      FifoMemory[FifoWritePointer] <= ResultWord;
+    if (FifoPopValid)
+      FifoReadData <= FifoMemory[FifoReadPointer];
+  end
+
+
+  // Sample FIFO pointers, occupancy and overflow
+  always_ff @(posedge SysClk or negedge RST_n)
+  begin
+    if (!RST_n)
+    begin
+      FifoWritePointer <= '0;
+      FifoReadPointer <= '0;
+      FifoCount <= '0;
+      FifoOverflow <= `FALSE;
+    end
+
+    // Flush empties the FIFO and clears overflow - so does arming the trigger
+    else if (FlushRisingEdge || ArmRisingEdge)
+    begin
+      FifoWritePointer <= '0;
+      FifoReadPointer <= '0;
+      FifoCount <= '0;
+      FifoOverflow <= `FALSE;
+    end
+
+    else
+    begin
+      if (FifoPush)
+        FifoWritePointer <= FifoWritePointer + 1;
+      if (FifoPopValid || FifoDrop)
+        FifoReadPointer <= FifoReadPointer + 1;
+      if (FifoPush && !(FifoPopValid || FifoDrop))
+        FifoCount <= FifoCount + 1;
+      else if ((FifoPopValid || FifoDrop) && !FifoPush)
+        FifoCount <= FifoCount - 1;
+
+      // Full FIFO drops the new sample - flag it until acknowledged
+      if (IRQ_Clear)
+        FifoOverflow <= `FALSE;
+      else if (FifoEnable && LatchNow && TrigStore && FifoFull && !FifoDrop)
+        FifoOverflow <= `TRUE;
+    end
+  end
+
+
+  // --------------------------
+  // Trigger engine
+  // --------------------------
+  // Runs on the result latch (LatchNow), one compare per conversion of the source channel.
+  // ARM flushes the FIFO (above) and starts the pre-trigger ring; the trigger sample and the
+  // ones after it are kept; at TrigPost samples the record is done and the capture stops.
+  assign TrigActive    = TrigEnable && FifoEnable;
+  assign TrigStore     = !TrigActive || (TrigState == `TRIG_STATE_ARMED) || (TrigState == `TRIG_STATE_POST);
+  assign FIFO_DMA_Hold = TrigActive && (TrigState != `TRIG_STATE_DONE);
+  assign TrigSample    = CicRun ? (TrigSourceB ? ResultSample_B[15:4] : ResultSample_A[15:4]) :
+                                  (TrigSourceB ? ResultSample_B[11:0] : ResultSample_A[11:0]);
+  assign TrigBandLow   = {1'b0, TrigLevel} - {1'b0, TrigHysteresis};
+  assign TrigBandHigh  = {1'b0, TrigLevel} + {1'b0, TrigHysteresis};
+  assign TrigPreHold   = {{(`TRIG_HOLDOFF_MSB - `TRIG_PRE_MSB){1'b0}}, TrigPre};
+
+  always_comb
+  begin
+    unique case (TrigMode)
+      `TRIG_MODE_ABOVE:   TrigCondition = (TrigSample >= TrigLevel);
+      `TRIG_MODE_RISING:  TrigCondition = TrigEdgeArmed && (TrigSample >= TrigLevel);
+      `TRIG_MODE_FALLING: TrigCondition = TrigEdgeArmed && (TrigSample <= TrigLevel);
+      default:            TrigCondition = (TrigSample <= TrigLevel);
+    endcase
+  end
+  assign TrigFire = TrigActive && (TrigState == `TRIG_STATE_ARMED) && LatchNow &&
+                    (TrigForcePending || ((TrigHoldCount == '0) && TrigCondition));
+
+  always_ff @(posedge SysClk or negedge RST_n)
+  begin
+    if (!RST_n)
+    begin
+      TrigState <= `TRIG_STATE_IDLE;
+      TrigHoldCount <= '0;
+      TrigPostCount <= '0;
+      TrigIndex <= '0;
+      TrigEdgeArmed <= `FALSE;
+      TrigForcePending <= `FALSE;
+      TrigDone <= `FALSE;
+    end
+
+    // Trigger or FIFO off - disarmed
+    else if (!TrigActive)
+    begin
+      TrigState <= `TRIG_STATE_IDLE;
+      TrigForcePending <= `FALSE;
+      TrigDone <= `FALSE;
+    end
+
+    // Arm: holdoff never shorter than the pre-trigger fill
+    else if (ArmRisingEdge)
+    begin
+      TrigState <= `TRIG_STATE_ARMED;
+      TrigHoldCount <= (TrigHoldoff > TrigPreHold) ? TrigHoldoff : TrigPreHold;
+      TrigIndex <= '0;
+      TrigEdgeArmed <= `FALSE;
+      TrigForcePending <= `FALSE;
+      TrigDone <= `FALSE;
+    end
+
+    else
+    begin
+      if (IRQ_Clear)
+        TrigDone <= `FALSE;
+      if (ForceRisingEdge && (TrigState == `TRIG_STATE_ARMED))
+        TrigForcePending <= `TRUE;
+
+      unique case (TrigState)
+        `TRIG_STATE_ARMED:
+        begin
+          if (LatchNow)
+          begin
+            if (TrigHoldCount != '0)
+              TrigHoldCount <= TrigHoldCount - 1;
+            // Edge re-arm once the source has left the hysteresis band on the far side
+            if (((TrigMode == `TRIG_MODE_RISING) && !TrigBandLow[12] && ({1'b0, TrigSample} < TrigBandLow)) ||
+                ((TrigMode == `TRIG_MODE_FALLING) && ({1'b0, TrigSample} > TrigBandHigh)))
+              TrigEdgeArmed <= `TRUE;
+            if (TrigFire)
+            begin
+              // FIFO holds only the pre-trigger samples now - the trigger sample lands at this index
+              TrigIndex <= FifoCount;
+              TrigForcePending <= `FALSE;
+              if (TrigPost <= 1)
+              begin
+                TrigDone <= `TRUE;
+                TrigState <= `TRIG_STATE_DONE;
+              end
+              else
+              begin
+                TrigPostCount <= TrigPost - 1;
+                TrigState <= `TRIG_STATE_POST;
+              end
+            end
+          end
+        end
+
+        `TRIG_STATE_POST:
+        begin
+          if (LatchNow)
+          begin
+            TrigPostCount <= TrigPostCount - 1;
+            if (TrigPostCount == 1)
+            begin
+              TrigDone <= `TRUE;
+              TrigState <= `TRIG_STATE_DONE;
+            end
+          end
+        end
+
+        default: ;
+      endcase
+    end
+  end
+
+
+  // --------------------------
+  // CIC decimator
+  // --------------------------
+  // Integrates each completed frame the clock after FrameDone (the shift registers then hold it).
+  // The R-th frame starts the combs: load the last integrator, then one comb per clock, so the output
+  // is pending N + 3 clocks after FrameDone.  Unsigned input, modulo arithmetic.
+  assign ResultSample_A = CicRun ? CicOut_A : {4'd0, ADC_Shift_A[11:0]};
+  assign ResultSample_B = CicRun ? CicOut_B : {4'd0, ADC_Shift_B[11:0]};
+  assign ResultWord     = CicRun ? {ResultSample_A, ResultSample_B} : {8'h00, ResultSample_A[11:0], ResultSample_B[11:0]};
+  assign CicSample_A    = {{(`CIC_WIDTH - `ADC_BITS){1'b0}}, ADC_Shift_A[11:0]};
+  assign CicSample_B    = {{(`CIC_WIDTH - `ADC_BITS){1'b0}}, ADC_Shift_B[11:0]};
+  assign CicCombIndex   = CicCombStep[1:0] - 2'd1;
+  assign CicScaled_A    = CicComb_A >> CicShift;
+  assign CicScaled_B    = CicComb_B >> CicShift;
+  assign CicOut_A       = (|CicScaled_A[`CIC_WIDTH - 1:`CIC_OUT_BITS]) ? 16'hFFFF : CicScaled_A[15:0];
+  assign CicOut_B       = (|CicScaled_B[`CIC_WIDTH - 1:`CIC_OUT_BITS]) ? 16'hFFFF : CicScaled_B[15:0];
+  assign CicOutputReady = CicCombActive && (CicCombStep == ({1'b0, CicOrderM1} + 3'd1)) && CicOutputFrame;
+
+  always_ff @(posedge SysClk or negedge RST_n)
+  begin
+    if (!RST_n)
+    begin
+      CicRun <= `FALSE;
+      CicInput <= `FALSE;
+      CicDecimCount <= '0;
+      CicPrimeCount <= '0;
+      CicOutputFrame <= `FALSE;
+      CicCombActive <= `FALSE;
+      CicCombStep <= '0;
+      CicComb_A <= '0;
+      CicComb_B <= '0;
+      for (int Stage = 0; Stage < `CIC_MAX_ORDER; Stage++)
+      begin
+        CicInteg_A[Stage[1:0]] <= '0;
+        CicInteg_B[Stage[1:0]] <= '0;
+        CicCombDelay_A[Stage[1:0]] <= '0;
+        CicCombDelay_B[Stage[1:0]] <= '0;
+      end
+    end
+
+    // Capture start: clear the filter, continuous captures decimate when enabled
+    else if ((State == `STATE_IDLE) && ChipEnable && (SingleRisingEdge || ContinuousRisingEdge))
+    begin
+      CicRun <= CicEnable && ContinuousRisingEdge;
+      CicInput <= `FALSE;
+      CicDecimCount <= '0;
+      CicPrimeCount <= CicOrderM1;
+      CicOutputFrame <= `FALSE;
+      CicCombActive <= `FALSE;
+      CicCombStep <= '0;
+      for (int Stage = 0; Stage < `CIC_MAX_ORDER; Stage++)
+      begin
+        CicInteg_A[Stage[1:0]] <= '0;
+        CicInteg_B[Stage[1:0]] <= '0;
+        CicCombDelay_A[Stage[1:0]] <= '0;
+        CicCombDelay_B[Stage[1:0]] <= '0;
+      end
+    end
+
+    else
+    begin
+      CicInput <= CicRun && FrameDone;
+
+      // Integrators - stage 0 takes the sample, the others the stage before (pipelined)
+      if (CicInput)
+      begin
+        CicInteg_A[0] <= CicInteg_A[0] + CicSample_A;
+        CicInteg_B[0] <= CicInteg_B[0] + CicSample_B;
+        for (int Stage = 1; Stage < `CIC_MAX_ORDER; Stage++)
+        begin
+          CicInteg_A[Stage[1:0]] <= CicInteg_A[Stage[1:0]] + CicInteg_A[Stage[1:0] - 2'd1];
+          CicInteg_B[Stage[1:0]] <= CicInteg_B[Stage[1:0]] + CicInteg_B[Stage[1:0] - 2'd1];
+        end
+        // R-th frame: decimate.  The first N - 1 outputs are still filling the filter
+        if (CicDecimCount == CicRatioM1)
+        begin
+          CicDecimCount <= '0;
+          CicCombActive <= `TRUE;
+          CicCombStep <= '0;
+          CicOutputFrame <= (CicPrimeCount == '0);
+          if (CicPrimeCount != '0)
+            CicPrimeCount <= CicPrimeCount - 1;
+        end
+        else
+        begin
+          CicDecimCount <= CicDecimCount + 1;
+          CicOutputFrame <= `FALSE;
+        end
+      end
+
+      // Combs - step 0 loads the last integrator, step k applies comb k - 1
+      if (CicCombActive)
+      begin
+        if (CicCombStep == '0)
+        begin
+          CicComb_A <= CicInteg_A[CicOrderM1];
+          CicComb_B <= CicInteg_B[CicOrderM1];
+        end
+        else
+        begin
+          CicComb_A <= CicComb_A - CicCombDelay_A[CicCombIndex];
+          CicComb_B <= CicComb_B - CicCombDelay_B[CicCombIndex];
+          CicCombDelay_A[CicCombIndex] <= CicComb_A;
+          CicCombDelay_B[CicCombIndex] <= CicComb_B;
+        end
+        if (CicCombStep == ({1'b0, CicOrderM1} + 3'd1))
+          CicCombActive <= `FALSE;
+        CicCombStep <= CicCombStep + 3'd1;
+      end
+    end
+  end
+
+
+  // --------------------------
+  // Sample period timer
+  // --------------------------
+  // The counter is held loaded in IDLE and START and runs from the first CS_n fall (START ->
+  // SHIFT), so the tick falls SamplePeriod - 1 clocks later and the next frame enters SHIFT
+  // (CS_n low) on the following edge - every CS_n fall exactly SamplePeriod SysClks after the
+  // one before.  A tick the FSM cannot take (frame still in flight, or a FIFO-off result not yet
+  // acknowledged) is an overrun: it is held pending, that frame starts late and the ones after
+  // it stay on the tick grid.  The tick after the last frame of a counted capture is not one,
+  // nor is any tick outside a continuous capture (single conversion, or START dropped to stop).
+  always_ff @(posedge SysClk or negedge RST_n)
+  begin
+    if (!RST_n)
+    begin
+      PeriodCount <= '0;
+      SamplePending <= `FALSE;
+      StatusOverrun <= `FALSE;
+    end
+    else if ((State == `STATE_IDLE) || (State == `STATE_START))
+    begin
+      PeriodCount <= SamplePeriod - 1;
+      SamplePending <= `FALSE;
+      if ((State == `STATE_IDLE) && (IRQ_Clear || (ChipEnable && (SingleRisingEdge || ContinuousRisingEdge))))
+        StatusOverrun <= `FALSE;
+    end
+    else
+    begin
+      PeriodCount <= (PeriodCount == '0) ? (SamplePeriod - 1) : (PeriodCount - 1);
+      if (SampleTick && !SampleTake)
+        SamplePending <= `TRUE;
+      else if (SampleTake)
+        SamplePending <= `FALSE;
+      if (ContinuousConversion && SampleTick && !SampleTake && !(QuietDone && !ContinueCapture))
+        StatusOverrun <= `TRUE;
+      else if (IRQ_Clear)
+        StatusOverrun <= `FALSE;
+    end
+  end
+
   // --------------------------
   // Clock divider (generates ADC_CLK toggles in SHIFT)
   // --------------------------
-  // Half-period tick at (ClockDividerCount == ClockDivider_N); ADC_CLK toggles then.
+  // Half-period tick at (ClockDividerCount == ClockDivider_N - 1); ADC_CLK toggles then.
   // SysClk = 100MHz
   // You count ClockDividerCount SysClk cycles to toggle ADC_CLK, ADC_CLK must toogle twice for one period
   // If ClockDividerCount = 3, ADC_CLK = 16.6667MHz, ClockDividerCount = 4, ADC_CLK = 12.5MHz, ClockDividerCount = 5, ADC_CLK = 10.0MHz
+  // ClockOdd ends the high phase one SysClk early: N = 3 gives 20MHz (high 2, low 3 SysClks) - the
+  // long low phase keeps the MISO access time, the 20 ns high phase meets 0.4 x tSCLK
+  logic [(`CTRL_CLKDIV_MSB - `CTRL_CLKDIV_LSB):0] ClockHalfCount;
+  assign ClockHalfCount = (ADC_CLK && ClockOdd) ? (ClockDivider_N - 2) : (ClockDivider_N - 1);
   always_ff @(posedge SysClk or negedge RST_n)
   begin
     if (!RST_n)
@@ -273,20 +1026,20 @@ module IMR_ADC_7476A_X2_Core
       ADC_CLK <= 1'b0;
     end
 
-    else if ((State == `STATE_SHIFT) || (State == `STATE_LATCH))
+    else if (State == `STATE_SHIFT)
     begin
-      if (ClockDividerCount == (ClockDivider_N - 1))
+      if (ClockDividerCount == ClockHalfCount)
       begin
         ClockDividerCount  <= '0;
         ADC_CLK <= ~ADC_CLK;
       end
       else
       begin
-        ClockDividerCount <= ClockDividerCount + 1'b1;
+        ClockDividerCount <= ClockDividerCount + 1;
       end
     end
 
-    else if ((State == `STATE_QUIET) || (State == `STATE_NEXT_CONV))  
+    else
     begin
       ClockDividerCount <= '0;
       ADC_CLK <= 1'b0; // idle low when not shifting
@@ -297,14 +1050,13 @@ module IMR_ADC_7476A_X2_Core
   // --------------------------
   // Main FSM (Finite State Machine)
   // Flow:
-  // IDLE -> START -> SHIFT -> LATCH -> QUIET -> (NEXT_CONV -> START ...) or IDLE
+  // IDLE -> START -> SHIFT -> QUIET -> (SHIFT ...) or (NEXT_CONV -> SHIFT ...) or IDLE
   // 
   // Idle State: Waiting for ChipEnable and Single/Continuous start command
-  // Start State: Assert CS_n low, prepare for shifting - cannot start if IRQ is asserted
+  // Start State: Wait for a pending result to latch, then CS_n low into SHIFT
   // Shift State: Shift in 16 bits from MISO on each rising edge of ADC_CLK for 16 bits on both ADC channels 
-  // Latch State: Move shifted data to registers, set Status Ready flag
-  // Quiet State: Wait tQUIET cycles with CS_n high before next conversion
-  // Next Conversion State: Prepare for next conversion (only for continuous mode)
+  // Quiet State: Wait tQUIET cycles with CS_n high - the result latches alongside
+  // Next Conversion State: Wait for the period tick / result latch (only for continuous mode)
   // --------------------------
   always_ff @(posedge SysClk or negedge RST_n)
   begin
@@ -337,7 +1089,8 @@ module IMR_ADC_7476A_X2_Core
 
         `STATE_START:
         begin
-          if (!IP_IRQ)
+          // FIFO disabled: a result still held for the last IRQ must latch before the shift registers reload
+          if (!ResultPending || LatchNow)
           begin
             StatusDebug <= 4'b0000;
             StatusBusy <= `TRUE;
@@ -347,8 +1100,8 @@ module IMR_ADC_7476A_X2_Core
 
         `STATE_SHIFT:
         begin
-          // On each rising edge of SCLK, sample MISO and increment bit count
-          if (ADC_CLK_RisingEdge)
+          // Two SysClks after each rising edge of SCLK, sample MISO and increment bit count
+          if (MISO_Sample)
           begin
             ShiftBitCount <= ShiftBitCount + 5'd1;
             // MSB-first shift-in
@@ -356,44 +1109,41 @@ module IMR_ADC_7476A_X2_Core
             ADC_Shift_B <= {ADC_Shift_B[14:0], MISO_B};
             if (ShiftBitCount == (`FRAME_CLKS - 1))
             begin
-              // Completed 16 captures. Latch done; Status Ready set data can be read.
-              State <= `STATE_LATCH;
+              // Completed 16 captures (FrameDone) - CS_n high now, the result latches alongside QUIET
+              ShiftBitCount <= '0;
+              QuietCnt <= '0;
+              State <= `STATE_QUIET;
             end
           end
         end
 
-        `STATE_LATCH:
-        begin
-            QuietCnt <= '0;
-            State <= `STATE_QUIET;
-        end
-
         `STATE_QUIET:
         begin
-          if (QuietCnt >= (`QUIET_SYS_CLKS - 1))
+          if (QuietDone)
           begin
-            // Handle case of contineous conversion
-            if (ContinuousConversion)
+            // Handle case of contineous conversion - free running has no count
+            // Back to back: the next frame starts here, CS_n high for exactly tQUIET
+            if (ContinueCapture)
             begin
-              if (ConversionCount == TotalConversions - 12'd1)
+              if (!CicRun || CicOutputFrame)
+                ConversionCount <= ConversionCount + 12'd1;
+              if (SampleTake)
               begin
-                StatusError <= `STATUS_ERR_NONE;
-                StatusBusy <= `FALSE;
-                State <= `STATE_IDLE;
-                StatusDebug <= StatusDebug | 4'b0010;
+                StatusDebug <= StatusDebug | 4'b0101;
+                State <= `STATE_SHIFT;
               end
               else
               begin
-                ConversionCount <= ConversionCount + 12'd1;
-                State <= `STATE_NEXT_CONV;
                 StatusDebug <= StatusDebug | 4'b0001;
+                State <= `STATE_NEXT_CONV;
               end
             end
 
-            // Handle case of Single Conversion
-            if (SingleConversion)
+            // Handle case of Single Conversion, the last continuous conversion, or START / ChipEnable
+            // cleared mid capture - previously the FSM held in QUIET when START was dropped
+            else
             begin
-              StatusDebug <= StatusDebug | 4'b1000;
+              StatusDebug <= StatusDebug | (ContinuousConversion ? 4'b0010 : 4'b1000);
               StatusError <= `STATUS_ERR_NONE;
               StatusBusy <= `FALSE;
               State <= `STATE_IDLE;
@@ -409,9 +1159,18 @@ module IMR_ADC_7476A_X2_Core
 
         `STATE_NEXT_CONV:
         begin
-          ShiftBitCount <= '0;
-          StatusDebug <= StatusDebug | 4'b0100;
-          State <= `STATE_START;
+          // Hold with CS_n high until the period tick and the result latch
+          if (!(ContinuousConversion && ChipEnable))
+          begin
+            StatusError <= `STATUS_ERR_NONE;
+            StatusBusy <= `FALSE;
+            State <= `STATE_IDLE;
+          end
+          else if (SampleTake)
+          begin
+            StatusDebug <= StatusDebug | 4'b0100;
+            State <= `STATE_SHIFT;
+          end
         end
 
         default: State <= `STATE_IDLE;
@@ -0,0 +1,317 @@
+//------------------------------------------------------------------------------
+// ADC 7476A Dual-Channel DMA Writer (AXI4 master, write only)
+//------------------------------------------------------------------------------
+// Description:
+//   Moves samples from the core sample FIFO straight into a ring in system memory
+//   (DDR on the MicroBlaze SmartConnect) with AXI4 INCR bursts, so the CPU does no
+//   per-sample work.  Each FIFO word {8'h00, A[11:0], B[11:0]} is written as one
+//   32-bit word, channels interleaved in the word.
+//
+// Ring descriptor (AXI-Lite registers, see IMR_ADC_7476A_X2_Def.vh):
+//   - DMA_BASE: Ring start address - 64 byte aligned
+//   - DMA_SIZE: Ring length in bytes - multiple of 64
+//   - DMA_BLOCK: Bytes per completion interrupt (0 = no block interrupt)
+//   - DMA_PRODUCER: Byte offset of the next write (read only) - advanced after each BRESP
+//   - DMA_CONSUMER: Byte offset software has consumed up to - the writer never passes it
+//     (one word is always left free so PRODUCER == CONSUMER means empty)
+//
+// Signal Interface:
+//   - DMA_Ctrl_Register: DMA_Enable, DMA_Reset (level, honoured between bursts)
+//   - FifoCount / EngineBusy: from the core - when to burst and when to flush a tail
+//   - FifoPop / FifoData: core FIFO read port, data valid the clock after the pop
+//   - IRQ_Clear: clears the sticky event flags
+//   - DMA_IRQ: Block done, capture done or write error
+//   - DMA_Status: {Stalled, CaptureDone, Error, BlockDone} to FIFO_STATUS[27:24]
+//
+// FSM States and Flow:
+//   1. IDLE: Wait for a burst worth of samples and ring space
+//      → Burst length = words to the next 64 byte line or ring end (max 16), so a burst
+//        never crosses a 4KB boundary
+//      → Shorter burst when the engine is idle - flushes the tail of a capture
+//   2. FILL: Pop the burst from the FIFO into the burst buffer (one word per SysClk)
+//   3. ADDR: AWVALID until AWREADY
+//   4. DATA: WVALID beats from the burst buffer, WLAST on the last
+//   5. RESP: BREADY until BVALID - advance PRODUCER, count the block, flag errors
+//
+// Notes:
+//   - The CPU must not read FIFO_DATA while DMA_Enable is set
+//   - Software must invalidate the D-cache over a region before reading it
+//------------------------------------------------------------------------------
+`timescale 1ns/1ps
+`include "IMR_ADC_7476A_X2_Def.vh"
+
+module IMR_ADC_7476A_X2_DMA_Writer #
+(
+  parameter integer C_M_AXI_ADDR_WIDTH = 32,
+  parameter integer C_M_AXI_DATA_WIDTH = 32   // One FIFO word per beat - must be 32
+)
+(
+  // Clock / Reset
+  input  logic        SysClk,
+  input  logic        RST_n,
+
+  // Ring descriptor and control from AXI regs
+  input  logic [31:0] DMA_Ctrl_Register,
+  input  logic [31:0] DMA_Base_Register,
+  input  logic [31:0] DMA_Size_Register,
+  input  logic [31:0] DMA_Block_Register,
+  input  logic [31:0] DMA_Consumer_Register,
+  output logic [31:0] DMA_Producer_Register,
+  output logic [3:0]  DMA_Status,
+  output logic        DMA_Enable,
+
+  // Interrupt
+  input  logic        IRQ_Clear,
+  output logic        DMA_IRQ,
+
+  // Core sample FIFO
+  input  logic [`FIFO_ADDR_BITS:0] FifoCount,
+  input  logic        EngineBusy,
+  output logic        FifoPop,
+  input  logic [31:0] FifoData,
+
+  // AXI4 master write channels
+  output logic [C_M_AXI_ADDR_WIDTH-1:0]   M_AXI_AWADDR,
+  output logic [7:0]                      M_AXI_AWLEN,
+  output logic [2:0]                      M_AXI_AWSIZE,
+  output logic [1:0]                      M_AXI_AWBURST,
+  output logic                            M_AXI_AWLOCK,
+  output logic [3:0]                      M_AXI_AWCACHE,
+  output logic [2:0]                      M_AXI_AWPROT,
+  output logic                            M_AXI_AWVALID,
+  input  logic                            M_AXI_AWREADY,
+  output logic [C_M_AXI_DATA_WIDTH-1:0]   M_AXI_WDATA,
+  output logic [C_M_AXI_DATA_WIDTH/8-1:0] M_AXI_WSTRB,
+  output logic                            M_AXI_WLAST,
+  output logic                            M_AXI_WVALID,
+  input  logic                            M_AXI_WREADY,
+  input  logic [1:0]                      M_AXI_BRESP,
+  input  logic                            M_AXI_BVALID,
+  output logic                            M_AXI_BREADY
+);
+
+  // --------------------------
+  // Control / descriptor extraction (byte values to words)
+  // --------------------------
+  logic DMA_Reset;
+  logic [29:0] RingWords;
+  logic [29:0] BlockWords;
+  logic [29:0] ConsumerWord;
+  assign DMA_Enable   = DMA_Ctrl_Register[`DMA_CTRL_EN_BIT];
+  assign DMA_Reset    = DMA_Ctrl_Register[`DMA_CTRL_RESET_BIT];
+  assign RingWords    = DMA_Size_Register[31:2];
+  assign BlockWords   = DMA_Block_Register[31:2];
+  assign ConsumerWord = DMA_Consumer_Register[31:2];
+
+  // --------------------------
+  // State / Counters
+  // --------------------------
+  logic [2:0] DmaState;
+  logic [29:0] ProducerWord;      // Next word written, 0..RingWords-1
+  logic [29:0] BlockCount;        // Words since the last block interrupt
+  logic [4:0] BurstLen;           // 1..16 words
+  logic [4:0] PopCount;           // FIFO pops issued for this burst
+  logic [4:0] StoreCount;         // Words in the burst buffer
+  logic [4:0] BeatCount;          // W beats accepted
+  logic FifoPop_Delay_1_Clk;      // FifoData valid
+  logic WrotePending;             // Burst written since the last capture done
+  logic [31:0] BurstBuffer [0:`DMA_BURST_WORDS - 1];
+
+  // Status flags (sticky until IRQ_Clear)
+  logic BlockDone;
+  logic CaptureDone;
+  logic WriteError;
+  logic Stalled;
+
+  // --------------------------
+  // Burst planning (combinational)
+  // --------------------------
+  logic [29:0] UsedWords;
+  logic [29:0] SpaceWords;
+  logic [29:0] WordsToEnd;
+  logic [29:0] WordsToLine;
+  logic [29:0] ChunkWords;
+  logic [4:0] NextLen;
+  logic [29:0] FifoWords;         // FifoCount / NextLen / BurstLen zero extended to the word counters
+  logic [29:0] NextWords;
+  logic [29:0] BurstWords;
+  logic StartBurst;
+
+  assign FifoWords  = {{(29 - `FIFO_ADDR_BITS){1'b0}}, FifoCount};
+  assign NextWords  = {25'd0, NextLen};
+  assign BurstWords = {25'd0, BurstLen};
+
+  always_comb
+  begin
+    UsedWords   = (ProducerWord >= ConsumerWord) ? (ProducerWord - ConsumerWord) : (ProducerWord + RingWords - ConsumerWord);
+    SpaceWords  = RingWords - 30'd1 - UsedWords;
+    WordsToEnd  = RingWords - ProducerWord;
+    WordsToLine = `DMA_BURST_WORDS - {26'd0, ProducerWord[3:0]};
+    ChunkWords  = (WordsToEnd < WordsToLine) ? WordsToEnd : WordsToLine;
+    NextLen     = (FifoWords >= ChunkWords) ? ChunkWords[4:0] : FifoCount[4:0];
+    // Full chunk waiting, or the engine has stopped and a tail is left - and room for it
+    StartBurst  = DMA_Enable && !DMA_Reset && (RingWords != '0) && (NextLen != '0) && (SpaceWords >= NextWords) &&
+                  ((FifoWords >= ChunkWords) || !EngineBusy);
+    Stalled     = DMA_Enable && (FifoCount != '0) && (SpaceWords < NextWords);
+  end
+
+  // --------------------------
+  // Output assigns (Combinational statments)
+  // --------------------------
+  assign FifoPop       = (DmaState == `DMA_STATE_FILL) && (PopCount != BurstLen);
+  assign M_AXI_AWSIZE  = 3'b010;            // 4 bytes per beat
+  assign M_AXI_AWBURST = 2'b01;             // INCR
+  assign M_AXI_AWLOCK  = 1'b0;
+  assign M_AXI_AWCACHE = 4'b0011;           // Normal non-cacheable bufferable
+  assign M_AXI_AWPROT  = 3'b000;
+  assign M_AXI_WDATA   = BurstBuffer[BeatCount[3:0]];
+  assign M_AXI_WSTRB   = '1;
+  assign M_AXI_WVALID  = (DmaState == `DMA_STATE_DATA);
+  assign M_AXI_WLAST   = (BeatCount == (BurstLen - 5'd1));
+  assign M_AXI_BREADY  = (DmaState == `DMA_STATE_RESP);
+  assign DMA_Producer_Register = {ProducerWord, 2'b00};
+  assign DMA_Status    = {Stalled, CaptureDone, WriteError, BlockDone};
+  assign DMA_IRQ       = BlockDone | CaptureDone | WriteError;
+
+
+  // Burst buffer - no reset so it maps to distributed RAM
+  always_ff @(posedge SysClk)
+  begin
+    if ((DmaState == `DMA_STATE_FILL) && FifoPop_Delay_1_Clk)
+      BurstBuffer[StoreCount[3:0]] <= FifoData;
+  end
+
+
+  // --------------------------
+  // Main FSM
+  // IDLE -> FILL -> ADDR -> DATA -> RESP -> IDLE
+  // --------------------------
+  always_ff @(posedge SysClk or negedge RST_n)
+  begin
+    if (!RST_n)
+    begin
+      DmaState <= `DMA_STATE_IDLE;
+      ProducerWord <= '0;
+      BlockCount <= '0;
+      BurstLen <= '0;
+      PopCount <= '0;
+      StoreCount <= '0;
+      BeatCount <= '0;
+      FifoPop_Delay_1_Clk <= 1'b0;
+      WrotePending <= 1'b0;
+      M_AXI_AWADDR <= '0;
+      M_AXI_AWLEN <= '0;
+      M_AXI_AWVALID <= 1'b0;
+      BlockDone <= `FALSE;
+      CaptureDone <= `FALSE;
+      WriteError <= `FALSE;
+    end
+
+    else
+    begin
+      FifoPop_Delay_1_Clk <= FifoPop;
+
+      // Clear the event flags - an event in the same clock below still sets its flag
+      if (IRQ_Clear)
+      begin
+        BlockDone <= `FALSE;
+        CaptureDone <= `FALSE;
+        WriteError <= `FALSE;
+      end
+
+      unique case (DmaState)
+
+        `DMA_STATE_IDLE:
+        begin
+          // Reset (level) rewinds the ring - only between bursts so no AXI transaction is cut short
+          if (DMA_Reset)
+          begin
+            ProducerWord <= '0;
+            BlockCount <= '0;
+            WrotePending <= 1'b0;
+            BlockDone <= `FALSE;
+            CaptureDone <= `FALSE;
+            WriteError <= `FALSE;
+          end
+          else if (StartBurst)
+          begin
+            BurstLen <= NextLen;
+            PopCount <= '0;
+            StoreCount <= '0;
+            DmaState <= `DMA_STATE_FILL;
+          end
+          // Engine stopped and everything written - the capture is in memory
+          else if (WrotePending && !EngineBusy && (FifoCount == '0))
+          begin
+            WrotePending <= 1'b0;
+            CaptureDone <= `TRUE;
+          end
+        end
+
+        `DMA_STATE_FILL:
+        begin
+          if (FifoPop)
+            PopCount <= PopCount + 5'd1;
+          if (FifoPop_Delay_1_Clk)
+          begin
+            StoreCount <= StoreCount + 5'd1;
+            if (StoreCount == (BurstLen - 5'd1))
+            begin
+              M_AXI_AWADDR <= DMA_Base_Register + {ProducerWord, 2'b00};
+              M_AXI_AWLEN <= {3'b000, BurstLen - 5'd1};
+              M_AXI_AWVALID <= 1'b1;
+              DmaState <= `DMA_STATE_ADDR;
+            end
+          end
+        end
+
+        `DMA_STATE_ADDR:
+        begin
+          if (M_AXI_AWREADY)
+          begin
+            M_AXI_AWVALID <= 1'b0;
+            BeatCount <= '0;
+            DmaState <= `DMA_STATE_DATA;
+          end
+        end
+
+        `DMA_STATE_DATA:
+        begin
+          if (M_AXI_WREADY)
+          begin
+            BeatCount <= BeatCount + 5'd1;
+            if (M_AXI_WLAST)
+              DmaState <= `DMA_STATE_RESP;
+          end
+        end
+
+        `DMA_STATE_RESP:
+        begin
+          if (M_AXI_BVALID)
+          begin
+            if (M_AXI_BRESP != 2'b00)
+              WriteError <= `TRUE;
+            // Advance the producer, wrapping at the ring end
+            if ((ProducerWord + BurstWords) == RingWords)
+              ProducerWord <= '0;
+            else
+              ProducerWord <= ProducerWord + BurstWords;
+            // Block interrupt every BlockWords
+            if ((BlockWords != '0) && ((BlockCount + BurstWords) >= BlockWords))
+            begin
+              BlockCount <= BlockCount + BurstWords - BlockWords;
+              BlockDone <= `TRUE;
+            end
+            else
+              BlockCount <= BlockCount + BurstWords;
+            WrotePending <= 1'b1;
+            DmaState <= `DMA_STATE_IDLE;
+          end
+        end
+
+        default: DmaState <= `DMA_STATE_IDLE;
+      endcase
+    end
+  end
+
+endmodule
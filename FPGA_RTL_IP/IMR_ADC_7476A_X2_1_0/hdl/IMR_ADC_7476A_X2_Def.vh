@@ -9,11 +9,23 @@
 `define FALSE               1'b0
 
 `define STATE_IDLE          3'd0  // waiting for start
-`define STATE_START         3'd1  // assert CS low, prime divider
+`define STATE_START         3'd1  // wait for a pending result to latch, CS high
 `define STATE_SHIFT         3'd2  // clock in 16-bit frame
-`define STATE_LATCH         3'd3  // move sample to registers
 `define STATE_QUIET         3'd4  // CS high quiet period (tQUIET)
-`define STATE_NEXT_CONV     3'd5  // prepare for next conversion in continuous mode
+`define STATE_NEXT_CONV     3'd5  // wait for the period tick / result latch in continuous mode
+
+// Trigger engine state encodings (TRIG_STATUS)
+`define TRIG_STATE_IDLE     2'd0  // disarmed - TRIG_EN set, samples are not stored
+`define TRIG_STATE_ARMED    2'd1  // FIFO holds the last PRE samples, holdoff then wait for the condition
+`define TRIG_STATE_POST     2'd2  // triggered - storing the POST samples
+`define TRIG_STATE_DONE     2'd3  // record complete in the FIFO, capture stopped
+
+// DMA writer FSM state encodings
+`define DMA_STATE_IDLE      3'd0  // waiting for a burst of samples and ring space
+`define DMA_STATE_FILL      3'd1  // pop the burst from the FIFO
+`define DMA_STATE_ADDR      3'd2  // AW handshake
+`define DMA_STATE_DATA      3'd3  // W beats
+`define DMA_STATE_RESP      3'd4  // B handshake, advance the producer
 
 //------------------------- Register Map (byte offsets) ------------------------
 `define REG_CTRL_OFFSET     32'h00  // Control
@@ -21,25 +33,137 @@
 `define REG_DATA_A_OFFSET   32'h08  // Latest sample
 `define REG_DATA_B_OFFSET   32'h0C  // Previous sample
 `define REG_IRQ_OFFSET      32'h10  // Interrupt 
+`define REG_FIFO_CTRL_OFFSET    32'h14  // Sample FIFO control
+`define REG_FIFO_STATUS_OFFSET  32'h18  // Sample FIFO occupancy and flags
+`define REG_FIFO_DATA_OFFSET    32'h1C  // Sample FIFO read port - each read pops one sample
+`define REG_DATA_AB_OFFSET      32'h20  // Both channels and a sequence number in one read
+`define REG_DMA_CTRL_OFFSET     32'h24  // DMA writer control
+`define REG_DMA_BASE_OFFSET     32'h28  // Ring start address (64 byte aligned)
+`define REG_DMA_SIZE_OFFSET     32'h2C  // Ring length in bytes (multiple of 64)
+`define REG_DMA_BLOCK_OFFSET    32'h30  // Bytes per block interrupt (0 = none)
+`define REG_DMA_PRODUCER_OFFSET 32'h34  // Byte offset of the next DMA write (read only)
+`define REG_DMA_CONSUMER_OFFSET 32'h38  // Byte offset software has consumed up to
+`define REG_SAMPLE_PERIOD_OFFSET 32'h3C // Conversion start period in SysClk cycles (0 = back to back)
+`define REG_TRIG_CTRL_OFFSET    32'h40  // Trigger enable, arm, force, source and mode
+`define REG_TRIG_LEVEL_OFFSET   32'h44  // Trigger level and hysteresis
+`define REG_TRIG_HOLDOFF_OFFSET 32'h48  // Samples after arming before a trigger is accepted
+`define REG_TRIG_RECORD_OFFSET  32'h4C  // Pre / post trigger sample counts
+`define REG_TRIG_STATUS_OFFSET  32'h50  // Trigger state and trigger position (read only)
+`define REG_CIC_CTRL_OFFSET     32'h54  // CIC decimator enable, order, ratio and output shift
 
 //----------------------------- CTRL bitfields ---------------------------------
 `define CTRL_EN_BIT         0   // enable engine
 `define CTRL_START_BIT      1   // write 1 = single-shot start pulse
 `define CTRL_CONT_BIT       2   // 0 = Single, 1 = continuous conversions
+`define CTRL_FREE_RUN_BIT   3   // With CONT: convert until START or EN is cleared, CONT_CNT ignored
 `define CTRL_CLKDIV_LSB     4   // SCLK divider field [7:4] - Total 4 bits
-`define CTRL_CLKDIV_MSB     7   // SCLK = SYSCLK / (2*(N+1)) - Total 4 bits
+`define CTRL_CLKDIV_MSB     7   // SCLK = SYSCLK / (2*N) - Total 4 bits (N = 0..2 run as 3, 20MHz max)
 `define CTRL_CONT_CNT_LSB   8   // Contineous Conversion Count LSB [19:8] - Total 12bits (4096 Max Conversions)
 `define CTRL_CONT_CNT_MSB   19  // Contineous Conversion Count MSB
+`define CTRL_CLKDIV_ODD_BIT 20  // 1 = SCLK = SYSCLK / (2*N - 1), high phase one SysClk shorter (N = 3: 20MHz)
 
 //----------------------------- IRQ bitfields ---------------------------------
 `define IRQ_EN_BIT          0   // enable the IRQ
-`define IRQ_CLR_BIT         1   // enable clear the pending irq
+`define IRQ_CLR_BIT         1   // write 1 = clear the pending irq (self-clearing - one write acknowledges)
+`define IRQ_AUTO_ACK_BIT    2   // 1 = reading DATA_AB also clears the pending irq
+`define IRQ_DONE_EN_BIT     3   // 1 = also interrupt on STATUS DONE - the end of a capture
+
+//--------------------------- FIFO_CTRL bitfields ------------------------------
+`define FIFO_CTRL_THRESH_LSB 0  // IRQ threshold [10:0] - samples in the FIFO (1 - 1024, 0 = threshold IRQ off)
+`define FIFO_CTRL_THRESH_MSB 10
+`define FIFO_CTRL_EN_BIT    16  // 1 = conversions go to the FIFO, IRQ on threshold / overflow / tail
+`define FIFO_CTRL_FLUSH_BIT 17  // write 1 = empty the FIFO and clear overflow (rising edge)
+
+//-------------------------- FIFO_STATUS bitfields ------------------------------
+`define FIFO_STATUS_COUNT_LSB   0   // Samples in the FIFO [10:0] (0 - 1024)
+`define FIFO_STATUS_COUNT_MSB   10
+`define FIFO_STATUS_THRESH_BIT  16  // Count >= threshold
+`define FIFO_STATUS_OVF_BIT     17  // Sample dropped, FIFO full (sticky - IRQ_CLR or flush)
+`define FIFO_STATUS_EMPTY_BIT   18
+`define FIFO_STATUS_FULL_BIT    19
+`define FIFO_STATUS_TAIL_BIT    20  // Engine idle with samples left - the end of a capture below threshold
+`define FIFO_STATUS_TRIG_BIT    21  // Triggered record complete (TRIG_STATUS DONE)
+`define FIFO_STATUS_DMA_LSB     24  // DMA writer flags [27:24]
+`define FIFO_STATUS_DMA_MSB     27
+`define FIFO_STATUS_DMA_BLOCK_BIT   24  // DMA_BLOCK bytes written since the last one (sticky - IRQ_CLR)
+`define FIFO_STATUS_DMA_ERR_BIT     25  // A burst got a SLVERR / DECERR response (sticky - IRQ_CLR)
+`define FIFO_STATUS_DMA_DONE_BIT    26  // Engine idle and every sample written (sticky - IRQ_CLR)
+`define FIFO_STATUS_DMA_STALL_BIT   27  // Ring full - waiting on DMA_CONSUMER
+
+//------------------------- SAMPLE_PERIOD bitfields ----------------------------
+`define SAMPLE_PERIOD_LSB   0   // SysClk cycles between conversion starts [23:0] - 0 = free paced (start after tQUIET)
+`define SAMPLE_PERIOD_MSB   23  // 100 MHz SysClk: 6 Hz to the conversion time limit
+
+//--------------------------- TRIG_CTRL bitfields ------------------------------
+`define TRIG_CTRL_EN_BIT    0   // 1 = FIFO samples are gated by the trigger engine (FIFO_EN must be set)
+`define TRIG_CTRL_ARM_BIT   1   // write 1 = flush the FIFO and arm (rising edge)
+`define TRIG_CTRL_FORCE_BIT 2   // write 1 = trigger on the next sample while armed (rising edge)
+`define TRIG_CTRL_SOURCE_BIT 3  // 0 = channel A, 1 = channel B
+`define TRIG_CTRL_MODE_LSB  4   // Trigger condition [5:4]
+`define TRIG_CTRL_MODE_MSB  5
+`define TRIG_MODE_ABOVE     2'd0  // level: sample >= LEVEL
+`define TRIG_MODE_RISING    2'd1  // rising edge: below LEVEL - HYST, then >= LEVEL
+`define TRIG_MODE_FALLING   2'd2  // falling edge: above LEVEL + HYST, then <= LEVEL
+`define TRIG_MODE_BELOW     2'd3  // level: sample <= LEVEL
+
+//-------------------------- TRIG_LEVEL bitfields ------------------------------
+`define TRIG_LEVEL_LSB      0   // Trigger level [11:0] in ADC codes
+`define TRIG_LEVEL_MSB      11
+`define TRIG_HYST_LSB       16  // Edge re-arm hysteresis [27:16] in ADC codes
+`define TRIG_HYST_MSB       27
+
+//------------------------- TRIG_HOLDOFF / RECORD ------------------------------
+`define TRIG_HOLDOFF_LSB    0   // Samples after arming before a trigger is accepted [23:0] (never less than PRE)
+`define TRIG_HOLDOFF_MSB    23
+`define TRIG_PRE_LSB        0   // Samples kept before the trigger [10:0]
+`define TRIG_PRE_MSB        10
+`define TRIG_POST_LSB       16  // Samples stored from the trigger sample on [26:16] (0 = 1), PRE + POST <= FIFO_DEPTH
+`define TRIG_POST_MSB       26
+
+//-------------------------- TRIG_STATUS bitfields -----------------------------
+`define TRIG_STATUS_INDEX_LSB   0   // Record index of the trigger sample = pre trigger samples stored [10:0]
+`define TRIG_STATUS_INDEX_MSB   10
+`define TRIG_STATUS_STATE_LSB   16  // TRIG_STATE_* [17:16]
+`define TRIG_STATUS_STATE_MSB   17
+`define TRIG_STATUS_DONE_BIT    20  // Record complete (sticky - IRQ_CLR or ARM)
+
+//--------------------------- DMA_CTRL bitfields -------------------------------
+`define DMA_CTRL_EN_BIT     0   // 1 = the DMA writer drains the FIFO into the ring (FIFO_EN must be set)
+`define DMA_CTRL_RESET_BIT  1   // 1 = rewind the producer and clear the flags (held while set)
+
+//--------------------------- FIFO data word -----------------------------------
+// [31:24] reserved (0), [23:12] channel A, [11:0] channel B
+// CIC decimating: [31:16] channel A, [15:0] channel B (16 bit decimated samples)
+`define FIFO_WORD_A_LSB     12
+`define FIFO_WORD_B_LSB     0
+`define FIFO_CIC_A_LSB      16
+`define FIFO_CIC_B_LSB      0
+
+//--------------------------- CIC_CTRL bitfields -------------------------------
+`define CIC_CTRL_EN_BIT     0   // 1 = continuous captures are decimated, 0 = bypass (single conversions always bypass)
+`define CIC_CTRL_ORDER_LSB  4   // Order - 1 [5:4] - 1 to 4 integrator / comb stages
+`define CIC_CTRL_ORDER_MSB  5
+`define CIC_CTRL_RATIO_LSB  8   // Decimation ratio - 1 [15:8] - R = 1 to 256 conversions per output
+`define CIC_CTRL_RATIO_MSB  15
+`define CIC_CTRL_SHIFT_LSB  16  // Output right shift [20:16] - bit growth dropped to a 16 bit sample (saturates)
+`define CIC_CTRL_SHIFT_MSB  20
+
+//--------------------------- DATA_AB bitfields --------------------------------
+// Latched the first clock the result may be (LatchNow) - at frame end with the FIFO on, once
+// the last result is acknowledged with it off - and stable until the next latch
+// CIC decimating: laid out as the FIFO word, no sequence number
+`define DATA_AB_SEQ_LSB     24  // Conversion sequence number [31:24] (wraps)
+`define DATA_AB_SEQ_MSB     31
+`define DATA_AB_A_LSB       12  // Channel A [23:12]
+`define DATA_AB_B_LSB       0   // Channel B [11:0]
 
 //---------------------------- STATUS bitfields --------------------------------
 `define STATUS_BUSY_BIT     0   // 1 = converting
-`define STATUS_RDY_BIT      1   // 1 = new sample available (sticky)
+`define STATUS_RDY_BIT      1   // 1 = new sample available (sticky, FIFO disabled only)
 `define STATUS_ERR_LSB      2   // Error detected 3 bits 
 `define STATUS_ERR_MSB      4   // Error detected 3 bits
+`define STATUS_OVERRUN_BIT  5   // 1 = a continuous capture missed a period tick (sticky - IRQ_CLR or next capture)
+`define STATUS_DONE_BIT     6   // 1 = the capture has ended, every result latched (sticky - IRQ_CLR or next capture)
 `define STATUS_STATE_LSB    8   // Present State 3 bits
 `define STATUS_STATE_MSB    10  // Present State 3 bits
 
@@ -56,6 +180,16 @@
 `define ADC_BITS            12  // AD7476A resolution
 `define FRAME_CLKS          16  // 16 SCLKs per conversion frame
 
+//------------------------------ Sample FIFO -----------------------------------
+`define FIFO_ADDR_BITS      10  // 1024 x 32 - one RAMB36
+`define FIFO_DEPTH          (1 << `FIFO_ADDR_BITS)
+`define DMA_BURST_WORDS     16  // 64 byte bursts - ring base aligned so a burst never crosses 4KB
+
+//------------------------------ CIC decimator ---------------------------------
+`define CIC_MAX_ORDER       4
+`define CIC_WIDTH           44  // ADC_BITS + CIC_MAX_ORDER * log2(256) - integrators wrap without loss
+`define CIC_OUT_BITS        16
+
 // tQUIET >= 50 ns.  With 100 MHz SYSCLK (10 ns), 5 cycles meet min.  Use 6.
 `define QUIET_SYS_CLKS      6
 
@@ -11,7 +11,9 @@
 		// Width of S_AXI data bus
 		parameter integer C_S_AXI_DATA_WIDTH	= 32,
 		// Width of S_AXI address bus
-		parameter integer C_S_AXI_ADDR_WIDTH	= 5
+		parameter integer C_S_AXI_ADDR_WIDTH	= 7,
+		// Width of the DMA writer M_AXI address bus (Hab user parameter)
+		parameter integer C_M_AXI_ADDR_WIDTH	= 32
 	)
 	(
 		// Users to add ports here
@@ -21,6 +23,24 @@
 		input  wire ADC_MISO_A,
 		input  wire ADC_MISO_B,
 		output wire IRQ,
+		// DMA writer AXI4 master (write only) - passed up to M00_AXI
+		output wire [C_M_AXI_ADDR_WIDTH-1 : 0] M_AXI_AWADDR,
+		output wire [7 : 0] M_AXI_AWLEN,
+		output wire [2 : 0] M_AXI_AWSIZE,
+		output wire [1 : 0] M_AXI_AWBURST,
+		output wire  M_AXI_AWLOCK,
+		output wire [3 : 0] M_AXI_AWCACHE,
+		output wire [2 : 0] M_AXI_AWPROT,
+		output wire  M_AXI_AWVALID,
+		input  wire  M_AXI_AWREADY,
+		output wire [31 : 0] M_AXI_WDATA,
+		output wire [3 : 0] M_AXI_WSTRB,
+		output wire  M_AXI_WLAST,
+		output wire  M_AXI_WVALID,
+		input  wire  M_AXI_WREADY,
+		input  wire [1 : 0] M_AXI_BRESP,
+		input  wire  M_AXI_BVALID,
+		output wire  M_AXI_BREADY,
 		// User ports ends
 		// Do not modify the ports beyond this line
 
@@ -103,16 +123,43 @@
 	// ADDR_LSB = 2 for 32 bits (n downto 2)
 	// ADDR_LSB = 3 for 64 bits (n downto 3)
 	localparam integer ADDR_LSB = (C_S_AXI_DATA_WIDTH/32) + 1;
-	localparam integer OPT_MEM_ADDR_BITS = 3; // Hab consider making this a global parameter
+	localparam integer OPT_MEM_ADDR_BITS = C_S_AXI_ADDR_WIDTH - ADDR_LSB; // Hab register index width follows the address width
 	//----------------------------------------------
 	//-- Signals for user logic register space example
 	//------------------------------------------------
-	//-- Number of Slave Registers 5
+	//-- Number of Slave Registers 22
 	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg0;
 	wire [C_S_AXI_DATA_WIDTH-1:0]	slv_reg1;
 	wire [C_S_AXI_DATA_WIDTH-1:0]	slv_reg2;
 	wire [C_S_AXI_DATA_WIDTH-1:0]	slv_reg3;
 	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg4;
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg5;	// FIFO_CTRL
+	wire [C_S_AXI_DATA_WIDTH-1:0]	slv_reg6;	// FIFO_STATUS
+	wire [C_S_AXI_DATA_WIDTH-1:0]	slv_reg7;	// FIFO_DATA - read pops
+	wire [C_S_AXI_DATA_WIDTH-1:0]	slv_reg8;	// DATA_AB - read may acknowledge the IRQ
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg9;	// DMA_CTRL
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg10;	// DMA_BASE
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg11;	// DMA_SIZE
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg12;	// DMA_BLOCK
+	wire [C_S_AXI_DATA_WIDTH-1:0]	slv_reg13;	// DMA_PRODUCER
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg14;	// DMA_CONSUMER
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg15;	// SAMPLE_PERIOD
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg16;	// TRIG_CTRL
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg17;	// TRIG_LEVEL
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg18;	// TRIG_HOLDOFF
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg19;	// TRIG_RECORD
+	wire [C_S_AXI_DATA_WIDTH-1:0]	slv_reg20;	// TRIG_STATUS
+	reg [C_S_AXI_DATA_WIDTH-1:0]	slv_reg21;	// CIC_CTRL
+	wire	fifo_pop;
+	wire	data_ab_read;
+	// Core / DMA writer interconnect
+	wire [C_S_AXI_DATA_WIDTH-1:0]	core_fifo_status;
+	wire [3:0]	dma_status;
+	wire	dma_fifo_pop;
+	wire	dma_enable;
+	wire	core_fifo_hold;
+	wire	dma_irq;
+	wire	core_irq;
 	integer	 byte_index;
 
 	// I/O Connections assignments
@@ -241,70 +288,171 @@
 	    //   slv_reg2 <= 0;
 	    //   slv_reg3 <= 0;
 	      slv_reg4 <= 0;
+	      slv_reg5 <= 0;
+	      slv_reg9 <= 0;
+	      slv_reg10 <= 0;
+	      slv_reg11 <= 0;
+	      slv_reg12 <= 0;
+	      slv_reg14 <= 0;
+	      slv_reg15 <= 0;
+	      slv_reg16 <= 0;
+	      slv_reg17 <= 0;
+	      slv_reg18 <= 0;
+	      slv_reg19 <= 0;
+	      slv_reg21 <= 0;
 	    end 
 	  else begin
+	    // Hab IRQ Clear self-clears: a write of 1 is a one clock pulse, a write below in the same clock wins
+	    slv_reg4[1] <= 1'b0;
 	    if (S_AXI_WVALID)
 	      begin
 	        case ( (S_AXI_AWVALID) ? S_AXI_AWADDR[ADDR_LSB+OPT_MEM_ADDR_BITS-1:ADDR_LSB] : axi_awaddr[ADDR_LSB+OPT_MEM_ADDR_BITS-1:ADDR_LSB] )
-	          3'h0:
+	          5'h00:
 	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
 	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
 	                // Respective byte enables are asserted as per write strobes 
 	                // Slave register 0
 	                slv_reg0[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
 	              end  
-	          3'h1:
+	          5'h01:
 	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
 	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
 	                // Respective byte enables are asserted as per write strobes 
 	                // Slave register 1
 	                // slv_reg1[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8]; Hab comment out to make read-only
 	              end  
-	          3'h2:
+	          5'h02:
 	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
 	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
 	                // Respective byte enables are asserted as per write strobes 
 	                // Slave register 2
 	                // slv_reg2[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
 	              end  
-	          3'h3:
+	          5'h03:
 	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
 	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
 	                // Respective byte enables are asserted as per write strobes 
 	                // Slave register 3
 	                // slv_reg3[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8]; 
 	              end  
-	          3'h4:
+	          5'h04:
 	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
 	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
 	                // Respective byte enables are asserted as per write strobes 
 	                // Slave register 4
 	                slv_reg4[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
 				  end
+	          5'h05:
+	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
+	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
+	                // Respective byte enables are asserted as per write strobes 
+	                // Slave register 5 (FIFO_CTRL)
+	                slv_reg5[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
+				  end
+	          // 5'h06 FIFO_STATUS, 5'h07 FIFO_DATA, 5'h08 DATA_AB: read-only
+	          5'h09:
+	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
+	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
+	                // Respective byte enables are asserted as per write strobes 
+	                // Slave register 9 (DMA_CTRL)
+	                slv_reg9[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
+				  end
+	          5'h0A:
+	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
+	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
+	                // Respective byte enables are asserted as per write strobes 
+	                // Slave register 10 (DMA_BASE)
+	                slv_reg10[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
+				  end
+	          5'h0B:
+	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
+	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
+	                // Respective byte enables are asserted as per write strobes 
+	                // Slave register 11 (DMA_SIZE)
+	                slv_reg11[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
+				  end
+	          5'h0C:
+	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
+	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
+	                // Respective byte enables are asserted as per write strobes 
+	                // Slave register 12 (DMA_BLOCK)
+	                slv_reg12[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
+				  end
+	          // 5'h0D DMA_PRODUCER: read-only
+	          5'h0E:
+	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
+	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
+	                // Respective byte enables are asserted as per write strobes 
+	                // Slave register 14 (DMA_CONSUMER)
+	                slv_reg14[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
+				  end
+	          5'h0F:
+	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
+	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
+	                // Respective byte enables are asserted as per write strobes 
+	                // Slave register 15 (SAMPLE_PERIOD)
+	                slv_reg15[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
+				  end
+	          5'h10:
+	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
+	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
+	                // Respective byte enables are asserted as per write strobes 
+	                // Slave register 16 (TRIG_CTRL)
+	                slv_reg16[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
+				  end
+	          5'h11:
+	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
+	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
+	                // Respective byte enables are asserted as per write strobes 
+	                // Slave register 17 (TRIG_LEVEL)
+	                slv_reg17[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
+				  end
+	          5'h12:
+	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
+	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
+	                // Respective byte enables are asserted as per write strobes 
+	                // Slave register 18 (TRIG_HOLDOFF)
+	                slv_reg18[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
+				  end
+	          5'h13:
+	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
+	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
+	                // Respective byte enables are asserted as per write strobes 
+	                // Slave register 19 (TRIG_RECORD)
+	                slv_reg19[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
+				  end
+	          // 5'h14 TRIG_STATUS: read-only
+	          5'h15:
+	            for ( byte_index = 0; byte_index <= (C_S_AXI_DATA_WIDTH/8)-1; byte_index = byte_index+1 )
+	              if ( S_AXI_WSTRB[byte_index] == 1 ) begin
+	                // Respective byte enables are asserted as per write strobes 
+	                // Slave register 21 (CIC_CTRL)
+	                slv_reg21[(byte_index*8) +: 8] <= S_AXI_WDATA[(byte_index*8) +: 8];
+				  end
 	          default : begin
 	                      slv_reg0 <= slv_reg0;
 	                    //   slv_reg1 <= slv_reg1;
 	                    //   slv_reg2 <= slv_reg2;
 	                    //   slv_reg3 <= slv_reg3;
-	                      slv_reg4 <= slv_reg4;
+	                    //   slv_reg4 holds - not assigned here so the IRQ Clear self-clear above applies
+	                      slv_reg5 <= slv_reg5;
+	                      slv_reg9 <= slv_reg9;
+	                      slv_reg10 <= slv_reg10;
+	                      slv_reg11 <= slv_reg11;
+	                      slv_reg12 <= slv_reg12;
+	                      slv_reg14 <= slv_reg14;
+	                      slv_reg15 <= slv_reg15;
+	                      slv_reg16 <= slv_reg16;
+	                      slv_reg17 <= slv_reg17;
+	                      slv_reg18 <= slv_reg18;
+	                      slv_reg19 <= slv_reg19;
+	                      slv_reg21 <= slv_reg21;
 	                    end
 	        endcase
 	      end
 	  end
 	end    
 
-	// Hab Added this always block to self-clear IRQ Clear bit if set outside of write
-	// always @(posedge S_AXI_ACLK)
-	// begin
-	//   if ( S_AXI_ARESETN == 1'b0 ) begin
-	//       slv_reg4[1] <= 1'b0; // Clear IRQ Clear bit on reset
-	//   end else begin
-	//       if (slv_reg4[1]) begin
-	//           slv_reg4[1] <= 1'b0; // Clear IRQ Clear bit after write
-	//       end
-	//   end
-	// end
-
 	// Hab Added this always block to self-clear Control Start bit if set outside of write
 	// reg StartBitDelay;
 	// always @(posedge S_AXI_ACLK)
@@ -388,8 +536,58 @@
 	           endcase                                       
 	          end                                       
 	        end                                         
+	// Hab FIFO_DATA / DATA_AB read side-effects: pop / acknowledge on the address handshake - the core registers the
+	// popped word on the same edge axi_araddr is latched, so it is on RDATA with RVALID
+	assign fifo_pop = (state_read == Raddr) && S_AXI_ARVALID && axi_arready && (S_AXI_ARADDR[ADDR_LSB+OPT_MEM_ADDR_BITS-1:ADDR_LSB] == 5'h07);
+	assign data_ab_read = (state_read == Raddr) && S_AXI_ARVALID && axi_arready && (S_AXI_ARADDR[ADDR_LSB+OPT_MEM_ADDR_BITS-1:ADDR_LSB] == 5'h08);
+
 	// Implement memory mapped register select and read logic generation
-	  assign S_AXI_RDATA = (axi_araddr[ADDR_LSB+OPT_MEM_ADDR_BITS-1:ADDR_LSB] == 3'h0) ? slv_reg0 : (axi_araddr[ADDR_LSB+OPT_MEM_ADDR_BITS-1:ADDR_LSB] == 3'h1) ? slv_reg1 : (axi_araddr[ADDR_LSB+OPT_MEM_ADDR_BITS-1:ADDR_LSB] == 3'h2) ? slv_reg2 : (axi_araddr[ADDR_LSB+OPT_MEM_ADDR_BITS-1:ADDR_LSB] == 3'h3) ? slv_reg3 : (axi_araddr[ADDR_LSB+OPT_MEM_ADDR_BITS-1:ADDR_LSB] == 3'h4) ? slv_reg4 : 0; 
+	reg [C_S_AXI_DATA_WIDTH-1:0] reg_data_out;
+	always @(*)
+	begin
+	  case ( axi_araddr[ADDR_LSB+OPT_MEM_ADDR_BITS-1:ADDR_LSB] )
+	    5'h00    : reg_data_out = slv_reg0;
+	    5'h01    : reg_data_out = slv_reg1;
+	    5'h02    : reg_data_out = slv_reg2;
+	    5'h03    : reg_data_out = slv_reg3;
+	    5'h04    : reg_data_out = slv_reg4;
+	    5'h05    : reg_data_out = slv_reg5;
+	    5'h06    : reg_data_out = slv_reg6;
+	    5'h07    : reg_data_out = slv_reg7;
+	    5'h08    : reg_data_out = slv_reg8;
+	    5'h09    : reg_data_out = slv_reg9;
+	    5'h0A    : reg_data_out = slv_reg10;
+	    5'h0B    : reg_data_out = slv_reg11;
+	    5'h0C    : reg_data_out = slv_reg12;
+	    5'h0D    : reg_data_out = slv_reg13;
+	    5'h0E    : reg_data_out = slv_reg14;
+	    5'h0F    : reg_data_out = slv_reg15;
+	    5'h10    : reg_data_out = slv_reg16;
+	    5'h11    : reg_data_out = slv_reg17;
+	    5'h12    : reg_data_out = slv_reg18;
+	    5'h13    : reg_data_out = slv_reg19;
+	    5'h14    : reg_data_out = slv_reg20;
+	    5'h15    : reg_data_out = slv_reg21;
+	    default : reg_data_out = 0;
+	  endcase
+	end
+	// Hab RDATA is the live register in the first RVALID clock, then held until the handshake - with RREADY held off
+	// by the interconnect a DATA_AB acknowledge would latch the waiting result (and STATUS / counts move) mid read
+	reg [C_S_AXI_DATA_WIDTH-1:0] axi_rdata_hold;
+	reg  	axi_rdata_held;
+	always @(posedge S_AXI_ACLK)
+	begin
+	  if (S_AXI_ARESETN == 1'b0)
+	    axi_rdata_held <= 1'b0;
+	  else if (S_AXI_RVALID && S_AXI_RREADY)
+	    axi_rdata_held <= 1'b0;
+	  else if (S_AXI_RVALID && !axi_rdata_held)
+	    begin
+	      axi_rdata_hold <= reg_data_out;
+	      axi_rdata_held <= 1'b1;
+	    end
+	end
+	assign S_AXI_RDATA = axi_rdata_held ? axi_rdata_hold : reg_data_out;
 	// Add user logic here
 	IMR_ADC_7476A_X2_Core u_adc_core 
 	(
@@ -400,11 +598,33 @@
 		// Control + IRQ enable from AXI regs
 		.Ctrl_Register(slv_reg0),
 		.IRQ_Register(slv_reg4),
+		.Sample_Period_Register(slv_reg15),
 
 		// Readback to AXI (STATUS / DATA_A / DATA_B)
 		.Status_Register(slv_reg1),
 		.ADC_Data_A_Register(slv_reg2),
 		.ADC_Data_B_Register(slv_reg3),
+		.ADC_Data_AB_Register(slv_reg8),
+		.DataAB_Read(data_ab_read),
+
+		// Sample FIFO
+		.FIFO_Ctrl_Register(slv_reg5),
+		.FIFO_Status_Register(core_fifo_status),
+		.FIFO_Data_Register(slv_reg7),
+		.FIFO_Pop(fifo_pop),
+		.FIFO_DMA_Pop(dma_fifo_pop),
+		.DMA_Enable(dma_enable),
+		.FIFO_DMA_Hold(core_fifo_hold),
+
+		// Trigger engine
+		.Trig_Ctrl_Register(slv_reg16),
+		.Trig_Level_Register(slv_reg17),
+		.Trig_Holdoff_Register(slv_reg18),
+		.Trig_Record_Register(slv_reg19),
+		.Trig_Status_Register(slv_reg20),
+
+		// CIC decimator
+		.Cic_Ctrl_Register(slv_reg21),
 
 		// External ADC pins
 		.MISO_A(ADC_MISO_A),
@@ -413,8 +633,63 @@
 		.CS_n(ADC_CS_n),
 
 		// Interrupt to system
-		.IP_IRQ(IRQ)
+		.IP_IRQ(core_irq)
+	);
+
+	// DMA writer: FIFO to a memory ring over M_AXI
+	IMR_ADC_7476A_X2_DMA_Writer #
+	(
+		.C_M_AXI_ADDR_WIDTH(C_M_AXI_ADDR_WIDTH),
+		.C_M_AXI_DATA_WIDTH(32)
+	) u_adc_dma
+	(
+		// Clock / Reset
+		.SysClk(S_AXI_ACLK),
+		.RST_n(S_AXI_ARESETN),
+
+		// Ring descriptor and control
+		.DMA_Ctrl_Register(slv_reg9),
+		.DMA_Base_Register(slv_reg10),
+		.DMA_Size_Register(slv_reg11),
+		.DMA_Block_Register(slv_reg12),
+		.DMA_Consumer_Register(slv_reg14),
+		.DMA_Producer_Register(slv_reg13),
+		.DMA_Status(dma_status),
+		.DMA_Enable(dma_enable),
+
+		// Interrupt - shares the IRQ register enable / clear
+		.IRQ_Clear(slv_reg4[1]),
+		.DMA_IRQ(dma_irq),
+
+		// Core sample FIFO - an armed trigger keeps the record in the FIFO until it is complete
+		.FifoCount(core_fifo_hold ? 11'd0 : core_fifo_status[10:0]),
+		.EngineBusy(slv_reg1[0]),
+		.FifoPop(dma_fifo_pop),
+		.FifoData(slv_reg7),
+
+		// AXI4 master write channels
+		.M_AXI_AWADDR(M_AXI_AWADDR),
+		.M_AXI_AWLEN(M_AXI_AWLEN),
+		.M_AXI_AWSIZE(M_AXI_AWSIZE),
+		.M_AXI_AWBURST(M_AXI_AWBURST),
+		.M_AXI_AWLOCK(M_AXI_AWLOCK),
+		.M_AXI_AWCACHE(M_AXI_AWCACHE),
+		.M_AXI_AWPROT(M_AXI_AWPROT),
+		.M_AXI_AWVALID(M_AXI_AWVALID),
+		.M_AXI_AWREADY(M_AXI_AWREADY),
+		.M_AXI_WDATA(M_AXI_WDATA),
+		.M_AXI_WSTRB(M_AXI_WSTRB),
+		.M_AXI_WLAST(M_AXI_WLAST),
+		.M_AXI_WVALID(M_AXI_WVALID),
+		.M_AXI_WREADY(M_AXI_WREADY),
+		.M_AXI_BRESP(M_AXI_BRESP),
+		.M_AXI_BVALID(M_AXI_BVALID),
+		.M_AXI_BREADY(M_AXI_BREADY)
 	);
+
+	// FIFO_STATUS[27:24] carries the DMA flags, one IRQ line for both (IRQ_EN gates the DMA events too)
+	assign slv_reg6 = core_fifo_status | {4'b0000, dma_status, 24'd0};
+	assign IRQ = core_irq | (slv_reg4[0] & dma_irq);
 	// User logic ends
 
 	endmodule
@@ -150,6 +150,7 @@ xilinx.com:ip:xlslice:1.0\
 xilinx.com:ip:axi_quad_spi:3.2\
 xilinx.com:ip:mig_7series:4.2\
 IMR:user:IMR_PL_Revision:1.0\
+IMR:user:IMR_ADC_7476A_X2:1.0\
 xilinx.com:ip:lmb_v10:3.0\
 xilinx.com:ip:lmb_bram_if_cntlr:4.0\
 xilinx.com:ip:blk_mem_gen:8.4\
@@ -487,6 +488,11 @@ proc create_root_design { parentCell } {
   set USD_CSn [ create_bd_port -dir O -from 0 -to 0 USD_CSn ]
   set USD_SCLK [ create_bd_port -dir O USD_SCLK ]
   set USD_CD [ create_bd_port -dir I USD_CD ]
+  set ADC_SCLK [ create_bd_port -dir O ADC_SCLK ]
+  set ADC_CS_n [ create_bd_port -dir O ADC_CS_n ]
+  set ADC_MISO_A [ create_bd_port -dir I ADC_MISO_A ]
+  set ADC_MISO_B [ create_bd_port -dir I ADC_MISO_B ]
+  set ADC_IP_IRQ [ create_bd_port -dir O ADC_IP_IRQ ]
 
   # Create instance: microblaze_0, and set properties
   set microblaze_0 [ create_bd_cell -type ip -vlnv xilinx.com:ip:microblaze:11.0 microblaze_0 ]
@@ -559,7 +565,7 @@ proc create_root_design { parentCell } {
   # Create instance: smartconnect_CPU, and set properties
   set smartconnect_CPU [ create_bd_cell -type ip -vlnv xilinx.com:ip:smartconnect:1.0 smartconnect_CPU ]
   set_property -dict [list \
-    CONFIG.NUM_MI {8} \
+    CONFIG.NUM_MI {9} \
     CONFIG.NUM_SI {3} \
   ] $smartconnect_CPU
 
@@ -637,8 +643,9 @@ proc create_root_design { parentCell } {
   # Create instance: smartconnect_DDR3, and set properties
   set smartconnect_DDR3 [ create_bd_cell -type ip -vlnv xilinx.com:ip:smartconnect:1.0 smartconnect_DDR3 ]
   set_property -dict [list \
+    CONFIG.NUM_CLKS {2} \
     CONFIG.NUM_MI {2} \
-    CONFIG.NUM_SI {1} \
+    CONFIG.NUM_SI {2} \
   ] $smartconnect_DDR3
 
 
@@ -683,7 +690,11 @@ proc create_root_design { parentCell } {
   # Create instance: IMR_PL_Revision_0, and set properties
   set IMR_PL_Revision_0 [ create_bd_cell -type ip -vlnv IMR:user:IMR_PL_Revision:1.0 IMR_PL_Revision_0 ]
 
+  # Create instance: IMR_ADC_7476A_X2_0, and set properties
+  set IMR_ADC_7476A_X2_0 [ create_bd_cell -type ip -vlnv IMR:user:IMR_ADC_7476A_X2:1.0 IMR_ADC_7476A_X2_0 ]
+
   # Create interface connections
+  connect_bd_intf_net -intf_net IMR_ADC_7476A_X2_0_M00_AXI [get_bd_intf_pins IMR_ADC_7476A_X2_0/M00_AXI] [get_bd_intf_pins smartconnect_DDR3/S01_AXI]
   connect_bd_intf_net -intf_net axi_clock_converter_0_M_AXI [get_bd_intf_pins axi_clock_converter_0/M_AXI] [get_bd_intf_pins smartconnect_DDR3/S00_AXI]
   connect_bd_intf_net -intf_net axi_intc_0_interrupt [get_bd_intf_pins axi_intc_0/interrupt] [get_bd_intf_pins microblaze_0/INTERRUPT]
   connect_bd_intf_net -intf_net microblaze_0_M_AXI_DC [get_bd_intf_pins microblaze_0/M_AXI_DC] [get_bd_intf_pins smartconnect_CPU/S01_AXI]
@@ -702,12 +713,24 @@ proc create_root_design { parentCell } {
   connect_bd_intf_net -intf_net smartconnect_CPU_M05_AXI [get_bd_intf_pins smartconnect_CPU/M05_AXI] [get_bd_intf_pins axi_quad_spi_1/AXI_LITE]
   connect_bd_intf_net -intf_net smartconnect_CPU_M06_AXI [get_bd_intf_pins smartconnect_CPU/M06_AXI] [get_bd_intf_pins axi_clock_converter_0/S_AXI]
   connect_bd_intf_net -intf_net smartconnect_CPU_M07_AXI [get_bd_intf_pins smartconnect_CPU/M07_AXI] [get_bd_intf_pins IMR_PL_Revision_0/S00_AXI]
+  connect_bd_intf_net -intf_net smartconnect_CPU_M08_AXI [get_bd_intf_pins smartconnect_CPU/M08_AXI] [get_bd_intf_pins IMR_ADC_7476A_X2_0/S00_AXI]
 
   # Create port connections
+  connect_bd_net -net ADC_MISO_A_1  [get_bd_ports ADC_MISO_A] \
+  [get_bd_pins IMR_ADC_7476A_X2_0/ADC_MISO_A]
+  connect_bd_net -net ADC_MISO_B_1  [get_bd_ports ADC_MISO_B] \
+  [get_bd_pins IMR_ADC_7476A_X2_0/ADC_MISO_B]
   connect_bd_net -net CLK_100MHZ_1  [get_bd_ports CLK_100MHZ] \
   [get_bd_pins util_ds_buf_0/BUFG_I]
   connect_bd_net -net DISPLAY_MISO_1  [get_bd_ports DISPLAY_MISO] \
   [get_bd_pins axi_quad_spi_0/io1_i]
+  connect_bd_net -net IMR_ADC_7476A_X2_0_ADC_CS_n  [get_bd_pins IMR_ADC_7476A_X2_0/ADC_CS_n] \
+  [get_bd_ports ADC_CS_n]
+  connect_bd_net -net IMR_ADC_7476A_X2_0_ADC_SCLK  [get_bd_pins IMR_ADC_7476A_X2_0/ADC_SCLK] \
+  [get_bd_ports ADC_SCLK]
+  connect_bd_net -net IMR_ADC_7476A_X2_0_IRQ  [get_bd_pins IMR_ADC_7476A_X2_0/IRQ] \
+  [get_bd_pins xlconcat_1/In1] \
+  [get_bd_ports ADC_IP_IRQ]
   connect_bd_net -net PB_1_1  [get_bd_ports PB_1] \
   [get_bd_pins xlconcat_0/In2]
   connect_bd_net -net PB_2_1  [get_bd_ports PB_2] \
@@ -771,7 +794,9 @@ proc create_root_design { parentCell } {
   [get_bd_pins axi_quad_spi_0/s_axi_aclk] \
   [get_bd_ports MB_CLK] \
   [get_bd_pins axi_quad_spi_1/s_axi_aclk] \
-  [get_bd_pins IMR_PL_Revision_0/s00_axi_aclk]
+  [get_bd_pins IMR_PL_Revision_0/s00_axi_aclk] \
+  [get_bd_pins IMR_ADC_7476A_X2_0/s00_axi_aclk] \
+  [get_bd_pins smartconnect_DDR3/aclk1]
   connect_bd_net -net mig_7series_0_init_calib_complete  [get_bd_pins mig_7series_0/init_calib_complete] \
   [get_bd_ports LED_4] \
   [get_bd_pins proc_sys_reset_CPU/aux_reset_in] \
@@ -797,7 +822,8 @@ proc create_root_design { parentCell } {
   [get_bd_pins axi_intc_0/s_axi_aresetn] \
   [get_bd_pins axi_quad_spi_0/s_axi_aresetn] \
   [get_bd_pins axi_quad_spi_1/s_axi_aresetn] \
-  [get_bd_pins IMR_PL_Revision_0/s00_axi_aresetn]
+  [get_bd_pins IMR_PL_Revision_0/s00_axi_aresetn] \
+  [get_bd_pins IMR_ADC_7476A_X2_0/s00_axi_aresetn]
   connect_bd_net -net rst_clk_wiz_1_100M_bus_struct_reset  [get_bd_pins proc_sys_reset_CPU/bus_struct_reset] \
   [get_bd_pins microblaze_0_local_memory/SYS_Rst]
   connect_bd_net -net rst_clk_wiz_1_100M_mb_reset  [get_bd_pins proc_sys_reset_CPU/mb_reset] \
@@ -820,14 +846,15 @@ proc create_root_design { parentCell } {
   connect_bd_net -net xlconstant_0_dout  [get_bd_pins xlconstant_0/dout] \
   [get_bd_pins proc_sys_reset_DDR3/mb_debug_sys_rst]
   connect_bd_net -net xlconstant_1_dout  [get_bd_pins xlconstant_1/dout] \
-  [get_bd_pins xlconcat_1/In0] \
-  [get_bd_pins xlconcat_1/In1]
+  [get_bd_pins xlconcat_1/In0]
   connect_bd_net -net xlconstant_3_dout  [get_bd_pins xlconstant_3/dout] \
   [get_bd_pins xlconcat_0/In7]
   connect_bd_net -net xlslice_0_Dout  [get_bd_pins xlslice_0/Dout] \
   [get_bd_ports ADC_IRQ_DONE]
 
   # Create address segments
+  assign_bd_address -offset 0x80000000 -range 0x10000000 -target_address_space [get_bd_addr_spaces IMR_ADC_7476A_X2_0/M00_AXI] [get_bd_addr_segs mig_7series_0/memmap/memaddr] -force
+  assign_bd_address -offset 0x44A20000 -range 0x00000080 -target_address_space [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs IMR_ADC_7476A_X2_0/S00_AXI/S00_AXI_reg] -force
   assign_bd_address -offset 0x40000000 -range 0x00010000 -target_address_space [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs axi_gpio_0/S_AXI/Reg] -force
   assign_bd_address -offset 0x41200000 -range 0x00010000 -target_address_space [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs axi_intc_0/S_AXI/Reg] -force
   assign_bd_address -offset 0x44A10000 -range 0x00010000 -target_address_space [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs axi_quad_spi_0/AXI_LITE/Reg] -force
@@ -836,6 +863,7 @@ proc create_root_design { parentCell } {
   assign_bd_address -offset 0x40600000 -range 0x00010000 -target_address_space [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs axi_uartlite_0/S_AXI/Reg] -force
   assign_bd_address -offset 0x00000000 -range 0x00008000 -target_address_space [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs microblaze_0_local_memory/dlmb_bram_if_cntlr/SLMB/Mem] -force
   assign_bd_address -offset 0x80000000 -range 0x10000000 -target_address_space [get_bd_addr_spaces microblaze_0/Data] [get_bd_addr_segs mig_7series_0/memmap/memaddr] -force
+  assign_bd_address -offset 0x44A20000 -range 0x00000080 -target_address_space [get_bd_addr_spaces microblaze_0/Instruction] [get_bd_addr_segs IMR_ADC_7476A_X2_0/S00_AXI/S00_AXI_reg] -force
   assign_bd_address -offset 0x40000000 -range 0x00010000 -target_address_space [get_bd_addr_spaces microblaze_0/Instruction] [get_bd_addr_segs axi_gpio_0/S_AXI/Reg] -force
   assign_bd_address -offset 0x41200000 -range 0x00010000 -target_address_space [get_bd_addr_spaces microblaze_0/Instruction] [get_bd_addr_segs axi_intc_0/S_AXI/Reg] -force
   assign_bd_address -offset 0x44A10000 -range 0x00010000 -target_address_space [get_bd_addr_spaces microblaze_0/Instruction] [get_bd_addr_segs axi_quad_spi_0/AXI_LITE/Reg] -force
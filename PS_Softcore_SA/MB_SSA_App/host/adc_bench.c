@@ -0,0 +1,734 @@
+/******************************************************************************************************
+ * @file            adc_bench.c
+ * @brief           Native Linux regression / benchmark of the ADC IP driver against the IP cycle model
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        Linux host (no target hardware) \n
+ * IDE:             Vitis 2024.2 / make \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            Builds AXI_IMR_ADC_7476A_DUAL.c unchanged from src/ against the SysClk model of the
+ *                  IMR_ADC_7476A_X2 IP (adc_model.c) behind the Xil_In32 / Xil_Out32 shims:
+ *                    1) Register and timing checks - revision, the frame period at each clock divider,
+ *                       sample period pacing, single conversion data, auto acknowledge, CIC DC gain
+ *                    2) ISR throughput - per conversion DATA_AB, FIFO threshold and stream captures swept
+ *                       over sample rate: samples dropped (sequence errors, FIFO overflow, ring overrun,
+ *                       missed sample periods), bus accesses and CPU load per sample, host time per ISR
+ *                       (the driver and the IP model its bus accesses run)
+ *                    3) Signal mode end to end - capture, Hann window (as Main_App) and FFT: peak bin,
+ *                       SNR and time, direct and through the CIC with the droop compensator
+ *                    4) Optional WAV input - the same capture with the file as both ADC inputs
+ *                  The CPU is modelled by the bus time of each access (ADC_MODEL_READ_CYCLES /
+ *                  ADC_MODEL_WRITE_CYCLES) and an estimated interrupt entry / exit cost - so the completion
+ *                  latency it prints is a model estimate, not a measurement on the target; the INTC is
+ *                  edge triggered and acknowledged on dispatch, as XIntc does for edge sources.  The
+ *                  application loop takes completion from the driver event queue (IMR_ADC_7476A_X2_GetEvent).
+ *                  The FFT is here - src/ has no FFT to build.  Exit non zero on any failure.
+ *
+ *                  Usage: adc_bench [input.wav]
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "adc_model.h"
+#include "AXI_IMR_ADC_7476A_DUAL.h"
+
+// DEFINES
+#define BENCH_BASE_ADDRESS      0x44A00000U
+#define BENCH_ISR_ENTRY_CYCLES  120U                // MicroBlaze vector, context save and XIntc dispatch - estimate
+#define BENCH_ISR_EXIT_CYCLES   60U                 // Context restore and return - estimate
+#define BENCH_TIMEOUT_CYCLES    (ADC_MODEL_SYSCLK_HZ / 2U)
+#define BENCH_FAST_DIVIDER      (3U | IMR_ADC_CLKDIV_ODD)   // 20 MHz SCLK - unpaced held at the rated 1 MSPS
+#define BENCH_DATA_AB_SAMPLES   2048U
+#define BENCH_FIFO_SAMPLES      4095U
+#define BENCH_FIFO_THRESHOLD    256U
+#define BENCH_STREAM_RING       2048U
+#define BENCH_STREAM_SAMPLES    8192U
+#define BENCH_FFT_SIZE          1024U               // FFT_SIZE - see Softcore_Audio_SA.h
+#define BENCH_FFT_RATE          200000U             // Signal mode Fs - period 500 SysClks
+#define BENCH_CIC_RATE          800000U
+#define BENCH_CIC_ORDER         3U
+#define BENCH_CIC_RATIO         8U
+#define BENCH_CIC_WARMUP        32U                 // Compensator ramp in, discarded
+#define BENCH_MIN_SNR_DB        60.0
+#define BENCH_PI                3.14159265358979323846
+#define BENCH_MAX_SAMPLES       (BENCH_STREAM_SAMPLES + BENCH_FIFO_SAMPLES)
+
+// TYPEDEFS AND ENUMS
+typedef enum
+{
+    BENCH_MODE_DATA_AB = 0,                 // One IRQ and one DATA_AB read per conversion
+    BENCH_MODE_FIFO,                        // IRQ per FIFO threshold, burst drain
+    BENCH_MODE_STREAM                       // Free running into the ring, halves released by the application
+}Type_BenchMode;
+
+typedef struct
+{
+    uint32_t    Samples;
+    uint64_t    Cycles;                     // Capture start to the application seeing it complete
+    uint64_t    IsrCycles;                  // SysClks spent in interrupt handlers
+    uint32_t    IsrCount;
+    double      IsrHost_ns;                 // Host time in IMR_ADC_7476A_X2_ClrIrq - includes the model run by its bus accesses
+    uint64_t    BusAccesses;
+    uint64_t    CompletionLatency;          // Last ADC IRQ edge to the application taking the event, SysClks
+    uint32_t    Events;                     // Completion events taken
+    uint64_t    FirstConversion;
+    uint64_t    LastConversion;
+    uint64_t    Conversions;
+    bool        Completed;
+    bool        Overrun;                    // STATUS overrun at the end
+}Type_BenchResult;
+
+// STATIC VARIABLES
+static Type_ADC_Model Model;
+static Type_ADC_Waveform Waveform;
+static Type_AXI_IMR_7476A_Handle IP_Handle;
+static uint16_t BufferA[BENCH_MAX_SAMPLES];
+static uint16_t BufferB[BENCH_MAX_SAMPLES];
+static uint16_t RingA[BENCH_STREAM_RING];
+static uint16_t RingB[BENCH_STREAM_RING];
+static double FftReal[BENCH_FFT_SIZE];
+static double FftImag[BENCH_FFT_SIZE];
+static uint64_t IrqEdgesServiced;
+static uint32_t Failures = 0;
+
+
+
+/********************************************************************************************************
+* @brief Monotonic host time
+*
+* @author original: Hab Collector \n
+*
+* @return Nanoseconds
+********************************************************************************************************/
+static double bench_Now_ns(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return((Now.tv_sec * 1e9) + Now.tv_nsec);
+
+} // END OF bench_Now_ns
+
+
+
+/********************************************************************************************************
+* @brief Records one check
+*
+* @author original: Hab Collector \n
+*
+* @param Passed: Check result
+* @param Name: Check name
+********************************************************************************************************/
+static void bench_Expect(bool Passed, const char *Name)
+{
+    printf("  %-40s %s\n", Name, Passed ? "ok" : "FAIL");
+    if (!Passed)
+        Failures++;
+
+} // END OF bench_Expect
+
+
+
+/********************************************************************************************************
+* @brief Power on: a fresh IP model on the bus and the driver initialized
+*
+* @author original: Hab Collector \n
+*
+* @param ClockDivider: Driver clock divider (with IMR_ADC_CLKDIV_ODD)
+********************************************************************************************************/
+static void bench_Reset(uint8_t ClockDivider)
+{
+    initADC_Model(&Model, &Waveform);
+    attachADC_ModelBus(&Model, BENCH_BASE_ADDRESS);
+    init_IMR_ADC_7476A_X2(&IP_Handle, BENCH_BASE_ADDRESS, ClockDivider);
+    IrqEdgesServiced = Model.IrqRisingEdges;
+
+} // END OF bench_Reset
+
+
+
+/********************************************************************************************************
+* @brief One ADC IP interrupt: entry, the driver ISR (its bus accesses run the IP on), exit
+*
+* @author original: Hab Collector \n
+*
+* @param Result: Returned by reference - ISR time and count added
+********************************************************************************************************/
+static void bench_AdcIsr(Type_BenchResult *Result)
+{
+    uint64_t Start = Model.Cycle;
+
+    ADC_Model_Advance(&Model, BENCH_ISR_ENTRY_CYCLES);
+    IrqEdgesServiced = Model.IrqRisingEdges;      // Acknowledged at dispatch - later edges stay pending
+    double Host_ns = bench_Now_ns();
+    IMR_ADC_7476A_X2_ClrIrq(&IP_Handle);
+    Result->IsrHost_ns += bench_Now_ns() - Host_ns;
+    ADC_Model_Advance(&Model, BENCH_ISR_EXIT_CYCLES);
+    Result->IsrCycles += Model.Cycle - Start;
+    Result->IsrCount++;
+
+} // END OF bench_AdcIsr
+
+
+
+/********************************************************************************************************
+* @brief Runs a started capture as the target would: the CPU idles until an interrupt, the ADC IP ISR is
+* taken on each IRQ edge, and the completion event taken by the application loop ends it.  A stream ends after StreamSamples,
+* each ring half being released as soon as it is handed out.
+*
+* @author original: Hab Collector \n
+*
+* @param Result: Returned by reference - filled in
+* @param Mode: Capture in progress
+* @param StreamSamples: Stream mode - samples to take
+*
+* STEP 1: Start the accounting from the capture start
+* STEP 2: Interrupts, the application loop, or one idle SysClk
+* STEP 3: Totals
+********************************************************************************************************/
+static void bench_Run(Type_BenchResult *Result, Type_BenchMode Mode, uint32_t StreamSamples)
+{
+    // STEP 1: Start the accounting from the capture start
+    uint64_t Start = Model.Cycle;
+    uint64_t BusStart = Model.BusReads + Model.BusWrites;
+    uint64_t ConversionsStart = Model.Conversions;
+    uint64_t LastEdge = Model.Cycle;
+    uint16_t *HalfA;
+    uint16_t *HalfB;
+    Type_ADC_Event Event;
+
+    // STEP 2: Interrupts, the application loop, or one idle SysClk
+    while ((Model.Cycle - Start) < BENCH_TIMEOUT_CYCLES)
+    {
+        if (Model.IrqRisingEdges != IrqEdgesServiced)
+        {
+            LastEdge = Model.Cycle;
+            bench_AdcIsr(Result);
+        }
+        else if (IMR_ADC_7476A_X2_GetEvent(&IP_Handle, &Event))
+        {
+            // The application loop - the ISR that finished the capture posted the event
+            Result->Events++;
+            Result->CompletionLatency = Model.Cycle - LastEdge;
+            Result->Completed = true;
+            break;
+        }
+        else if ((Mode == BENCH_MODE_STREAM) && IMR_ADC_7476A_X2_GetRingHalf(&IP_Handle, &HalfA, &HalfB))
+        {
+            uint32_t HalfSize = IP_Handle.RingSize / IMR_ADC_RING_HALVES;
+            memcpy(&BufferA[Result->Samples], HalfA, HalfSize * sizeof(uint16_t));
+            memcpy(&BufferB[Result->Samples], HalfB, HalfSize * sizeof(uint16_t));
+            IMR_ADC_7476A_X2_ReleaseRingHalf(&IP_Handle);
+            Result->Samples += HalfSize;
+            if (Result->Samples >= StreamSamples)
+            {
+                Result->Completed = true;
+                break;
+            }
+        }
+        else
+        {
+            ADC_Model_Advance(&Model, 1);
+        }
+        if ((Model.Conversions != ConversionsStart) && (Result->FirstConversion == 0))
+            Result->FirstConversion = Model.LastConversionCycle;
+    }
+
+    // STEP 3: Totals
+    Result->Cycles = Model.Cycle - Start;
+    Result->BusAccesses = (Model.BusReads + Model.BusWrites) - BusStart;
+    Result->LastConversion = Model.LastConversionCycle;
+    Result->Conversions = Model.Conversions - ConversionsStart;
+    if (Mode != BENCH_MODE_STREAM)
+        Result->Samples = IP_Handle.TotalConversions;
+    Result->Overrun = (IMR_ADC_7476A_X2_GetStatusReg(&IP_Handle) & STATUS_OVERRUN_MASK) != 0;
+
+} // END OF bench_Run
+
+
+
+/********************************************************************************************************
+* @brief Starts a capture in a mode at a sample rate and runs it to completion
+*
+* @author original: Hab Collector \n
+*
+* @param Result: Returned by reference - cleared and filled in
+* @param Mode: Delivery path
+* @param ClockDivider: Driver clock divider
+* @param SampleRate: Hz, 0 = back to back
+* @param Samples: Samples to capture
+*
+* @return True if started (rate accepted)
+*
+* STEP 1: Power on at the divider and set the rate
+* STEP 2: Start in the mode
+* STEP 3: Run - a stream is stopped afterwards
+********************************************************************************************************/
+static bool bench_Capture(Type_BenchResult *Result, Type_BenchMode Mode, uint8_t ClockDivider, uint32_t SampleRate, uint32_t Samples)
+{
+    // STEP 1: Power on at the divider and set the rate
+    memset(Result, 0x00, sizeof(Type_BenchResult));
+    bench_Reset(ClockDivider);
+    if (!IMR_ADC_7476A_X2_SetSampleRate(&IP_Handle, SampleRate, NULL))
+        return(false);
+
+    // STEP 2: Start in the mode
+    switch (Mode)
+    {
+        case BENCH_MODE_DATA_AB:
+            IMR_ADC_7476A_X2_MultiConvert(&IP_Handle, BufferA, BufferB, Samples);
+            break;
+        case BENCH_MODE_FIFO:
+            IMR_ADC_7476A_X2_EnableFifo(&IP_Handle, BENCH_FIFO_THRESHOLD);
+            IMR_ADC_7476A_X2_MultiConvert(&IP_Handle, BufferA, BufferB, Samples);
+            break;
+        case BENCH_MODE_STREAM:
+            IMR_ADC_7476A_X2_StartStream(&IP_Handle, RingA, RingB, BENCH_STREAM_RING);
+            break;
+    }
+
+    // STEP 3: Run - a stream is stopped afterwards
+    bench_Run(Result, Mode, Samples);
+    if (Mode == BENCH_MODE_STREAM)
+        return(IMR_ADC_7476A_X2_StopStream(&IP_Handle));
+    return(true);
+
+} // END OF bench_Capture
+
+
+
+/********************************************************************************************************
+* @brief Register and timing checks of the driver on the model
+*
+* @author original: Hab Collector \n
+*
+* STEP 1: Revision
+* STEP 2: Back to back frame period at each divider - IMR_ADC_MIN_SAMPLE_PERIOD, 3 | ODD paced at the rating; N < 3 refused
+* STEP 3: Sample period pacing
+* STEP 4: Single conversion data, DATA_A / DATA_B and auto acknowledge
+* STEP 5: CIC DC gain - 16 x the ADC code after the filter fills
+* STEP 6: A FIFO capture that overflowed ends short on STATUS DONE - one event, IRQ left low
+* STEP 7: Stopping a stream mid frame - BUSY drops well inside IMR_ADC_STOP_TIMEOUT_US and the stop says so
+********************************************************************************************************/
+static void bench_RegisterChecks(void)
+{
+    const uint8_t Divider[] = {3, 3 | IMR_ADC_CLKDIV_ODD, 4, 4 | IMR_ADC_CLKDIV_ODD, 5};
+    Type_BenchResult Result;
+    Type_ADC_Event Event;
+    char Name[64];
+
+    printf("registers and timing\n");
+    initADC_WaveformSine(&Waveform, 1000.0, 1500.0, 1000.0, 0.0);
+
+    // STEP 1: Revision
+    bench_Reset(IMR_ADC_CLOCK_DIVIDER);
+    bench_Expect((IMR_ADC_7476A_X2_GetStatusReg(&IP_Handle) >> 28) == ADC_MODEL_REVISION, "STATUS revision");
+
+    // STEP 2: Back to back frame period at each divider - IMR_ADC_MIN_SAMPLE_PERIOD, 3 | ODD paced at the rating; N < 3 refused
+    for (uint8_t Index = 0; Index < sizeof(Divider); Index++)
+    {
+        uint32_t Expected = IMR_ADC_UNPACED_PERIOD(Divider[Index]) ? IMR_ADC_UNPACED_PERIOD(Divider[Index]) : IMR_ADC_MIN_SAMPLE_PERIOD(Divider[Index]);
+        bench_Capture(&Result, BENCH_MODE_FIFO, Divider[Index], 0, 64);
+        uint64_t Period = (Result.LastConversion - Result.FirstConversion) / (Result.Conversions - 1);
+        snprintf(Name, sizeof(Name), "frame period divider %u%s = %u", Divider[Index] & 0x0F, (Divider[Index] & IMR_ADC_CLKDIV_ODD) ? " odd" : "", Expected);
+        bench_Expect(Result.Completed && (Result.Conversions == 64) && (Period == Expected) && !Result.Overrun, Name);
+    }
+    bench_Expect(!init_IMR_ADC_7476A_X2(&IP_Handle, BENCH_BASE_ADDRESS, 2 | IMR_ADC_CLKDIV_ODD), "divider 2 refused");
+
+    // STEP 3: Sample period pacing
+    bench_Capture(&Result, BENCH_MODE_FIFO, IMR_ADC_CLOCK_DIVIDER, 250000, 64);
+    bench_Expect(Result.Completed && ((Result.LastConversion - Result.FirstConversion) == (63U * 400U)), "250 kS/s paced at 400 SysClks");
+    bench_Expect(!Result.Overrun, "no overrun");
+
+    // STEP 4: Single conversion data, DATA_A / DATA_B and auto acknowledge
+    initADC_WaveformSine(&Waveform, 0.0, 0.0, 0.0, 0.0);
+    Waveform.Offset[0] = 1234.0;
+    Waveform.Offset[1] = 3210.0;
+    memset(&Result, 0x00, sizeof(Result));
+    bench_Reset(IMR_ADC_CLOCK_DIVIDER);
+    IMR_ADC_7476A_X2_SingleConvert(&IP_Handle, BufferA, BufferB);
+    bench_Run(&Result, BENCH_MODE_DATA_AB, 0);
+    bench_Expect(Result.Completed && (BufferA[0] == 1234) && (BufferB[0] == 3210), "single conversion A / B");
+    bench_Expect((IMR_ADC_7476A_X2_GetDataAReg(&IP_Handle) == 1234) && (IMR_ADC_7476A_X2_GetDataBReg(&IP_Handle) == 3210), "DATA_A / DATA_B");
+    bench_Expect(!getADC_ModelIrq(&Model) && (Result.IsrCount == 1), "DATA_AB read acknowledges");
+
+    // STEP 5: CIC DC gain - 16 x the ADC code after the filter fills
+    bench_Reset(BENCH_FAST_DIVIDER);
+    IMR_ADC_7476A_X2_SetDecimation(&IP_Handle, BENCH_CIC_ORDER, BENCH_CIC_RATIO);
+    IMR_ADC_7476A_X2_EnableFifo(&IP_Handle, 64);
+    memset(&Result, 0x00, sizeof(Result));
+    IMR_ADC_7476A_X2_MultiConvert(&IP_Handle, BufferA, BufferB, 100);
+    bench_Run(&Result, BENCH_MODE_FIFO, 0);
+    bool DcGain = Result.Completed && (IP_Handle.ConversionCount == 100);
+    for (uint32_t Index = 0; Index < 100; Index++)
+        DcGain = DcGain && (BufferA[Index] == 1234U * 16U) && (BufferB[Index] == 3210U * 16U);
+    bench_Expect(DcGain, "CIC order 3 ratio 8 DC gain");
+    bench_Expect(Result.Conversions == ((100U + BENCH_CIC_ORDER - 1U) * BENCH_CIC_RATIO), "CIC conversions per sample");
+
+    // STEP 6: A FIFO capture that overflowed ends short on STATUS DONE - one event, IRQ left low
+    bench_Reset(BENCH_FAST_DIVIDER);
+    IMR_ADC_7476A_X2_EnableFifo(&IP_Handle, IMR_ADC_FIFO_DEPTH);
+    memset(&Result, 0x00, sizeof(Result));
+    IMR_ADC_7476A_X2_MultiConvert(&IP_Handle, BufferA, BufferB, 2000);
+    ADC_Model_Advance(&Model, 2000U * IP_Handle.SamplePeriod);
+    bench_Run(&Result, BENCH_MODE_FIFO, 0);
+    bench_Expect(Result.Completed && (IP_Handle.FifoOverflowCount != 0) && (IP_Handle.ConversionCount == IMR_ADC_FIFO_DEPTH), "overflowed capture completes on DONE");
+    ADC_Model_Advance(&Model, 1000);
+    bench_Expect(!getADC_ModelIrq(&Model) && !IMR_ADC_7476A_X2_GetEvent(&IP_Handle, &Event) && (IP_Handle.EventDropCount == 0), "one completion event, IRQ low");
+
+    // STEP 7: Stopping a stream mid frame - BUSY drops well inside IMR_ADC_STOP_TIMEOUT_US and the stop says so
+    bench_Reset(IMR_ADC_CLOCK_DIVIDER);
+    IMR_ADC_7476A_X2_StartStream(&IP_Handle, RingA, RingB, BENCH_STREAM_RING);
+    ADC_Model_Advance(&Model, 1000);
+    uint64_t StopStart = Model.Cycle;
+    bool Stopped = IMR_ADC_7476A_X2_StopStream(&IP_Handle);
+    bench_Expect(Stopped && !(IMR_ADC_7476A_X2_GetStatusReg(&IP_Handle) & STATUS_BUSY_MASK) && !IP_Handle.Streaming, "stream stop idles");
+    bench_Expect((Model.Cycle - StopStart) < (uint64_t)IMR_ADC_MIN_SAMPLE_PERIOD(IMR_ADC_CLOCK_DIVIDER) * 2U, "stream stop within two frames");
+
+} // END OF bench_RegisterChecks
+
+
+
+/********************************************************************************************************
+* @brief ISR throughput and dropped samples of each delivery path over sample rate
+*
+* @author original: Hab Collector \n
+*
+* @note: Missed slots are sample periods with no conversion - the IP holds the next conversion for a result the
+*        ISR has not yet read (DATA_AB path) rather than lose it, so the loss shows as a lower achieved rate
+*
+* STEP 1: Sweep
+* STEP 2: Drops by path - DATA_AB may only miss slots; FIFO and stream must lose nothing to 1 MS/s
+********************************************************************************************************/
+static void bench_Throughput(void)
+{
+    const uint32_t SampleRate[] = {100000, 250000, 500000, 750000, 1000000};
+    const char *ModeName[] = {"DATA_AB", "FIFO", "stream"};
+    const uint32_t ModeSamples[] = {BENCH_DATA_AB_SAMPLES, BENCH_FIFO_SAMPLES, BENCH_STREAM_SAMPLES};
+    bool DataAbSequence = true;
+    bool DataAbSlow = true;
+    bool FifoLossless = true;
+    bool StreamLossless = true;
+    Type_BenchResult Result;
+
+    // STEP 1: Sweep
+    printf("ISR throughput (entry %u + exit %u SysClks, read %u, write %u)\n", BENCH_ISR_ENTRY_CYCLES, BENCH_ISR_EXIT_CYCLES, ADC_MODEL_READ_CYCLES, ADC_MODEL_WRITE_CYCLES);
+    printf("  %-8s %8s %8s %6s %8s %6s %7s %6s %6s %6s %8s\n", "path", "kS/s", "got", "ISRs", "bus/smp", "CPU%", "missed", "seq", "f_ovf", "r_ovr", "host us");
+    initADC_WaveformSine(&Waveform, 1000.0, 1500.0, 1500.0, 0.5);
+    for (uint8_t Mode = BENCH_MODE_DATA_AB; Mode <= BENCH_MODE_STREAM; Mode++)
+    {
+        for (uint8_t Rate = 0; Rate < (sizeof(SampleRate) / sizeof(SampleRate[0])); Rate++)
+        {
+            bench_Capture(&Result, (Type_BenchMode)Mode, BENCH_FAST_DIVIDER, SampleRate[Rate], ModeSamples[Mode]);
+            uint64_t Span = Result.LastConversion - Result.FirstConversion;
+            uint64_t Slots = (Span / IP_Handle.SamplePeriod) + 1U;
+            uint64_t Missed = (Slots > Result.Conversions) ? (Slots - Result.Conversions) : 0;
+            double Achieved = (Span == 0) ? 0.0 : ((Result.Conversions - 1U) * (double)ADC_MODEL_SYSCLK_HZ / Span / 1000.0);
+            printf("  %-8s %8u %8.1f %6u %8.2f %6.1f %7llu %6u %6u %6u %8.1f%s\n", ModeName[Mode], SampleRate[Rate] / 1000U, Achieved,
+                   Result.IsrCount, (double)Result.BusAccesses / Result.Samples, 100.0 * Result.IsrCycles / Result.Cycles,
+                   (unsigned long long)Missed, IP_Handle.SequenceErrorCount, IP_Handle.FifoOverflowCount, IP_Handle.RingOverrunCount,
+                   (Result.IsrCount == 0) ? 0.0 : (Result.IsrHost_ns / Result.IsrCount / 1000.0), Result.Completed ? "" : "  (timed out)");
+
+            // STEP 2: Drops by path - DATA_AB may only miss slots; FIFO and stream must lose nothing to 1 MS/s
+            if (Mode == BENCH_MODE_DATA_AB)
+            {
+                DataAbSequence = DataAbSequence && Result.Completed && (IP_Handle.SequenceErrorCount == 0);
+                if (SampleRate[Rate] <= 250000)
+                    DataAbSlow = DataAbSlow && (Missed == 0) && !Result.Overrun;
+            }
+            else if (Mode == BENCH_MODE_FIFO)
+            {
+                FifoLossless = FifoLossless && Result.Completed && (Missed == 0) && (IP_Handle.FifoOverflowCount == 0) && (IP_Handle.ConversionCount == BENCH_FIFO_SAMPLES);
+            }
+            else
+            {
+                StreamLossless = StreamLossless && Result.Completed && (Missed == 0) && (IP_Handle.FifoOverflowCount == 0) && (IP_Handle.RingOverrunCount == 0);
+            }
+        }
+    }
+    bench_Expect(DataAbSequence, "DATA_AB no sequence errors");
+    bench_Expect(DataAbSlow, "DATA_AB holds 250 kS/s");
+    bench_Expect(FifoLossless, "FIFO lossless to 1 MS/s");
+    bench_Expect(StreamLossless, "stream lossless to 1 MS/s");
+
+} // END OF bench_Throughput
+
+
+
+/********************************************************************************************************
+* @brief In place radix-2 FFT
+*
+* @author original: Hab Collector \n
+*
+* @param Real: Real parts
+* @param Imag: Imaginary parts
+* @param Size: Points, a power of 2
+*
+* STEP 1: Bit reverse order
+* STEP 2: Butterflies
+********************************************************************************************************/
+static void bench_Fft(double *Real, double *Imag, uint32_t Size)
+{
+    // STEP 1: Bit reverse order
+    for (uint32_t Index = 1, Reverse = 0; Index < Size; Index++)
+    {
+        uint32_t Bit = Size >> 1;
+        for (; Reverse & Bit; Bit >>= 1)
+            Reverse ^= Bit;
+        Reverse ^= Bit;
+        if (Index < Reverse)
+        {
+            double Swap = Real[Index];
+            Real[Index] = Real[Reverse];
+            Real[Reverse] = Swap;
+            Swap = Imag[Index];
+            Imag[Index] = Imag[Reverse];
+            Imag[Reverse] = Swap;
+        }
+    }
+
+    // STEP 2: Butterflies
+    for (uint32_t Length = 2; Length <= Size; Length <<= 1)
+    {
+        double Angle = -2.0 * BENCH_PI / Length;
+        for (uint32_t Block = 0; Block < Size; Block += Length)
+        {
+            for (uint32_t Index = 0; Index < (Length / 2); Index++)
+            {
+                double TwiddleReal = cos(Angle * Index);
+                double TwiddleImag = sin(Angle * Index);
+                uint32_t Top = Block + Index;
+                uint32_t Bottom = Top + (Length / 2);
+                double Real_ = (Real[Bottom] * TwiddleReal) - (Imag[Bottom] * TwiddleImag);
+                double Imag_ = (Real[Bottom] * TwiddleImag) + (Imag[Bottom] * TwiddleReal);
+                Real[Bottom] = Real[Top] - Real_;
+                Imag[Bottom] = Imag[Top] - Imag_;
+                Real[Top] += Real_;
+                Imag[Top] += Imag_;
+            }
+        }
+    }
+
+} // END OF bench_Fft
+
+
+
+/********************************************************************************************************
+* @brief Spectrum of FFT_SIZE samples as the signal mode forms it: mean removed, Hann window (Main_App), FFT
+*
+* @author original: Hab Collector \n
+*
+* @param Samples: BENCH_FFT_SIZE ADC samples
+* @param PeakBin: Returned by reference - strongest bin above DC
+* @param Amplitude: Returned by reference - peak amplitude of the tone in sample units
+*
+* @return SNR in dB - the tone (peak +/- 3 bins) against every other bin above DC
+*
+* STEP 1: Window
+* STEP 2: Transform and find the peak
+* STEP 3: Signal and noise power
+********************************************************************************************************/
+static double bench_Spectrum(const uint16_t *Samples, uint32_t *PeakBin, double *Amplitude)
+{
+    double Mean = 0.0;
+    double WindowSum = 0.0;
+    double Signal = 0.0;
+    double Noise = 0.0;
+
+    // STEP 1: Window
+    for (uint32_t Index = 0; Index < BENCH_FFT_SIZE; Index++)
+        Mean += Samples[Index];
+    Mean /= BENCH_FFT_SIZE;
+    for (uint32_t Index = 0; Index < BENCH_FFT_SIZE; Index++)
+    {
+        double Hann = 0.5 * (1.0 - cos((2.0 * BENCH_PI * Index) / (BENCH_FFT_SIZE - 1)));
+        FftReal[Index] = (Samples[Index] - Mean) * Hann;
+        FftImag[Index] = 0.0;
+        WindowSum += Hann;
+    }
+
+    // STEP 2: Transform and find the peak
+    bench_Fft(FftReal, FftImag, BENCH_FFT_SIZE);
+    *PeakBin = 4;
+    for (uint32_t Bin = 4; Bin <= (BENCH_FFT_SIZE / 2); Bin++)
+    {
+        FftReal[Bin] = (FftReal[Bin] * FftReal[Bin]) + (FftImag[Bin] * FftImag[Bin]);
+        if (FftReal[Bin] > FftReal[*PeakBin])
+            *PeakBin = Bin;
+    }
+    *Amplitude = 2.0 * sqrt(FftReal[*PeakBin]) / WindowSum;
+
+    // STEP 3: Signal and noise power
+    for (uint32_t Bin = 4; Bin <= (BENCH_FFT_SIZE / 2); Bin++)
+    {
+        if ((Bin + 3 >= *PeakBin) && (Bin <= *PeakBin + 3))
+            Signal += FftReal[Bin];
+        else
+            Noise += FftReal[Bin];
+    }
+    return(10.0 * log10(Signal / Noise));
+
+} // END OF bench_Spectrum
+
+
+
+/********************************************************************************************************
+* @brief Signal mode end to end: a tone on an exact bin captured through the FIFO at a set rate, windowed and
+* transformed.  Then through the CIC decimator with the droop compensator.
+*
+* @author original: Hab Collector \n
+*
+* STEP 1: Direct - 12 bit samples at 200 kS/s, tones on bins 100 (A) and 37 (B)
+* STEP 2: Decimated - 800 kS/s / 8, tone on bin 128 where the CIC droop is 0.66 dB
+* STEP 3: Compensated - droop removed, first samples (filter ramp in) dropped
+********************************************************************************************************/
+static void bench_SignalFft(void)
+{
+    Type_BenchResult Result;
+    Type_ADC_CicCompensator Compensator;
+    uint32_t PeakBin;
+    double Amplitude;
+    double Snr;
+    double Host_ns;
+    double FftTime_ns;
+    char Name[64];
+
+    // STEP 1: Direct - 12 bit samples at 200 kS/s, tones on bins 100 (A) and 37 (B)
+    printf("signal mode FFT (%u points)\n", BENCH_FFT_SIZE);
+    double BinHz = (double)BENCH_FFT_RATE / BENCH_FFT_SIZE;
+    initADC_WaveformSine(&Waveform, 100.0 * BinHz, 37.0 * BinHz, 1500.0, 0.5);
+    Host_ns = bench_Now_ns();
+    bench_Capture(&Result, BENCH_MODE_FIFO, IMR_ADC_CLOCK_DIVIDER, BENCH_FFT_RATE, BENCH_FFT_SIZE);
+    Host_ns = bench_Now_ns() - Host_ns;
+    FftTime_ns = bench_Now_ns();
+    Snr = bench_Spectrum(BufferA, &PeakBin, &Amplitude);
+    FftTime_ns = bench_Now_ns() - FftTime_ns;
+    printf("  A: %u kS/s, capture %.2f ms (%.1f ms host), CPU %.2f%%, FFT %.0f us host, peak bin %u, SNR %.1f dB\n",
+           BENCH_FFT_RATE / 1000U, Result.Cycles / (ADC_MODEL_SYSCLK_HZ / 1000.0), Host_ns / 1e6,
+           100.0 * Result.IsrCycles / Result.Cycles, FftTime_ns / 1e3, PeakBin, Snr);
+    printf("  completion: application event %llu SysClks after the last ADC IRQ (model estimate, unmeasured on target)\n", (unsigned long long)Result.CompletionLatency);
+    snprintf(Name, sizeof(Name), "A peak bin 100, SNR > %.0f dB", BENCH_MIN_SNR_DB);
+    bench_Expect(Result.Completed && (PeakBin == 100) && (Snr > BENCH_MIN_SNR_DB), Name);
+    Snr = bench_Spectrum(BufferB, &PeakBin, &Amplitude);
+    printf("  B: peak bin %u, SNR %.1f dB\n", PeakBin, Snr);
+    snprintf(Name, sizeof(Name), "B peak bin 37, SNR > %.0f dB", BENCH_MIN_SNR_DB);
+    bench_Expect((PeakBin == 37) && (Snr > BENCH_MIN_SNR_DB), Name);
+
+    // STEP 2: Decimated - 800 kS/s / 8, tone on bin 128 where the CIC droop is 0.66 dB
+    uint32_t Samples = BENCH_FFT_SIZE + BENCH_CIC_WARMUP;
+    BinHz = (double)BENCH_CIC_RATE / BENCH_CIC_RATIO / BENCH_FFT_SIZE;
+    initADC_WaveformSine(&Waveform, 128.0 * BinHz, 128.0 * BinHz, 1500.0, 0.5);
+    memset(&Result, 0x00, sizeof(Result));
+    bench_Reset(BENCH_FAST_DIVIDER);
+    IMR_ADC_7476A_X2_SetSampleRate(&IP_Handle, BENCH_CIC_RATE, NULL);
+    IMR_ADC_7476A_X2_SetDecimation(&IP_Handle, BENCH_CIC_ORDER, BENCH_CIC_RATIO);
+    IMR_ADC_7476A_X2_EnableFifo(&IP_Handle, BENCH_FIFO_THRESHOLD);
+    IMR_ADC_7476A_X2_MultiConvert(&IP_Handle, BufferA, BufferB, Samples);
+    bench_Run(&Result, BENCH_MODE_FIFO, 0);
+    Snr = bench_Spectrum(&BufferA[BENCH_CIC_WARMUP], &PeakBin, &Amplitude);
+    double RawGain = Amplitude / (1500.0 * 16.0);
+    printf("  CIC order %u ratio %u: %u kS/s out, capture %.2f ms, CPU %.2f%%, peak bin %u, SNR %.1f dB, gain %.4f\n",
+           BENCH_CIC_ORDER, BENCH_CIC_RATIO, BENCH_CIC_RATE / BENCH_CIC_RATIO / 1000U, Result.Cycles / (ADC_MODEL_SYSCLK_HZ / 1000.0),
+           100.0 * Result.IsrCycles / Result.Cycles, PeakBin, Snr, RawGain);
+    bench_Expect(Result.Completed && (PeakBin == 128) && (Snr > BENCH_MIN_SNR_DB), "CIC peak bin 128");
+    bench_Expect(fabs(RawGain - 0.9266) < 0.01, "CIC droop at bin 128 (0.927)");
+
+    // STEP 3: Compensated - droop removed, first samples (filter ramp in) dropped
+    IMR_ADC_7476A_X2_InitCicCompensator(&Compensator, BENCH_CIC_ORDER, BENCH_CIC_RATIO, 0.25f);
+    Host_ns = bench_Now_ns();
+    IMR_ADC_7476A_X2_CicCompensate(&Compensator, BufferA, Samples);
+    Host_ns = bench_Now_ns() - Host_ns;
+    Snr = bench_Spectrum(&BufferA[BENCH_CIC_WARMUP], &PeakBin, &Amplitude);
+    printf("  compensated: %.1f ns/sample host, peak bin %u, SNR %.1f dB, gain %.4f\n", Host_ns / Samples, PeakBin, Snr, Amplitude / (1500.0 * 16.0));
+    bench_Expect((PeakBin == 128) && (Snr > BENCH_MIN_SNR_DB) && (fabs((Amplitude / (1500.0 * 16.0)) - 1.0) < 0.02), "compensated gain 1.0 +/- 2%");
+
+} // END OF bench_SignalFft
+
+
+
+/********************************************************************************************************
+* @brief A WAV file as the input of both ADCs - capture at 48 kS/s and report the strongest frequency
+*
+* @author original: Hab Collector \n
+*
+* @param Path: 8 or 16 bit PCM WAV file
+********************************************************************************************************/
+static void bench_WavInput(const char *Path)
+{
+    Type_BenchResult Result;
+    uint32_t PeakBin;
+    double Amplitude;
+    uint32_t SampleRate;
+
+    printf("WAV input (%s)\n", Path);
+    if (!loadADC_WaveformWav(&Waveform, Path))
+    {
+        bench_Expect(false, "WAV loaded");
+        return;
+    }
+    bench_Reset(IMR_ADC_CLOCK_DIVIDER);
+    IMR_ADC_7476A_X2_SetSampleRate(&IP_Handle, 48000, &SampleRate);
+    IMR_ADC_7476A_X2_EnableFifo(&IP_Handle, BENCH_FIFO_THRESHOLD);
+    memset(&Result, 0x00, sizeof(Result));
+    // Start a second in - past any lead in silence
+    ADC_Model_Advance(&Model, ADC_MODEL_SYSCLK_HZ);
+    IMR_ADC_7476A_X2_MultiConvert(&IP_Handle, BufferA, BufferB, BENCH_FFT_SIZE);
+    bench_Run(&Result, BENCH_MODE_FIFO, 0);
+    bench_Spectrum(BufferA, &PeakBin, &Amplitude);
+    printf("  %u Hz PCM, %u channel(s), %u frames: %u S/s, strongest %.0f Hz at %.0f codes\n", Waveform.PcmRate, Waveform.PcmChannels,
+           Waveform.PcmFrames, SampleRate, PeakBin * (double)SampleRate / BENCH_FFT_SIZE, Amplitude);
+    bench_Expect(Result.Completed && (IP_Handle.ConversionCount == BENCH_FFT_SIZE), "WAV capture");
+    freeADC_Waveform(&Waveform);
+
+} // END OF bench_WavInput
+
+
+
+/********************************************************************************************************
+* @brief Entry point
+*
+* @author original: Hab Collector \n
+*
+* @param argc: Argument count
+* @param argv: [input.wav]
+*
+* @return 0 all checks pass, 1 any failure
+*
+* STEP 1: Register and timing checks
+* STEP 2: Throughput and the signal mode FFT
+* STEP 3: WAV input and result
+********************************************************************************************************/
+int main(int argc, char *argv[])
+{
+    // STEP 1: Register and timing checks
+    bench_RegisterChecks();
+
+    // STEP 2: Throughput and the signal mode FFT
+    bench_Throughput();
+    bench_SignalFft();
+
+    // STEP 3: WAV input and result
+    if (argc > 1)
+        bench_WavInput(argv[1]);
+    attachADC_ModelBus(NULL, 0);
+    if (Failures != 0)
+    {
+        printf("FAIL: %u checks\n", Failures);
+        return(1);
+    }
+    printf("PASS\n");
+    return(0);
+
+} // END OF main
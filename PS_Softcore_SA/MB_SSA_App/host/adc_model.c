@@ -0,0 +1,878 @@
+/******************************************************************************************************
+ * @file            adc_model.c
+ * @brief           SysClk cycle model of the IMR_ADC_7476A_X2 IP register interface for host builds
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        Linux host (no target hardware) \n
+ * IDE:             Vitis 2024.2 / make \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            Stands in for the IP behind Xil_In32 / Xil_Out32 (bsp_shim/xil_io.h) so
+ *                  AXI_IMR_ADC_7476A_DUAL.c runs unchanged on Linux.  Each call of adcModel_Step is one
+ *                  SysClk of IMR_ADC_7476A_X2_Core.sv (REV 11) - the always_ff blocks in the same order,
+ *                  all reading the values from before the edge:
+ *                    - CTRL / STATUS / DATA_A / DATA_B / IRQ / DATA_AB, SAMPLE_PERIOD pacing and overrun,
+ *                      the capture done flag and its interrupt
+ *                    - FSM IDLE, START, SHIFT, QUIET, NEXT_CONV with the SCLK divider (odd option),
+ *                      MISO sampled the clock after the SCLK rise detect (N < 3 runs as 3), the pipelined result latch
+ *                    - Sample FIFO: threshold, overflow, tail, flush, pop on the FIFO_DATA read
+ *                    - CIC decimator: pipelined integrators, sequential combs, priming, saturation
+ *                  The AXI-lite slave is modelled as its side effects: a write lands on the handshake
+ *                  (IRQ_CLR is a one clock pulse), a FIFO_DATA / DATA_AB read pops / acknowledges on the
+ *                  address handshake and returns the registers after that edge.  Each access costs the
+ *                  model ReadCycles / WriteCycles of SysClk - the time the CPU is stalled on the bus.
+ *                  Not modelled: the trigger engine (TRIG_* hold what is written, TRIG_STATUS reads 0)
+ *                  and the DMA writer (DMA_* hold what is written, no bursts, the DMA flags read 0).
+ *                  The AD7476A samples the waveform at the CS_n fall; the frame is {4'b0000, code}.
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#include "adc_model.h"
+#include "xil_io.h"
+#include "diskio_timing.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+// DEFINES
+// Register indexes (byte offset / 4) - see hdl/IMR_ADC_7476A_X2_Def.vh
+#define REG_CTRL                0U
+#define REG_STATUS              1U
+#define REG_DATA_A              2U
+#define REG_DATA_B              3U
+#define REG_IRQ                 4U
+#define REG_FIFO_CTRL           5U
+#define REG_FIFO_STATUS         6U
+#define REG_FIFO_DATA           7U
+#define REG_DATA_AB             8U
+#define REG_DMA_CTRL            9U
+#define REG_DMA_PRODUCER        13U
+#define REG_SAMPLE_PERIOD       15U
+#define REG_TRIG_STATUS         20U
+#define REG_CIC_CTRL            21U
+#define BIT(Value, Bit)         ((((Value) >> (Bit)) & 0x01U) != 0)
+#define FIELD(Value, Lsb, Mask) (((Value) >> (Lsb)) & (Mask))
+#define CH_A                    0U
+#define CH_B                    1U
+
+// STATIC VARIABLES
+static Type_ADC_Model *BusModel = NULL;     // Target of Xil_In32 / Xil_Out32 - one IP at a time
+static uint32_t BusBaseAddress = 0;
+
+
+
+/********************************************************************************************************
+* @brief Interrupt line as the core drives it from the registers of this clock
+*
+* @author original: Hab Collector \n
+*
+* @param Model: IP model
+*
+* @return IP_IRQ
+********************************************************************************************************/
+static bool adcModel_Irq(const Type_ADC_Model *Model)
+{
+    uint32_t FifoControl = Model->Register[REG_FIFO_CTRL];
+    uint16_t Threshold = FIELD(FifoControl, 0, 0x7FFU);
+    bool FifoEnable = BIT(FifoControl, 16);
+    bool DmaEnable = BIT(Model->Register[REG_DMA_CTRL], 0);
+    bool ThresholdReached = (Threshold != 0) && (Model->FifoCount >= Threshold);
+    bool Tail = (Model->FifoCount != 0) && (Model->State == ADC_MODEL_STATE_IDLE);
+
+    if (!BIT(Model->Register[REG_IRQ], 0))
+        return(false);
+    if (BIT(Model->Register[REG_IRQ], 3) && Model->CaptureDone)
+        return(true);
+    if (FifoEnable)
+        return(ThresholdReached || Model->FifoOverflow || (Tail && !DmaEnable));
+    return(Model->StatusReady);
+
+} // END OF adcModel_Irq
+
+
+
+/********************************************************************************************************
+* @brief One SysClk of the core.  Every block reads the state from before the edge, as the RTL
+* nonblocking assignments do, so the combinational terms are all formed first.
+*
+* @author original: Hab Collector \n
+*
+* @param Model: IP model
+*
+* STEP 1: Register extraction and edge detects
+* STEP 2: Combinational terms (the assigns of the core)
+* STEP 3: Status ready, capture done, result latch, pending result
+* STEP 4: FIFO storage, pointers and overflow
+* STEP 5: CIC decimator
+* STEP 6: Sample period timer
+* STEP 7: SCLK divider
+* STEP 8: Main FSM - the AD7476A loads its frame on the CS_n fall
+* STEP 9: Edge detect registers, the IRQ_CLR self clear and statistics
+********************************************************************************************************/
+static void adcModel_Step(Type_ADC_Model *Model)
+{
+    // STEP 1: Register extraction and edge detects
+    uint32_t Control = Model->Register[REG_CTRL];
+    uint32_t IrqRegister = Model->Register[REG_IRQ];
+    uint32_t FifoControl = Model->Register[REG_FIFO_CTRL];
+    uint32_t CicControl = Model->Register[REG_CIC_CTRL];
+    bool ChipEnable = BIT(Control, 0);
+    bool Single = BIT(Control, 1) && !BIT(Control, 2);
+    bool Continuous = BIT(Control, 1) && BIT(Control, 2);
+    bool FreeRun = BIT(Control, 3);
+    uint8_t Divider = (FIELD(Control, 4, 0x0FU) < 3U) ? 3U : FIELD(Control, 4, 0x0FU);   // N below 3 runs as 3
+    uint16_t TotalConversions = FIELD(Control, 8, 0xFFFU);
+    bool ClockOdd = BIT(Control, 20);
+    uint32_t SamplePeriod = Model->Register[REG_SAMPLE_PERIOD] & 0x00FFFFFFU;
+    bool PeriodEnable = (SamplePeriod != 0);
+    bool IrqClear = BIT(IrqRegister, 1);
+    bool AutoAck = BIT(IrqRegister, 2);
+    bool FifoEnable = BIT(FifoControl, 16);
+    bool FifoFlush = BIT(FifoControl, 17);
+    uint16_t Threshold = FIELD(FifoControl, 0, 0x7FFU);
+    bool CicEnable = BIT(CicControl, 0);
+    uint8_t CicOrderM1 = FIELD(CicControl, 4, 0x03U);
+    uint8_t CicRatioM1 = FIELD(CicControl, 8, 0xFFU);
+    uint8_t CicShift = FIELD(CicControl, 16, 0x1FU);
+    bool SingleRise = Single && !Model->SingleDelay;
+    bool ContinuousRise = Continuous && !Model->ContinuousDelay;
+    bool FlushRise = FifoFlush && !Model->FlushDelay;
+    bool ClockRise = Model->Clock && !Model->ClockDelay;
+    bool CaptureStart = (Model->State == ADC_MODEL_STATE_IDLE) && ChipEnable && (SingleRise || ContinuousRise);
+
+    // STEP 2: Combinational terms (the assigns of the core)
+    bool FifoFull = (Model->FifoCount == ADC_MODEL_FIFO_DEPTH);
+    bool FifoEmpty = (Model->FifoCount == 0);
+    bool FifoPopValid = Model->FifoPop && !FifoEmpty;
+    bool Irq = adcModel_Irq(Model);
+    bool FrameDone = (Model->State == ADC_MODEL_STATE_SHIFT) && Model->MisoSample && (Model->ShiftBitCount == 15);
+    bool LatchNow = Model->ResultPending && (FifoEnable || !Irq);
+    bool SampleTick = PeriodEnable && (Model->State != ADC_MODEL_STATE_IDLE) && (Model->State != ADC_MODEL_STATE_START) && (Model->PeriodCount == 0);
+    bool QuietDone = (Model->State == ADC_MODEL_STATE_QUIET) && (Model->QuietCount >= (ADC_MODEL_QUIET_SYS_CLKS - 1));
+    bool CountDone = (Model->ConversionCount == ((TotalConversions - 1U) & 0xFFFU)) && (!Model->CicRun || Model->CicOutputFrame);
+    bool ContinueCapture = Continuous && ChipEnable && (FreeRun || !CountDone);
+    bool StartReady = (!PeriodEnable || Model->SamplePending || SampleTick) && (!Model->ResultPending || LatchNow);
+    bool SampleTake = StartReady && ((QuietDone && ContinueCapture) || ((Model->State == ADC_MODEL_STATE_NEXT_CONV) && Continuous && ChipEnable));
+    bool FifoPush = FifoEnable && LatchNow && !FifoFull;
+    bool CicOutputReady = Model->CicCombActive && (Model->CicCombStep == (CicOrderM1 + 1U)) && Model->CicOutputFrame;
+    bool CaptureBusy = Model->StatusBusy || Model->ResultPending || Model->CicCombActive;
+    uint16_t ResultSample[2];
+    for (uint8_t Channel = CH_A; Channel <= CH_B; Channel++)
+    {
+        uint64_t Scaled = (Model->CicComb[Channel] & ADC_MODEL_CIC_MASK) >> CicShift;
+        uint16_t CicOut = (Scaled > 0xFFFFU) ? 0xFFFFU : (uint16_t)Scaled;
+        ResultSample[Channel] = Model->CicRun ? CicOut : (Model->Shift[Channel] & 0x0FFFU);
+    }
+    uint32_t ResultWord = Model->CicRun ? (((uint32_t)ResultSample[CH_A] << 16) | ResultSample[CH_B]) :
+                                          (((uint32_t)(ResultSample[CH_A] & 0x0FFFU) << 12) | (ResultSample[CH_B] & 0x0FFFU));
+
+    // STEP 3: Status ready, capture done, result latch, pending result
+    if (IrqClear || (AutoAck && Model->DataAB_Read))
+        Model->StatusReady = false;
+    else if (LatchNow && !FifoEnable)
+        Model->StatusReady = true;
+    if (Model->CaptureBusyDelay && !CaptureBusy)
+        Model->CaptureDone = true;
+    else if (IrqClear || CaptureStart)
+        Model->CaptureDone = false;
+    Model->CaptureBusyDelay = CaptureBusy;
+    if (LatchNow)
+    {
+        Model->Result[CH_A] = ResultSample[CH_A];
+        Model->Result[CH_B] = ResultSample[CH_B];
+        Model->DataAB = Model->CicRun ? ResultWord : (((uint32_t)Model->Sequence << 24) | (ResultWord & 0x00FFFFFFU));
+        Model->Sequence++;
+    }
+    if (Model->CicRun ? CicOutputReady : FrameDone)
+        Model->ResultPending = true;
+    else if (LatchNow)
+        Model->ResultPending = false;
+
+    // STEP 4: FIFO storage, pointers and overflow
+    if (FifoPopValid)
+        Model->FifoReadData = Model->FifoMemory[Model->FifoReadPointer];
+    if (FifoPush)
+        Model->FifoMemory[Model->FifoWritePointer] = ResultWord;
+    if (FlushRise)
+    {
+        Model->FifoWritePointer = 0;
+        Model->FifoReadPointer = 0;
+        Model->FifoCount = 0;
+        Model->FifoOverflow = false;
+    }
+    else
+    {
+        if (FifoPush)
+            Model->FifoWritePointer = (Model->FifoWritePointer + 1U) % ADC_MODEL_FIFO_DEPTH;
+        if (FifoPopValid)
+            Model->FifoReadPointer = (Model->FifoReadPointer + 1U) % ADC_MODEL_FIFO_DEPTH;
+        if (FifoPush && !FifoPopValid)
+            Model->FifoCount++;
+        else if (FifoPopValid && !FifoPush)
+            Model->FifoCount--;
+        if (IrqClear)
+            Model->FifoOverflow = false;
+        else if (FifoEnable && LatchNow && FifoFull)
+            Model->FifoOverflow = true;
+    }
+
+    // STEP 5: CIC decimator
+    if (CaptureStart)
+    {
+        Model->CicRun = CicEnable && ContinuousRise;
+        Model->CicInput = false;
+        Model->CicDecimCount = 0;
+        Model->CicPrimeCount = CicOrderM1;
+        Model->CicOutputFrame = false;
+        Model->CicCombActive = false;
+        Model->CicCombStep = 0;
+        memset(Model->CicInteg, 0x00, sizeof(Model->CicInteg));
+        memset(Model->CicDelay, 0x00, sizeof(Model->CicDelay));
+    }
+    else
+    {
+        bool CicInput = Model->CicInput;
+        bool CombActive = Model->CicCombActive;
+        uint8_t CombStep = Model->CicCombStep;
+        Model->CicInput = Model->CicRun && FrameDone;
+        if (CicInput)
+        {
+            for (uint8_t Channel = CH_A; Channel <= CH_B; Channel++)
+            {
+                for (uint8_t Stage = ADC_MODEL_CIC_MAX_ORDER - 1; Stage > 0; Stage--)
+                    Model->CicInteg[Channel][Stage] = (Model->CicInteg[Channel][Stage] + Model->CicInteg[Channel][Stage - 1]) & ADC_MODEL_CIC_MASK;
+                Model->CicInteg[Channel][0] = (Model->CicInteg[Channel][0] + (Model->Shift[Channel] & 0x0FFFU)) & ADC_MODEL_CIC_MASK;
+            }
+            if (Model->CicDecimCount == CicRatioM1)
+            {
+                Model->CicDecimCount = 0;
+                Model->CicCombActive = true;
+                Model->CicCombStep = 0;
+                Model->CicOutputFrame = (Model->CicPrimeCount == 0);
+                if (Model->CicPrimeCount != 0)
+                    Model->CicPrimeCount--;
+            }
+            else
+            {
+                Model->CicDecimCount++;
+                Model->CicOutputFrame = false;
+            }
+        }
+        if (CombActive)
+        {
+            for (uint8_t Channel = CH_A; Channel <= CH_B; Channel++)
+            {
+                if (CombStep == 0)
+                {
+                    Model->CicComb[Channel] = Model->CicInteg[Channel][CicOrderM1];
+                }
+                else
+                {
+                    uint64_t Comb = Model->CicComb[Channel];
+                    Model->CicComb[Channel] = (Comb - Model->CicDelay[Channel][CombStep - 1]) & ADC_MODEL_CIC_MASK;
+                    Model->CicDelay[Channel][CombStep - 1] = Comb;
+                }
+            }
+            if (CombStep == (CicOrderM1 + 1U))
+                Model->CicCombActive = false;
+            Model->CicCombStep = (CombStep + 1U) & 0x07U;
+        }
+    }
+
+    // STEP 6: Sample period timer
+    if ((Model->State == ADC_MODEL_STATE_IDLE) || (Model->State == ADC_MODEL_STATE_START))
+    {
+        Model->PeriodCount = (SamplePeriod - 1U) & 0x00FFFFFFU;
+        Model->SamplePending = false;
+        if ((Model->State == ADC_MODEL_STATE_IDLE) && (IrqClear || (ChipEnable && (SingleRise || ContinuousRise))))
+            Model->StatusOverrun = false;
+    }
+    else
+    {
+        Model->PeriodCount = (Model->PeriodCount == 0) ? ((SamplePeriod - 1U) & 0x00FFFFFFU) : (Model->PeriodCount - 1U);
+        if (SampleTick && !SampleTake)
+            Model->SamplePending = true;
+        else if (SampleTake)
+            Model->SamplePending = false;
+        if (Continuous && SampleTick && !SampleTake && !(QuietDone && !ContinueCapture))
+            Model->StatusOverrun = true;
+        else if (IrqClear)
+            Model->StatusOverrun = false;
+    }
+
+    // STEP 7: SCLK divider
+    bool Clock = Model->Clock;
+    if (Model->State == ADC_MODEL_STATE_SHIFT)
+    {
+        uint8_t HalfCount = ((Clock && ClockOdd) ? (Divider - 2U) : (Divider - 1U)) & 0x0FU;
+        if (Model->ClockDividerCount == HalfCount)
+        {
+            Model->ClockDividerCount = 0;
+            Model->Clock = !Clock;
+        }
+        else
+        {
+            Model->ClockDividerCount = (Model->ClockDividerCount + 1U) & 0x0FU;
+        }
+    }
+    else
+    {
+        Model->ClockDividerCount = 0;
+        Model->Clock = false;
+    }
+
+    // STEP 8: Main FSM - the AD7476A loads its frame on the CS_n fall
+    Type_ADC_ModelState State = Model->State;
+    switch (State)
+    {
+        case ADC_MODEL_STATE_IDLE:
+            Model->StatusBusy = false;
+            if (ChipEnable && (SingleRise || ContinuousRise))
+            {
+                Model->ShiftBitCount = 0;
+                Model->ConversionCount = 0;
+                Model->State = ADC_MODEL_STATE_START;
+            }
+            break;
+
+        case ADC_MODEL_STATE_START:
+            if (!Model->ResultPending || LatchNow)
+            {
+                Model->StatusDebug = 0x00;
+                Model->StatusBusy = true;
+                Model->State = ADC_MODEL_STATE_SHIFT;
+            }
+            break;
+
+        case ADC_MODEL_STATE_SHIFT:
+            if (Model->MisoSample)
+            {
+                for (uint8_t Channel = CH_A; Channel <= CH_B; Channel++)
+                {
+                    uint16_t Miso = (Model->Frame[Channel] >> (15U - Model->ShiftBitCount)) & 0x01U;
+                    Model->Shift[Channel] = (uint16_t)((Model->Shift[Channel] << 1) | Miso);
+                }
+                Model->ShiftBitCount++;
+                if (Model->ShiftBitCount == 16)
+                {
+                    Model->ShiftBitCount = 0;
+                    Model->QuietCount = 0;
+                    Model->State = ADC_MODEL_STATE_QUIET;
+                }
+            }
+            break;
+
+        case ADC_MODEL_STATE_QUIET:
+            if (QuietDone)
+            {
+                if (ContinueCapture)
+                {
+                    if (!Model->CicRun || Model->CicOutputFrame)
+                        Model->ConversionCount = (Model->ConversionCount + 1U) & 0xFFFU;
+                    Model->StatusDebug |= SampleTake ? 0x05 : 0x01;
+                    Model->State = SampleTake ? ADC_MODEL_STATE_SHIFT : ADC_MODEL_STATE_NEXT_CONV;
+                }
+                else
+                {
+                    Model->StatusDebug |= Continuous ? 0x02 : 0x08;
+                    Model->StatusBusy = false;
+                    Model->State = ADC_MODEL_STATE_IDLE;
+                }
+            }
+            else
+            {
+                Model->QuietCount++;
+            }
+            break;
+
+        case ADC_MODEL_STATE_NEXT_CONV:
+            if (!(Continuous && ChipEnable))
+            {
+                Model->StatusBusy = false;
+                Model->State = ADC_MODEL_STATE_IDLE;
+            }
+            else if (SampleTake)
+            {
+                Model->StatusDebug |= 0x04;
+                Model->State = ADC_MODEL_STATE_SHIFT;
+            }
+            break;
+
+        default:
+            Model->State = ADC_MODEL_STATE_IDLE;
+            break;
+    }
+    Model->Cycle++;
+    if ((Model->State == ADC_MODEL_STATE_SHIFT) && (State != ADC_MODEL_STATE_SHIFT))
+    {
+        double Time = (double)Model->Cycle / ADC_MODEL_SYSCLK_HZ;
+        Model->Frame[CH_A] = Model->Waveform ? sampleADC_Waveform(Model->Waveform, CH_A, Time) : 0;
+        Model->Frame[CH_B] = Model->Waveform ? sampleADC_Waveform(Model->Waveform, CH_B, Time) : 0;
+        Model->Conversions++;
+        Model->LastConversionCycle = Model->Cycle;
+    }
+
+    // STEP 9: Edge detect registers, the IRQ_CLR self clear and statistics
+    Model->SingleDelay = Single;
+    Model->ContinuousDelay = Continuous;
+    Model->FlushDelay = FifoFlush;
+    Model->ClockDelay = Clock;
+    Model->MisoSample = ClockRise;
+    Model->Register[REG_IRQ] &= ~(0x01U << 1);
+    Model->FifoPop = false;
+    Model->DataAB_Read = false;
+    bool IrqLevel = adcModel_Irq(Model);
+    if (IrqLevel && !Model->IrqLevel)
+        Model->IrqRisingEdges++;
+    Model->IrqLevel = IrqLevel;
+    (void)Threshold;
+
+} // END OF adcModel_Step
+
+
+
+/********************************************************************************************************
+* @brief True when a clock would change nothing but the cycle count - idle with no edge, pulse or result
+* in flight - so time can be skipped
+*
+* @author original: Hab Collector \n
+*
+* @param Model: IP model
+*
+* @return True if quiescent
+********************************************************************************************************/
+static bool adcModel_Quiescent(const Type_ADC_Model *Model)
+{
+    uint32_t Control = Model->Register[REG_CTRL];
+    bool Single = BIT(Control, 1) && !BIT(Control, 2);
+    bool Continuous = BIT(Control, 1) && BIT(Control, 2);
+
+    if ((Model->State != ADC_MODEL_STATE_IDLE) || Model->StatusBusy || Model->ResultPending || Model->CaptureBusyDelay)
+        return(false);
+    if (Model->CicCombActive || Model->CicInput || Model->Clock || Model->ClockDelay || Model->MisoSample)
+        return(false);
+    if (Model->FifoPop || Model->DataAB_Read || BIT(Model->Register[REG_IRQ], 1))
+        return(false);
+    if ((Single != Model->SingleDelay) || (Continuous != Model->ContinuousDelay) || (BIT(Model->Register[REG_FIFO_CTRL], 17) != Model->FlushDelay))
+        return(false);
+    return(true);
+
+} // END OF adcModel_Quiescent
+
+
+
+/********************************************************************************************************
+* @brief Resets the model to the IP power on state
+*
+* @author original: Hab Collector \n
+*
+* @param Model: IP model
+* @param Waveform: Analog input of both ADCs (NULL reads 0)
+********************************************************************************************************/
+void initADC_Model(Type_ADC_Model *Model, Type_ADC_Waveform *Waveform)
+{
+    memset(Model, 0x00, sizeof(Type_ADC_Model));
+    Model->Waveform = Waveform;
+    Model->ReadCycles = ADC_MODEL_READ_CYCLES;
+    Model->WriteCycles = ADC_MODEL_WRITE_CYCLES;
+
+} // END OF initADC_Model
+
+
+
+/********************************************************************************************************
+* @brief Runs the IP for a number of SysClks - idle stretches are skipped
+*
+* @author original: Hab Collector \n
+*
+* @param Model: IP model
+* @param Cycles: SysClks to run
+********************************************************************************************************/
+void ADC_Model_Advance(Type_ADC_Model *Model, uint64_t Cycles)
+{
+    while (Cycles != 0)
+    {
+        if (adcModel_Quiescent(Model))
+        {
+            Model->Cycle += Cycles;
+            return;
+        }
+        adcModel_Step(Model);
+        Cycles--;
+    }
+
+} // END OF ADC_Model_Advance
+
+
+
+/********************************************************************************************************
+* @brief AXI-lite read.  The bus time passes, the address handshake pops FIFO_DATA / acknowledges DATA_AB,
+* and the value is the register after that edge - as RDATA is with RVALID
+*
+* @author original: Hab Collector \n
+*
+* @param Model: IP model
+* @param Offset: Byte offset
+*
+* @return Register value
+********************************************************************************************************/
+uint32_t ADC_Model_Read(Type_ADC_Model *Model, uint32_t Offset)
+{
+    uint32_t Index = (Offset % ADC_MODEL_SPAN) >> 2;
+    uint32_t Value = 0;
+
+    Model->BusReads++;
+    if (Model->ReadCycles > 1)
+        ADC_Model_Advance(Model, Model->ReadCycles - 1);
+    Model->FifoPop = (Index == REG_FIFO_DATA);
+    Model->DataAB_Read = (Index == REG_DATA_AB);
+    adcModel_Step(Model);
+
+    switch (Index)
+    {
+        case REG_STATUS:
+            Value = (Model->StatusBusy || Model->ResultPending || Model->CicCombActive) ? 0x01U : 0x00U;
+            Value |= Model->StatusReady ? (0x01U << 1) : 0;
+            Value |= Model->StatusOverrun ? (0x01U << 5) : 0;
+            Value |= Model->CaptureDone ? (0x01U << 6) : 0;
+            Value |= (uint32_t)Model->State << 8;
+            Value |= (uint32_t)(Model->StatusDebug & 0x0FU) << 12;
+            Value |= (uint32_t)Model->ConversionCount << 16;
+            Value |= (uint32_t)ADC_MODEL_REVISION << 28;
+            break;
+        case REG_DATA_A:
+            Value = Model->Result[CH_A];
+            break;
+        case REG_DATA_B:
+            Value = Model->Result[CH_B];
+            break;
+        case REG_FIFO_STATUS:
+        {
+            uint16_t Threshold = FIELD(Model->Register[REG_FIFO_CTRL], 0, 0x7FFU);
+            Value = Model->FifoCount;
+            Value |= ((Threshold != 0) && (Model->FifoCount >= Threshold)) ? (0x01U << 16) : 0;
+            Value |= Model->FifoOverflow ? (0x01U << 17) : 0;
+            Value |= (Model->FifoCount == 0) ? (0x01U << 18) : 0;
+            Value |= (Model->FifoCount == ADC_MODEL_FIFO_DEPTH) ? (0x01U << 19) : 0;
+            Value |= ((Model->FifoCount != 0) && (Model->State == ADC_MODEL_STATE_IDLE)) ? (0x01U << 20) : 0;
+            break;
+        }
+        case REG_FIFO_DATA:
+            Value = Model->FifoReadData;
+            break;
+        case REG_DATA_AB:
+            Value = Model->DataAB;
+            break;
+        case REG_DMA_PRODUCER:
+        case REG_TRIG_STATUS:
+            Value = 0;
+            break;
+        default:
+            Value = (Index < ADC_MODEL_REGISTERS) ? Model->Register[Index] : 0;
+            break;
+    }
+    return(Value);
+
+} // END OF ADC_Model_Read
+
+
+
+/********************************************************************************************************
+* @brief AXI-lite write.  The bus time passes and the register takes the value on the handshake; the core
+* sees it from the next clock.  Read only registers ignore writes
+*
+* @author original: Hab Collector \n
+*
+* @param Model: IP model
+* @param Offset: Byte offset
+* @param Value: Register value
+********************************************************************************************************/
+void ADC_Model_Write(Type_ADC_Model *Model, uint32_t Offset, uint32_t Value)
+{
+    uint32_t Index = (Offset % ADC_MODEL_SPAN) >> 2;
+
+    Model->BusWrites++;
+    if (Model->WriteCycles != 0)
+        ADC_Model_Advance(Model, Model->WriteCycles);
+    switch (Index)
+    {
+        case REG_STATUS:
+        case REG_DATA_A:
+        case REG_DATA_B:
+        case REG_FIFO_STATUS:
+        case REG_FIFO_DATA:
+        case REG_DATA_AB:
+        case REG_DMA_PRODUCER:
+        case REG_TRIG_STATUS:
+            break;
+        default:
+            if (Index < ADC_MODEL_REGISTERS)
+                Model->Register[Index] = Value;
+            break;
+    }
+
+} // END OF ADC_Model_Write
+
+
+
+/********************************************************************************************************
+* @brief Present level of the IP interrupt line
+*
+* @author original: Hab Collector \n
+*
+* @param Model: IP model
+*
+* @return True if IRQ is high
+********************************************************************************************************/
+bool getADC_ModelIrq(Type_ADC_Model *Model)
+{
+    return(adcModel_Irq(Model));
+
+} // END OF getADC_ModelIrq
+
+
+
+/********************************************************************************************************
+* @brief Two tones, mid scale, same amplitude on both channels
+*
+* @author original: Hab Collector \n
+*
+* @param Waveform: Waveform to set up
+* @param FrequencyA: Channel A tone in Hz
+* @param FrequencyB: Channel B tone in Hz
+* @param Amplitude: Peak in ADC codes (2047 = full scale)
+* @param Noise: RMS in ADC codes, 0 for none
+********************************************************************************************************/
+void initADC_WaveformSine(Type_ADC_Waveform *Waveform, double FrequencyA, double FrequencyB, double Amplitude, double Noise)
+{
+    memset(Waveform, 0x00, sizeof(Type_ADC_Waveform));
+    Waveform->Kind = ADC_WAVEFORM_SINE;
+    Waveform->Frequency[CH_A] = FrequencyA;
+    Waveform->Frequency[CH_B] = FrequencyB;
+    Waveform->Amplitude[CH_A] = Amplitude;
+    Waveform->Amplitude[CH_B] = Amplitude;
+    Waveform->Offset[CH_A] = 2048.0;
+    Waveform->Offset[CH_B] = 2048.0;
+    Waveform->Noise = Noise;
+    Waveform->NoiseState = 0x12345678U;
+
+} // END OF initADC_WaveformSine
+
+
+
+/********************************************************************************************************
+* @brief Loads an 8 or 16 bit PCM WAV file as the ADC input - full scale PCM maps to the full ADC range
+*
+* @author original: Hab Collector \n
+*
+* @param Waveform: Waveform to set up
+* @param Path: WAV file
+*
+* @return True if loaded
+*
+* STEP 1: RIFF / WAVE header
+* STEP 2: Walk the chunks for fmt and data
+* STEP 3: Keep the samples - 8 bit (unsigned) widened to 16 bit
+********************************************************************************************************/
+bool loadADC_WaveformWav(Type_ADC_Waveform *Waveform, const char *Path)
+{
+    uint8_t Header[12];
+    uint8_t Chunk[8];
+    uint16_t Format = 0;
+    uint16_t BitsPerSample = 0;
+    FILE *File = fopen(Path, "rb");
+
+    memset(Waveform, 0x00, sizeof(Type_ADC_Waveform));
+    if (File == NULL)
+        return(false);
+
+    // STEP 1: RIFF / WAVE header
+    if ((fread(Header, 1, sizeof(Header), File) != sizeof(Header)) || (memcmp(Header, "RIFF", 4) != 0) || (memcmp(&Header[8], "WAVE", 4) != 0))
+    {
+        fclose(File);
+        return(false);
+    }
+
+    // STEP 2: Walk the chunks for fmt and data
+    while (fread(Chunk, 1, sizeof(Chunk), File) == sizeof(Chunk))
+    {
+        uint32_t ChunkSize = Chunk[4] | ((uint32_t)Chunk[5] << 8) | ((uint32_t)Chunk[6] << 16) | ((uint32_t)Chunk[7] << 24);
+        if (memcmp(Chunk, "fmt ", 4) == 0)
+        {
+            uint8_t FormatChunk[16];
+            if ((ChunkSize < sizeof(FormatChunk)) || (fread(FormatChunk, 1, sizeof(FormatChunk), File) != sizeof(FormatChunk)))
+                break;
+            Format = FormatChunk[0] | (FormatChunk[1] << 8);
+            Waveform->PcmChannels = FormatChunk[2] | (FormatChunk[3] << 8);
+            Waveform->PcmRate = FormatChunk[4] | ((uint32_t)FormatChunk[5] << 8) | ((uint32_t)FormatChunk[6] << 16) | ((uint32_t)FormatChunk[7] << 24);
+            BitsPerSample = FormatChunk[14] | (FormatChunk[15] << 8);
+            fseek(File, (long)(ChunkSize - sizeof(FormatChunk) + (ChunkSize & 0x01U)), SEEK_CUR);
+        }
+        else if (memcmp(Chunk, "data", 4) == 0)
+        {
+            // STEP 3: Keep the samples - 8 bit (unsigned) widened to 16 bit
+            if ((Format != 1) || ((BitsPerSample != 8) && (BitsPerSample != 16)) || (Waveform->PcmChannels == 0) || (Waveform->PcmRate == 0))
+                break;
+            uint32_t BytesPerSample = BitsPerSample / 8U;
+            Waveform->Pcm = malloc((ChunkSize / BytesPerSample) * sizeof(int16_t));
+            if (Waveform->Pcm == NULL)
+                break;
+            size_t Read = fread(Waveform->Pcm, 1, ChunkSize, File);
+            if (BytesPerSample == 1)
+            {
+                uint8_t *Bytes = (uint8_t *)Waveform->Pcm;
+                for (size_t Index = Read; Index > 0; Index--)
+                    Waveform->Pcm[Index - 1] = (int16_t)((Bytes[Index - 1] - 128) * 256);
+            }
+            Waveform->PcmFrames = (uint32_t)(Read / (BytesPerSample * Waveform->PcmChannels));
+            Waveform->Kind = ADC_WAVEFORM_WAV;
+            fclose(File);
+            return(Waveform->PcmFrames != 0);
+        }
+        else
+        {
+            fseek(File, (long)(ChunkSize + (ChunkSize & 0x01U)), SEEK_CUR);
+        }
+    }
+    fclose(File);
+    freeADC_Waveform(Waveform);
+    return(false);
+
+} // END OF loadADC_WaveformWav
+
+
+
+/********************************************************************************************************
+* @brief Releases a WAV waveform
+*
+* @author original: Hab Collector \n
+*
+* @param Waveform: Waveform
+********************************************************************************************************/
+void freeADC_Waveform(Type_ADC_Waveform *Waveform)
+{
+    free(Waveform->Pcm);
+    Waveform->Pcm = NULL;
+    Waveform->PcmFrames = 0;
+
+} // END OF freeADC_Waveform
+
+
+
+/********************************************************************************************************
+* @brief The ADC code a channel converts at a time - the AD7476A track and hold closes on the CS_n fall
+*
+* @author original: Hab Collector \n
+*
+* @note: WAV input is linearly interpolated between PCM frames and loops
+*
+* @param Waveform: Waveform
+* @param Channel: 0 = A, 1 = B
+* @param Time: Seconds since reset
+*
+* @return 12 bit code
+********************************************************************************************************/
+uint16_t sampleADC_Waveform(Type_ADC_Waveform *Waveform, uint8_t Channel, double Time)
+{
+    double Value;
+
+    if (Waveform->Kind == ADC_WAVEFORM_WAV)
+    {
+        double Position = fmod(Time * Waveform->PcmRate, (double)Waveform->PcmFrames);
+        uint32_t Frame = (uint32_t)Position;
+        uint32_t NextFrame = (Frame + 1U) % Waveform->PcmFrames;
+        uint16_t Column = (Channel < Waveform->PcmChannels) ? Channel : 0;
+        double Fraction = Position - Frame;
+        double Pcm = (Waveform->Pcm[(Frame * Waveform->PcmChannels) + Column] * (1.0 - Fraction)) +
+                     (Waveform->Pcm[(NextFrame * Waveform->PcmChannels) + Column] * Fraction);
+        Value = 2048.0 + (Pcm / 16.0);
+    }
+    else
+    {
+        Value = Waveform->Offset[Channel] + (Waveform->Amplitude[Channel] * sin(2.0 * M_PI * Waveform->Frequency[Channel] * Time));
+        if (Waveform->Noise > 0.0)
+        {
+            // Box-Muller on a xorshift32 pair - repeatable runs
+            double Uniform[2];
+            for (uint8_t Draw = 0; Draw < 2; Draw++)
+            {
+                Waveform->NoiseState ^= Waveform->NoiseState << 13;
+                Waveform->NoiseState ^= Waveform->NoiseState >> 17;
+                Waveform->NoiseState ^= Waveform->NoiseState << 5;
+                Uniform[Draw] = (Waveform->NoiseState + 1.0) / 4294967297.0;
+            }
+            Value += Waveform->Noise * sqrt(-2.0 * log(Uniform[0])) * cos(2.0 * M_PI * Uniform[1]);
+        }
+    }
+
+    Value = floor(Value + 0.5);
+    if (Value < 0.0)
+        Value = 0.0;
+    if (Value > 4095.0)
+        Value = 4095.0;
+    return((uint16_t)Value);
+
+} // END OF sampleADC_Waveform
+
+
+
+/********************************************************************************************************
+* @brief Puts the model behind Xil_In32 / Xil_Out32 at the IP base address the driver is given
+*
+* @author original: Hab Collector \n
+*
+* @param Model: IP model (NULL detaches)
+* @param BaseAddress: IP base address - ADC_MODEL_SPAN bytes
+********************************************************************************************************/
+void attachADC_ModelBus(Type_ADC_Model *Model, uint32_t BaseAddress)
+{
+    BusModel = Model;
+    BusBaseAddress = BaseAddress;
+
+} // END OF attachADC_ModelBus
+
+
+
+// BSP SHIM - bsp_shim/xil_io.h
+u32 Xil_In32(UINTPTR Addr)
+{
+    if ((BusModel == NULL) || (Addr < BusBaseAddress) || ((Addr - BusBaseAddress) >= ADC_MODEL_SPAN))
+        return(0);
+    return(ADC_Model_Read(BusModel, (uint32_t)(Addr - BusBaseAddress)));
+}
+
+void Xil_Out32(UINTPTR Addr, u32 Value)
+{
+    if ((BusModel == NULL) || (Addr < BusBaseAddress) || ((Addr - BusBaseAddress) >= ADC_MODEL_SPAN))
+        return;
+    ADC_Model_Write(BusModel, (uint32_t)(Addr - BusBaseAddress), Value);
+}
+
+
+
+// BSP SHIM - FAT_FS/diskio_timing.h: the time base is the SysClk count of the model on the bus
+u32 disk_time_now(void)
+{
+    static u32 SoftTicks = 0;
+
+    if (BusModel == NULL)
+        return(SoftTicks += DISK_TIME_TICKS_PER_US);
+    return((u32)BusModel->Cycle);
+}
+
+u32 disk_time_elapsed_us(u32 StartTicks)
+{
+    return((disk_time_now() - StartTicks) / DISK_TIME_TICKS_PER_US);
+}
+
+int disk_time_expired(u32 StartTicks, u32 TimeoutUs)
+{
+    return(disk_time_elapsed_us(StartTicks) >= TimeoutUs);
+}
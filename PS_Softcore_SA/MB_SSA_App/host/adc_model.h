@@ -0,0 +1,151 @@
+/******************************************************************************************************
+ * @file            adc_model.h
+ * @brief           Header file to support adc_model.c
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        Linux host (no target hardware) \n
+ * IDE:             Vitis 2024.2 / make \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#ifndef ADC_MODEL_H_
+#define ADC_MODEL_H_
+#ifdef __cplusplus
+extern"C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// DEFINES
+#define ADC_MODEL_SYSCLK_HZ         100000000U  // s00_axi_aclk
+#define ADC_MODEL_REGISTERS         22U         // slv_reg0 - slv_reg21, 0x00 - 0x54
+#define ADC_MODEL_SPAN              0x80U       // AXI-lite address space (C_S_AXI_ADDR_WIDTH 7)
+#define ADC_MODEL_FIFO_DEPTH        1024U
+#define ADC_MODEL_CIC_MAX_ORDER     4U
+#define ADC_MODEL_CIC_MASK          0x00000FFFFFFFFFFFULL   // CIC_WIDTH 44 bits - the integrators wrap
+#define ADC_MODEL_QUIET_SYS_CLKS    6U
+#define ADC_MODEL_REVISION          11U         // STATUS [31:28] of the RTL modelled
+#define ADC_MODEL_READ_CYCLES       12U         // Default SysClks per AXI-lite read from the MicroBlaze (bus + stall)
+#define ADC_MODEL_WRITE_CYCLES      8U          // Default SysClks per AXI-lite write
+
+// TYPEDEFS AND ENUMS
+typedef enum
+{
+    ADC_MODEL_STATE_IDLE = 0,
+    ADC_MODEL_STATE_START,
+    ADC_MODEL_STATE_SHIFT,
+    ADC_MODEL_STATE_QUIET = 4,              // STATUS [10:8] encodings as the RTL - 3 is unused
+    ADC_MODEL_STATE_NEXT_CONV
+}Type_ADC_ModelState;
+
+typedef enum
+{
+    ADC_WAVEFORM_SINE = 0,                  // Tone per channel plus optional noise
+    ADC_WAVEFORM_WAV                        // 8 / 16 bit PCM file, left to A, right (or mono) to B
+}Type_ADC_WaveformKind;
+
+typedef struct
+{
+    Type_ADC_WaveformKind       Kind;
+    double                      Frequency[2];       // Hz, channel A and B
+    double                      Amplitude[2];       // ADC codes peak
+    double                      Offset[2];          // ADC codes (2048 = mid scale)
+    double                      Noise;              // ADC codes RMS, both channels
+    int16_t                     *Pcm;               // WAV: interleaved samples, 16 bit
+    uint32_t                    PcmFrames;
+    uint16_t                    PcmChannels;
+    uint32_t                    PcmRate;            // Hz - resampled to the conversion instants, looped
+    uint32_t                    NoiseState;         // Deterministic noise generator
+}Type_ADC_Waveform;
+
+typedef struct
+{
+    uint32_t                    Register[ADC_MODEL_REGISTERS];  // Bus written registers (read only ones unused)
+    uint64_t                    Cycle;              // SysClks since reset
+    Type_ADC_Waveform           *Waveform;
+    // Edge detect and bus pulses
+    bool                        SingleDelay;
+    bool                        ContinuousDelay;
+    bool                        FlushDelay;
+    bool                        ClockDelay;
+    bool                        MisoSample;         // Take MISO - the clock after the SCLK rise detect
+    bool                        FifoPop;            // One clock pulses from the bus
+    bool                        DataAB_Read;
+    // FSM
+    Type_ADC_ModelState         State;
+    bool                        StatusBusy;
+    bool                        StatusReady;
+    bool                        StatusOverrun;
+    bool                        CaptureBusyDelay;   // STATUS BUSY last clock - its fall sets CaptureDone
+    bool                        CaptureDone;        // STATUS DONE (sticky)
+    uint8_t                     StatusDebug;
+    uint8_t                     ShiftBitCount;
+    uint8_t                     QuietCount;
+    uint16_t                    ConversionCount;
+    uint8_t                     ClockDividerCount;
+    bool                        Clock;              // SCLK
+    uint16_t                    Shift[2];
+    uint16_t                    Frame[2];           // {4'b0000, sample} loaded on the CS_n fall
+    uint32_t                    PeriodCount;
+    bool                        SamplePending;
+    // Result latch
+    bool                        ResultPending;
+    uint16_t                    Result[2];
+    uint32_t                    DataAB;
+    uint8_t                     Sequence;
+    // FIFO
+    uint32_t                    FifoMemory[ADC_MODEL_FIFO_DEPTH];
+    uint16_t                    FifoWritePointer;
+    uint16_t                    FifoReadPointer;
+    uint16_t                    FifoCount;
+    bool                        FifoOverflow;
+    uint32_t                    FifoReadData;
+    // CIC decimator
+    bool                        CicRun;
+    bool                        CicInput;
+    uint64_t                    CicInteg[2][ADC_MODEL_CIC_MAX_ORDER];
+    uint64_t                    CicDelay[2][ADC_MODEL_CIC_MAX_ORDER];
+    uint64_t                    CicComb[2];
+    uint8_t                     CicDecimCount;
+    uint8_t                     CicPrimeCount;
+    bool                        CicOutputFrame;
+    bool                        CicCombActive;
+    uint8_t                     CicCombStep;
+    // Statistics
+    uint64_t                    Conversions;        // CS_n falls
+    uint64_t                    LastConversionCycle;
+    uint64_t                    IrqRisingEdges;
+    bool                        IrqLevel;
+    uint64_t                    BusReads;
+    uint64_t                    BusWrites;
+    uint32_t                    ReadCycles;         // Bus cost charged per access
+    uint32_t                    WriteCycles;
+}Type_ADC_Model;
+
+
+// FUNCTION PROTOTYPES
+void initADC_Model(Type_ADC_Model *Model, Type_ADC_Waveform *Waveform);
+void ADC_Model_Advance(Type_ADC_Model *Model, uint64_t Cycles);
+uint32_t ADC_Model_Read(Type_ADC_Model *Model, uint32_t Offset);
+void ADC_Model_Write(Type_ADC_Model *Model, uint32_t Offset, uint32_t Value);
+bool getADC_ModelIrq(Type_ADC_Model *Model);
+void initADC_WaveformSine(Type_ADC_Waveform *Waveform, double FrequencyA, double FrequencyB, double Amplitude, double Noise);
+bool loadADC_WaveformWav(Type_ADC_Waveform *Waveform, const char *Path);
+void freeADC_Waveform(Type_ADC_Waveform *Waveform);
+uint16_t sampleADC_Waveform(Type_ADC_Waveform *Waveform, uint8_t Channel, double Time);
+void attachADC_ModelBus(Type_ADC_Model *Model, uint32_t BaseAddress);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* ADC_MODEL_H_ */
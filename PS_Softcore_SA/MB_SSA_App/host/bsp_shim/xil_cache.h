@@ -0,0 +1,35 @@
+/******************************************************************************************************
+ * @file            xil_cache.h
+ * @brief           Host stand-in for the MicroBlaze cache maintenance calls - nothing to maintain
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        Linux host (no target hardware) \n
+ * IDE:             Vitis 2024.2 / make \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#ifndef XIL_CACHE_H
+#define XIL_CACHE_H
+
+#include "xil_io.h"
+
+static inline void Xil_DCacheFlushRange(UINTPTR Address, u32 Length)
+{
+    (void)Address;
+    (void)Length;
+}
+
+static inline void Xil_DCacheInvalidateRange(UINTPTR Address, u32 Length)
+{
+    (void)Address;
+    (void)Length;
+}
+
+#endif /* XIL_CACHE_H */
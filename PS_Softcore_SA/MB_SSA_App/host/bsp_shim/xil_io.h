@@ -0,0 +1,29 @@
+/******************************************************************************************************
+ * @file            xil_io.h
+ * @brief           Host stand-in for the standalone BSP xil_io.h - AXI register access into adc_model.c
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        Linux host (no target hardware) \n
+ * IDE:             Vitis 2024.2 / make \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            Only the accesses the ADC driver uses.  Addresses inside the span given to
+ *                  attachADC_ModelBus reach the IP model, charged its bus cycles; others read 0
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#ifndef XIL_IO_H
+#define XIL_IO_H
+
+#include "xil_types.h"
+
+u32 Xil_In32(UINTPTR Addr);
+void Xil_Out32(UINTPTR Addr, u32 Value);
+
+#endif /* XIL_IO_H */
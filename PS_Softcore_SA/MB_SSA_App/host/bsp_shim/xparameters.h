@@ -0,0 +1,25 @@
+/******************************************************************************************************
+ * @file            xparameters.h
+ * @brief           Host stand-in for the BSP hardware parameters - no INTC, so no fabric IRQ IDs;
+ *                  the diskio_timing time base runs at the model SysClk
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        Linux host (no target hardware) \n
+ * IDE:             Vitis 2024.2 / make \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#ifndef XPARAMETERS_H
+#define XPARAMETERS_H
+
+#define XPAR_AXI_TIMER_0_BASEADDR           0x41C00000U
+#define XPAR_AXI_TIMER_0_CLOCK_FREQUENCY    100000000U      // ADC_MODEL_SYSCLK_HZ
+
+#endif /* XPARAMETERS_H */
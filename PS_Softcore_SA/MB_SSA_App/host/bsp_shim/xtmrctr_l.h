@@ -0,0 +1,24 @@
+/******************************************************************************************************
+ * @file            xtmrctr_l.h
+ * @brief           Host stand-in for the AXI timer low level header diskio_timing.h includes
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        Linux host (no target hardware) \n
+ * IDE:             Vitis 2024.2 / make \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            Empty - the ADC driver uses only disk_time_now / disk_time_expired, which
+ *                  adc_model.c answers from the model SysClk count rather than a timer
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#ifndef XTMRCTR_L_H
+#define XTMRCTR_L_H
+
+#endif /* XTMRCTR_L_H */
@@ -0,0 +1,163 @@
+/* =============================================================================
+ *  File: diskio_file.c
+ *  Project: MicroBlaze + AXI Quad SPI (microSD Interface) - native Linux build
+ *  Author: IMR Engineering / Hab Collector
+ *  ---------------------------------------------------------------------------
+ *  Purpose:
+ *      SD card image storage backend for the native Linux build.  Sector N of
+ *      the drive is bytes [N*512, N*512+512) of the image file; transfers are
+ *      single pread()/pwrite() calls so multi-sector requests from FatFs stay
+ *      as large as they are on the card.
+ *
+ *  ---------------------------------------------------------------------------
+ *  Notes:
+ *      - POSIX only; never part of the MicroBlaze build.
+ *      - Partitioned (MBR) and unpartitioned images both work; FatFs finds
+ *        the volume the same way it does on the card.
+ *
+ *  ---------------------------------------------------------------------------
+ *  File Version History:
+ *      v1.0  – Initial image-file backend
+ * =============================================================================
+ */
+
+#define _XOPEN_SOURCE 700
+#include "diskio_file.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static int ImageFd = -1;            /* open image, -1 = no medium */
+static LBA_t ImageSectors = 0;      /* image size in sectors */
+static DSTATUS ImageStat = STA_NOINIT | STA_NODISK;
+
+/* Full transfer or failure: pread/pwrite may return short counts */
+static int file_xfer(int Write, BYTE *buff, LBA_t sector, UINT count)
+{
+    size_t Remaining = (size_t)count * DISK_FILE_SECTOR_SIZE;
+    off_t Offset = (off_t)sector * DISK_FILE_SECTOR_SIZE;
+
+    while (Remaining > 0u)
+    {
+        ssize_t Done = Write ? pwrite(ImageFd, buff, Remaining, Offset) : pread(ImageFd, buff, Remaining, Offset);
+        if (Done <= 0)
+        {
+            return -1;
+        }
+        buff += Done;
+        Offset += Done;
+        Remaining -= (size_t)Done;
+    }
+    return 0;
+}
+
+static DSTATUS file_status (BYTE pdrv)
+{
+    (void)pdrv;
+    return ImageStat;
+}
+
+static DSTATUS file_initialize (BYTE pdrv)
+{
+    (void)pdrv;
+    if (ImageFd >= 0)
+    {
+        ImageStat = 0;
+    }
+    return ImageStat;
+}
+
+static DRESULT file_read (BYTE pdrv, BYTE* buff, LBA_t sector, UINT count)
+{
+    (void)pdrv;
+    if ((sector >= ImageSectors) || (count > (ImageSectors - sector)))
+    {
+        return RES_PARERR;
+    }
+    return (file_xfer(0, buff, sector, count) == 0) ? RES_OK : RES_ERROR;
+}
+
+static DRESULT file_write (BYTE pdrv, const BYTE* buff, LBA_t sector, UINT count)
+{
+    (void)pdrv;
+    if ((sector >= ImageSectors) || (count > (ImageSectors - sector)))
+    {
+        return RES_PARERR;
+    }
+    return (file_xfer(1, (BYTE*)buff, sector, count) == 0) ? RES_OK : RES_ERROR;
+}
+
+static DRESULT file_ioctl (BYTE pdrv, BYTE cmd, void* buff)
+{
+    (void)pdrv;
+    if (ImageStat & STA_NOINIT)
+    {
+        return RES_NOTRDY;
+    }
+
+    switch (cmd)
+    {
+        case CTRL_SYNC:
+            return (fsync(ImageFd) == 0) ? RES_OK : RES_ERROR;
+        case GET_SECTOR_COUNT:
+            *(LBA_t*)buff = ImageSectors;
+            return RES_OK;
+        case GET_SECTOR_SIZE:
+            *(WORD*)buff = DISK_FILE_SECTOR_SIZE;
+            return RES_OK;
+        case GET_BLOCK_SIZE:
+            *(DWORD*)buff = 1;
+            return RES_OK;
+        default:
+            return RES_PARERR;
+    }
+}
+
+const DiskBackend DiskBackend_File =
+{
+    "image file",
+    file_initialize,
+    file_status,
+    file_read,
+    file_write,
+    file_ioctl,
+    NULL
+};
+
+DRESULT disk_file_attach(BYTE pdrv, const char *ImagePath, int Create, LBA_t SectorCount)
+{
+    struct stat Info;
+
+    disk_file_detach(pdrv);
+    ImageFd = open(ImagePath, Create ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR, 0644);
+    if (ImageFd < 0)
+    {
+        return RES_NOTRDY;
+    }
+    if (Create && (ftruncate(ImageFd, (off_t)SectorCount * DISK_FILE_SECTOR_SIZE) != 0))
+    {
+        disk_file_detach(pdrv);
+        return RES_ERROR;
+    }
+    if (fstat(ImageFd, &Info) != 0)
+    {
+        disk_file_detach(pdrv);
+        return RES_ERROR;
+    }
+
+    ImageSectors = (LBA_t)(Info.st_size / DISK_FILE_SECTOR_SIZE);
+    ImageStat = STA_NOINIT;
+    return disk_attach(pdrv, &DiskBackend_File);
+}
+
+void disk_file_detach(BYTE pdrv)
+{
+    (void)pdrv;
+    if (ImageFd >= 0)
+    {
+        close(ImageFd);
+    }
+    ImageFd = -1;
+    ImageSectors = 0;
+    ImageStat = STA_NOINIT | STA_NODISK;
+}
@@ -0,0 +1,34 @@
+/* =============================================================================
+ *  File: diskio_file.h
+ *  Project: MicroBlaze + AXI Quad SPI (microSD Interface) - native Linux build
+ *  Author: IMR Engineering / Hab Collector
+ *  ---------------------------------------------------------------------------
+ *  Purpose:
+ *      SD card image storage backend (diskio_file.c).  Serves a drive from a
+ *      raw image file (e.g. "dd if=/dev/sdX of=card.img") with pread/pwrite.
+ * =============================================================================
+ */
+
+#ifndef _DISKIO_FILE_DEFINED
+#define _DISKIO_FILE_DEFINED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "diskio.h"
+
+#define DISK_FILE_SECTOR_SIZE   512U
+
+/* Backend table */
+extern const DiskBackend DiskBackend_File;
+
+/* Open (Create != 0: create / truncate to SectorCount sectors) and attach to pdrv */
+DRESULT disk_file_attach(BYTE pdrv, const char *ImagePath, int Create, LBA_t SectorCount);
+/* Close the image; the drive reads as no medium until re-attached */
+void    disk_file_detach(BYTE pdrv);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _DISKIO_FILE_DEFINED */
@@ -0,0 +1,236 @@
+/******************************************************************************************************
+ * @file            display_bench.c
+ * @brief           Native Linux benchmark / regression run of the spectrum bar blitter
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        Linux host (no target hardware) \n
+ * IDE:             Vitis 2024.2 / make \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            Builds u8g2 and Display_Spectrum unchanged from src/ on an SSD1309 128x64 full buffer
+ *                  setup with no display attached, then for each bar geometry:
+ *                    1) Renders 256 random frames both ways - u8g2_ClearBuffer + a u8g2_DrawBox per
+ *                       segment and peak (the drawSpectrumMock path) and drawSpectrumBars
+ *                    2) Checks the two buffers are identical, and that drawSpectrumBars leaves every
+ *                       bit outside the bar band untouched
+ *                    3) Reports ns per frame for each path
+ *                  Exit non zero on any mismatch.
+ *
+ *                  Usage: display_bench
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "u8g2.h"
+#include "Display_Spectrum.h"
+
+// DEFINES
+#define BENCH_FRAMES            20000U
+#define BENCH_FRAME_BYTES       (SPECTRUM_DISPLAY_WIDTH * SPECTRUM_PAGE_COUNT)
+#define BENCH_LEVEL_SETS        256U                // Frames of random levels, generated outside the timed loops
+
+// STATIC VARIABLES
+static u8g2_t U8G2;
+static Type_SpectrumBlitter Blitter;
+static uint8_t BarLevel[BENCH_LEVEL_SETS][SPECTRUM_MAX_BARS];
+static uint8_t PeakLevel[BENCH_LEVEL_SETS][SPECTRUM_MAX_BARS];
+static uint8_t Reference[BENCH_FRAME_BYTES];
+
+static const Type_SpectrumConfig BenchConfig[] =
+{
+    // Bars Width HSpace X_Offset Baseline SegH VSpace Levels
+    { 16,   4,     2,     0,       60,      2,   1,     10 },  // drawSpectrumMock
+    { 16,   6,     2,     1,       64,      3,   1,     16 },
+    { 32,   3,     1,     0,       64,      1,   0,     64 },  // Solid bars, one level per row
+    { 64,   1,     1,     0,       63,      2,   1,     21 },
+};
+
+
+
+/********************************************************************************************************
+* @brief Monotonic time in nanoseconds
+*
+* @author original: Hab Collector \n
+*
+* @return Nanoseconds
+********************************************************************************************************/
+static double bench_Now_ns(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return((Now.tv_sec * 1e9) + Now.tv_nsec);
+
+} // END OF bench_Now_ns
+
+
+
+/********************************************************************************************************
+* @brief Random bar and peak levels for every level set - peaks at or above the bar as a peak hold would be
+*
+* @author original: Hab Collector \n
+*
+* @param Config: Bar geometry
+********************************************************************************************************/
+static void bench_RandomLevels(const Type_SpectrumConfig *Config)
+{
+    for (uint32_t Set = 0; Set < BENCH_LEVEL_SETS; Set++)
+    {
+        for (uint8_t BarIndex = 0; BarIndex < Config->NumBars; BarIndex++)
+        {
+            BarLevel[Set][BarIndex] = rand() % (Config->Levels + 1);
+            PeakLevel[Set][BarIndex] = BarLevel[Set][BarIndex] + (rand() % (Config->Levels + 1 - BarLevel[Set][BarIndex]));
+        }
+    }
+
+} // END OF bench_RandomLevels
+
+
+
+/********************************************************************************************************
+* @brief Reference renderer - the drawSpectrumMock path: clear, then one u8g2_DrawBox per lit segment and
+* one for the peak marker
+*
+* @author original: Hab Collector \n
+*
+* @param Config: Bar geometry
+* @param Bar: Bar levels
+* @param Peak: Peak levels
+********************************************************************************************************/
+static void bench_DrawBoxPath(const Type_SpectrumConfig *Config, const uint8_t *Bar, const uint8_t *Peak)
+{
+    uint8_t SegmentPitch = Config->SegmentHeight + Config->SegmentVSpace;
+
+    u8g2_ClearBuffer(&U8G2);
+    for (uint8_t BarIndex = 0; BarIndex < Config->NumBars; BarIndex++)
+    {
+        uint8_t X_Position = Config->X_Offset + (BarIndex * (Config->BarWidth + Config->BarHSpace));
+        for (uint8_t SegmentIndex = 0; SegmentIndex < Bar[BarIndex]; SegmentIndex++)
+        {
+            uint8_t Y_Top = Config->BaselineY - (SegmentIndex * SegmentPitch) - Config->SegmentHeight;
+            u8g2_DrawBox(&U8G2, X_Position, Y_Top, Config->BarWidth, Config->SegmentHeight);
+        }
+        if (Peak[BarIndex] != SPECTRUM_NO_PEAK)
+        {
+            uint8_t Y_Top = Config->BaselineY - ((Peak[BarIndex] - 1) * SegmentPitch) - Config->SegmentHeight;
+            u8g2_DrawBox(&U8G2, X_Position, Y_Top, Config->BarWidth, Config->SegmentHeight);
+        }
+    }
+
+} // END OF bench_DrawBoxPath
+
+
+
+/********************************************************************************************************
+* @brief Checks drawSpectrumBars against the u8g2_DrawBox path on random frames
+*
+* @author original: Hab Collector \n
+*
+* @param Config: Bar geometry
+*
+* @return Number of mismatching frames
+*
+* STEP 1: Cleared buffer - must match the reference exactly
+* STEP 2: Set buffer - bar band must match, everything else must still be set
+********************************************************************************************************/
+static uint32_t bench_Check(const Type_SpectrumConfig *Config)
+{
+    uint8_t *Buffer = u8g2_GetBufferPtr(&U8G2);
+    uint8_t X_End = Config->X_Offset + (Config->NumBars * (Config->BarWidth + Config->BarHSpace)) - Config->BarHSpace;
+    uint32_t Mismatch = 0;
+
+    bench_RandomLevels(Config);
+    for (uint32_t Frame = 0; Frame < BENCH_LEVEL_SETS; Frame++)
+    {
+        bench_DrawBoxPath(Config, BarLevel[Frame], PeakLevel[Frame]);
+        memcpy(Reference, Buffer, BENCH_FRAME_BYTES);
+
+        // STEP 1: Cleared buffer - must match the reference exactly
+        memset(Buffer, 0x00, BENCH_FRAME_BYTES);
+        drawSpectrumBars(&Blitter, &U8G2, BarLevel[Frame], PeakLevel[Frame]);
+        bool Failed = (memcmp(Reference, Buffer, BENCH_FRAME_BYTES) != 0);
+
+        // STEP 2: Set buffer - bar band must match, everything else must still be set
+        memset(Buffer, 0xFF, BENCH_FRAME_BYTES);
+        drawSpectrumBars(&Blitter, &U8G2, BarLevel[Frame], PeakLevel[Frame]);
+        for (uint32_t Index = 0; Index < BENCH_FRAME_BYTES; Index++)
+        {
+            uint8_t X = Index % SPECTRUM_DISPLAY_WIDTH;
+            uint8_t Page = Index / SPECTRUM_DISPLAY_WIDTH;
+            uint8_t Expected = ((X >= Config->X_Offset) && (X < X_End)) ? (Reference[Index] | Blitter.KeepMask[Page]) : 0xFF;
+            if (Buffer[Index] != Expected)
+                Failed = true;
+        }
+        Mismatch += Failed ? 1 : 0;
+    }
+    return(Mismatch);
+
+} // END OF bench_Check
+
+
+
+/********************************************************************************************************
+* @brief Blitter benchmark: every bar geometry is checked against u8g2_DrawBox rendering and both are timed
+*
+* @author original: Hab Collector \n
+*
+* @return 0 all geometries match, 1 mismatch or bad geometry
+*
+* STEP 1: u8g2 full buffer, no display - the byte and gpio callbacks do nothing
+* STEP 2: Per geometry: check, then time both paths on the same level sequence
+* STEP 3: Report
+********************************************************************************************************/
+int main(void)
+{
+    int ExitCode = 0;
+
+    // STEP 1: u8g2 full buffer, no display - the byte and gpio callbacks do nothing
+    u8g2_Setup_ssd1309_128x64_noname0_f(&U8G2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb);
+    u8g2_InitDisplay(&U8G2);
+
+    printf("bars  levels  u8g2_DrawBox ns/frame  drawSpectrumBars ns/frame  speedup  check\n");
+    for (uint32_t ConfigIndex = 0; ConfigIndex < (sizeof(BenchConfig) / sizeof(BenchConfig[0])); ConfigIndex++)
+    {
+        // STEP 2: Per geometry: check, then time both paths on the same level sequence
+        const Type_SpectrumConfig *Config = &BenchConfig[ConfigIndex];
+        if (!initSpectrumBlitter(&Blitter, Config))
+        {
+            printf("FAIL: geometry %u rejected\n", ConfigIndex);
+            return(1);
+        }
+        srand(ConfigIndex + 1);
+        uint32_t Mismatch = bench_Check(Config);
+
+        double Start = bench_Now_ns();
+        for (uint32_t Frame = 0; Frame < BENCH_FRAMES; Frame++)
+            bench_DrawBoxPath(Config, BarLevel[Frame % BENCH_LEVEL_SETS], PeakLevel[Frame % BENCH_LEVEL_SETS]);
+        double DrawBox_ns = (bench_Now_ns() - Start) / BENCH_FRAMES;
+
+        Start = bench_Now_ns();
+        for (uint32_t Frame = 0; Frame < BENCH_FRAMES; Frame++)
+            drawSpectrumBars(&Blitter, &U8G2, BarLevel[Frame % BENCH_LEVEL_SETS], PeakLevel[Frame % BENCH_LEVEL_SETS]);
+        double Blitter_ns = (bench_Now_ns() - Start) / BENCH_FRAMES;
+
+        // STEP 3: Report
+        printf("%4u  %6u  %21.0f  %25.0f  %6.1fx  %s\n", Config->NumBars, Config->Levels, DrawBox_ns, Blitter_ns, DrawBox_ns / Blitter_ns, (Mismatch == 0) ? "ok" : "MISMATCH");
+        if (Mismatch != 0)
+        {
+            printf("FAIL: %u of %u frames differ\n", Mismatch, BENCH_LEVEL_SETS);
+            ExitCode = 1;
+        }
+    }
+    if (ExitCode == 0)
+        printf("PASS\n");
+    return(ExitCode);
+
+} // END OF main
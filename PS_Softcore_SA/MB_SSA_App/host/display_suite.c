@@ -0,0 +1,886 @@
+/******************************************************************************************************
+ * @file            display_suite.c
+ * @brief           Native Linux render benchmarks and golden image regression of the display screens
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        Linux host (no target hardware) \n
+ * IDE:             Vitis 2024.2 / make \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            Drives u8g2 (ssd1309_128x64_noname0_f, as init_Display_SSD1309 sets it up) into the
+ *                  headless SSD1309 emulator (ssd1309_emulator.c):
+ *                    1) Controller checks - init sequence, contrast, power save, flip, start line
+ *                    2) Golden images - each spectrum screen is rendered, pushed with u8g2_SendBuffer
+ *                       and the panel snapshot compared with golden/<screen>.pbm; the panel must also
+ *                       match the u8g2 buffer (u8g2_WriteBufferPBM) where no flip is applied
+ *                    3) Waterfall - ring order on the panel through the start line, Bayer dither, one
+ *                       page per line on the wire, golden/waterfall.pbm
+ *                    4) Label cache - drawDisplayLabel against u8g2_DrawStr on a random background,
+ *                       both font modes and draw colors, clipped at the edges.  u8g2_fonts.c is not
+ *                       part of the source tree, so the u8g2 font is built here from u8x8_font_5x8_r
+ *                    5) Benchmarks - bar rendering, text, labels, full frame, partial and waterfall
+ *                       pushes in ns per operation, with the bytes each push puts on the wire.  u8g2_DrawStr with
+ *                       u8g2_font_5x8_tr is timed too when u8g2_fonts.c is present (SUITE_U8G2_FONTS)
+ *                  A failing screen is written to <screen>.fail.pbm.  Exit non zero on any failure.
+ *
+ *                  Usage: display_suite [golden directory] [--update]
+ *                         --update rewrites the golden images from the current rendering
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "u8g2.h"
+#include "Display_Spectrum.h"
+#include "Display_Labels.h"
+#include "Display_Waterfall.h"
+#include "ssd1309_emulator.h"
+
+// DEFINES
+#define SUITE_DEFAULT_GOLDEN    "golden"
+#define SUITE_BENCH_FRAMES      20000U
+#define SUITE_PATH_SIZE         256U
+#define SUITE_WATERFALL_BINS    64U
+#define SUITE_WATERFALL_LINES   100U                // More than a screen - the ring has wrapped
+#define SUITE_FONT_SIZE         2048U               // u8g2 font built from u8x8_font_5x8_r
+#define SUITE_FONT_FIRST        32U                 // ' ' - '~'
+#define SUITE_FONT_LAST         126U
+#define SUITE_FONT_BASELINE     7U                  // u8x8 cell row below the baseline
+#define SUITE_FONT_HEADER_SIZE  23U                 // U8G2_FONT_DATA_STRUCT_SIZE, private to u8g2_font.c
+
+// TYPEDEFS AND ENUMS
+typedef void (*suiteScreenFunctionPtr)(void);
+
+typedef struct
+{
+    const char                  *Name;
+    suiteScreenFunctionPtr      drawScreen;
+    uint8_t                     FlipMode;
+}Type_SuiteScreen;
+
+// STATIC VARIABLES
+static u8g2_t U8G2;
+static Type_SSD1309_Emulator Emulator;
+static Type_SpectrumBlitter Blitter;
+static char PanelText[EMULATOR_PBM_BYTES];
+static char BufferText[EMULATOR_PBM_BYTES];
+static char GoldenText[EMULATOR_PBM_BYTES];
+static uint32_t Failures = 0;
+static uint8_t SuiteFont[SUITE_FONT_SIZE];
+static uint8_t Background[EMULATOR_PAGE_COUNT * EMULATOR_WIDTH];
+static uint8_t Reference[EMULATOR_PAGE_COUNT * EMULATOR_WIDTH];
+
+static const Type_SpectrumConfig MockConfig = { .NumBars = 16, .BarWidth = 4, .BarHSpace = 2, .X_Offset = 0, .BaselineY = 60, .SegmentHeight = 2, .SegmentVSpace = 1, .Levels = 10 };
+static const Type_SpectrumConfig PeakConfig = { .NumBars = 32, .BarWidth = 3, .BarHSpace = 1, .X_Offset = 0, .BaselineY = 63, .SegmentHeight = 2, .SegmentVSpace = 1, .Levels = 17 };
+static const Type_SpectrumConfig FineConfig = { .NumBars = 64, .BarWidth = 1, .BarHSpace = 1, .X_Offset = 1, .BaselineY = 64, .SegmentHeight = 1, .SegmentVSpace = 0, .Levels = 54 };
+
+
+
+/********************************************************************************************************
+* @brief Monotonic time in nanoseconds
+*
+* @author original: Hab Collector \n
+*
+* @return Nanoseconds
+********************************************************************************************************/
+static double suite_Now_ns(void)
+{
+    struct timespec Now;
+
+    clock_gettime(CLOCK_MONOTONIC, &Now);
+    return((Now.tv_sec * 1e9) + Now.tv_nsec);
+
+} // END OF suite_Now_ns
+
+
+
+/********************************************************************************************************
+* @brief Deterministic bar and peak levels - golden images must not depend on the C library's rand()
+*
+* @author original: Hab Collector \n
+*
+* @param Config: Bar geometry
+* @param BarLevel: Returned by reference - NumBars levels
+* @param PeakLevel: Returned by reference - NumBars peak levels (NULL for none)
+* @param Seed: Pattern selector
+********************************************************************************************************/
+static void suite_Levels(const Type_SpectrumConfig *Config, uint8_t *BarLevel, uint8_t *PeakLevel, uint32_t Seed)
+{
+    for (uint8_t BarIndex = 0; BarIndex < Config->NumBars; BarIndex++)
+    {
+        BarLevel[BarIndex] = (uint8_t)(((BarIndex * 7U) + (Seed * 13U) + 3U) % (Config->Levels + 1U));
+        if (PeakLevel != NULL)
+        {
+            uint32_t Peak = BarLevel[BarIndex] + 1U + ((BarIndex + Seed) % 3U);
+            PeakLevel[BarIndex] = (uint8_t)((Peak > Config->Levels) ? Config->Levels : Peak);
+        }
+    }
+
+} // END OF suite_Levels
+
+
+
+/********************************************************************************************************
+* @brief Tile aligned text from the u8x8 5x8 font copied into the u8g2 buffer.  u8x8 glyphs are already 8
+* vertical_top_lsb page bytes; the u8g2 fonts (u8g2_fonts.c) are not part of this source tree
+*
+* @author original: Hab Collector \n
+*
+* @param TileX: First tile column 0 - 15
+* @param Page: Tile row 0 - 7
+* @param Text: Null terminated text - clipped at the right edge
+********************************************************************************************************/
+static void suite_DrawText(uint8_t TileX, uint8_t Page, const char *Text)
+{
+    u8x8_t *U8X8 = u8g2_GetU8x8(&U8G2);
+    uint8_t *Tile = u8g2_GetBufferPtr(&U8G2) + (Page * EMULATOR_WIDTH) + (TileX * 8U);
+
+    u8x8_SetFont(U8X8, u8x8_font_5x8_r);
+    for (; (*Text != '\0') && (TileX < (EMULATOR_WIDTH / 8U)); Text++, TileX++, Tile += 8)
+        u8x8_get_glyph_data(U8X8, (uint8_t)*Text, Tile, 0);
+
+} // END OF suite_DrawText
+
+
+
+/********************************************************************************************************
+* @brief Appends bits to a u8g2 font glyph bitstream - LSB first, as u8g2_font_decode_get_unsigned_bits reads
+*
+* @author original: Hab Collector \n
+*
+* @param Stream: Glyph bitstream (zeroed)
+* @param BitPosition: Returned by reference - next bit
+* @param Value: Bits to write
+* @param BitCount: Number of bits
+********************************************************************************************************/
+static void suite_PutBits(uint8_t *Stream, uint32_t *BitPosition, uint32_t Value, uint8_t BitCount)
+{
+    for (uint8_t Bit = 0; Bit < BitCount; Bit++, (*BitPosition)++)
+    {
+        if (Value & (1U << Bit))
+            Stream[*BitPosition / 8U] |= (uint8_t)(1U << (*BitPosition % 8U));
+    }
+
+} // END OF suite_PutBits
+
+
+
+/********************************************************************************************************
+* @brief Builds a u8g2 font (bbx mode 0, run length glyphs) from u8x8_font_5x8_r - text drawn with it by
+* u8g2_DrawStr matches suite_DrawText on a tile boundary
+*
+* @author original: Hab Collector \n
+*
+* @note: u8g2_fonts.c is not part of the source tree.  Glyph advance is the 8 pixel u8x8 cell, the row
+* below SUITE_FONT_BASELINE - 1 is descender
+*
+* @return Font size in bytes
+*
+* STEP 1: Header - see the font format description in u8g2_font.c
+* STEP 2: One glyph per character: box, offsets and advance, then zero / one runs of the box pixels
+* STEP 3: End of glyph list
+********************************************************************************************************/
+static size_t suite_BuildFont(void)
+{
+    u8x8_t *U8X8 = u8g2_GetU8x8(&U8G2);
+    size_t Size = SUITE_FONT_HEADER_SIZE;
+
+    // STEP 1: Header - see the font format description in u8g2_font.c
+    static const uint8_t Header[SUITE_FONT_HEADER_SIZE] =
+    {
+        SUITE_FONT_LAST - SUITE_FONT_FIRST + 1,     // Glyph count
+        0, 4, 4,                                    // bbx mode, bits per 0 run, bits per 1 run
+        4, 4, 5, 5, 5,                              // Bits per width, height, x, y, advance
+        8, 8, 0, (uint8_t)-1,                       // Max box and its offset
+        6, (uint8_t)-1, 7, (uint8_t)-1,             // Ascent 'A', descent 'g', ascent '(', descent ')'
+        0, 0, 0, 0, 0, 0                            // Start of 'A', 'a', unicode - set below
+    };
+    memset(SuiteFont, 0x00, sizeof(SuiteFont));
+    memcpy(SuiteFont, Header, sizeof(Header));
+    u8x8_SetFont(U8X8, u8x8_font_5x8_r);
+
+    // STEP 2: One glyph per character: box, offsets and advance, then zero / one runs of the box pixels
+    for (uint16_t Encoding = SUITE_FONT_FIRST; Encoding <= SUITE_FONT_LAST; Encoding++)
+    {
+        uint8_t Tile[8];
+        uint8_t Column0 = 8, Column1 = 0, Row0 = 8, Row1 = 0;
+        u8x8_get_glyph_data(U8X8, (uint8_t)Encoding, Tile, 0);
+        for (uint8_t Column = 0; Column < 8; Column++)
+        {
+            for (uint8_t Row = 0; Row < 8; Row++)
+            {
+                if ((Tile[Column] & (1U << Row)) == 0)
+                    continue;
+                Column0 = (Column < Column0) ? Column : Column0;
+                Column1 = (Column > Column1) ? Column : Column1;
+                Row0 = (Row < Row0) ? Row : Row0;
+                Row1 = (Row > Row1) ? Row : Row1;
+            }
+        }
+        uint8_t Width = (Column0 == 8) ? 0 : (Column1 - Column0 + 1);
+        uint8_t Height = (Column0 == 8) ? 0 : (Row1 - Row0 + 1);
+        int8_t Y_Offset = (Column0 == 8) ? 0 : ((int8_t)(SUITE_FONT_BASELINE - 1) - (int8_t)Row1);
+        if (Encoding == 'A')
+        {
+            SuiteFont[17] = (uint8_t)((Size - SUITE_FONT_HEADER_SIZE) >> 8);
+            SuiteFont[18] = (uint8_t)(Size - SUITE_FONT_HEADER_SIZE);
+        }
+        if (Encoding == 'a')
+        {
+            SuiteFont[19] = (uint8_t)((Size - SUITE_FONT_HEADER_SIZE) >> 8);
+            SuiteFont[20] = (uint8_t)(Size - SUITE_FONT_HEADER_SIZE);
+        }
+
+        uint8_t *Stream = &SuiteFont[Size + 2];
+        uint32_t BitPosition = 0;
+        suite_PutBits(Stream, &BitPosition, Width, 4);
+        suite_PutBits(Stream, &BitPosition, Height, 4);
+        suite_PutBits(Stream, &BitPosition, (Column0 == 8) ? 16U : (Column0 + 16U), 5);
+        suite_PutBits(Stream, &BitPosition, (uint32_t)(Y_Offset + 16), 5);
+        suite_PutBits(Stream, &BitPosition, 8U + 16U, 5);
+        uint32_t PixelCount = Width * Height;
+        for (uint32_t Pixel = 0; Pixel < PixelCount; )
+        {
+            uint32_t Zeros = 0, Ones = 0;
+            while ((Pixel < PixelCount) && (Zeros < 15U) && !(Tile[Column0 + (Pixel % Width)] & (1U << (Row0 + (Pixel / Width)))))
+            {
+                Zeros++;
+                Pixel++;
+            }
+            while ((Pixel < PixelCount) && (Ones < 15U) && (Tile[Column0 + (Pixel % Width)] & (1U << (Row0 + (Pixel / Width)))))
+            {
+                Ones++;
+                Pixel++;
+            }
+            suite_PutBits(Stream, &BitPosition, Zeros, 4);
+            suite_PutBits(Stream, &BitPosition, Ones, 4);
+            suite_PutBits(Stream, &BitPosition, 0, 1);          // No repeat of the pair
+        }
+        SuiteFont[Size] = (uint8_t)Encoding;
+        SuiteFont[Size + 1] = (uint8_t)(2U + ((BitPosition + 7U) / 8U));
+        Size += SuiteFont[Size + 1];
+    }
+
+    // STEP 3: End of glyph list
+    Size += 2;
+    return(Size);
+
+} // END OF suite_BuildFont
+
+
+
+/********************************************************************************************************
+* @brief Spectrum screens - drawn into the u8g2 buffer, pushed by suite_CheckScreen
+*
+* @author original: Hab Collector \n
+********************************************************************************************************/
+static void suite_ScreenMock(void)
+{
+    uint8_t BarLevel[SPECTRUM_MAX_BARS];
+
+    initSpectrumBlitter(&Blitter, &MockConfig);
+    suite_Levels(&MockConfig, BarLevel, NULL, 0);
+    u8g2_ClearBuffer(&U8G2);
+    drawSpectrumBars(&Blitter, &U8G2, BarLevel, NULL);
+}
+
+static void suite_ScreenPeaks(void)
+{
+    uint8_t BarLevel[SPECTRUM_MAX_BARS];
+    uint8_t PeakLevel[SPECTRUM_MAX_BARS];
+
+    initSpectrumBlitter(&Blitter, &PeakConfig);
+    suite_Levels(&PeakConfig, BarLevel, PeakLevel, 1);
+    u8g2_ClearBuffer(&U8G2);
+    drawSpectrumBars(&Blitter, &U8G2, BarLevel, PeakLevel);
+}
+
+static void suite_ScreenFine(void)
+{
+    uint8_t BarLevel[SPECTRUM_MAX_BARS];
+    uint8_t PeakLevel[SPECTRUM_MAX_BARS];
+
+    initSpectrumBlitter(&Blitter, &FineConfig);
+    suite_Levels(&FineConfig, BarLevel, PeakLevel, 2);
+    u8g2_ClearBuffer(&U8G2);
+    drawSpectrumBars(&Blitter, &U8G2, BarLevel, PeakLevel);
+}
+
+static void suite_ScreenLabels(void)
+{
+    suite_ScreenMock();
+    suite_DrawText(12, 0, "FFT");
+    suite_DrawText(12, 1, "48k");
+    u8g2_DrawHLine(&U8G2, 0, 61, 94);
+}
+
+static const Type_SuiteScreen SuiteScreen[] =
+{
+    { "spectrum_mock",      suite_ScreenMock,   0 },
+    { "spectrum_peaks",     suite_ScreenPeaks,  0 },
+    { "spectrum_fine",      suite_ScreenFine,   0 },
+    { "spectrum_labels",    suite_ScreenLabels, 0 },
+    { "spectrum_flip",      suite_ScreenPeaks,  1 },
+};
+
+
+
+/********************************************************************************************************
+* @brief Records a failed check
+*
+* @author original: Hab Collector \n
+*
+* @param Passed: Check result
+* @param Name: Check name
+********************************************************************************************************/
+static void suite_Expect(bool Passed, const char *Name)
+{
+    printf("  %-40s %s\n", Name, Passed ? "ok" : "FAIL");
+    if (!Passed)
+        Failures++;
+
+} // END OF suite_Expect
+
+
+
+/********************************************************************************************************
+* @brief Reads a whole text file
+*
+* @author original: Hab Collector \n
+*
+* @param Path: File
+* @param Text: Returned by reference - file text, null terminated
+* @param TextSize: Size of Text
+*
+* @return True if read
+********************************************************************************************************/
+static bool suite_ReadText(const char *Path, char *Text, size_t TextSize)
+{
+    FILE *File = fopen(Path, "r");
+    if (File == NULL)
+        return(false);
+    size_t Length = fread(Text, 1, TextSize - 1, File);
+    Text[Length] = '\0';
+    fclose(File);
+    return(true);
+
+} // END OF suite_ReadText
+
+
+
+/********************************************************************************************************
+* @brief Writes a whole text file
+*
+* @author original: Hab Collector \n
+*
+* @param Path: File
+* @param Text: Null terminated text
+*
+* @return True if written
+********************************************************************************************************/
+static bool suite_WriteText(const char *Path, const char *Text)
+{
+    FILE *File = fopen(Path, "w");
+    if (File == NULL)
+        return(false);
+    bool Written = (fputs(Text, File) >= 0);
+    fclose(File);
+    return(Written);
+
+} // END OF suite_WriteText
+
+
+
+/********************************************************************************************************
+* @brief Controller level checks of the emulator against what u8g2 sends
+*
+* @author original: Hab Collector \n
+*
+* STEP 1: Init sequence - display on, page addressing, flip 0 remaps, contrast
+* STEP 2: Power save and contrast
+* STEP 3: Start line scrolls the panel without touching the GDDRAM
+********************************************************************************************************/
+static void suite_ControllerChecks(void)
+{
+    printf("controller\n");
+
+    // STEP 1: Init sequence - display on, page addressing, flip 0 remaps, contrast
+    suite_Expect(Emulator.DisplayOn && (Emulator.Addressing == EMULATOR_PAGE_ADDRESSING), "init: display on, page addressing");
+    suite_Expect(Emulator.SegmentRemap && Emulator.ComReverse, "init: segment remap 0xA1, COM reverse 0xC8");
+    suite_Expect(Emulator.UnknownCommands == 0, "init: every command decoded");
+    suite_Expect(Emulator.UnselectedBytes == 0, "init: every byte inside a transfer");
+
+    // STEP 2: Power save and contrast
+    u8g2_SetContrast(&U8G2, 64);
+    suite_Expect(Emulator.Contrast == 64, "contrast 64");
+    u8g2_SetPowerSave(&U8G2, 1);
+    bool Off = !Emulator.DisplayOn;
+    u8g2_SetPowerSave(&U8G2, 0);
+    suite_Expect(Off && Emulator.DisplayOn, "power save off / on");
+
+    // STEP 3: Start line scrolls the panel without touching the GDDRAM
+    suite_ScreenLabels();
+    u8g2_SendBuffer(&U8G2);
+    u8x8_t *U8X8 = u8g2_GetU8x8(&U8G2);
+    u8x8_cad_StartTransfer(U8X8);
+    u8x8_cad_SendCmd(U8X8, 0x40 | 8);
+    u8x8_cad_EndTransfer(U8X8);
+    uint8_t *Buffer = u8g2_GetBufferPtr(&U8G2);
+    bool Scrolled = true;
+    for (uint8_t Y = 0; Y < EMULATOR_HEIGHT; Y++)
+    {
+        uint8_t Row = (Y + 8) & (EMULATOR_HEIGHT - 1);
+        for (uint8_t X = 0; X < EMULATOR_WIDTH; X++)
+        {
+            if (getEmulatorPixel(&Emulator, X, Y) != ((Buffer[((Row >> 3) * EMULATOR_WIDTH) + X] >> (Row & 0x07)) & 0x01))
+                Scrolled = false;
+        }
+    }
+    suite_Expect(Scrolled && (Emulator.StartLine == 8), "start line 8 scrolls the panel by 8 rows");
+    u8x8_cad_StartTransfer(U8X8);
+    u8x8_cad_SendCmd(U8X8, 0x40);
+    u8x8_cad_EndTransfer(U8X8);
+
+} // END OF suite_ControllerChecks
+
+
+
+/********************************************************************************************************
+* @brief Compares the panel snapshot (PanelText) with its golden image - or writes it when updating
+*
+* @author original: Hab Collector \n
+*
+* @param ScreenName: Golden image name
+* @param GoldenDirectory: Golden image directory
+* @param Update: True: write the golden image instead of comparing
+********************************************************************************************************/
+static void suite_CheckGolden(const char *ScreenName, const char *GoldenDirectory, bool Update)
+{
+    char Path[SUITE_PATH_SIZE];
+    char Name[SUITE_PATH_SIZE];
+
+    snprintf(Path, sizeof(Path), "%s/%s.pbm", GoldenDirectory, ScreenName);
+    if (Update)
+    {
+        snprintf(Name, sizeof(Name), "%s: golden written", ScreenName);
+        suite_Expect(suite_WriteText(Path, PanelText), Name);
+        return;
+    }
+    bool Golden = suite_ReadText(Path, GoldenText, sizeof(GoldenText)) && (strcmp(GoldenText, PanelText) == 0);
+    snprintf(Name, sizeof(Name), "%s: matches golden", ScreenName);
+    suite_Expect(Golden, Name);
+    if (!Golden)
+    {
+        snprintf(Path, sizeof(Path), "%s.fail.pbm", ScreenName);
+        suite_WriteText(Path, PanelText);
+    }
+
+} // END OF suite_CheckGolden
+
+
+
+/********************************************************************************************************
+* @brief Renders a screen, pushes it through the emulator and compares the panel with its golden image
+*
+* @author original: Hab Collector \n
+*
+* @param Screen: Screen to check
+* @param GoldenDirectory: Golden image directory
+* @param Update: True: write the golden image instead of comparing
+*
+* STEP 1: Render and push
+* STEP 2: Panel must match the u8g2 buffer - or its 180 degree rotation when flipped
+* STEP 3: Golden image
+********************************************************************************************************/
+static void suite_CheckScreen(const Type_SuiteScreen *Screen, const char *GoldenDirectory, bool Update)
+{
+    char Name[SUITE_PATH_SIZE];
+
+    // STEP 1: Render and push
+    u8g2_SetFlipMode(&U8G2, Screen->FlipMode);
+    Screen->drawScreen();
+    u8g2_SendBuffer(&U8G2);
+    captureEmulatorPBM(&Emulator, PanelText, sizeof(PanelText));
+    captureBufferPBM(&U8G2, BufferText, sizeof(BufferText));
+
+    // STEP 2: Panel must match the u8g2 buffer - or its 180 degree rotation when flipped
+    bool Matches = true;
+    for (uint8_t Y = 0; Y < EMULATOR_HEIGHT; Y++)
+    {
+        for (uint8_t X = 0; X < EMULATOR_WIDTH; X++)
+        {
+            uint8_t BufferX = Screen->FlipMode ? ((EMULATOR_WIDTH - 1) - X) : X;
+            uint8_t BufferY = Screen->FlipMode ? ((EMULATOR_HEIGHT - 1) - Y) : Y;
+            uint8_t Expected = (u8g2_GetBufferPtr(&U8G2)[((BufferY >> 3) * EMULATOR_WIDTH) + BufferX] >> (BufferY & 0x07)) & 0x01;
+            if (getEmulatorPixel(&Emulator, X, Y) != Expected)
+                Matches = false;
+        }
+    }
+    if (Screen->FlipMode == 0)
+        Matches = Matches && (strcmp(PanelText, BufferText) == 0);
+    snprintf(Name, sizeof(Name), "%s: panel matches u8g2 buffer", Screen->Name);
+    suite_Expect(Matches, Name);
+    u8g2_SetFlipMode(&U8G2, 0);
+
+    // STEP 3: Golden image
+    suite_CheckGolden(Screen->Name, GoldenDirectory, Update);
+
+} // END OF suite_CheckScreen
+
+
+
+/********************************************************************************************************
+* @brief Waterfall test line: a tone sweeping up the spectrum over a sloping noise floor
+*
+* @author original: Hab Collector \n
+*
+* @param Line: Line number
+* @param Intensity: Returned by reference - SUITE_WATERFALL_BINS values
+********************************************************************************************************/
+static void suite_WaterfallLine(uint32_t Line, uint8_t *Intensity)
+{
+    uint32_t Tone = (Line * 3U) % SUITE_WATERFALL_BINS;
+
+    for (uint32_t Bin = 0; Bin < SUITE_WATERFALL_BINS; Bin++)
+    {
+        uint32_t Distance = (Bin > Tone) ? (Bin - Tone) : (Tone - Bin);
+        uint32_t Level = ((SUITE_WATERFALL_BINS - Bin) * 96U) / SUITE_WATERFALL_BINS;
+        Level += (Distance < 8U) ? (255U - (Distance * 32U)) : 0U;
+        Intensity[Bin] = (uint8_t)((Level > 255U) ? 255U : Level);
+    }
+
+} // END OF suite_WaterfallLine
+
+
+
+/********************************************************************************************************
+* @brief Waterfall checks - each line is one page and the start line on the wire, the panel shows the
+* lines newest first with the 4 x 4 Bayer dither, and the start line is restored on stop
+*
+* @author original: Hab Collector \n
+*
+* @param GoldenDirectory: Golden image directory
+* @param Update: True: write the golden image instead of comparing
+*
+* STEP 1: Start - blank panel, start line 0
+* STEP 2: Add lines - one page of data each
+* STEP 3: Panel: row Y is the line added Y lines ago, dithered by its GDDRAM row
+* STEP 4: Golden image, then stop
+********************************************************************************************************/
+static void suite_WaterfallChecks(const char *GoldenDirectory, bool Update)
+{
+    static const uint8_t Bayer[4][4] = { { 0, 8, 2, 10 }, { 12, 4, 14, 6 }, { 3, 11, 1, 9 }, { 15, 7, 13, 5 } };
+    uint8_t Intensity[SUITE_WATERFALL_BINS];
+    Type_Waterfall Waterfall;
+
+    printf("waterfall\n");
+
+    // STEP 1: Start - blank panel, start line 0
+    suite_Expect(!initWaterfall(&Waterfall, &U8G2, 24) && initWaterfall(&Waterfall, &U8G2, SUITE_WATERFALL_BINS), "start: 64 bins accepted, 24 rejected");
+    suite_Expect(Emulator.StartLine == 0, "start: start line 0");
+
+    // STEP 2: Add lines - one page of data each
+    uint32_t DataBytes = Emulator.DataBytes;
+    for (uint32_t Line = 0; Line < SUITE_WATERFALL_LINES; Line++)
+    {
+        suite_WaterfallLine(Line, Intensity);
+        addWaterfallLine(&Waterfall, Intensity);
+    }
+    DataBytes = Emulator.DataBytes - DataBytes;
+    suite_Expect(DataBytes == (SUITE_WATERFALL_LINES * EMULATOR_WIDTH), "one page of data per line");
+    suite_Expect(Emulator.StartLine == Waterfall.TopRow, "start line follows the newest line");
+
+    // STEP 3: Panel: row Y is the line added Y lines ago, dithered by its GDDRAM row
+    bool Matches = true;
+    for (uint8_t Y = 0; Y < EMULATOR_HEIGHT; Y++)
+    {
+        uint8_t Row = (Waterfall.TopRow + Y) & (EMULATOR_HEIGHT - 1);
+        suite_WaterfallLine(SUITE_WATERFALL_LINES - 1 - Y, Intensity);
+        for (uint8_t X = 0; X < EMULATOR_WIDTH; X++)
+        {
+            uint8_t Threshold = (uint8_t)((Bayer[Row & 3][X & 3] * 16U) + 8U);
+            uint8_t Expected = (Intensity[X / (EMULATOR_WIDTH / SUITE_WATERFALL_BINS)] > Threshold) ? 1 : 0;
+            if (getEmulatorPixel(&Emulator, X, Y) != Expected)
+                Matches = false;
+        }
+    }
+    suite_Expect(Matches, "panel shows the lines newest first");
+
+    // STEP 4: Golden image, then stop
+    captureEmulatorPBM(&Emulator, PanelText, sizeof(PanelText));
+    suite_CheckGolden("waterfall", GoldenDirectory, Update);
+    stopWaterfall(&Waterfall);
+    suite_Expect((Emulator.StartLine == 0) && !Waterfall.Active, "stop: start line 0");
+
+} // END OF suite_WaterfallChecks
+
+
+
+/********************************************************************************************************
+* @brief Label cache checks - drawDisplayLabel must leave the frame buffer exactly as u8g2_DrawStr does
+*
+* @author original: Hab Collector \n
+*
+* STEP 1: Font and random background
+* STEP 2: Every label in both font modes and draw colors, drawn twice from the cache
+* STEP 3: Cache is kept while the label is unchanged
+********************************************************************************************************/
+static void suite_LabelChecks(void)
+{
+    typedef struct
+    {
+        u8g2_uint_t             X;
+        u8g2_uint_t             Y;
+        const char              *Text;
+    }Type_SuiteLabel;
+    static const Type_SuiteLabel SuiteLabel[] =
+    {
+        {  98,  7, "FFT" },                     // Page aligned, one page
+        {  90, 12, "48 kHz" },                  // Straddles pages 0 and 1
+        {   3, 37, "gjpqy|" },                  // Descenders
+        { 112, 30, "clip" },                    // Clipped at the right edge
+        {  20,  3, "top" },                     // Clipped at the top
+        {  40, 64, "bottom" },                  // Descender below the last row
+        {  10, 20, "" },                        // Nothing drawn
+    };
+    uint8_t *Buffer = u8g2_GetBufferPtr(&U8G2);
+    Type_DisplayLabel Label;
+    uint32_t Mismatch = 0;
+
+    printf("label cache\n");
+
+    // STEP 1: Font and random background
+    size_t FontSize = suite_BuildFont();
+    u8g2_ClearBuffer(&U8G2);
+    suite_DrawText(2, 3, "Softcore SA");
+    memcpy(Reference, Buffer, sizeof(Reference));
+    u8g2_ClearBuffer(&U8G2);
+    u8g2_SetFont(&U8G2, SuiteFont);
+    u8g2_DrawStr(&U8G2, 16, (3 * 8) + SUITE_FONT_BASELINE, "Softcore SA");
+    suite_Expect((FontSize <= SUITE_FONT_SIZE) && (memcmp(Reference, Buffer, sizeof(Reference)) == 0), "u8g2 font from u8x8_font_5x8_r");
+    srand(39);
+    for (uint32_t Index = 0; Index < sizeof(Background); Index++)
+        Background[Index] = (uint8_t)rand();
+
+    // STEP 2: Every label in both font modes and draw colors, drawn twice from the cache
+    for (uint8_t FontMode = 0; FontMode < 2; FontMode++)
+    {
+        for (uint8_t DrawColor = 0; DrawColor < 2; DrawColor++)
+        {
+            u8g2_SetFontMode(&U8G2, FontMode);
+            u8g2_SetDrawColor(&U8G2, DrawColor);
+            for (uint32_t LabelIndex = 0; LabelIndex < (sizeof(SuiteLabel) / sizeof(SuiteLabel[0])); LabelIndex++)
+            {
+                const Type_SuiteLabel *Test = &SuiteLabel[LabelIndex];
+                memcpy(Buffer, Background, sizeof(Background));
+                u8g2_SetFont(&U8G2, SuiteFont);
+                u8g2_DrawStr(&U8G2, Test->X, Test->Y, Test->Text);
+                memcpy(Reference, Buffer, sizeof(Reference));
+
+                initDisplayLabel(&Label);
+                setDisplayLabel(&Label, SuiteFont, Test->X, Test->Y, Test->Text);
+                for (uint8_t Pass = 0; Pass < 2; Pass++)
+                {
+                    memcpy(Buffer, Background, sizeof(Background));
+                    drawDisplayLabel(&Label, &U8G2);
+                    if (memcmp(Reference, Buffer, sizeof(Reference)) != 0)
+                    {
+                        printf("  mismatch: \"%s\" at %u,%u font mode %u draw color %u pass %u\n", Test->Text, Test->X, Test->Y, FontMode, DrawColor, Pass);
+                        Mismatch++;
+                    }
+                }
+            }
+        }
+    }
+    u8g2_SetFontMode(&U8G2, 0);
+    u8g2_SetDrawColor(&U8G2, 1);
+    suite_Expect(Mismatch == 0, "drawDisplayLabel == u8g2_DrawStr");
+
+    // STEP 3: Cache is kept while the label is unchanged
+    initDisplayLabel(&Label);
+    bool Changed = setDisplayLabel(&Label, SuiteFont, 98, 7, "FFT");
+    drawDisplayLabel(&Label, &U8G2);
+    Changed = setDisplayLabel(&Label, SuiteFont, 98, 7, "FFT") || !Changed;
+    drawDisplayLabel(&Label, &U8G2);
+    suite_Expect(!Changed && (Label.RenderCount == 1), "unchanged label decoded once");
+    Changed = setDisplayLabel(&Label, SuiteFont, 98, 7, "LOG");
+    drawDisplayLabel(&Label, &U8G2);
+    suite_Expect(Changed && (Label.RenderCount == 2), "new text decoded again");
+
+} // END OF suite_LabelChecks
+
+
+
+/********************************************************************************************************
+* @brief Render and push benchmarks
+*
+* @author original: Hab Collector \n
+*
+* STEP 1: Bar rendering
+* STEP 2: Text - u8x8 tiles, u8g2_DrawStr and the same lines as cached labels
+* STEP 3: Full frame push
+* STEP 4: Partial push - two tiles, as a dirty tile push of a moving bar would send
+* STEP 5: Waterfall line - dither, one page and the start line
+********************************************************************************************************/
+static void suite_Benchmarks(void)
+{
+    uint8_t BarLevel[SPECTRUM_MAX_BARS];
+    uint8_t PeakLevel[SPECTRUM_MAX_BARS];
+    const Type_SpectrumConfig *BarConfig[] = { &MockConfig, &PeakConfig, &FineConfig };
+    static Type_DisplayLabel TextLabel[8];
+
+    printf("benchmarks (ns per operation)\n");
+
+    // STEP 1: Bar rendering
+    for (uint8_t ConfigIndex = 0; ConfigIndex < 3; ConfigIndex++)
+    {
+        initSpectrumBlitter(&Blitter, BarConfig[ConfigIndex]);
+        suite_Levels(BarConfig[ConfigIndex], BarLevel, PeakLevel, 3);
+        double Start = suite_Now_ns();
+        for (uint32_t Frame = 0; Frame < SUITE_BENCH_FRAMES; Frame++)
+        {
+            BarLevel[Frame % BarConfig[ConfigIndex]->NumBars] = (uint8_t)(Frame % (BarConfig[ConfigIndex]->Levels + 1U));
+            drawSpectrumBars(&Blitter, &U8G2, BarLevel, PeakLevel);
+        }
+        printf("  bars %2u x %2u levels                     %8.0f\n", BarConfig[ConfigIndex]->NumBars, BarConfig[ConfigIndex]->Levels, (suite_Now_ns() - Start) / SUITE_BENCH_FRAMES);
+    }
+
+    // STEP 2: Text - u8x8 tiles, u8g2_DrawStr and the same lines as cached labels
+    double Start = suite_Now_ns();
+    for (uint32_t Frame = 0; Frame < SUITE_BENCH_FRAMES; Frame++)
+    {
+        u8g2_ClearBuffer(&U8G2);
+        for (uint8_t Line = 0; Line < 8; Line++)
+            suite_DrawText(0, Line, "Softcore SA 1234");
+    }
+    printf("  text, clear + 8 lines of 16 chars       %8.0f\n", (suite_Now_ns() - Start) / SUITE_BENCH_FRAMES);
+    u8g2_SetFont(&U8G2, SuiteFont);
+    Start = suite_Now_ns();
+    for (uint32_t Frame = 0; Frame < SUITE_BENCH_FRAMES; Frame++)
+    {
+        u8g2_ClearBuffer(&U8G2);
+        for (uint8_t Line = 0; Line < 8; Line++)
+            u8g2_DrawStr(&U8G2, 0, (Line * 8) + SUITE_FONT_BASELINE, "Softcore SA 1234");
+    }
+    printf("  u8g2_DrawStr, clear + 8 lines of 16     %8.0f\n", (suite_Now_ns() - Start) / SUITE_BENCH_FRAMES);
+    for (uint8_t Line = 0; Line < 8; Line++)
+    {
+        initDisplayLabel(&TextLabel[Line]);
+        setDisplayLabel(&TextLabel[Line], SuiteFont, 0, (Line * 8) + SUITE_FONT_BASELINE, "Softcore SA 1234");
+    }
+    Start = suite_Now_ns();
+    for (uint32_t Frame = 0; Frame < SUITE_BENCH_FRAMES; Frame++)
+    {
+        u8g2_ClearBuffer(&U8G2);
+        for (uint8_t Line = 0; Line < 8; Line++)
+            drawDisplayLabel(&TextLabel[Line], &U8G2);
+    }
+    printf("  labels, clear + 8 lines of 16           %8.0f\n", (suite_Now_ns() - Start) / SUITE_BENCH_FRAMES);
+#ifdef SUITE_U8G2_FONTS
+    u8g2_SetFont(&U8G2, u8g2_font_5x8_tr);
+    Start = suite_Now_ns();
+    for (uint32_t Frame = 0; Frame < SUITE_BENCH_FRAMES; Frame++)
+    {
+        u8g2_ClearBuffer(&U8G2);
+        for (uint8_t Line = 0; Line < 8; Line++)
+            u8g2_DrawStr(&U8G2, 0, (Line * 8) + 7, "Softcore SA 1234567890");
+    }
+    printf("  u8g2_DrawStr, clear + 8 lines of 22     %8.0f\n", (suite_Now_ns() - Start) / SUITE_BENCH_FRAMES);
+#endif
+
+    // STEP 3: Full frame push
+    uint32_t WireBytes = Emulator.CommandBytes + Emulator.DataBytes;
+    Start = suite_Now_ns();
+    for (uint32_t Frame = 0; Frame < SUITE_BENCH_FRAMES; Frame++)
+        u8g2_SendBuffer(&U8G2);
+    double Push_ns = (suite_Now_ns() - Start) / SUITE_BENCH_FRAMES;
+    WireBytes = Emulator.CommandBytes + Emulator.DataBytes - WireBytes;
+    printf("  full frame push (%4u bytes on wire)    %8.0f\n", WireBytes / SUITE_BENCH_FRAMES, Push_ns);
+
+    // STEP 4: Partial push - two tiles, as a dirty tile push of a moving bar would send
+    WireBytes = Emulator.CommandBytes + Emulator.DataBytes;
+    Start = suite_Now_ns();
+    for (uint32_t Frame = 0; Frame < SUITE_BENCH_FRAMES; Frame++)
+        u8g2_UpdateDisplayArea(&U8G2, Frame % 15, 7, 2, 1);
+    Push_ns = (suite_Now_ns() - Start) / SUITE_BENCH_FRAMES;
+    WireBytes = Emulator.CommandBytes + Emulator.DataBytes - WireBytes;
+    printf("  2 tile push     (%4u bytes on wire)    %8.0f\n", WireBytes / SUITE_BENCH_FRAMES, Push_ns);
+
+    // STEP 5: Waterfall line - dither, one page and the start line
+    Type_Waterfall Waterfall;
+    uint8_t Intensity[SUITE_WATERFALL_BINS];
+    initWaterfall(&Waterfall, &U8G2, SUITE_WATERFALL_BINS);
+    suite_WaterfallLine(0, Intensity);
+    WireBytes = Emulator.CommandBytes + Emulator.DataBytes;
+    Start = suite_Now_ns();
+    for (uint32_t Frame = 0; Frame < SUITE_BENCH_FRAMES; Frame++)
+        addWaterfallLine(&Waterfall, Intensity);
+    Push_ns = (suite_Now_ns() - Start) / SUITE_BENCH_FRAMES;
+    WireBytes = Emulator.CommandBytes + Emulator.DataBytes - WireBytes;
+    stopWaterfall(&Waterfall);
+    printf("  waterfall line  (%4u bytes on wire)    %8.0f\n", WireBytes / SUITE_BENCH_FRAMES, Push_ns);
+
+} // END OF suite_Benchmarks
+
+
+
+/********************************************************************************************************
+* @brief Display suite: controller checks, golden images, benchmarks
+*
+* @author original: Hab Collector \n
+*
+* @return 0 all checks pass, 1 any failure
+*
+* STEP 1: u8g2 into the emulator - the init_Display_SSD1309 sequence
+* STEP 2: Controller checks, golden images, waterfall and label cache
+* STEP 3: Benchmarks and result
+********************************************************************************************************/
+int main(int argc, char *argv[])
+{
+    const char *GoldenDirectory = SUITE_DEFAULT_GOLDEN;
+    bool Update = false;
+
+    for (int Arg = 1; Arg < argc; Arg++)
+    {
+        if (strcmp(argv[Arg], "--update") == 0)
+            Update = true;
+        else
+            GoldenDirectory = argv[Arg];
+    }
+
+    // STEP 1: u8g2 into the emulator - the init_Display_SSD1309 sequence
+    initSSD1309_Emulator(&Emulator, &U8G2);
+    u8g2_Setup_ssd1309_128x64_noname0_f(&U8G2, U8G2_R0, Emulator_U8G2_WriteBytes, Emulator_U8G2_GPIO_DelayControl);
+    u8g2_ClearBuffer(&U8G2);
+    u8g2_InitDisplay(&U8G2);
+    u8g2_SetPowerSave(&U8G2, 0);
+    u8g2_SetFlipMode(&U8G2, 0);
+
+    // STEP 2: Controller checks, golden images, waterfall and label cache
+    suite_ControllerChecks();
+    printf("golden images (%s%s)\n", GoldenDirectory, Update ? ", updating" : "");
+    for (uint32_t ScreenIndex = 0; ScreenIndex < (sizeof(SuiteScreen) / sizeof(SuiteScreen[0])); ScreenIndex++)
+        suite_CheckScreen(&SuiteScreen[ScreenIndex], GoldenDirectory, Update);
+    suite_WaterfallChecks(GoldenDirectory, Update);
+    suite_LabelChecks();
+
+    // STEP 3: Benchmarks and result
+    suite_Benchmarks();
+    if (Failures != 0)
+    {
+        printf("FAIL: %u checks\n", Failures);
+        return(1);
+    }
+    printf("PASS\n");
+    return(0);
+
+} // END OF main
@@ -0,0 +1,452 @@
+/******************************************************************************************************
+ * @file            ssd1309_emulator.c
+ * @brief           Headless SSD1309 128x64 emulator behind the u8x8 byte and GPIO callbacks
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        Linux host (no target hardware) \n
+ * IDE:             Vitis 2024.2 / make \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            Stands in for U8G2_WriteBytes_SPI / U8G2_GPIO_DelayControl of AXI_SPI_Display_SSD1309.c:
+ *                  the bytes u8g2 would clock out over SPI are decoded as the controller would -
+ *                  commands (D/C low) with their argument bytes, data (D/C high) into a 128x64 GDDRAM
+ *                  with page, horizontal and vertical addressing.  The panel image applies segment
+ *                  remap, COM scan direction, display start line, inverse, entire on and display off,
+ *                  assuming the panel is mounted upright for the u8g2 flip 0 setting (0xA1, 0xC8).
+ *                  Snapshots are u8x8_capture P1 PBM text, the same format as u8g2_WriteBufferPBM.
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#include "ssd1309_emulator.h"
+#include <string.h>
+
+// STATIC VARIABLES
+static Type_SSD1309_Emulator *ActiveEmulator = NULL;     // u8x8 callbacks have no context - one emulator at a time
+static char *CaptureText = NULL;
+static size_t CaptureSize = 0;
+static size_t CaptureLength = 0;
+
+
+
+/********************************************************************************************************
+* @brief Resets the emulator to the SSD1309 power on state and makes it the target of the u8x8 callbacks
+*
+* @author original: Hab Collector \n
+*
+* @note: Set up u8g2 with Emulator_U8G2_WriteBytes and Emulator_U8G2_GPIO_DelayControl, e.g.
+* u8g2_Setup_ssd1309_128x64_noname0_f(U8G2, U8G2_R0, Emulator_U8G2_WriteBytes, Emulator_U8G2_GPIO_DelayControl)
+*
+* @param Emulator: Emulator handle
+* @param U8G2_Handle: Display driven into the emulator (not used - kept for symmetry with init_Display_SSD1309)
+********************************************************************************************************/
+void initSSD1309_Emulator(Type_SSD1309_Emulator *Emulator, u8g2_t *U8G2_Handle)
+{
+    (void)U8G2_Handle;
+
+    memset(Emulator, 0x00, sizeof(Type_SSD1309_Emulator));
+    Emulator->ColumnEnd = EMULATOR_WIDTH - 1;
+    Emulator->PageEnd = EMULATOR_PAGE_COUNT - 1;
+    Emulator->Addressing = EMULATOR_PAGE_ADDRESSING;
+    Emulator->Contrast = 0x7F;
+    ActiveEmulator = Emulator;
+
+} // END OF initSSD1309_Emulator
+
+
+
+/********************************************************************************************************
+* @brief Number of argument bytes that follow a command byte
+*
+* @author original: Hab Collector \n
+*
+* @param Command: Command byte
+*
+* @return Argument bytes (0 for single byte commands)
+********************************************************************************************************/
+static uint8_t emulatorCommandArgs(uint8_t Command)
+{
+    switch (Command)
+    {
+        case 0x81:      // Contrast
+        case 0x20:      // Memory addressing mode
+        case 0xA8:      // Multiplex ratio
+        case 0xD3:      // Display offset
+        case 0xD5:      // Clock divide / oscillator
+        case 0xD9:      // Pre-charge period
+        case 0xDA:      // COM pin configuration
+        case 0xDB:      // VCOMH deselect level
+        case 0xFD:      // Command lock
+        case 0x8D:      // Charge pump (SSD1306 compatible modules)
+            return(1);
+        case 0x21:      // Column address window
+        case 0x22:      // Page address window
+        case 0xA3:      // Vertical scroll area
+            return(2);
+        case 0x29:      // Vertical and horizontal scroll setup
+        case 0x2A:
+        case 0x2C:      // Content scroll
+        case 0x2D:
+            return(5);
+        case 0x26:      // Horizontal scroll setup
+        case 0x27:
+            return(6);
+        default:
+            return(0);
+    }
+
+} // END OF emulatorCommandArgs
+
+
+
+/********************************************************************************************************
+* @brief Executes a complete command (command byte plus its arguments)
+*
+* @author original: Hab Collector \n
+*
+* @param Emulator: Emulator handle
+*
+* STEP 1: Commands with arguments
+* STEP 2: Single byte commands - ranges first
+********************************************************************************************************/
+static void emulatorExecute(Type_SSD1309_Emulator *Emulator)
+{
+    uint8_t Command = Emulator->Command;
+    uint8_t *Args = Emulator->Args;
+
+    // STEP 1: Commands with arguments
+    switch (Command)
+    {
+        case 0x81:
+            Emulator->Contrast = Args[0];
+            return;
+        case 0x20:
+            Emulator->Addressing = (Type_EmulatorAddressing)((Args[0] & 0x03) > 2 ? EMULATOR_PAGE_ADDRESSING : (Args[0] & 0x03));
+            return;
+        case 0x21:
+            Emulator->ColumnStart = Args[0] & 0x7F;
+            Emulator->ColumnEnd = Args[1] & 0x7F;
+            Emulator->Column = Emulator->ColumnStart;
+            return;
+        case 0x22:
+            Emulator->PageStart = Args[0] & 0x07;
+            Emulator->PageEnd = Args[1] & 0x07;
+            Emulator->Page = Emulator->PageStart;
+            return;
+        default:
+            if (emulatorCommandArgs(Command) != 0)
+                return;     // Timing, scroll and hardware configuration - no effect on the image
+            break;
+    }
+
+    // STEP 2: Single byte commands - ranges first
+    if (Command <= 0x0F)
+    {
+        if (Emulator->Addressing == EMULATOR_PAGE_ADDRESSING)
+            Emulator->Column = (Emulator->Column & 0xF0) | Command;
+    }
+    else if (Command <= 0x1F)
+    {
+        if (Emulator->Addressing == EMULATOR_PAGE_ADDRESSING)
+            Emulator->Column = ((Command & 0x07) << 4) | (Emulator->Column & 0x0F);
+    }
+    else if ((Command >= 0x40) && (Command <= 0x7F))
+    {
+        Emulator->StartLine = Command & 0x3F;
+    }
+    else if ((Command >= 0xB0) && (Command <= 0xB7))
+    {
+        if (Emulator->Addressing == EMULATOR_PAGE_ADDRESSING)
+            Emulator->Page = Command & 0x07;
+    }
+    else
+    {
+        switch (Command)
+        {
+            case 0xA0: Emulator->SegmentRemap = false; break;
+            case 0xA1: Emulator->SegmentRemap = true; break;
+            case 0xA4: Emulator->EntireOn = false; break;
+            case 0xA5: Emulator->EntireOn = true; break;
+            case 0xA6: Emulator->Inverse = false; break;
+            case 0xA7: Emulator->Inverse = true; break;
+            case 0xAE: Emulator->DisplayOn = false; break;
+            case 0xAF: Emulator->DisplayOn = true; break;
+            case 0xC0: Emulator->ComReverse = false; break;
+            case 0xC8: Emulator->ComReverse = true; break;
+            case 0x2E:      // Deactivate / activate scroll
+            case 0x2F:
+            case 0xE3:      // NOP
+                break;
+            default:
+                Emulator->UnknownCommands++;
+                break;
+        }
+    }
+
+} // END OF emulatorExecute
+
+
+
+/********************************************************************************************************
+* @brief Decodes one byte from the wire: command bytes and arguments with D/C low, GDDRAM data with D/C high
+*
+* @author original: Hab Collector \n
+*
+* @param Emulator: Emulator handle
+* @param Byte: Byte clocked in
+*
+* STEP 1: Command byte or argument
+* STEP 2: Data - write and advance per the addressing mode
+********************************************************************************************************/
+static void emulatorWriteByte(Type_SSD1309_Emulator *Emulator, uint8_t Byte)
+{
+    if (!Emulator->Selected)
+        Emulator->UnselectedBytes++;
+
+    // STEP 1: Command byte or argument
+    if (!Emulator->DataMode)
+    {
+        Emulator->CommandBytes++;
+        if (Emulator->ArgCount < Emulator->ArgsExpected)
+        {
+            Emulator->Args[Emulator->ArgCount++] = Byte;
+        }
+        else
+        {
+            Emulator->Command = Byte;
+            Emulator->ArgsExpected = emulatorCommandArgs(Byte);
+            Emulator->ArgCount = 0;
+        }
+        if (Emulator->ArgCount == Emulator->ArgsExpected)
+        {
+            emulatorExecute(Emulator);
+            Emulator->ArgsExpected = 0;
+            Emulator->ArgCount = 0;
+        }
+        return;
+    }
+
+    // STEP 2: Data - write and advance per the addressing mode
+    Emulator->DataBytes++;
+    Emulator->Ram[Emulator->Page][Emulator->Column] = Byte;
+    switch (Emulator->Addressing)
+    {
+        case EMULATOR_PAGE_ADDRESSING:
+            Emulator->Column = (Emulator->Column + 1) & (EMULATOR_WIDTH - 1);
+            break;
+
+        case EMULATOR_HORIZONTAL_ADDRESSING:
+            if (Emulator->Column++ >= Emulator->ColumnEnd)
+            {
+                Emulator->Column = Emulator->ColumnStart;
+                Emulator->Page = (Emulator->Page >= Emulator->PageEnd) ? Emulator->PageStart : (Emulator->Page + 1);
+            }
+            break;
+
+        case EMULATOR_VERTICAL_ADDRESSING:
+            if (Emulator->Page++ >= Emulator->PageEnd)
+            {
+                Emulator->Page = Emulator->PageStart;
+                Emulator->Column = (Emulator->Column >= Emulator->ColumnEnd) ? Emulator->ColumnStart : (Emulator->Column + 1);
+            }
+            break;
+    }
+
+} // END OF emulatorWriteByte
+
+
+
+/********************************************************************************************************
+* @brief u8x8 byte callback - the emulator's SPI port
+*
+* @author original: Hab Collector \n
+*
+* @param   U8X8         U8G2 library object - not used
+* @param   Msg          The present action desired by the U8G2 library
+* @param   ArgInt       D/C level (U8X8_MSG_BYTE_SET_DC) or byte count (U8X8_MSG_BYTE_SEND)
+* @param   ArgPtr       Bytes to send (U8X8_MSG_BYTE_SEND)
+*
+* @return Must always return 1
+********************************************************************************************************/
+uint8_t Emulator_U8G2_WriteBytes(u8x8_t *U8X8, uint8_t Msg, uint8_t ArgInt, void *ArgPtr)
+{
+    (void)U8X8;
+    Type_SSD1309_Emulator *Emulator = ActiveEmulator;
+
+    switch (Msg)
+    {
+        case U8X8_MSG_BYTE_START_TRANSFER:
+            Emulator->Selected = true;
+            Emulator->Transfers++;
+            break;
+
+        case U8X8_MSG_BYTE_END_TRANSFER:
+            Emulator->Selected = false;
+            break;
+
+        case U8X8_MSG_BYTE_SET_DC:
+            Emulator->DataMode = (ArgInt != 0);
+            break;
+
+        case U8X8_MSG_BYTE_SEND:
+        {
+            const uint8_t *Data = (const uint8_t *)ArgPtr;
+            for (uint8_t Index = 0; Index < ArgInt; Index++)
+                emulatorWriteByte(Emulator, Data[Index]);
+        }
+        break;
+
+        case U8X8_MSG_BYTE_INIT:
+        default:
+            break;
+    }
+    return(1);
+
+} // END OF Emulator_U8G2_WriteBytes
+
+
+
+/********************************************************************************************************
+* @brief u8x8 GPIO and delay callback - reset, CS and delays have no effect on the emulator
+*
+* @author original: Hab Collector \n
+*
+* @param   U8X8         U8G2 library object - not used
+* @param   Msg          The present action desired by the U8G2 library
+* @param   ArgInt       Msg dependent
+* @param   ArgPtr       Msg dependent
+*
+* @return Must always return 1
+********************************************************************************************************/
+uint8_t Emulator_U8G2_GPIO_DelayControl(u8x8_t *U8X8, uint8_t Msg, uint8_t ArgInt, void *ArgPtr)
+{
+    (void)U8X8;
+    (void)ArgPtr;
+
+    if ((Msg == U8X8_MSG_GPIO_DC) && (ActiveEmulator != NULL))
+        ActiveEmulator->DataMode = (ArgInt != 0);
+    return(1);
+
+} // END OF Emulator_U8G2_GPIO_DelayControl
+
+
+
+/********************************************************************************************************
+* @brief Pixel as seen on the panel
+*
+* @author original: Hab Collector \n
+*
+* @param Emulator: Emulator handle
+* @param X: Column 0 (left) - 127
+* @param Y: Row 0 (top) - 63
+*
+* @return 1 lit, 0 dark
+*
+* STEP 1: Display off / entire display on
+* STEP 2: Panel position to GDDRAM bit - segment remap, COM direction, start line
+********************************************************************************************************/
+uint8_t getEmulatorPixel(Type_SSD1309_Emulator *Emulator, uint8_t X, uint8_t Y)
+{
+    // STEP 1: Display off / entire display on
+    if (!Emulator->DisplayOn)
+        return(0);
+    if (Emulator->EntireOn)
+        return(1);
+
+    // STEP 2: Panel position to GDDRAM bit - segment remap, COM direction, start line
+    uint8_t Column = Emulator->SegmentRemap ? X : ((EMULATOR_WIDTH - 1) - X);
+    uint8_t Com = Emulator->ComReverse ? Y : ((EMULATOR_HEIGHT - 1) - Y);
+    uint8_t Row = (Com + Emulator->StartLine) & (EMULATOR_HEIGHT - 1);
+    uint8_t Pixel = (Emulator->Ram[Row >> 3][Column] >> (Row & 0x07)) & 0x01;
+    return(Emulator->Inverse ? (Pixel ^ 0x01) : Pixel);
+
+} // END OF getEmulatorPixel
+
+
+
+/********************************************************************************************************
+* @brief u8x8_capture output callback - appends to the capture text
+*
+* @author original: Hab Collector \n
+*
+* @param Text: Null terminated text
+********************************************************************************************************/
+static void captureOut(const char *Text)
+{
+    size_t Length = strlen(Text);
+
+    if ((CaptureLength + Length) < CaptureSize)
+    {
+        memcpy(&CaptureText[CaptureLength], Text, Length);
+        CaptureLength += Length;
+        CaptureText[CaptureLength] = '\0';
+    }
+
+} // END OF captureOut
+
+
+
+/********************************************************************************************************
+* @brief Snapshot of the panel as P1 PBM text (u8x8_capture format)
+*
+* @author original: Hab Collector \n
+*
+* @param Emulator: Emulator handle
+* @param Text: Returned by reference - PBM text (EMULATOR_PBM_BYTES is enough)
+* @param TextSize: Size of Text
+*
+* @return Length of the text
+*
+* STEP 1: Panel image back to a vertical_top_lsb buffer
+* STEP 2: Write through u8x8_capture
+********************************************************************************************************/
+size_t captureEmulatorPBM(Type_SSD1309_Emulator *Emulator, char *Text, size_t TextSize)
+{
+    uint8_t Panel[EMULATOR_PAGE_COUNT * EMULATOR_WIDTH] = {0};
+
+    // STEP 1: Panel image back to a vertical_top_lsb buffer
+    for (uint8_t Y = 0; Y < EMULATOR_HEIGHT; Y++)
+    {
+        for (uint8_t X = 0; X < EMULATOR_WIDTH; X++)
+            Panel[((Y >> 3) * EMULATOR_WIDTH) + X] |= (uint8_t)(getEmulatorPixel(Emulator, X, Y) << (Y & 0x07));
+    }
+
+    // STEP 2: Write through u8x8_capture
+    CaptureText = Text;
+    CaptureSize = TextSize;
+    CaptureLength = 0;
+    Text[0] = '\0';
+    u8x8_capture_write_pbm_pre(EMULATOR_WIDTH / 8U, EMULATOR_PAGE_COUNT, captureOut);
+    u8x8_capture_write_pbm_buffer(Panel, EMULATOR_WIDTH / 8U, EMULATOR_PAGE_COUNT, u8x8_capture_get_pixel_1, captureOut);
+    return(CaptureLength);
+
+} // END OF captureEmulatorPBM
+
+
+
+/********************************************************************************************************
+* @brief Snapshot of the u8g2 frame buffer as P1 PBM text (u8g2_WriteBufferPBM)
+*
+* @author original: Hab Collector \n
+*
+* @param U8G2_Handle: Display
+* @param Text: Returned by reference - PBM text (EMULATOR_PBM_BYTES is enough)
+* @param TextSize: Size of Text
+*
+* @return Length of the text
+********************************************************************************************************/
+size_t captureBufferPBM(u8g2_t *U8G2_Handle, char *Text, size_t TextSize)
+{
+    CaptureText = Text;
+    CaptureSize = TextSize;
+    CaptureLength = 0;
+    Text[0] = '\0';
+    u8g2_WriteBufferPBM(U8G2_Handle, captureOut);
+    return(CaptureLength);
+
+} // END OF captureBufferPBM
@@ -0,0 +1,88 @@
+/******************************************************************************************************
+ * @file            ssd1309_emulator.h
+ * @brief           Header file to support ssd1309_emulator.c
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        Linux host (no target hardware) \n
+ * IDE:             Vitis 2024.2 / make \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#ifndef SSD1309_EMULATOR_H_
+#define SSD1309_EMULATOR_H_
+#ifdef __cplusplus
+extern"C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "u8g2.h"
+
+// DEFINES
+#define EMULATOR_WIDTH              128U
+#define EMULATOR_HEIGHT             64U
+#define EMULATOR_PAGE_COUNT         (EMULATOR_HEIGHT / 8U)
+#define EMULATOR_MAX_ARGS           6U
+#define EMULATOR_PBM_BYTES          (16U + ((EMULATOR_WIDTH + 1U) * EMULATOR_HEIGHT))  // u8x8_capture P1 text
+
+
+// TYPEDEFS AND ENUMS
+typedef enum
+{
+    EMULATOR_HORIZONTAL_ADDRESSING = 0,
+    EMULATOR_VERTICAL_ADDRESSING,
+    EMULATOR_PAGE_ADDRESSING
+}Type_EmulatorAddressing;
+
+typedef struct
+{
+    uint8_t                     Ram[EMULATOR_PAGE_COUNT][EMULATOR_WIDTH];   // GDDRAM, vertical_top_lsb
+    uint8_t                     Column;                 // RAM write pointer
+    uint8_t                     Page;
+    uint8_t                     ColumnStart;            // 0x21 / 0x22 window (horizontal, vertical addressing)
+    uint8_t                     ColumnEnd;
+    uint8_t                     PageStart;
+    uint8_t                     PageEnd;
+    Type_EmulatorAddressing     Addressing;
+    uint8_t                     StartLine;              // 0x40 - 0x7F: RAM row shown on the first COM
+    uint8_t                     Contrast;
+    bool                        SegmentRemap;           // 0xA1: column 0 to SEG127
+    bool                        ComReverse;             // 0xC8: COM scan reversed
+    bool                        Inverse;                // 0xA7
+    bool                        EntireOn;               // 0xA5
+    bool                        DisplayOn;              // 0xAF
+    bool                        DataMode;               // D/C high
+    bool                        Selected;               // Inside a transfer
+    uint8_t                     Command;                // Command waiting for its arguments
+    uint8_t                     ArgsExpected;
+    uint8_t                     ArgCount;
+    uint8_t                     Args[EMULATOR_MAX_ARGS];
+    uint32_t                    CommandBytes;           // Wire statistics
+    uint32_t                    DataBytes;
+    uint32_t                    Transfers;
+    uint32_t                    UnknownCommands;
+    uint32_t                    UnselectedBytes;        // Bytes sent without a transfer in progress
+}Type_SSD1309_Emulator;
+
+
+// FUNCTION PROTOTYPES
+void initSSD1309_Emulator(Type_SSD1309_Emulator *Emulator, u8g2_t *U8G2_Handle);
+uint8_t Emulator_U8G2_WriteBytes(u8x8_t *U8X8, uint8_t Msg, uint8_t ArgInt, void *ArgPtr);
+uint8_t Emulator_U8G2_GPIO_DelayControl(u8x8_t *U8X8, uint8_t Msg, uint8_t ArgInt, void *ArgPtr);
+uint8_t getEmulatorPixel(Type_SSD1309_Emulator *Emulator, uint8_t X, uint8_t Y);
+size_t captureEmulatorPBM(Type_SSD1309_Emulator *Emulator, char *Text, size_t TextSize);
+size_t captureBufferPBM(u8g2_t *U8G2_Handle, char *Text, size_t TextSize);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SSD1309_EMULATOR_H_ */
@@ -0,0 +1,463 @@
+/******************************************************************************************************
+ * @file            storage_bench.c
+ * @brief           Native Linux benchmark / regression run of the storage and audio ingest stack
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        Linux host (no target hardware) \n
+ * IDE:             Vitis 2024.2 / make \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            Builds FatFs, diskio (dispatcher + sector cache) and Audio_File_API unchanged from
+ *                  src/ and runs them on an SD card image file or a RAM disk:
+ *                    0) Re-initialize the drive over a dirty write-back sector - it must reach the medium
+ *                    1) Format the medium, create 0:/AUDIO and copy the reference WAV onto it
+ *                    2) Remount cold, locate the WAV with getNextWavFile / getWavFileHeader
+ *                    3) Stream the file in MAX_CHUNK_BUFFER reads (the WAV feeder's read size),
+ *                       PCM16 samples are pushed through the Type_int16_t_CircularBuffer
+ *                    4) Report MB/s and CPU ms per MB; exit non zero if the data read back differs,
+ *                       the header is rejected or the PCM16 path did not see every sample
+ *
+ *                  Usage: storage_bench <reference.wav> [image.img | --ram]
+ *                         storage_bench --fixture <out.wav>   (16 bit stereo PCM reference for the run)
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "ff.h"
+#include "diskio.h"
+#include "diskio_cache.h"
+#include "diskio_ram.h"
+#include "diskio_file.h"
+#include "Audio_File_API.h"
+
+// DEFINES
+#define BENCH_DISK_SECTORS      (64U * 2048U)       // 64 MB medium - FAT32 with 512 byte clusters is not required
+#define BENCH_CHUNK_BYTES       (1024U * 8U)        // FFT_SIZE * CHUNK_MULTIPLIER - see Softcore_Audio_SA.h
+#define BENCH_PASSES            20U
+#define BENCH_DEFAULT_IMAGE     "storage_bench.img"
+#define FNV_OFFSET_BASIS        0x811C9DC5U
+#define FNV_PRIME               0x01000193U
+#define FIXTURE_SAMPLE_RATE     44100U
+#define FIXTURE_FRAMES          (FIXTURE_SAMPLE_RATE * 3U)
+#define FIXTURE_AMPLITUDE       24000
+
+// STATIC VARIABLES
+static FATFS FatFs;
+static BYTE ChunkBuffer[BENCH_CHUNK_BYTES];
+static BYTE WorkBuffer[FF_MAX_SS * 4];
+
+
+
+/********************************************************************************************************
+* @brief Incremental FNV-1a hash of a byte run - used to compare the data read back against the reference
+*
+* @author original: Hab Collector \n
+*
+* @param Hash: Running hash (start with FNV_OFFSET_BASIS)
+* @param Data: Bytes to add
+* @param Length: Number of bytes
+*
+* @return Updated hash
+********************************************************************************************************/
+static uint32_t bench_Hash(uint32_t Hash, const BYTE *Data, size_t Length)
+{
+    for (size_t Index = 0; Index < Length; Index++)
+    {
+        Hash ^= Data[Index];
+        Hash *= FNV_PRIME;
+    }
+    return(Hash);
+
+} // END OF bench_Hash
+
+
+
+/********************************************************************************************************
+* @brief Wall clock and CPU time (user + system) in seconds
+*
+* @author original: Hab Collector \n
+*
+* @param WallSeconds: Returned by reference - monotonic wall time
+* @param CpuSeconds: Returned by reference - process CPU time
+********************************************************************************************************/
+static void bench_Now(double *WallSeconds, double *CpuSeconds)
+{
+    struct timespec Wall;
+    struct rusage Usage;
+
+    clock_gettime(CLOCK_MONOTONIC, &Wall);
+    getrusage(RUSAGE_SELF, &Usage);
+    *WallSeconds = Wall.tv_sec + (Wall.tv_nsec * 1e-9);
+    *CpuSeconds = Usage.ru_utime.tv_sec + Usage.ru_stime.tv_sec + ((Usage.ru_utime.tv_usec + Usage.ru_stime.tv_usec) * 1e-6);
+
+} // END OF bench_Now
+
+
+
+/********************************************************************************************************
+* @brief Formats the attached medium and copies the reference WAV into the audio directory
+*
+* @author original: Hab Collector \n
+*
+* @param ReferenceFile: Host path of the WAV file
+* @param ReferenceName: File name to use on the medium
+* @param ReferenceHash: Returned by reference - FNV-1a hash of the reference file
+*
+* @return FR_OK on success, else the failing FatFs result (FR_INT_ERR for host file errors)
+*
+* STEP 1: Format and mount
+* STEP 2: Copy the reference file in chunks
+* STEP 3: Unmount - flushes the cache and directory entries
+********************************************************************************************************/
+static FRESULT bench_PrepareMedium(const char *ReferenceFile, const char *ReferenceName, uint32_t *ReferenceHash)
+{
+    MKFS_PARM FormatOptions = {FM_FAT | FM_SFD, 0, 0, 0, 0};
+    char PathFileName[MAX_PATH_FILE_LENGTH];
+    FIL FileHandle;
+    FRESULT FileResult;
+    UINT BytesWritten;
+    size_t BytesRead;
+
+    // STEP 1: Format and mount
+    FileResult = f_mkfs(ROOT_PATH, &FormatOptions, WorkBuffer, sizeof(WorkBuffer));
+    if (FileResult != FR_OK)
+        return(FileResult);
+    FileResult = f_mount(&FatFs, ROOT_PATH, 1);
+    if (FileResult != FR_OK)
+        return(FileResult);
+    FileResult = f_mkdir(AUDIO_DIRECTORY);
+    if (FileResult != FR_OK)
+        return(FileResult);
+
+    // STEP 2: Copy the reference file in chunks
+    FILE *Reference = fopen(ReferenceFile, "rb");
+    if (Reference == NULL)
+        return(FR_INT_ERR);
+    snprintf(PathFileName, sizeof(PathFileName), "%s/%s", AUDIO_DIRECTORY, ReferenceName);
+    FileResult = f_open(&FileHandle, PathFileName, FA_CREATE_ALWAYS | FA_WRITE);
+    *ReferenceHash = FNV_OFFSET_BASIS;
+    while ((FileResult == FR_OK) && ((BytesRead = fread(ChunkBuffer, 1, sizeof(ChunkBuffer), Reference)) > 0))
+    {
+        *ReferenceHash = bench_Hash(*ReferenceHash, ChunkBuffer, BytesRead);
+        FileResult = f_write(&FileHandle, ChunkBuffer, (UINT)BytesRead, &BytesWritten);
+        if ((FileResult == FR_OK) && (BytesWritten != BytesRead))
+            FileResult = FR_DENIED;
+    }
+    fclose(Reference);
+    if (FileResult != FR_OK)
+        return(FileResult);
+    FileResult = f_close(&FileHandle);
+    if (FileResult != FR_OK)
+        return(FileResult);
+
+    // STEP 3: Unmount - flushes the cache and directory entries
+    disk_cache_flush();
+    return(f_mount(NULL, ROOT_PATH, 0));
+
+} // END OF bench_PrepareMedium
+
+
+
+/********************************************************************************************************
+* @brief Checks that re-initializing the cached drive (what f_mount does) writes back dirty write-back
+* lines instead of dropping them
+*
+* @author original: Hab Collector \n
+*
+* @param None
+*
+* @return true if the sector written through the cache reached the backend
+*
+* STEP 1: Write one sector through a write-back cache
+* STEP 2: Re-initialize the drive and read the sector straight from the backend
+* STEP 3: Restore the default policy
+********************************************************************************************************/
+static bool bench_CacheReinit(void)
+{
+#if DISK_CACHE_ENABLE
+    const LBA_t Sector = BENCH_DISK_SECTORS - 1U;
+    BYTE ReadBack[FF_MAX_SS];
+
+    // STEP 1: Write one sector through a write-back cache
+    memset(WorkBuffer, 0xA5, FF_MAX_SS);
+    bool SectorOK = ((disk_initialize(0) & STA_NOINIT) == 0) && (disk_cache_set_policy(DISK_CACHE_WRITE_BACK) == RES_OK) && (disk_write(0, WorkBuffer, Sector, 1) == RES_OK);
+
+    // STEP 2: Re-initialize the drive and read the sector straight from the backend
+    SectorOK = SectorOK && ((disk_initialize(0) & STA_NOINIT) == 0) && (disk_backend(0)->Read(0, ReadBack, Sector, 1) == RES_OK);
+    SectorOK = SectorOK && (memcmp(ReadBack, WorkBuffer, FF_MAX_SS) == 0);
+
+    // STEP 3: Restore the default policy
+    disk_cache_set_policy(DISK_CACHE_DEFAULT_POLICY);
+    return(SectorOK);
+#else
+    return(true);
+#endif
+
+} // END OF bench_CacheReinit
+
+
+
+/********************************************************************************************************
+* @brief Writes the 16 bit stereo PCM reference WAV the run uses: a triangle on the left channel and a
+* square on the right, so every sample value is known and the file passes getWavFileHeader
+*
+* @author original: Hab Collector \n
+*
+* @param FixturePath: Host path of the WAV to create
+*
+* @return 0 on success, 2 on a host file error
+*
+* STEP 1: Standard 44 byte PCM header
+* STEP 2: Interleaved little endian sample frames
+********************************************************************************************************/
+static int bench_WriteFixture(const char *FixturePath)
+{
+    Type_WavHeader WavHeader;
+    FILE *Fixture = fopen(FixturePath, "wb");
+    if (Fixture == NULL)
+        return(2);
+
+    // STEP 1: Standard 44 byte PCM header
+    memcpy(WavHeader.RiffChunkID, RIFF_FILE_TYPE, 4);
+    memcpy(WavHeader.RiffType, WAVE_RIFF_TYPE, 4);
+    memcpy(WavHeader.FormatChunkID, "fmt ", 4);
+    memcpy(WavHeader.DataChunkID, "data", 4);
+    WavHeader.FormatChunkSize = WAVE_CHUNK_SIZE;
+    WavHeader.Compression = COMPRESSION_NONE;
+    WavHeader.ChannelNumber = STEREO;
+    WavHeader.SampleRate = FIXTURE_SAMPLE_RATE;
+    WavHeader.BitsPerSample = PCM_16_BIT_SIGNED;
+    WavHeader.BlockAlign = STEREO * (PCM_16_BIT_SIGNED / 8);
+    WavHeader.ByteRate = FIXTURE_SAMPLE_RATE * WavHeader.BlockAlign;
+    WavHeader.DataSize = FIXTURE_FRAMES * WavHeader.BlockAlign;
+    WavHeader.RiffChunkSize = WavHeader.DataSize + sizeof(WavHeader) - 8;
+    bool FileOK = (fwrite(&WavHeader, sizeof(WavHeader), 1, Fixture) == 1);
+
+    // STEP 2: Interleaved little endian sample frames
+    for (uint32_t Frame = 0; FileOK && (Frame < FIXTURE_FRAMES); Frame++)
+    {
+        int32_t Phase = (int32_t)(Frame % 100U);
+        int16_t Left = (int16_t)(((Phase < 50) ? (Phase * 4 - 100) : (300 - Phase * 4)) * (FIXTURE_AMPLITUDE / 100));
+        int16_t Right = (int16_t)(((Frame / 40U) & 1U) ? FIXTURE_AMPLITUDE : -FIXTURE_AMPLITUDE);
+        uint8_t FrameBytes[4] = {(uint8_t)Left, (uint8_t)((uint16_t)Left >> 8), (uint8_t)Right, (uint8_t)((uint16_t)Right >> 8)};
+        FileOK = (fwrite(FrameBytes, sizeof(FrameBytes), 1, Fixture) == 1);
+    }
+    if ((fclose(Fixture) != 0) || !FileOK)
+        return(2);
+    printf("fixture   : %s, %u frames 16 bit stereo at %u Hz\n", FixturePath, FIXTURE_FRAMES, FIXTURE_SAMPLE_RATE);
+    return(0);
+
+} // END OF bench_WriteFixture
+
+
+
+/********************************************************************************************************
+* @brief Reads the whole WAV file the way the WAV feeder does: chunked f_read, PCM16 samples unpacked
+* and pushed through a circular buffer that is drained as it fills
+*
+* @author original: Hab Collector \n
+*
+* @param AudioFile: Located WAV file (name, size and header valid)
+* @param FileHash: Returned by reference - FNV-1a hash of every byte read
+* @param SampleCount: Returned by reference - PCM16 samples pushed through the circular buffer
+*
+* @return FR_OK on success, else the failing FatFs result
+*
+* STEP 1: Open and create the circular buffer
+* STEP 2: Chunked reads, unpack PCM16 through the CB
+* STEP 3: Close
+********************************************************************************************************/
+static FRESULT bench_IngestFile(Type_AudioFile *AudioFile, uint32_t *FileHash, uint32_t *SampleCount)
+{
+    Type_int16_t_CircularBuffer CircularBuffer;
+    Type_Union_PCM_AudioValue PCM_AudioValue;
+    FIL FileHandle;
+    FRESULT FileResult;
+    UINT BytesRead;
+    int16_t Sample;
+    bool Half_Empty, Half_Full;
+
+    // STEP 1: Open and create the circular buffer
+    FileResult = f_open(&FileHandle, AudioFile->PathFileName, FA_READ);
+    if (FileResult != FR_OK)
+        return(FileResult);
+    if (!init_CB(&CircularBuffer, (BENCH_CHUNK_BYTES / 2)))
+    {
+        f_close(&FileHandle);
+        return(FR_NOT_ENOUGH_CORE);
+    }
+
+    // STEP 2: Chunked reads, unpack PCM16 through the CB
+    bool IsPCM16 = AudioFile->IsOpen && (AudioFile->Header.BitsPerSample == PCM_16_BIT_SIGNED);
+    *FileHash = FNV_OFFSET_BASIS;
+    *SampleCount = 0;
+    do
+    {
+        FileResult = f_read(&FileHandle, ChunkBuffer, sizeof(ChunkBuffer), &BytesRead);
+        if (FileResult != FR_OK)
+            break;
+        *FileHash = bench_Hash(*FileHash, ChunkBuffer, BytesRead);
+        for (UINT Index = 0; IsPCM16 && ((Index + 1) < BytesRead); Index += 2)
+        {
+            PCM_AudioValue.ByteValue[LSB] = ChunkBuffer[Index];
+            PCM_AudioValue.ByteValue[MSB] = ChunkBuffer[Index + 1];
+            if (!write_CB(&CircularBuffer, &PCM_AudioValue.Signed16Bit_Value))
+            {
+                while (read_CB(&CircularBuffer, &Sample, &Half_Empty, &Half_Full));
+                write_CB(&CircularBuffer, &PCM_AudioValue.Signed16Bit_Value);
+            }
+            (*SampleCount)++;
+        }
+    } while (BytesRead == sizeof(ChunkBuffer));
+
+    // STEP 3: Close
+    free_CB(&CircularBuffer);
+    f_close(&FileHandle);
+    return(FileResult);
+
+} // END OF bench_IngestFile
+
+
+
+/********************************************************************************************************
+* @brief Benchmark entry point
+*
+* @author original: Hab Collector \n
+*
+* @param argv[1]: Reference WAV file
+* @param argv[2]: Optional SD card image path (created / overwritten) or --ram for the RAM disk
+* @note: --fixture <out.wav> only writes the 16 bit reference WAV (bench_WriteFixture)
+*
+* @return 0 pass, 1 data mismatch, rejected header or storage error, 2 usage / setup error
+*
+* STEP 1: Attach the backend
+* STEP 2: Put the reference WAV on the medium
+* STEP 3: Mount and locate the WAV as the application does
+* STEP 4: Timed ingest passes
+* STEP 5: Report
+********************************************************************************************************/
+int main(int argc, char *argv[])
+{
+    Type_AudioFile AudioFile;
+    uint32_t ReferenceHash = 0;
+    uint32_t FileHash = 0;
+    uint32_t SampleCount = 0;
+    uint16_t FileCount = 0;
+    BYTE *RamDisk = NULL;
+    DRESULT DiskResult;
+
+    if ((argc < 2) || (argc > 3))
+    {
+        fprintf(stderr, "usage: %s <reference.wav> [image.img | --ram] | --fixture <out.wav>\n", argv[0]);
+        return(2);
+    }
+    if (strcmp(argv[1], "--fixture") == 0)
+        return((argc == 3) ? bench_WriteFixture(argv[2]) : 2);
+
+    // STEP 1: Attach the backend
+    const char *ImagePath = (argc == 3) ? argv[2] : BENCH_DEFAULT_IMAGE;
+    if (strcmp(ImagePath, "--ram") == 0)
+    {
+        RamDisk = malloc((size_t)BENCH_DISK_SECTORS * DISK_RAM_SECTOR_SIZE);
+        DiskResult = (RamDisk == NULL) ? RES_ERROR : disk_ram_attach(0, RamDisk, BENCH_DISK_SECTORS);
+    }
+    else
+    {
+        DiskResult = disk_file_attach(0, ImagePath, 1, BENCH_DISK_SECTORS);
+    }
+    if (DiskResult != RES_OK)
+    {
+        fprintf(stderr, "cannot attach %s\n", ImagePath);
+        return(2);
+    }
+
+    if (!bench_CacheReinit())
+    {
+        printf("FAIL: disk_initialize dropped a dirty write-back sector\n");
+        return(1);
+    }
+
+    // STEP 2: Put the reference WAV on the medium
+    const char *ReferenceName = strrchr(argv[1], '/');
+    ReferenceName = (ReferenceName == NULL) ? argv[1] : (ReferenceName + 1);
+    FRESULT FileResult = bench_PrepareMedium(argv[1], ReferenceName, &ReferenceHash);
+    if (FileResult != FR_OK)
+    {
+        fprintf(stderr, "prepare medium failed: FRESULT %d\n", FileResult);
+        return(2);
+    }
+
+    // STEP 3: Mount and locate the WAV as the application does
+    memset(&AudioFile, 0x00, sizeof(AudioFile));
+    FileResult = f_mount(&FatFs, ROOT_PATH, 1);
+    if (FileResult == FR_OK)
+        FileResult = countFilesInDirectory(AUDIO_DIRECTORY, &FileCount);
+    if (FileResult == FR_OK)
+        FileResult = getNextWavFile(AUDIO_DIRECTORY, AudioFile.Name, AudioFile.PathFileName, &AudioFile.Size, FileCount);
+    if (FileResult != FR_OK)
+    {
+        fprintf(stderr, "WAV not found on medium: FRESULT %d\n", FileResult);
+        return(1);
+    }
+    // A rejected header fails the run - the PCM16 path would not be exercised
+    AudioFile.IsOpen = getWavFileHeader(AudioFile.PathFileName, AudioFile.Size, &AudioFile.Header);
+
+    // STEP 4: Timed ingest passes
+    double WallStart, CpuStart, WallEnd, CpuEnd;
+    disk_cache_reset_stats();
+    bench_Now(&WallStart, &CpuStart);
+    for (uint32_t Pass = 0; Pass < BENCH_PASSES; Pass++)
+    {
+        FileResult = bench_IngestFile(&AudioFile, &FileHash, &SampleCount);
+        if ((FileResult != FR_OK) || (FileHash != ReferenceHash))
+            break;
+    }
+    bench_Now(&WallEnd, &CpuEnd);
+    f_mount(NULL, ROOT_PATH, 0);
+    disk_file_detach(0);
+    free(RamDisk);
+
+    // STEP 5: Report
+    double MegaBytes = ((double)AudioFile.Size * BENCH_PASSES) / (1024.0 * 1024.0);
+    printf("backend   : %s (%s)\n", disk_backend(0)->Name, ImagePath);
+    printf("file      : %s, %lu bytes, header %s", AudioFile.PathFileName, (unsigned long)AudioFile.Size, AudioFile.IsOpen ? "valid" : "rejected");
+    if (AudioFile.IsOpen)
+        printf(" (%u ch, %lu Hz, %u bit)", AudioFile.Header.ChannelNumber, (unsigned long)AudioFile.Header.SampleRate, AudioFile.Header.BitsPerSample);
+    printf("\nthroughput: %.1f MB/s over %u passes\n", MegaBytes / (WallEnd - WallStart), BENCH_PASSES);
+    printf("cpu       : %.3f ms/MB\n", ((CpuEnd - CpuStart) * 1000.0) / MegaBytes);
+#if DISK_CACHE_ENABLE
+    DiskCacheStats Stats;
+    disk_cache_get_stats(&Stats);
+    printf("cache     : %lu hits, %lu misses, %lu bypass\n", (unsigned long)Stats.Hits, (unsigned long)Stats.Misses, (unsigned long)Stats.Bypass);
+#endif
+    if ((FileResult != FR_OK) || (FileHash != ReferenceHash))
+    {
+        printf("FAIL: read back %s (hash %08lX expected %08lX)\n", (FileResult != FR_OK) ? "error" : "mismatch", (unsigned long)FileHash, (unsigned long)ReferenceHash);
+        return(1);
+    }
+    if (!AudioFile.IsOpen)
+    {
+        printf("FAIL: WAV header rejected - a 16 bit PCM file is required (storage_bench --fixture)\n");
+        return(1);
+    }
+    printf("pcm16     : %lu samples per pass through the circular buffer\n", (unsigned long)SampleCount);
+    if (SampleCount != (AudioFile.Size / 2))
+    {
+        printf("FAIL: PCM16 path saw %lu of %lu samples\n", (unsigned long)SampleCount, (unsigned long)(AudioFile.Size / 2));
+        return(1);
+    }
+    printf("PASS\n");
+    return(0);
+
+} // END OF main
@@ -24,25 +24,44 @@
  * The IMR_ADC_7476A IP implements a dual-channel interface to the AD7476A SPI ADC, supporting two modes:
  * 1. Single conversion mode – performs one 16-bit ADC conversion for each channel (A and B)
  * 2. Multi conversion mode – performs a fixed number of conversions and returns the sampled values.
- * In both modes, sampling is synchronized to an internally generated SCLK derived from the AXI clock via a divider.
+ * A third, free running mode streams without a count limit: samples go through the sample FIFO into a RAM
+ * ring the driver fills from the IP ISR, and each filled half is handed to the application while the other
+ * half fills - no stop / restart between frames.
+ * In all modes, sampling is synchronized to an internally generated SCLK derived from the AXI clock via a divider.
  * Data is returned MSB-first via shift registers, and results are latched at the end of each frame.  See IP HDL notes for more information
  *
  * The ADC IP includes:
  *  - Control register (start, mode, clock divider)
+ *  - Sample period register - conversion starts paced to an exact SysClk count, so Fs (and the FFT bin spacing)
+ *    is chosen rather than set by the clock divider and the FSM overhead
  *  - Status register (busy, ready, debug)
  *  - Data A register (16-bit results per channel)
  *  - Data B register (16-bit results per channel)
- *  - IRQ register (enable/clear)
+ *  - IRQ register (enable/clear, auto acknowledge) - the clear bit self-clears so one write acknowledges
+ *  - Data AB register - both channels and a sequence number in one word.  With auto acknowledge the read
+ *    also clears the IRQ, so a conversion costs the ISR one AXI read rather than two reads and two writes
+ *  - Sample FIFO (control, count / flags, read port) - 1024 samples of both channels in block RAM.  With the
+ *    FIFO enabled the IP interrupts at a fill threshold (or on overflow, or when a capture ends below it)
+ *    instead of once per conversion, and the ISR burst drains every sample waiting
+ *  - DMA writer (AXI4 master) - with DMA enabled the IP burst writes the FIFO into a RAM ring in DDR itself and
+ *    publishes a producer offset; the CPU does no per sample work and only takes block / done interrupts
+ *  - CIC decimator - continuous captures may be low pass filtered and decimated by R in the IP (order 1 to 4,
+ *    R 1 to 256), so the CPU sees 16 bit samples at Fs / R.  IMR_ADC_7476A_X2_CicCompensate flattens the
+ *    CIC passband droop in software
+ *  - Completion - the IP raises STATUS DONE when a capture ends (optionally an interrupt of its own) and the ISR
+ *    posts an event to a small queue in the handle; the main loop takes it with IMR_ADC_7476A_X2_GetEvent
  *
  * @copyright       IMR Engineering, LLC
  ********************************************************************************************************/
 
  #include "AXI_IMR_ADC_7476A_DUAL.h"
  #include "xil_io.h"
- #include "xgpio.h"
+ #include "xil_cache.h"
+ #include "diskio_timing.h"
  #include <math.h>
 
- extern XGpio AXI_GPIO_Handle;
+static void adcPostEvent(Type_AXI_IMR_7476A_Handle *IP_Handle, Type_ADC_EventType Type, uint32_t Samples);
+static bool adcWaitIdle(Type_AXI_IMR_7476A_Handle *IP_Handle, uint32_t StartTicks);
 
 /********************************************************************************************************
 * @brief Init of the custom IMR ADC Dual ADC7476A IP Block for use.  
@@ -54,18 +73,18 @@
 * 
 * @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
 * @param IP_BaseAddress: Base address of the IMR ADC Dual ADC7476A IP
-* @param ClockDivider: Clock divider value to generate SCLK for the ADCs
+* @param ClockDivider: Clock divider value to generate SCLK for the ADCs (| IMR_ADC_CLKDIV_ODD for the odd period, 3 | ODD = 20MHz)
 *
-* @return True if init OK
+* @return True if init OK - false for a divider below IMR_ADC_MIN_CLOCK_DIVIDER (SCLK above 20MHz)
 *
 * STEP 1: Load IP Handle members
-* STEP 2: In all modes IRQ must be enabled
-* STEP 3: Load the ADC Clock divider will be the same in all modes
-* STEP 4: Clear GPIO output signals - This is the poor man's DMA signals
+* STEP 2: In all modes IRQ must be enabled - a DATA_AB read acknowledges it
+* STEP 3: Load the ADC Clock divider will be the same in all modes - unpaced, or at the rated period if faster
+* STEP 4: Empty the completion event queue
 ********************************************************************************************************/
  bool init_IMR_ADC_7476A_X2(Type_AXI_IMR_7476A_Handle *IP_Handle, uint32_t IP_BaseAddress, uint8_t ClockDivider)
  {
-     if (IP_Handle ==  NULL)
+     if ((IP_Handle ==  NULL) || ((ClockDivider & 0x0F) < IMR_ADC_MIN_CLOCK_DIVIDER))
         return(false);
 
      // STEP 1: Load IP Handle members
@@ -74,17 +93,38 @@
      IP_Handle->ClockDivider = (uint32_t)ClockDivider;
      IP_Handle->ADC_Data_A = 0x00;
      IP_Handle->ADC_Data_B = 0x00;
+     IP_Handle->FifoEnabled = false;
+     IP_Handle->FifoThreshold = 0;
+     IP_Handle->FifoOverflowCount = 0;
+     IP_Handle->Sequence = 0;
+     IP_Handle->SequenceErrorCount = 0;
+     IP_Handle->Streaming = false;
+     IP_Handle->DmaEnabled = false;
+     IP_Handle->Triggering = false;
+     IP_Handle->TriggerControl = 0;
+     IP_Handle->TriggerRecordReady = false;
+     IP_Handle->SamplePeriod = IMR_ADC_UNPACED_PERIOD(ClockDivider);
+     IP_Handle->SampleRate = (IP_Handle->SamplePeriod == 0) ? 0 : IMR_ADC_MAX_SAMPLE_RATE;
+     IP_Handle->CicEnabled = false;
+     IP_Handle->CicOrder = 1;
+     IP_Handle->CicRatio = 1;
+     IP_Handle->CicShift = 0;
 
-     // STEP 2: In all modes IRQ must be enabled
-     Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK);
+     // STEP 2: In all modes IRQ must be enabled - a DATA_AB read acknowledges it
+     Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_AUTO_ACK_MASK);
 
-     // STEP 3: Load the ADC Clock divider will be the same in all modes
-     IP_Handle->ControlRegister = IP_Handle->ClockDivider;
-     IP_Handle->ControlRegister = IP_Handle->ControlRegister << CTRL_CLKDIV_LSB;
+     // STEP 3: Load the ADC Clock divider will be the same in all modes - conversions back to back until a rate is set,
+     // but never above the AD7476A rating: 3 | ODD frames run 1.163 MSPS, so those are paced at 1 MSPS
+     Xil_Out32(IP_Handle->ADC_BaseAddress + REG_SAMPLE_PERIOD_OFFSET, IP_Handle->SamplePeriod);
+     Xil_Out32(IP_Handle->ADC_BaseAddress + REG_TRIG_CTRL_OFFSET, 0x00);
+     Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CIC_CTRL_OFFSET, 0x00);
+     IP_Handle->ControlRegister = CTRL_CLKDIV_FIELD(IP_Handle->ClockDivider);
      Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
 
-     // STEP 4: Clear GPIO output signals - This is the poor man's DMA signals
-     XGpio_DiscreteClear(&AXI_GPIO_Handle, 2, 0x20);
+     // STEP 4: Empty the completion event queue
+     IP_Handle->EventHead = 0;
+     IP_Handle->EventTail = 0;
+     IP_Handle->EventDropCount = 0;
 
      return(true);   
 
@@ -92,10 +132,61 @@
 
 
 
+/********************************************************************************************************
+* @brief Sets the ADC sample rate.  Conversion starts are paced by the IP sample period timer to a whole number
+* of SysClk cycles, so the rate achieved is IMR_ADC_SYSCLK_HZ / Period - the nearest to the rate requested.
+* Spectra then use the achieved rate for exact bin spacing (Fs / FFT_SIZE).
+*
+* @author original: Hab Collector \n
+*
+* @note: IP must be initialized before use - applies to the next capture in every mode
+* @note: The period cannot be shorter than one conversion frame at the clock divider in use
+*        (IMR_ADC_MIN_SAMPLE_PERIOD) nor the AD7476A rating (IMR_ADC_MAX_SAMPLE_RATE) - a higher rate is refused.  With the FIFO disabled each conversion also
+*        waits for the ISR, so a rate near the limit may overrun: check STATUS_OVERRUN_MASK
+* @note: Unpaced at 3 | IMR_ADC_CLKDIV_ODD would exceed the rating - the period is held at IMR_ADC_RATED_SAMPLE_PERIOD
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+* @param RequestedRate: Sample rate in Hz, 0 = unpaced (conversions back to back as before, IMR_ADC_UNPACED_PERIOD)
+* @param AchievedRate: Returns the rate the IP will run at in Hz (may be NULL)
+*
+* @return True if the rate is set
+*
+* STEP 1: Test for valid handle
+* STEP 2: Nearest whole period - in range for the divider and the 24 bit register
+* STEP 3: Load the IP sample period register and report the achieved rate
+********************************************************************************************************/
+bool IMR_ADC_7476A_X2_SetSampleRate(Type_AXI_IMR_7476A_Handle *IP_Handle, uint32_t RequestedRate, uint32_t *AchievedRate)
+{
+    // STEP 1: Test for valid handle
+    if (IP_Handle ==  NULL)
+        return(false);
+
+    // STEP 2: Nearest whole period - in range for the divider and the 24 bit register
+    uint32_t Period = IMR_ADC_UNPACED_PERIOD(IP_Handle->ClockDivider);
+    if (RequestedRate != 0)
+    {
+        Period = (IMR_ADC_SYSCLK_HZ + (RequestedRate / 2)) / RequestedRate;
+        if ((RequestedRate > IMR_ADC_MAX_SAMPLE_RATE) || (Period < IMR_ADC_MIN_SAMPLE_PERIOD(IP_Handle->ClockDivider)) || (Period > SAMPLE_PERIOD_MAX))
+            return(false);
+    }
+
+    // STEP 3: Load the IP sample period register and report the achieved rate
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_SAMPLE_PERIOD_OFFSET, Period);
+    IP_Handle->SamplePeriod = Period;
+    IP_Handle->SampleRate = (Period == 0) ? 0 : ((IMR_ADC_SYSCLK_HZ + (Period / 2)) / Period);
+    if (AchievedRate != NULL)
+        *AchievedRate = IP_Handle->SampleRate;
+
+    return(true);
+
+} // END IMR_ADC_7476A_X2_SetSampleRate
+
+
+
 /********************************************************************************************************
 * @brief The IP functions in one of two modes: Single conversion or Multi conversion.  This function starts a 
-* single conversion.  Note upon completion of the conversion an IRQ will be generated and the ISR associated
-* with the "Poor Man's DMA" will be called.
+* single conversion.  Note upon completion of the conversion an IRQ will be generated and the ISR posts an
+* ADC_EVENT_CAPTURE_DONE event for the main loop (IMR_ADC_7476A_X2_GetEvent).
 *
 * @author original: Hab Collector \n
 *
@@ -111,7 +202,8 @@
 *
 * STEP 1: Test for valid handle
 * STEP 2: Set data pointers
-* STEP 3: Load IP config register for single conversion
+* STEP 3: With the FIFO the end of the capture interrupts too (STATUS DONE)
+* STEP 4: Load IP config register for single conversion
 ********************************************************************************************************/
 bool IMR_ADC_7476A_X2_SingleConvert(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_t *BufferData_A, uint16_t *BufferData_B) 
 {
@@ -122,11 +214,16 @@ bool IMR_ADC_7476A_X2_SingleConvert(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16
     // STEP 2: Set data pointers
     IP_Handle->ADC_Data_A = BufferData_A;
     IP_Handle->ADC_Data_B = BufferData_B;
+    IP_Handle->TotalConversions = 1;
+    IP_Handle->ConversionCount = 0;
 
-    // STEP 3: Load IP config register for single conversion
+    // STEP 3: With the FIFO the end of the capture interrupts too (STATUS DONE)
+    if (IP_Handle->FifoEnabled)
+        Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_AUTO_ACK_MASK | IRQ_DONE_EN_MASK);
+
+    // STEP 4: Load IP config register for single conversion
     IP_Handle->ControlRegister = 0x00;
-    uint32_t ClockDividerOffset = IP_Handle->ClockDivider;
-    ClockDividerOffset = ClockDividerOffset << CTRL_CLKDIV_LSB;
+    uint32_t ClockDividerOffset = CTRL_CLKDIV_FIELD(IP_Handle->ClockDivider);
     IP_Handle->ControlRegister = ClockDividerOffset | CTRL_EN_BIT_MASK | CTRL_START_BIT_MASK;
     Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
 
@@ -138,14 +235,15 @@ bool IMR_ADC_7476A_X2_SingleConvert(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16
 
 /********************************************************************************************************
 * @brief The IP functions in one of two modes: Single conversion or Multi conversion.  This function starts a 
-* multi conversion.  Note upon completion of the conversion an IRQ will be generated and the ISR associated
-* with the "Poor Man's DMA" will be called.
+* multi conversion.  Note upon completion of the conversion an IRQ will be generated and the ISR posts an
+* ADC_EVENT_CAPTURE_DONE event for the main loop (IMR_ADC_7476A_X2_GetEvent).
 *
 * @author original: Hab Collector \n
 *
 * @note: IP must be initialized before use
 * @note: See IP HDL notes for more information on the IP operation
 * @note: Buffer memory must be allocated by the caller
+* @note: Limited to 4095 conversions by the CTRL count field - use IMR_ADC_7476A_X2_StartStream for more
 * 
 * @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
 * @param BufferData_A: Base address to store ADC channel A data
@@ -156,7 +254,8 @@ bool IMR_ADC_7476A_X2_SingleConvert(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16
 *
 * STEP 1: Test for valid handle
 * STEP 2: Set data pointers and handle members for multi conversion
-* STEP 3: Load IP config register for muti conversions: Total Conversions, Clock Divider, Multi Bit, Start Bit and Enable Bit
+* STEP 3: With the FIFO the end of the capture interrupts too (STATUS DONE) - a capture that overflowed ends short
+* STEP 4: Load IP config register for muti conversions: Total Conversions, Clock Divider, Multi Bit, Start Bit and Enable Bit
 ********************************************************************************************************/
 bool IMR_ADC_7476A_X2_MultiConvert(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_t *BufferData_A, uint16_t *BufferData_B, uint32_t TotalConversions) 
 {
@@ -174,12 +273,15 @@ bool IMR_ADC_7476A_X2_MultiConvert(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_
     IP_Handle->TotalConversions = TotalConversions;
     IP_Handle->ConversionCount = 0;
 
-    // STEP 3: Load IP config register for muti conversions: Total Conversions, Clock Divider, Multi Bit, Start Bit and Enable Bit
+    // STEP 3: With the FIFO the end of the capture interrupts too (STATUS DONE) - a capture that overflowed ends short
+    if (IP_Handle->FifoEnabled)
+        Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_AUTO_ACK_MASK | IRQ_DONE_EN_MASK);
+
+    // STEP 4: Load IP config register for muti conversions: Total Conversions, Clock Divider, Multi Bit, Start Bit and Enable Bit
     IP_Handle->ControlRegister = 0x00;
     uint32_t TotalConversionsOffset = IP_Handle->TotalConversions;
     TotalConversionsOffset = TotalConversionsOffset << CTRL_CONT_CNT_LSB;
-    uint32_t ClockDividerOffset = IP_Handle->ClockDivider;
-    ClockDividerOffset = ClockDividerOffset << CTRL_CLKDIV_LSB;
+    uint32_t ClockDividerOffset = CTRL_CLKDIV_FIELD(IP_Handle->ClockDivider);
     IP_Handle->ControlRegister = IP_Handle->ControlRegister | TotalConversionsOffset | ClockDividerOffset | CTRL_MULTI_BIT_MASK | CTRL_START_BIT_MASK | CTRL_EN_BIT_MASK;
     Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
 
@@ -191,59 +293,1051 @@ bool IMR_ADC_7476A_X2_MultiConvert(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_
 
 /********************************************************************************************************
 * @brief The IP functions in one of two modes: Single conversion or Multi conversion.  This is the IRQ clear
-* function called by the ADC IP IRQ ISR.  It handles both modes of conversion (single and multi).  It is NOT 
-* the "Poor Man's DMA" ISR.  This clear function triggers the "Poor Man's DMA" ISR (when all conversions are
-* completed), which in turns signals to the application to process the ADC data.
+* function called by the ADC IP IRQ ISR.  It handles both modes of conversion (single and multi).  When all
+* conversions are completed it posts an event to the handle queue, which the application takes with
+* IMR_ADC_7476A_X2_GetEvent to process the ADC data - no second interrupt.
 *
 * @author original: Hab Collector \n
 *
 * @note: IP must be initialized before use
 * @note: See IP HDL notes for more information on the IP operation
 * 
+* @note: With the FIFO enabled both modes take the FIFO path - one interrupt per threshold worth of samples, and
+*        one on STATUS DONE when the capture ends so a short (overflowed) capture still completes
+* @note: An armed trigger interrupts once, with the complete record in the FIFO
+* @note: Otherwise one DATA_AB read per conversion fetches both channels and acknowledges the IRQ (auto ack)
+* 
 * @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
 *
-* STEP 1: Service Multiple Conversions Interrupt
-* STEP 2: Service Single Conversions Interrupt
+* STEP 1: Service DMA Interrupt
+* STEP 2: Service Triggered Record Interrupt
+* STEP 3: Service Free Running Stream Interrupt
+* STEP 4: Service FIFO Interrupt
+* STEP 5: Service Multiple Conversions Interrupt
+* STEP 6: Service Single Conversions Interrupt
 ********************************************************************************************************/
 void IMR_ADC_7476A_X2_ClrIrq(Type_AXI_IMR_7476A_Handle *IP_Handle)
 {
-    // STEP 1: Service Multiple Conversions Interrupt
-    if (IP_Handle->ControlRegister & CTRL_MULTI_BIT_MASK)
+    // STEP 1: Service DMA Interrupt
+    if (IP_Handle->DmaEnabled)
     {
-        IP_Handle->ADC_Data_A[IP_Handle->ConversionCount] = (uint16_t)IMR_ADC_7476A_X2_GetDataAReg(IP_Handle);
-        IP_Handle->ADC_Data_B[IP_Handle->ConversionCount] = (uint16_t)IMR_ADC_7476A_X2_GetDataBReg(IP_Handle);
+        // No samples to move - count the events and acknowledge.  Re-read after the clear: an event landing in
+        // the same clock keeps IRQ high and the edge triggered INTC would not see it again
+        uint32_t FifoStatus = IMR_ADC_7476A_X2_GetFifoStatusReg(IP_Handle);
+        while (FifoStatus & FIFO_STATUS_DMA_EVENT_MASK)
+        {
+            if (FifoStatus & FIFO_STATUS_DMA_BLOCK_MASK)
+                IP_Handle->DmaBlockCount++;
+            if (FifoStatus & FIFO_STATUS_DMA_ERR_MASK)
+                IP_Handle->DmaErrorCount++;
+            if (FifoStatus & FIFO_STATUS_OVF_MASK)
+                IP_Handle->FifoOverflowCount++;
+            Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_AUTO_ACK_MASK | IRQ_CLR_MASK);
+            if (FifoStatus & FIFO_STATUS_DMA_DONE_MASK)
+                adcPostEvent(IP_Handle, ADC_EVENT_DMA_DONE, IP_Handle->DmaBlockCount);
+            FifoStatus = IMR_ADC_7476A_X2_GetFifoStatusReg(IP_Handle);
+        }
+    }
+    // STEP 2: Service Triggered Record Interrupt
+    else if (IP_Handle->Triggering)
+    {
+        // The engine has stopped and nothing more is stored - drain the whole record, then acknowledge
+        uint32_t FifoStatus = IMR_ADC_7476A_X2_GetFifoStatusReg(IP_Handle);
+        if (FifoStatus & FIFO_STATUS_OVF_MASK)
+            IP_Handle->FifoOverflowCount++;
+        if (FifoStatus & FIFO_STATUS_TRIG_MASK)
+        {
+            IP_Handle->TriggerIndex = (IMR_ADC_7476A_X2_GetTriggerStatusReg(IP_Handle) & TRIG_STATUS_INDEX_MASK) >> TRIG_STATUS_INDEX_LSB;
+            IP_Handle->ConversionCount = IMR_ADC_7476A_X2_DrainFifo(IP_Handle, IP_Handle->ADC_Data_A, IP_Handle->ADC_Data_B, IP_Handle->TotalConversions);
+        }
+        Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_AUTO_ACK_MASK | IRQ_CLR_MASK);
+
+        if (FifoStatus & FIFO_STATUS_TRIG_MASK)
+        {
+            IP_Handle->ControlRegister = 0x00; 
+            Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
+            IP_Handle->TriggerRecordReady = true;
+            adcPostEvent(IP_Handle, ADC_EVENT_TRIGGER_RECORD, IP_Handle->ConversionCount);
+        }
+    }
+    // STEP 3: Service Free Running Stream Interrupt
+    else if (IP_Handle->Streaming)
+    {
+        // Drain up to the end of the half being filled so every half boundary is seen, until the FIFO is empty
+        uint32_t HalfSize = IP_Handle->RingSize / IMR_ADC_RING_HALVES;
+        uint32_t Requested;
+        uint32_t Drained;
+        do
+        {
+            uint32_t HalfEnd = (IP_Handle->RingWriteIndex < HalfSize) ? HalfSize : IP_Handle->RingSize;
+            Requested = HalfEnd - IP_Handle->RingWriteIndex;
+            Drained = IMR_ADC_7476A_X2_DrainFifo(IP_Handle, &IP_Handle->Ring_A[IP_Handle->RingWriteIndex], &IP_Handle->Ring_B[IP_Handle->RingWriteIndex], Requested);
+            IP_Handle->RingWriteIndex += Drained;
+            if (IP_Handle->RingWriteIndex == HalfEnd)
+            {
+                uint8_t Half = (HalfEnd == HalfSize) ? 0 : 1;
+                if (IP_Handle->RingHalfReady[Half])
+                    IP_Handle->RingOverrunCount++;
+                IP_Handle->RingHalfReady[Half] = true;
+                if (IP_Handle->RingWriteIndex == IP_Handle->RingSize)
+                    IP_Handle->RingWriteIndex = 0;
+            }
+        } while (Drained == Requested);
+
+        if (IMR_ADC_7476A_X2_GetFifoStatusReg(IP_Handle) & FIFO_STATUS_OVF_MASK)
+        {
+            IP_Handle->FifoOverflowCount++;
+            Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_AUTO_ACK_MASK | IRQ_CLR_MASK);
+        }
+    }
+    // STEP 4: Service FIFO Interrupt
+    else if (IP_Handle->FifoEnabled)
+    {
+        // DONE is read before the drain: once set every sample of the capture is already in the FIFO
+        uint32_t Status = IMR_ADC_7476A_X2_GetStatusReg(IP_Handle);
+        uint32_t MaxSamples = IP_Handle->TotalConversions - IP_Handle->ConversionCount;
+        IP_Handle->ConversionCount += IMR_ADC_7476A_X2_DrainFifo(IP_Handle, &IP_Handle->ADC_Data_A[IP_Handle->ConversionCount], &IP_Handle->ADC_Data_B[IP_Handle->ConversionCount], MaxSamples);
+
+        // Overflow: samples were dropped so the count will fall short - the capture ends on STATUS DONE
+        bool CaptureComplete = (IP_Handle->ConversionCount >= IP_Handle->TotalConversions) || (Status & STATUS_DONE_MASK);
+        if (IMR_ADC_7476A_X2_GetFifoStatusReg(IP_Handle) & FIFO_STATUS_OVF_MASK)
+        {
+            IP_Handle->FifoOverflowCount++;
+            Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_AUTO_ACK_MASK | IRQ_DONE_EN_MASK | IRQ_CLR_MASK);
+            // The clear takes DONE with it - a capture that ended meanwhile shows as BUSY low
+            if (!(IMR_ADC_7476A_X2_GetStatusReg(IP_Handle) & STATUS_BUSY_MASK))
+                CaptureComplete = true;
+        }
+
+        // Only once per capture - an interrupt still pending after the stop finds START low
+        if (CaptureComplete && (IP_Handle->ControlRegister & CTRL_START_BIT_MASK))
+        {
+            IP_Handle->ControlRegister = 0x00; 
+            Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
+            Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_AUTO_ACK_MASK | IRQ_CLR_MASK);
+            adcPostEvent(IP_Handle, ADC_EVENT_CAPTURE_DONE, IP_Handle->ConversionCount);
+        }
+    }
+    // STEP 5: Service Multiple Conversions Interrupt
+    else if (IP_Handle->ControlRegister & CTRL_MULTI_BIT_MASK)
+    {
+        // One read: both channels, and the IRQ is acknowledged - the next conversion is already free to start
+        uint32_t DataAB = IMR_ADC_7476A_X2_GetDataABReg(IP_Handle);
+        if (IP_Handle->CicEnabled)
+        {
+            // Decimated: 16 bits per channel, no room for the sequence number
+            IP_Handle->ADC_Data_A[IP_Handle->ConversionCount] = CIC_WORD_A(DataAB);
+            IP_Handle->ADC_Data_B[IP_Handle->ConversionCount] = CIC_WORD_B(DataAB);
+        }
+        else
+        {
+            uint8_t Sequence = (uint8_t)(DataAB >> DATA_AB_SEQ_LSB);
+            if ((IP_Handle->ConversionCount != 0) && (Sequence != (uint8_t)(IP_Handle->Sequence + 1)))
+                IP_Handle->SequenceErrorCount++;
+            IP_Handle->Sequence = Sequence;
+            IP_Handle->ADC_Data_A[IP_Handle->ConversionCount] = (uint16_t)((DataAB >> DATA_AB_A_LSB) & DATA_AB_SAMPLE_MASK);
+            IP_Handle->ADC_Data_B[IP_Handle->ConversionCount] = (uint16_t)((DataAB >> DATA_AB_B_LSB) & DATA_AB_SAMPLE_MASK);
+        }
 
         if (IP_Handle->ConversionCount >= IP_Handle->TotalConversions - 1)
         {
             IP_Handle->ControlRegister = 0x00; 
             Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
-            Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_CLR_MASK);
-            Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK);
-            XGpio_DiscreteSet(&AXI_GPIO_Handle, 2, 0x20);
+            adcPostEvent(IP_Handle, ADC_EVENT_CAPTURE_DONE, IP_Handle->TotalConversions);
         }
         else
         {
             IP_Handle->ConversionCount = IP_Handle->ConversionCount + 1;
-            Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_CLR_MASK);
-            Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK);
         }
     }
-    // STEP 2: Service Single Conversion Interrupt
+    // STEP 6: Service Single Conversion Interrupt
     else
     {
+        uint32_t DataAB = IMR_ADC_7476A_X2_GetDataABReg(IP_Handle);
+        IP_Handle->Sequence = (uint8_t)(DataAB >> DATA_AB_SEQ_LSB);
         IP_Handle->ControlRegister = 0x00; 
         Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
-        Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_CLR_MASK);
-        Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK);
-        *IP_Handle->ADC_Data_A = (uint16_t)IMR_ADC_7476A_X2_GetDataAReg(IP_Handle);
-        *IP_Handle->ADC_Data_B = (uint16_t)IMR_ADC_7476A_X2_GetDataBReg(IP_Handle);
-        XGpio_DiscreteSet(&AXI_GPIO_Handle, 2, 0x20);
+        *IP_Handle->ADC_Data_A = (uint16_t)((DataAB >> DATA_AB_A_LSB) & DATA_AB_SAMPLE_MASK);
+        *IP_Handle->ADC_Data_B = (uint16_t)((DataAB >> DATA_AB_B_LSB) & DATA_AB_SAMPLE_MASK);
+        adcPostEvent(IP_Handle, ADC_EVENT_CAPTURE_DONE, 1);
     }
 
 } // END IMR_ADC_7476A_X2_ClrIrq
 
 
 
+/********************************************************************************************************
+* @brief Takes the oldest completion event posted by the ADC ISR.  The main loop polls this in place of a flag
+* set by a second interrupt - the ISR that finished the capture posts the event itself.
+*
+* @author original: Hab Collector \n
+*
+* @note: Only this function moves EventTail and only the ISR moves EventHead - no critical section needed
+* @note: Events posted to a full queue are dropped and counted in EventDropCount
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+* @param Event: Returns the event type and the sample count it covers
+*
+* @return True if an event was waiting
+********************************************************************************************************/
+bool IMR_ADC_7476A_X2_GetEvent(Type_AXI_IMR_7476A_Handle *IP_Handle, Type_ADC_Event *Event)
+{
+    uint8_t Tail = IP_Handle->EventTail;
+    if (Tail == IP_Handle->EventHead)
+        return(false);
+
+    *Event = IP_Handle->EventQueue[Tail];
+    IP_Handle->EventTail = (Tail + 1) & (IMR_ADC_EVENT_QUEUE_SIZE - 1);
+    return(true);
+
+} // END IMR_ADC_7476A_X2_GetEvent
+
+
+
+/********************************************************************************************************
+* @brief Posts a completion event for the main loop - called from the ADC ISR only
+*
+* @author original: Hab Collector \n
+*
+* @note: One slot is kept empty so a full queue is told from an empty one
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+* @param Type: What completed
+* @param Samples: Samples per channel the event covers
+********************************************************************************************************/
+static void adcPostEvent(Type_AXI_IMR_7476A_Handle *IP_Handle, Type_ADC_EventType Type, uint32_t Samples)
+{
+    uint8_t Head = IP_Handle->EventHead;
+    uint8_t NextHead = (Head + 1) & (IMR_ADC_EVENT_QUEUE_SIZE - 1);
+    if (NextHead == IP_Handle->EventTail)
+    {
+        IP_Handle->EventDropCount++;
+        return;
+    }
+
+    IP_Handle->EventQueue[Head].Type = Type;
+    IP_Handle->EventQueue[Head].Samples = Samples;
+    IP_Handle->EventHead = NextHead;
+
+} // END adcPostEvent
+
+
+
+/********************************************************************************************************
+* @brief Routes conversions through the IP sample FIFO.  The IP then interrupts when Threshold samples are
+* waiting, when a sample is dropped to a full FIFO, or when a capture ends with fewer than Threshold left -
+* rather than after every conversion.  Single and Multi convert are used as before.
+*
+* @author original: Hab Collector \n
+*
+* @note: IP must be initialized before use
+* @note: The FIFO is flushed - any samples waiting are discarded
+* @note: The IP interrupt is edge triggered at the INTC: the IP drops IRQ only once the FIFO is drained below
+*        Threshold, so the ISR must drain until empty (IMR_ADC_7476A_X2_DrainFifo does)
+* @note: The DONE interrupt is left off here - Single and Multi convert turn it on for their capture
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+* @param Threshold: IRQ fill level 1 to IMR_ADC_FIFO_DEPTH samples
+*
+* @return True if FIFO enabled
+*
+* STEP 1: Test for valid handle and threshold
+* STEP 2: Flush then enable with the threshold
+* STEP 3: Threshold interrupts only - clear any DONE left from an earlier capture
+********************************************************************************************************/
+bool IMR_ADC_7476A_X2_EnableFifo(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_t Threshold)
+{
+    // STEP 1: Test for valid handle and threshold
+    if (IP_Handle ==  NULL)
+        return(false);
+    if ((Threshold == 0) || (Threshold > IMR_ADC_FIFO_DEPTH))
+        return(false);
+
+    // STEP 2: Flush then enable with the threshold
+    uint32_t FifoControl = FIFO_CTRL_EN_MASK | (((uint32_t)Threshold << FIFO_CTRL_THRESH_LSB) & FIFO_CTRL_THRESH_MASK);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_FIFO_CTRL_OFFSET, FifoControl | FIFO_CTRL_FLUSH_MASK);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_FIFO_CTRL_OFFSET, FifoControl);
+    IP_Handle->FifoEnabled = true;
+    IP_Handle->FifoThreshold = Threshold;
+    IP_Handle->FifoOverflowCount = 0;
+
+    // STEP 3: Threshold interrupts only - clear any DONE left from an earlier capture
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_AUTO_ACK_MASK | IRQ_CLR_MASK);
+
+    return(true);
+
+} // END IMR_ADC_7476A_X2_EnableFifo
+
+
+
+/********************************************************************************************************
+* @brief Returns the IP to one interrupt per conversion through the DATA_A / DATA_B registers
+*
+* @author original: Hab Collector \n
+*
+* @note: Do not call while a conversion is in progress
+* @note: The DONE interrupt goes off with the FIFO - the IRQ enable is left as it is
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+********************************************************************************************************/
+void IMR_ADC_7476A_X2_DisableFifo(Type_AXI_IMR_7476A_Handle *IP_Handle)
+{
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_FIFO_CTRL_OFFSET, FIFO_CTRL_FLUSH_MASK);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_FIFO_CTRL_OFFSET, 0x00);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IMR_ADC_7476A_X2_GetIrqReg(IP_Handle) & ~(IRQ_DONE_EN_MASK | IRQ_CLR_MASK));
+    IP_Handle->FifoEnabled = false;
+
+} // END IMR_ADC_7476A_X2_DisableFifo
+
+
+
+/********************************************************************************************************
+* @brief Burst drain of the IP sample FIFO.  The occupancy is read once and then that many FIFO_DATA reads are
+* issued back to back with no per sample status check; repeated until the FIFO reads empty (samples that
+* landed during the burst) or MaxSamples are stored.
+*
+* @author original: Hab Collector \n
+*
+* @note: Called from the ADC IP ISR (IMR_ADC_7476A_X2_ClrIrq) - may also be polled with the IRQ disabled
+* @note: Each FIFO word holds one conversion of both channels: [23:12] channel A, [11:0] channel B - decimated
+*        (CIC on and a continuous capture) [31:16] channel A, [15:0] channel B
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+* @param BufferData_A: Where to store channel A samples
+* @param BufferData_B: Where to store channel B samples
+* @param MaxSamples: Room in each buffer
+*
+* @return Samples stored
+*
+* STEP 1: Read the occupancy - done when empty or the buffers are full
+* STEP 2: Burst read and unpack
+********************************************************************************************************/
+uint32_t IMR_ADC_7476A_X2_DrainFifo(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_t *BufferData_A, uint16_t *BufferData_B, uint32_t MaxSamples)
+{
+    uint32_t FifoDataAddress = IP_Handle->ADC_BaseAddress + REG_FIFO_DATA_OFFSET;
+    uint32_t Drained = 0;
+    bool Decimated = IP_Handle->CicEnabled && (IP_Handle->ControlRegister & CTRL_MULTI_BIT_MASK);    // Single conversions bypass the CIC
+
+    while (Drained < MaxSamples)
+    {
+        // STEP 1: Read the occupancy - done when empty or the buffers are full
+        uint32_t Count = (IMR_ADC_7476A_X2_GetFifoStatusReg(IP_Handle) & FIFO_STATUS_COUNT_MASK) >> FIFO_STATUS_COUNT_LSB;
+        if (Count == 0)
+            break;
+        if (Count > (MaxSamples - Drained))
+            Count = MaxSamples - Drained;
+
+        // STEP 2: Burst read and unpack
+        for (uint32_t Index = 0; Index < Count; Index++)
+        {
+            uint32_t FifoWord = Xil_In32(FifoDataAddress);
+            BufferData_A[Drained] = Decimated ? CIC_WORD_A(FifoWord) : FIFO_WORD_A(FifoWord);
+            BufferData_B[Drained] = Decimated ? CIC_WORD_B(FifoWord) : FIFO_WORD_B(FifoWord);
+            Drained++;
+        }
+    }
+    return(Drained);
+
+} // END IMR_ADC_7476A_X2_DrainFifo
+
+
+
+/********************************************************************************************************
+* @brief Free running acquisition into a RAM ring with no conversion limit.  The IP converts until stopped; the
+* ISR (IMR_ADC_7476A_X2_ClrIrq) drains the sample FIFO into the ring and marks each half ready as it fills.
+* The application takes ready halves with IMR_ADC_7476A_X2_GetRingHalf while the other half fills, so frames
+* are gap free.
+*
+* @author original: Hab Collector \n
+*
+* @note: IP must be initialized before use
+* @note: Ring memory must be allocated by the caller - RingSize samples per channel, one frame per half
+* @note: No completion event - the application polls IMR_ADC_7476A_X2_GetRingHalf
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+* @param RingData_A: Ring for channel A samples
+* @param RingData_B: Ring for channel B samples
+* @param RingSize: Samples per channel - even, at least 2
+*
+* @return True if streaming started
+*
+* STEP 1: Test for valid handle and ring
+* STEP 2: Reset the ring
+* STEP 3: FIFO threshold no larger than a ring half so each half is reported promptly
+* STEP 4: Load IP config register for free running: Clock Divider, Free Run, Multi Bit, Start Bit and Enable Bit
+********************************************************************************************************/
+bool IMR_ADC_7476A_X2_StartStream(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_t *RingData_A, uint16_t *RingData_B, uint32_t RingSize)
+{
+    // STEP 1: Test for valid handle and ring
+    if (IP_Handle ==  NULL)
+        return(false);
+    if ((RingData_A == NULL) || (RingData_B == NULL) || (RingSize < IMR_ADC_RING_HALVES) || (RingSize % IMR_ADC_RING_HALVES))
+        return(false);
+
+    // STEP 2: Reset the ring
+    IP_Handle->Ring_A = RingData_A;
+    IP_Handle->Ring_B = RingData_B;
+    IP_Handle->RingSize = RingSize;
+    IP_Handle->RingWriteIndex = 0;
+    IP_Handle->RingNextHalf = 0;
+    IP_Handle->RingOverrunCount = 0;
+    for (uint8_t Half = 0; Half < IMR_ADC_RING_HALVES; Half++)
+        IP_Handle->RingHalfReady[Half] = false;
+
+    // STEP 3: FIFO threshold no larger than a ring half so each half is reported promptly
+    uint32_t Threshold = RingSize / IMR_ADC_RING_HALVES;
+    if (Threshold > IMR_ADC_STREAM_FIFO_THRESHOLD)
+        Threshold = IMR_ADC_STREAM_FIFO_THRESHOLD;
+    if (!IMR_ADC_7476A_X2_EnableFifo(IP_Handle, (uint16_t)Threshold))
+        return(false);
+    IP_Handle->Streaming = true;
+
+    // STEP 4: Load IP config register for free running: Clock Divider, Free Run, Multi Bit, Start Bit and Enable Bit
+    uint32_t ClockDividerOffset = CTRL_CLKDIV_FIELD(IP_Handle->ClockDivider);
+    IP_Handle->ControlRegister = ClockDividerOffset | CTRL_EN_BIT_MASK;
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
+    IP_Handle->ControlRegister |= CTRL_FREE_RUN_BIT_MASK | CTRL_MULTI_BIT_MASK | CTRL_START_BIT_MASK;
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
+
+    return(true);
+
+} // END IMR_ADC_7476A_X2_StartStream
+
+
+
+/********************************************************************************************************
+* @brief Stops free running acquisition.  The frame in flight completes, then the FIFO is flushed and disabled.
+*
+* @author original: Hab Collector \n
+*
+* @note: Samples in a partly filled half are discarded; halves already ready stay available until released
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+*
+* @return True if the IP went idle within IMR_ADC_STOP_TIMEOUT_US - the handle leaves stream mode either way
+*
+* STEP 1: Drop START - the IP idles after the current frame
+* STEP 2: Leave stream mode and return the FIFO to off
+********************************************************************************************************/
+bool IMR_ADC_7476A_X2_StopStream(Type_AXI_IMR_7476A_Handle *IP_Handle)
+{
+    // STEP 1: Drop START - the IP idles after the current frame
+    IP_Handle->ControlRegister &= ~(CTRL_FREE_RUN_BIT_MASK | CTRL_MULTI_BIT_MASK | CTRL_START_BIT_MASK);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
+    bool Idle = adcWaitIdle(IP_Handle, disk_time_now());
+
+    // STEP 2: Leave stream mode and return the FIFO to off
+    IP_Handle->Streaming = false;
+    IMR_ADC_7476A_X2_DisableFifo(IP_Handle);
+    return(Idle);
+
+} // END IMR_ADC_7476A_X2_StopStream
+
+
+
+/********************************************************************************************************
+* @brief Hands out the oldest ready ring half.  The half belongs to the caller until
+* IMR_ADC_7476A_X2_ReleaseRingHalf; the ISR keeps filling the other half meanwhile.
+*
+* @author original: Hab Collector \n
+*
+* @note: A half not released before the ISR comes round to it again is overwritten and counted in
+*        RingOverrunCount
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+* @param HalfData_A: Returns the channel A samples of the half (RingSize / 2)
+* @param HalfData_B: Returns the channel B samples of the half
+*
+* @return True if a half is ready
+********************************************************************************************************/
+bool IMR_ADC_7476A_X2_GetRingHalf(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_t **HalfData_A, uint16_t **HalfData_B)
+{
+    if (!IP_Handle->RingHalfReady[IP_Handle->RingNextHalf])
+        return(false);
+
+    uint32_t HalfOffset = IP_Handle->RingNextHalf * (IP_Handle->RingSize / IMR_ADC_RING_HALVES);
+    *HalfData_A = &IP_Handle->Ring_A[HalfOffset];
+    *HalfData_B = &IP_Handle->Ring_B[HalfOffset];
+    return(true);
+
+} // END IMR_ADC_7476A_X2_GetRingHalf
+
+
+
+/********************************************************************************************************
+* @brief Returns the half handed out by IMR_ADC_7476A_X2_GetRingHalf to the ISR
+*
+* @author original: Hab Collector \n
+*
+* @note: Only this function clears a ready flag and only the ISR sets one - no critical section needed
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+********************************************************************************************************/
+void IMR_ADC_7476A_X2_ReleaseRingHalf(Type_AXI_IMR_7476A_Handle *IP_Handle)
+{
+    IP_Handle->RingHalfReady[IP_Handle->RingNextHalf] = false;
+    IP_Handle->RingNextHalf = (IP_Handle->RingNextHalf + 1) % IMR_ADC_RING_HALVES;
+
+} // END IMR_ADC_7476A_X2_ReleaseRingHalf
+
+
+
+/********************************************************************************************************
+* @brief Free running acquisition straight into a RAM ring by the IP DMA writer (AXI4 master to DDR).  The IP
+* converts until stopped, bursts the sample FIFO into the ring and advances its producer offset; the CPU copies
+* nothing.  The application takes samples with IMR_ADC_7476A_X2_GetDmaSamples and hands the space back with
+* IMR_ADC_7476A_X2_ReleaseDmaSamples - the IP stalls rather than overwrite samples not yet released.
+*
+* @author original: Hab Collector \n
+*
+* @note: IP must be initialized before use
+* @note: Ring memory must be allocated by the caller in memory the IP master can reach (DDR) - one uint32_t per
+*        sample, channel A [23:12] channel B [11:0], see FIFO_WORD_A / FIFO_WORD_B (decimating: CIC_WORD_A / CIC_WORD_B)
+* @note: The IP interrupts every BlockBytes written, on a write error and on a FIFO overflow - not per sample
+* @note: Samples are written to memory behind the D-cache - IMR_ADC_7476A_X2_GetDmaSamples invalidates them
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+* @param RingData: The ring - IMR_ADC_DMA_ALIGN byte aligned
+* @param RingBytes: Ring length in bytes - a multiple of IMR_ADC_DMA_ALIGN, at least two bursts
+* @param BlockBytes: Bytes per block interrupt - a multiple of 4 less than RingBytes, 0 for none
+*
+* @return True if DMA capture started
+*
+* STEP 1: Test for valid handle and ring
+* STEP 2: Reset the ring and write back / drop any cached copy of it so no dirty line lands on DMA data later
+* STEP 3: FIFO on with no threshold interrupt - the DMA writer drains it
+* STEP 4: Load the ring descriptor, rewind the producer and enable the DMA writer
+* STEP 5: Load IP config register for free running: Clock Divider, Free Run, Multi Bit, Start Bit and Enable Bit
+********************************************************************************************************/
+bool IMR_ADC_7476A_X2_StartDma(Type_AXI_IMR_7476A_Handle *IP_Handle, uint32_t *RingData, uint32_t RingBytes, uint32_t BlockBytes)
+{
+    // STEP 1: Test for valid handle and ring
+    if (IP_Handle ==  NULL)
+        return(false);
+    if ((RingData == NULL) || ((UINTPTR)RingData % IMR_ADC_DMA_ALIGN) || (RingBytes < (2 * IMR_ADC_DMA_ALIGN)) || (RingBytes % IMR_ADC_DMA_ALIGN))
+        return(false);
+    if ((BlockBytes % sizeof(uint32_t)) || (BlockBytes >= RingBytes))
+        return(false);
+
+    // STEP 2: Reset the ring and write back / drop any cached copy of it so no dirty line lands on DMA data later
+    IP_Handle->DmaRing = RingData;
+    IP_Handle->DmaRingBytes = RingBytes;
+    IP_Handle->DmaConsumer = 0;
+    IP_Handle->DmaBlockCount = 0;
+    IP_Handle->DmaErrorCount = 0;
+    Xil_DCacheFlushRange((UINTPTR)RingData, RingBytes);
+
+    // STEP 3: FIFO on with no threshold interrupt - the DMA writer drains it
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_FIFO_CTRL_OFFSET, FIFO_CTRL_EN_MASK | FIFO_CTRL_FLUSH_MASK);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_FIFO_CTRL_OFFSET, FIFO_CTRL_EN_MASK);
+    IP_Handle->FifoEnabled = true;
+    IP_Handle->FifoThreshold = 0;
+    IP_Handle->FifoOverflowCount = 0;
+
+    // STEP 4: Load the ring descriptor, rewind the producer and enable the DMA writer
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_DMA_BASE_OFFSET, (uint32_t)(UINTPTR)RingData);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_DMA_SIZE_OFFSET, RingBytes);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_DMA_BLOCK_OFFSET, BlockBytes);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_DMA_CONSUMER_OFFSET, 0);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_DMA_CTRL_OFFSET, DMA_CTRL_RESET_MASK);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_DMA_CTRL_OFFSET, DMA_CTRL_EN_MASK);
+    IP_Handle->DmaEnabled = true;
+
+    // STEP 5: Load IP config register for free running: Clock Divider, Free Run, Multi Bit, Start Bit and Enable Bit
+    uint32_t ClockDividerOffset = CTRL_CLKDIV_FIELD(IP_Handle->ClockDivider);
+    IP_Handle->ControlRegister = ClockDividerOffset | CTRL_EN_BIT_MASK;
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
+    IP_Handle->ControlRegister |= CTRL_FREE_RUN_BIT_MASK | CTRL_MULTI_BIT_MASK | CTRL_START_BIT_MASK;
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
+
+    return(true);
+
+} // END IMR_ADC_7476A_X2_StartDma
+
+
+
+/********************************************************************************************************
+* @brief Stops DMA acquisition.  The frame in flight completes and the DMA writer flushes the FIFO tail into the
+* ring, then the DMA writer and the FIFO are turned off.
+*
+* @author original: Hab Collector \n
+*
+* @note: Synchronous - the IP interrupt is masked during the stop so no DMA done interrupt is taken after the
+*        handle has left DMA mode
+* @note: Samples not yet released stay in the ring and can still be read with IMR_ADC_7476A_X2_GetDmaSamples
+* @note: If the ring is full (not released) the tail cannot land - the FIFO is flushed and those samples lost
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+*
+* @return True if the IP went idle and the FIFO tail landed within IMR_ADC_STOP_TIMEOUT_US - the DMA writer and
+*         the FIFO are turned off either way
+*
+* STEP 1: Mask the IP interrupt
+* STEP 2: Drop START - the IP idles after the current frame
+* STEP 3: Wait for the DMA writer to empty the FIFO unless it is stalled on a full ring
+* STEP 4: DMA writer and FIFO off, clear the DMA flags and unmask
+********************************************************************************************************/
+bool IMR_ADC_7476A_X2_StopDma(Type_AXI_IMR_7476A_Handle *IP_Handle)
+{
+    // STEP 1: Mask the IP interrupt
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_AUTO_ACK_MASK);
+
+    // STEP 2: Drop START - the IP idles after the current frame
+    IP_Handle->ControlRegister &= ~(CTRL_FREE_RUN_BIT_MASK | CTRL_MULTI_BIT_MASK | CTRL_START_BIT_MASK);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
+    uint32_t StartTicks = disk_time_now();
+    bool Idle = adcWaitIdle(IP_Handle, StartTicks);
+
+    // STEP 3: Wait for the DMA writer to empty the FIFO unless it is stalled on a full ring
+    uint32_t FifoStatus;
+    do
+    {
+        FifoStatus = IMR_ADC_7476A_X2_GetFifoStatusReg(IP_Handle);
+        if (!(FifoStatus & FIFO_STATUS_COUNT_MASK) || (FifoStatus & FIFO_STATUS_DMA_STALL_MASK))
+            break;
+        Idle = Idle && !disk_time_expired(StartTicks, IMR_ADC_STOP_TIMEOUT_US);
+    } while (Idle);
+
+    // STEP 4: DMA writer and FIFO off, clear the DMA flags and unmask
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_DMA_CTRL_OFFSET, 0x00);
+    IP_Handle->DmaEnabled = false;
+    IMR_ADC_7476A_X2_DisableFifo(IP_Handle);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_AUTO_ACK_MASK | IRQ_CLR_MASK);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_AUTO_ACK_MASK);
+    return(Idle);
+
+} // END IMR_ADC_7476A_X2_StopDma
+
+
+
+/********************************************************************************************************
+* @brief Hands out the samples the IP has written since the last release, as one contiguous run of the ring
+* (up to the producer, or up to the ring end if the producer has wrapped - call again for the rest).  The
+* run is invalidated in the D-cache first so the CPU reads what the IP wrote, not stale lines.
+*
+* @author original: Hab Collector \n
+*
+* @note: The samples belong to the caller until IMR_ADC_7476A_X2_ReleaseDmaSamples
+* @note: Whole cache lines are invalidated - the ring is only ever written by the IP so partial lines at either
+*        end lose nothing
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+* @param Samples: Returns the first sample of the run - unpack with FIFO_WORD_A / FIFO_WORD_B
+*
+* @return Samples in the run, 0 if none
+*
+* STEP 1: Read the producer - the run ends there or at the ring end
+* STEP 2: Invalidate the run so the CPU sees the DMA data
+********************************************************************************************************/
+uint32_t IMR_ADC_7476A_X2_GetDmaSamples(Type_AXI_IMR_7476A_Handle *IP_Handle, uint32_t **Samples)
+{
+    // STEP 1: Read the producer - the run ends there or at the ring end
+    uint32_t Producer = IMR_ADC_7476A_X2_GetDmaProducerReg(IP_Handle);
+    if (Producer == IP_Handle->DmaConsumer)
+        return(0);
+    uint32_t RunEnd = (Producer > IP_Handle->DmaConsumer) ? Producer : IP_Handle->DmaRingBytes;
+    uint32_t RunBytes = RunEnd - IP_Handle->DmaConsumer;
+
+    // STEP 2: Invalidate the run so the CPU sees the DMA data
+    *Samples = &IP_Handle->DmaRing[IP_Handle->DmaConsumer / sizeof(uint32_t)];
+    Xil_DCacheInvalidateRange((UINTPTR)*Samples, RunBytes);
+    return(RunBytes / sizeof(uint32_t));
+
+} // END IMR_ADC_7476A_X2_GetDmaSamples
+
+
+
+/********************************************************************************************************
+* @brief Returns samples handed out by IMR_ADC_7476A_X2_GetDmaSamples to the IP - the DMA writer may then
+* reuse that part of the ring
+*
+* @author original: Hab Collector \n
+*
+* @note: Release no more than the last run returned
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+* @param SampleCount: Samples consumed
+********************************************************************************************************/
+void IMR_ADC_7476A_X2_ReleaseDmaSamples(Type_AXI_IMR_7476A_Handle *IP_Handle, uint32_t SampleCount)
+{
+    IP_Handle->DmaConsumer = (IP_Handle->DmaConsumer + (SampleCount * sizeof(uint32_t))) % IP_Handle->DmaRingBytes;
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_DMA_CONSUMER_OFFSET, IP_Handle->DmaConsumer);
+
+} // END IMR_ADC_7476A_X2_ReleaseDmaSamples
+
+
+
+/********************************************************************************************************
+* @brief Triggered (signal mode) capture.  The IP converts free running into a pre-trigger ring in the sample
+* FIFO, compares each sample of the source channel against the trigger and, once PostSamples have followed the
+* trigger, stops and interrupts once with the whole record waiting.  The ISR copies it into the buffers, sets
+* TriggerRecordReady and TriggerIndex (the buffer index of the trigger sample) and posts ADC_EVENT_TRIGGER_RECORD.
+*
+* @author original: Hab Collector \n
+*
+* @note: IP must be initialized before use - the sample rate is the one set by IMR_ADC_7476A_X2_SetSampleRate
+* @note: No interrupts while armed - a record that never triggers costs the CPU nothing
+* @note: Triggers are ignored until Holdoff samples (at least PreSamples) have been taken so the pre-trigger part
+*        is full.  IMR_ADC_7476A_X2_ForceTrigger overrides the holdoff - TriggerIndex then shows the pre samples held
+* @note: Call again to re-arm after the record has been used, IMR_ADC_7476A_X2_DisarmTrigger to leave
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+* @param TriggerConfig: Source, mode, level, hysteresis, holdoff and record shape
+* @param BufferData_A: Record buffer, PreSamples + PostSamples
+* @param BufferData_B: Record buffer, PreSamples + PostSamples
+*
+* @return True if armed
+*
+* STEP 1: Test for valid handle, buffers and trigger
+* STEP 2: Set data pointers and handle members for the record
+* STEP 3: FIFO on with no threshold interrupt - the trigger engine interrupts when the record is complete
+* STEP 4: Load the trigger and arm - ARM flushes the FIFO and starts the pre-trigger ring
+* STEP 5: Load IP config register for free running: Clock Divider, Free Run, Multi Bit, Start Bit and Enable Bit
+********************************************************************************************************/
+bool IMR_ADC_7476A_X2_ArmTrigger(Type_AXI_IMR_7476A_Handle *IP_Handle, const Type_ADC_TriggerConfig *TriggerConfig, uint16_t *BufferData_A, uint16_t *BufferData_B)
+{
+    // STEP 1: Test for valid handle, buffers and trigger
+    if ((IP_Handle ==  NULL) || (TriggerConfig == NULL))
+        return(false);
+    if ((BufferData_A == NULL) || (BufferData_B == NULL) || IP_Handle->Streaming || IP_Handle->DmaEnabled)
+        return(false);
+    if ((TriggerConfig->Level > TRIG_SAMPLE_MASK) || (TriggerConfig->Hysteresis > TRIG_SAMPLE_MASK) || (TriggerConfig->Holdoff > TRIG_HOLDOFF_MAX))
+        return(false);
+    if ((TriggerConfig->PostSamples == 0) || (((uint32_t)TriggerConfig->PreSamples + TriggerConfig->PostSamples) > IMR_ADC_FIFO_DEPTH))
+        return(false);
+
+    // STEP 2: Set data pointers and handle members for the record
+    IP_Handle->ControlRegister = 0x00;
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
+    IP_Handle->ADC_Data_A = BufferData_A;
+    IP_Handle->ADC_Data_B = BufferData_B;
+    IP_Handle->TotalConversions = (uint32_t)TriggerConfig->PreSamples + TriggerConfig->PostSamples;
+    IP_Handle->ConversionCount = 0;
+    IP_Handle->TriggerIndex = 0;
+    IP_Handle->TriggerRecordReady = false;
+    IP_Handle->Triggering = true;
+
+    // STEP 3: FIFO on with no threshold interrupt - the trigger engine interrupts when the record is complete
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_FIFO_CTRL_OFFSET, FIFO_CTRL_EN_MASK | FIFO_CTRL_FLUSH_MASK);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_FIFO_CTRL_OFFSET, FIFO_CTRL_EN_MASK);
+    IP_Handle->FifoEnabled = true;
+    IP_Handle->FifoThreshold = 0;
+    IP_Handle->FifoOverflowCount = 0;
+
+    // STEP 4: Load the trigger and arm - ARM flushes the FIFO and starts the pre-trigger ring
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_TRIG_LEVEL_OFFSET, ((uint32_t)TriggerConfig->Level << TRIG_LEVEL_LSB) | ((uint32_t)TriggerConfig->Hysteresis << TRIG_HYST_LSB));
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_TRIG_HOLDOFF_OFFSET, TriggerConfig->Holdoff);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_TRIG_RECORD_OFFSET, ((uint32_t)TriggerConfig->PreSamples << TRIG_PRE_LSB) | ((uint32_t)TriggerConfig->PostSamples << TRIG_POST_LSB));
+    IP_Handle->TriggerControl = TRIG_CTRL_EN_MASK | (((uint32_t)TriggerConfig->Mode << TRIG_CTRL_MODE_LSB) & TRIG_CTRL_MODE_MASK);
+    if (TriggerConfig->Source == ADC_TRIGGER_SOURCE_B)
+        IP_Handle->TriggerControl |= TRIG_CTRL_SOURCE_MASK;
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_TRIG_CTRL_OFFSET, IP_Handle->TriggerControl);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_TRIG_CTRL_OFFSET, IP_Handle->TriggerControl | TRIG_CTRL_ARM_MASK);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_TRIG_CTRL_OFFSET, IP_Handle->TriggerControl);
+
+    // STEP 5: Load IP config register for free running: Clock Divider, Free Run, Multi Bit, Start Bit and Enable Bit
+    uint32_t ClockDividerOffset = CTRL_CLKDIV_FIELD(IP_Handle->ClockDivider);
+    IP_Handle->ControlRegister = ClockDividerOffset | CTRL_EN_BIT_MASK;
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
+    IP_Handle->ControlRegister |= CTRL_FREE_RUN_BIT_MASK | CTRL_MULTI_BIT_MASK | CTRL_START_BIT_MASK;
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
+
+    return(true);
+
+} // END IMR_ADC_7476A_X2_ArmTrigger
+
+
+
+/********************************************************************************************************
+* @brief Triggers an armed capture on the next sample regardless of the trigger condition and holdoff - the
+* record completes as normal
+*
+* @author original: Hab Collector \n
+*
+* @note: Ignored unless armed - no effect once triggered
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+********************************************************************************************************/
+void IMR_ADC_7476A_X2_ForceTrigger(Type_AXI_IMR_7476A_Handle *IP_Handle)
+{
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_TRIG_CTRL_OFFSET, IP_Handle->TriggerControl | TRIG_CTRL_FORCE_MASK);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_TRIG_CTRL_OFFSET, IP_Handle->TriggerControl);
+
+} // END IMR_ADC_7476A_X2_ForceTrigger
+
+
+
+/********************************************************************************************************
+* @brief Leaves triggered capture.  The frame in flight completes, then the trigger engine and the FIFO are
+* turned off - a record not yet reported is discarded.
+*
+* @author original: Hab Collector \n
+*
+* @note: Synchronous - the IP interrupt is masked during the stop so no record interrupt is taken after the
+*        handle has left trigger mode
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+*
+* @return True if the IP went idle within IMR_ADC_STOP_TIMEOUT_US - the handle leaves trigger mode either way
+*
+* STEP 1: Mask the IP interrupt
+* STEP 2: Drop START - the IP idles after the current frame
+* STEP 3: Trigger engine and FIFO off, clear the flags and unmask
+********************************************************************************************************/
+bool IMR_ADC_7476A_X2_DisarmTrigger(Type_AXI_IMR_7476A_Handle *IP_Handle)
+{
+    // STEP 1: Mask the IP interrupt
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_AUTO_ACK_MASK);
+
+    // STEP 2: Drop START - the IP idles after the current frame
+    IP_Handle->ControlRegister = 0x00;
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CTRL_OFFSET, IP_Handle->ControlRegister);
+    bool Idle = adcWaitIdle(IP_Handle, disk_time_now());
+
+    // STEP 3: Trigger engine and FIFO off, clear the flags and unmask
+    IP_Handle->TriggerControl = 0x00;
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_TRIG_CTRL_OFFSET, IP_Handle->TriggerControl);
+    IP_Handle->Triggering = false;
+    IMR_ADC_7476A_X2_DisableFifo(IP_Handle);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_AUTO_ACK_MASK | IRQ_CLR_MASK);
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_IRQ_OFFSET, IRQ_ENABLE_MASK | IRQ_AUTO_ACK_MASK);
+    return(Idle);
+
+} // END IMR_ADC_7476A_X2_DisarmTrigger
+
+
+
+/********************************************************************************************************
+* @brief Waits for STATUS BUSY to drop after START has been cleared, bounded by the diskio_timing time base
+*
+* @author original: Hab Collector \n
+*
+* @note: A frame in flight takes under 6us at any divider - a longer wait means the IP is wedged, and the
+*        caller turns the mode off regardless rather than hang the main loop
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+* @param StartTicks: disk_time_now() when START was cleared
+*
+* @return True if BUSY dropped before IMR_ADC_STOP_TIMEOUT_US
+********************************************************************************************************/
+static bool adcWaitIdle(Type_AXI_IMR_7476A_Handle *IP_Handle, uint32_t StartTicks)
+{
+    while (IMR_ADC_7476A_X2_GetStatusReg(IP_Handle) & STATUS_BUSY_MASK)
+    {
+        if (disk_time_expired(StartTicks, IMR_ADC_STOP_TIMEOUT_US))
+            return(false);
+    }
+    return(true);
+
+} // END adcWaitIdle
+
+
+
+/********************************************************************************************************
+* @brief Sets the IP CIC decimator for the continuous captures that follow.  Each delivered sample is then the
+* CIC low pass of Ratio conversions: Order integrator / comb stages, DC gain Ratio^Order, scaled back to a 16 bit
+* sample by the output shift set here.  Multi convert, stream, DMA and trigger captures all deliver decimated
+* samples at SampleRate / Ratio; single conversions are never decimated.
+*
+* @author original: Hab Collector \n
+*
+* @note: IP must be idle - the IP takes the setting at the start of a capture
+* @note: Counts are in decimated samples: a multi convert of TotalConversions takes TotalConversions * Ratio
+*        conversions (plus Order - 1 outputs discarded while the filter fills), the FIFO threshold, trigger record
+*        and DMA ring all hold decimated samples
+* @note: The shift drops the growth above 16 bits: Order * ceil(log2(Ratio)) - 4.  With Ratio a power of 2 and a
+*        growth of 4 or more a full scale input is 0xFFF0 - 16 x ADC codes, which is also what the trigger compares
+*        (the level stays in ADC codes).  Less growth returns samples of 12 + growth bits
+* @note: Droop: the CIC passband falls off toward Fs / (2 * Ratio) - see IMR_ADC_7476A_X2_InitCicCompensator
+* 
+* @param IP_Handle: Pointer to the IMR ADC Dual ADC7476A IP handle  
+* @param Order: CIC stages 1 to IMR_ADC_CIC_MAX_ORDER, 0 = bypass
+* @param Ratio: Conversions per sample 2 to IMR_ADC_CIC_MAX_RATIO, 0 or 1 = bypass
+*
+* @return True if set
+*
+* STEP 1: Test for valid handle, idle IP and range
+* STEP 2: Bypass - samples as converted
+* STEP 3: Bit growth and the shift back to 16 bits
+* STEP 4: Load the IP CIC control register
+********************************************************************************************************/
+bool IMR_ADC_7476A_X2_SetDecimation(Type_AXI_IMR_7476A_Handle *IP_Handle, uint8_t Order, uint16_t Ratio)
+{
+    // STEP 1: Test for valid handle, idle IP and range
+    if (IP_Handle ==  NULL)
+        return(false);
+    if (IMR_ADC_7476A_X2_GetStatusReg(IP_Handle) & STATUS_BUSY_MASK)
+        return(false);
+    if ((Order > IMR_ADC_CIC_MAX_ORDER) || (Ratio > IMR_ADC_CIC_MAX_RATIO))
+        return(false);
+
+    // STEP 2: Bypass - samples as converted
+    if ((Order == 0) || (Ratio <= 1))
+    {
+        IP_Handle->CicEnabled = false;
+        IP_Handle->CicOrder = 1;
+        IP_Handle->CicRatio = 1;
+        IP_Handle->CicShift = 0;
+        Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CIC_CTRL_OFFSET, 0x00);
+        return(true);
+    }
+
+    // STEP 3: Bit growth and the shift back to 16 bits
+    uint8_t RatioBits = 0;
+    while ((1U << RatioBits) < Ratio)
+        RatioBits++;
+    uint8_t Growth = Order * RatioBits;
+    IP_Handle->CicShift = (Growth > (IMR_ADC_CIC_OUT_BITS - 12)) ? (Growth - (IMR_ADC_CIC_OUT_BITS - 12)) : 0;
+    IP_Handle->CicOrder = Order;
+    IP_Handle->CicRatio = Ratio;
+    IP_Handle->CicEnabled = true;
+
+    // STEP 4: Load the IP CIC control register
+    uint32_t CicControl = CIC_CTRL_EN_MASK;
+    CicControl |= ((uint32_t)(Order - 1) << CIC_CTRL_ORDER_LSB) & CIC_CTRL_ORDER_MASK;
+    CicControl |= ((uint32_t)(Ratio - 1) << CIC_CTRL_RATIO_LSB) & CIC_CTRL_RATIO_MASK;
+    CicControl |= ((uint32_t)IP_Handle->CicShift << CIC_CTRL_SHIFT_LSB) & CIC_CTRL_SHIFT_MASK;
+    Xil_Out32(IP_Handle->ADC_BaseAddress + REG_CIC_CTRL_OFFSET, CicControl);
+
+    return(true);
+
+} // END IMR_ADC_7476A_X2_SetDecimation
+
+
+
+/********************************************************************************************************
+* @brief Designs the FIR that flattens the CIC passband droop.  The CIC response at output frequency F (cycles
+* per decimated sample) is |sin(pi * F) / (Ratio * sin(pi * F / Ratio))|^Order; the compensator is its inverse up
+* to PassbandEdge and zero above, windowed (Hamming) to IMR_ADC_CIC_COMP_TAPS linear phase taps.
+*
+* @author original: Hab Collector \n
+*
+* @note: Runs at the decimated rate on the CPU - call once per decimation setting, not per block
+* @note: Taps are Q14 scaled to a DC gain of exactly 1.0, so a DC input passes unchanged
+* @note: 21 taps make PassbandEdge the half gain point of the transition: the CIC and compensator together are
+*        flat to about 1% up to 0.6 of it.  The inverse rises steeply near Fs / 2: keep PassbandEdge at or below
+*        about 0.25 of the decimated rate (the band the CIC aliasing leaves clean anyway)
+* 
+* @param Compensator: Filter to initialize - taps and cleared history
+* @param Order: CIC order in use (IP_Handle->CicOrder)
+* @param Ratio: CIC ratio in use (IP_Handle->CicRatio)
+* @param PassbandEdge: Highest frequency to flatten as a fraction of the decimated rate, 0 to 0.5
+*
+* @return True if designed
+*
+* STEP 1: Test the filter and the band
+* STEP 2: Ideal response - integrate the inverse droop over the passband for each tap
+* STEP 3: Window, quantize to Q14 and trim the centre tap for unity DC gain
+* STEP 4: Clear the history
+********************************************************************************************************/
+bool IMR_ADC_7476A_X2_InitCicCompensator(Type_ADC_CicCompensator *Compensator, uint8_t Order, uint16_t Ratio, float PassbandEdge)
+{
+    const uint16_t GridPoints = 256;
+    const int16_t Centre = (IMR_ADC_CIC_COMP_TAPS - 1) / 2;
+    const float Pi = 3.14159265f;
+    float Ideal[IMR_ADC_CIC_COMP_TAPS] = {0};
+
+    // STEP 1: Test the filter and the band
+    if (Compensator == NULL)
+        return(false);
+    if ((Order == 0) || (Order > IMR_ADC_CIC_MAX_ORDER) || (Ratio == 0) || (Ratio > IMR_ADC_CIC_MAX_RATIO))
+        return(false);
+    if ((PassbandEdge <= 0.0f) || (PassbandEdge >= 0.5f))
+        return(false);
+
+    // STEP 2: Ideal response - integrate the inverse droop over the passband for each tap
+    // h[n] = 2 * integral 0..Fp of D(F) * cos(2 * pi * F * (n - Centre)) dF, midpoint rule
+    float Step = PassbandEdge / GridPoints;
+    for (uint16_t Point = 0; Point < GridPoints; Point++)
+    {
+        float Frequency = (Point + 0.5f) * Step;
+        float Droop = sinf(Pi * Frequency) / (Ratio * sinf(Pi * Frequency / Ratio));
+        float Inverse = 1.0f / powf(fabsf(Droop), Order);
+        for (int16_t Tap = 0; Tap < IMR_ADC_CIC_COMP_TAPS; Tap++)
+            Ideal[Tap] += 2.0f * Inverse * cosf(2.0f * Pi * Frequency * (Tap - Centre)) * Step;
+    }
+
+    // STEP 3: Window, quantize to Q14 and trim the centre tap for unity DC gain
+    float DcGain = 0.0f;
+    for (int16_t Tap = 0; Tap < IMR_ADC_CIC_COMP_TAPS; Tap++)
+    {
+        Ideal[Tap] *= 0.54f - (0.46f * cosf(2.0f * Pi * Tap / (IMR_ADC_CIC_COMP_TAPS - 1)));
+        DcGain += Ideal[Tap];
+    }
+    int32_t TapSum = 0;
+    for (int16_t Tap = 0; Tap < IMR_ADC_CIC_COMP_TAPS; Tap++)
+    {
+        float Scaled = roundf((Ideal[Tap] / DcGain) * (1 << IMR_ADC_CIC_COMP_SHIFT));
+        if (Scaled > INT16_MAX)
+            Scaled = INT16_MAX;
+        if (Scaled < INT16_MIN)
+            Scaled = INT16_MIN;
+        Compensator->Taps[Tap] = (int16_t)Scaled;
+        TapSum += Compensator->Taps[Tap];
+    }
+    Compensator->Taps[Centre] += (int16_t)((1 << IMR_ADC_CIC_COMP_SHIFT) - TapSum);
+
+    // STEP 4: Clear the history
+    for (int16_t Tap = 0; Tap < IMR_ADC_CIC_COMP_TAPS; Tap++)
+        Compensator->History[Tap] = 0;
+    Compensator->Index = 0;
+
+    return(true);
+
+} // END IMR_ADC_7476A_X2_InitCicCompensator
+
+
+
+/********************************************************************************************************
+* @brief Runs the CIC droop compensator over a block of decimated samples in place.  The history carries
+* across calls, so a capture may be compensated block by block (a ring half, a DMA run) with no seams.
+*
+* @author original: Hab Collector \n
+*
+* @note: One compensator per channel
+* @note: Linear phase - the output lags the input by (IMR_ADC_CIC_COMP_TAPS - 1) / 2 samples, and the first
+*        IMR_ADC_CIC_COMP_TAPS - 1 of a fresh compensator ramp in from zero
+* @note: Results saturate to the 16 bit sample range - the inverse droop boosts full scale tones near the edge
+* 
+* @param Compensator: Filter from IMR_ADC_7476A_X2_InitCicCompensator
+* @param Samples: Decimated samples - replaced by the compensated samples
+* @param SampleCount: Samples in the block
+*
+* STEP 1: Store the new sample over the oldest
+* STEP 2: Multiply accumulate, newest sample first
+* STEP 3: Round, saturate and write back
+********************************************************************************************************/
+void IMR_ADC_7476A_X2_CicCompensate(Type_ADC_CicCompensator *Compensator, uint16_t *Samples, uint32_t SampleCount)
+{
+    for (uint32_t Sample = 0; Sample < SampleCount; Sample++)
+    {
+        // STEP 1: Store the new sample over the oldest
+        uint8_t Newest = Compensator->Index;
+        Compensator->History[Newest] = Samples[Sample];
+        Compensator->Index = (Newest + 1) % IMR_ADC_CIC_COMP_TAPS;
+
+        // STEP 2: Multiply accumulate, newest sample first
+        int32_t Accumulator = 0;
+        uint8_t HistoryIndex = Newest;
+        for (uint8_t Tap = 0; Tap < IMR_ADC_CIC_COMP_TAPS; Tap++)
+        {
+            Accumulator += (int32_t)Compensator->Taps[Tap] * Compensator->History[HistoryIndex];
+            HistoryIndex = (HistoryIndex == 0) ? (IMR_ADC_CIC_COMP_TAPS - 1) : (HistoryIndex - 1);
+        }
+
+        // STEP 3: Round, saturate and write back
+        Accumulator = (Accumulator + (1 << (IMR_ADC_CIC_COMP_SHIFT - 1))) >> IMR_ADC_CIC_COMP_SHIFT;
+        if (Accumulator < 0)
+            Accumulator = 0;
+        if (Accumulator > UINT16_MAX)
+            Accumulator = UINT16_MAX;
+        Samples[Sample] = (uint16_t)Accumulator;
+    }
+
+} // END IMR_ADC_7476A_X2_CicCompensate
+
+
+
 // QUICK ACCESS GET FUNCTIONS
 uint32_t IMR_ADC_7476A_X2_GetCtrlReg(Type_AXI_IMR_7476A_Handle *IP_Handle)
 {
@@ -270,5 +1364,24 @@ uint32_t IMR_ADC_7476A_X2_GetDataBReg(Type_AXI_IMR_7476A_Handle *IP_Handle)
     return(Xil_In32(IP_Handle->ADC_BaseAddress + REG_DATA_B_OFFSET));
 }
 
+uint32_t IMR_ADC_7476A_X2_GetDataABReg(Type_AXI_IMR_7476A_Handle *IP_Handle)
+{
+    return(Xil_In32(IP_Handle->ADC_BaseAddress + REG_DATA_AB_OFFSET));
+}
+
+uint32_t IMR_ADC_7476A_X2_GetFifoStatusReg(Type_AXI_IMR_7476A_Handle *IP_Handle)
+{
+    return(Xil_In32(IP_Handle->ADC_BaseAddress + REG_FIFO_STATUS_OFFSET));
+}
+
+uint32_t IMR_ADC_7476A_X2_GetDmaProducerReg(Type_AXI_IMR_7476A_Handle *IP_Handle)
+{
+    return(Xil_In32(IP_Handle->ADC_BaseAddress + REG_DMA_PRODUCER_OFFSET));
+}
+
+uint32_t IMR_ADC_7476A_X2_GetTriggerStatusReg(Type_AXI_IMR_7476A_Handle *IP_Handle)
+{
+    return(Xil_In32(IP_Handle->ADC_BaseAddress + REG_TRIG_STATUS_OFFSET));
+}
 
 
@@ -32,6 +32,7 @@ extern"C" {
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "xparameters.h"
 
 // DEFINES
 // ADDRESS OFFSET
@@ -41,29 +42,225 @@ extern"C" {
 #define REG_DATA_A_OFFSET       0x08        // Register 2: Data A value (read only) 12b
 #define REG_DATA_B_OFFSET       0x0C        // Register 3: Data B value (read only) 12b
 #define REG_IRQ_OFFSET          0x10        // Register 4: IRQ Register
+#define REG_FIFO_CTRL_OFFSET    0x14        // Register 5: Sample FIFO control
+#define REG_FIFO_STATUS_OFFSET  0x18        // Register 6: Sample FIFO count and flags (read only)
+#define REG_FIFO_DATA_OFFSET    0x1C        // Register 7: Sample FIFO read port - each read pops one sample (read only)
+#define REG_DATA_AB_OFFSET      0x20        // Register 8: Sequence, Data A and Data B in one word (read only)
+#define REG_DMA_CTRL_OFFSET     0x24        // Register 9: DMA writer control
+#define REG_DMA_BASE_OFFSET     0x28        // Register 10: DMA ring start address (64 byte aligned)
+#define REG_DMA_SIZE_OFFSET     0x2C        // Register 11: DMA ring length in bytes (multiple of 64)
+#define REG_DMA_BLOCK_OFFSET    0x30        // Register 12: Bytes per DMA block interrupt (0 = none)
+#define REG_DMA_PRODUCER_OFFSET 0x34        // Register 13: Byte offset of the next DMA write (read only)
+#define REG_DMA_CONSUMER_OFFSET 0x38        // Register 14: Byte offset software has consumed up to
+#define REG_SAMPLE_PERIOD_OFFSET 0x3C       // Register 15: SysClk cycles between conversion starts (0 = back to back)
+#define REG_TRIG_CTRL_OFFSET    0x40        // Register 16: Trigger enable, arm, force, source and mode
+#define REG_TRIG_LEVEL_OFFSET   0x44        // Register 17: Trigger level and hysteresis
+#define REG_TRIG_HOLDOFF_OFFSET 0x48        // Register 18: Samples after arming before a trigger is accepted
+#define REG_TRIG_RECORD_OFFSET  0x4C        // Register 19: Pre / post trigger sample counts
+#define REG_TRIG_STATUS_OFFSET  0x50        // Register 20: Trigger state and trigger position (read only)
+#define REG_CIC_CTRL_OFFSET     0x54        // Register 21: CIC decimator enable, order, ratio and output shift
 // MISC
+#ifdef XPAR_FABRIC_IMR_ADC_7476A_X2_0_INTR
+#define ADC_7476A_X2_FABRIC_ID  XPAR_FABRIC_IMR_ADC_7476A_X2_0_INTR     // ADC IP IRQ input on the INTC concat (xlconcat_1/In1)
+#else
 #define ADC_7476A_X2_FABRIC_ID  1           // I manually created this based on the ADC IP IRQ connection to the Concat block (2 means 3rd connection counting from 0 [x:0] where x is last connection)
+#endif
+#define IMR_ADC_SYSCLK_HZ       100000000U  // IP clock (s00_axi_aclk) - sample period unit
+#define IMR_ADC_MIN_CLOCK_DIVIDER 3         // SCLK 20MHz max - init refuses a smaller divider (the IP runs 0..2 as 3)
 #define IMR_ADC_CLOCK_DIVIDER   4           // Max ADC Clock 20MHz. SysClk = 100MHz - ClockDivider = 3, ADC_CLK = 16.6667MHz, ClockDivider = 4, ADC_CLK = 12.5MHz, ClockDivider = 5, ADC_CLK = 10.0MHz
+#define IMR_ADC_CLKDIV_ODD      0x80        // ClockDivider flag: SCLK period 2N - 1 SysClks - (3 | IMR_ADC_CLKDIV_ODD) = 20MHz
+#define IMR_ADC_MAX_SAMPLE_RATE 1000000U    // AD7476A rated throughput (back to back at 3 | ODD is 1.163 MSPS - paced, see IMR_ADC_UNPACED_PERIOD)
+// Back to back throughput (SAMPLE_PERIOD = 0): ClockDivider 3 = 990.1 kSPS, 4 = 757.6 kSPS, 5 = 613.5 kSPS, 3 | ODD = 1.163 MSPS, 4 | ODD = 854.7 kSPS
 //----------------------------- CTRL bitfields ---------------------------------
 #define CTRL_EN_BIT             0           // enable engine
 #define CTRL_START_BIT          1           // write 1 = single-shot start pulse
 #define CTRL_MULTI_BIT          2           // 1 = continuous conversions
+#define CTRL_FREE_RUN_BIT       3           // with MULTI: convert until START is cleared, count ignored
 #define CTRL_CLKDIV_LSB         4           // SCLK divider field [7:4] - Total 4 bits
-#define CTRL_CLKDIV_MSB         7           // SCLK = SYSCLK / (2*(N+1)) - Total 4 bits
+#define CTRL_CLKDIV_MSB         7           // SCLK = SYSCLK / (2*N) - Total 4 bits (N = 0..2 run as 3)
 #define CTRL_CONT_CNT_LSB       8           // Contineous Conversion Count LSB [19:8] - Total 12bits (4096 Max Conversions)
 #define CTRL_CONT_CNT_MSB       19          // Contineous Conversion Count MSB
+#define CTRL_CLKDIV_ODD_BIT     20          // 1 = SCLK = SYSCLK / (2*N - 1) - high phase one SysClk shorter
 //----------------------------- IRQ bitfields ---------------------------------
 #define IRQ_EN_BIT              0           // enable the IRQ
-#define IRQ_CLR_BIT             1           // enable clear the pending irq
+#define IRQ_CLR_BIT             1           // clear the pending irq - self-clearing, one write acknowledges
+#define IRQ_AUTO_ACK_BIT        2           // reading DATA_AB also clears the pending irq
+#define IRQ_DONE_EN_BIT         3           // also irq on STATUS DONE - the end of a capture
+//----------------------------- DATA_AB bitfields ---------------------------------
+#define DATA_AB_SEQ_LSB         24          // Conversion sequence number [31:24] - wraps at 256
+#define DATA_AB_A_LSB           12          // Channel A [23:12]
+#define DATA_AB_B_LSB           0           // Channel B [11:0]
+//----------------------------- STATUS bitfields ---------------------------------
+#define STATUS_BUSY_BIT         0           // 1 = converting
+#define STATUS_OVERRUN_BIT      5           // 1 = a conversion missed its sample period slot (sticky - IRQ_CLR or next capture)
+#define STATUS_DONE_BIT         6           // 1 = the capture has ended, every result latched (sticky - IRQ_CLR or next capture)
+//----------------------------- SAMPLE_PERIOD ---------------------------------
+#define SAMPLE_PERIOD_MAX       0x00FFFFFF  // 24 bit period - 6 Hz at 100 MHz
+#define SAMPLE_PERIOD_QUIET     6           // CS_n high SysClks between frames (tQUIET) - the result latch overlaps it
+#define IMR_ADC_SCLK_PERIOD(Divider)        ((2U * ((uint32_t)(Divider) & 0x0F)) - (((Divider) & IMR_ADC_CLKDIV_ODD) ? 1U : 0U))
+#define IMR_ADC_MIN_SAMPLE_PERIOD(Divider)  ((15U * IMR_ADC_SCLK_PERIOD(Divider)) + ((uint32_t)(Divider) & 0x0F) + 2U + SAMPLE_PERIOD_QUIET)  // One frame: first SCLK rise, 15 SCLKs, MISO two SysClks after the rise, tQUIET
+#define IMR_ADC_RATED_SAMPLE_PERIOD         (IMR_ADC_SYSCLK_HZ / IMR_ADC_MAX_SAMPLE_RATE)   // 100 SysClks - the shortest period the AD7476A is rated for
+#define IMR_ADC_UNPACED_PERIOD(Divider)     ((IMR_ADC_MIN_SAMPLE_PERIOD(Divider) < IMR_ADC_RATED_SAMPLE_PERIOD) ? IMR_ADC_RATED_SAMPLE_PERIOD : 0U)  // Rate 0: back to back, unless faster than rated (3 | ODD)
+//----------------------------- FIFO bitfields ---------------------------------
+#define IMR_ADC_FIFO_DEPTH      1024        // Samples (one word holds both channels)
+#define FIFO_CTRL_THRESH_LSB    0           // IRQ threshold [10:0] - 1 to 1024 samples, 0 = threshold IRQ off
+#define FIFO_CTRL_THRESH_MSB    10
+#define FIFO_CTRL_EN_BIT        16          // 1 = conversions to the FIFO, IRQ on threshold / overflow / tail
+#define FIFO_CTRL_FLUSH_BIT     17          // write 1 = empty the FIFO and clear overflow
+#define FIFO_STATUS_COUNT_LSB   0           // Samples in the FIFO [10:0]
+#define FIFO_STATUS_COUNT_MSB   10
+#define FIFO_STATUS_THRESH_BIT  16          // Count >= threshold
+#define FIFO_STATUS_OVF_BIT     17          // Sample dropped to a full FIFO (sticky - cleared with IRQ_CLR)
+#define FIFO_STATUS_EMPTY_BIT   18
+#define FIFO_STATUS_FULL_BIT    19
+#define FIFO_STATUS_TAIL_BIT    20          // Engine idle with samples left
+#define FIFO_STATUS_TRIG_BIT    21          // Triggered record complete in the FIFO (sticky - cleared with IRQ_CLR)
+#define FIFO_WORD_A_LSB         12          // FIFO word: [23:12] channel A, [11:0] channel B
+#define FIFO_WORD_B_LSB         0
+#define FIFO_CIC_A_LSB          16          // CIC decimating - FIFO / DATA_AB word: [31:16] channel A, [15:0] channel B
+#define FIFO_CIC_B_LSB          0
+#define FIFO_STATUS_DMA_BLOCK_BIT   24      // DMA_BLOCK bytes written (sticky - cleared with IRQ_CLR)
+#define FIFO_STATUS_DMA_ERR_BIT     25      // DMA burst got an error response (sticky - cleared with IRQ_CLR)
+#define FIFO_STATUS_DMA_DONE_BIT    26      // Engine idle and every sample in the ring (sticky - cleared with IRQ_CLR)
+#define FIFO_STATUS_DMA_STALL_BIT   27      // Ring full - DMA waiting on the consumer offset
+//----------------------------- DMA bitfields ---------------------------------
+#define DMA_CTRL_EN_BIT         0           // 1 = the IP writes the FIFO into the ring itself
+#define DMA_CTRL_RESET_BIT      1           // 1 = rewind the producer and clear the DMA flags
+#define IMR_ADC_DMA_ALIGN       64          // Ring base and length alignment in bytes (one 16 word burst)
+//----------------------------- Trigger bitfields ---------------------------------
+#define TRIG_CTRL_EN_BIT        0           // 1 = FIFO samples gated by the trigger engine (FIFO must be on)
+#define TRIG_CTRL_ARM_BIT       1           // write 1 = flush the FIFO and arm (rising edge)
+#define TRIG_CTRL_FORCE_BIT     2           // write 1 = trigger on the next sample while armed (rising edge)
+#define TRIG_CTRL_SOURCE_BIT    3           // 0 = channel A, 1 = channel B
+#define TRIG_CTRL_MODE_LSB      4           // Trigger condition [5:4] - Type_ADC_TriggerMode
+#define TRIG_LEVEL_LSB          0           // Trigger level [11:0] in ADC codes
+#define TRIG_HYST_LSB           16          // Edge re-arm hysteresis [27:16] in ADC codes
+#define TRIG_HOLDOFF_MAX        0x00FFFFFF  // 24 bit holdoff in samples
+#define TRIG_PRE_LSB            0           // Samples kept before the trigger [10:0]
+#define TRIG_POST_LSB           16          // Samples from the trigger sample on [26:16] - PRE + POST <= IMR_ADC_FIFO_DEPTH
+#define TRIG_STATUS_INDEX_LSB   0           // Record index of the trigger sample [10:0]
+#define TRIG_STATUS_STATE_LSB   16          // Type_ADC_TriggerState [17:16]
+#define TRIG_STATUS_DONE_BIT    20          // Record complete (sticky - IRQ_CLR or ARM)
+//----------------------------- CIC bitfields ---------------------------------
+#define CIC_CTRL_EN_BIT         0           // 1 = continuous captures decimated, 0 = bypass (single conversions always bypass)
+#define CIC_CTRL_ORDER_LSB      4           // Order - 1 [5:4]
+#define CIC_CTRL_RATIO_LSB      8           // Decimation ratio - 1 [15:8]
+#define CIC_CTRL_SHIFT_LSB      16          // Output right shift [20:16] - the result saturates at 16 bits
+#define IMR_ADC_CIC_MAX_ORDER   4
+#define IMR_ADC_CIC_MAX_RATIO   256
+#define IMR_ADC_CIC_OUT_BITS    16          // Decimated samples are 16 bit - 12 bit ADC codes scaled by 16 at full gain
+#define IMR_ADC_CIC_COMP_TAPS   21          // Droop compensation FIR length (odd - linear phase, integer delay)
+#define IMR_ADC_CIC_COMP_SHIFT  14          // Compensation taps are Q14
+//----------------------------- Free running stream ---------------------------------
+#define IMR_ADC_STREAM_FIFO_THRESHOLD   128 // FIFO fill per IRQ while streaming (less if the ring half is smaller)
+#define IMR_ADC_RING_HALVES             2
+#define IMR_ADC_EVENT_QUEUE_SIZE        8   // Completion events waiting for the main loop - power of 2
+#define IMR_ADC_STOP_TIMEOUT_US         1000U   // Stop / disarm: BUSY low, then the DMA tail flush - one frame is under 6us
 //----------------------------- Masks ---------------------------------
 #define IRQ_ENABLE_MASK         (uint32_t)(0x01 << IRQ_EN_BIT)
 #define IRQ_CLR_MASK            (uint32_t)(0x01 << IRQ_CLR_BIT)
+#define IRQ_AUTO_ACK_MASK       (uint32_t)(0x01 << IRQ_AUTO_ACK_BIT)
+#define IRQ_DONE_EN_MASK        (uint32_t)(0x01 << IRQ_DONE_EN_BIT)
+#define DATA_AB_SAMPLE_MASK     (uint32_t)0x0FFF
 #define CTRL_EN_BIT_MASK        (uint32_t)(0x01 << CTRL_EN_BIT)
 #define CTRL_START_BIT_MASK     (uint32_t)(0x01 << CTRL_START_BIT)
 #define CTRL_MULTI_BIT_MASK     (uint32_t)(0x01 << CTRL_MULTI_BIT)
+#define CTRL_FREE_RUN_BIT_MASK  (uint32_t)(0x01 << CTRL_FREE_RUN_BIT)
+#define CTRL_CLKDIV_ODD_MASK    (uint32_t)(0x01 << CTRL_CLKDIV_ODD_BIT)
+#define CTRL_CLKDIV_FIELD(Divider)  (((uint32_t)((Divider) & 0x0F) << CTRL_CLKDIV_LSB) | (((Divider) & IMR_ADC_CLKDIV_ODD) ? CTRL_CLKDIV_ODD_MASK : 0))
+#define STATUS_BUSY_MASK        (uint32_t)(0x01 << STATUS_BUSY_BIT)
+#define STATUS_OVERRUN_MASK     (uint32_t)(0x01 << STATUS_OVERRUN_BIT)
+#define STATUS_DONE_MASK        (uint32_t)(0x01 << STATUS_DONE_BIT)
+#define FIFO_CTRL_THRESH_MASK   (uint32_t)(0x7FF << FIFO_CTRL_THRESH_LSB)
+#define FIFO_CTRL_EN_MASK       (uint32_t)(0x01 << FIFO_CTRL_EN_BIT)
+#define FIFO_CTRL_FLUSH_MASK    (uint32_t)(0x01 << FIFO_CTRL_FLUSH_BIT)
+#define FIFO_STATUS_COUNT_MASK  (uint32_t)(0x7FF << FIFO_STATUS_COUNT_LSB)
+#define FIFO_STATUS_OVF_MASK    (uint32_t)(0x01 << FIFO_STATUS_OVF_BIT)
+#define FIFO_WORD_SAMPLE_MASK   (uint32_t)0x0FFF
+#define FIFO_STATUS_DMA_BLOCK_MASK  (uint32_t)(0x01 << FIFO_STATUS_DMA_BLOCK_BIT)
+#define FIFO_STATUS_DMA_ERR_MASK    (uint32_t)(0x01 << FIFO_STATUS_DMA_ERR_BIT)
+#define FIFO_STATUS_DMA_DONE_MASK   (uint32_t)(0x01 << FIFO_STATUS_DMA_DONE_BIT)
+#define FIFO_STATUS_DMA_STALL_MASK  (uint32_t)(0x01 << FIFO_STATUS_DMA_STALL_BIT)
+#define FIFO_STATUS_DMA_EVENT_MASK  (FIFO_STATUS_DMA_BLOCK_MASK | FIFO_STATUS_DMA_ERR_MASK | FIFO_STATUS_DMA_DONE_MASK | FIFO_STATUS_OVF_MASK)
+#define FIFO_STATUS_TRIG_MASK   (uint32_t)(0x01 << FIFO_STATUS_TRIG_BIT)
+#define DMA_CTRL_EN_MASK        (uint32_t)(0x01 << DMA_CTRL_EN_BIT)
+#define DMA_CTRL_RESET_MASK     (uint32_t)(0x01 << DMA_CTRL_RESET_BIT)
+#define TRIG_CTRL_EN_MASK       (uint32_t)(0x01 << TRIG_CTRL_EN_BIT)
+#define TRIG_CTRL_ARM_MASK      (uint32_t)(0x01 << TRIG_CTRL_ARM_BIT)
+#define TRIG_CTRL_FORCE_MASK    (uint32_t)(0x01 << TRIG_CTRL_FORCE_BIT)
+#define TRIG_CTRL_SOURCE_MASK   (uint32_t)(0x01 << TRIG_CTRL_SOURCE_BIT)
+#define TRIG_CTRL_MODE_MASK     (uint32_t)(0x03 << TRIG_CTRL_MODE_LSB)
+#define TRIG_SAMPLE_MASK        (uint32_t)0x0FFF
+#define TRIG_RECORD_MASK        (uint32_t)0x07FF
+#define TRIG_STATUS_INDEX_MASK  (uint32_t)(0x7FF << TRIG_STATUS_INDEX_LSB)
+#define TRIG_STATUS_STATE_MASK  (uint32_t)(0x03 << TRIG_STATUS_STATE_LSB)
+#define TRIG_STATUS_DONE_MASK   (uint32_t)(0x01 << TRIG_STATUS_DONE_BIT)
+#define CIC_CTRL_EN_MASK        (uint32_t)(0x01 << CIC_CTRL_EN_BIT)
+#define CIC_CTRL_ORDER_MASK     (uint32_t)(0x03 << CIC_CTRL_ORDER_LSB)
+#define CIC_CTRL_RATIO_MASK     (uint32_t)(0xFF << CIC_CTRL_RATIO_LSB)
+#define CIC_CTRL_SHIFT_MASK     (uint32_t)(0x1F << CIC_CTRL_SHIFT_LSB)
+#define CIC_WORD_SAMPLE_MASK    (uint32_t)0xFFFF
+//----------------------------- MACRO Functions ---------------------------------
+#define FIFO_WORD_A(Word)       (uint16_t)(((Word) >> FIFO_WORD_A_LSB) & FIFO_WORD_SAMPLE_MASK)     // Channel A of a FIFO / DMA ring word
+#define FIFO_WORD_B(Word)       (uint16_t)(((Word) >> FIFO_WORD_B_LSB) & FIFO_WORD_SAMPLE_MASK)     // Channel B of a FIFO / DMA ring word
+#define CIC_WORD_A(Word)        (uint16_t)(((Word) >> FIFO_CIC_A_LSB) & CIC_WORD_SAMPLE_MASK)       // Channel A of a decimated FIFO / DMA ring / DATA_AB word
+#define CIC_WORD_B(Word)        (uint16_t)(((Word) >> FIFO_CIC_B_LSB) & CIC_WORD_SAMPLE_MASK)       // Channel B of a decimated FIFO / DMA ring / DATA_AB word
 
 
 // TYPEDEFS AND ENUMS
+typedef enum
+{
+    ADC_TRIGGER_ABOVE = 0,                  // Sample >= Level
+    ADC_TRIGGER_RISING,                     // Below Level - Hysteresis, then >= Level
+    ADC_TRIGGER_FALLING,                    // Above Level + Hysteresis, then <= Level
+    ADC_TRIGGER_BELOW                       // Sample <= Level
+}Type_ADC_TriggerMode;
+
+typedef enum
+{
+    ADC_TRIGGER_SOURCE_A = 0,
+    ADC_TRIGGER_SOURCE_B
+}Type_ADC_TriggerSource;
+
+typedef enum
+{
+    ADC_TRIGGER_IDLE = 0,                   // Disarmed - no samples stored
+    ADC_TRIGGER_ARMED,                      // Pre-trigger ring filling / waiting for the condition
+    ADC_TRIGGER_POST,                       // Triggered - storing the post trigger samples
+    ADC_TRIGGER_DONE                        // Record complete, capture stopped
+}Type_ADC_TriggerState;
+
+typedef struct
+{
+    Type_ADC_TriggerSource  Source;
+    Type_ADC_TriggerMode    Mode;
+    uint16_t    Level;                      // ADC codes 0 to 4095
+    uint16_t    Hysteresis;                 // Edge modes: distance past Level the signal must go before an edge counts
+    uint32_t    Holdoff;                    // Samples after arming before a trigger is accepted (never less than PreSamples)
+    uint16_t    PreSamples;                 // Samples kept before the trigger sample
+    uint16_t    PostSamples;                // Samples from the trigger sample on - at least 1, Pre + Post <= IMR_ADC_FIFO_DEPTH
+}Type_ADC_TriggerConfig;
+
+typedef enum
+{
+    ADC_EVENT_CAPTURE_DONE = 0,             // Single / multi convert complete - Samples in ADC_Data_A / ADC_Data_B
+    ADC_EVENT_TRIGGER_RECORD,               // Triggered record complete - Samples in the record, TriggerIndex set
+    ADC_EVENT_DMA_DONE                      // DMA capture ended and every sample written - Samples is DmaBlockCount
+}Type_ADC_EventType;
+
+typedef struct
+{
+    Type_ADC_EventType  Type;
+    uint32_t    Samples;
+}Type_ADC_Event;
+
+typedef struct
+{
+    int16_t     Taps[IMR_ADC_CIC_COMP_TAPS];        // Q14, sum 1.0 (16384) - unity DC gain
+    uint16_t    History[IMR_ADC_CIC_COMP_TAPS];     // Last samples, carried across blocks
+    uint8_t     Index;                              // Oldest history entry
+}Type_ADC_CicCompensator;
+
 typedef struct
 {
     uint8_t     ClockDivider;
@@ -73,19 +270,75 @@ typedef struct
     uint32_t    ControlRegister;
     uint32_t    TotalConversions;
     uint32_t    ConversionCount;
+    uint32_t    SamplePeriod;               // SysClk cycles per sample, 0 = back to back
+    uint32_t    SampleRate;                 // Achieved Fs in Hz for SamplePeriod (0 = not paced)
+    bool        FifoEnabled;                // Samples delivered through the IP sample FIFO
+    uint16_t    FifoThreshold;              // IRQ fill level
+    uint32_t    FifoOverflowCount;          // Overflow IRQs seen - samples were lost
+    uint8_t     Sequence;                   // DATA_AB sequence number of the last sample read
+    uint32_t    SequenceErrorCount;         // Samples missed between DATA_AB reads
+    bool        Streaming;                  // Free running into the ring
+    uint16_t *  Ring_A;                     // Stream ring, RingSize samples per channel
+    uint16_t *  Ring_B;
+    uint32_t    RingSize;
+    uint32_t    RingWriteIndex;
+    volatile bool RingHalfReady[IMR_ADC_RING_HALVES];  // Set by the ISR when a half fills, cleared on release
+    uint8_t     RingNextHalf;               // Next half handed out to the consumer
+    uint32_t    RingOverrunCount;           // Halves refilled before they were released
+    bool        DmaEnabled;                 // The IP writes samples into the DMA ring itself
+    uint32_t *  DmaRing;                    // DMA ring, one FIFO word (A and B) per sample
+    uint32_t    DmaRingBytes;
+    uint32_t    DmaConsumer;                // Byte offset consumed up to - mirrors DMA_CONSUMER
+    uint32_t    DmaBlockCount;              // Block interrupts seen
+    uint32_t    DmaErrorCount;              // Bursts the interconnect answered with an error
+    bool        Triggering;                 // Armed capture: one interrupt per complete record
+    uint32_t    TriggerControl;             // TRIG_CTRL less the ARM / FORCE pulses
+    volatile bool TriggerRecordReady;       // Set by the ISR with the record in ADC_Data_A / ADC_Data_B
+    uint32_t    TriggerIndex;               // Record index of the trigger sample
+    bool        CicEnabled;                 // Continuous captures return 16 bit decimated samples
+    uint8_t     CicOrder;                   // 1 to IMR_ADC_CIC_MAX_ORDER
+    uint16_t    CicRatio;                   // Conversions per decimated sample, 1 = bypass
+    uint8_t     CicShift;                   // Output shift loaded - bit growth above 16 bits dropped
+    Type_ADC_Event EventQueue[IMR_ADC_EVENT_QUEUE_SIZE];   // Posted by the ISR, taken by IMR_ADC_7476A_X2_GetEvent
+    volatile uint8_t EventHead;             // Next slot the ISR writes - only the ISR moves it
+    volatile uint8_t EventTail;             // Next event for the main loop - only the main loop moves it
+    uint32_t    EventDropCount;             // Events lost to a full queue
 } Type_AXI_IMR_7476A_Handle;
 
 
 // FUNCTION PROTOTYPES
 bool init_IMR_ADC_7476A_X2(Type_AXI_IMR_7476A_Handle *IP_Handle, uint32_t IP_BaseAddress, uint8_t ClockDivider);
+bool IMR_ADC_7476A_X2_SetSampleRate(Type_AXI_IMR_7476A_Handle *IP_Handle, uint32_t RequestedRate, uint32_t *AchievedRate);
 bool IMR_ADC_7476A_X2_SingleConvert(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_t *BufferData_A, uint16_t *BufferData_B);
 bool IMR_ADC_7476A_X2_MultiConvert(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_t *BufferData_A, uint16_t *BufferData_B, uint32_t TotalConversions);
 void IMR_ADC_7476A_X2_ClrIrq(Type_AXI_IMR_7476A_Handle *IP_Handle);
+bool IMR_ADC_7476A_X2_GetEvent(Type_AXI_IMR_7476A_Handle *IP_Handle, Type_ADC_Event *Event);
+bool IMR_ADC_7476A_X2_EnableFifo(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_t Threshold);
+void IMR_ADC_7476A_X2_DisableFifo(Type_AXI_IMR_7476A_Handle *IP_Handle);
+uint32_t IMR_ADC_7476A_X2_DrainFifo(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_t *BufferData_A, uint16_t *BufferData_B, uint32_t MaxSamples);
+bool IMR_ADC_7476A_X2_StartStream(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_t *RingData_A, uint16_t *RingData_B, uint32_t RingSize);
+bool IMR_ADC_7476A_X2_StopStream(Type_AXI_IMR_7476A_Handle *IP_Handle);
+bool IMR_ADC_7476A_X2_GetRingHalf(Type_AXI_IMR_7476A_Handle *IP_Handle, uint16_t **HalfData_A, uint16_t **HalfData_B);
+void IMR_ADC_7476A_X2_ReleaseRingHalf(Type_AXI_IMR_7476A_Handle *IP_Handle);
+bool IMR_ADC_7476A_X2_StartDma(Type_AXI_IMR_7476A_Handle *IP_Handle, uint32_t *RingData, uint32_t RingBytes, uint32_t BlockBytes);
+bool IMR_ADC_7476A_X2_StopDma(Type_AXI_IMR_7476A_Handle *IP_Handle);
+uint32_t IMR_ADC_7476A_X2_GetDmaSamples(Type_AXI_IMR_7476A_Handle *IP_Handle, uint32_t **Samples);
+void IMR_ADC_7476A_X2_ReleaseDmaSamples(Type_AXI_IMR_7476A_Handle *IP_Handle, uint32_t SampleCount);
+bool IMR_ADC_7476A_X2_ArmTrigger(Type_AXI_IMR_7476A_Handle *IP_Handle, const Type_ADC_TriggerConfig *TriggerConfig, uint16_t *BufferData_A, uint16_t *BufferData_B);
+void IMR_ADC_7476A_X2_ForceTrigger(Type_AXI_IMR_7476A_Handle *IP_Handle);
+bool IMR_ADC_7476A_X2_DisarmTrigger(Type_AXI_IMR_7476A_Handle *IP_Handle);
+bool IMR_ADC_7476A_X2_SetDecimation(Type_AXI_IMR_7476A_Handle *IP_Handle, uint8_t Order, uint16_t Ratio);
+bool IMR_ADC_7476A_X2_InitCicCompensator(Type_ADC_CicCompensator *Compensator, uint8_t Order, uint16_t Ratio, float PassbandEdge);
+void IMR_ADC_7476A_X2_CicCompensate(Type_ADC_CicCompensator *Compensator, uint16_t *Samples, uint32_t SampleCount);
 uint32_t IMR_ADC_7476A_X2_GetCtrlReg(Type_AXI_IMR_7476A_Handle *IP_Handle);
 uint32_t IMR_ADC_7476A_X2_GetStatusReg(Type_AXI_IMR_7476A_Handle *IP_Handle);
 uint32_t IMR_ADC_7476A_X2_GetIrqReg(Type_AXI_IMR_7476A_Handle *IP_Handle);
 uint32_t IMR_ADC_7476A_X2_GetDataAReg(Type_AXI_IMR_7476A_Handle *IP_Handle);
 uint32_t IMR_ADC_7476A_X2_GetDataBReg(Type_AXI_IMR_7476A_Handle *IP_Handle);
+uint32_t IMR_ADC_7476A_X2_GetDataABReg(Type_AXI_IMR_7476A_Handle *IP_Handle);
+uint32_t IMR_ADC_7476A_X2_GetFifoStatusReg(Type_AXI_IMR_7476A_Handle *IP_Handle);
+uint32_t IMR_ADC_7476A_X2_GetDmaProducerReg(Type_AXI_IMR_7476A_Handle *IP_Handle);
+uint32_t IMR_ADC_7476A_X2_GetTriggerStatusReg(Type_AXI_IMR_7476A_Handle *IP_Handle);
 
 
 #ifdef __cplusplus
@@ -34,6 +34,11 @@
 #include "AXI_SPI_Display_SSD1309.h"
 #include "Hab_Types.h"
 #include "u8g2.h"
+#include "Display_Spectrum.h"
+#include "diskio_timing.h"
+#include "xil_printf.h"
+#include "xspi_l.h"
+#include "xil_io.h"
 #include <string.h>
 
 void *U8G2_UserPointer;
@@ -43,6 +48,11 @@ static void *getUserPointer_U8G2(void);
 static uint8_t U8G2_WriteBytes_SPI(u8x8_t *U8X8, uint8_t Msg, uint8_t ArgInt, void *ArgPtr);
 static uint8_t U8G2_GPIO_DelayControl(u8x8_t *U8X8, uint8_t Msg, uint8_t ArgInt, void *ArgPtr);
 static void displaySegmented_SPI_Transfer(Type_Display_SSD1309 *SSD1309, uint8_t *DataPtr, uint32_t DataLength);
+static void displayFast_SPI_Transfer(Type_Display_SSD1309 *SSD1309, const uint8_t *DataPtr, uint32_t DataLength);
+static uint32_t displayBuildDirtyRuns(Type_Display_SSD1309 *Display_SSD1309);
+static bool displayPushLoadFIFO(Type_Display_SSD1309 *Display_SSD1309);
+static void displayPushStep(Type_Display_SSD1309 *Display_SSD1309);
+static void displayGovernorPushDone(Type_Display_SSD1309 *Display_SSD1309);
 
 
 /********************************************************************************************************
@@ -68,7 +78,7 @@ static void displaySegmented_SPI_Transfer(Type_Display_SSD1309 *SSD1309, uint8_t
 * STEP 1: Basic test
 * STEP 2: Load struct members
 * STEP 3: Reset the display
-* STEP 4: Init the display driver
+* STEP 4: Init the display driver - draw into the handle's word aligned frame buffer
 ********************************************************************************************************/
 bool init_Display_SSD1309(Type_Display_SSD1309 *Display_SSD1309, XSpi *QSPI_Handle, uint8_t ChipSelect_N, uint16_t FIFO_Depth, displayResetRunFunctionPtr displayResetRunFunction, displayCommandDataFunctionPtr displayCommandDataFunction, displayTxRxFunctionPtr displayTxRxFunction, displayChipSelectFunctionPtr displayChipSelectFunction, displaySleep_msFunctionPtr displaySleep_msFunction, displaySleep_10usFunctionPtr displaySleep_10usFunction, u8g2_t *U8G2_Object)
 {
@@ -87,15 +97,28 @@ bool init_Display_SSD1309(Type_Display_SSD1309 *Display_SSD1309, XSpi *QSPI_Hand
     Display_SSD1309->displaySleep_ms = displaySleep_msFunction;
     Display_SSD1309->displaySleep_10us = displaySleep_10usFunction;
     Display_SSD1309->U8G2_Handle = U8G2_Object;
+    Display_SSD1309->FastTransport = false;
+    Display_SSD1309->PushBusy = false;
+    Display_SSD1309->PushIrqMode = false;
+    Display_SSD1309->PushComplete = NULL;
+    Display_SSD1309->PushFrames = 0;
+    Display_SSD1309->DrawBuffer = 0;
+    Display_SSD1309->FrontBuffer = 0;
+    Display_SSD1309->DoubleBuffer = false;
+    memset(Display_SSD1309->FrameBuffer, 0x00, sizeof(Display_SSD1309->FrameBuffer));
+    memset(&Display_SSD1309->Governor, 0x00, sizeof(Display_SSD1309->Governor));
 
     // STEP 3: Reset the display
     Display_SSD1309->displayResetRun(DISPLAY_RESET);
     Display_SSD1309->displaySleep_ms(10);
     Display_SSD1309->displayResetRun(DISPLAY_RUN);
 
-    // STEP 4: Init the display driver
+    // STEP 4: Init the display driver - draw into the handle's word aligned frame buffer
     setUserPointer_U8G2(Display_SSD1309);
     u8g2_Setup_ssd1309_128x64_noname0_f(Display_SSD1309->U8G2_Handle, U8G2_R0, U8G2_WriteBytes_SPI, U8G2_GPIO_DelayControl);
+    Display_SSD1309->U8G2_Handle->tile_buf_ptr = (uint8_t *)Display_SSD1309->FrameBuffer[0];    // u8g2_SetBufferPtr is only built with U8G2_USE_DYNAMIC_ALLOC
+    u8g2_ClearBuffer(Display_SSD1309->U8G2_Handle);
+    Display_SSD1309->ShadowValid = false;
     // Critical for SSD1309:
     u8g2_InitDisplay(Display_SSD1309->U8G2_Handle);
     u8g2_SetPowerSave(Display_SSD1309->U8G2_Handle, 0);
@@ -200,8 +223,10 @@ static uint8_t U8G2_WriteBytes_SPI(u8x8_t *U8X8, uint8_t Msg, uint8_t ArgInt, vo
 
         case U8X8_MSG_BYTE_SEND:
         {
-            // SSD1309->displayTxRx(SSD1309->SPI_Handle, SSD1309->ChipSelectBitMask, (uint8_t *)ArgPtr, NULL, (uint32_t)ArgInt);
-            displaySegmented_SPI_Transfer(SSD1309, (uint8_t *)ArgPtr, (uint32_t)ArgInt);
+            if (SSD1309->FastTransport)
+                displayFast_SPI_Transfer(SSD1309, (const uint8_t *)ArgPtr, (uint32_t)ArgInt);
+            else
+                displaySegmented_SPI_Transfer(SSD1309, (uint8_t *)ArgPtr, (uint32_t)ArgInt);
             return(1);
         }
         break;
@@ -312,7 +337,7 @@ static uint8_t U8G2_GPIO_DelayControl(u8x8_t *U8X8, uint8_t Msg, uint8_t ArgInt,
 * @param   DataLength   Lenght of data in bytes to transmit
 *
 * STEP 1: If data lenght can fit with in the FIFO buffer no need to segment
-* STEP 2: Data lenght beyond FIFO buffer - segmented trasmission
+* STEP 2: Data lenght beyond FIFO buffer - segmented trasmission straight from the caller's buffer
 ********************************************************************************************************/
 static void displaySegmented_SPI_Transfer(Type_Display_SSD1309 *SSD1309, uint8_t *DataPtr, uint32_t DataLength)
 {
@@ -323,12 +348,10 @@ static void displaySegmented_SPI_Transfer(Type_Display_SSD1309 *SSD1309, uint8_t
         return;
     }
 
-    // STEP 2: Data lenght beyond FIFO buffer - segmented trasmission
-    uint8_t DataBuffer[SSD1309->FIFO_BufferDepth];
-    uint8_t DataOffset = 0;
-    uint8_t BytesTransmitted = 0;
-    uint8_t BytesRemaining;
-    uint8_t BytesToTransmit;
+    // STEP 2: Data lenght beyond FIFO buffer - segmented trasmission straight from the caller's buffer
+    uint32_t BytesTransmitted = 0;
+    uint32_t BytesRemaining;
+    uint32_t BytesToTransmit;
     do 
     {
         // Determine Bytes remaining to send
@@ -337,18 +360,685 @@ static void displaySegmented_SPI_Transfer(Type_Display_SSD1309 *SSD1309, uint8_t
             BytesToTransmit = SSD1309->FIFO_BufferDepth;
         else
             BytesToTransmit = BytesRemaining;
-        // Copy upto the FIFP depth bytes to transmit and transmit
-        memcpy(DataBuffer, &DataPtr[DataOffset], BytesToTransmit);
-        SSD1309->displayTxRx(SSD1309->SPI_Handle, SSD1309->ChipSelectBitMask, DataBuffer, NULL, BytesToTransmit);
-        // Update the Buffer poniter, bytes transmitted and test if done
-        DataOffset += BytesToTransmit;
+        // Transmit upto the FIFO depth bytes and test if done
+        SSD1309->displayTxRx(SSD1309->SPI_Handle, SSD1309->ChipSelectBitMask, &DataPtr[BytesTransmitted], NULL, BytesToTransmit);
         BytesTransmitted += BytesToTransmit;    
     }while (BytesTransmitted < DataLength);
 
 } // END OF displaySegmented_SPI_Transfer
+
+
+
+/********************************************************************************************************
+* @brief Selects the display transport.  The fast transport configures the Quad SPI once (master, manual
+* slave select held asserted, interrupts off, transfers enabled) so each transfer is nothing but register
+* writes.  The default transport calls displayTxRx, which reconfigures the SPI for every segment.
+*
+* @author original: Hab Collector \n
+*
+* @note: Display must be init before use
+* @note: The fast transport owns the Quad SPI - any call to displayTxRx (or other XSpi API use) reconfigures
+* the SPI and must be followed by displaySetFastTransport(true) before the next display push
+* 
+* @param   Display_SSD1309      Pointer to display handle
+* @param   Enable               True: fast register level transport, False: displayTxRx per segment
+*
+* @return True if the transport was set
+*
+* STEP 1: Default transport - nothing to configure
+* STEP 2: One time SPI configuration: master, manual slave select, polled
+* STEP 3: Assert the slave select and release the master inhibit - stays this way between transfers
+********************************************************************************************************/
+bool displaySetFastTransport(Type_Display_SSD1309 *Display_SSD1309, bool Enable)
+{
+    XSpi *SPI_Handle = Display_SSD1309->SPI_Handle;
+
+    // STEP 1: Default transport - nothing to configure
+    Display_SSD1309->FastTransport = false;
+    if (!Enable)
+        return(true);
+    if (Display_SSD1309->FIFO_BufferDepth == 0)
+        return(false);
+
+    // STEP 2: One time SPI configuration: master, manual slave select, polled
+    XSpi_Reset(SPI_Handle);
+    if (XSpi_SetOptions(SPI_Handle, XSP_MASTER_OPTION | XSP_MANUAL_SSELECT_OPTION) != XST_SUCCESS)
+        return(false);
+    if (XSpi_SetSlaveSelect(SPI_Handle, Display_SSD1309->ChipSelectBitMask) != XST_SUCCESS)
+        return(false);
+    if (XSpi_Start(SPI_Handle) != XST_SUCCESS)
+        return(false);
+    XSpi_IntrGlobalDisable(SPI_Handle);
+
+    // STEP 3: Assert the slave select and release the master inhibit - stays this way between transfers
+    Xil_Out32(SPI_Handle->BaseAddr + XSP_SSR_OFFSET, SPI_Handle->SlaveSelectReg);
+    Xil_Out32(SPI_Handle->BaseAddr + XSP_CR_OFFSET, Xil_In32(SPI_Handle->BaseAddr + XSP_CR_OFFSET) & ~XSP_CR_TRANS_INHIBIT_MASK);
+    Display_SSD1309->FastTransport = true;
+    return(true);
+
+} // END OF displaySetFastTransport
+
+
+
+/********************************************************************************************************
+* @brief Fast transport: streams the caller's buffer into the TX FIFO keeping at most a FIFO depth of bytes
+* in flight, and drains the RX FIFO as bytes complete.  Returns only when every byte has been shifted out,
+* so the caller can change D/C or CS straight after.
+*
+* @author original: Hab Collector \n
+*
+* @note: Requires displaySetFastTransport(true)
+* @note: Any length - no segment copies and no SPI reconfiguration
+* 
+* @param   SSD1309      Pointer to the  handle
+* @param   DataPtr      Pointer to the data to transmit
+* @param   DataLength   Lenght of data in bytes to transmit
+*
+* STEP 1: Top up the TX FIFO without exceeding its depth
+* STEP 2: Count completed bytes off the RX FIFO
+********************************************************************************************************/
+static void displayFast_SPI_Transfer(Type_Display_SSD1309 *SSD1309, const uint8_t *DataPtr, uint32_t DataLength)
+{
+    UINTPTR BaseAddress = SSD1309->SPI_Handle->BaseAddr;
+    uint32_t BytesSent = 0;
+    uint32_t BytesDone = 0;
+
+    while (BytesDone < DataLength)
+    {
+        // STEP 1: Top up the TX FIFO without exceeding its depth
+        while ((BytesSent < DataLength) && ((BytesSent - BytesDone) < SSD1309->FIFO_BufferDepth))
+            Xil_Out32(BaseAddress + XSP_DTR_OFFSET, DataPtr[BytesSent++]);
+
+        // STEP 2: Count completed bytes off the RX FIFO
+        while (!(Xil_In32(BaseAddress + XSP_SR_OFFSET) & XSP_SR_RX_EMPTY_MASK))
+        {
+            (void)Xil_In32(BaseAddress + XSP_DRR_OFFSET);
+            BytesDone++;
+        }
+    }
+
+} // END OF displayFast_SPI_Transfer
     
 
 
+/********************************************************************************************************
+* @brief Compares the front frame buffer with a shadow copy of what the panel shows, 32 bits at a time, and lists
+* every run of adjacent changed 8x8 tiles per page.  The shadow is updated to the frame as it goes, so on
+* return it holds exactly what is about to be sent - the snapshot the transfer reads from.
+*
+* @author original: Hab Collector \n
+*
+* @note: No valid shadow (first push / displayInvalidateShadow) lists every page as one full width run
+* 
+* @param   Display_SSD1309      Pointer to display handle
+*
+* @return Number of tiles listed in the runs
+*
+* STEP 1: No valid shadow - full frame
+* STEP 2: Build the dirty tile map one page at a time
+* STEP 3: Convert the map to runs and update the shadow
+********************************************************************************************************/
+static uint32_t displayBuildDirtyRuns(Type_Display_SSD1309 *Display_SSD1309)
+{
+    uint32_t *Frame = Display_SSD1309->FrameBuffer[Display_SSD1309->FrontBuffer];
+    uint32_t *Shadow = Display_SSD1309->ShadowFrame;
+    uint32_t TileCount = 0;
+
+    Display_SSD1309->RunCount = 0;
+    for (uint8_t Page = 0; Page < DISPLAY_PAGE_COUNT; Page++)
+    {
+        // STEP 1: No valid shadow - full frame
+        uint32_t PageWord = Page * (DISPLAY_PAGE_BYTES / sizeof(uint32_t));
+        uint16_t DirtyMap = 0;
+        if (!Display_SSD1309->ShadowValid)
+        {
+            DirtyMap = 0xFFFF;
+        }
+        // STEP 2: Build the dirty tile map one page at a time
+        else
+        {
+            for (uint32_t Word = 0; Word < (DISPLAY_PAGE_BYTES / sizeof(uint32_t)); Word++)
+            {
+                if (Frame[PageWord + Word] != Shadow[PageWord + Word])
+                    DirtyMap |= (uint16_t)(1U << (Word / DISPLAY_TILE_WORDS));
+            }
+        }
+        Display_SSD1309->DirtyMap[Page] = DirtyMap;
+
+        // STEP 3: Convert the map to runs and update the shadow
+        uint8_t Tile = 0;
+        while (DirtyMap != 0)
+        {
+            while (!(DirtyMap & 0x01))
+            {
+                DirtyMap >>= 1;
+                Tile++;
+            }
+            uint8_t RunStart = Tile;
+            while (DirtyMap & 0x01)
+            {
+                DirtyMap >>= 1;
+                Tile++;
+            }
+            Type_DisplayRun *Run = &Display_SSD1309->Runs[Display_SSD1309->RunCount++];
+            Run->Page = Page;
+            Run->Tile = RunStart;
+            Run->TileCount = Tile - RunStart;
+            memcpy(&Shadow[PageWord + (RunStart * DISPLAY_TILE_WORDS)], &Frame[PageWord + (RunStart * DISPLAY_TILE_WORDS)], Run->TileCount * 8U);
+            TileCount += Run->TileCount;
+        }
+    }
+    Display_SSD1309->ShadowValid = true;
+    return(TileCount);
+
+} // END OF displayBuildDirtyRuns
+
+
+
+/********************************************************************************************************
+* @brief Sends only the parts of the frame that changed since the last push.  The frame buffer is compared
+* with a shadow copy of what the panel shows, 32 bits at a time; every 8x8 tile with a difference is marked
+* in a per page dirty map and each run of adjacent dirty tiles goes out as one u8g2_UpdateDisplayArea.  Push
+* time therefore follows how much of the screen moved rather than the screen size.
+*
+* @author original: Hab Collector \n
+*
+* @note: Display must be init before use
+* @note: Use in place of u8g2_SendBuffer.  Anything else that writes the panel (u8g2_SendBuffer, clear display,
+* power save) must be followed by displayInvalidateShadow so the next push is a full frame
+* @note: Blocking - waits for a background push (displayPushFrameAsync) to finish first
+* @note: Double buffered (displaySetDoubleBuffer) the front buffer is sent - displaySwapBuffers first
+* 
+* @param   Display_SSD1309      Pointer to display handle
+*
+* @return Number of tiles sent (0 - 128)
+*
+* STEP 1: Let a background push finish - it reads the shadow
+* STEP 2: List the changed tile runs
+* STEP 3: Send each run from the u8g2 buffer
+********************************************************************************************************/
+uint32_t displaySendChanged(Type_Display_SSD1309 *Display_SSD1309)
+{
+    // STEP 1: Let a background push finish - it reads the shadow
+    while (Display_SSD1309->PushBusy)
+    {
+        if (!Display_SSD1309->PushIrqMode)
+            displayPushService(Display_SSD1309);
+    }
+
+    // STEP 2: List the changed tile runs
+    Display_SSD1309->TilesSent = displayBuildDirtyRuns(Display_SSD1309);
+
+    // STEP 3: Send each run from the u8g2 buffer
+    for (uint8_t RunIndex = 0; RunIndex < Display_SSD1309->RunCount; RunIndex++)
+    {
+        Type_DisplayRun *Run = &Display_SSD1309->Runs[RunIndex];
+        u8g2_UpdateDisplayArea(Display_SSD1309->U8G2_Handle, Run->Tile, Run->Page, Run->TileCount, 1);
+    }
+    return(Display_SSD1309->TilesSent);
+
+} // END OF displaySendChanged
+
+
+
+/********************************************************************************************************
+* @brief Loads the next phase of a background push into the TX FIFO.  A run goes out as two phases: the 3
+* byte column / page address command with D/C low, then the run's tile bytes from the shadow with D/C high.
+* D/C is only changed once the previous phase has fully shifted out (DTR empty).
+*
+* @author original: Hab Collector \n
+*
+* @note: Called at push start and from displayPushStep - never while bytes are in flight
+* @note: IISR bits toggle on write - the DTR empty flag is acknowledged by writing back only the bit as read, so
+* an already clear flag is never set by the write
+* 
+* @param   Display_SSD1309      Pointer to display handle
+*
+* @return False when every run has been sent
+*
+* STEP 1: Current phase finished - command phase moves on to its data, data phase to the next run
+* STEP 2: Refill up to the FIFO depth
+********************************************************************************************************/
+static bool displayPushLoadFIFO(Type_Display_SSD1309 *Display_SSD1309)
+{
+    UINTPTR BaseAddress = Display_SSD1309->SPI_Handle->BaseAddr;
+
+    // STEP 1: Current phase finished - command phase moves on to its data, data phase to the next run
+    if (Display_SSD1309->PushRemaining == 0)
+    {
+        Type_DisplayRun *Run;
+        if (Display_SSD1309->PushPhase == DISPLAY_COMMAND)
+        {
+            Run = &Display_SSD1309->Runs[Display_SSD1309->PushRun];
+            Display_SSD1309->PushPtr = (const uint8_t *)Display_SSD1309->ShadowFrame + (Run->Page * DISPLAY_PAGE_BYTES) + (Run->Tile * 8U);
+            Display_SSD1309->PushRemaining = Run->TileCount * 8U;
+            Display_SSD1309->PushPhase = DISPLAY_DATA;
+        }
+        else
+        {
+            if (++Display_SSD1309->PushRun >= Display_SSD1309->RunCount)
+                return(false);
+            Run = &Display_SSD1309->Runs[Display_SSD1309->PushRun];
+            uint8_t X = (Run->Tile * 8U) + u8g2_GetU8x8(Display_SSD1309->U8G2_Handle)->x_offset;
+            Display_SSD1309->PushCommand[0] = 0x10 | (X >> 4);
+            Display_SSD1309->PushCommand[1] = 0x00 | (X & 0x0F);
+            Display_SSD1309->PushCommand[2] = 0xB0 | Run->Page;
+            Display_SSD1309->PushPtr = Display_SSD1309->PushCommand;
+            Display_SSD1309->PushRemaining = sizeof(Display_SSD1309->PushCommand);
+            Display_SSD1309->PushPhase = DISPLAY_COMMAND;
+        }
+        Display_SSD1309->displayCommandData(Display_SSD1309->PushPhase);
+    }
+
+    // STEP 2: Refill up to the FIFO depth
+    uint32_t BytesToLoad = (Display_SSD1309->PushRemaining < Display_SSD1309->FIFO_BufferDepth) ? Display_SSD1309->PushRemaining : Display_SSD1309->FIFO_BufferDepth;
+    Xil_Out32(BaseAddress + XSP_CR_OFFSET, Xil_In32(BaseAddress + XSP_CR_OFFSET) | XSP_CR_RXFIFO_RESET_MASK);
+    Xil_Out32(BaseAddress + XSP_IISR_OFFSET, Xil_In32(BaseAddress + XSP_IISR_OFFSET) & XSP_INTR_TX_EMPTY_MASK);
+    for (uint32_t Index = 0; Index < BytesToLoad; Index++)
+        Xil_Out32(BaseAddress + XSP_DTR_OFFSET, Display_SSD1309->PushPtr[Index]);
+    Display_SSD1309->PushPtr += BytesToLoad;
+    Display_SSD1309->PushRemaining -= BytesToLoad;
+    return(true);
+
+} // END OF displayPushLoadFIFO
+
+
+
+/********************************************************************************************************
+* @brief Starts a background push of the changed parts of the frame and returns at once.  The changed
+* tiles are snapshot into the shadow frame, so drawing of the next frame can start immediately; the
+* Quad SPI DTR empty interrupt (or displayPushService) then feeds the FIFO run by run.
+*
+* @author original: Hab Collector \n
+*
+* @note: Requires displaySetFastTransport(true)
+* @note: Frame in flight guard - returns false while the previous push is still going out.  No other display
+* access (u8g2 commands, displaySendChanged) may be made until the push completes
+* 
+* @param   Display_SSD1309      Pointer to display handle
+*
+* @return True if the push was started (or there was nothing to send), False if busy or not set up
+*
+* STEP 1: One frame in flight at a time
+* STEP 2: Snapshot the changed runs
+* STEP 3: Select the display and load the first command
+* STEP 4: Hand over to the interrupt
+********************************************************************************************************/
+bool displayPushFrameAsync(Type_Display_SSD1309 *Display_SSD1309)
+{
+    // STEP 1: One frame in flight at a time
+    if (Display_SSD1309->PushBusy || !Display_SSD1309->FastTransport)
+        return(false);
+
+    // STEP 2: Snapshot the changed runs
+    Display_SSD1309->TilesSent = displayBuildDirtyRuns(Display_SSD1309);
+    if (Display_SSD1309->RunCount == 0)
+    {
+        if (Display_SSD1309->PushComplete != NULL)
+            Display_SSD1309->PushComplete(Display_SSD1309);
+        return(true);
+    }
+
+    // STEP 3: Select the display and load the first command
+    Display_SSD1309->PushBusy = true;
+    Display_SSD1309->PushRun = 0xFF;
+    Display_SSD1309->PushRemaining = 0;
+    Display_SSD1309->PushPhase = DISPLAY_DATA;
+    Display_SSD1309->display_CS(CS_ENABLE);
+    displayPushLoadFIFO(Display_SSD1309);
+
+    // STEP 4: Hand over to the interrupt
+    if (Display_SSD1309->PushIrqMode)
+    {
+        XSpi_IntrEnable(Display_SSD1309->SPI_Handle, XSP_INTR_TX_EMPTY_MASK);
+        XSpi_IntrGlobalEnable(Display_SSD1309->SPI_Handle);
+    }
+    return(true);
+
+} // END OF displayPushFrameAsync
+
+
+
+/********************************************************************************************************
+* @brief Background push engine step: once the bytes in the FIFO have shifted out, loads the next bytes or
+* phase, and completes the push after the last run
+*
+* @author original: Hab Collector \n
+*
+* @note: Runs from displayPush_ISR or displayPushService
+* 
+* @param   Display_SSD1309      Pointer to display handle
+*
+* STEP 1: Nothing to do until the FIFO has fully shifted out
+* STEP 2: Next bytes / phase
+* STEP 3: Last run done - release the display and signal completion
+********************************************************************************************************/
+static void displayPushStep(Type_Display_SSD1309 *Display_SSD1309)
+{
+    // STEP 1: Nothing to do until the FIFO has fully shifted out
+    if (!Display_SSD1309->PushBusy)
+        return;
+    if (!(Xil_In32(Display_SSD1309->SPI_Handle->BaseAddr + XSP_IISR_OFFSET) & XSP_INTR_TX_EMPTY_MASK))
+        return;
+
+    // STEP 2: Next bytes / phase
+    if (displayPushLoadFIFO(Display_SSD1309))
+        return;
+
+    // STEP 3: Last run done - release the display and signal completion
+    UINTPTR BaseAddress = Display_SSD1309->SPI_Handle->BaseAddr;
+    Xil_Out32(BaseAddress + XSP_IISR_OFFSET, Xil_In32(BaseAddress + XSP_IISR_OFFSET) & XSP_INTR_TX_EMPTY_MASK);
+    if (Display_SSD1309->PushIrqMode)
+    {
+        XSpi_IntrGlobalDisable(Display_SSD1309->SPI_Handle);
+        XSpi_IntrDisable(Display_SSD1309->SPI_Handle, XSP_INTR_TX_EMPTY_MASK);
+    }
+    Display_SSD1309->display_CS(CS_DISABLE);
+    Display_SSD1309->PushFrames++;
+    displayGovernorPushDone(Display_SSD1309);
+    Display_SSD1309->PushBusy = false;
+    if (Display_SSD1309->PushComplete != NULL)
+        Display_SSD1309->PushComplete(Display_SSD1309);
+
+} // END OF displayPushStep
+
+
+
+/********************************************************************************************************
+* @brief Quad SPI interrupt handler for the background push - connect with connectPeripheral_IRQ using
+* DISPLAY_SPI_FABRIC_ID and the display handle as the callback reference
+*
+* @author original: Hab Collector \n
+*
+* @note: Completion callback runs in interrupt context
+* 
+* @param   CallbackRef      Display handle
+********************************************************************************************************/
+void displayPush_ISR(void *CallbackRef)
+{
+    displayPushStep((Type_Display_SSD1309 *)CallbackRef);
+}
+
+
+
+/********************************************************************************************************
+* @brief Polled background push - call from the main loop when the display SPI interrupt is not connected
+*
+* @author original: Hab Collector \n
+*
+* @param   Display_SSD1309      Pointer to display handle
+********************************************************************************************************/
+void displayPushService(Type_Display_SSD1309 *Display_SSD1309)
+{
+    displayPushStep(Display_SSD1309);
+}
+
+
+
+/********************************************************************************************************
+* @brief Configures the background push: interrupt or polled and the completion callback
+*
+* @author original: Hab Collector \n
+*
+* @note: Only change while no push is in flight
+* 
+* @param   Display_SSD1309      Pointer to display handle
+* @param   IrqMode              True: displayPush_ISR is connected, False: displayPushService is called
+* @param   PushComplete         Called when a push completes (NULL for none) - poll displayIsPushBusy instead
+********************************************************************************************************/
+void displaySetPushMode(Type_Display_SSD1309 *Display_SSD1309, bool IrqMode, displayPushCompleteFunctionPtr PushComplete)
+{
+    Display_SSD1309->PushIrqMode = IrqMode;
+    Display_SSD1309->PushComplete = PushComplete;
+}
+
+
+
+/********************************************************************************************************
+* @brief Frame in flight test
+*
+* @author original: Hab Collector \n
+*
+* @param   Display_SSD1309      Pointer to display handle
+*
+* @return True while a background push is going out
+********************************************************************************************************/
+bool displayIsPushBusy(Type_Display_SSD1309 *Display_SSD1309)
+{
+    return(Display_SSD1309->PushBusy);
+}
+
+
+/********************************************************************************************************
+* @brief Selects single or double buffered drawing.  Double buffered, u8g2 draws into the back buffer while
+* the pushes send the front buffer; displaySwapBuffers makes the finished back buffer the front
+*
+* @author original: Hab Collector \n
+*
+* @note: Only change while no push is in flight.  Both buffers start as a copy of the current frame
+* 
+* @param   Display_SSD1309      Pointer to display handle
+* @param   Enable               True: two frame buffers, False: draw and push share one
+********************************************************************************************************/
+void displaySetDoubleBuffer(Type_Display_SSD1309 *Display_SSD1309, bool Enable)
+{
+    uint8_t Current = Display_SSD1309->DrawBuffer;
+
+    Display_SSD1309->DoubleBuffer = Enable;
+    Display_SSD1309->FrontBuffer = Current;
+    Display_SSD1309->DrawBuffer = Enable ? (Current ^ 0x01) : Current;
+    if (Enable)
+        memcpy(Display_SSD1309->FrameBuffer[Display_SSD1309->DrawBuffer], Display_SSD1309->FrameBuffer[Current], DISPLAY_FRAME_BYTES);
+    Display_SSD1309->U8G2_Handle->tile_buf_ptr = (uint8_t *)Display_SSD1309->FrameBuffer[Display_SSD1309->DrawBuffer];
+}
+
+
+
+/********************************************************************************************************
+* @brief Makes the finished draw buffer the front buffer (the next push sends it) and hands u8g2 the other
+* buffer to draw the next frame into
+*
+* @author original: Hab Collector \n
+*
+* @note: Safe while a push is in flight - the push sends its snapshot in the shadow frame, not the front buffer
+* @note: No effect when single buffered
+* 
+* @param   Display_SSD1309      Pointer to display handle
+* @param   KeepContent          True: the new draw buffer starts as a copy of the frame just finished (for
+*                               drawing that adds to the last frame), False: left as is - redraw it fully
+********************************************************************************************************/
+void displaySwapBuffers(Type_Display_SSD1309 *Display_SSD1309, bool KeepContent)
+{
+    if (!Display_SSD1309->DoubleBuffer)
+        return;
+
+    Display_SSD1309->FrontBuffer = Display_SSD1309->DrawBuffer;
+    Display_SSD1309->DrawBuffer ^= 0x01;
+    if (KeepContent)
+        memcpy(Display_SSD1309->FrameBuffer[Display_SSD1309->DrawBuffer], Display_SSD1309->FrameBuffer[Display_SSD1309->FrontBuffer], DISPLAY_FRAME_BYTES);
+    Display_SSD1309->U8G2_Handle->tile_buf_ptr = (uint8_t *)Display_SSD1309->FrameBuffer[Display_SSD1309->DrawBuffer];
+}
+
+
+
+/********************************************************************************************************
+* @brief Configures the display frame rate governor and clears its statistics
+*
+* @author original: Hab Collector \n
+*
+* @note: The governor decouples the DSP frame rate from the display: each spectrum is offered with
+* displayGovernorOffer and is only rendered when the display can take it and the FPS cap allows
+* 
+* @param   Display_SSD1309      Pointer to display handle
+* @param   MaxFPS               Display update cap (0 = as fast as the display takes frames)
+* @param   Policy               What the caller should do with spectra that are not rendered
+********************************************************************************************************/
+void displaySetGovernor(Type_Display_SSD1309 *Display_SSD1309, uint32_t MaxFPS, Type_DisplayGovernPolicy Policy)
+{
+    Type_DisplayGovernor *Governor = &Display_SSD1309->Governor;
+
+    memset(Governor, 0x00, sizeof(Type_DisplayGovernor));
+    Governor->MinFrameInterval_us = (MaxFPS == 0) ? 0 : (1000000U / MaxFPS);
+    Governor->Policy = Policy;
+    Governor->FpsWindowTicks = disk_time_now();
+}
+
+
+
+/********************************************************************************************************
+* @brief Offers a new DSP frame to the display.  Returns whether to render it now, or to drop it or merge it
+* into the next rendered frame (per the governor policy) because a push is still in flight or the FPS cap
+* has not elapsed
+*
+* @author original: Hab Collector \n
+*
+* @note: On DISPLAY_FRAME_RENDER draw into the draw buffer and call displayGovernorCommit
+* @note: Services a polled background push so the caller's loop needs no separate call
+* 
+* @param   Display_SSD1309      Pointer to display handle
+*
+* @return Frame action: DISPLAY_FRAME_RENDER, DISPLAY_FRAME_DROP or DISPLAY_FRAME_MERGE
+*
+* STEP 1: Move a polled push along
+* STEP 2: Display busy or too soon - drop or merge
+* STEP 3: Accept - start the render timer
+********************************************************************************************************/
+Type_DisplayFrameAction displayGovernorOffer(Type_Display_SSD1309 *Display_SSD1309)
+{
+    Type_DisplayGovernor *Governor = &Display_SSD1309->Governor;
+
+    // STEP 1: Move a polled push along
+    Governor->Stats.FramesOffered++;
+    if (Display_SSD1309->PushBusy && !Display_SSD1309->PushIrqMode)
+        displayPushService(Display_SSD1309);
+
+    // STEP 2: Display busy or too soon - drop or merge
+    bool TooSoon = Governor->Started && (disk_time_elapsed_us(Governor->FrameStartTicks) < Governor->MinFrameInterval_us);
+    if (Display_SSD1309->PushBusy || TooSoon)
+    {
+        if (Governor->Policy == DISPLAY_GOVERN_MERGE)
+        {
+            Governor->Stats.FramesMerged++;
+            return(DISPLAY_FRAME_MERGE);
+        }
+        Governor->Stats.FramesDropped++;
+        return(DISPLAY_FRAME_DROP);
+    }
+
+    // STEP 3: Accept - start the render timer
+    Governor->FrameStartTicks = disk_time_now();
+    Governor->Started = true;
+    return(DISPLAY_FRAME_RENDER);
+
+} // END OF displayGovernorOffer
+
+
+
+/********************************************************************************************************
+* @brief Completes a frame accepted by displayGovernorOffer: swaps it to the front and pushes it - in the
+* background with the fast transport, otherwise blocking
+*
+* @author original: Hab Collector \n
+*
+* @param   Display_SSD1309      Pointer to display handle
+*
+* STEP 1: Render time
+* STEP 2: Finished frame to the front
+* STEP 3: Push - push time is taken when it completes
+********************************************************************************************************/
+void displayGovernorCommit(Type_Display_SSD1309 *Display_SSD1309)
+{
+    Type_DisplayGovernor *Governor = &Display_SSD1309->Governor;
+
+    // STEP 1: Render time
+    Governor->Stats.FramesRendered++;
+    Governor->Stats.RenderTime_us = disk_time_elapsed_us(Governor->FrameStartTicks);
+    if (Governor->Stats.RenderTime_us > Governor->Stats.MaxRenderTime_us)
+        Governor->Stats.MaxRenderTime_us = Governor->Stats.RenderTime_us;
+
+    // STEP 2: Finished frame to the front
+    displaySwapBuffers(Display_SSD1309, false);
+
+    // STEP 3: Push - push time is taken when it completes
+    Governor->PushStartTicks = disk_time_now();
+    if (Display_SSD1309->FastTransport)
+    {
+        displayPushFrameAsync(Display_SSD1309);
+        if (Display_SSD1309->RunCount == 0)
+            displayGovernorPushDone(Display_SSD1309);
+    }
+    else
+    {
+        displaySendChanged(Display_SSD1309);
+        displayGovernorPushDone(Display_SSD1309);
+    }
+
+} // END OF displayGovernorCommit
+
+
+
+/********************************************************************************************************
+* @brief Governor push statistics: push time and the achieved FPS window
+*
+* @author original: Hab Collector \n
+*
+* @note: Called from the push completion - may be in the ISR
+* 
+* @param   Display_SSD1309      Pointer to display handle
+********************************************************************************************************/
+static void displayGovernorPushDone(Type_Display_SSD1309 *Display_SSD1309)
+{
+    Type_DisplayGovernor *Governor = &Display_SSD1309->Governor;
+
+    Governor->Stats.PushTime_us = disk_time_elapsed_us(Governor->PushStartTicks);
+    if (Governor->Stats.PushTime_us > Governor->Stats.MaxPushTime_us)
+        Governor->Stats.MaxPushTime_us = Governor->Stats.PushTime_us;
+
+    Governor->FpsWindowFrames++;
+    uint32_t Window_us = disk_time_elapsed_us(Governor->FpsWindowTicks);
+    if (Window_us >= DISPLAY_FPS_WINDOW_US)
+    {
+        Governor->Stats.AchievedFPS_x10 = (uint32_t)(((uint64_t)Governor->FpsWindowFrames * 10000000U) / Window_us);
+        Governor->FpsWindowFrames = 0;
+        Governor->FpsWindowTicks = disk_time_now();
+    }
+}
+
+
+
+/********************************************************************************************************
+* @brief Prints the governor statistics for tuning the FPS cap and DSP frame rate
+*
+* @author original: Hab Collector \n
+*
+* @param   Display_SSD1309      Pointer to display handle
+********************************************************************************************************/
+void printDisplayGovernorReport(Type_Display_SSD1309 *Display_SSD1309)
+{
+    Type_DisplayGovernorStats *Stats = &Display_SSD1309->Governor.Stats;
+
+    xil_printf("Display: %d.%d FPS, %d offered, %d rendered, %d dropped, %d merged\r\n", Stats->AchievedFPS_x10 / 10, Stats->AchievedFPS_x10 % 10, Stats->FramesOffered, Stats->FramesRendered, Stats->FramesDropped, Stats->FramesMerged);
+    xil_printf("Display: render %d us (max %d), push %d us (max %d)\r\n", Stats->RenderTime_us, Stats->MaxRenderTime_us, Stats->PushTime_us, Stats->MaxPushTime_us);
+}
+
+
+
+/********************************************************************************************************
+* @brief Forces the next displaySendChanged to send the full frame
+*
+* @author original: Hab Collector \n
+*
+* @note: Call after anything that writes the panel outside of displaySendChanged
+* 
+* @param   Display_SSD1309      Pointer to display handle
+********************************************************************************************************/
+void displayInvalidateShadow(Type_Display_SSD1309 *Display_SSD1309)
+{
+    Display_SSD1309->ShadowValid = false;
+}
+
+
+
 /********************************************************************************************************
 * @brief Simple display test - clear the display and show Hello Hab in top left corner
 *
@@ -363,7 +1053,7 @@ void displaySimpleTest(Type_Display_SSD1309 *Display_SSD1309)
     u8g2_ClearBuffer(Display_SSD1309->U8G2_Handle);
     u8g2_SetFont(Display_SSD1309->U8G2_Handle, u8g2_font_5x8_tr);
     u8g2_DrawStr(Display_SSD1309->U8G2_Handle, 0, 10, "Hello Hab!");
-    u8g2_SendBuffer(Display_SSD1309->U8G2_Handle);
+    displaySendChanged(Display_SSD1309);
 }
 
 
@@ -374,7 +1064,7 @@ void displayTest_2(void)
 
     static uint8_t Y = 20;
     u8g2_DrawStr(SSD1309->U8G2_Handle, 10, Y, "Hello Hab Again!");
-    u8g2_SendBuffer(SSD1309->U8G2_Handle);
+    displaySendChanged(SSD1309);
     Y += 10;
 }
 
@@ -383,46 +1073,34 @@ void displayTest_2(void)
 void drawSpectrumMock(Type_Display_SSD1309 *Display_SSD1309)
 {
     // USER-ADJUSTABLE LOCAL CONSTANTS (self-contained)
-    uint8_t NumBars           = 16;     // Number of frequency columns
-    uint8_t SegmentsPerBar    = 10;     // Vertical resolution
-    uint8_t SegmentHeight     = 2;      // Height of each vertical block (pixels)
-    uint8_t SegmentVSpace     = 1;      // Space between vertical blocks
-    uint8_t BarWidth          = 4;      // Width of each bar (pixels)
-    uint8_t BarHSpace         = 2;      // Horizontal spacing between bars
-    uint8_t BaselineY         = 60;     // Vertical baseline position (SSD1309 is 64px tall)
-
-    // Pull U8G2 handle
-    u8g2_t *U = Display_SSD1309->U8G2_Handle;
-
-    // Clear screen
-    u8g2_ClearBuffer(U);
-
-    // Draw each bar
-    for (uint8_t BarIndex = 0; BarIndex < NumBars; BarIndex++)
+    static const Type_SpectrumConfig SpectrumConfig =
     {
-        // Random height: 0–SegmentsPerBar
-        uint8_t Value = rand() % (SegmentsPerBar + 1);
+        .NumBars        = 16,       // Number of frequency columns
+        .BarWidth       = 4,        // Width of each bar (pixels)
+        .BarHSpace      = 2,        // Horizontal spacing between bars
+        .X_Offset       = 0,
+        .BaselineY      = 60,       // Vertical baseline position (SSD1309 is 64px tall)
+        .SegmentHeight  = 2,        // Height of each vertical block (pixels)
+        .SegmentVSpace  = 1,        // Space between vertical blocks
+        .Levels         = 10,       // Vertical resolution
+    };
+    static Type_SpectrumBlitter SpectrumBlitter;
+    static bool BlitterReady = false;
+    uint8_t BarLevel[16];
+
+    if (!BlitterReady)
+        BlitterReady = initSpectrumBlitter(&SpectrumBlitter, &SpectrumConfig);
 
-        // Compute X position of this bar
-        uint8_t X_Position = BarIndex * (BarWidth + BarHSpace);
+    // Clear screen
+    u8g2_ClearBuffer(Display_SSD1309->U8G2_Handle);
 
-        // Draw vertical segments bottom → top
-        for (uint8_t SegmentIndex = 0; SegmentIndex < Value; SegmentIndex++)
-        {
-            uint8_t Y_Top = BaselineY
-                            - (SegmentIndex * (SegmentHeight + SegmentVSpace))
-                            - SegmentHeight;
-
-            u8g2_DrawBox(U,
-                         X_Position,
-                         Y_Top,
-                         BarWidth,
-                         SegmentHeight);
-        }
-    }
+    // Random height: 0–Levels, drawn straight into the frame buffer
+    for (uint8_t BarIndex = 0; BarIndex < SpectrumConfig.NumBars; BarIndex++)
+        BarLevel[BarIndex] = rand() % (SpectrumConfig.Levels + 1);
+    drawSpectrumBars(&SpectrumBlitter, Display_SSD1309->U8G2_Handle, BarLevel, NULL);
 
-    // Push to display
-    u8g2_SendBuffer(U);
+    // Push to display - only the bars that moved
+    displaySendChanged(Display_SSD1309);
 }
 
 
@@ -32,11 +32,29 @@ extern"C" {
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "xparameters.h"
 #include "xspi.h"
 #include "u8g2.h"
 #include "u8x8.h"
 
 // DEFINES
+// FRAME GEOMETRY - u8g2 full buffer, vertical_top_lsb: one byte = 8 vertical pixels, 128 bytes per page
+#define DISPLAY_TILE_WIDTH          16U                                         // 8x8 tiles across
+#define DISPLAY_PAGE_COUNT          8U                                          // 8 pixel high pages (tile rows)
+#define DISPLAY_PAGE_BYTES          (DISPLAY_TILE_WIDTH * 8U)
+#define DISPLAY_FRAME_BYTES         (DISPLAY_PAGE_BYTES * DISPLAY_PAGE_COUNT)
+#define DISPLAY_FRAME_WORDS         (DISPLAY_FRAME_BYTES / sizeof(uint32_t))
+#define DISPLAY_TILE_WORDS          (8U / sizeof(uint32_t))                     // 32 bit words per tile in a page
+#define DISPLAY_MAX_RUNS            (DISPLAY_PAGE_COUNT * DISPLAY_TILE_WIDTH / 2U)  // Worst case: every other tile changed
+// BACKGROUND PUSH - DISPLAY_SPI_FABRIC_ID is the INTC input of the display Quad SPI (axi_quad_spi_0) interrupt,
+// taken from xparameters.h.  It is only defined once that interrupt is routed to the INTC concat in the block
+// design and the platform is re-exported; until then run the push from the main loop with displayPushService
+#ifdef XPAR_FABRIC_AXI_QUAD_SPI_0_INTR
+#define DISPLAY_SPI_FABRIC_ID       XPAR_FABRIC_AXI_QUAD_SPI_0_INTR
+#endif
+// DOUBLE BUFFER AND GOVERNOR
+#define DISPLAY_FRAME_BUFFERS       2U                                          // Draw (back) and front - see displaySetDoubleBuffer
+#define DISPLAY_FPS_WINDOW_US       1000000U                                    // Achieved FPS measured over 1s
 
 
 // TYPEDEFES AND ENUMS
@@ -64,6 +82,52 @@ typedef bool (*displayTxRxFunctionPtr)(XSpi *, uint8_t, uint8_t *, uint8_t *, ui
 typedef void (*displaySleep_msFunctionPtr)(uint32_t);
 typedef void (*displaySleep_10usFunctionPtr)(uint32_t);
 typedef void (*displayChipSelectFunctionPtr)(Type_Display_CS);
+typedef void (*displayPushCompleteFunctionPtr)(void *);
+
+typedef struct
+{
+    uint8_t                         Page;                   // Tile row 0 - 7
+    uint8_t                         Tile;                   // First tile of the run 0 - 15
+    uint8_t                         TileCount;              // Tiles in the run
+}Type_DisplayRun;
+
+typedef enum
+{
+    DISPLAY_GOVERN_DROP = 0,                                // Frames offered while the display is busy are discarded
+    DISPLAY_GOVERN_MERGE                                    // ... are merged (peak hold) into the next rendered frame
+}Type_DisplayGovernPolicy;
+
+typedef enum
+{
+    DISPLAY_FRAME_RENDER = 0,                               // Render into the draw buffer then displayGovernorCommit
+    DISPLAY_FRAME_DROP,                                     // Display busy / FPS cap - discard this spectrum
+    DISPLAY_FRAME_MERGE                                     // Display busy / FPS cap - fold this spectrum into the next frame
+}Type_DisplayFrameAction;
+
+typedef struct
+{
+    uint32_t                        FramesOffered;          // DSP frames offered to the display
+    uint32_t                        FramesRendered;         // Frames committed for push
+    uint32_t                        FramesDropped;
+    uint32_t                        FramesMerged;
+    uint32_t                        AchievedFPS_x10;        // Pushed frames per second x 10, over DISPLAY_FPS_WINDOW_US
+    uint32_t                        RenderTime_us;          // Last offer to commit
+    uint32_t                        MaxRenderTime_us;
+    uint32_t                        PushTime_us;            // Last commit to push complete
+    uint32_t                        MaxPushTime_us;
+}Type_DisplayGovernorStats;
+
+typedef struct
+{
+    uint32_t                        MinFrameInterval_us;    // 1 / FPS cap (0 = uncapped)
+    Type_DisplayGovernPolicy        Policy;
+    uint32_t                        FrameStartTicks;        // Last frame accepted for render
+    uint32_t                        PushStartTicks;
+    uint32_t                        FpsWindowTicks;
+    uint32_t                        FpsWindowFrames;
+    bool                            Started;                // A frame has been accepted - FrameStartTicks valid
+    Type_DisplayGovernorStats       Stats;
+}Type_DisplayGovernor;
 
 typedef struct
 {
@@ -77,11 +141,46 @@ typedef struct
     displaySleep_msFunctionPtr      displaySleep_ms;        // Sleep function ms interval (blocking)
     displaySleep_10usFunctionPtr    displaySleep_10us;      // Sleep function 10us interval (blocking)
     u8g2_t                          *U8G2_Handle;           // Graphics Library Handle
+    uint32_t                        FrameBuffer[DISPLAY_FRAME_BUFFERS][DISPLAY_FRAME_WORDS];    // u8g2 frame buffers (word aligned for the tile compare)
+    uint8_t                         DrawBuffer;             // Frame buffer u8g2 draws into
+    uint8_t                         FrontBuffer;            // Frame buffer the pushes send (== DrawBuffer when single buffered)
+    bool                            DoubleBuffer;
+    uint32_t                        ShadowFrame[DISPLAY_FRAME_WORDS];   // Copy of what the display panel is showing
+    bool                            ShadowValid;            // False: next push sends the full frame
+    uint16_t                        DirtyMap[DISPLAY_PAGE_COUNT];       // Bit per tile of the last push (bit 0 = tile 0)
+    uint32_t                        TilesSent;              // Tiles sent by the last push
+    bool                            FastTransport;          // True: QSPI configured once, register level FIFO bursts
+    Type_DisplayRun                 Runs[DISPLAY_MAX_RUNS]; // Changed tile runs of the last push
+    uint8_t                         RunCount;
+    volatile bool                   PushBusy;               // Background push in flight - shadow frame in use
+    bool                            PushIrqMode;            // True: displayPush_ISR connected, False: displayPushService polled
+    uint8_t                         PushRun;                // Run being sent
+    Type_DisplayCommandData         PushPhase;              // Command (address) or data phase of the run
+    const uint8_t                   *PushPtr;               // Next byte to load into the FIFO
+    uint32_t                        PushRemaining;          // Bytes of the phase not yet loaded
+    uint8_t                         PushCommand[3];         // Column high, column low, page address
+    uint32_t                        PushFrames;             // Completed background pushes
+    displayPushCompleteFunctionPtr  PushComplete;           // Completion callback (display handle) - may run in the ISR
+    Type_DisplayGovernor            Governor;               // Display frame rate governor
 }Type_Display_SSD1309;
 
 
 // FUNCTION PROTOTYPES
 bool init_Display_SSD1309(Type_Display_SSD1309 *Display_SSD1309, XSpi *QSPI_Handle, uint8_t ChipSelect_N, uint16_t FIFO_Depth, displayResetRunFunctionPtr displayResetRunFunction, displayCommandDataFunctionPtr displayCommandDataFunction, displayTxRxFunctionPtr displayTxRxFunction, displayChipSelectFunctionPtr displayChipSelectFunction, displaySleep_msFunctionPtr displaySleep_msFunction, displaySleep_10usFunctionPtr displaySleep_10usFunction, u8g2_t *U8G2_Object);
+uint32_t displaySendChanged(Type_Display_SSD1309 *Display_SSD1309);
+void displayInvalidateShadow(Type_Display_SSD1309 *Display_SSD1309);
+bool displaySetFastTransport(Type_Display_SSD1309 *Display_SSD1309, bool Enable);
+bool displayPushFrameAsync(Type_Display_SSD1309 *Display_SSD1309);
+void displayPush_ISR(void *CallbackRef);
+void displayPushService(Type_Display_SSD1309 *Display_SSD1309);
+void displaySetPushMode(Type_Display_SSD1309 *Display_SSD1309, bool IrqMode, displayPushCompleteFunctionPtr PushComplete);
+bool displayIsPushBusy(Type_Display_SSD1309 *Display_SSD1309);
+void displaySetDoubleBuffer(Type_Display_SSD1309 *Display_SSD1309, bool Enable);
+void displaySwapBuffers(Type_Display_SSD1309 *Display_SSD1309, bool KeepContent);
+void displaySetGovernor(Type_Display_SSD1309 *Display_SSD1309, uint32_t MaxFPS, Type_DisplayGovernPolicy Policy);
+Type_DisplayFrameAction displayGovernorOffer(Type_Display_SSD1309 *Display_SSD1309);
+void displayGovernorCommit(Type_Display_SSD1309 *Display_SSD1309);
+void printDisplayGovernorReport(Type_Display_SSD1309 *Display_SSD1309);
 void displaySimpleTest(Type_Display_SSD1309 *Display_SSD1309);
 void displayTest_2(void);
 void drawSpectrumMock(Type_Display_SSD1309 *Display_SSD1309);
@@ -548,6 +548,132 @@ uint32_t unusedElements(Type_int16_t_CircularBuffer *CircularBuffer)
 
 
 
+/********************************************************************************************************
+* @brief Builds the FAT FS fast seek cluster link map for an open file.  The map lets the file's data be
+* located on the card without walking the FAT, which is what allows sectors to be read ahead directly via
+* the asynchronous block device.
+*
+* @author original: Hab Collector \n
+*
+* @note: Requires FF_USE_FASTSEEK = 1 (ffconf.h)
+* @note: The link map must stay valid (static or in the owning handle) for as long as the file is open
+* @note: Fragmented files need 2 DWORDs per fragment + 1 - FR_NOT_ENOUGH_CORE if the map is too small
+* 
+* @param FileHandle: Open file handle
+* @param LinkMap: Storage for the cluster link map table
+* @param LinkMapSize: Number of DWORD elements in LinkMap
+*
+* @return FR_OK if successful or a file specific error if not
+*
+* STEP 1: Attach the link map to the file
+* STEP 2: Have FAT FS fill in the cluster runs
+********************************************************************************************************/
+FRESULT init_FileLinkMap(FIL *FileHandle, DWORD *LinkMap, UINT LinkMapSize)
+{
+    // STEP 1: Attach the link map to the file
+    if ((FileHandle == NULL) || (LinkMap == NULL) || (LinkMapSize < 3))
+        return(FR_INVALID_PARAMETER);
+    LinkMap[0] = LinkMapSize;
+    FileHandle->cltbl = LinkMap;
+
+    // STEP 2: Have FAT FS fill in the cluster runs
+    FRESULT FileResult = f_lseek(FileHandle, CREATE_LINKMAP);
+    if (FileResult != FR_OK)
+        FileHandle->cltbl = NULL;
+    return(FileResult);
 
+} // END OF init_FileLinkMap
 
 
+
+/********************************************************************************************************
+* @brief Maps a byte offset within a file to the card sector holding it and returns how many sectors from
+* there on are physically contiguous (to the end of the current cluster run).
+*
+* @author original: Hab Collector \n
+*
+* @note: The file must have a link map - see init_FileLinkMap
+* 
+* @param FileHandle: Open file handle with link map
+* @param FileOffset: Byte offset in the file (sector aligned offsets avoid partial reads)
+* @param Sector: Card LBA of the sector holding FileOffset - returned by reference
+* @param SectorCount: Number of contiguous sectors starting at Sector - returned by reference
+*
+* @return True if the offset lies inside the file's mapped clusters
+*
+* STEP 1: Convert the offset into a cluster index and a sector within that cluster
+* STEP 2: Walk the cluster runs of the link map to find the physical cluster
+********************************************************************************************************/
+bool getFileSectorRun(FIL *FileHandle, FSIZE_t FileOffset, LBA_t *Sector, UINT *SectorCount)
+{
+    // STEP 1: Convert the offset into a cluster index and a sector within that cluster
+    if ((FileHandle == NULL) || (FileHandle->cltbl == NULL) || (FileOffset >= f_size(FileHandle)))
+        return(false);
+    FATFS *FileSystem = FileHandle->obj.fs;
+    DWORD ClusterIndex = (DWORD)(FileOffset / ((FSIZE_t)FileSystem->csize * FF_MAX_SS));
+    UINT SectorInCluster = (UINT)((FileOffset / FF_MAX_SS) % FileSystem->csize);
+
+    // STEP 2: Walk the cluster runs of the link map to find the physical cluster
+    DWORD *LinkMap = FileHandle->cltbl + 1;
+    while (LinkMap[0] != 0)
+    {
+        DWORD RunLength = LinkMap[0];
+        DWORD RunStart = LinkMap[1];
+        if (ClusterIndex < RunLength)
+        {
+            *Sector = FileSystem->database + ((LBA_t)(RunStart + ClusterIndex - 2) * FileSystem->csize) + SectorInCluster;
+            *SectorCount = ((RunLength - ClusterIndex) * FileSystem->csize) - SectorInCluster;
+            return(true);
+        }
+        ClusterIndex -= RunLength;
+        LinkMap += 2;
+    }
+    return(false);
+
+} // END OF getFileSectorRun
+
+
+
+/********************************************************************************************************
+* @brief Queues an asynchronous read of file data straight from the card so the caller can keep processing
+* (DSP) while the sectors arrive.  The request is clipped to the contiguous run holding FileOffset; call
+* again at the returned point for the remainder.
+*
+* @author original: Hab Collector \n
+*
+* @note: The file must have a link map - see init_FileLinkMap
+* @note: Reads bypass FAT FS buffering - use for files opened read only
+* @note: Callback runs from the SD engine (ISR in IRQ mode, else disk_async_service) - see diskio.h
+* 
+* @param FileHandle: Open file handle with link map
+* @param FileOffset: Sector aligned byte offset in the file to read from
+* @param Buffer: Destination - must hold SectorCount * FF_MAX_SS bytes and stay valid until the callback
+* @param SectorCount: Sectors wanted
+* @param Callback: Completion callback (Context, Result)
+* @param Context: User pointer handed to the callback
+*
+* @return Number of sectors queued (0 if nothing could be queued - queue full or offset invalid)
+*
+* STEP 1: Locate the contiguous sector run
+* STEP 2: Clip and submit the request
+********************************************************************************************************/
+UINT submitFileReadAhead(FIL *FileHandle, FSIZE_t FileOffset, BYTE *Buffer, UINT SectorCount, DiskAsyncCallback Callback, void *Context)
+{
+    LBA_t Sector;
+    UINT RunCount;
+
+    // STEP 1: Locate the contiguous sector run
+    if ((FileOffset % FF_MAX_SS) != 0)
+        return(0);
+    if (!getFileSectorRun(FileHandle, FileOffset, &Sector, &RunCount))
+        return(0);
+
+    // STEP 2: Clip and submit the request
+    if (SectorCount > RunCount)
+        SectorCount = RunCount;
+    if (disk_read_async(FileHandle->obj.fs->pdrv, Buffer, Sector, SectorCount, Callback, Context) != RES_OK)
+        return(0);
+    return(SectorCount);
+
+} // END OF submitFileReadAhead
+
@@ -34,6 +34,7 @@ extern"C" {
 #include <stdbool.h>
 #include "ff.h"
 #include "ffconf.h"
+#include "diskio.h"
 
 // DEFINES
 // DIRECTORY
@@ -171,6 +172,9 @@ bool isEmpty_CB(Type_int16_t_CircularBuffer *CircularBuffer);
 bool write_CB(Type_int16_t_CircularBuffer *CircularBuffer, int16_t *Element);
 bool read_CB(Type_int16_t_CircularBuffer *CircularBuffer, int16_t *Element, bool *CB_Half_Empty, bool *CB_Half_Full);
 uint32_t unusedElements(Type_int16_t_CircularBuffer *CircularBuffer);
+FRESULT init_FileLinkMap(FIL *FileHandle, DWORD *LinkMap, UINT LinkMapSize);
+bool getFileSectorRun(FIL *FileHandle, FSIZE_t FileOffset, LBA_t *Sector, UINT *SectorCount);
+UINT submitFileReadAhead(FIL *FileHandle, FSIZE_t FileOffset, BYTE *Buffer, UINT SectorCount, DiskAsyncCallback Callback, void *Context);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,372 @@
+/******************************************************************************************************
+ * @file            Capture_Recorder.c
+ * @brief           Sustained rate recorder of ADC captures (MODE_SIGNAL) to WAV files on the SD card
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        <Xilinx Artix A7> \n
+ * IDE:             Vitis 2024.2 \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            The associated header file provides MACRO functions for IO control
+ *
+ *                  This is an embedded application
+ *                  It will be necessary to consult the reference documents to fully understand the code
+ *                  It is suggested that the documents be reviewed in the order shown.
+ *                    Schematic: 
+ *                    IMR Engineering
+ *                    IMR Engineering
+ *
+ * RECORDER OVERVIEW:
+ * Small f_write calls allocate clusters and update the FAT as the file grows, which stalls the stream.  The
+ * recorder avoids all of that while recording:
+ *  - The file is pre-allocated as one contiguous cluster run (f_expand) sized for the maximum capture
+ *  - The 44 byte RIFF header is placed at the start of the first buffer, sizes patched at close
+ *  - Samples are packed as 16 bit PCM into two sector aligned buffers; a full buffer goes to the card as a
+ *    single multi-block disk_write straight to the file's sectors while the other buffer fills
+ *  - At close the file is truncated to the recorded length and the header sizes are written
+ * The producer (putCaptureSamples) may run from an ISR; serviceCaptureRecorder must run from the main loop.
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#include "Capture_Recorder.h"
+#include "diskio.h"
+#include "diskio_timing.h"
+#include "xil_printf.h"
+#include <string.h>
+
+
+
+/********************************************************************************************************
+* @brief Fills a canonical 44 byte PCM16 WAV header for the recorder's format and data size
+*
+* @author original: Hab Collector \n
+*
+* @param Recorder: Recorder handle (format members set)
+* @param DataSize: Bytes of sample data that follow the header
+* @param WavHeader: Header to fill
+********************************************************************************************************/
+static void buildCaptureHeader(Type_CaptureRecorder *Recorder, uint32_t DataSize, Type_WavHeader *WavHeader)
+{
+    memcpy(WavHeader->RiffChunkID, RIFF_FILE_TYPE, 4);
+    WavHeader->RiffChunkSize = (WAV_DATA_OFFSET - 8) + DataSize;
+    memcpy(WavHeader->RiffType, WAVE_RIFF_TYPE, 4);
+    memcpy(WavHeader->FormatChunkID, "fmt ", 4);
+    WavHeader->FormatChunkSize = WAVE_CHUNK_SIZE;
+    WavHeader->Compression = COMPRESSION_NONE;
+    WavHeader->ChannelNumber = Recorder->ChannelNumber;
+    WavHeader->SampleRate = Recorder->SampleRate;
+    WavHeader->ByteRate = Recorder->SampleRate * Recorder->FrameBytes;
+    WavHeader->BlockAlign = (uint16_t)Recorder->FrameBytes;
+    WavHeader->BitsPerSample = PCM_16_BIT_SIGNED;
+    memcpy(WavHeader->DataChunkID, "data", 4);
+    WavHeader->DataSize = DataSize;
+
+} // END OF buildCaptureHeader
+
+
+
+/********************************************************************************************************
+* @brief Creates the capture file, pre-allocates it as a contiguous run and places the RIFF header at the
+* front of the first buffer
+*
+* @author original: Hab Collector \n
+*
+* @note: Requires FF_USE_EXPAND = 1 (ffconf.h) and FAT FS mounted
+* @note: The card must have a free contiguous area of MaxSamples * ChannelNumber * 2 + 44 bytes
+* 
+* @param Recorder: Recorder handle (static - holds the sector buffers)
+* @param PathFileName: File to create (overwritten if present)
+* @param SampleRate: ADC sample rate in Hz (WAV header)
+* @param ChannelNumber: 1 = ADC channel A only, 2 = channels A and B
+* @param MaxSamples: Longest capture in sample frames - sets the pre-allocated size
+*
+* @return FR_OK if successful or a file specific error if not
+*
+* STEP 1: Validate and reset the handle
+* STEP 2: Create and pre-allocate the file as one contiguous cluster run
+* STEP 3: Locate the first sector of the file
+* STEP 4: Header up front in the first buffer - sizes patched at close
+********************************************************************************************************/
+FRESULT openCaptureFile(Type_CaptureRecorder *Recorder, const char *PathFileName, uint32_t SampleRate, uint16_t ChannelNumber, uint32_t MaxSamples)
+{
+    FRESULT FileResult;
+
+    // STEP 1: Validate and reset the handle
+    if ((Recorder == NULL) || Recorder->IsOpen || (MaxSamples == 0) || (ChannelNumber < MONO) || (ChannelNumber > STEREO))
+        return(FR_INVALID_PARAMETER);
+    memset(&Recorder->Stats, 0x00, sizeof(Recorder->Stats));
+    Recorder->ChannelNumber = ChannelNumber;
+    Recorder->SampleRate = SampleRate;
+    Recorder->FrameBytes = (uint32_t)ChannelNumber * sizeof(int16_t);
+    Recorder->MaxSamples = MaxSamples;
+
+    // STEP 2: Create and pre-allocate the file as one contiguous cluster run
+    FSIZE_t FileSize = WAV_DATA_OFFSET + ((FSIZE_t)MaxSamples * Recorder->FrameBytes);
+    FileResult = f_open(&Recorder->FileHandle, PathFileName, FA_CREATE_ALWAYS | FA_WRITE | FA_READ);
+    if (FileResult != FR_OK)
+        return(FileResult);
+    FileResult = f_expand(&Recorder->FileHandle, FileSize, 1);
+    if (FileResult != FR_OK)
+    {
+        f_close(&Recorder->FileHandle);
+        f_unlink(PathFileName);
+        return(FileResult);
+    }
+
+    // STEP 3: Locate the first sector of the file
+    FATFS *FileSystem = Recorder->FileHandle.obj.fs;
+    Recorder->StartSector = FileSystem->database + ((LBA_t)(Recorder->FileHandle.obj.sclust - 2) * FileSystem->csize);
+    Recorder->NextSector = 0;
+
+    // STEP 4: Header up front in the first buffer - sizes patched at close
+    buildCaptureHeader(Recorder, (uint32_t)(FileSize - WAV_DATA_OFFSET), (Type_WavHeader *)Recorder->Buffer[0]);
+    Recorder->BufferFill[0] = WAV_DATA_OFFSET;
+    Recorder->BufferFill[1] = 0;
+    Recorder->BufferReady[0] = false;
+    Recorder->BufferReady[1] = false;
+    Recorder->ActiveBuffer = 0;
+    Recorder->WriteBuffer = 0;
+    Recorder->SamplesQueued = 0;
+    Recorder->StartTicks = disk_time_now();
+    Recorder->IsOpen = true;
+    return(FR_OK);
+
+} // END OF openCaptureFile
+
+
+
+/********************************************************************************************************
+* @brief Packs ADC conversions into the active buffer as 16 bit PCM.  A full buffer is handed to the card
+* writer and filling continues in the other buffer; if that one has not yet been written the remaining
+* samples are dropped and counted.
+*
+* @author original: Hab Collector \n
+*
+* @note: May be called from the ADC completion ISR - no card access is made here
+* @note: 12 bit offset binary ADC codes are centred and scaled to full scale signed 16 bit
+* 
+* @param Recorder: Open recorder handle
+* @param Data_A: ADC channel A conversions
+* @param Data_B: ADC channel B conversions (ignored for 1 channel captures)
+* @param SampleCount: Number of conversions in each channel buffer
+*
+* @return Number of sample frames accepted
+*
+* STEP 1: Stop at the pre-allocated size
+* STEP 2: Switch buffers when full - drop if the card writer is behind
+* STEP 3: Pack the sample frame
+********************************************************************************************************/
+uint32_t putCaptureSamples(Type_CaptureRecorder *Recorder, const uint16_t *Data_A, const uint16_t *Data_B, uint32_t SampleCount)
+{
+    if ((Recorder == NULL) || !Recorder->IsOpen)
+        return(0);
+
+    for (uint32_t Index = 0; Index < SampleCount; Index++)
+    {
+        // STEP 1: Stop at the pre-allocated size
+        if (Recorder->SamplesQueued >= Recorder->MaxSamples)
+        {
+            Recorder->Stats.TruncatedSamples += SampleCount - Index;
+            return(Index);
+        }
+
+        // STEP 2: Switch buffers when full - drop if the card writer is behind
+        uint8_t Active = Recorder->ActiveBuffer;
+        if ((Recorder->BufferFill[Active] + Recorder->FrameBytes) > CAPTURE_BUFFER_BYTES)
+        {
+            Recorder->BufferReady[Active] = true;
+            if (Recorder->BufferReady[Active ^ 1])
+            {
+                Recorder->Stats.BufferOverruns++;
+                Recorder->Stats.DroppedSamples += SampleCount - Index;
+                return(Index);
+            }
+            Active ^= 1;
+            Recorder->BufferFill[Active] = 0;
+            Recorder->ActiveBuffer = Active;
+        }
+
+        // STEP 3: Pack the sample frame
+        int16_t *Frame = (int16_t *)&Recorder->Buffer[Active][Recorder->BufferFill[Active]];
+        // Signed offset removal then a multiply - a left shift of the negative half is undefined; -2048..2047 x 16 fits int16
+        Frame[0] = (int16_t)(((int32_t)Data_A[Index] - (int32_t)CAPTURE_ADC_MID_SCALE) * (1 << CAPTURE_ADC_TO_PCM16_SHIFT));
+        if (Recorder->ChannelNumber == STEREO)
+            Frame[1] = (int16_t)(((int32_t)Data_B[Index] - (int32_t)CAPTURE_ADC_MID_SCALE) * (1 << CAPTURE_ADC_TO_PCM16_SHIFT));
+        Recorder->BufferFill[Active] += Recorder->FrameBytes;
+        Recorder->SamplesQueued++;
+    }
+    return(SampleCount);
+
+} // END OF putCaptureSamples
+
+
+
+/********************************************************************************************************
+* @brief Writes one buffer to the next sectors of the contiguous file as a single multi-block write
+*
+* @author original: Hab Collector \n
+*
+* @note: A partly filled buffer (close) is zero padded to a whole sector - the pad is cut by the truncate
+* 
+* @param Recorder: Open recorder handle
+* @param BufferIndex: Buffer to write
+*
+* @return FR_OK if successful, FR_DISK_ERR on a block device error
+*
+* STEP 1: Whole sectors only
+* STEP 2: Timed multi-block write
+* STEP 3: Account for the samples now on the card
+********************************************************************************************************/
+static FRESULT writeCaptureBuffer(Type_CaptureRecorder *Recorder, uint8_t BufferIndex)
+{
+    uint32_t Fill = Recorder->BufferFill[BufferIndex];
+
+    // STEP 1: Whole sectors only
+    UINT SectorCount = (UINT)((Fill + FF_MAX_SS - 1) / FF_MAX_SS);
+    memset(&Recorder->Buffer[BufferIndex][Fill], 0x00, (SectorCount * FF_MAX_SS) - Fill);
+
+    // STEP 2: Timed multi-block write
+    uint32_t StartTicks = disk_time_now();
+    DRESULT DiskResult = disk_write(Recorder->FileHandle.obj.fs->pdrv, Recorder->Buffer[BufferIndex], Recorder->StartSector + Recorder->NextSector, SectorCount);
+    uint32_t WriteTime_us = disk_time_elapsed_us(StartTicks);
+    if (DiskResult != RES_OK)
+        return(FR_DISK_ERR);
+    Recorder->Stats.WriteCount++;
+    Recorder->Stats.WriteTime_us += WriteTime_us;
+    if (WriteTime_us > Recorder->Stats.MaxWriteTime_us)
+        Recorder->Stats.MaxWriteTime_us = WriteTime_us;
+
+    // STEP 3: Account for the samples now on the card
+    if (Recorder->NextSector == 0)
+        Fill -= WAV_DATA_OFFSET;
+    Recorder->Stats.SamplesWritten += Fill / Recorder->FrameBytes;
+    Recorder->NextSector += SectorCount;
+    return(FR_OK);
+
+} // END OF writeCaptureBuffer
+
+
+
+/********************************************************************************************************
+* @brief Card writer - sends every full buffer to the card in the order they were filled
+*
+* @author original: Hab Collector \n
+*
+* @note: Call from the main loop at least once per buffer fill time (CAPTURE_BUFFER_BYTES / byte rate)
+* 
+* @param Recorder: Open recorder handle
+*
+* @return FR_OK if successful or a file specific error if not
+*
+* STEP 1: Accumulate record time - the tick counter wraps so it is banked each call
+* STEP 2: Write ready buffers and release them to the producer
+********************************************************************************************************/
+FRESULT serviceCaptureRecorder(Type_CaptureRecorder *Recorder)
+{
+    if ((Recorder == NULL) || !Recorder->IsOpen)
+        return(FR_INVALID_OBJECT);
+
+    // STEP 1: Accumulate record time - the tick counter wraps so it is banked each call
+    uint32_t NowTicks = disk_time_now();
+    Recorder->Stats.RecordTime_us += (NowTicks - Recorder->StartTicks) / DISK_TIME_TICKS_PER_US;
+    Recorder->StartTicks = NowTicks - ((NowTicks - Recorder->StartTicks) % DISK_TIME_TICKS_PER_US);
+
+    // STEP 2: Write ready buffers and release them to the producer
+    while (Recorder->BufferReady[Recorder->WriteBuffer])
+    {
+        uint8_t WriteBuffer = Recorder->WriteBuffer;
+        FRESULT FileResult = writeCaptureBuffer(Recorder, WriteBuffer);
+        if (FileResult != FR_OK)
+            return(FileResult);
+        Recorder->WriteBuffer = WriteBuffer ^ 1;
+        Recorder->BufferReady[WriteBuffer] = false;
+    }
+    return(FR_OK);
+
+} // END OF serviceCaptureRecorder
+
+
+
+/********************************************************************************************************
+* @brief Finishes a capture: writes the buffered samples, trims the file to the recorded length and patches
+* the RIFF and data chunk sizes
+*
+* @author original: Hab Collector \n
+*
+* @note: The producer must be stopped before the call
+* 
+* @param Recorder: Open recorder handle
+*
+* @return FR_OK if successful or a file specific error if not
+*
+* STEP 1: Flush full buffers then the partly filled active buffer
+* STEP 2: Trim the pre-allocation to the recorded length
+* STEP 3: Patch the header sizes and close
+********************************************************************************************************/
+FRESULT closeCaptureFile(Type_CaptureRecorder *Recorder)
+{
+    FRESULT FileResult;
+    UINT BytesWritten;
+    Type_WavHeader WavHeader;
+
+    if ((Recorder == NULL) || !Recorder->IsOpen)
+        return(FR_INVALID_OBJECT);
+
+    // STEP 1: Flush full buffers then the partly filled active buffer
+    FileResult = serviceCaptureRecorder(Recorder);
+    uint8_t Active = Recorder->ActiveBuffer;
+    if ((FileResult == FR_OK) && !Recorder->BufferReady[Active] && (Recorder->BufferFill[Active] != 0))
+        FileResult = writeCaptureBuffer(Recorder, Active);
+    Recorder->IsOpen = false;
+
+    // STEP 2: Trim the pre-allocation to the recorded length
+    uint32_t DataSize = Recorder->Stats.SamplesWritten * Recorder->FrameBytes;
+    if (FileResult == FR_OK)
+        FileResult = f_lseek(&Recorder->FileHandle, WAV_DATA_OFFSET + (FSIZE_t)DataSize);
+    if (FileResult == FR_OK)
+        FileResult = f_truncate(&Recorder->FileHandle);
+
+    // STEP 3: Patch the header sizes and close
+    buildCaptureHeader(Recorder, DataSize, &WavHeader);
+    if (FileResult == FR_OK)
+        FileResult = f_lseek(&Recorder->FileHandle, 0);
+    if (FileResult == FR_OK)
+        FileResult = f_write(&Recorder->FileHandle, &WavHeader, sizeof(WavHeader), &BytesWritten);
+    FRESULT CloseResult = f_close(&Recorder->FileHandle);
+    return((FileResult != FR_OK) ? FileResult : CloseResult);
+
+} // END OF closeCaptureFile
+
+
+
+/********************************************************************************************************
+* @brief Prints the capture statistics: samples written and lost, and the achieved write rate both over the
+* block writes alone (what the SD interface delivered) and over the whole recording
+*
+* @author original: Hab Collector \n
+*
+* @param Recorder: Recorder handle (open or closed)
+*
+* STEP 1: Sample counters
+* STEP 2: Rates in kB/s shown as MB/s
+********************************************************************************************************/
+void printCaptureReport(Type_CaptureRecorder *Recorder)
+{
+    Type_CaptureStats *Stats = &Recorder->Stats;
+
+    // STEP 1: Sample counters
+    xil_printf("Capture: %d samples written, %d dropped (%d overruns), %d truncated\r\n", Stats->SamplesWritten, Stats->DroppedSamples, Stats->BufferOverruns, Stats->TruncatedSamples);
+
+    // STEP 2: Rates in kB/s shown as MB/s
+    uint64_t Bytes = (uint64_t)Recorder->NextSector * FF_MAX_SS;
+    uint32_t WriteRate_kBps = (Stats->WriteTime_us == 0) ? 0 : (uint32_t)((Bytes * 1000) / Stats->WriteTime_us);
+    uint32_t RecordRate_kBps = (Stats->RecordTime_us == 0) ? 0 : (uint32_t)((Bytes * 1000) / Stats->RecordTime_us);
+    xil_printf("Capture: card %d.%03d MB/s (%d writes, max %d us), sustained %d.%03d MB/s\r\n", WriteRate_kBps / 1000, WriteRate_kBps % 1000, Stats->WriteCount, Stats->MaxWriteTime_us, RecordRate_kBps / 1000, RecordRate_kBps % 1000);
+
+} // END OF printCaptureReport
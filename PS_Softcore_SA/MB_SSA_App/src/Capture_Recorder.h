@@ -0,0 +1,92 @@
+/******************************************************************************************************
+ * @file            Capture_Recorder.h
+ * @brief           Header file to support Capture_Recorder.c
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        <Xilinx Artix A7> \n
+ * IDE:             Vitis 2024.2 \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            The associated header file provides MACRO functions for IO control
+ *
+ *                  This is an embedded application
+ *                  It will be necessary to consult the reference documents to fully understand the code
+ *                  It is suggested that the documents be reviewed in the order shown.
+ *                    Schematic: 
+ *                    IMR Engineering
+ *                    IMR Engineering
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#ifndef CAPTURE_RECORDER_H_
+#define CAPTURE_RECORDER_H_
+#ifdef __cplusplus
+extern"C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ff.h"
+#include "Audio_File_API.h"
+
+// DEFINES
+#define CAPTURE_DIRECTORY           "CAPTURE"
+#define CAPTURE_BUFFER_SECTORS      32U                                     // Sectors per half of the double buffer - one multi-block write each
+#define CAPTURE_BUFFER_BYTES        (CAPTURE_BUFFER_SECTORS * FF_MAX_SS)
+#define CAPTURE_BUFFER_COUNT        2U
+#define CAPTURE_ADC_MID_SCALE       2048U                                   // 12 bit ADC offset binary zero
+#define CAPTURE_ADC_TO_PCM16_SHIFT  4U                                      // 12 bit to 16 bit full scale
+
+
+// TYPEDEFS AND ENUMS
+typedef struct
+{
+    uint32_t                    SamplesWritten;         // Sample frames on the card
+    uint32_t                    DroppedSamples;         // Frames lost: both buffers waiting on the card
+    uint32_t                    TruncatedSamples;       // Frames lost: pre-allocated file full
+    uint32_t                    BufferOverruns;         // Times the producer found both buffers full
+    uint32_t                    WriteCount;             // Multi-block writes issued
+    uint32_t                    WriteTime_us;           // Time spent in the block writes
+    uint32_t                    MaxWriteTime_us;        // Slowest single buffer write
+    uint32_t                    RecordTime_us;          // Open to close
+} Type_CaptureStats;
+
+typedef struct
+{
+    bool                        IsOpen;
+    FIL                         FileHandle;
+    LBA_t                       StartSector;            // First sector of the contiguous file
+    uint32_t                    MaxSamples;             // Sample frames the file was pre-allocated for
+    uint16_t                    ChannelNumber;          // 1 = channel A, 2 = channel A and B
+    uint32_t                    SampleRate;
+    uint32_t                    FrameBytes;             // ChannelNumber * 2
+    uint32_t                    StartTicks;
+    uint32_t                    NextSector;             // File relative sector of the next buffer write
+    volatile uint32_t           SamplesQueued;          // Sample frames accepted into the buffers
+    volatile uint8_t            ActiveBuffer;           // Buffer the producer is filling
+    volatile uint8_t            WriteBuffer;            // Next buffer to go to the card
+    volatile bool               BufferReady[CAPTURE_BUFFER_COUNT];
+    volatile uint32_t           BufferFill[CAPTURE_BUFFER_COUNT];
+    uint8_t                     Buffer[CAPTURE_BUFFER_COUNT][CAPTURE_BUFFER_BYTES] __attribute__((aligned(4)));
+    Type_CaptureStats           Stats;
+} Type_CaptureRecorder;
+
+
+// FUNCTION PROTOTYPES
+FRESULT openCaptureFile(Type_CaptureRecorder *Recorder, const char *PathFileName, uint32_t SampleRate, uint16_t ChannelNumber, uint32_t MaxSamples);
+uint32_t putCaptureSamples(Type_CaptureRecorder *Recorder, const uint16_t *Data_A, const uint16_t *Data_B, uint32_t SampleCount);
+FRESULT serviceCaptureRecorder(Type_CaptureRecorder *Recorder);
+FRESULT closeCaptureFile(Type_CaptureRecorder *Recorder);
+void printCaptureReport(Type_CaptureRecorder *Recorder);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CAPTURE_RECORDER_H_ */
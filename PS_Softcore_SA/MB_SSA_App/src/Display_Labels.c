@@ -0,0 +1,225 @@
+/******************************************************************************************************
+ * @file            Display_Labels.c
+ * @brief           Pre-rendered bitmap cache for static display text (axis labels, mode banner, file name)
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        <Xilinx Artix A7> \n
+ * IDE:             Vitis 2024.2 \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            The associated header file provides MACRO functions for IO control
+ *
+ *                  This is an embedded application
+ *                  It will be necessary to consult the reference documents to fully understand the code
+ *                  It is suggested that the documents be reviewed in the order shown.
+ *                    Schematic:
+ *                    IMR Engineering
+ *                    IMR Engineering
+ *
+ * LABEL CACHE OVERVIEW:
+ * u8g2_DrawStr runs the RLE glyph decoder for every character on every frame.  A label instead decodes its
+ * string once: u8g2_DrawStr is run into a scratch frame cleared to 0 (the bits it sets) and again into one
+ * set to 1 (the bits it clears), which gives the page bytes it writes and a mask of every bit it touches -
+ * glyph and, in solid font mode, background.  Later frames copy those bytes into the frame buffer with the
+ * mask: a byte aligned copy per page row, a plain memcpy where the row is fully covered.  The result is
+ * identical to u8g2_DrawStr for any font, font mode and draw color 0 / 1 (not XOR).  The bitmap is only
+ * rebuilt when the text, font or position changes.
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#include "Display_Labels.h"
+#include <string.h>
+
+// STATIC VARIABLES
+static uint8_t ScratchClear[LABEL_FRAME_PAGES * LABEL_FRAME_WIDTH] __attribute__((aligned(4)));
+static uint8_t ScratchSet[LABEL_FRAME_PAGES * LABEL_FRAME_WIDTH] __attribute__((aligned(4)));
+
+
+
+/********************************************************************************************************
+* @brief Empty label - nothing is drawn until setDisplayLabel
+*
+* @author original: Hab Collector \n
+*
+* @param Label: Label handle
+********************************************************************************************************/
+void initDisplayLabel(Type_DisplayLabel *Label)
+{
+    memset(Label, 0x00, sizeof(Type_DisplayLabel));
+
+} // END OF initDisplayLabel
+
+
+
+/********************************************************************************************************
+* @brief Sets the label's text, font and position.  The cached bitmap is kept when nothing changed, so this
+* may be called every frame
+*
+* @author original: Hab Collector \n
+*
+* @param Label: Label handle
+* @param Font: u8g2 font
+* @param X: u8g2_DrawStr X
+* @param Y: u8g2_DrawStr Y (font reference point, baseline by default)
+* @param Text: Null terminated text - truncated to LABEL_TEXT_SIZE - 1
+*
+* @return True if the label changed (re-rendered on the next draw)
+********************************************************************************************************/
+bool setDisplayLabel(Type_DisplayLabel *Label, const uint8_t *Font, u8g2_uint_t X, u8g2_uint_t Y, const char *Text)
+{
+    if (Label->Valid && (Label->Font == Font) && (Label->X == X) && (Label->Y == Y) && (strncmp(Label->Text, Text, LABEL_TEXT_SIZE - 1) == 0))
+        return(false);
+
+    Label->Font = Font;
+    Label->X = X;
+    Label->Y = Y;
+    strncpy(Label->Text, Text, LABEL_TEXT_SIZE - 1);
+    Label->Text[LABEL_TEXT_SIZE - 1] = '\0';
+    Label->Valid = false;
+    return(true);
+
+} // END OF setDisplayLabel
+
+
+
+/********************************************************************************************************
+* @brief Forces the label to be re-rendered - e.g. after u8g2_SetFontMode / u8g2_SetDrawColor / flip changes
+*
+* @author original: Hab Collector \n
+*
+* @param Label: Label handle
+********************************************************************************************************/
+void invalidateDisplayLabel(Type_DisplayLabel *Label)
+{
+    Label->Valid = false;
+
+} // END OF invalidateDisplayLabel
+
+
+
+/********************************************************************************************************
+* @brief Decodes the label's string once and keeps the page bytes and mask of the box it touches
+*
+* @author original: Hab Collector \n
+*
+* @param Label: Label handle
+* @param U8G2_Handle: Display - its draw color and font mode apply
+*
+* STEP 1: Draw the string into both scratch frames
+* STEP 2: Box of the touched bits
+* STEP 3: Keep the box if it fits the cache
+********************************************************************************************************/
+static void renderDisplayLabel(Type_DisplayLabel *Label, u8g2_t *U8G2_Handle)
+{
+    // STEP 1: Draw the string into both scratch frames
+    uint8_t *FrameBuffer = U8G2_Handle->tile_buf_ptr;
+    u8g2_SetFont(U8G2_Handle, Label->Font);
+    memset(ScratchClear, 0x00, sizeof(ScratchClear));
+    U8G2_Handle->tile_buf_ptr = ScratchClear;
+    u8g2_DrawStr(U8G2_Handle, Label->X, Label->Y, Label->Text);
+    memset(ScratchSet, 0xFF, sizeof(ScratchSet));
+    U8G2_Handle->tile_buf_ptr = ScratchSet;
+    u8g2_DrawStr(U8G2_Handle, Label->X, Label->Y, Label->Text);
+    U8G2_Handle->tile_buf_ptr = FrameBuffer;
+    Label->RenderCount++;
+
+    // STEP 2: Box of the touched bits
+    uint8_t FirstColumn = LABEL_FRAME_WIDTH, LastColumn = 0;
+    uint8_t FirstPage = LABEL_FRAME_PAGES, LastPage = 0;
+    for (uint32_t Index = 0; Index < sizeof(ScratchClear); Index++)
+    {
+        if ((ScratchClear[Index] | (uint8_t)~ScratchSet[Index]) == 0)
+            continue;
+        uint8_t Column = Index % LABEL_FRAME_WIDTH;
+        uint8_t Page = Index / LABEL_FRAME_WIDTH;
+        FirstColumn = (Column < FirstColumn) ? Column : FirstColumn;
+        LastColumn = (Column > LastColumn) ? Column : LastColumn;
+        FirstPage = (Page < FirstPage) ? Page : FirstPage;
+        LastPage = Page;
+    }
+    Label->Valid = true;
+    if (FirstPage == LABEL_FRAME_PAGES)
+    {
+        // Empty string or fully clipped
+        Label->Cached = true;
+        Label->PageCount = 0;
+        return;
+    }
+
+    // STEP 3: Keep the box if it fits the cache
+    Label->PageCount = LastPage - FirstPage + 1;
+    Label->Cached = (Label->PageCount <= LABEL_MAX_PAGES);
+    if (!Label->Cached)
+        return;
+    Label->FirstColumn = FirstColumn;
+    Label->Width = LastColumn - FirstColumn + 1;
+    Label->FirstPage = FirstPage;
+    for (uint8_t Page = 0; Page < Label->PageCount; Page++)
+    {
+        uint32_t Offset = ((FirstPage + Page) * LABEL_FRAME_WIDTH) + FirstColumn;
+        Label->SolidPage[Page] = true;
+        for (uint8_t Column = 0; Column < Label->Width; Column++)
+        {
+            Label->Value[Page][Column] = ScratchClear[Offset + Column];
+            Label->Mask[Page][Column] = ScratchClear[Offset + Column] | (uint8_t)~ScratchSet[Offset + Column];
+            if (Label->Mask[Page][Column] != 0xFF)
+                Label->SolidPage[Page] = false;
+        }
+    }
+
+} // END OF renderDisplayLabel
+
+
+
+/********************************************************************************************************
+* @brief Draws the label into the u8g2 frame buffer - same result as u8g2_DrawStr with the label's font
+*
+* @author original: Hab Collector \n
+*
+* @note: Requires a full frame buffer 128 x 64 (_f setup).  Labels too tall for the cache fall back to
+* u8g2_DrawStr
+* @note: Changes the u8g2 font only when the label is (re)rendered
+*
+* @param Label: Label handle (setDisplayLabel)
+* @param U8G2_Handle: Display
+*
+* STEP 1: Render once
+* STEP 2: Masked byte copy per page row - memcpy where fully covered
+********************************************************************************************************/
+void drawDisplayLabel(Type_DisplayLabel *Label, u8g2_t *U8G2_Handle)
+{
+    if (Label->Font == NULL)
+        return;
+
+    // STEP 1: Render once
+    if (!Label->Valid)
+        renderDisplayLabel(Label, U8G2_Handle);
+    if (!Label->Cached)
+    {
+        u8g2_SetFont(U8G2_Handle, Label->Font);
+        u8g2_DrawStr(U8G2_Handle, Label->X, Label->Y, Label->Text);
+        return;
+    }
+
+    // STEP 2: Masked byte copy per page row - memcpy where fully covered
+    uint8_t *Destination = U8G2_Handle->tile_buf_ptr + (Label->FirstPage * LABEL_FRAME_WIDTH) + Label->FirstColumn;
+    for (uint8_t Page = 0; Page < Label->PageCount; Page++, Destination += LABEL_FRAME_WIDTH)
+    {
+        if (Label->SolidPage[Page])
+        {
+            memcpy(Destination, Label->Value[Page], Label->Width);
+            continue;
+        }
+        const uint8_t *Value = Label->Value[Page];
+        const uint8_t *Mask = Label->Mask[Page];
+        for (uint8_t Column = 0; Column < Label->Width; Column++)
+            Destination[Column] = (Destination[Column] & (uint8_t)~Mask[Column]) | Value[Column];
+    }
+
+} // END OF drawDisplayLabel
@@ -0,0 +1,75 @@
+/******************************************************************************************************
+ * @file            Display_Labels.h
+ * @brief           Header file to support Display_Labels.c
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        <Xilinx Artix A7> \n
+ * IDE:             Vitis 2024.2 \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            The associated header file provides MACRO functions for IO control
+ *
+ *                  This is an embedded application
+ *                  It will be necessary to consult the reference documents to fully understand the code
+ *                  It is suggested that the documents be reviewed in the order shown.
+ *                    Schematic:
+ *                    IMR Engineering
+ *                    IMR Engineering
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#ifndef DISPLAY_LABELS_H_
+#define DISPLAY_LABELS_H_
+#ifdef __cplusplus
+extern"C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "u8g2.h"
+
+// DEFINES
+#define LABEL_TEXT_SIZE             32U                 // Longest label + null
+#define LABEL_MAX_PAGES             3U                  // 16 pixel high font at any Y
+#define LABEL_MAX_WIDTH             128U
+#define LABEL_FRAME_WIDTH           128U                // SSD1309 u8g2 full buffer
+#define LABEL_FRAME_PAGES           8U
+
+
+// TYPEDEFS AND ENUMS
+typedef struct
+{
+    char                        Text[LABEL_TEXT_SIZE];
+    const uint8_t               *Font;
+    u8g2_uint_t                 X;                      // u8g2_DrawStr position (font reference point)
+    u8g2_uint_t                 Y;
+    bool                        Valid;                  // Bitmap matches Text / Font / X / Y
+    bool                        Cached;                 // False: too large to cache - drawn with u8g2_DrawStr
+    uint8_t                     FirstColumn;            // Box of the pixels the string touches
+    uint8_t                     Width;
+    uint8_t                     FirstPage;
+    uint8_t                     PageCount;
+    uint8_t                     Value[LABEL_MAX_PAGES][LABEL_MAX_WIDTH];    // Page bytes to write
+    uint8_t                     Mask[LABEL_MAX_PAGES][LABEL_MAX_WIDTH];     // Bits u8g2_DrawStr writes (glyph and background)
+    bool                        SolidPage[LABEL_MAX_PAGES];                 // Every bit of the page row written - plain memcpy
+    uint32_t                    RenderCount;            // Times the glyphs were decoded
+} Type_DisplayLabel;
+
+
+// FUNCTION PROTOTYPES
+void initDisplayLabel(Type_DisplayLabel *Label);
+bool setDisplayLabel(Type_DisplayLabel *Label, const uint8_t *Font, u8g2_uint_t X, u8g2_uint_t Y, const char *Text);
+void invalidateDisplayLabel(Type_DisplayLabel *Label);
+void drawDisplayLabel(Type_DisplayLabel *Label, u8g2_t *U8G2_Handle);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* DISPLAY_LABELS_H_ */
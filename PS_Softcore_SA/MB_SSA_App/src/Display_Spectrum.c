@@ -0,0 +1,188 @@
+/******************************************************************************************************
+ * @file            Display_Spectrum.c
+ * @brief           Spectrum bar renderer writing directly into the u8g2 tile buffer
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        <Xilinx Artix A7> \n
+ * IDE:             Vitis 2024.2 \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            The associated header file provides MACRO functions for IO control
+ *
+ *                  This is an embedded application
+ *                  It will be necessary to consult the reference documents to fully understand the code
+ *                  It is suggested that the documents be reviewed in the order shown.
+ *                    Schematic:
+ *                    IMR Engineering
+ *                    IMR Engineering
+ *
+ * BLITTER OVERVIEW:
+ * The SSD1309 u8g2 buffer is vertical_top_lsb: 8 pages of 128 bytes, each byte one column of 8 rows with
+ * the top row in bit 0.  A bar column of a given level is therefore the same 8 bytes wherever it is drawn.
+ * At init every level (0 - Levels) is converted once to its 8 page bytes, segment gaps included, and the
+ * same for the single segment peak marker.  A frame is then one pass over the pages the bars occupy:
+ * each column byte is a table lookup ORed with the bits of the page outside the bar band.  No clipping,
+ * no per segment u8g2_DrawBox, and the only memory touched is the bar area of the buffer.
+ * Pure u8g2 - builds unchanged on the host (see host/display_bench.c).
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#include "Display_Spectrum.h"
+#include <string.h>
+
+
+
+/********************************************************************************************************
+* @brief Sets a band of rows in an 8 page column mask
+*
+* @author original: Hab Collector \n
+*
+* @param ColumnMask: 8 page bytes of a column
+* @param Y_Top: First row of the band
+* @param Height: Rows in the band
+********************************************************************************************************/
+static void setColumnRows(uint8_t *ColumnMask, uint8_t Y_Top, uint8_t Height)
+{
+    for (uint8_t Y = Y_Top; Y < (Y_Top + Height); Y++)
+        ColumnMask[Y >> 3] |= (uint8_t)(1U << (Y & 0x07));
+
+} // END OF setColumnRows
+
+
+
+/********************************************************************************************************
+* @brief Validates the bar geometry and builds the level to page byte look up tables
+*
+* @author original: Hab Collector \n
+*
+* @note: Level N lights segments 0 to N-1 counted up from BaselineY; each segment is SegmentHeight rows
+* with SegmentVSpace dark rows above it, matching drawSpectrumMock
+*
+* @param Blitter: Blitter handle
+* @param Config: Bar geometry
+*
+* @return True if the bars fit the display
+*
+* STEP 1: Geometry must fit the 128 x 64 buffer
+* STEP 2: Level -> bar and peak page masks
+* STEP 3: Pages touched and the bits of them that are not ours
+********************************************************************************************************/
+bool initSpectrumBlitter(Type_SpectrumBlitter *Blitter, const Type_SpectrumConfig *Config)
+{
+    // STEP 1: Geometry must fit the 128 x 64 buffer
+    uint32_t SegmentPitch = Config->SegmentHeight + Config->SegmentVSpace;
+    uint32_t BarHeight = (Config->Levels * SegmentPitch) - Config->SegmentVSpace;
+    uint32_t SpectrumWidth = (Config->NumBars * (Config->BarWidth + Config->BarHSpace)) - Config->BarHSpace;
+    if ((Config->NumBars == 0) || (Config->NumBars > SPECTRUM_MAX_BARS) || (Config->BarWidth == 0) || (Config->SegmentHeight == 0))
+        return(false);
+    if ((Config->Levels == 0) || (Config->Levels > SPECTRUM_MAX_LEVELS) || (BarHeight > Config->BaselineY) || (Config->BaselineY > (SPECTRUM_PAGE_COUNT * 8U)))
+        return(false);
+    if ((Config->X_Offset + SpectrumWidth) > SPECTRUM_DISPLAY_WIDTH)
+        return(false);
+    Blitter->Config = *Config;
+
+    // STEP 2: Level -> bar and peak page masks
+    memset(Blitter->BarMask, 0, sizeof(Blitter->BarMask));
+    memset(Blitter->PeakMask, 0, sizeof(Blitter->PeakMask));
+    for (uint8_t Level = 1; Level <= Config->Levels; Level++)
+    {
+        uint8_t Y_Top = Config->BaselineY - (Level * SegmentPitch) + Config->SegmentVSpace;
+        memcpy(Blitter->BarMask[Level], Blitter->BarMask[Level - 1], SPECTRUM_PAGE_COUNT);
+        setColumnRows(Blitter->BarMask[Level], Y_Top, Config->SegmentHeight);
+        setColumnRows(Blitter->PeakMask[Level], Y_Top, Config->SegmentHeight);
+    }
+
+    // STEP 3: Pages touched and the bits of them that are not ours
+    uint8_t BandMask[SPECTRUM_PAGE_COUNT] = {0};
+    setColumnRows(BandMask, Config->BaselineY - BarHeight, BarHeight);
+    Blitter->FirstPage = (Config->BaselineY - BarHeight) >> 3;
+    Blitter->LastPage = (Config->BaselineY - 1) >> 3;
+    for (uint8_t Page = 0; Page < SPECTRUM_PAGE_COUNT; Page++)
+        Blitter->KeepMask[Page] = (uint8_t)~BandMask[Page];
+    return(true);
+
+} // END OF initSpectrumBlitter
+
+
+
+/********************************************************************************************************
+* @brief Renders all bars (and peak markers) straight into the u8g2 tile buffer in one pass over the pages
+* the bars occupy.  The bar band is fully rewritten - no u8g2_ClearBuffer needed between frames - and
+* everything outside it is left untouched
+*
+* @author original: Hab Collector \n
+*
+* @note: Levels above Config.Levels are clamped
+* @note: Push with displaySendChanged / displayPushFrameAsync as usual
+*
+* @param Blitter: Blitter handle (initSpectrumBlitter)
+* @param U8G2_Handle: Display with a full frame buffer (_f setup)
+* @param BarLevel: NumBars bar levels 0 - Levels
+* @param PeakLevel: NumBars peak marker levels 0 - Levels (SPECTRUM_NO_PEAK for none), or NULL
+*
+* STEP 1: Per bar page bytes for this frame - clamp and merge the peak once, not per page
+* STEP 2: One pass over the pages: each bar column is one byte written BarWidth times
+********************************************************************************************************/
+void drawSpectrumBars(Type_SpectrumBlitter *Blitter, u8g2_t *U8G2_Handle, const uint8_t *BarLevel, const uint8_t *PeakLevel)
+{
+    uint8_t BarColumn[SPECTRUM_PAGE_COUNT][SPECTRUM_MAX_BARS];
+    uint8_t Levels = Blitter->Config.Levels;
+    uint8_t NumBars = Blitter->Config.NumBars;
+    uint8_t BarWidth = Blitter->Config.BarWidth;
+    uint8_t BarHSpace = Blitter->Config.BarHSpace;
+
+    // STEP 1: Per bar page bytes for this frame - clamp and merge the peak once, not per page
+    for (uint8_t BarIndex = 0; BarIndex < NumBars; BarIndex++)
+    {
+        uint8_t Level = (BarLevel[BarIndex] > Levels) ? Levels : BarLevel[BarIndex];
+        uint8_t Peak = (PeakLevel == NULL) ? SPECTRUM_NO_PEAK : ((PeakLevel[BarIndex] > Levels) ? Levels : PeakLevel[BarIndex]);
+        for (uint8_t Page = Blitter->FirstPage; Page <= Blitter->LastPage; Page++)
+            BarColumn[Page][BarIndex] = Blitter->BarMask[Level][Page] | Blitter->PeakMask[Peak][Page];
+    }
+
+    // STEP 2: One pass over the pages: each bar column is one byte written BarWidth times
+    uint8_t *TileBuffer = U8G2_Handle->tile_buf_ptr;
+    for (uint8_t Page = Blitter->FirstPage; Page <= Blitter->LastPage; Page++)
+    {
+        uint8_t *PageBuffer = &TileBuffer[(Page * SPECTRUM_DISPLAY_WIDTH) + Blitter->Config.X_Offset];
+        uint8_t KeepMask = Blitter->KeepMask[Page];
+        for (uint8_t BarIndex = 0; BarIndex < NumBars; BarIndex++)
+        {
+            uint8_t Column = BarColumn[Page][BarIndex];
+            for (uint8_t X = 0; X < BarWidth; X++, PageBuffer++)
+                *PageBuffer = (*PageBuffer & KeepMask) | Column;
+            if (BarIndex == (NumBars - 1))
+                break;
+            for (uint8_t X = 0; X < BarHSpace; X++, PageBuffer++)
+                *PageBuffer &= KeepMask;
+        }
+    }
+
+} // END OF drawSpectrumBars
+
+
+
+/********************************************************************************************************
+* @brief Folds a spectrum the display governor did not render (DISPLAY_FRAME_MERGE) into the levels of the
+* next rendered frame - peak hold, so a short transient is not lost when the display runs slower than the DSP
+*
+* @author original: Hab Collector \n
+*
+* @param MergedLevel: Levels accumulated since the last rendered frame - start from the first offered frame
+* @param BarLevel: Levels of the new spectrum
+* @param NumBars: Number of bars
+********************************************************************************************************/
+void mergeSpectrumLevels(uint8_t *MergedLevel, const uint8_t *BarLevel, uint8_t NumBars)
+{
+    for (uint8_t BarIndex = 0; BarIndex < NumBars; BarIndex++)
+    {
+        if (BarLevel[BarIndex] > MergedLevel[BarIndex])
+            MergedLevel[BarIndex] = BarLevel[BarIndex];
+    }
+}
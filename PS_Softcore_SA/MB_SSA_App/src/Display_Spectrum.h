@@ -0,0 +1,78 @@
+/******************************************************************************************************
+ * @file            Display_Spectrum.h
+ * @brief           Header file to support Display_Spectrum.c
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        <Xilinx Artix A7> \n
+ * IDE:             Vitis 2024.2 \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            The associated header file provides MACRO functions for IO control
+ *
+ *                  This is an embedded application
+ *                  It will be necessary to consult the reference documents to fully understand the code
+ *                  It is suggested that the documents be reviewed in the order shown.
+ *                    Schematic:
+ *                    IMR Engineering
+ *                    IMR Engineering
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#ifndef DISPLAY_SPECTRUM_H_
+#define DISPLAY_SPECTRUM_H_
+#ifdef __cplusplus
+extern"C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "u8g2.h"
+
+// DEFINES
+#define SPECTRUM_DISPLAY_WIDTH      128U                // SSD1309 columns
+#define SPECTRUM_PAGE_COUNT         8U                  // 64 rows / 8 rows per page
+#define SPECTRUM_MAX_BARS           64U
+#define SPECTRUM_MAX_LEVELS         64U                 // One level per pixel row at most
+#define SPECTRUM_NO_PEAK            0U                  // Peak level 0 - no marker drawn
+
+
+// TYPEDEFS AND ENUMS
+typedef struct
+{
+    uint8_t                     NumBars;                // 16 - 64 bars
+    uint8_t                     BarWidth;               // Pixels per bar
+    uint8_t                     BarHSpace;              // Pixels between bars
+    uint8_t                     X_Offset;               // Left edge of the first bar
+    uint8_t                     BaselineY;              // First row below the bars (1 - 64)
+    uint8_t                     SegmentHeight;          // Lit rows per level
+    uint8_t                     SegmentVSpace;          // Dark rows between levels (0 = solid bar)
+    uint8_t                     Levels;                 // Bar height in levels
+} Type_SpectrumConfig;
+
+typedef struct
+{
+    Type_SpectrumConfig         Config;
+    uint8_t                     FirstPage;              // Pages the bars occupy
+    uint8_t                     LastPage;
+    uint8_t                     KeepMask[SPECTRUM_PAGE_COUNT];                          // Bits of each page outside the bar band
+    uint8_t                     BarMask[SPECTRUM_MAX_LEVELS + 1][SPECTRUM_PAGE_COUNT];  // Level -> page bytes of a bar column
+    uint8_t                     PeakMask[SPECTRUM_MAX_LEVELS + 1][SPECTRUM_PAGE_COUNT]; // Level -> page bytes of the peak segment
+} Type_SpectrumBlitter;
+
+
+// FUNCTION PROTOTYPES
+bool initSpectrumBlitter(Type_SpectrumBlitter *Blitter, const Type_SpectrumConfig *Config);
+void drawSpectrumBars(Type_SpectrumBlitter *Blitter, u8g2_t *U8G2_Handle, const uint8_t *BarLevel, const uint8_t *PeakLevel);
+void mergeSpectrumLevels(uint8_t *MergedLevel, const uint8_t *BarLevel, uint8_t NumBars);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* DISPLAY_SPECTRUM_H_ */
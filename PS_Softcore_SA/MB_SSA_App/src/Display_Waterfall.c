@@ -0,0 +1,182 @@
+/******************************************************************************************************
+ * @file            Display_Waterfall.c
+ * @brief           Scrolling spectrogram (waterfall) on the SSD1309 display start line
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        <Xilinx Artix A7> \n
+ * IDE:             Vitis 2024.2 \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            The associated header file provides MACRO functions for IO control
+ *
+ *                  This is an embedded application
+ *                  It will be necessary to consult the reference documents to fully understand the code
+ *                  It is suggested that the documents be reviewed in the order shown.
+ *                    Schematic:
+ *                    IMR Engineering
+ *                    IMR Engineering
+ *
+ * WATERFALL OVERVIEW:
+ * Each spectrum is one 128 pixel row, newest at the top.  Rather than move 63 rows down and resend the
+ * whole frame per line, the u8g2 buffer (and the GDDRAM it mirrors) is used as a ring of 64 rows: the new
+ * line overwrites the oldest row and the SSD1309 display start line (0x40 | row) is moved onto it, so the
+ * panel scrolls in hardware.  A line costs one page over SPI - 128 data bytes, its 3 address commands and
+ * the start line command - against 1048 bytes for a full frame.  Intensity (0 - 255 per bin) is reduced to
+ * 1 bpp with a 4 x 4 Bayer ordered dither, the threshold picked by GDDRAM row and column so the pattern
+ * scrolls with the line it belongs to.
+ * The start line moves the whole panel: nothing else can share the screen while the waterfall runs.  With
+ * flip mode 1 the waterfall runs bottom up.  Pure u8g2 - builds unchanged on the host (host/display_suite.c).
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#include "Display_Waterfall.h"
+#include <string.h>
+
+// DEFINES
+#define SSD1309_SET_START_LINE      0x40U
+
+// STATIC VARIABLES
+// 4 x 4 Bayer matrix scaled to 0 - 255: a pixel is lit when its intensity is above the threshold
+static const uint8_t DitherThreshold[WATERFALL_DITHER_SIZE][WATERFALL_DITHER_SIZE] =
+{
+    {   8, 136,  40, 168 },
+    { 200,  72, 232, 104 },
+    {  56, 184,  24, 152 },
+    { 248, 120, 216,  88 },
+};
+
+
+
+/********************************************************************************************************
+* @brief Sets the SSD1309 display start line - the GDDRAM row shown on the first panel row
+*
+* @author original: Hab Collector \n
+*
+* @param U8G2_Handle: Display
+* @param Row: GDDRAM row 0 - 63
+********************************************************************************************************/
+static void waterfallSetStartLine(u8g2_t *U8G2_Handle, uint8_t Row)
+{
+    u8x8_t *U8X8 = u8g2_GetU8x8(U8G2_Handle);
+
+    u8x8_cad_StartTransfer(U8X8);
+    u8x8_cad_SendCmd(U8X8, SSD1309_SET_START_LINE | (Row & (WATERFALL_ROWS - 1)));
+    u8x8_cad_EndTransfer(U8X8);
+
+} // END OF waterfallSetStartLine
+
+
+
+/********************************************************************************************************
+* @brief Starts the waterfall: blank panel, start line 0
+*
+* @author original: Hab Collector \n
+*
+* @note: Requires the full frame buffer 128 x 64 (_f setup), flip mode 0 for newest line at the top.  The
+* buffer holds the ring after this - redraw (and on the target displayInvalidateShadow) after stopWaterfall
+*
+* @param Waterfall: Waterfall handle
+* @param U8G2_Handle: Display
+* @param NumBins: Intensity values per line: 16, 32, 64 or 128 - each spans 128 / NumBins columns
+*
+* @return True if started, false for an unsupported bin count
+*
+* STEP 1: Bin geometry
+* STEP 2: Clear the ring and the panel, start line 0
+********************************************************************************************************/
+bool initWaterfall(Type_Waterfall *Waterfall, u8g2_t *U8G2_Handle, uint8_t NumBins)
+{
+    // STEP 1: Bin geometry
+    memset(Waterfall, 0x00, sizeof(Type_Waterfall));
+    if ((NumBins < 16) || (NumBins > WATERFALL_WIDTH) || ((WATERFALL_WIDTH % NumBins) != 0))
+        return(false);
+    Waterfall->U8G2_Handle = U8G2_Handle;
+    Waterfall->NumBins = NumBins;
+    Waterfall->BinWidth = WATERFALL_WIDTH / NumBins;
+
+    // STEP 2: Clear the ring and the panel, start line 0
+    u8g2_ClearBuffer(U8G2_Handle);
+    u8g2_SendBuffer(U8G2_Handle);
+    waterfallSetStartLine(U8G2_Handle, 0);
+    Waterfall->TopRow = 0;
+    Waterfall->Active = true;
+    return(true);
+
+} // END OF initWaterfall
+
+
+
+/********************************************************************************************************
+* @brief Adds a spectrum line at the top of the waterfall - the older lines move down one row
+*
+* @author original: Hab Collector \n
+*
+* @note: Sends one page and the start line through the u8g2 transport - on the target, no background push
+* (displayPushFrameAsync) may be in flight
+*
+* @param Waterfall: Waterfall handle (initWaterfall)
+* @param Intensity: NumBins values, 0 (dark) - 255 (lit)
+*
+* STEP 1: Newest line replaces the oldest row of the ring
+* STEP 2: Dither the line into its bit of the page
+* STEP 3: Send the page, then move the start line onto the new row
+********************************************************************************************************/
+void addWaterfallLine(Type_Waterfall *Waterfall, const uint8_t *Intensity)
+{
+    if (!Waterfall->Active)
+        return;
+
+    // STEP 1: Newest line replaces the oldest row of the ring
+    Waterfall->TopRow = (Waterfall->TopRow + WATERFALL_ROWS - 1) & (WATERFALL_ROWS - 1);
+    uint8_t Row = Waterfall->TopRow;
+    uint8_t Page = Row >> 3;
+    uint8_t RowBit = (uint8_t)(1U << (Row & 0x07));
+    const uint8_t *Threshold = DitherThreshold[Row & (WATERFALL_DITHER_SIZE - 1)];
+
+    // STEP 2: Dither the line into its bit of the page
+    uint8_t *Column = u8g2_GetBufferPtr(Waterfall->U8G2_Handle) + (Page * WATERFALL_WIDTH);
+    uint8_t ColumnIndex = 0;
+    for (uint8_t BinIndex = 0; BinIndex < Waterfall->NumBins; BinIndex++)
+    {
+        uint8_t Level = Intensity[BinIndex];
+        for (uint8_t Repeat = 0; Repeat < Waterfall->BinWidth; Repeat++, ColumnIndex++, Column++)
+        {
+            if (Level > Threshold[ColumnIndex & (WATERFALL_DITHER_SIZE - 1)])
+                *Column |= RowBit;
+            else
+                *Column &= (uint8_t)~RowBit;
+        }
+    }
+
+    // STEP 3: Send the page, then move the start line onto the new row
+    u8g2_UpdateDisplayArea(Waterfall->U8G2_Handle, 0, Page, WATERFALL_PAGE_TILES, 1);
+    waterfallSetStartLine(Waterfall->U8G2_Handle, Row);
+    Waterfall->Lines++;
+
+} // END OF addWaterfallLine
+
+
+
+/********************************************************************************************************
+* @brief Ends the waterfall: start line back to 0 and the buffer cleared - the caller redraws its screen
+*
+* @author original: Hab Collector \n
+*
+* @param Waterfall: Waterfall handle
+********************************************************************************************************/
+void stopWaterfall(Type_Waterfall *Waterfall)
+{
+    if (!Waterfall->Active)
+        return;
+    waterfallSetStartLine(Waterfall->U8G2_Handle, 0);
+    u8g2_ClearBuffer(Waterfall->U8G2_Handle);
+    Waterfall->TopRow = 0;
+    Waterfall->Active = false;
+
+} // END OF stopWaterfall
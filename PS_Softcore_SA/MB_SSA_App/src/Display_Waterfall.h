@@ -0,0 +1,65 @@
+/******************************************************************************************************
+ * @file            Display_Waterfall.h
+ * @brief           Header file to support Display_Waterfall.c
+ * ****************************************************************************************************
+ * @author          Hab Collector (habco)\n
+ *
+ * @version         See Main_Support.h: FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV
+ *
+ * @param Development_Environment \n
+ * Hardware:        <Xilinx Artix A7> \n
+ * IDE:             Vitis 2024.2 \n
+ * Compiler:        GCC \n
+ * Editor Settings: 1 Tab = 4 Spaces, Recommended Courier New 11
+ *
+ * @note            The associated header file provides MACRO functions for IO control
+ *
+ *                  This is an embedded application
+ *                  It will be necessary to consult the reference documents to fully understand the code
+ *                  It is suggested that the documents be reviewed in the order shown.
+ *                    Schematic:
+ *                    IMR Engineering
+ *                    IMR Engineering
+ *
+ * @copyright       IMR Engineering, LLC
+ ********************************************************************************************************/
+
+#ifndef DISPLAY_WATERFALL_H_
+#define DISPLAY_WATERFALL_H_
+#ifdef __cplusplus
+extern"C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "u8g2.h"
+
+// DEFINES
+#define WATERFALL_WIDTH             128U                // SSD1309 columns - one per frequency column
+#define WATERFALL_ROWS              64U                 // History lines = GDDRAM rows
+#define WATERFALL_PAGE_TILES        16U                 // 8 pixel tiles per page
+#define WATERFALL_DITHER_SIZE       4U                  // 4 x 4 Bayer ordered dither
+
+
+// TYPEDEFS AND ENUMS
+typedef struct
+{
+    u8g2_t                      *U8G2_Handle;
+    uint8_t                     NumBins;                // Intensity values per line: 16, 32, 64 or 128
+    uint8_t                     BinWidth;               // Columns per bin
+    uint8_t                     TopRow;                 // GDDRAM row of the newest line = SSD1309 display start line
+    bool                        Active;
+    uint32_t                    Lines;                  // Lines added since initWaterfall
+} Type_Waterfall;
+
+
+// FUNCTION PROTOTYPES
+bool initWaterfall(Type_Waterfall *Waterfall, u8g2_t *U8G2_Handle, uint8_t NumBins);
+void addWaterfallLine(Type_Waterfall *Waterfall, const uint8_t *Intensity);
+void stopWaterfall(Type_Waterfall *Waterfall);
+
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* DISPLAY_WATERFALL_H_ */
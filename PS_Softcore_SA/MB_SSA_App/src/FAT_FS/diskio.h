@@ -9,9 +9,11 @@
  *      required by the FatFs core (ff.c) to communicate with a physical
  *      storage device through user-supplied drivers such as diskio.c.
  *
- *      In this project, diskio.h pairs with diskio.c, which implements
- *      sector-level access to an SD/microSD card over the AXI Quad SPI IP
- *      in standard SPI mode for a MicroBlaze system running Vitis 2024.2.
+ *      In this project, diskio.h pairs with diskio.c, which routes each
+ *      drive to a pluggable storage backend: SD/microSD over the AXI Quad
+ *      SPI IP (diskio_sd.c, MicroBlaze / Vitis 2024.2), a RAM disk
+ *      (diskio_ram.c) or, in the native Linux build, an SD card image file
+ *      (host/diskio_file.c).
  *
  *  ---------------------------------------------------------------------------
  *  Functional Overview:
@@ -31,16 +33,16 @@
  *  ---------------------------------------------------------------------------
  *  Adapting to Other Hardware:
  *      • The API definitions in this header should not be changed.
- *      • Only the corresponding diskio.c needs modification when porting
- *        to a different SPI controller, SD interface, or hardware platform.
+ *      • Porting to a different SPI controller, SD interface, or hardware
+ *        platform means adding a DiskBackend; diskio.c stays as is.
  *      • For non-SPI implementations (e.g., SDIO or SD Host), use the
  *        Xilinx-provided “diskio_sdps.c” instead of this pair.
  *
  *  ---------------------------------------------------------------------------
  *  Notes:
  *      - This implementation supports a single drive (pdrv = 0).
- *      - All operations are blocking/polled.  DMA and interrupt modes
- *        are not used in this project.
+ *      - FatFs calls are blocking.  Reads may also be queued with
+ *        disk_read_async() and completed by IRQ or a polled service.
  *      - get_fattime() provides a fixed timestamp unless a real-time
  *        clock is integrated and used.
  *
@@ -60,7 +62,6 @@ extern "C" {
 #endif
 
 #include "ff.h"
-#include "xil_types.h"
 
 /* Status of Disk Functions */
 typedef BYTE DSTATUS;
@@ -97,6 +98,32 @@ DRESULT disk_ioctl      (BYTE pdrv, BYTE cmd, void* buff);
 /* Optional timestamp provider (FatFs calls get_fattime) */
 DWORD get_fattime(void);
 
+/* Asynchronous read completion: Result of the whole request */
+typedef void (*DiskAsyncCallback)(void *Context, DRESULT Result);
+
+/* Storage backend: one physical device behind a drive number.  Operations have the
+   same contract as the disk_* functions; Write and ReadAsync may be NULL (read only /
+   no async engine - disk_read_async() then completes synchronously). */
+typedef struct
+{
+    const char *Name;
+    DSTATUS (*Initialize)(BYTE pdrv);
+    DSTATUS (*Status)    (BYTE pdrv);
+    DRESULT (*Read)      (BYTE pdrv, BYTE* buff, LBA_t sector, UINT count);
+    DRESULT (*Write)     (BYTE pdrv, const BYTE* buff, LBA_t sector, UINT count);
+    DRESULT (*Ioctl)     (BYTE pdrv, BYTE cmd, void* buff);
+    DRESULT (*ReadAsync) (BYTE pdrv, BYTE* buff, LBA_t sector, UINT count, DiskAsyncCallback Callback, void *Context);
+} DiskBackend;
+
+/* Backend selection (not called by FatFs).  Attach before f_mount(); on the target
+   drive 0 defaults to the SD-over-SPI backend (diskio_sd.h). */
+DRESULT disk_attach       (BYTE pdrv, const DiskBackend *Backend);
+const DiskBackend *disk_backend(BYTE pdrv);
+
+/* Asynchronous reads (not called by FatFs); bypass the sector cache.  Callbacks may
+   run from an ISR (see diskio_sd.h) and must not call back into FatFs. */
+DRESULT disk_read_async   (BYTE pdrv, BYTE* buff, LBA_t sector, UINT count, DiskAsyncCallback Callback, void *Context);
+
 #ifdef __cplusplus
 }
 #endif
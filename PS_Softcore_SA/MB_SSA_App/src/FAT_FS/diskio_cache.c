@@ -0,0 +1,274 @@
+/* =============================================================================
+ *  File: diskio_cache.c
+ *  Project: MicroBlaze + AXI Quad SPI (microSD Interface)
+ *  Author: IMR Engineering / Hab Collector
+ *  ---------------------------------------------------------------------------
+ *  Purpose:
+ *      Set-associative, LRU sector cache between FatFs (diskio.c) and the SD
+ *      sector driver.  See diskio_cache.h for policy and configuration.
+ *
+ *  ---------------------------------------------------------------------------
+ *  Notes:
+ *      - The line storage is a static array; the linker script places .bss
+ *        in mig_0, so the cache lives in DDR.
+ *      - Reads queued with disk_read_async() do not pass through the cache.
+ *        With write-back enabled, flush before reading freshly written data
+ *        asynchronously.
+ *
+ *  ---------------------------------------------------------------------------
+ *  File Version History:
+ *      v1.0  – Initial implementation (set-associative, LRU, WT/WB)
+ * =============================================================================
+ */
+
+#include "diskio_cache.h"
+#include <string.h>
+
+#if DISK_CACHE_ENABLE
+
+#if (DISK_CACHE_SETS & (DISK_CACHE_SETS - 1u)) != 0
+#error "DISK_CACHE_SETS must be a power of two"
+#endif
+
+#define CACHE_SECTOR_SIZE   512u
+
+typedef struct
+{
+    LBA_t Sector;       /* tag: full LBA */
+    DWORD LastUse;        /* LRU stamp */
+    BYTE Valid;
+    BYTE Dirty;
+    BYTE Data[CACHE_SECTOR_SIZE];
+} CacheLine;
+
+static CacheLine Lines[DISK_CACHE_SETS][DISK_CACHE_WAYS];
+static DiskCacheStats Stats;
+static DiskCachePolicy Policy = DISK_CACHE_DEFAULT_POLICY;
+static DWORD UseClock = 0;
+static BYTE Drive = 0;
+static DiskCacheRead DeviceRead = NULL;
+static DiskCacheWrite DeviceWrite = NULL;
+
+/* Set that may hold sector */
+static CacheLine *cache_set(LBA_t sector)
+{
+    return Lines[(DWORD)sector & (DISK_CACHE_SETS - 1u)];
+}
+
+/* Cached line for sector or NULL */
+static CacheLine *cache_lookup(LBA_t sector)
+{
+    CacheLine *Set = cache_set(sector);
+
+    for (DWORD w = 0; w < DISK_CACHE_WAYS; w++)
+    {
+        if (Set[w].Valid && (Set[w].Sector == sector))
+        {
+            return &Set[w];
+        }
+    }
+    return NULL;
+}
+
+/* Write a dirty line to the device */
+static DRESULT cache_write_back(CacheLine *Line)
+{
+    if (Line->Valid && Line->Dirty)
+    {
+        DRESULT res = DeviceWrite(Drive, Line->Data, Line->Sector, 1);
+        if (res != RES_OK)
+        {
+            return res;
+        }
+        Line->Dirty = 0;
+        Stats.WriteBacks++;
+    }
+    return RES_OK;
+}
+
+/* Free line in the set of sector: an invalid way, else the least recently used */
+static CacheLine *cache_victim(LBA_t sector)
+{
+    CacheLine *Set = cache_set(sector);
+    CacheLine *Victim = &Set[0];
+
+    for (DWORD w = 0; w < DISK_CACHE_WAYS; w++)
+    {
+        if (!Set[w].Valid)
+        {
+            return &Set[w];
+        }
+        if (Set[w].LastUse < Victim->LastUse)
+        {
+            Victim = &Set[w];
+        }
+    }
+
+    if (cache_write_back(Victim) != RES_OK)
+    {
+        return NULL;
+    }
+    Victim->Valid = 0;
+    Stats.Evictions++;
+    return Victim;
+}
+
+void disk_cache_init(BYTE pdrv, DiskCacheRead Read, DiskCacheWrite Write)
+{
+    Drive = pdrv;
+    DeviceRead = Read;
+    DeviceWrite = Write;
+    disk_cache_invalidate();
+    disk_cache_reset_stats();
+}
+
+DRESULT disk_cache_read(BYTE* buff, LBA_t sector, UINT count)
+{
+    if (count > 1u)
+    {
+        /* Streamed data: straight from the device, then overlay newer dirty copies */
+        Stats.Bypass++;
+        DRESULT res = DeviceRead(Drive, buff, sector, count);
+        if ((res == RES_OK) && (Policy == DISK_CACHE_WRITE_BACK))
+        {
+            for (UINT i = 0; i < count; i++)
+            {
+                CacheLine *Line = cache_lookup(sector + i);
+                if ((Line != NULL) && Line->Dirty)
+                {
+                    memcpy(&buff[i * CACHE_SECTOR_SIZE], Line->Data, CACHE_SECTOR_SIZE);
+                }
+            }
+        }
+        return res;
+    }
+
+    CacheLine *Line = cache_lookup(sector);
+    if (Line != NULL)
+    {
+        Stats.Hits++;
+    }
+    else
+    {
+        Stats.Misses++;
+        Line = cache_victim(sector);
+        if (Line == NULL)
+        {
+            return DeviceRead(Drive, buff, sector, 1);   /* victim could not be written back */
+        }
+        DRESULT res = DeviceRead(Drive, Line->Data, sector, 1);
+        if (res != RES_OK)
+        {
+            return res;
+        }
+        Line->Sector = sector;
+        Line->Dirty = 0;
+        Line->Valid = 1;
+    }
+
+    Line->LastUse = ++UseClock;
+    memcpy(buff, Line->Data, CACHE_SECTOR_SIZE);
+    return RES_OK;
+}
+
+DRESULT disk_cache_write(const BYTE* buff, LBA_t sector, UINT count)
+{
+    if ((Policy == DISK_CACHE_WRITE_BACK) && (count == 1u))
+    {
+        CacheLine *Line = cache_lookup(sector);
+        if (Line == NULL)
+        {
+            Line = cache_victim(sector);
+            if (Line == NULL)
+            {
+                return DeviceWrite(Drive, buff, sector, 1);
+            }
+            Line->Sector = sector;
+            Line->Valid = 1;
+        }
+        memcpy(Line->Data, buff, CACHE_SECTOR_SIZE);
+        Line->Dirty = 1;
+        Line->LastUse = ++UseClock;
+        return RES_OK;
+    }
+
+    /* Write-through (or multi-sector): device first, then refresh cached copies */
+    if (count > 1u)
+    {
+        Stats.Bypass++;
+    }
+    DRESULT res = DeviceWrite(Drive, buff, sector, count);
+    if (res != RES_OK)
+    {
+        return res;
+    }
+    for (UINT i = 0; i < count; i++)
+    {
+        CacheLine *Line = cache_lookup(sector + i);
+        if (Line != NULL)
+        {
+            memcpy(Line->Data, &buff[i * CACHE_SECTOR_SIZE], CACHE_SECTOR_SIZE);
+            Line->Dirty = 0;
+        }
+    }
+    return RES_OK;
+}
+
+/* Write every dirty line to the device */
+DRESULT disk_cache_flush(void)
+{
+    DRESULT res = RES_OK;
+
+    if (DeviceWrite == NULL)
+    {
+        return RES_OK;
+    }
+    for (DWORD s = 0; s < DISK_CACHE_SETS; s++)
+    {
+        for (DWORD w = 0; w < DISK_CACHE_WAYS; w++)
+        {
+            if (cache_write_back(&Lines[s][w]) != RES_OK)
+            {
+                res = RES_ERROR;   /* keep going; line stays dirty */
+            }
+        }
+    }
+    return res;
+}
+
+/* Change policy; leaving write-back flushes first */
+DRESULT disk_cache_set_policy(DiskCachePolicy NewPolicy)
+{
+    if ((Policy == DISK_CACHE_WRITE_BACK) && (NewPolicy != DISK_CACHE_WRITE_BACK))
+    {
+        DRESULT res = disk_cache_flush();
+        if (res != RES_OK)
+        {
+            return res;
+        }
+    }
+    Policy = NewPolicy;
+    return RES_OK;
+}
+
+/* Drop every line (dirty data is lost - flush first if it matters) */
+void disk_cache_invalidate(void)
+{
+    memset(Lines, 0, sizeof(Lines));
+    UseClock = 0;
+}
+
+void disk_cache_get_stats(DiskCacheStats *Out)
+{
+    if (Out != NULL)
+    {
+        *Out = Stats;
+    }
+}
+
+void disk_cache_reset_stats(void)
+{
+    memset(&Stats, 0, sizeof(Stats));
+}
+
+#endif /* DISK_CACHE_ENABLE */
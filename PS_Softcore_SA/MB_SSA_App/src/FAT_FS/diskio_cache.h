@@ -0,0 +1,92 @@
+/* =============================================================================
+ *  File: diskio_cache.h
+ *  Project: MicroBlaze + AXI Quad SPI (microSD Interface)
+ *  Author: IMR Engineering / Hab Collector
+ *  ---------------------------------------------------------------------------
+ *  Purpose:
+ *      Set-associative sector cache that sits between the FatFs glue
+ *      (diskio.c) and the SD-over-SPI sector driver.  FatFs only keeps one
+ *      window sector per volume, so FAT chain walks and directory rescans
+ *      re-read the same sectors over SPI; with this cache they are served
+ *      from DDR instead.
+ *
+ *  ---------------------------------------------------------------------------
+ *  Operation:
+ *      - Single-sector requests (FAT, directory and partial file sectors -
+ *        everything FatFs moves through fs->win or fp->buf) are cached.
+ *      - Multi-sector requests (streamed file data) bypass the cache so they
+ *        do not evict metadata; cached copies in the range are kept coherent.
+ *      - Replacement is LRU within a set.
+ *      - Write-through (default) or write-back; write-back lines are flushed
+ *        on CTRL_SYNC (f_sync / f_close) and by disk_cache_flush(), which
+ *        must be called before unmounting.
+ *
+ *  ---------------------------------------------------------------------------
+ *  Configuration:
+ *      DISK_CACHE_ENABLE  0 removes the cache entirely (diskio.c calls the
+ *                         sector driver directly).
+ *      DISK_CACHE_SETS    Number of sets, power of two.
+ *      DISK_CACHE_WAYS    Lines per set.  SETS * WAYS = sectors cached
+ *                         (64 .. 1024 sensible; 512 B each, linked to DDR).
+ * =============================================================================
+ */
+
+#ifndef _DISKIO_CACHE_DEFINED
+#define _DISKIO_CACHE_DEFINED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "diskio.h"
+
+#define DISK_CACHE_ENABLE           1
+#define DISK_CACHE_SETS             64u     /* power of two */
+#define DISK_CACHE_WAYS             4u      /* 64 x 4 = 256 sectors (128 KB) */
+#define DISK_CACHE_DEFAULT_POLICY   DISK_CACHE_WRITE_THROUGH
+
+/* Write policy */
+typedef enum
+{
+    DISK_CACHE_WRITE_THROUGH = 0,   /* device updated on every write */
+    DISK_CACHE_WRITE_BACK           /* device updated on eviction / flush */
+} DiskCachePolicy;
+
+/* Counters since init or last disk_cache_reset_stats() */
+typedef struct
+{
+    DWORD Hits;           /* single-sector reads served from cache */
+    DWORD Misses;         /* single-sector reads that went to the device */
+    DWORD Bypass;         /* multi-sector requests passed straight through */
+    DWORD Evictions;      /* valid lines replaced */
+    DWORD WriteBacks;     /* dirty lines written to the device */
+} DiskCacheStats;
+
+/* Sector driver beneath the cache */
+typedef DRESULT (*DiskCacheRead) (BYTE pdrv, BYTE* buff, LBA_t sector, UINT count);
+typedef DRESULT (*DiskCacheWrite)(BYTE pdrv, const BYTE* buff, LBA_t sector, UINT count);
+
+/* Called by diskio.c */
+void    disk_cache_init  (BYTE pdrv, DiskCacheRead Read, DiskCacheWrite Write);
+DRESULT disk_cache_read  (BYTE* buff, LBA_t sector, UINT count);
+DRESULT disk_cache_write (const BYTE* buff, LBA_t sector, UINT count);
+
+/* Application control */
+#if DISK_CACHE_ENABLE
+DRESULT disk_cache_flush      (void);
+DRESULT disk_cache_set_policy (DiskCachePolicy Policy);
+void    disk_cache_invalidate (void);
+void    disk_cache_get_stats  (DiskCacheStats *Stats);
+void    disk_cache_reset_stats(void);
+#else
+#define disk_cache_flush()          (RES_OK)
+#define disk_cache_set_policy(p)    (RES_OK)
+#define disk_cache_invalidate()
+#define disk_cache_get_stats(s)
+#define disk_cache_reset_stats()
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _DISKIO_CACHE_DEFINED */
@@ -0,0 +1,113 @@
+/* =============================================================================
+ *  File: diskio_ram.c
+ *  Project: MicroBlaze + AXI Quad SPI (microSD Interface)
+ *  Author: IMR Engineering / Hab Collector
+ *  ---------------------------------------------------------------------------
+ *  Purpose:
+ *      RAM disk storage backend.  Sectors are plain memcpy() to and from a
+ *      caller supplied region; the medium is "inserted" by disk_ram_attach().
+ *
+ *  ---------------------------------------------------------------------------
+ *  Notes:
+ *      - The region is not cleared; format it with f_mkfs() or load an image.
+ *      - One RAM disk per image (FF_VOLUMES is 1 in this project).
+ *
+ *  ---------------------------------------------------------------------------
+ *  File Version History:
+ *      v1.0  – Initial RAM disk backend
+ * =============================================================================
+ */
+
+#include "diskio_ram.h"
+#include <string.h>
+
+static BYTE *RamBase = NULL;        /* region bound by disk_ram_attach() */
+static LBA_t RamSectors = 0;        /* size of the region in sectors */
+static DSTATUS RamStat = STA_NOINIT | STA_NODISK;
+
+static DSTATUS ram_status (BYTE pdrv)
+{
+    (void)pdrv;
+    return RamStat;
+}
+
+static DSTATUS ram_initialize (BYTE pdrv)
+{
+    (void)pdrv;
+    if (RamBase != NULL)
+    {
+        RamStat = 0;
+    }
+    return RamStat;
+}
+
+static DRESULT ram_read (BYTE pdrv, BYTE* buff, LBA_t sector, UINT count)
+{
+    (void)pdrv;
+    if ((sector >= RamSectors) || (count > (RamSectors - sector)))
+    {
+        return RES_PARERR;
+    }
+    memcpy(buff, RamBase + ((size_t)sector * DISK_RAM_SECTOR_SIZE), (size_t)count * DISK_RAM_SECTOR_SIZE);
+    return RES_OK;
+}
+
+static DRESULT ram_write (BYTE pdrv, const BYTE* buff, LBA_t sector, UINT count)
+{
+    (void)pdrv;
+    if ((sector >= RamSectors) || (count > (RamSectors - sector)))
+    {
+        return RES_PARERR;
+    }
+    memcpy(RamBase + ((size_t)sector * DISK_RAM_SECTOR_SIZE), buff, (size_t)count * DISK_RAM_SECTOR_SIZE);
+    return RES_OK;
+}
+
+static DRESULT ram_ioctl (BYTE pdrv, BYTE cmd, void* buff)
+{
+    (void)pdrv;
+    if (RamStat & STA_NOINIT)
+    {
+        return RES_NOTRDY;
+    }
+
+    switch (cmd)
+    {
+        case CTRL_SYNC:
+            return RES_OK;
+        case GET_SECTOR_COUNT:
+            *(LBA_t*)buff = RamSectors;
+            return RES_OK;
+        case GET_SECTOR_SIZE:
+            *(WORD*)buff = DISK_RAM_SECTOR_SIZE;
+            return RES_OK;
+        case GET_BLOCK_SIZE:
+            *(DWORD*)buff = 1;
+            return RES_OK;
+        default:
+            return RES_PARERR;
+    }
+}
+
+const DiskBackend DiskBackend_RAM =
+{
+    "RAM",
+    ram_initialize,
+    ram_status,
+    ram_read,
+    ram_write,
+    ram_ioctl,
+    NULL
+};
+
+DRESULT disk_ram_attach(BYTE pdrv, BYTE *Buffer, LBA_t SectorCount)
+{
+    if ((Buffer == NULL) || (SectorCount == 0u))
+    {
+        return RES_PARERR;
+    }
+    RamBase = Buffer;
+    RamSectors = SectorCount;
+    RamStat = STA_NOINIT;
+    return disk_attach(pdrv, &DiskBackend_RAM);
+}
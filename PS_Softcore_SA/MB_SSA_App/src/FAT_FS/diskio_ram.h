@@ -0,0 +1,33 @@
+/* =============================================================================
+ *  File: diskio_ram.h
+ *  Project: MicroBlaze + AXI Quad SPI (microSD Interface)
+ *  Author: IMR Engineering / Hab Collector
+ *  ---------------------------------------------------------------------------
+ *  Purpose:
+ *      RAM disk storage backend (diskio_ram.c).  Serves a drive from a caller
+ *      supplied memory region - DDR on the target, heap on the host - so the
+ *      FatFs stack can be exercised without a card.
+ * =============================================================================
+ */
+
+#ifndef _DISKIO_RAM_DEFINED
+#define _DISKIO_RAM_DEFINED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "diskio.h"
+
+#define DISK_RAM_SECTOR_SIZE    512U
+
+/* Backend table */
+extern const DiskBackend DiskBackend_RAM;
+
+/* Bind the memory region (SectorCount * 512 bytes) and attach it to pdrv */
+DRESULT disk_ram_attach(BYTE pdrv, BYTE *Buffer, LBA_t SectorCount);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _DISKIO_RAM_DEFINED */
@@ -0,0 +1,1191 @@
+/* =============================================================================
+ *  File: diskio_sd.c
+ *  Project: MicroBlaze + AXI Quad SPI (microSD Interface)
+ *  Author: IMR Engineering / Hab Collector
+ *  ---------------------------------------------------------------------------
+ *  Purpose:
+ *      This file implements the SD-over-SPI storage backend (DiskBackend_SD)
+ *      for use on a Xilinx MicroBlaze system where an SD or microSD card is
+ *      connected via an AXI Quad SPI (AXI QSPI) peripheral operating in
+ *      standard SPI mode.
+ *
+ *      FatFs (ff.c) is file-system independent and requires only five glue
+ *      functions: disk_initialize(), disk_status(), disk_read(), disk_write(),
+ *      and disk_ioctl().  diskio.c provides those and routes each drive to
+ *      an attached backend; this backend communicates with the physical SD
+ *      card using the SPI protocol over the AXI QSPI IP core and is the
+ *      default for drive 0 on the target.
+ *
+ *  ---------------------------------------------------------------------------
+ *  Functional Overview:
+ *      - The file initializes the AXI Quad SPI peripheral using its base
+ *        address (XSpi_CfgInitialize() with manual configuration).
+ *      - Commands such as CMD0, CMD8, ACMD41, and CMD58 are issued to
+ *        initialize SD or SDHC cards in SPI mode.
+ *      - Sector reads and writes (CMD17, CMD24) are supported for 512-byte
+ *        block transfers as required by FatFs; multi-sector writes use
+ *        CMD25 with a STOP_TRAN token.
+ *      - The interface is blocking/polled mode and uses FIFO transfers only.
+ *
+ *      This implementation is compact, requires no interrupts or DMA,
+ *      and provides reliable operation for single-card, single-drive systems.
+ *
+ *  ---------------------------------------------------------------------------
+ *  Required Hardware:
+ *      • MicroBlaze soft processor (Vitis 2024.2 standalone domain)
+ *      • AXI Quad SPI IP configured as:
+ *            - Mode: Standard SPI
+ *            - Master Mode: Enabled
+ *            - FIFO Depth: 16
+ *            - Performance Mode: Disabled
+ *            - XIP Mode: Disabled
+ *            - STARTUP Primitive: Disabled
+ *      • microSD card connected to SPI MISO/MOSI/SCLK/SS0.
+ *
+ *      **Clock Domains**
+ *      -----------------
+ *      The AXI Quad SPI IP has two main clock inputs:
+ *
+ *          1. s_axi_aclk   – The AXI4-Lite bus interface clock.
+ *             This clock drives register access timing between the
+ *             MicroBlaze processor and the SPI control registers.
+ *
+ *          2. ext_spi_clk  – The SPI bit clock domain used to clock
+ *             SCK, MISO, and MOSI signals to the external device.
+ *
+ *      In most designs these clocks can be tied together (both driven
+ *      by the same 100 MHz or 125 MHz system clock).  However, the
+ *      ext_spi_clk can also be generated separately (for example,
+ *      from a Clocking Wizard) to precisely control the SPI frequency.
+ *
+ *      The effective SPI clock rate (SCK) is derived inside the AXI QSPI
+ *      core from ext_spi_clk using its configured divider ratio.
+ *      For SD card initialization, keep SCK at ~400 kHz, then raise to
+ *      12–25 MHz for normal operation.
+ *
+ *  ---------------------------------------------------------------------------
+ *  How to Adapt for Other Implementations:
+ *
+ *      1. **SPI Base Address**
+ *         Update the macro `SPI_BASEADDR` to match the base address
+ *         assigned in Vivado’s Address Editor for your AXI Quad SPI instance.
+ *
+ *      2. **Slave Select Line**
+ *         Update `SPI_SS0_MASK` if your microSD is wired to SS1, SS2, etc.
+ *         (Bit 0 = SS0, Bit 1 = SS1, etc.)
+ *
+ *      3. **Clock Rates**
+ *         `SD_SPI_EXT_CLK_HZ` / `SD_SPI_SCK_RATIO` must match the ext_spi_clk
+ *         and C_SCK_RATIO of the AXI QSPI instance.  SCK is fixed by that
+ *         configuration - the block design has no divider the driver could
+ *         program - so card identification and data transfer run at the
+ *         same rate.  After ACMD41/CMD58 the card's CSD TRAN_SPEED is read
+ *         (CMD9) and reported next to SCK (disk_card_max_hz(),
+ *         disk_spi_clock_hz()) so a mismatch shows at mount.
+ *
+ *      4. **Multiple Drives**
+ *         If using more than one storage device, change `SD_SPI_DRIVE`
+ *         and extend the driver to handle multiple `pdrv` values.
+ *
+ *      5. **DMA or Interrupt Mode**
+ *         Reads go through a request queue (disk_read_async()) served one
+ *         FIFO at a time by either disk_async_isr() on the QSPI TX-empty
+ *         interrupt or disk_async_service() from the main loop; disk_read()
+ *         is a synchronous wrapper over it.  Route the QSPI interrupt to the
+ *         INTC (SD_SPI_FABRIC_ID in diskio_sd.h) to use IRQ mode.  DMA and
+ *         AXI Stream modes are **not supported**.  Command/response traffic uses
+ *         XSpi_Transfer() in blocking mode; the 512-byte data phase (and the
+ *         data-token scan) uses the FIFO-burst helpers Spi_Burst_Read() /
+ *         Spi_Burst_Write(), which drive the QSPI registers directly and keep
+ *         the FIFO (SPI_FIFO_DEPTH entries) full so SCK runs back-to-back.
+ *
+ *      6. **Alternative Hardware**
+ *         - To use another SPI controller (e.g., AXI SPI or PS SPI),
+ *           replace the XSpi_* functions with the equivalent driver API.
+ *         - To use SDIO or SD Host IP instead of SPI mode, you must switch
+ *           to Xilinx’s xsdps driver and FatFs “diskio_sdps.c” variant.
+ *
+ *      7. **Block Size**
+ *         This driver fixes block length to 512 bytes, which is required
+ *         by FatFs.  SDHC/SDXC cards ignore CMD16 and always use 512 B.
+ *
+ *      8. **Card Detection and Write Protect**
+ *         If your board supports CD/WP signals via GPIO, you may enhance
+ *         sd_status() to check those pins.
+ *
+ *  ---------------------------------------------------------------------------
+ *  File Version History:
+ *      v1.0  – Initial implementation for AXI Quad SPI standard mode (Hab)
+ *      v1.1  – Integrated with FatFs xilffs BSP; tested on Arty A7 (2025)
+ *      v1.2  – FIFO-burst register-level engine for the data block phase
+ *              (token scan, 512 B payload, CRC) replaces per-byte XSpi_Transfer
+ *      v1.3  – CSD TRAN_SPEED decode, init/run SCK switching via optional PL
+ *              divider, rate accessors for reporting at mount
+ *      v1.4  – Asynchronous read queue (IRQ or polled); disk_read() becomes a
+ *              thin wrapper over disk_read_async()
+ *      v1.5  – Sector cache (diskio_cache.c) between FatFs and the SD driver;
+ *              CTRL_SYNC flushes write-back lines
+ *      v1.6  – AXI-timer microsecond deadlines replace usleep poll counts;
+ *              CMD17 / CMD24 / token / busy latency histograms
+ *      v1.7  – Split out of diskio.c as a pluggable backend (DiskBackend_SD);
+ *              cache and FatFs glue now live in the diskio.c dispatcher
+ *      v1.8  – CMD25 multi-block write with STOP_TRAN for count > 1, timed in
+ *              its own latency class (command to not-busy)
+ *      v1.9  – SCK switching removed: the block design has no programmable
+ *              divider, so SCK is the fixed C_SCK_RATIO rate and is only reported
+ *
+ *  ---------------------------------------------------------------------------
+ *  References:
+ *      - ChaN FatFs documentation:  https://elm-chan.org/fsw/ff/
+ *      - AMD/Xilinx AXI Quad SPI PG153
+ *      - Vitis 2024.2 Standalone BSP Reference Guide
+ * =============================================================================
+ */
+
+#include "diskio_sd.h"
+#include "diskio_timing.h"
+#include "ff.h"
+#include "xil_types.h"
+#include "xstatus.h"
+#include "xspi.h"
+#include "xspi_l.h"
+#include "xil_io.h"
+#include "xparameters.h"
+#include "sleep.h"
+#include <string.h>
+
+/* ===================== User configuration (matches your design) ===================== */
+
+#define SPI_BASEADDR        0x44A00000u   /* From your Address Editor */
+#define SPI_SS0_MASK        0x01u         /* Using slave-select 0 (Pmod microSD) */
+#define SPI_FIFO_DEPTH      XPAR_AXI_QUAD_SPI_1_FIFO_SIZE /* TX/RX FIFO entries (16) */
+
+/* SCK source: ext_spi_clk (clk_wiz_1 clk_out5) / C_SCK_RATIO per PG153 */
+#define SD_SPI_EXT_CLK_HZ   50000000u     /* ext_spi_clk of axi_quad_spi_1 */
+#define SD_SPI_SCK_RATIO    2u            /* C_SCK_RATIO of axi_quad_spi_1 (BD_Softcore_SA.bd) */
+#define SD_SPI_SCK_HZ       (SD_SPI_EXT_CLK_HZ / SD_SPI_SCK_RATIO)
+
+#define SD_SPI_DRIVE        0             /* pdrv index (always 0 unless multiple cards) */
+
+#define SD_CMD_TIMEOUT_US   100000u       /* Generic command / ready timeout */
+#define SD_TOKEN_TIMEOUT_US 100000u       /* Read access time limit (SD spec: 100 ms) */
+#define SD_BUSY_TIMEOUT_US  500000u       /* Write busy limit (SD spec: 250 ms SDSC, 500 ms SDHC) */
+#define SD_ACMD41_TIMEOUT_MS 1200u        /* Init loop timeout */
+
+#define SD_ASYNC_QUEUE_DEPTH 8u           /* Outstanding async read requests */
+
+/* ==================================================================================== */
+
+/* Internal state */
+static XSpi Spi;              /* SPI driver instance (base-address init) */
+static u8 CardIsReady = 0;    /* 1 when initialized */
+static u8 CardHighCapacity = 0; /* 1 if SDHC/SDXC (block addressing) */
+static u32 SpiClockHz = 0;    /* SCK currently applied to the card */
+static u32 CardMaxHz = 0;     /* Card limit decoded from CSD TRAN_SPEED (0 = unknown) */
+
+/* ===================== Minimal SPI helpers ===================== */
+
+static int Spi_Init(void)
+{
+    XSpi_Config Cfg;
+
+    /* Zero-init then set only what XSpi_CfgInitialize actually needs */
+    memset(&Cfg, 0, sizeof(Cfg));
+    Cfg.BaseAddress = SPI_BASEADDR;
+
+    /* Initialize by base address (no device ID) */
+    if (XSpi_CfgInitialize(&Spi, &Cfg, Cfg.BaseAddress) != XST_SUCCESS)
+    {
+        return XST_FAILURE;
+    }
+
+    XSpi_Reset(&Spi);
+
+    /* Master, manual slave-select, manual start off (let driver handle it) */
+    u32 Options = XSP_MASTER_OPTION | XSP_MANUAL_SSELECT_OPTION;
+    if (XSpi_SetOptions(&Spi, Options) != XST_SUCCESS)
+    {
+        return XST_FAILURE;
+    }
+
+    /* Clear any stale FIFOs; start the device */
+    XSpi_Start(&Spi);
+    XSpi_IntrGlobalDisable(&Spi);
+
+    /* Select SS0 (active-low) but don’t toggle yet; XSpi_Transfer asserts as needed */
+    XSpi_SetSlaveSelect(&Spi, SPI_SS0_MASK);
+
+    /* NOTE on SPI clock:
+       AXI Quad SPI’s SCK is derived in hardware from ext_spi_clk and C_SCK_RATIO
+       (SD_SPI_SCK_HZ).  There is no software control of it in this design. */
+    return XST_SUCCESS;
+}
+
+static void Spi_ShortDelayUs(u32 usec)
+{
+    /* usleep is available in standalone */
+    if (usec) usleep(usec);
+}
+
+static void Spi_TxRx(const u8 *Tx, u8 *Rx, u32 Len)
+{
+    /* XSpi_Transfer handles full-duplex; pass NULL for Tx/Rx as needed */
+    XSpi_Transfer(&Spi, (u8*)Tx, Rx, Len);
+}
+
+static u8 Spi_TxRx_Byte(u8 out)
+{
+    u8 in = 0xFF;
+    XSpi_Transfer(&Spi, &out, &in, 1);
+    return in;
+}
+
+static u8 Spi_Read_Byte(void)
+{
+    u8 out = 0xFF, in = 0xFF;
+    XSpi_Transfer(&Spi, &out, &in, 1);
+    return in;
+}
+
+static void Spi_Write_Byte(u8 b)
+{
+    u8 dummy;
+    XSpi_Transfer(&Spi, &b, &dummy, 1);
+}
+
+/* ===================== FIFO-burst SPI engine ===================== */
+/*
+ * XSpi_Transfer() costs a full driver round trip (state checks, FIFO reset,
+ * inhibit toggling, slave-select update) for every call.  For the 512-byte
+ * data phase that overhead dominates the wire time, so the helpers below
+ * talk to the AXI Quad SPI registers directly:
+ *
+ *   - SS0 is asserted once for the whole burst via the SSR register and the
+ *     transmitter inhibit is lifted only while the burst runs.
+ *   - The TX FIFO is kept topped up (never more than SPI_FIFO_DEPTH bytes
+ *     in flight so the RX FIFO can not overrun).
+ *   - The RX FIFO is drained as soon as bytes arrive, so SCK keeps running
+ *     back-to-back at the configured line rate.
+ *
+ * These helpers assume Spi_Init() has already configured the core as a
+ * master with manual slave select and that no XSpi_Transfer() is in progress.
+ */
+
+/* Discard anything left in the RX FIFO before starting a burst */
+static void Spi_Burst_FlushRx(void)
+{
+    while ((Xil_In32(SPI_BASEADDR + XSP_SR_OFFSET) & XSP_SR_RX_EMPTY_MASK) == 0u)
+    {
+        (void)Xil_In32(SPI_BASEADDR + XSP_DRR_OFFSET);
+    }
+}
+
+/* Core burst loop: Tx may be NULL (send 0xFF), Rx may be NULL (discard) */
+static void Spi_Burst(const u8 *Tx, u8 *Rx, u32 Len)
+{
+    u32 Sent = 0;
+    u32 Received = 0;
+
+    if (Len == 0u)
+    {
+        return;
+    }
+
+    Spi_Burst_FlushRx();
+
+    /* Hold CS low for the whole burst and let the master clock out */
+    Xil_Out32(SPI_BASEADDR + XSP_SSR_OFFSET, Spi.SlaveSelectReg);
+    Xil_Out32(SPI_BASEADDR + XSP_CR_OFFSET,
+              Xil_In32(SPI_BASEADDR + XSP_CR_OFFSET) & ~XSP_CR_TRANS_INHIBIT_MASK);
+
+    while (Received < Len)
+    {
+        /* Top up the TX FIFO - bytes in flight never exceed the FIFO depth */
+        while ((Sent < Len) && ((Sent - Received) < SPI_FIFO_DEPTH))
+        {
+            Xil_Out32(SPI_BASEADDR + XSP_DTR_OFFSET, (Tx != NULL) ? (u32)Tx[Sent] : 0xFFu);
+            Sent++;
+        }
+
+        /* Drain whatever has arrived */
+        while ((Received < Sent) &&
+               ((Xil_In32(SPI_BASEADDR + XSP_SR_OFFSET) & XSP_SR_RX_EMPTY_MASK) == 0u))
+        {
+            u8 In = (u8)Xil_In32(SPI_BASEADDR + XSP_DRR_OFFSET);
+            if (Rx != NULL)
+            {
+                Rx[Received] = In;
+            }
+            Received++;
+        }
+    }
+
+    /* Inhibit the transmitter and release CS - same end state as XSpi_Transfer() */
+    Xil_Out32(SPI_BASEADDR + XSP_CR_OFFSET,
+              Xil_In32(SPI_BASEADDR + XSP_CR_OFFSET) | XSP_CR_TRANS_INHIBIT_MASK);
+    Xil_Out32(SPI_BASEADDR + XSP_SSR_OFFSET, Spi.SlaveSelectMask);
+}
+
+/* Clock in Len bytes while sending 0xFF */
+static void Spi_Burst_Read(u8 *Rx, u32 Len)
+{
+    Spi_Burst(NULL, Rx, Len);
+}
+
+/* Clock out Len bytes, discarding MISO */
+static void Spi_Burst_Write(const u8 *Tx, u32 Len)
+{
+    Spi_Burst(Tx, NULL, Len);
+}
+
+/* ============== SD over SPI primitives (tokens, commands) ============== */
+
+#define SD_TOKEN_START_BLOCK   0xFEu
+#define SD_TOKEN_MULTI_WRITE   0xFCu   /* start block of a CMD25 write */
+#define SD_TOKEN_STOP_TRAN     0xFDu   /* ends a CMD25 write */
+
+/* R1 bits */
+#define R1_IDLE_STATE          0x01u
+#define R1_ILLEGAL_COMMAND     0x04u
+
+/* Commands (SPI has bit 6 set) */
+#define CMD0    (0u)    /* GO_IDLE_STATE */
+#define CMD8    (8u)    /* SEND_IF_COND */
+#define CMD9    (9u)    /* SEND_CSD */
+#define CMD16   (16u)   /* SET_BLOCKLEN */
+#define CMD17   (17u)   /* READ_SINGLE_BLOCK */
+#define CMD24   (24u)   /* WRITE_SINGLE_BLOCK */
+#define CMD25   (25u)   /* WRITE_MULTIPLE_BLOCK */
+#define CMD55   (55u)   /* APP_CMD */
+#define CMD58   (58u)   /* READ_OCR */
+#define ACMD41  (41u)   /* SD_SEND_OP_COND (after CMD55) */
+
+/* Send N dummy clocks (CS high) */
+static void sd_send_dummy_clocks(u32 nbytes)
+{
+    /* Ensure CS is deasserted before sending idle clocks */
+    XSpi_SetSlaveSelect(&Spi, SPI_SS0_MASK);
+    for (u32 i = 0; i < nbytes; i++)
+    {
+        Spi_Write_Byte(0xFF);
+    }
+}
+
+/* Select the card (CS low) */
+static void sd_select(void)
+{
+    /* XSpi driver asserts SS for the device selected via SetSlaveSelect;
+       to guarantee min setup time, push one idle byte */
+    Spi_Write_Byte(0xFF);
+}
+
+/* Deselect the card (CS high) */
+static void sd_deselect(void)
+{
+    sd_send_dummy_clocks(2); /* at least 8 clocks after CS high */
+}
+
+/* Wait for the card to release MISO (0xFF) with a timeout in us; busy time goes to the BUSY histogram */
+static int sd_wait_ready(u32 timeout_us)
+{
+    if (Spi_Read_Byte() == 0xFF)
+    {
+        return XST_SUCCESS; /* not busy - nothing to record */
+    }
+
+    u32 start = disk_time_now();
+    while (!disk_time_expired(start, timeout_us))
+    {
+        if (Spi_Read_Byte() == 0xFF)
+        {
+            disk_latency_record(DISK_LAT_BUSY, start);
+            return XST_SUCCESS; /* bus free / card ready */
+        }
+    }
+    disk_latency_record(DISK_LAT_BUSY, start);
+    return XST_FAILURE;
+}
+
+/* Send a command (CMD or ACMD) and get R1 */
+static u8 sd_send_cmd(u8 cmd, u32 arg, u8 crc)
+{
+    /* ACMD prefix: CMD55 then the app command */
+    if (cmd & 0x80u)
+    {
+        cmd &= 0x7Fu;
+        (void)sd_send_cmd(CMD55, 0, 0x65); /* valid CRC for CMD55 isn’t required after idle, harmless */
+    }
+
+    /* Ensure card ready to receive a command */
+    (void)sd_wait_ready(SD_CMD_TIMEOUT_US);
+
+    /* Command frame: 0x40|cmd, arg[31:0], crc */
+    u8 frame[6];
+    frame[0] = (u8)(0x40u | cmd);
+    frame[1] = (u8)(arg >> 24);
+    frame[2] = (u8)(arg >> 16);
+    frame[3] = (u8)(arg >> 8);
+    frame[4] = (u8)(arg);
+    frame[5] = crc | 0x01u; /* end bit = 1 */
+
+    Spi_TxRx(frame, NULL, 6);
+
+    /* Read R1 (response within 8 bytes) */
+    for (int i = 0; i < 8; i++)
+    {
+        u8 r1 = Spi_Read_Byte();
+        if ((r1 & 0x80u) == 0u)
+        {
+            return r1;
+        }
+    }
+    return 0xFFu; /* timeout */
+}
+
+/* Read a data block (len bytes, len >= SPI_FIFO_DEPTH) after a READ/CMD9; returns 0 on success */
+static int sd_read_data(u8 *buff, u32 len, u32 timeout_us)
+{
+    u32 start = disk_time_now();
+    u8 scan[SPI_FIFO_DEPTH];
+    u8 crc[2];
+
+    /* Wait for data token 0xFE - poll a FIFO's worth of bytes per burst, no sleeping */
+    while (!disk_time_expired(start, timeout_us))
+    {
+        Spi_Burst_Read(scan, SPI_FIFO_DEPTH);
+        for (u32 k = 0; k < SPI_FIFO_DEPTH; k++)
+        {
+            if (scan[k] == SD_TOKEN_START_BLOCK)
+            {
+                disk_latency_record(DISK_LAT_TOKEN, start);
+
+                /* Bytes clocked in after the token already belong to the block */
+                u32 carry = SPI_FIFO_DEPTH - 1u - k;
+                memcpy(buff, &scan[k + 1u], carry);
+
+                /* read the rest of the block */
+                Spi_Burst_Read(&buff[carry], len - carry);
+
+                /* discard CRC */
+                Spi_Burst_Read(crc, sizeof(crc));
+                return 0;
+            }
+            if (scan[k] != 0xFF)
+            {
+                /* error token */
+                return -1;
+            }
+        }
+    }
+    return -2;
+}
+
+/* Decode CSD TRAN_SPEED (byte 3) into a bit rate in Hz */
+static u32 sd_decode_tran_speed(u8 TranSpeed)
+{
+    /* Time value x10 (bits 6:3) and rate unit (bits 2:0) per SD Physical Layer spec */
+    static const u8 TimeValueX10[16] = {0, 10, 12, 13, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 70, 80};
+    static const u32 RateUnit[4] = {100000u, 1000000u, 10000000u, 100000000u};
+    u32 Unit = TranSpeed & 0x07u;
+
+    if (Unit > 3u)
+    {
+        return 0u; /* reserved */
+    }
+    return (RateUnit[Unit] / 10u) * TimeValueX10[(TranSpeed >> 3) & 0x0Fu];
+}
+
+/* Write a data block (512B) after CMD24 / CMD25 with its start token; returns 0 on success */
+static int sd_write_block(const u8 *buff, u8 token)
+{
+    static const u8 dummy_crc[2] = {0xFF, 0xFF};
+
+    /* Start token */
+    Spi_Write_Byte(token);
+
+    /* Data */
+    Spi_Burst_Write(buff, 512u);
+
+    /* Dummy CRC (not used in SPI mode) */
+    Spi_Burst_Write(dummy_crc, sizeof(dummy_crc));
+
+    /* Data response: 0bxxx00101 accepted */
+    u8 resp = Spi_Read_Byte() & 0x1Fu;
+    if (resp != 0x05u)
+    {
+        return -1;
+    }
+
+    /* Wait while card is busy (drives MISO low) */
+    if (sd_wait_ready(SD_BUSY_TIMEOUT_US) != XST_SUCCESS)
+    {
+        return -2;
+    }
+    return 0;
+}
+
+static DSTATUS Stat = STA_NOINIT;
+
+/* ===================== Asynchronous read request queue ===================== */
+/*
+ * Read requests {LBA, count, buffer, callback} are queued and served by a
+ * byte-stream state machine that moves at most one FIFO of bytes per step.
+ * A step runs once the TX FIFO has drained: from disk_async_isr() when the
+ * AXI QSPI interrupt is routed to the INTC (disk_async_irq_mode(1)), or from
+ * disk_async_service() called by the main loop otherwise.  While a request
+ * is in flight CS stays asserted and the transmitter runs uninhibited, so
+ * the CPU is only needed once per SPI_FIFO_DEPTH bytes.
+ *
+ * Writes stay synchronous; disk_write(), disk_ioctl() and disk_initialize()
+ * first wait for the queue to drain so the card never sees interleaved
+ * commands.
+ */
+
+typedef enum
+{
+    SD_ASYNC_IDLE = 0,
+    SD_ASYNC_R1,            /* waiting for R1 of CMD17 */
+    SD_ASYNC_TOKEN,         /* waiting for data token 0xFE */
+    SD_ASYNC_DATA,          /* 512 data bytes */
+    SD_ASYNC_CRC            /* 2 CRC bytes */
+} SdAsyncState;
+
+typedef struct
+{
+    BYTE *Buffer;
+    LBA_t Sector;
+    UINT Count;
+    DiskAsyncCallback Callback;
+    void *Context;
+} SdAsyncRequest;
+
+static SdAsyncRequest AsyncQueue[SD_ASYNC_QUEUE_DEPTH];
+static volatile u32 AsyncHead = 0;      /* next request to serve (free running) */
+static volatile u32 AsyncTail = 0;      /* next free slot (free running) */
+static volatile SdAsyncState AsyncState = SD_ASYNC_IDLE;
+static u32 AsyncInFlight = 0;           /* bytes pushed to the TX FIFO this step */
+static u32 AsyncSkip = 0;               /* RX bytes to ignore (command frame) */
+static u32 AsyncCount = 0;              /* bytes consumed in the current phase */
+static u32 AsyncSectorStart = 0;        /* ticks: CMD17 issued */
+static u32 AsyncTokenStart = 0;         /* ticks: R1 received */
+static u8 AsyncIrqMode = 0;             /* 1 when disk_async_isr() is connected */
+
+/*
+ * The QSPI global interrupt is only enabled while the engine is busy in IRQ
+ * mode.  XSpi_Transfer() switches to its own interrupt protocol when DGIER is
+ * set, so the synchronous command path must always find it cleared.
+ */
+
+/* Mask the QSPI interrupt around queue updates made from thread context */
+static void sd_async_lock(void)
+{
+    Xil_Out32(SPI_BASEADDR + XSP_DGIER_OFFSET, 0u);
+}
+
+static void sd_async_unlock(void)
+{
+    if (AsyncIrqMode && (AsyncState != SD_ASYNC_IDLE))
+    {
+        Xil_Out32(SPI_BASEADDR + XSP_DGIER_OFFSET, XSP_GINTR_ENABLE_MASK);
+    }
+}
+
+/* Queue n TX bytes (NULL = 0xFF) for this step */
+static void sd_async_push(const u8 *tx, u32 n)
+{
+    for (u32 i = 0; i < n; i++)
+    {
+        Xil_Out32(SPI_BASEADDR + XSP_DTR_OFFSET, (tx != NULL) ? (u32)tx[i] : 0xFFu);
+    }
+    AsyncInFlight = n;
+}
+
+/* Issue CMD17 for the sector at the head of the queue */
+static void sd_async_begin_sector(void)
+{
+    SdAsyncRequest *Req = &AsyncQueue[AsyncHead % SD_ASYNC_QUEUE_DEPTH];
+    u32 addr = (CardHighCapacity) ? (u32)Req->Sector : (u32)(Req->Sector * 512u);
+    u8 tx[15];
+
+    /* one idle byte, 6-byte frame, then up to 8 bytes for R1 */
+    tx[0] = 0xFF;
+    tx[1] = (u8)(0x40u | CMD17);
+    tx[2] = (u8)(addr >> 24);
+    tx[3] = (u8)(addr >> 16);
+    tx[4] = (u8)(addr >> 8);
+    tx[5] = (u8)(addr);
+    tx[6] = 0xE1 | 0x01u;
+    memset(&tx[7], 0xFF, 8);
+
+    AsyncSkip = 7;
+    AsyncCount = 0;
+    AsyncSectorStart = disk_time_now();
+    AsyncState = SD_ASYNC_R1;
+    sd_async_push(tx, sizeof(tx));
+}
+
+/* Start the head request (if any) or park the engine */
+static void sd_async_start_next(void)
+{
+    if (AsyncHead == AsyncTail)
+    {
+        AsyncState = SD_ASYNC_IDLE;
+        AsyncInFlight = 0;
+        if (AsyncIrqMode)
+        {
+            XSpi_IntrDisable(&Spi, XSP_INTR_TX_EMPTY_MASK);
+            XSpi_IntrGlobalDisable(&Spi);
+        }
+        /* Inhibit and release CS - same end state as XSpi_Transfer() */
+        Xil_Out32(SPI_BASEADDR + XSP_CR_OFFSET,
+                  Xil_In32(SPI_BASEADDR + XSP_CR_OFFSET) | XSP_CR_TRANS_INHIBIT_MASK);
+        Xil_Out32(SPI_BASEADDR + XSP_SSR_OFFSET, Spi.SlaveSelectMask);
+        return;
+    }
+
+    /* Select the card and let the master run for the whole request */
+    Spi_Burst_FlushRx();
+    Xil_Out32(SPI_BASEADDR + XSP_SSR_OFFSET, Spi.SlaveSelectReg);
+    sd_async_begin_sector();
+    Xil_Out32(SPI_BASEADDR + XSP_CR_OFFSET,
+              Xil_In32(SPI_BASEADDR + XSP_CR_OFFSET) & ~XSP_CR_TRANS_INHIBIT_MASK);
+    if (AsyncIrqMode)
+    {
+        XSpi_IntrClear(&Spi, XSP_INTR_TX_EMPTY_MASK);
+        XSpi_IntrEnable(&Spi, XSP_INTR_TX_EMPTY_MASK);
+        XSpi_IntrGlobalEnable(&Spi);
+    }
+}
+
+/* Complete the head request and move on */
+static void sd_async_finish(DRESULT Result)
+{
+    SdAsyncRequest *Req = &AsyncQueue[AsyncHead % SD_ASYNC_QUEUE_DEPTH];
+    DiskAsyncCallback Callback = Req->Callback;
+    void *Context = Req->Context;
+
+    AsyncHead++;
+    AsyncState = SD_ASYNC_IDLE;
+    if (Callback != NULL)
+    {
+        Callback(Context, Result);
+    }
+
+    /* Stop the clock between requests, then start the next one */
+    Xil_Out32(SPI_BASEADDR + XSP_CR_OFFSET,
+              Xil_In32(SPI_BASEADDR + XSP_CR_OFFSET) | XSP_CR_TRANS_INHIBIT_MASK);
+    sd_async_start_next();
+}
+
+/* Feed the RX bytes of the last step through the state machine */
+static void sd_async_consume(const u8 *rx, u32 n)
+{
+    SdAsyncRequest *Req = &AsyncQueue[AsyncHead % SD_ASYNC_QUEUE_DEPTH];
+
+    for (u32 i = 0; i < n; i++)
+    {
+        u8 b = rx[i];
+
+        if (AsyncSkip > 0u)
+        {
+            AsyncSkip--;
+            continue;
+        }
+
+        switch (AsyncState)
+        {
+            case SD_ASYNC_R1:
+                if ((b & 0x80u) == 0u)
+                {
+                    if (b != 0x00u)
+                    {
+                        sd_async_finish(RES_ERROR);
+                        return;
+                    }
+                    AsyncState = SD_ASYNC_TOKEN;
+                    AsyncTokenStart = disk_time_now();
+                }
+                else if (++AsyncCount >= 8u)
+                {
+                    sd_async_finish(RES_ERROR);   /* no R1 */
+                    return;
+                }
+                break;
+
+            case SD_ASYNC_TOKEN:
+                if (b == SD_TOKEN_START_BLOCK)
+                {
+                    disk_latency_record(DISK_LAT_TOKEN, AsyncTokenStart);
+                    AsyncState = SD_ASYNC_DATA;
+                    AsyncCount = 0;
+                }
+                else if (b != 0xFF)
+                {
+                    sd_async_finish(RES_ERROR);   /* error token */
+                    return;
+                }
+                break;
+
+            case SD_ASYNC_DATA:
+                Req->Buffer[AsyncCount++] = b;
+                if (AsyncCount == 512u)
+                {
+                    AsyncState = SD_ASYNC_CRC;
+                    AsyncCount = 0;
+                }
+                break;
+
+            case SD_ASYNC_CRC:
+                if (++AsyncCount == 2u)
+                {
+                    /* Sector complete (CRC discarded) */
+                    disk_latency_record(DISK_LAT_CMD17, AsyncSectorStart);
+                    Req->Buffer += 512u;
+                    Req->Sector++;
+                    if (--Req->Count == 0u)
+                    {
+                        sd_async_finish(RES_OK);
+                    }
+                    else
+                    {
+                        sd_async_begin_sector();
+                    }
+                    return;
+                }
+                break;
+
+            default:
+                return;
+        }
+    }
+
+    if ((AsyncState == SD_ASYNC_TOKEN) && disk_time_expired(AsyncTokenStart, SD_TOKEN_TIMEOUT_US))
+    {
+        sd_async_finish(RES_ERROR);   /* token timeout */
+    }
+}
+
+/* One engine step: collect the last FIFO's worth of RX, then queue the next */
+static void sd_async_step(void)
+{
+    u8 rx[SPI_FIFO_DEPTH];
+    u32 n = AsyncInFlight;
+
+    if (AsyncState == SD_ASYNC_IDLE)
+    {
+        return;
+    }
+
+    /* TX empty: the last byte is in the shifter, its RX follows within a byte time */
+    for (u32 i = 0; i < n; i++)
+    {
+        while (Xil_In32(SPI_BASEADDR + XSP_SR_OFFSET) & XSP_SR_RX_EMPTY_MASK) { }
+        rx[i] = (u8)Xil_In32(SPI_BASEADDR + XSP_DRR_OFFSET);
+    }
+
+    AsyncInFlight = 0;
+    sd_async_consume(rx, n);
+
+    /* Nothing queued by a phase change - keep clocking */
+    if ((AsyncState != SD_ASYNC_IDLE) && (AsyncInFlight == 0u))
+    {
+        u32 need = SPI_FIFO_DEPTH;
+        if (AsyncState == SD_ASYNC_DATA) need = (512u - AsyncCount) + 2u;
+        if (AsyncState == SD_ASYNC_CRC)  need = 2u - AsyncCount;
+        if (need > SPI_FIFO_DEPTH) need = SPI_FIFO_DEPTH;
+        sd_async_push(NULL, need);
+    }
+}
+
+/* Completion record for the synchronous disk_read() wrapper */
+typedef struct
+{
+    volatile u8 Done;
+    volatile DRESULT Result;
+} SdSyncWait;
+
+static void sd_sync_done(void *Context, DRESULT Result)
+{
+    SdSyncWait *Wait = (SdSyncWait*)Context;
+    Wait->Result = Result;
+    Wait->Done = 1u;
+}
+
+/* Block until every queued request has completed */
+static void sd_async_wait_idle(void)
+{
+    while (AsyncHead != AsyncTail)
+    {
+        disk_async_service();
+    }
+}
+
+/* Queue a read; Callback(Context, Result) runs from the step that completes it */
+static DRESULT sd_read_async(BYTE pdrv, BYTE* buff, LBA_t sector, UINT count, DiskAsyncCallback Callback, void *Context)
+{
+    if ((pdrv != SD_SPI_DRIVE) || (count == 0u) || (buff == NULL))
+    {
+        return RES_PARERR;
+    }
+    if (Stat & STA_NOINIT)
+    {
+        return RES_NOTRDY;
+    }
+
+    sd_async_lock();
+    if ((AsyncTail - AsyncHead) >= SD_ASYNC_QUEUE_DEPTH)
+    {
+        sd_async_unlock();
+        return RES_NOTRDY;   /* queue full - try again after a completion */
+    }
+
+    SdAsyncRequest *Req = &AsyncQueue[AsyncTail % SD_ASYNC_QUEUE_DEPTH];
+    Req->Buffer = buff;
+    Req->Sector = sector;
+    Req->Count = count;
+    Req->Callback = Callback;
+    Req->Context = Context;
+    AsyncTail++;
+
+    if (AsyncState == SD_ASYNC_IDLE)
+    {
+        sd_async_start_next();
+    }
+    sd_async_unlock();
+    return RES_OK;
+}
+
+/* Polled engine: call from the main loop when the QSPI IRQ is not connected */
+void disk_async_service(void)
+{
+    if (AsyncIrqMode)
+    {
+        return;   /* the ISR owns the engine */
+    }
+    if ((AsyncState != SD_ASYNC_IDLE) &&
+        (Xil_In32(SPI_BASEADDR + XSP_SR_OFFSET) & XSP_SR_TX_EMPTY_MASK))
+    {
+        sd_async_step();
+    }
+}
+
+/* QSPI interrupt handler - connect with connectPeripheral_IRQ(.., SD_SPI_FABRIC_ID, disk_async_isr, NULL) */
+void disk_async_isr(void *CallbackRef)
+{
+    (void)CallbackRef;
+    u32 Pending = XSpi_IntrGetStatus(&Spi) & XSpi_IntrGetEnabled(&Spi);
+
+    XSpi_IntrClear(&Spi, Pending);
+    if (Pending & XSP_INTR_TX_EMPTY_MASK)
+    {
+        sd_async_step();
+    }
+}
+
+/* Select interrupt (1) or polled (0) operation; connect disk_async_isr() before enabling */
+void disk_async_irq_mode(u8 Enable)
+{
+    sd_async_wait_idle();
+    AsyncIrqMode = (Enable != 0u);
+    if ((Stat & STA_NOINIT) == 0u)
+    {
+        XSpi_IntrDisable(&Spi, XSP_INTR_ALL);
+        XSpi_IntrGlobalDisable(&Spi);
+    }
+}
+
+/* Number of requests queued or in flight */
+u32 disk_async_pending(void)
+{
+    return AsyncTail - AsyncHead;
+}
+
+/* ===================== Backend operations ===================== */
+
+static DSTATUS sd_status (BYTE pdrv)
+{
+    if (pdrv != SD_SPI_DRIVE)
+    {
+        return STA_NOINIT;
+    }
+    return Stat;
+}
+
+/* Card init sequence (SPI mode) */
+static DSTATUS sd_initialize (BYTE pdrv)
+{
+    if (pdrv != SD_SPI_DRIVE)
+    {
+        return STA_NOINIT;
+    }
+
+    /* Never re-init under an in-flight read */
+    if ((Stat & STA_NOINIT) == 0u)
+    {
+        sd_async_wait_idle();
+    }
+
+    if (Spi_Init() != XST_SUCCESS)
+    {
+        Stat |= STA_NOINIT;
+        return Stat;
+    }
+
+    SpiClockHz = SD_SPI_SCK_HZ;
+    CardMaxHz = 0;
+
+    /* Give the card >=74 clock cycles with CS high */
+    sd_deselect();
+    sd_send_dummy_clocks(10);
+
+    /* Select card (CS low) and send CMD0 to go idle */
+    sd_select();
+    u8 r1 = sd_send_cmd(CMD0, 0, 0x95);  /* Valid CRC for CMD0 */
+    if (r1 != R1_IDLE_STATE)
+    {
+        sd_deselect();
+        Stat |= STA_NOINIT;
+        return Stat;
+    }
+
+    /* CMD8: check voltage range / SDHC */
+    r1 = sd_send_cmd(CMD8, 0x000001AAu, 0x87); /* VHS=0x1 (2.7-3.6V), check pattern 0xAA */
+    if (r1 & R1_ILLEGAL_COMMAND)
+    {
+        /* Older v1.x card (no CMD8); treat as SDSC */
+        CardHighCapacity = 0;
+    }
+    else
+    {
+        /* Read CMD8 trailing bytes (R7) */
+        u8 r7[4] = {0};
+        for (int i = 0; i < 4; i++) r7[i] = Spi_Read_Byte();
+        /* If echo-back matches 0xAA, proceed */
+        CardHighCapacity = 0; /* set after ACMD41 with HCS */
+    }
+
+    /* ACMD41 loop with HCS bit if we assume SDv2 */
+    u32 waited_ms = 0;
+    do
+    {
+        r1 = sd_send_cmd(0x80u | ACMD41, 0x40000000u, 0x77); /* HCS=1 */
+        if (r1 == 0x00u) break;             /* Ready */
+        usleep(10000);                      /* 10 ms */
+        waited_ms += 10;
+    } while (waited_ms < SD_ACMD41_TIMEOUT_MS);
+
+    if (r1 != 0x00u)
+    {
+        sd_deselect();
+        Stat |= STA_NOINIT;
+        return Stat;
+    }
+
+    /* CMD58: read OCR to infer CCS (high capacity) */
+    r1 = sd_send_cmd(CMD58, 0, 0xFD);
+    if (r1 == 0x00u)
+    {
+        u8 ocr[4];
+        for (int i = 0; i < 4; i++) ocr[i] = Spi_Read_Byte();
+        CardHighCapacity = ( (ocr[0] & 0x40u) != 0u ); /* CCS bit */
+    }
+
+    /* Force 512-byte block length for SDSC; SDHC ignores CMD16 */
+    (void)sd_send_cmd(CMD16, 512u, 0x15);
+
+    /* CMD9: read CSD for TRAN_SPEED (max transfer rate of the card) */
+    r1 = sd_send_cmd(CMD9, 0, 0xAF);
+    if (r1 == 0x00u)
+    {
+        u8 csd[16];
+        if (sd_read_data(csd, sizeof(csd), SD_TOKEN_TIMEOUT_US) == 0)
+        {
+            CardMaxHz = sd_decode_tran_speed(csd[3]);
+        }
+    }
+
+    sd_deselect();
+
+    CardIsReady = 1;
+    Stat &= (DSTATUS)~STA_NOINIT;
+    return Stat;
+}
+
+static DRESULT sd_disk_read (BYTE pdrv, BYTE* buff, LBA_t sector, UINT count)
+{
+    SdSyncWait Wait = { 0u, RES_ERROR };
+
+    if ((pdrv != SD_SPI_DRIVE) || (count == 0u) || (buff == NULL))
+    {
+        return RES_PARERR;
+    }
+    if (Stat & STA_NOINIT)
+    {
+        return RES_NOTRDY;
+    }
+
+    /* Thin wrapper: queue behind any read-ahead and run the engine until done */
+    while (sd_read_async(pdrv, buff, sector, count, sd_sync_done, (void*)&Wait) == RES_NOTRDY)
+    {
+        disk_async_service();   /* queue full */
+    }
+    while (!Wait.Done)
+    {
+        disk_async_service();
+    }
+
+    return Wait.Result;
+}
+
+#if FF_FS_READONLY == 0
+static DRESULT sd_disk_write (BYTE pdrv, const BYTE* buff, LBA_t sector, UINT count)
+{
+    if ((pdrv != SD_SPI_DRIVE) || (count == 0u) || (buff == NULL))
+    {
+        return RES_PARERR;
+    }
+    if (Stat & STA_NOINIT)
+    {
+        return RES_NOTRDY;
+    }
+
+    /* Reads queued before this write complete first */
+    sd_async_wait_idle();
+
+    /* Convert to byte address for SDSC */
+    u32 addr = (CardHighCapacity) ? (u32)sector : (u32)(sector * 512u);
+
+    /* Multi-sector: one CMD25, a 0xFC token per block and STOP_TRAN - the card
+       programs back to back instead of a command and busy cycle per sector */
+    if (count > 1u)
+    {
+        sd_select();
+
+        u32 start = disk_time_now();
+        u8 r1 = sd_send_cmd(CMD25, addr, 0x01);
+        if (r1 != 0x00u)
+        {
+            sd_deselect();
+            return RES_ERROR;
+        }
+
+        for (UINT i = 0; i < count; i++)
+        {
+            if (sd_write_block(&buff[i * 512u], SD_TOKEN_MULTI_WRITE) != 0)
+            {
+                /* Stop the transfer so the card leaves receive-data state */
+                Spi_Write_Byte(SD_TOKEN_STOP_TRAN);
+                (void)Spi_Read_Byte();
+                (void)sd_wait_ready(SD_BUSY_TIMEOUT_US);
+                sd_deselect();
+                return RES_ERROR;
+            }
+        }
+
+        /* STOP_TRAN, one byte before busy starts, then wait out the programming */
+        Spi_Write_Byte(SD_TOKEN_STOP_TRAN);
+        (void)Spi_Read_Byte();
+        if (sd_wait_ready(SD_BUSY_TIMEOUT_US) != XST_SUCCESS)
+        {
+            sd_deselect();
+            return RES_ERROR;
+        }
+
+        disk_latency_record(DISK_LAT_CMD25, start);
+        sd_deselect();
+        return RES_OK;
+    }
+
+    for (UINT i = 0; i < count; i++)
+    {
+        sd_select();
+
+        u32 start = disk_time_now();
+        u8 r1 = sd_send_cmd(CMD24, addr, 0xE1);
+        if (r1 != 0x00u)
+        {
+            sd_deselect();
+            return RES_ERROR;
+        }
+
+        if (sd_write_block(&buff[i * 512u], SD_TOKEN_START_BLOCK) != 0)
+        {
+            sd_deselect();
+            return RES_ERROR;
+        }
+
+        disk_latency_record(DISK_LAT_CMD24, start);
+        sd_deselect();
+
+        /* Next LBA */
+        if (!CardHighCapacity) addr += 512u; else addr += 1u;
+    }
+
+    return RES_OK;
+}
+
+#endif /* FF_FS_READONLY == 0 */
+
+static DRESULT sd_ioctl (BYTE pdrv, BYTE cmd, void* buff)
+{
+    if (pdrv != SD_SPI_DRIVE) return RES_PARERR;
+    if (Stat & STA_NOINIT)    return RES_NOTRDY;
+
+    sd_async_wait_idle();
+
+    switch (cmd)
+    {
+        case CTRL_SYNC:
+            /* Ensure card not busy */
+            return (sd_wait_ready(SD_BUSY_TIMEOUT_US) == XST_SUCCESS) ? RES_OK : RES_ERROR;
+
+        case GET_SECTOR_SIZE:
+            *(DWORD*)buff = 512u;
+            return RES_OK;
+
+        case GET_BLOCK_SIZE:
+            /* Erase block size in sectors (typical 128); not critical for SPI */
+            *(DWORD*)buff = 128u;
+            return RES_OK;
+
+        case GET_SECTOR_COUNT:
+            /* If you want exact size, parse CSD here.
+               For now return a large placeholder to allow mkfs; adjust as needed. */
+            *(DWORD*)buff = 0; /* 0 means “unknown” to FatFs for some ops */
+            return RES_OK;
+
+        default:
+            return RES_PARERR;
+    }
+}
+
+/* Backend table - attached to drive 0 by default (see diskio.c) */
+const DiskBackend DiskBackend_SD =
+{
+    "SD-SPI",
+    sd_initialize,
+    sd_status,
+    sd_disk_read,
+#if FF_FS_READONLY == 0
+    sd_disk_write,
+#else
+    NULL,
+#endif
+    sd_ioctl,
+    sd_read_async
+};
+
+/* ===================== Driver extensions (not part of the FatFs API) ===================== */
+
+/* SCK currently applied to the card in Hz (0 before disk_initialize) */
+u32 disk_spi_clock_hz(BYTE pdrv)
+{
+    return (pdrv == SD_SPI_DRIVE) ? SpiClockHz : 0u;
+}
+
+/* Card maximum transfer rate from CSD TRAN_SPEED in Hz (0 if unknown) */
+u32 disk_card_max_hz(BYTE pdrv)
+{
+    return (pdrv == SD_SPI_DRIVE) ? CardMaxHz : 0u;
+}
+
@@ -0,0 +1,48 @@
+/* =============================================================================
+ *  File: diskio_sd.h
+ *  Project: MicroBlaze + AXI Quad SPI (microSD Interface)
+ *  Author: IMR Engineering / Hab Collector
+ *  ---------------------------------------------------------------------------
+ *  Purpose:
+ *      SD-over-SPI storage backend (diskio_sd.c) and its target-only
+ *      extensions: SPI clock reporting and control of the asynchronous read
+ *      engine.  Generic disk access goes through diskio.h.
+ * =============================================================================
+ */
+
+#ifndef _DISKIO_SD_DEFINED
+#define _DISKIO_SD_DEFINED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "diskio.h"
+#include "xil_types.h"
+#include "xparameters.h"
+
+/* Backend table - drive 0 default on the target */
+extern const DiskBackend DiskBackend_SD;
+
+/* Link reporting */
+u32 disk_spi_clock_hz(BYTE pdrv);   /* SCK in use after disk_initialize (Hz) */
+u32 disk_card_max_hz (BYTE pdrv);   /* Card CSD TRAN_SPEED limit (Hz, 0 = unknown) */
+
+/* Asynchronous read engine.  SD_SPI_FABRIC_ID is the INTC input of the SD QSPI
+   (axi_quad_spi_1) interrupt, taken from xparameters.h.  It is only defined once the
+   interrupt is routed to the INTC concat in the block design and the platform is
+   re-exported; until then run the engine from the main loop with
+   disk_async_service().  Callbacks run from the ISR in IRQ mode. */
+#ifdef XPAR_FABRIC_AXI_QUAD_SPI_1_INTR
+#define SD_SPI_FABRIC_ID    XPAR_FABRIC_AXI_QUAD_SPI_1_INTR
+#endif
+
+void    disk_async_service(void);               /* polled mode: step the engine */
+void    disk_async_isr    (void *CallbackRef);  /* IRQ mode: QSPI interrupt handler */
+void    disk_async_irq_mode(u8 Enable);         /* 1 = IRQ driven, 0 = polled (default) */
+u32     disk_async_pending(void);               /* requests queued or in flight */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _DISKIO_SD_DEFINED */
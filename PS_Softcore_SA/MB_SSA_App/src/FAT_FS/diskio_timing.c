@@ -0,0 +1,127 @@
+/* =============================================================================
+ *  File: diskio_timing.c
+ *  Project: MicroBlaze + AXI Quad SPI (microSD Interface)
+ *  Author: IMR Engineering / Hab Collector
+ *  ---------------------------------------------------------------------------
+ *  Purpose:
+ *      Microsecond deadlines and latency histograms for diskio_sd.c.  See
+ *      diskio_timing.h for the time base requirements.
+ *
+ *  ---------------------------------------------------------------------------
+ *  File Version History:
+ *      v1.0  – Initial implementation (AXI timer time base, log2 histograms)
+ *      v1.1  – disk_time_init owns the counter; a counter not free running
+ *              falls back to the software clock
+ * =============================================================================
+ */
+
+#include "diskio_timing.h"
+#include "xil_printf.h"
+#include <string.h>
+
+static DiskLatencyHistogram Histograms[DISK_LAT_CLASSES];
+static u32 SoftTicks = 0;
+
+static const char *const ClassName[DISK_LAT_CLASSES] =
+{
+    "CMD17", "CMD24", "CMD25", "TOKEN", "BUSY"
+};
+
+/* Takes the counter as the 2^32 free-running time base; 0 once it reads back in that mode */
+int disk_time_init(void)
+{
+    XTmrCtr_SetControlStatusReg(DISK_TIME_TIMER_BASEADDR, DISK_TIME_TIMER_NUM, 0u);
+    XTmrCtr_SetLoadReg(DISK_TIME_TIMER_BASEADDR, DISK_TIME_TIMER_NUM, XTC_MAX_LOAD_VALUE);
+    XTmrCtr_SetControlStatusReg(DISK_TIME_TIMER_BASEADDR, DISK_TIME_TIMER_NUM, XTC_CSR_LOAD_MASK);
+    XTmrCtr_SetControlStatusReg(DISK_TIME_TIMER_BASEADDR, DISK_TIME_TIMER_NUM, DISK_TIME_TCSR_MODE);
+
+    u32 Csr = XTmrCtr_GetControlStatusReg(DISK_TIME_TIMER_BASEADDR, DISK_TIME_TIMER_NUM);
+    u32 Load = XTmrCtr_GetLoadReg(DISK_TIME_TIMER_BASEADDR, DISK_TIME_TIMER_NUM);
+    return (((Csr & DISK_TIME_TCSR_CHECK) == DISK_TIME_TCSR_MODE) && (Load == XTC_MAX_LOAD_VALUE)) ? 0 : -1;
+}
+
+/* Current time in timer ticks, counting up */
+u32 disk_time_now(void)
+{
+    u32 Csr = XTmrCtr_ReadReg(DISK_TIME_TIMER_BASEADDR, DISK_TIME_TIMER_NUM, XTC_TCSR_OFFSET);
+
+    if ((Csr & DISK_TIME_TCSR_CHECK) != DISK_TIME_TCSR_MODE)
+    {
+        /* Stopped or reprogrammed (a periodic reload would make deadlines misfire): 1 us per call
+           keeps every deadline finite */
+        SoftTicks += DISK_TIME_TICKS_PER_US;
+        return SoftTicks;
+    }
+
+    return ~XTmrCtr_ReadReg(DISK_TIME_TIMER_BASEADDR, DISK_TIME_TIMER_NUM, XTC_TCR_OFFSET);
+}
+
+u32 disk_time_elapsed_us(u32 StartTicks)
+{
+    return (disk_time_now() - StartTicks) / DISK_TIME_TICKS_PER_US;
+}
+
+/* Non-zero once TimeoutUs has passed since StartTicks */
+int disk_time_expired(u32 StartTicks, u32 TimeoutUs)
+{
+    return disk_time_elapsed_us(StartTicks) >= TimeoutUs;
+}
+
+/* Log2 bucket: 0 for 0 us, n for [2^(n-1), 2^n) us */
+static u32 latency_bucket(u32 Us)
+{
+    u32 Bucket = (Us == 0u) ? 0u : (32u - (u32)__builtin_clz(Us));
+    return (Bucket < DISK_LATENCY_BUCKETS) ? Bucket : (DISK_LATENCY_BUCKETS - 1u);
+}
+
+/* Add the time since StartTicks to a class */
+void disk_latency_record(DiskLatencyClass Class, u32 StartTicks)
+{
+    DiskLatencyHistogram *Hist = &Histograms[Class];
+    u32 Us = disk_time_elapsed_us(StartTicks);
+
+    if ((Hist->Count == 0u) || (Us < Hist->MinUs)) Hist->MinUs = Us;
+    if (Us > Hist->MaxUs) Hist->MaxUs = Us;
+    Hist->Count++;
+    Hist->SumUs += Us;
+    Hist->Bucket[latency_bucket(Us)]++;
+}
+
+void disk_latency_get(DiskLatencyClass Class, DiskLatencyHistogram *Histogram)
+{
+    if ((Class < DISK_LAT_CLASSES) && (Histogram != NULL))
+    {
+        *Histogram = Histograms[Class];
+    }
+}
+
+void disk_latency_reset(void)
+{
+    memset(Histograms, 0, sizeof(Histograms));
+}
+
+/* Console dump: one summary line per class, then its non-empty buckets */
+void disk_latency_print(void)
+{
+    xil_printf("SD latency (us)\r\n");
+    for (u32 c = 0; c < DISK_LAT_CLASSES; c++)
+    {
+        DiskLatencyHistogram *Hist = &Histograms[c];
+        u32 Avg = (Hist->Count != 0u) ? (u32)(Hist->SumUs / Hist->Count) : 0u;
+
+        xil_printf("  %-5s n=%d min=%d avg=%d max=%d\r\n", ClassName[c], Hist->Count, Hist->MinUs, Avg, Hist->MaxUs);
+        for (u32 b = 0; b < DISK_LATENCY_BUCKETS; b++)
+        {
+            if (Hist->Bucket[b] == 0u)
+            {
+                continue;
+            }
+            if (b == 0u)
+                xil_printf("        0          : %d\r\n", Hist->Bucket[b]);
+            else if (b == (DISK_LATENCY_BUCKETS - 1u))
+                xil_printf("    >= %-10d : %d\r\n", 1u << (b - 1u), Hist->Bucket[b]);
+            else
+                xil_printf("    %7d-%-7d : %d\r\n", 1u << (b - 1u), (1u << b) - 1u, Hist->Bucket[b]);
+        }
+    }
+}
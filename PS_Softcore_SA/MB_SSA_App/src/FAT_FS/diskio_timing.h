@@ -0,0 +1,88 @@
+/* =============================================================================
+ *  File: diskio_timing.h
+ *  Project: MicroBlaze + AXI Quad SPI (microSD Interface)
+ *  Author: IMR Engineering / Hab Collector
+ *  ---------------------------------------------------------------------------
+ *  Purpose:
+ *      Microsecond time base and latency histograms for the SD protocol
+ *      layer (diskio_sd.c).  Deadlines are taken from the free-running AXI
+ *      timer so polling loops run tight (no usleep on the fast path) and a
+ *      timeout is a real time, not a poll count.
+ *
+ *  ---------------------------------------------------------------------------
+ *  Time Base:
+ *      DISK_TIME_TIMER_BASEADDR / DISK_TIME_TIMER_NUM select the counter.
+ *      disk_time_init() owns it: reload 0xFFFFFFFF, auto reload, down
+ *      count, no interrupt - so it wraps at 2^32 - and checks it reads
+ *      back that way.  Nothing else may load, stop or reprogram the
+ *      counter (the applications keep their periodic timers on the other
+ *      counter).  disk_time_now() checks TCSR on every call: if the
+ *      counter is stopped or not in the free-running mode each call
+ *      advances a software clock by 1 us instead, so every deadline still
+ *      expires (later than asked, never sooner).
+ *
+ *  ---------------------------------------------------------------------------
+ *  Histograms:
+ *      Each latency class keeps count / min / max / sum and log2 buckets:
+ *      bucket 0 = 0 us, bucket n = [2^(n-1), 2^n) us, last = overflow.
+ *      disk_latency_print() dumps all classes on the console.
+ * =============================================================================
+ */
+
+#ifndef _DISKIO_TIMING_DEFINED
+#define _DISKIO_TIMING_DEFINED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "xil_types.h"
+#include "xparameters.h"
+#include "xtmrctr_l.h"
+
+#define DISK_TIME_TIMER_BASEADDR    XPAR_AXI_TIMER_0_BASEADDR
+#define DISK_TIME_TIMER_NUM         0u
+#define DISK_TIME_TICKS_PER_US      (XPAR_AXI_TIMER_0_CLOCK_FREQUENCY / 1000000u)
+
+#define DISK_TIME_TCSR_MODE         (XTC_CSR_ENABLE_TMR_MASK | XTC_CSR_AUTO_RELOAD_MASK | XTC_CSR_DOWN_COUNT_MASK)
+#define DISK_TIME_TCSR_CHECK        (DISK_TIME_TCSR_MODE | XTC_CSR_ENABLE_INT_MASK | XTC_CSR_ENABLE_PWM_MASK | \
+                                     XTC_CSR_CAPTURE_MODE_MASK | XTC_CSR_CASC_MASK)
+
+#define DISK_LATENCY_BUCKETS        22u     /* 0 us .. 2^20 us (~1 s) + overflow */
+
+/* Latency classes */
+typedef enum
+{
+    DISK_LAT_CMD17 = 0,     /* single block read: command to CRC */
+    DISK_LAT_CMD24,         /* single block write: command to not-busy */
+    DISK_LAT_CMD25,         /* multi block write: command to not-busy after STOP_TRAN */
+    DISK_LAT_TOKEN,         /* R1 to data start token */
+    DISK_LAT_BUSY,          /* card busy (DO low) wait */
+    DISK_LAT_CLASSES
+} DiskLatencyClass;
+
+typedef struct
+{
+    u32 Count;
+    u32 MinUs;
+    u32 MaxUs;
+    u64 SumUs;
+    u32 Bucket[DISK_LATENCY_BUCKETS];
+} DiskLatencyHistogram;
+
+/* Time base */
+int  disk_time_init      (void);             /* 0 = counter free running */
+u32  disk_time_now       (void);             /* ticks, increasing */
+u32  disk_time_elapsed_us(u32 StartTicks);
+int  disk_time_expired   (u32 StartTicks, u32 TimeoutUs);
+
+/* Histograms */
+void disk_latency_record (DiskLatencyClass Class, u32 StartTicks);
+void disk_latency_get    (DiskLatencyClass Class, DiskLatencyHistogram *Histogram);
+void disk_latency_reset  (void);
+void disk_latency_print  (void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* _DISKIO_TIMING_DEFINED */
@@ -43,6 +43,10 @@
 #include "xil_printf.h"
 #include "xstatus.h"
 #include "ff.h"
+#include "diskio.h"
+#include "diskio_sd.h"
+#include "diskio_cache.h"
+#include "diskio_timing.h"
 #include <stdio.h>
 #include <math.h>
 #include "AXI_Timer_PWM_Support.h"
@@ -57,6 +61,12 @@
 static void main_InitApplication(void);
 static void main_WhileLoop(void);
 static bool init_SoftCoreHandle(Type_SoftCore_SA *Handle);
+static uint32_t main_MeasureStorageReadRate(uint32_t SectorCount);
+#ifdef XPAR_IMR_ADC_7476A_X2_0_BASEADDR
+static bool main_SignalFrame(void);
+static bool main_SignalCapture(Type_SoftCore_SA *Handle, uint32_t CaptureSeconds);
+static void ADC_IP_Callback_ISR(void *CallbackRef);
+#endif
 
 
 // GLOBAL DEFINES
@@ -80,6 +90,13 @@ XIntc AXI_IRQ_ControllerHandle;
 // FAT FS SUPPORT
 FATFS FatFs; 
 
+// AXI IMR ADC SUPPORT - MODE_SIGNAL builds once the exported platform (xparameters.h) has the ADC IP
+#ifdef XPAR_IMR_ADC_7476A_X2_0_BASEADDR
+Type_AXI_IMR_7476A_Handle AXI_IMR_7476A_Handle;
+static uint16_t SignalRing_A[SIGNAL_RING_SIZE];
+static uint16_t SignalRing_B[SIGNAL_RING_SIZE];
+#endif
+
 
 /********************************************************************************************************
 * @brief This is the mian application - it is broken up into two parts - the main init and the main never
@@ -113,6 +130,7 @@ static void main_InitApplication(void)
     int AXI_Status;
     bool Status;
     uint16_t InitFailMode = 0;
+    uint32_t SD_ReadBytesPerSecond = 0;
     char PrintBuffer[MAX_PRINT_BUFFER] = {0};
     
     // STEP 1: Init AXI peripherals for use
@@ -133,11 +151,44 @@ static void main_InitApplication(void)
     if (Status == false)
         InitFailMode |= INIT_FAIL_PWM;
 
+    // Init AXI Timer 0 as a free running down counter - time base for sleep_ms, rate measurements and the SD
+    // deadlines.  The handle is for sleep_ms reads only: diskio_timing owns the counter and starts it
+    Status = init_PeriodicTimer(&AXI_TimerHandle, XPAR_AXI_TIMER_0_BASEADDR, XTC_TIMER_0, FREE_RUNNING_TIMER_TICKS, NULL);
+    if ((Status == false) || (disk_time_init() != 0))
+        InitFailMode |= INIT_FAIL_TIMER;
+
+    // Init AXI IRQ Controller - peripherals are connected below where the exported platform routes their IRQ
+    Status = init_IRQ_Controller(&AXI_IRQ_ControllerHandle, 0);
+    if (Status == false)
+        InitFailMode |= INIT_FAIL_IRQ;
+
+#ifdef XPAR_IMR_ADC_7476A_X2_0_BASEADDR
+    // Init AXI IMR ADC IP and its IRQ - the ISR drains the sample FIFO into the MODE_SIGNAL stream ring
+    Status = init_IMR_ADC_7476A_X2(&AXI_IMR_7476A_Handle, XPAR_IMR_ADC_7476A_X2_0_BASEADDR, IMR_ADC_CLOCK_DIVIDER);
+    if (Status == true)
+        Status = connectPeripheral_IRQ(&AXI_IRQ_ControllerHandle, ADC_7476A_X2_FABRIC_ID, ADC_IP_Callback_ISR, &AXI_IMR_7476A_Handle);
+    if (Status == false)
+        InitFailMode |= INIT_FAIL_ADC;
+#endif
+
+#ifdef SD_SPI_FABRIC_ID
+    // SD card QSPI IRQ drives the asynchronous read engine (WAV read-ahead) - else the feeder polls it
+    Status = connectPeripheral_IRQ(&AXI_IRQ_ControllerHandle, SD_SPI_FABRIC_ID, disk_async_isr, NULL);
+    if (Status == false)
+        InitFailMode |= INIT_FAIL_IRQ;
+#endif
+    enableExceptionHandling(&AXI_IRQ_ControllerHandle);
+
 
     // STEP 2: Init of libraries
     // Init FAT FS
     if (f_mount(&FatFs, ROOT_PATH, 1) != FR_OK)
         InitFailMode |= INIT_FAIL_FAT_FS;
+    else
+        SD_ReadBytesPerSecond = main_MeasureStorageReadRate(SD_RATE_TEST_SECTORS);
+#ifdef SD_SPI_FABRIC_ID
+    disk_async_irq_mode(1);
+#endif
 
 
     // STEP 3: Init SoftCore SA Handle
@@ -156,6 +207,7 @@ static void main_InitApplication(void)
     xil_printf("Softcore Spectrum Analyzer\r\n");
     xil_printf("PS REV: %02d.%02d.%02d\r\n", FW_MAJOR_REV, FW_MINOR_REV, FW_TEST_REV);
     xil_printf("PL VER: %d\r\n\n", PL_Ver);
+    xil_printf("SD SCK: %d kHz (card max %d kHz), read %d kB/s\r\n\n", disk_spi_clock_hz(0) / 1000, disk_card_max_hz(0) / 1000, SD_ReadBytesPerSecond / 1000);
     if (InitFailMode)
     {
         snprintf(PrintBuffer, sizeof(PrintBuffer), "Init Fail Code(s): 0x%04X\r\n\n",InitFailMode);
@@ -229,7 +281,22 @@ static void main_WhileLoop(void)
 
     
 
+#ifdef XPAR_IMR_ADC_7476A_X2_0_BASEADDR
+    // MODE_SIGNAL: SW0 on checks both ADC channels with one frame, then records them to the card
+    if (XGpio_DiscreteRead(&AXI_GPIO_Handle, GPIO_INPUT_CHANNEL) & SW_0)
+        SoftCore_SA.Mode = MODE_SIGNAL;
+    if (SoftCore_SA.Mode == MODE_SIGNAL)
+    {
+        if (main_SignalFrame() == false)
+            printBrightRed("Error: signal frame incomplete\r\n");
+        if (main_SignalCapture(&SoftCore_SA, SIGNAL_CAPTURE_SECONDS) == false)
+            printBrightRed("Error: signal capture incomplete\r\n");
+    }
+#endif
+
     f_closedir(&Directory);
+    disk_latency_print();
+    disk_cache_flush();
     f_mount(0, ROOT_PATH, 0);
 
     setup_PWM(&AXI_PWM_Handle, 200000, 50.0);
@@ -265,6 +332,7 @@ static bool init_SoftCoreHandle(Type_SoftCore_SA *Handle)
     memset(Handle->Audio_SA.File.Name, 0x00, sizeof(Handle->Audio_SA.File.Name));
     memset(Handle->Audio_SA.File.PathFileName, 0x00, sizeof(Handle->Audio_SA.File.PathFileName));
     Handle->Audio_SA.File.DirectoryFileCount = 0;
+    Handle->Recorder.IsOpen = false;
     FRESULT FileResult = countFilesInDirectory(AUDIO_DIRECTORY, &Handle->Audio_SA.File.DirectoryFileCount);
     if ((FileResult != FR_OK) || (Handle->Audio_SA.File.DirectoryFileCount == 0))
         return(false);
@@ -280,5 +348,190 @@ static bool init_SoftCoreHandle(Type_SoftCore_SA *Handle)
 
 
 
+/********************************************************************************************************
+* @brief Measures the sustained SD card read rate by timing a run of raw sector reads against the free
+* running AXI timer.  Used at mount to report what the SPI link actually delivers.
+*
+* @author original: Hab Collector \n
+*
+* @note: Requires FAT FS mounted (disk initialized) and AXI_TimerHandle running as a down counter
+* @note: Sectors are read from LBA 0 upward - read only, card content is not changed
+* 
+* @param SectorCount: Number of 512 byte sectors to read
+*
+* @return Read rate in bytes per second (0 on read error)
+*
+* STEP 1: Time the sector reads
+* STEP 2: Convert timer ticks to bytes per second
+********************************************************************************************************/
+static uint32_t main_MeasureStorageReadRate(uint32_t SectorCount)
+{
+    static BYTE SectorBuffer[FF_MAX_SS];
+
+    // STEP 1: Time the sector reads
+    uint32_t StartCount = XTmrCtr_GetValue(&AXI_TimerHandle, XTC_TIMER_0);
+    for (uint32_t Sector = 0; Sector < SectorCount; Sector++)
+    {
+        if (disk_read(0, SectorBuffer, (LBA_t)Sector, 1) != RES_OK)
+            return(0);
+    }
+    uint32_t ElapsedTicks = StartCount - XTmrCtr_GetValue(&AXI_TimerHandle, XTC_TIMER_0);
+
+    // STEP 2: Convert timer ticks to bytes per second
+    if (ElapsedTicks == 0)
+        return(0);
+    uint64_t Bytes = (uint64_t)SectorCount * FF_MAX_SS;
+    return((uint32_t)((Bytes * XPAR_AXI_TIMER_0_CLOCK_FREQUENCY) / ElapsedTicks));
+
+} // END OF main_MeasureStorageReadRate
+
+
+
+#ifdef XPAR_IMR_ADC_7476A_X2_0_BASEADDR
+/********************************************************************************************************
+* @brief MODE_SIGNAL level check: one FFT_SIZE frame of both ADC channels through the IP FIFO, completed by the
+* ADC_EVENT_CAPTURE_DONE event the ISR posts - this loop is the consumer of the driver event queue.  Reports
+* the peak to peak code of each channel so a dead input shows before the recording starts.
+*
+* @author original: Hab Collector \n
+*
+* @note: Requires the ADC IP with its IRQ connected (main_InitApplication) and no stream running
+* @note: The frame lands in the stream ring memory - free until main_SignalCapture starts the stream
+* 
+* @return True if the frame completed with every sample
+*
+* STEP 1: Pace the ADC and start the frame through the FIFO
+* STEP 2: Take events until the capture is done - bounded by SIGNAL_FRAME_TIMEOUT_US
+* STEP 3: FIFO off and report the levels
+********************************************************************************************************/
+static bool main_SignalFrame(void)
+{
+    Type_ADC_Event Event;
+    bool Done = false;
+
+    // STEP 1: Pace the ADC and start the frame through the FIFO
+    if (IMR_ADC_7476A_X2_SetSampleRate(&AXI_IMR_7476A_Handle, SIGNAL_SAMPLE_RATE, NULL) == false)
+        return(false);
+    if (IMR_ADC_7476A_X2_EnableFifo(&AXI_IMR_7476A_Handle, SIGNAL_FRAME_FIFO_THRESHOLD) == false)
+        return(false);
+    if (IMR_ADC_7476A_X2_MultiConvert(&AXI_IMR_7476A_Handle, SignalRing_A, SignalRing_B, FFT_SIZE) == false)
+    {
+        IMR_ADC_7476A_X2_DisableFifo(&AXI_IMR_7476A_Handle);
+        return(false);
+    }
+
+    // STEP 2: Take events until the capture is done - bounded by SIGNAL_FRAME_TIMEOUT_US
+    uint32_t StartTicks = disk_time_now();
+    while (!Done && !disk_time_expired(StartTicks, SIGNAL_FRAME_TIMEOUT_US))
+    {
+        while (!Done && IMR_ADC_7476A_X2_GetEvent(&AXI_IMR_7476A_Handle, &Event))
+            Done = (Event.Type == ADC_EVENT_CAPTURE_DONE);
+    }
+
+    // STEP 3: FIFO off and report the levels
+    IMR_ADC_7476A_X2_DisableFifo(&AXI_IMR_7476A_Handle);
+    if (!Done)
+    {
+        xil_printf("Signal frame: no completion event in %d us\r\n", SIGNAL_FRAME_TIMEOUT_US);
+        return(false);
+    }
+    uint16_t Min_A = 0xFFFF;
+    uint16_t Max_A = 0;
+    uint16_t Min_B = 0xFFFF;
+    uint16_t Max_B = 0;
+    for (uint32_t Index = 0; Index < Event.Samples; Index++)
+    {
+        Min_A = (SignalRing_A[Index] < Min_A) ? SignalRing_A[Index] : Min_A;
+        Max_A = (SignalRing_A[Index] > Max_A) ? SignalRing_A[Index] : Max_A;
+        Min_B = (SignalRing_B[Index] < Min_B) ? SignalRing_B[Index] : Min_B;
+        Max_B = (SignalRing_B[Index] > Max_B) ? SignalRing_B[Index] : Max_B;
+    }
+    xil_printf("Signal frame: %d samples, A %d pk-pk, B %d pk-pk codes, %d events dropped\r\n", Event.Samples,
+               (Event.Samples ? Max_A - Min_A : 0), (Event.Samples ? Max_B - Min_B : 0), AXI_IMR_7476A_Handle.EventDropCount);
+    return((Event.Samples == FFT_SIZE) && (AXI_IMR_7476A_Handle.FifoOverflowCount == 0));
+
+} // END OF main_SignalFrame
+
+
+
+/********************************************************************************************************
+* @brief MODE_SIGNAL capture: both ADC channels stream free running into a RAM ring and are recorded to a WAV
+* file on the card by the capture recorder.  The ADC ISR fills the ring; this loop hands each ready half to
+* the recorder and runs the card writer while the other half fills.
+*
+* @author original: Hab Collector \n
+*
+* @note: Requires FAT FS mounted and the ADC IP with its IRQ connected (main_InitApplication)
+* @note: Blocks for CaptureSeconds
+* 
+* @param Handle: Pointer to Soft Core SA structure
+* @param CaptureSeconds: Length of the recording
+*
+* @return True if the whole recording reached the card with no samples lost
+*
+* STEP 1: Pace the ADC and open the pre-allocated capture file
+* STEP 2: Start the free running stream
+* STEP 3: Ring halves to the recorder, full buffers to the card - until the file is full
+* STEP 4: Stop the stream, finish the file and report
+********************************************************************************************************/
+static bool main_SignalCapture(Type_SoftCore_SA *Handle, uint32_t CaptureSeconds)
+{
+    FRESULT FileResult;
+    uint32_t SampleRate;
+    uint16_t *HalfData_A;
+    uint16_t *HalfData_B;
+
+    // STEP 1: Pace the ADC and open the pre-allocated capture file
+    if (IMR_ADC_7476A_X2_SetSampleRate(&AXI_IMR_7476A_Handle, SIGNAL_SAMPLE_RATE, &SampleRate) == false)
+        return(false);
+    FileResult = f_mkdir(CAPTURE_DIRECTORY);
+    if ((FileResult != FR_OK) && (FileResult != FR_EXIST))
+        return(false);
+    FileResult = openCaptureFile(&Handle->Recorder, SIGNAL_CAPTURE_FILE, SampleRate, STEREO, SampleRate * CaptureSeconds);
+    if (FileResult != FR_OK)
+        return(false);
+
+    // STEP 2: Start the free running stream
+    if (IMR_ADC_7476A_X2_StartStream(&AXI_IMR_7476A_Handle, SignalRing_A, SignalRing_B, SIGNAL_RING_SIZE) == false)
+    {
+        closeCaptureFile(&Handle->Recorder);
+        return(false);
+    }
+
+    // STEP 3: Ring halves to the recorder, full buffers to the card - until the file is full
+    while ((FileResult == FR_OK) && (Handle->Recorder.SamplesQueued < Handle->Recorder.MaxSamples))
+    {
+        if (IMR_ADC_7476A_X2_GetRingHalf(&AXI_IMR_7476A_Handle, &HalfData_A, &HalfData_B))
+        {
+            putCaptureSamples(&Handle->Recorder, HalfData_A, HalfData_B, SIGNAL_RING_SIZE / IMR_ADC_RING_HALVES);
+            IMR_ADC_7476A_X2_ReleaseRingHalf(&AXI_IMR_7476A_Handle);
+        }
+        FileResult = serviceCaptureRecorder(&Handle->Recorder);
+    }
+
+    // STEP 4: Stop the stream, finish the file and report
+    bool Stopped = IMR_ADC_7476A_X2_StopStream(&AXI_IMR_7476A_Handle);
+    FRESULT CloseResult = closeCaptureFile(&Handle->Recorder);
+    printCaptureReport(&Handle->Recorder);
+    xil_printf("Capture: %d ring overruns, %d FIFO overflows\r\n", AXI_IMR_7476A_Handle.RingOverrunCount, AXI_IMR_7476A_Handle.FifoOverflowCount);
+    if (!Stopped)
+        xil_printf("Capture: ADC still BUSY %d us after the stop\r\n", IMR_ADC_STOP_TIMEOUT_US);
+    if ((FileResult != FR_OK) || (CloseResult != FR_OK) || !Stopped)
+        return(false);
+    return((Handle->Recorder.Stats.DroppedSamples == 0) && (AXI_IMR_7476A_Handle.RingOverrunCount == 0) && (AXI_IMR_7476A_Handle.FifoOverflowCount == 0));
+
+} // END OF main_SignalCapture
+
+
+
+// ISR Callback function for the ADC IP - drains the sample FIFO into the stream ring
+static void ADC_IP_Callback_ISR(void *CallbackRef)
+{
+    IMR_ADC_7476A_X2_ClrIrq((Type_AXI_IMR_7476A_Handle *)CallbackRef);
+}
+#endif
+
+
+
 // END OF PROCESSOR DEFINE FOR RUN_MAIN_APPLICATION
 #endif
\ No newline at end of file
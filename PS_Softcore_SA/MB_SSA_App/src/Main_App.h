@@ -34,6 +34,8 @@ extern"C" {
 #include <stdint.h>
 #include <stdbool.h>
 #include "SoftCore_Audio_SA.h"
+#include "Capture_Recorder.h"
+#include "AXI_IMR_ADC_7476A_DUAL.h"
 
 
 // DEFINES
@@ -43,6 +45,19 @@ extern"C" {
 #define INIT_FAIL_FAT_FS                ((uint16_t)(0x01 << 2))
 #define INIT_FAIL_PWM                   ((uint16_t)(0x01 << 3))
 #define INIT_FAIL_SOFTCORE_HANDLE       ((uint16_t)(0x01 << 4))
+#define INIT_FAIL_TIMER                 ((uint16_t)(0x01 << 5))
+#define INIT_FAIL_ADC                   ((uint16_t)(0x01 << 6))
+#define INIT_FAIL_IRQ                   ((uint16_t)(0x01 << 7))
+// TIMING
+#define FREE_RUNNING_TIMER_TICKS        0xFFFFFFFFU     // AXI Timer 0 auto-reload value (down count, ~43s at 100MHz)
+#define SD_RATE_TEST_SECTORS            64U             // Sectors read at mount to measure SD throughput
+// SIGNAL MODE
+#define SIGNAL_SAMPLE_RATE              48000U          // Both ADC channels recorded at this rate in MODE_SIGNAL
+#define SIGNAL_RING_SIZE                8192U           // Samples per channel in the ADC stream ring - a half covers ~85ms of card write
+#define SIGNAL_CAPTURE_SECONDS          10U             // Length of one MODE_SIGNAL recording
+#define SIGNAL_CAPTURE_FILE             CAPTURE_DIRECTORY "/SIGNAL.WAV"
+#define SIGNAL_FRAME_FIFO_THRESHOLD     256U            // FIFO fill per ADC IRQ during the MODE_SIGNAL level check frame
+#define SIGNAL_FRAME_TIMEOUT_US         100000U         // FFT_SIZE samples at SIGNAL_SAMPLE_RATE take 21.3ms
 // MISC
 #define MAX_PRINT_BUFFER                255U
 
@@ -71,6 +86,7 @@ typedef struct
 {
     Type_Mode                   Mode;
     Type_Audio_SA               Audio_SA;
+    Type_CaptureRecorder        Recorder;       // MODE_SIGNAL capture to card
 }Type_SoftCore_SA;
 
 // FUNTION PROTOTYPES
@@ -30,11 +30,16 @@
 #include "xuartlite.h"
 #include "xtmrctr.h"
 #include "xiltimer.h"
+#include "mb_interface.h"
+
+#define MSR_INTERRUPT_ENABLE    0x02U
 
 
 extern XTmrCtr AXI_TimerHandle;
 extern XGpio AXI_GPIO_Handle;
 
+static void gpioOutputUpdate(uint32_t Mask, bool Set);
+
 uint32_t volatile ReceivedBytes = 0;
 uint8_t RxDataBuffer[RX_BUFFER_SIZE] = {0};
 
@@ -67,28 +72,36 @@ void sleep_ms(XTmrCtr *AXI_TimerHandle, uint8_t Timer, uint32_t WaitTime)
 
 
 
-void displayResetOrRun(Type_DisplayResetRun ResetRunAction)
+// GPIO output channel read-modify-write with interrupts held off: the display push ISR drives D/C and CS and the
+// timer ISR drives the timer outputs on the same channel, so an ISR landing between the read and the write of a
+// main loop update would otherwise have its bit written back to the old value.  Restores the previous MSR so it
+// is also safe to call from an ISR
+static void gpioOutputUpdate(uint32_t Mask, bool Set)
 {
-    if (ResetRunAction == DISPLAY_RUN)
-        XGpio_DiscreteSet(&AXI_GPIO_Handle, GPIO_OUTPUT_CHANNEL, DISPLAY_RESET_RUN);
+    uint32_t MSR_State = mfmsr();
+    if (MSR_State & MSR_INTERRUPT_ENABLE)
+        microblaze_disable_interrupts();
+    if (Set)
+        XGpio_DiscreteSet(&AXI_GPIO_Handle, GPIO_OUTPUT_CHANNEL, Mask);
     else
-        XGpio_DiscreteClear(&AXI_GPIO_Handle, GPIO_OUTPUT_CHANNEL, DISPLAY_RESET_RUN);
+        XGpio_DiscreteClear(&AXI_GPIO_Handle, GPIO_OUTPUT_CHANNEL, Mask);
+    if (MSR_State & MSR_INTERRUPT_ENABLE)
+        microblaze_enable_interrupts();
+}
+
+void displayResetOrRun(Type_DisplayResetRun ResetRunAction)
+{
+    gpioOutputUpdate(DISPLAY_RESET_RUN, (ResetRunAction == DISPLAY_RUN));
 }
 
 void displayCommandOrData(Type_DisplayCommandData CommandDataAction)
 {
-    if (CommandDataAction == DISPLAY_DATA)
-        XGpio_DiscreteSet(&AXI_GPIO_Handle, GPIO_OUTPUT_CHANNEL, DISPLAY_CMD_DATA);
-    else
-        XGpio_DiscreteClear(&AXI_GPIO_Handle, GPIO_OUTPUT_CHANNEL, DISPLAY_CMD_DATA);
+    gpioOutputUpdate(DISPLAY_CMD_DATA, (CommandDataAction == DISPLAY_DATA));
 }
 
 void displayChipSelect(Type_Display_CS Status)
 {
-    if (Status == CS_ENABLE)
-        XGpio_DiscreteClear(&AXI_GPIO_Handle, GPIO_OUTPUT_CHANNEL, DISPLAY_CS);
-    else
-        XGpio_DiscreteSet(&AXI_GPIO_Handle, GPIO_OUTPUT_CHANNEL, DISPLAY_CS);
+    gpioOutputUpdate(DISPLAY_CS, (Status != CS_ENABLE));
 }
 
 bool displayTrasmitReceive(XSpi *SPI_DisplayHandle, uint8_t ChipSelect_N, uint8_t *TxBuffer, uint8_t *RxBuffer, uint32_t BytesToTransfer)
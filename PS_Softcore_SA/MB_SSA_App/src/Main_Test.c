@@ -9,9 +9,10 @@
  *
  * PERIODIC TIMER ACTION:
  * There are 1 AXI Timer IP Block within this design.  axi_timer_0 is configured for Timer.
- * axi_timer_0 is configured for periodic timer and both timers are used. 
- * Timer number 0 is set for an ISR IRQ every 300ms.  Timer number 1 is set for an ISR IRQ every 120ms.
- * With a periodic timer, both timer numbers share the same ISR.  There are two switches in use SW0 and SW1.
+ * Timer number 0 is the free running time base owned by diskio_timing (disk_time_init) - SD deadlines, the
+ * display governor, sleep_ms and the display benchmarks all read it, so it is never reloaded or stopped.
+ * Timer number 1 is set for an ISR IRQ every 100ms; the Timer 0 output is toggled from the same ISR every
+ * TIMER_0_OUTPUT_DIVIDE interrupts.  There are two switches in use SW0 and SW1.
  *
  * UART LITE ACTION: 
  * The UART is configure in IRQ mode, but even in IRQ mode it can be used in polling via
@@ -33,8 +34,8 @@
  * Several PL actions generate interruts.  The Timer, UART, etc. The interrupt controller feeds the various IRQs to the MicroBlaze
  *
  * UI INPUTS
- * SW0 on: Periodic Timer Number 0 is enabled \ disable
- * SW0 off: Periodic Timer Number 0 is enable \ disable
+ * SW0 on: Timer 0 output toggle enabled
+ * SW0 off: Timer 0 output toggle disabled (the time base keeps running)
  * PB_0: Board level reset
  * PB_1:
  * PB_2:
@@ -77,6 +78,8 @@
 #include "xiltimer.h"
 #include <stdint.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 #include <xstatus.h>
 #include <xtmrctr_l.h>
 #include "ff.h"
@@ -86,15 +89,28 @@
 #include "AXI_IMR_ADC_7476A_DUAL.h"
 #include "AXI_IMR_PL_Revision.h"
 #include "IO_Support.h"
+#include "Display_Spectrum.h"
+#include "Display_Labels.h"
+#include "Display_Waterfall.h"
+#include "diskio_timing.h"
 
 
 // DISPLAY SUPPORT
 // #include "AXI_SPI_Display_SSD1309.h"
 #include "u8g2.h"
 #define DISPLAY_CSN     0x01
+#define DISPLAY_BENCH_FRAMES    20
+#define DISPLAY_DEMO_DSP_FRAMES 500                 // Simulated FFT frames offered to the governor
+#define DISPLAY_DEMO_DSP_US     2000                // Simulated FFT frame period (500 frames/s)
+#define DISPLAY_DEMO_MAX_FPS    30
+#define WATERFALL_DEMO_LINES    256                 // Four screens of history
+#define WATERFALL_DEMO_BINS     64
 XSpi AXI_SPI_DisplayHandle;
 u8g2_t U8G2;
 Type_Display_SSD1309 Display_SSD1309;
+static void displayBenchmarkFPS(void);
+static void displayGovernorDemo(void);
+static void displayWaterfallDemo(void);
 
 
 // DDR 3 SUPPORT
@@ -119,7 +135,10 @@ XUartLite AXI_UART_Handle;
 // uint8_t RxDataBuffer[RX_BUFFER_SIZE] = {0};
 
 // TIMER SUPPORT
+#define TIMER_1_INTERVAL_TICKS  10e6
+#define TIMER_0_OUTPUT_DIVIDE   40          // Timer 1 IRQs per Timer 0 output toggle (4s)
 XTmrCtr AXI_TimerHandle_0;
+static volatile bool Timer0_OutputEnable = false;
 
 
 // IRQ CONTROLLER SUPPORT
@@ -151,10 +170,12 @@ void TimerCallback_ISR(void *CallbackRef, u8 TmrCtrNumber)
     // Cast the CallbackRef to the XTmrCtr instance
     XTmrCtr *InstancePtr = (XTmrCtr *)CallbackRef; 
 
-    // USER: Add your periodic timer 0 task here
+    // USER: Add your periodic timer 0 task here - Timer number 0 is the time base, so this runs off Timer 1
     static volatile bool ToggleTimer_0 = false;
-    if (TmrCtrNumber == XTC_TIMER_0)
+    static volatile uint8_t Timer_0_Divide = 0;
+    if ((TmrCtrNumber == XTC_TIMER_1) && Timer0_OutputEnable && (++Timer_0_Divide >= TIMER_0_OUTPUT_DIVIDE))
     {
+        Timer_0_Divide = 0;
         if (ToggleTimer_0)
             XGpio_DiscreteSet(&AXI_GPIO_Handle, GPIO_OUTPUT_CHANNEL, TIMER_0_OUTPUT);
         else
@@ -224,14 +245,6 @@ void ADC_IP_Callback_ISR(void *CallbackRef)
     IMR_ADC_7476A_X2_ClrIrq(IP_Handle);
 }
 
-bool ADC_ConversionCompleteFlag = false;
-void ADC_GPIO_ConversionComplete_ISR(void *CallbackRef)
-{
-    XGpio *IP_Handle = (XGpio *)CallbackRef;
-    ADC_ConversionCompleteFlag = true;
-    XGpio_DiscreteClear(IP_Handle, GPIO_OUTPUT_CHANNEL, 0x20);
-}
-
 
 
 
@@ -256,12 +269,11 @@ void mainTest(void)
     XGpio_SetDataDirection(&AXI_GPIO_Handle, GPIO_INPUT_CHANNEL, 0xFFFF);     // Switches and push buttons as input
     XGpio_SetDataDirection(&AXI_GPIO_Handle, GPIO_OUTPUT_CHANNEL, 0x0000);    
 
-    // Init AXI Timer 0 Timer Number 0 for Periodic IRQ (250ms) / Timer Number 1 for Periodic IRQ (100ms)
-    Status = init_PeriodicTimer(&AXI_TimerHandle_0, XPAR_AXI_TIMER_0_BASEADDR, XTC_TIMER_0, 400e6, TimerCallback_ISR);
+    // Init AXI Timer 0 Timer Number 1 for Periodic IRQ (100ms) / Timer Number 0 as the free running time base
+    Status = init_PeriodicTimer(&AXI_TimerHandle_0, XPAR_AXI_TIMER_0_BASEADDR, XTC_TIMER_1, TIMER_1_INTERVAL_TICKS, TimerCallback_ISR);
     if (Status == false)
         while(1);
-    Status = init_PeriodicTimer(&AXI_TimerHandle_0, XPAR_AXI_TIMER_0_BASEADDR, XTC_TIMER_1, 10e6, TimerCallback_ISR);
-    if (Status == false)
+    if (disk_time_init() != 0)
         while(1);
 
     // Init AXI SPI: Display Interface
@@ -315,14 +327,10 @@ void mainTest(void)
     // Status = connectPeripheral_IRQ(&AXI_IRQ_ControllerHandle, ADC_7476A_X2_FABRIC_ID, ADC_IP_Callback_ISR, &AXI_IMR_7476A_Handle);
     // if (Status == false)
     //     while(1);
-     // Step 2D of 4 IRQ Controller setup: 
-    Status = connectPeripheral_IRQ(&AXI_IRQ_ControllerHandle, 0, ADC_GPIO_ConversionComplete_ISR, &AXI_GPIO_Handle);
-    if (Status == false)
-        while(1);
     // Step 3 of 4 IRQ Controller setup: Enable IRQs
     enableExceptionHandling(&AXI_IRQ_ControllerHandle);
     // Step 4 of 4 Start the IRQ funtions - not part of the AXI IRQ Controller - unique to the AXI peripheral
-    startPeriodicTimer(&AXI_TimerHandle_0, XTC_TIMER_0);
+    Timer0_OutputEnable = true;
     startPeriodicTimer(&AXI_TimerHandle_0, XTC_TIMER_1);
     XUartLite_EnableInterrupt(&AXI_UART_Handle);
 
@@ -395,12 +403,12 @@ void mainTest(void)
             // SWITCH 1
             if (SwitchState & SW_0)
             {
-                startPeriodicTimer(&AXI_TimerHandle_0, XTC_TIMER_0);
+                Timer0_OutputEnable = true;
                 xil_printf("Timer 0 started\r\n");
             }
             else
             {
-                stopPeriodicTimer(&AXI_TimerHandle_0, XTC_TIMER_0);
+                Timer0_OutputEnable = false;
                 xil_printf("Timer 0 stopped\r\n");
             }
             // SWITCH 2
@@ -453,14 +461,18 @@ void mainTest(void)
                 // displayChipSelect(CS_DISABLE);
                 drawSpectrumMock(&Display_SSD1309);
                 xil_printf("End display test\r\n");
+                displayBenchmarkFPS();
+                displayGovernorDemo();
+                displayWaterfallDemo();
             }
             // Push Button 3
             if (SwitchState & PB_3)
             {
                 // xil_printf("***Single ADC conversion Trigger\r\n");
                 // IMR_ADC_7476A_X2_SingleConvert(&AXI_IMR_7476A_Handle, ADC_BufferDataA, ADC_BufferDataB);
-                // // Wait for IRQ to occur - Data A and B are loaded by the ISR
-                // usleep(200);
+                // // Wait for the completion event - Data A and B are loaded by the ISR
+                // Type_ADC_Event ADC_Event;
+                // while (!IMR_ADC_7476A_X2_GetEvent(&AXI_IMR_7476A_Handle, &ADC_Event));
                 // // Print Data A and B and registers
                 // xil_printf("Data A: %d\r\n", AXI_IMR_7476A_Handle.ADC_Data_A[0]);
                 // xil_printf("Data B: %d\r\n", AXI_IMR_7476A_Handle.ADC_Data_B[0]);
@@ -470,8 +482,8 @@ void mainTest(void)
 
                 // xil_printf("***Multi ADC conversion Triggers\r\n");
                 // IMR_ADC_7476A_X2_MultiConvert(&AXI_IMR_7476A_Handle, ADC_BufferDataA, ADC_BufferDataB, ADC_SAMPLE_SIZE);
-                // // Step 3: Wait for IRQ to occur - Data A and B are loaded by the ISR
-                // msleep(10);
+                // // Step 3: Wait for the completion event - Data A and B are loaded by the ISR
+                // while (!IMR_ADC_7476A_X2_GetEvent(&AXI_IMR_7476A_Handle, &ADC_Event));
                 // xil_printf("Control Register: 0x%08lx\r\n", IMR_ADC_7476A_X2_GetCtrlReg(&AXI_IMR_7476A_Handle));
                 // xil_printf("Status Register: 0x%08lx\r\n", IMR_ADC_7476A_X2_GetStatusReg(&AXI_IMR_7476A_Handle));
                 // xil_printf("Interrupt Register: 0x%08lx\r\n", IMR_ADC_7476A_X2_GetIrqReg(&AXI_IMR_7476A_Handle));
@@ -506,6 +518,148 @@ void mainTest(void)
 
 
 
+/********************************************************************************************************
+* @brief Full frame push rate of the display with the per segment displayTxRx transport and with the fast
+* register level transport
+*
+* @author original: Hab Collector \n
+*
+* @note: Times DISPLAY_BENCH_FRAMES full frames (u8g2_SendBuffer) per transport against the diskio_timing time base
+* 
+* STEP 1: Time each transport
+* STEP 2: Leave the fast transport selected
+********************************************************************************************************/
+static void displayBenchmarkFPS(void)
+{
+    // STEP 1: Time each transport
+    for (uint8_t Fast = 0; Fast < 2; Fast++)
+    {
+        displaySetFastTransport(&Display_SSD1309, Fast);
+        uint32_t StartTicks = disk_time_now();
+        for (uint8_t Frame = 0; Frame < DISPLAY_BENCH_FRAMES; Frame++)
+            u8g2_SendBuffer(Display_SSD1309.U8G2_Handle);
+        uint32_t ElapsedUs = disk_time_elapsed_us(StartTicks);
+        uint32_t FPS_x10 = (ElapsedUs == 0) ? 0 : (uint32_t)(((uint64_t)DISPLAY_BENCH_FRAMES * 10 * 1000000U) / ElapsedUs);
+        xil_printf("Display %s transport: %d.%d FPS (%d us per frame)\r\n", Fast ? "fast" : "segmented", FPS_x10 / 10, FPS_x10 % 10, ElapsedUs / DISPLAY_BENCH_FRAMES);
+    }
+
+    // STEP 2: Leave the fast transport selected
+    displayInvalidateShadow(&Display_SSD1309);
+
+} // END OF displayBenchmarkFPS
+
+
+
+/********************************************************************************************************
+* @brief Governed spectrum display: simulated FFT frames arrive faster than the display can take them; the
+* governor renders at most DISPLAY_DEMO_MAX_FPS and the spectra in between are merged (peak hold)
+*
+* @author original: Hab Collector \n
+*
+* @note: Double buffered - the next frame is drawn while the last goes out in the background.  The mode
+* and rate text are cached labels - decoded once, copied into every rendered frame
+* 
+* STEP 1: Blitter, labels, double buffer and governor
+* STEP 2: Offer every DSP frame - render, merge or drop as the governor says
+* STEP 3: Let the last push finish and report
+********************************************************************************************************/
+static void displayGovernorDemo(void)
+{
+    static const Type_SpectrumConfig SpectrumConfig = { .NumBars = 16, .BarWidth = 4, .BarHSpace = 2, .X_Offset = 0, .BaselineY = 60, .SegmentHeight = 2, .SegmentVSpace = 1, .Levels = 10 };
+    static Type_SpectrumBlitter SpectrumBlitter;
+    static Type_DisplayLabel ModeLabel;
+    static Type_DisplayLabel RateLabel;
+    uint8_t BarLevel[16];
+    uint8_t MergedLevel[16] = {0};
+
+    // STEP 1: Blitter, labels, double buffer and governor
+    initSpectrumBlitter(&SpectrumBlitter, &SpectrumConfig);
+    initDisplayLabel(&ModeLabel);
+    initDisplayLabel(&RateLabel);
+    setDisplayLabel(&ModeLabel, u8g2_font_5x8_tr, 98, 8, "FFT");
+    setDisplayLabel(&RateLabel, u8g2_font_5x8_tr, 98, 18, "30FPS");
+    displaySetDoubleBuffer(&Display_SSD1309, true);
+    displaySetGovernor(&Display_SSD1309, DISPLAY_DEMO_MAX_FPS, DISPLAY_GOVERN_MERGE);
+
+    // STEP 2: Offer every DSP frame - render, merge or drop as the governor says
+    for (uint32_t Frame = 0; Frame < DISPLAY_DEMO_DSP_FRAMES; Frame++)
+    {
+        for (uint8_t BarIndex = 0; BarIndex < SpectrumConfig.NumBars; BarIndex++)
+            BarLevel[BarIndex] = rand() % (SpectrumConfig.Levels + 1);
+        Type_DisplayFrameAction FrameAction = displayGovernorOffer(&Display_SSD1309);
+        if (FrameAction != DISPLAY_FRAME_DROP)
+            mergeSpectrumLevels(MergedLevel, BarLevel, SpectrumConfig.NumBars);
+        if (FrameAction == DISPLAY_FRAME_RENDER)
+        {
+            u8g2_ClearBuffer(Display_SSD1309.U8G2_Handle);
+            drawSpectrumBars(&SpectrumBlitter, Display_SSD1309.U8G2_Handle, MergedLevel, NULL);
+            drawDisplayLabel(&ModeLabel, Display_SSD1309.U8G2_Handle);
+            drawDisplayLabel(&RateLabel, Display_SSD1309.U8G2_Handle);
+            displayGovernorCommit(&Display_SSD1309);
+            memset(MergedLevel, 0x00, sizeof(MergedLevel));
+        }
+        // DSP time - the push runs from the QSPI interrupt once routed, polled here meanwhile
+        uint32_t DSP_StartTicks = disk_time_now();
+        while (disk_time_elapsed_us(DSP_StartTicks) < DISPLAY_DEMO_DSP_US)
+            displayPushService(&Display_SSD1309);
+    }
+
+    // STEP 3: Let the last push finish and report
+    while (displayIsPushBusy(&Display_SSD1309))
+        displayPushService(&Display_SSD1309);
+    displaySetDoubleBuffer(&Display_SSD1309, false);
+    printDisplayGovernorReport(&Display_SSD1309);
+
+} // END OF displayGovernorDemo
+
+
+
+/********************************************************************************************************
+* @brief Waterfall display: a simulated tone sweeps across the spectrum over a noise floor, one line per
+* spectrum, each line one page and the start line over SPI
+*
+* @author original: Hab Collector \n
+*
+* STEP 1: Start the waterfall - the display must be idle
+* STEP 2: Add the simulated spectra, timing each line
+* STEP 3: Restore the start line and the normal screen
+********************************************************************************************************/
+static void displayWaterfallDemo(void)
+{
+    Type_Waterfall Waterfall;
+    uint8_t Intensity[WATERFALL_DEMO_BINS];
+
+    // STEP 1: Start the waterfall - the display must be idle
+    while (displayIsPushBusy(&Display_SSD1309))
+        displayPushService(&Display_SSD1309);
+    if (!initWaterfall(&Waterfall, Display_SSD1309.U8G2_Handle, WATERFALL_DEMO_BINS))
+        return;
+
+    // STEP 2: Add the simulated spectra, timing each line
+    uint32_t StartTicks = disk_time_now();
+    for (uint32_t Line = 0; Line < WATERFALL_DEMO_LINES; Line++)
+    {
+        uint32_t Tone = (Line / 2) % WATERFALL_DEMO_BINS;
+        for (uint32_t Bin = 0; Bin < WATERFALL_DEMO_BINS; Bin++)
+        {
+            uint32_t Distance = (Bin > Tone) ? (Bin - Tone) : (Tone - Bin);
+            uint32_t Level = (rand() % 64) + ((Distance < 6) ? (255 - (Distance * 40)) : 0);
+            Intensity[Bin] = (Level > 255) ? 255 : Level;
+        }
+        addWaterfallLine(&Waterfall, Intensity);
+    }
+    uint32_t ElapsedUs = disk_time_elapsed_us(StartTicks);
+    xil_printf("Waterfall: %d lines, %d us per line\r\n", WATERFALL_DEMO_LINES, ElapsedUs / WATERFALL_DEMO_LINES);
+
+    // STEP 3: Restore the start line and the normal screen
+    stopWaterfall(&Waterfall);
+    displayInvalidateShadow(&Display_SSD1309);
+    drawSpectrumMock(&Display_SSD1309);
+
+} // END OF displayWaterfallDemo
+
+
+
 void readFileTest(const char *FileName)
 {
     FIL   FileHandle;       /* File object */
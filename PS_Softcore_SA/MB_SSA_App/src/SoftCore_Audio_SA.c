@@ -29,8 +29,14 @@
 #include "Main_Support.h"
 #include "Hab_Types.h"
 #include "ff.h"
+#include "diskio_sd.h"
 
 static bool feedStream_PCM16_WAV(Type_Audio_SA *Audio_SA);
+static void startRawChunk(Type_RawChunk *Chunk, FSIZE_t FileOffset, FSIZE_t DataEnd);
+static bool queueRawChunk(FIL *FileHandle, Type_RawChunk *Chunk);
+static void rawChunkReadDone(void *Context, DRESULT Result);
+static bool isRawChunkReady(Type_RawChunk *Chunk);
+static void waitRawChunksIdle(void);
 static void errorCloseFileAudio_SA(Type_Audio_SA *Audio_SA, FIL *FileHandle);
 static int16_t convert_PCM16_ToMono(int16_t Left_PCM16_Audio, int16_t Right_PCM16_Audion);
 static float convert_PCM16_To_PWM_DutyPercent(int16_t PCM16_Sample);
@@ -39,12 +45,14 @@ static void apply_FFT_Window(Type_Audio_SA *Audio_SA);
 
 
 
-uint8_t RawBuffer[MAX_CHUNK_BUFFER];
+static Type_RawChunk RawChunk[RAW_CHUNK_COUNT];
 
 void audioSpectrumAnalyzer(Type_Audio_SA *Audio_SA)
 {
     if (!Audio_SA->Enable)
         return;
+    // Polled SD engine moves the WAV read-ahead along - returns at once when the SD SPI IRQ drives it
+    disk_async_service();
     feedStream_PCM16_WAV(Audio_SA);
     if (Audio_SA->FFT.FrameReady)
     {
@@ -66,6 +74,10 @@ void audioSpectrumAnalyzer(Type_Audio_SA *Audio_SA)
 *
 * @note: Requires prior initialization of FAT FS and a valid WAV file header
 * @note: This function does not perform FFT processing or display updates
+* @note: The file is read in MAX_CHUNK_BUFFER chunks straight from the card with the asynchronous read-ahead
+* (submitFileReadAhead): while one chunk is decoded the next is already on its way, and a call never waits
+* on the card - if the next chunk has not arrived it returns and decodes on a later call.  A file too
+* fragmented for the link map falls back to a blocking f_read per chunk
 * @note: PCM DATA STORAGE – MONO
 * For mono WAV files, audio samples are stored in the file as consecutive signed 16-bit
 * little-endian values.  Each sample consists of two bytes:
@@ -87,24 +99,23 @@ void audioSpectrumAnalyzer(Type_Audio_SA *Audio_SA)
 * @return true if operation is successful or no action is required
 * @return false if a file or buffer initialization error occurs
 *
-* STEP 1: Verify Audio_SA is enabled and open WAV file on first use
-* STEP 2: Seek to WAV data offset if raw buffer is empty
-* STEP 3: Read a chunk of raw audio data from the WAV file into the raw buffer
-* STEP 4: Check circular buffer has sufficient unused elements for FFT_SIZE samples
-* STEP 5: Decode PCM16 samples and convert stereo to mono if required, then load circular buffer
-* STEP 6: Update raw buffer and file read offsets
-* STEP 7: Detect end of file and close WAV file when complete
+* STEP 1: Open WAV file on first use, build its link map and start reading the first chunks
+* STEP 2: Keep the read-ahead of both chunks going
+* STEP 3: Decode only once the chunk has arrived and the circular buffer has room for FFT_SIZE samples
+* STEP 4: Decode PCM16 samples and convert stereo to mono if required, then load circular buffer
+* STEP 5: Chunk used up - read the chunk after next into it and move on
+* STEP 6: Detect end of file and close WAV file when complete
 ********************************************************************************************************/
 static bool feedStream_PCM16_WAV(Type_Audio_SA *Audio_SA)
 {
     static FIL FileHandle;
-    static uint32_t RawIndexOffset = 0;
-    static uint32_t BytesLastReadFromFile = 0;
-    static uint32_t SeekOffset = 0;
-    static uint32_t BytesToReadFromFile = 0;
-    static uint32_t BytesToReadFromRawBuffer = 0;
+    static DWORD LinkMap[WAV_LINK_MAP_SIZE];
+    static FSIZE_t ReadOffset = 0;
+    static FSIZE_t DecodeOffset = 0;
+    static FSIZE_t DataEnd = 0;
+    static uint8_t DecodeChunk = 0;
     
-    // STEP 1: Open file in read-only mode and set conditions to begin loading the CB
+    // STEP 1: Open WAV file on first use, build its link map and start reading the first chunks
     if (!Audio_SA->File.IsOpen)
     {
         if (f_open(&FileHandle, Audio_SA->File.PathFileName, FA_READ) != FR_OK)
@@ -116,88 +127,88 @@ static bool feedStream_PCM16_WAV(Type_Audio_SA *Audio_SA)
         {
             Audio_SA->File.IsOpen = true;
             Audio_SA->IsFirstRead = true;
-            Audio_SA->IsRawBufferEmpty = true;
-            SeekOffset = WAV_DATA_OFFSET;
-            RawIndexOffset = 0;
-            BytesToReadFromFile = Audio_SA->File.Size;
+            DecodeOffset = WAV_DATA_OFFSET;
+            DataEnd = WAV_DATA_OFFSET + (FSIZE_t)Audio_SA->File.Header.DataSize;
+            if (DataEnd > f_size(&FileHandle))
+                DataEnd = f_size(&FileHandle);
             if (!init_CB(&Audio_SA->CircularBuffer, (Audio_SA->FFT.Size * 2)))
             {
                 errorCloseFileAudio_SA(Audio_SA, &FileHandle);
                 return(false);
             }
+            // Without a link map (too many fragments) the chunks are read with f_read instead
+            init_FileLinkMap(&FileHandle, LinkMap, WAV_LINK_MAP_SIZE);
+            ReadOffset = 0;
+            for (DecodeChunk = 0; DecodeChunk < RAW_CHUNK_COUNT; DecodeChunk++)
+            {
+                startRawChunk(&RawChunk[DecodeChunk], ReadOffset, DataEnd);
+                ReadOffset += MAX_CHUNK_BUFFER;
+            }
+            DecodeChunk = 0;
             // The first FFT Frame is made ready here - subsequent frames will be driven by the completion of the ISR PWM Buffer being empty
             Audio_SA->FFT.FrameReady = true;
         }
     }
 
-    // STEP 2: Seek to WAV data offset
-    if (Audio_SA->IsRawBufferEmpty)
-    {
-        if (f_lseek(&FileHandle, SeekOffset) != FR_OK)
-        {
-            f_close(&FileHandle);
-            Audio_SA->File.IsOpen = false;
-            return(false);
-        }
-    }
-
-    // STEP 3: Read a chucnk of data into the raw buffer - the raw buffer feeds the CB
-    if (Audio_SA->IsRawBufferEmpty)
+    // STEP 2: Keep the read-ahead of both chunks going - the one decoded next first
+    for (uint8_t Chunk = 0; Chunk < RAW_CHUNK_COUNT; Chunk++)
     {
-        if (f_read(&FileHandle, RawBuffer, sizeof(RawBuffer), &BytesLastReadFromFile) != FR_OK)
+        if (!queueRawChunk(&FileHandle, &RawChunk[(DecodeChunk + Chunk) % RAW_CHUNK_COUNT]))
         {
             errorCloseFileAudio_SA(Audio_SA, &FileHandle);
             return(false);
         }
-        else 
-        {
-            Audio_SA->IsRawBufferEmpty = false;
-            BytesToReadFromRawBuffer = sizeof(RawBuffer);
-            BytesToReadFromFile -= BytesLastReadFromFile;
-        }
     }
 
-    // STEP 4: Load CB Buffer only if there is room to do so
+    // STEP 3: Decode only once the chunk has arrived and the circular buffer has room for FFT_SIZE samples
+    Type_RawChunk *Chunk = &RawChunk[DecodeChunk];
+    if (!isRawChunkReady(Chunk))
+        return(true);
     if (unusedElements(&Audio_SA->CircularBuffer) < Audio_SA->FFT.Size)
         return(true);
 
-    // STEP 5: Load CB Buffer with FFT Size number of samples as there is room - if stero convert to mono        
-    uint32_t BytesReadFromRawBuffer = (Audio_SA->File.Header.ChannelNumber == MONO)? (Audio_SA->FFT.Size * 2) : (Audio_SA->FFT.Size * 4);
+    // STEP 4: Load CB Buffer with FFT Size number of samples as there is room - if stero convert to mono
+    // Data starts at byte 44 and chunks are 4 byte multiples, so a sample frame never straddles two chunks
     uint8_t IndexIncrement = (Audio_SA->File.Header.ChannelNumber == MONO)? 2 : 4;
+    FSIZE_t ChunkEnd = Chunk->FileOffset + MAX_CHUNK_BUFFER;
+    FSIZE_t DecodeEnd = (ChunkEnd < DataEnd) ? ChunkEnd : DataEnd;
     Type_Union_PCM_AudioValue PCM_LeftAudioValue;
     Type_Union_PCM_AudioValue PCM_RightAudioValue;
-    for(uint32_t Index = RawIndexOffset; Index < BytesReadFromRawBuffer; Index += IndexIncrement)
+    for (uint16_t Sample = 0; (Sample < Audio_SA->FFT.Size) && ((DecodeOffset + IndexIncrement) <= DecodeEnd); Sample++)
     {
+        uint32_t Index = (uint32_t)(DecodeOffset - Chunk->FileOffset);
         // In Mono you make two reads for left channel a single signed 16b value
         if (Audio_SA->File.Header.ChannelNumber == MONO)
         {
-            PCM_LeftAudioValue.ByteValue[LSB] = RawBuffer[Index];
-            PCM_LeftAudioValue.ByteValue[MSB] = RawBuffer[Index + 1];
+            PCM_LeftAudioValue.ByteValue[LSB] = Chunk->Data[Index];
+            PCM_LeftAudioValue.ByteValue[MSB] = Chunk->Data[Index + 1];
             write_CB(&Audio_SA->CircularBuffer, PCM_LeftAudioValue.Signed16Bit_Value);
         }
         // In Stero you make 4 reads for left and right channel signed 16b value
         if (Audio_SA->File.Header.ChannelNumber == STEREO)
         {
-            PCM_LeftAudioValue.ByteValue[LSB] = RawBuffer[Index];
-            PCM_LeftAudioValue.ByteValue[MSB] = RawBuffer[Index + 1];
-            PCM_RightAudioValue.ByteValue[LSB] = RawBuffer[Index + 2];
-            PCM_RightAudioValue.ByteValue[MSB] = RawBuffer[Index + 3];
+            PCM_LeftAudioValue.ByteValue[LSB] = Chunk->Data[Index];
+            PCM_LeftAudioValue.ByteValue[MSB] = Chunk->Data[Index + 1];
+            PCM_RightAudioValue.ByteValue[LSB] = Chunk->Data[Index + 2];
+            PCM_RightAudioValue.ByteValue[MSB] = Chunk->Data[Index + 3];
             write_CB(&Audio_SA->CircularBuffer, convert_PCM16_ToMono(PCM_LeftAudioValue.Signed16Bit_Value, PCM_RightAudioValue.Signed16Bit_Value));              
         }
+        DecodeOffset += IndexIncrement;
     }
+    Audio_SA->IsFirstRead = false;
 
-    // STEP 6: Calculate bytes read
-    BytesToReadFromRawBuffer -= BytesReadFromRawBuffer;
-    if (BytesToReadFromRawBuffer == 0)
+    // STEP 5: Chunk used up - read the chunk after next into it and move on
+    if (DecodeOffset >= ChunkEnd)
     {
-        Audio_SA->IsRawBufferEmpty = true;
-        SeekOffset += BytesLastReadFromFile;
-        RawIndexOffset += BytesReadFromRawBuffer;
+        startRawChunk(Chunk, ReadOffset, DataEnd);
+        ReadOffset += MAX_CHUNK_BUFFER;
+        DecodeChunk = (DecodeChunk + 1) % RAW_CHUNK_COUNT;
     }
 
-    // STEP 7: Check if full read of file is complete
-    if ((BytesToReadFromRawBuffer == 0) && (BytesToReadFromFile == 0))
+    // STEP 6: Check if full read of file is complete - no read-ahead may still be landing in a chunk
+    if ((DecodeOffset + IndexIncrement) > DataEnd)
     {
+        waitRawChunksIdle();
         f_close(&FileHandle);
         Audio_SA->File.IsOpen = false;
     }
@@ -208,6 +219,137 @@ static bool feedStream_PCM16_WAV(Type_Audio_SA *Audio_SA)
 
 
 
+/********************************************************************************************************
+* @brief Sets a raw chunk up to hold the next MAX_CHUNK_BUFFER bytes of the file from FileOffset
+*
+* @author original: Hab Collector \n
+*
+* @note: Only for a chunk with no read in flight (ready or idle)
+* 
+* @param Chunk: Raw chunk to reuse
+* @param FileOffset: Sector aligned file offset of the chunk
+* @param DataEnd: File offset just past the audio data - nothing is read from there on
+*
+* STEP 1: Size the chunk to the data left and clear its read state
+********************************************************************************************************/
+static void startRawChunk(Type_RawChunk *Chunk, FSIZE_t FileOffset, FSIZE_t DataEnd)
+{
+    // STEP 1: Size the chunk to the data left and clear its read state
+    FSIZE_t Bytes = (FileOffset >= DataEnd) ? 0 : (DataEnd - FileOffset);
+    if (Bytes > MAX_CHUNK_BUFFER)
+        Bytes = MAX_CHUNK_BUFFER;
+    Chunk->FileOffset = FileOffset;
+    Chunk->Sectors = (UINT)((Bytes + FF_MAX_SS - 1) / FF_MAX_SS);
+    Chunk->SectorsQueued = 0;
+    Chunk->RequestsQueued = 0;
+    Chunk->RequestsDone = 0;
+    Chunk->ReadError = false;
+
+} // END OF startRawChunk
+
+
+
+/********************************************************************************************************
+* @brief Hands the sectors of a raw chunk not yet requested to the SD read-ahead queue.  A chunk crossing
+* a fragment boundary goes out as more than one request; a full queue is retried on the next call.
+*
+* @author original: Hab Collector \n
+*
+* @note: Files without a link map are read here with a blocking f_read
+* 
+* @param FileHandle: Open WAV file
+* @param Chunk: Raw chunk to fill
+*
+* @return False on a read error
+*
+* STEP 1: Submit the remaining sectors run by run
+********************************************************************************************************/
+static bool queueRawChunk(FIL *FileHandle, Type_RawChunk *Chunk)
+{
+    UINT BytesRead;
+
+    // STEP 1: Submit the remaining sectors run by run
+    while (Chunk->SectorsQueued < Chunk->Sectors)
+    {
+        FSIZE_t FileOffset = Chunk->FileOffset + ((FSIZE_t)Chunk->SectorsQueued * FF_MAX_SS);
+        BYTE *Buffer = &Chunk->Data[Chunk->SectorsQueued * FF_MAX_SS];
+        UINT SectorCount = Chunk->Sectors - Chunk->SectorsQueued;
+        if (FileHandle->cltbl == NULL)
+        {
+            if ((f_lseek(FileHandle, FileOffset) != FR_OK) || (f_read(FileHandle, Buffer, SectorCount * FF_MAX_SS, &BytesRead) != FR_OK))
+                return(false);
+            Chunk->SectorsQueued = Chunk->Sectors;
+            break;
+        }
+        SectorCount = submitFileReadAhead(FileHandle, FileOffset, Buffer, SectorCount, rawChunkReadDone, Chunk);
+        if (SectorCount == 0)
+            break;
+        Chunk->RequestsQueued++;
+        Chunk->SectorsQueued += SectorCount;
+    }
+    return(!Chunk->ReadError);
+
+} // END OF queueRawChunk
+
+
+
+/********************************************************************************************************
+* @brief Read-ahead completion - runs from the SD engine (ISR in IRQ mode, else disk_async_service)
+*
+* @author original: Hab Collector \n
+*
+* @param Context: Raw chunk the request was for
+* @param Result: Result of the request
+********************************************************************************************************/
+static void rawChunkReadDone(void *Context, DRESULT Result)
+{
+    Type_RawChunk *Chunk = (Type_RawChunk *)Context;
+    if (Result != RES_OK)
+        Chunk->ReadError = true;
+    Chunk->RequestsDone++;
+
+} // END OF rawChunkReadDone
+
+
+
+/********************************************************************************************************
+* @brief Raw chunk test: every sector requested and every request completed
+*
+* @author original: Hab Collector \n
+*
+* @param Chunk: Raw chunk
+*
+* @return True if the chunk data can be decoded
+********************************************************************************************************/
+static bool isRawChunkReady(Type_RawChunk *Chunk)
+{
+    return((Chunk->SectorsQueued == Chunk->Sectors) && (Chunk->RequestsDone == Chunk->RequestsQueued));
+
+} // END OF isRawChunkReady
+
+
+
+/********************************************************************************************************
+* @brief Waits for every read-ahead in flight to land so no chunk is written after the file is closed or
+* the chunk reused
+*
+* @author original: Hab Collector \n
+*
+* STEP 1: Run the polled SD engine until each chunk has no request outstanding
+********************************************************************************************************/
+static void waitRawChunksIdle(void)
+{
+    // STEP 1: Run the polled SD engine until each chunk has no request outstanding
+    for (uint8_t Chunk = 0; Chunk < RAW_CHUNK_COUNT; Chunk++)
+    {
+        while (RawChunk[Chunk].RequestsDone != RawChunk[Chunk].RequestsQueued)
+            disk_async_service();
+    }
+
+} // END OF waitRawChunksIdle
+
+
+
 /********************************************************************************************************
 * @brief A serires of steps necessary when closing out the feedStream_PCM16_WAV due to an error condition
 *
@@ -221,6 +363,7 @@ static bool feedStream_PCM16_WAV(Type_Audio_SA *Audio_SA)
 static void errorCloseFileAudio_SA(Type_Audio_SA *Audio_SA, FIL *FileHandle)
 {
     // STEP 1: Make preperations to leave feedStream_PCM16_WAV gracefully
+    waitRawChunksIdle();
     f_close(FileHandle);
     Audio_SA->File.IsOpen = false;
     free_CB(&Audio_SA->CircularBuffer);
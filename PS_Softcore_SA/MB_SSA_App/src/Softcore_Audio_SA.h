@@ -45,6 +45,9 @@ extern"C" {
     #error "CHUNK_MULTIPLIER must be >= 4 and be an even value
 #endif
 #define MAX_CHUNK_BUFFER          (FFT_SIZE * CHUNK_MULTIPLIER)
+#define RAW_CHUNK_COUNT           2                     // One chunk decodes while the other is read ahead from the card
+#define RAW_CHUNK_SECTORS         (MAX_CHUNK_BUFFER / FF_MAX_SS)
+#define WAV_LINK_MAP_SIZE         64                    // Fast seek link map DWORDs - up to 31 file fragments
 
 typedef struct
 {
@@ -59,12 +62,22 @@ typedef struct
     float                       Samples[FFT_SIZE];
 } Type_PWM;
 
+typedef struct
+{
+    FSIZE_t                     FileOffset;             // Sector aligned file offset of the chunk
+    UINT                        Sectors;                // Sectors in the chunk - short at the end of the file
+    UINT                        SectorsQueued;          // Sectors handed to the SD engine - feeder only
+    UINT                        RequestsQueued;         // Read-ahead requests submitted - feeder only
+    volatile UINT               RequestsDone;           // Read-ahead completions - SD engine callback only
+    volatile bool               ReadError;
+    uint8_t                     Data[MAX_CHUNK_BUFFER] __attribute__((aligned(4)));
+} Type_RawChunk;
+
 // TYPEDEFS AND ENUMS
 typedef struct
 {
     bool                        Enable;
     bool                        IsFirstRead;
-    bool                        IsRawBufferEmpty;
     Type_AudioFile              File;
     Type_int16_t_CircularBuffer CircularBuffer;
     Type_FFT                    FFT;
@@ -40,7 +40,15 @@ set(USER_COMPILE_SOURCES
 "AXI_SPI_Display_SSD1309.c"
 "AXI_Timer_PWM_Support.c"
 "AXI_UART_Lite_Support.c"
+"Capture_Recorder.c"
+"Display_Spectrum.c"
+"Display_Labels.c"
+"Display_Waterfall.c"
 "FAT_FS/diskio.c"
+"FAT_FS/diskio_sd.c"
+"FAT_FS/diskio_ram.c"
+"FAT_FS/diskio_cache.c"
+"FAT_FS/diskio_timing.c"
 "FAT_FS/ff.c"
 "FAT_FS/ffsystem.c"
 "FAT_FS/ffunicode.c"
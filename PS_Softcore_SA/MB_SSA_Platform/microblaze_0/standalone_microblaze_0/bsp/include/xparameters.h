@@ -19,6 +19,24 @@
 #define XPAR_XGPIO_0_INTERRUPT_PRESENT 0x0
 #define XPAR_XGPIO_0_IS_DUAL 0x1
 
+#define XPAR_XIMR_ADC_7476A_X2_NUM_INSTANCES 1
+
+/* Definitions for peripheral IMR_ADC_7476A_X2_0 */
+#define XPAR_IMR_ADC_7476A_X2_0_COMPATIBLE "xlnx,IMR_ADC_7476A_X2-1.0"
+#define XPAR_IMR_ADC_7476A_X2_0_BASEADDR 0x44a20000
+#define XPAR_IMR_ADC_7476A_X2_0_HIGHADDR 0x44a2007f
+#define XPAR_IMR_ADC_7476A_X2_0_INTERRUPTS 0x2001
+#define XPAR_FABRIC_IMR_ADC_7476A_X2_0_INTR 1
+#define XPAR_IMR_ADC_7476A_X2_0_INTERRUPT_PARENT 0x41200001
+
+/* Canonical definitions for peripheral IMR_ADC_7476A_X2_0 */
+#define XPAR_XIMR_ADC_7476A_X2_0_BASEADDR 0x44a20000
+#define XPAR_FABRIC_XIMR_ADC_7476A_X2_0_INTR 1
+#define XPAR_XIMR_ADC_7476A_X2_0_HIGHADDR 0x44a2007f
+#define XPAR_XIMR_ADC_7476A_X2_0_COMPATIBLE "xlnx,IMR_ADC_7476A_X2-1.0"
+#define XPAR_XIMR_ADC_7476A_X2_0_INTERRUPTS 0x2001
+#define XPAR_XIMR_ADC_7476A_X2_0_INTERRUPT_PARENT 0x41200001
+
 #define XPAR_XINTC_NUM_INSTANCES 1
 
 /* Definitions for peripheral AXI_INTC_0 */